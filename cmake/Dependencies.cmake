@@ -26,6 +26,13 @@ if (BUILD_TEST)
   set_target_properties(gtest gmock PROPERTIES POSITION_INDEPENDENT_CODE ON)
 endif()
 
+##################################################################
+# Google Benchmark
+##################################################################
+if (BUILD_TEST AND BUILD_BENCHMARK)
+  find_package(benchmark REQUIRED)
+endif()
+
 function(CUDA_find_library out_path lib_name)
     find_library(${out_path} ${lib_name} PATHS ${CMAKE_CUDA_IMPLICIT_LINK_DIRECTORIES}
                  PATH_SUFFIXES lib lib64)
@@ -122,6 +129,36 @@ else()
     message("libtiff dependencies: ${TIFF_LIBRARY_DEPS}")
 endif()
 
+find_path(WEBP_INCLUDE_DIR NAMES webp/encode.h)
+find_library(WEBP_LIBRARY NAMES webp libwebp)
+if(NOT WEBP_INCLUDE_DIR OR NOT WEBP_LIBRARY)
+    message(WARNING "libwebp not found - disabled")
+    set(BUILD_LIBWEBP_EXT OFF CACHE BOOL INTERNAL)
+    set(BUILD_LIBWEBP_EXT OFF)
+else()
+    message("Using libwebp at ${WEBP_LIBRARY}")
+    include_directories(SYSTEM ${WEBP_INCLUDE_DIR})
+endif()
+
+find_path(OPENJPEG_INCLUDE_DIR NAMES openjpeg.h PATH_SUFFIXES openjpeg-2.5 openjpeg-2.4 openjpeg-2.3)
+find_library(OPENJPEG_LIBRARY NAMES openjp2)
+if(NOT OPENJPEG_INCLUDE_DIR OR NOT OPENJPEG_LIBRARY)
+    message(WARNING "openjpeg not found - disabled")
+    set(BUILD_OPENJPEG_EXT OFF CACHE BOOL INTERNAL)
+    set(BUILD_OPENJPEG_EXT OFF)
+else()
+    message("Using openjpeg at ${OPENJPEG_LIBRARY}")
+    include_directories(SYSTEM ${OPENJPEG_INCLUDE_DIR})
+endif()
+
+find_path(LZ4_INCLUDE_DIR NAMES lz4.h)
+find_library(LZ4_LIBRARY NAMES lz4 liblz4)
+if(NOT LZ4_INCLUDE_DIR OR NOT LZ4_LIBRARY)
+    message("lz4 not found - nvtensor extension will support zstd compression only")
+else()
+    message("Using lz4 at ${LZ4_LIBRARY}")
+endif()
+
 if (NOT DEFINED OpenCV_VERSION)
     if (WIN32)
     set(OpenCV_STATIC ON)
@@ -37,6 +37,9 @@ export BUILD_NVBMP_EXT=${BUILD_NVBMP_EXT:-ON}
 export BUILD_NVPNM_EXT=${BUILD_NVPNM_EXT:-ON}
 export BUILD_LIBJPEG_TURBO_EXT=${BUILD_LIBJPEG_TURBO_EXT:-ON}
 export BUILD_LIBTIFF_EXT=${BUILD_LIBTIFF_EXT:-ON}
+export BUILD_LIBWEBP_EXT=${BUILD_LIBWEBP_EXT:-ON}
+export BUILD_OPENJPEG_EXT=${BUILD_OPENJPEG_EXT:-ON}
+export BUILD_NVTENSOR_EXT=${BUILD_NVTENSOR_EXT:-ON}
 export BUILD_OPENCV_EXT=${BUILD_OPENCV_EXT:-ON}
 export BUILD_PYTHON=${BUILD_PYTHON:-ON}
 export BUILD_WHEEL=${BUILD_WHEEL:-ON}
@@ -77,6 +80,9 @@ cmake ../                                                            \
       -DBUILD_NVPNM_EXT=${BUILD_NVPNM_EXT}                           \
       -DBUILD_LIBJPEG_TURBO_EXT=${BUILD_LIBJPEG_TURBO_EXT}           \
       -DBUILD_LIBTIFF_EXT=${BUILD_LIBTIFF_EXT}                       \
+      -DBUILD_LIBWEBP_EXT=${BUILD_LIBWEBP_EXT}                       \
+      -DBUILD_OPENJPEG_EXT=${BUILD_OPENJPEG_EXT}                     \
+      -DBUILD_NVTENSOR_EXT=${BUILD_NVTENSOR_EXT}                     \
       -DBUILD_OPENCV_EXT=${BUILD_OPENCV_EXT}                         \
       -DBUILD_PYTHON=${BUILD_PYTHON}                                 \
       -DBUILD_WHEEL=${BUILD_WHEEL}                                   \
@@ -471,7 +471,12 @@ int prepare_decode_resources(nvimgcodecInstance_t instance, FileData& file_data,
         ibuf[i].size = image_info.buffer_size;
         image_info.buffer = ibuf[i].data;
 
-        CHECK_NVIMGCODEC(nvimgcodecImageCreate(instance, &images[i], &image_info));
+        // Handles of the previous batch are pointed at the new buffers instead of being recreated
+        if (images[i]) {
+            CHECK_NVIMGCODEC(nvimgcodecImageSetImageInfo(images[i], &image_info));
+        } else {
+            CHECK_NVIMGCODEC(nvimgcodecImageCreate(instance, &images[i], &image_info));
+        }
 
         if (decoder == nullptr) {
             std::string dec_options{":fancy_upsampling=0"};
@@ -689,9 +694,11 @@ int process_images(nvimgcodecInstance_t instance, fs::path input_path, fs::path
         for (auto& cs : out_code_streams) {
             nvimgcodecCodeStreamDestroy(cs);
         }
-        for (auto& img : images) {
+    }
+
+    for (auto& img : images) {
+        if (img)
             nvimgcodecImageDestroy(img);
-        }
     }
 
     for (int i = 0; i < params.batch_size; ++i) {
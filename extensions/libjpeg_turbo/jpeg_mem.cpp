@@ -28,6 +28,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include "jpeg_handle.h"
 #include "log.h"
 
@@ -99,7 +100,7 @@ bool IsCropWindowValid(const UncompressFlags& flags, int input_image_width, int
            flags.crop_y + flags.crop_height <= input_image_height && flags.crop_x + flags.crop_width <= input_image_width;
 }
 
-std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompiler* argball)
+UncompressedImage UncompressLow(const void* srcdata, FewerArgsForCompiler* argball)
 {
     // unpack the argball
     const int datasize = argball->datasize_;
@@ -204,7 +205,7 @@ std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompil
         ss << "Invalid image size: " << cinfo.output_width << " x " << cinfo.output_height;
         throw std::runtime_error(ss.str());
     }
-    if (total_size >= (1LL << 29)) {
+    if (flags.band_height == 0 && total_size >= (1LL << 29)) {
         std::stringstream ss{};
         ss << "Image too large: " << total_size;
         throw std::runtime_error(ss.str());
@@ -268,8 +269,16 @@ std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompil
     argball->height_ = target_output_height;
     argball->stride_ = stride;
 
-    std::unique_ptr<uint8_t[]> dstdata;
-    dstdata.reset(new JSAMPLE[target_output_width * target_output_height * components]);
+    // In band mode, the output buffer is reused for each band of rows
+    const bool band_mode = flags.band_height > 0;
+    const int buffer_height = band_mode ? std::min<int>(flags.band_height, target_output_height) : target_output_height;
+
+    const size_t buffer_size = static_cast<size_t>(stride) * buffer_height;
+    UncompressedImage dstdata;
+    if (flags.allocate_output)
+        dstdata = UncompressedImage(flags.allocate_output(buffer_size), [](uint8_t*) {});
+    else
+        dstdata = UncompressedImage(new JSAMPLE[buffer_size], [](uint8_t* ptr) { delete[] ptr; });
 
     if (dstdata == nullptr) {
         return nullptr;
@@ -364,7 +373,7 @@ std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompil
             std::stringstream ss{};
             ss << "Premature end of JPEG data. Stopped at line " << cinfo.output_scanline - skipped_scanlines << "/"
                << target_output_height;
-            throw std::runtime_error(ss.str());
+            throw TruncatedJpegError(ss.str());
             if (!flags.try_recover_truncated_jpeg) {
                 argball->height_read_ = cinfo.output_scanline - skipped_scanlines;
                 error = JPEGERRORS_UNEXPECTED_END_OF_DATA;
@@ -388,6 +397,16 @@ std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompil
         if (num_lines_read != 1)
             throw std::runtime_error("Unexpected number of lines read");
         output_line += stride;
+
+        if (band_mode) {
+            int rows_decoded = cinfo.output_scanline - skipped_scanlines;
+            int rows_in_band = (output_line - dstdata.get()) / stride;
+            if (rows_in_band == buffer_height || rows_decoded == static_cast<int>(target_output_height)) {
+                if (!flags.band_callback(dstdata.get(), rows_decoded - rows_in_band, rows_in_band))
+                    throw std::runtime_error("Band output was interrupted");
+                output_line = dstdata.get();
+            }
+        }
     }
     temp.reset();
     tempdata = nullptr;
@@ -484,7 +503,7 @@ std::unique_ptr<uint8_t[]> UncompressLow(const void* srcdata, FewerArgsForCompil
 //  associated libraries aren't good enough to guarantee that 7
 //  parameters won't get clobbered by the longjmp.  So we help
 //  it out a little.
-std::unique_ptr<uint8_t[]> Uncompress(const void* srcdata, int datasize, const UncompressFlags& flags)
+UncompressedImage Uncompress(const void* srcdata, int datasize, const UncompressFlags& flags)
 {
     FewerArgsForCompiler argball(datasize, flags);
     auto dstdata = UncompressLow(srcdata, &argball);
@@ -497,7 +516,7 @@ std::unique_ptr<uint8_t[]> Uncompress(const void* srcdata, int datasize, const U
 
     // If there was an error in reading the jpeg data,
     // set the unread pixels to black
-    if (argball.height_read_ != argball.height_) {
+    if (flags.band_height == 0 && argball.height_read_ != argball.height_) {
         const int first_bad_line = argball.height_read_;
         uint8_t* start = dstdata.get() + first_bad_line * argball.stride_;
         const int nbytes = (argball.height_ - first_bad_line) * argball.stride_;
@@ -558,4 +577,199 @@ bool GetImageInfo(const void* srcdata, int datasize, int* width, int* height, in
     return true;
 }
 
+namespace {
+
+bool SamplingFactors(nvimgcodecChromaSubsampling_t subsampling, int* h, int* v)
+{
+    switch (subsampling) {
+    case NVIMGCODEC_SAMPLING_444:
+        *h = 1, *v = 1;
+        return true;
+    case NVIMGCODEC_SAMPLING_422:
+        *h = 2, *v = 1;
+        return true;
+    case NVIMGCODEC_SAMPLING_420:
+        *h = 2, *v = 2;
+        return true;
+    case NVIMGCODEC_SAMPLING_440:
+        *h = 1, *v = 2;
+        return true;
+    case NVIMGCODEC_SAMPLING_411:
+        *h = 4, *v = 1;
+        return true;
+    case NVIMGCODEC_SAMPLING_410:
+        *h = 4, *v = 2;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Sets the compression parameters and writes the header, must be called within the setjmp scope of cinfo
+void StartCompress(j_compress_ptr cinfo, int h_factor, int v_factor, bool raw_data, const CompressFlags& flags)
+{
+    jpeg_set_defaults(cinfo);
+    cinfo->raw_data_in = raw_data ? TRUE : FALSE;
+    if (cinfo->input_components == 3 && flags.chroma_subsampling == NVIMGCODEC_SAMPLING_GRAY) {
+        jpeg_set_colorspace(cinfo, JCS_GRAYSCALE);
+    } else if (cinfo->input_components == 3) {
+        cinfo->comp_info[0].h_samp_factor = h_factor;
+        cinfo->comp_info[0].v_samp_factor = v_factor;
+        for (int c = 1; c < 3; c++) {
+            cinfo->comp_info[c].h_samp_factor = 1;
+            cinfo->comp_info[c].v_samp_factor = 1;
+        }
+    }
+    cinfo->optimize_coding = flags.optimize_jpeg_size ? TRUE : FALSE;
+    cinfo->density_unit = flags.density_unit;
+    cinfo->X_density = flags.x_density;
+    cinfo->Y_density = flags.y_density;
+    jpeg_set_quality(cinfo, flags.quality, TRUE);
+    if (flags.progressive)
+        jpeg_simple_progression(cinfo);
+    jpeg_start_compress(cinfo, TRUE);
+
+    if (!flags.xmp_metadata.empty()) {
+        // XMP metadata is embedded in an APP1 tag, prefixed with the XMP namespace, see
+        // https://wwwimages2.adobe.com/content/dam/acom/en/devnet/xmp/pdfs/XMP%20SDK%20Release%20cc-2016-08/XMPSpecificationPart3.pdf
+        const std::string name_space = "http://ns.adobe.com/xap/1.0/";
+        std::string marker_data = name_space + '\0' + flags.xmp_metadata;
+        jpeg_write_marker(cinfo, JPEG_APP0 + 1, reinterpret_cast<const JOCTET*>(marker_data.data()), marker_data.size());
+    }
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Compresses an image to a jpeg string.
+// Returns true on success; false on failure.
+bool Compress(const void* srcdata, int width, int height, const CompressFlags& flags, std::string* output)
+{
+    if (output == nullptr)
+        return false;
+    output->clear();
+    const int components = (static_cast<int>(flags.format) & 0xff);
+    if (srcdata == nullptr || width <= 0 || height <= 0 || (components != 1 && components != 3))
+        return false;
+    const int min_stride = width * components;
+    const int stride = flags.stride == 0 ? min_stride : flags.stride;
+    if (stride < min_stride)
+        return false;
+    int h_factor = 1, v_factor = 1;
+    if (components == 3 && flags.chroma_subsampling != NVIMGCODEC_SAMPLING_GRAY &&
+        !SamplingFactors(flags.chroma_subsampling, &h_factor, &v_factor))
+        return false;
+
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    // Declared before setjmp, so that it is released on the error path
+    std::vector<JOCTET> buffer(64 * 1024);
+    jmp_buf jpeg_jmpbuf;
+    cinfo.err = jpeg_std_error(&jerr);
+    cinfo.client_data = &jpeg_jmpbuf;
+    jerr.error_exit = CatchError;
+    jpeg_create_compress(&cinfo);
+    if (setjmp(jpeg_jmpbuf)) {
+        jpeg_destroy_compress(&cinfo);
+        output->clear();
+        return false;
+    }
+
+    SetDest(&cinfo, buffer.data(), buffer.size(), output);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = components;
+    cinfo.in_color_space = components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+    StartCompress(&cinfo, h_factor, v_factor, false, flags);
+
+    const JSAMPLE* src = static_cast<const JSAMPLE*>(srcdata);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = const_cast<JSAMPROW>(src + static_cast<size_t>(cinfo.next_scanline) * stride);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Compresses planar YCbCr to a jpeg string, passing the planes to libjpeg as raw data.
+// Returns true on success; false on failure.
+bool CompressRaw(const uint8_t* const planes[3], const int strides[3], int width, int height, const CompressFlags& flags,
+    std::string* output)
+{
+    if (output == nullptr)
+        return false;
+    output->clear();
+    int h_factor = 1, v_factor = 1;
+    if (width <= 0 || height <= 0 || !SamplingFactors(flags.chroma_subsampling, &h_factor, &v_factor))
+        return false;
+    const int plane_widths[3] = {width, (width + h_factor - 1) / h_factor, (width + h_factor - 1) / h_factor};
+    const int plane_heights[3] = {height, (height + v_factor - 1) / v_factor, (height + v_factor - 1) / v_factor};
+    for (int c = 0; c < 3; c++) {
+        if (planes[c] == nullptr || strides[c] < plane_widths[c])
+            return false;
+    }
+
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    // Declared before setjmp, so that they are released on the error path
+    std::vector<JOCTET> buffer(64 * 1024);
+    std::vector<JSAMPLE> padded[3];
+    std::vector<JSAMPROW> rows[3];
+    jmp_buf jpeg_jmpbuf;
+    cinfo.err = jpeg_std_error(&jerr);
+    cinfo.client_data = &jpeg_jmpbuf;
+    jerr.error_exit = CatchError;
+    jpeg_create_compress(&cinfo);
+    if (setjmp(jpeg_jmpbuf)) {
+        jpeg_destroy_compress(&cinfo);
+        output->clear();
+        return false;
+    }
+
+    SetDest(&cinfo, buffer.data(), buffer.size(), output);
+    cinfo.image_width = width;
+    cinfo.image_height = height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_YCbCr;
+    StartCompress(&cinfo, h_factor, v_factor, true, flags);
+
+    // Raw data is consumed in whole iMCU rows, with each component padded to whole DCT blocks.
+    // Rows are taken from the planes as they are, only the blocks crossing the right edge need a padded copy.
+    const int imcu_rows = cinfo.max_v_samp_factor * DCTSIZE;
+    int padded_widths[3];
+    for (int c = 0; c < 3; c++) {
+        padded_widths[c] = cinfo.comp_info[c].width_in_blocks * DCTSIZE;
+        int comp_rows = cinfo.comp_info[c].v_samp_factor * DCTSIZE;
+        rows[c].resize(comp_rows);
+        if (padded_widths[c] > plane_widths[c])
+            padded[c].resize(static_cast<size_t>(padded_widths[c]) * comp_rows);
+    }
+    JSAMPARRAY data[3] = {rows[0].data(), rows[1].data(), rows[2].data()};
+    while (cinfo.next_scanline < cinfo.image_height) {
+        for (int c = 0; c < 3; c++) {
+            int comp_rows = static_cast<int>(rows[c].size());
+            int first_row = static_cast<int>(cinfo.next_scanline) / imcu_rows * comp_rows;
+            for (int r = 0; r < comp_rows; r++) {
+                // Rows below the image repeat the last one
+                int y = std::min(first_row + r, plane_heights[c] - 1);
+                const JSAMPLE* src = planes[c] + static_cast<size_t>(y) * strides[c];
+                if (padded[c].empty()) {
+                    rows[c][r] = const_cast<JSAMPROW>(src);
+                } else {
+                    JSAMPLE* dst = &padded[c][static_cast<size_t>(r) * padded_widths[c]];
+                    std::copy(src, src + plane_widths[c], dst);
+                    std::fill(dst + plane_widths[c], dst + padded_widths[c], src[plane_widths[c] - 1]);
+                    rows[c][r] = dst;
+                }
+            }
+        }
+        jpeg_write_raw_data(&cinfo, data, imcu_rows);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    return true;
+}
+
 } // namespace libjpeg_turbo
@@ -22,8 +22,10 @@ limitations under the License.
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include "nvimgcodec.h"
 #include "jpeg_utils.h"
@@ -74,14 +76,34 @@ struct UncompressFlags {
   int crop_width = 0;
   // Height of the output image.
   int crop_height = 0;
+
+  // If greater than 0, the output buffer holds only band_height rows and is
+  // passed to band_callback each time it is filled, or when the last row is
+  // decoded. Decoding stops if the callback returns false.
+  int band_height = 0;
+  std::function<bool(const uint8_t* band, int first_row, int num_rows)> band_callback;
+
+  // If set, allocates the output buffer, which then stays owned by the caller.
+  // Otherwise, the output buffer is allocated on the heap.
+  std::function<uint8_t*(size_t size)> allocate_output;
+};
+
+// Output buffer of Uncompress, freed on destruction unless it comes from
+// UncompressFlags::allocate_output.
+using UncompressedImage = std::unique_ptr<uint8_t[], std::function<void(uint8_t*)>>;
+
+// Thrown by Uncompress when the data ends before all the lines of the image.
+class TruncatedJpegError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
 };
 
 // Uncompress some raw JPEG data given by the pointer srcdata and the length
 // datasize.
 // The function returns a shared pointer to the uncompressed data or a null pointer if
-// there was an error.
-std::unique_ptr<uint8_t[]> Uncompress(const void* srcdata, int datasize,
-                                      const UncompressFlags& flags);
+// there was an error. Throws TruncatedJpegError if the data is truncated.
+UncompressedImage Uncompress(const void* srcdata, int datasize,
+                             const UncompressFlags& flags);
 
 // Read jpeg header and get image information.  Returns true on success.
 // The width, height, and components points may be null.
@@ -111,7 +133,8 @@ struct CompressFlags {
   bool optimize_jpeg_size = false;
 
   // See http://en.wikipedia.org/wiki/Chroma_subsampling
-  bool chroma_downsampling = true;
+  // NVIMGCODEC_SAMPLING_GRAY stores only the luma of a color input.
+  nvimgcodecChromaSubsampling_t chroma_subsampling = NVIMGCODEC_SAMPLING_420;
 
   // Resolution
   int density_unit = 1;  // 1 = in, 2 = cm
@@ -127,4 +150,16 @@ struct CompressFlags {
   int stride = 0;
 };
 
+// Compresses an image with FORMAT_GRAYSCALE or FORMAT_RGB layout and stores
+// the result in output. Returns false on failure.
+bool Compress(const void* srcdata, int width, int height,
+              const CompressFlags& flags, std::string* output);
+
+// Compresses planar YCbCr, laid out according to flags.chroma_subsampling, without color
+// conversion nor chroma downsampling. Chroma planes are ceil(width / h) x ceil(height / v)
+// for the horizontal and vertical subsampling factors. format and stride are ignored, each
+// plane has its own stride. Returns false on failure.
+bool CompressRaw(const uint8_t* const planes[3], const int strides[3], int width, int height,
+                 const CompressFlags& flags, std::string* output);
+
 }  // namespace libjpeg_turbo
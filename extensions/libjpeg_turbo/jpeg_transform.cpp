@@ -0,0 +1,355 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jpeg_transform.h"
+#include <setjmp.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "jpeg_handle.h"
+
+namespace libjpeg_turbo {
+
+namespace {
+
+constexpr int kExifOrientationTag = 0x0112;
+
+bool IsTransposed(nvimgcodecTransformOp_t op)
+{
+    return op == NVIMGCODEC_TRANSFORM_OP_TRANSPOSE || op == NVIMGCODEC_TRANSFORM_OP_TRANSVERSE || op == NVIMGCODEC_TRANSFORM_OP_ROT_90 ||
+           op == NVIMGCODEC_TRANSFORM_OP_ROT_270;
+}
+
+// Whether the last column (row) of the input ends up somewhere else than the
+// last column (row) of the output, so partial iMCUs can't be kept.
+bool MovesRightEdge(nvimgcodecTransformOp_t op)
+{
+    return op == NVIMGCODEC_TRANSFORM_OP_FLIP_X || op == NVIMGCODEC_TRANSFORM_OP_TRANSVERSE || op == NVIMGCODEC_TRANSFORM_OP_ROT_180 ||
+           op == NVIMGCODEC_TRANSFORM_OP_ROT_270;
+}
+
+bool MovesBottomEdge(nvimgcodecTransformOp_t op)
+{
+    return op == NVIMGCODEC_TRANSFORM_OP_FLIP_Y || op == NVIMGCODEC_TRANSFORM_OP_TRANSVERSE || op == NVIMGCODEC_TRANSFORM_OP_ROT_180 ||
+           op == NVIMGCODEC_TRANSFORM_OP_ROT_90;
+}
+
+// Operation which brings an image stored with the given EXIF orientation to normal orientation
+nvimgcodecTransformOp_t FromExifOrientation(int orientation)
+{
+    switch (orientation) {
+    case 2:
+        return NVIMGCODEC_TRANSFORM_OP_FLIP_X;
+    case 3:
+        return NVIMGCODEC_TRANSFORM_OP_ROT_180;
+    case 4:
+        return NVIMGCODEC_TRANSFORM_OP_FLIP_Y;
+    case 5:
+        return NVIMGCODEC_TRANSFORM_OP_TRANSPOSE;
+    case 6:
+        return NVIMGCODEC_TRANSFORM_OP_ROT_90;
+    case 7:
+        return NVIMGCODEC_TRANSFORM_OP_TRANSVERSE;
+    case 8:
+        return NVIMGCODEC_TRANSFORM_OP_ROT_270;
+    default:
+        return NVIMGCODEC_TRANSFORM_OP_NONE;
+    }
+}
+
+// Returns the offset of the orientation value in an APP1 Exif marker, or -1 if there is none
+int FindExifOrientation(const JOCTET* data, unsigned int length, bool* big_endian)
+{
+    if (length < 14 || std::memcmp(data, "Exif\0\0", 6) != 0)
+        return -1;
+    const JOCTET* tiff = data + 6;
+    unsigned int tiff_length = length - 6;
+    if (tiff[0] == 'M' && tiff[1] == 'M')
+        *big_endian = true;
+    else if (tiff[0] == 'I' && tiff[1] == 'I')
+        *big_endian = false;
+    else
+        return -1;
+    auto u16 = [&](unsigned int offset) -> unsigned int {
+        return *big_endian ? (tiff[offset] << 8) | tiff[offset + 1] : (tiff[offset + 1] << 8) | tiff[offset];
+    };
+    auto u32 = [&](unsigned int offset) -> unsigned int {
+        return *big_endian ? (u16(offset) << 16) | u16(offset + 2) : (u16(offset + 2) << 16) | u16(offset);
+    };
+    unsigned int ifd = u32(4);
+    if (ifd > tiff_length - 2)
+        return -1;
+    unsigned int num_entries = u16(ifd);
+    for (unsigned int i = 0; i < num_entries; i++) {
+        unsigned int entry = ifd + 2 + i * 12;
+        if (entry > tiff_length - 12)
+            return -1;
+        if (u16(entry) == kExifOrientationTag)
+            return 6 + entry + 8;
+    }
+    return -1;
+}
+
+// Rearranges coefficients of a block, given in natural order
+void TransformBlock(const JCOEF* src, JCOEF* dst, nvimgcodecTransformOp_t op)
+{
+    bool transposed = IsTransposed(op);
+    for (int i = 0; i < DCTSIZE; i++) {
+        for (int j = 0; j < DCTSIZE; j++) {
+            JCOEF value = transposed ? src[j * DCTSIZE + i] : src[i * DCTSIZE + j];
+            bool negate = false;
+            switch (op) {
+            case NVIMGCODEC_TRANSFORM_OP_FLIP_X:
+            case NVIMGCODEC_TRANSFORM_OP_ROT_90:
+                negate = j & 1;
+                break;
+            case NVIMGCODEC_TRANSFORM_OP_FLIP_Y:
+            case NVIMGCODEC_TRANSFORM_OP_ROT_270:
+                negate = i & 1;
+                break;
+            case NVIMGCODEC_TRANSFORM_OP_TRANSVERSE:
+            case NVIMGCODEC_TRANSFORM_OP_ROT_180:
+                negate = (i + j) & 1;
+                break;
+            default:
+                break;
+            }
+            dst[i * DCTSIZE + j] = negate ? -value : value;
+        }
+    }
+}
+
+// Position of the source block for a block of the output, in a window of
+// width x height blocks
+void SourceBlock(nvimgcodecTransformOp_t op, int x, int y, int width, int height, int* src_x, int* src_y)
+{
+    switch (op) {
+    case NVIMGCODEC_TRANSFORM_OP_FLIP_X:
+        *src_x = width - 1 - x;
+        *src_y = y;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_FLIP_Y:
+        *src_x = x;
+        *src_y = height - 1 - y;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_TRANSPOSE:
+        *src_x = y;
+        *src_y = x;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_TRANSVERSE:
+        *src_x = width - 1 - y;
+        *src_y = height - 1 - x;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_ROT_90:
+        *src_x = y;
+        *src_y = height - 1 - x;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_ROT_180:
+        *src_x = width - 1 - x;
+        *src_y = height - 1 - y;
+        break;
+    case NVIMGCODEC_TRANSFORM_OP_ROT_270:
+        *src_x = width - 1 - y;
+        *src_y = x;
+        break;
+    default:
+        *src_x = x;
+        *src_y = y;
+        break;
+    }
+}
+
+struct ComponentWindow
+{
+    int h_samp;
+    int v_samp;
+    int x0;     // first block column of the window in the input
+    int y0;     // first block row of the window in the input
+    int width;  // window width in blocks, before the operation
+    int height; // window height in blocks, before the operation
+};
+
+}  // namespace
+
+bool Transform(const void* srcdata, uint64_t datasize, const TransformFlags& flags, std::string* output)
+{
+    if (datasize == 0 || srcdata == nullptr || output == nullptr)
+        return false;
+
+    struct jpeg_decompress_struct srcinfo;
+    struct jpeg_compress_struct dstinfo;
+    struct jpeg_error_mgr jsrcerr, jdsterr;
+    struct ProgressMgr progress{};
+    // Declared before setjmp, so that they are released on the error path
+    std::vector<ComponentWindow> windows;
+    std::vector<jvirt_barray_ptr> dst_coef_arrays;
+    std::vector<JCOEF> window_coefs;
+    std::vector<JOCTET> buffer(64 * 1024);
+    jmp_buf jpeg_jmpbuf;
+    srcinfo.err = jpeg_std_error(&jsrcerr);
+    jsrcerr.error_exit = CatchError;
+    srcinfo.client_data = &jpeg_jmpbuf;
+    dstinfo.err = jpeg_std_error(&jdsterr);
+    jdsterr.error_exit = CatchError;
+    dstinfo.client_data = &jpeg_jmpbuf;
+    // Both are created before the first possible error, destroying twice is harmless
+    jpeg_create_decompress(&srcinfo);
+    jpeg_create_compress(&dstinfo);
+    if (setjmp(jpeg_jmpbuf)) {
+        jpeg_destroy_compress(&dstinfo);
+        jpeg_destroy_decompress(&srcinfo);
+        return false;
+    }
+
+    SetupProgressMgr(&srcinfo, &progress);
+    SetSrc(&srcinfo, srcdata, datasize, false);
+    jpeg_save_markers(&srcinfo, JPEG_COM, 0xFFFF);
+    for (int m = 0; m < 16; m++)
+        jpeg_save_markers(&srcinfo, JPEG_APP0 + m, 0xFFFF);
+    jpeg_read_header(&srcinfo, TRUE);
+
+    JOCTET* exif_orientation = nullptr;
+    bool exif_big_endian = false;
+    for (auto marker = srcinfo.marker_list; marker != nullptr && !exif_orientation; marker = marker->next) {
+        if (marker->marker != JPEG_APP0 + 1)
+            continue;
+        int offset = FindExifOrientation(marker->data, marker->data_length, &exif_big_endian);
+        if (offset >= 0)
+            exif_orientation = marker->data + offset;
+    }
+
+    nvimgcodecTransformOp_t op = flags.op;
+    if (flags.apply_exif_orientation) {
+        int orientation = 1;
+        if (exif_orientation)
+            orientation = exif_big_endian ? exif_orientation[1] : exif_orientation[0];
+        op = FromExifOrientation(orientation);
+    }
+    bool transposed = IsTransposed(op);
+
+    // Size of iMCU in samples. Single component images use single block MCUs.
+    bool single_component = srcinfo.num_components == 1;
+    int mcu_width = single_component ? DCTSIZE : srcinfo.max_h_samp_factor * DCTSIZE;
+    int mcu_height = single_component ? DCTSIZE : srcinfo.max_v_samp_factor * DCTSIZE;
+
+    int crop_x = 0, crop_y = 0;
+    int crop_width = srcinfo.image_width, crop_height = srcinfo.image_height;
+    if (flags.crop) {
+        if (flags.crop_x < 0 || flags.crop_y < 0 || flags.crop_width <= 0 || flags.crop_height <= 0 ||
+            flags.crop_x + flags.crop_width > static_cast<int>(srcinfo.image_width) ||
+            flags.crop_y + flags.crop_height > static_cast<int>(srcinfo.image_height)) {
+            jpeg_destroy_compress(&dstinfo);
+            jpeg_destroy_decompress(&srcinfo);
+            return false;
+        }
+        crop_x = flags.crop_x / mcu_width * mcu_width;
+        crop_y = flags.crop_y / mcu_height * mcu_height;
+        crop_width = flags.crop_x + flags.crop_width - crop_x;
+        crop_height = flags.crop_y + flags.crop_height - crop_y;
+    }
+    if (MovesRightEdge(op))
+        crop_width = crop_width / mcu_width * mcu_width;
+    if (MovesBottomEdge(op))
+        crop_height = crop_height / mcu_height * mcu_height;
+    if (crop_width == 0 || crop_height == 0) {
+        jpeg_destroy_compress(&dstinfo);
+        jpeg_destroy_decompress(&srcinfo);
+        return false;
+    }
+
+    windows.resize(srcinfo.num_components);
+    dst_coef_arrays.resize(srcinfo.num_components);
+    for (int c = 0; c < srcinfo.num_components; c++) {
+        auto& w = windows[c];
+        w.h_samp = single_component ? 1 : srcinfo.comp_info[c].h_samp_factor;
+        w.v_samp = single_component ? 1 : srcinfo.comp_info[c].v_samp_factor;
+        w.x0 = crop_x / mcu_width * w.h_samp;
+        w.y0 = crop_y / mcu_height * w.v_samp;
+        w.width = (crop_width + mcu_width - 1) / mcu_width * w.h_samp;
+        w.height = (crop_height + mcu_height - 1) / mcu_height * w.v_samp;
+        dst_coef_arrays[c] = (*srcinfo.mem->request_virt_barray)(reinterpret_cast<j_common_ptr>(&srcinfo), JPOOL_IMAGE, FALSE,
+            transposed ? w.height : w.width, transposed ? w.width : w.height, transposed ? w.h_samp : w.v_samp);
+    }
+
+    jvirt_barray_ptr* src_coef_arrays = jpeg_read_coefficients(&srcinfo);
+
+    jpeg_copy_critical_parameters(&srcinfo, &dstinfo);
+    dstinfo.image_width = transposed ? crop_height : crop_width;
+    dstinfo.image_height = transposed ? crop_width : crop_height;
+    for (int c = 0; c < dstinfo.num_components; c++) {
+        auto* comp = &dstinfo.comp_info[c];
+        comp->h_samp_factor = transposed ? windows[c].v_samp : windows[c].h_samp;
+        comp->v_samp_factor = transposed ? windows[c].h_samp : windows[c].v_samp;
+    }
+    if (transposed) {
+        for (int t = 0; t < NUM_QUANT_TBLS; t++) {
+            auto* qtbl = dstinfo.quant_tbl_ptrs[t];
+            if (qtbl == nullptr)
+                continue;
+            for (int i = 0; i < DCTSIZE; i++) {
+                for (int j = 0; j < i; j++)
+                    std::swap(qtbl->quantval[i * DCTSIZE + j], qtbl->quantval[j * DCTSIZE + i]);
+            }
+        }
+    }
+
+    for (int c = 0; c < srcinfo.num_components; c++) {
+        const auto& w = windows[c];
+        auto common = reinterpret_cast<j_common_ptr>(&srcinfo);
+        window_coefs.resize(static_cast<size_t>(w.width) * w.height * DCTSIZE2);
+        for (int y = 0; y < w.height; y++) {
+            JBLOCKARRAY row = (*srcinfo.mem->access_virt_barray)(common, src_coef_arrays[c], w.y0 + y, 1, FALSE);
+            std::memcpy(&window_coefs[static_cast<size_t>(y) * w.width * DCTSIZE2], row[0] + w.x0, w.width * sizeof(JBLOCK));
+        }
+        int dst_width = transposed ? w.height : w.width;
+        int dst_height = transposed ? w.width : w.height;
+        for (int y = 0; y < dst_height; y++) {
+            JBLOCKARRAY row = (*srcinfo.mem->access_virt_barray)(common, dst_coef_arrays[c], y, 1, TRUE);
+            for (int x = 0; x < dst_width; x++) {
+                int src_x, src_y;
+                SourceBlock(op, x, y, w.width, w.height, &src_x, &src_y);
+                TransformBlock(&window_coefs[(static_cast<size_t>(src_y) * w.width + src_x) * DCTSIZE2], row[0][x], op);
+            }
+        }
+    }
+
+    SetDest(&dstinfo, buffer.data(), buffer.size(), output);
+    jpeg_write_coefficients(&dstinfo, dst_coef_arrays.data());
+
+    if (flags.apply_exif_orientation && exif_orientation) {
+        exif_orientation[exif_big_endian ? 0 : 1] = 0;
+        exif_orientation[exif_big_endian ? 1 : 0] = 1;
+    }
+    for (auto marker = srcinfo.marker_list; marker != nullptr; marker = marker->next) {
+        // JFIF and Adobe markers are already written by the library
+        if (dstinfo.write_JFIF_header && marker->marker == JPEG_APP0 && marker->data_length >= 5 &&
+            std::memcmp(marker->data, "JFIF", 5) == 0)
+            continue;
+        if (dstinfo.write_Adobe_marker && marker->marker == JPEG_APP0 + 14 && marker->data_length >= 5 &&
+            std::memcmp(marker->data, "Adobe", 5) == 0)
+            continue;
+        jpeg_write_marker(&dstinfo, marker->marker, marker->data, marker->data_length);
+    }
+
+    jpeg_finish_compress(&dstinfo);
+    jpeg_destroy_compress(&dstinfo);
+    jpeg_finish_decompress(&srcinfo);
+    jpeg_destroy_decompress(&srcinfo);
+    return true;
+}
+
+}  // namespace libjpeg_turbo
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file declares lossless transformations of JPEG data in memory.
+// Blocks of DCT coefficients are rearranged without decoding the samples.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "nvimgcodec.h"
+
+namespace libjpeg_turbo {
+
+// Flags for Transform
+struct TransformFlags {
+  // Geometric operation, applied after the crop.
+  nvimgcodecTransformOp_t op = NVIMGCODEC_TRANSFORM_OP_NONE;
+
+  // If true, the operation is taken from the EXIF orientation tag instead of
+  // op, and the tag is reset to 1 in the output.
+  bool apply_exif_orientation = false;
+
+  // Settings of crop window. The top-left corner is moved up and left to the
+  // closest iMCU boundary, extending the window.
+  bool crop = false;
+  int crop_x = 0;
+  int crop_y = 0;
+  int crop_width = 0;
+  int crop_height = 0;
+};
+
+// Transforms the JPEG data and stores the result in output.
+// Operations which would move partial iMCUs from the right or bottom edge
+// drop them, so the output can be slightly smaller than the input.
+// Returns false on failure.
+bool Transform(const void* srcdata, uint64_t datasize, const TransformFlags& flags, std::string* output);
+
+}  // namespace libjpeg_turbo
@@ -20,6 +20,7 @@
 
 #include <cstring>
 #include <future>
+#include <optional>
 #include "jpeg_mem.h"
 #include "log.h"
 #undef INT32
@@ -28,6 +29,8 @@
 #include "error_handling.h"
 #include "../utils/stream_ctx.h"
 #include "../utils/parallel_exec.h"
+#include "../utils/scratch.h"
+#include "../utils/image_statistics.h"
 
 namespace libjpeg_turbo {
 struct DecoderImpl
@@ -58,6 +61,10 @@ struct DecoderImpl
 
     CodeStreamCtxManager code_stream_mgr_;
 
+    // Measured costs of checking and decoding samples, to decide how to parallelize the next batches
+    AdaptiveParallelPolicy can_decode_policy_;
+    std::shared_ptr<AdaptiveParallelPolicy> decode_policy_ = std::make_shared<AdaptiveParallelPolicy>();
+
     // Options
     bool fancy_upsampling_;
     bool fast_idct_;
@@ -65,7 +72,7 @@ struct DecoderImpl
 
 LibjpegTurboDecoderPlugin::LibjpegTurboDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "jpeg", NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create,
-          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch}
+          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch, 1}
     , framework_(framework)
 {
 }
@@ -163,7 +170,7 @@ nvimgcodecStatus_t DecoderImpl::canDecode(nvimgcodecProcessingStatus_t* status,
             auto this_ptr = reinterpret_cast<DecoderImpl*>(context);
             this_ptr->canDecodeImpl(*this_ptr->code_stream_mgr_[stream_idx]);
         };
-        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_);
+        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_, &can_decode_policy_);
         for (int i = 0; i < batch_size; i++) {
             status[i] = code_stream_mgr_.get_batch_item(i).processing_status;
         }
@@ -191,6 +198,7 @@ DecoderImpl::DecoderImpl(
     : plugin_id_(plugin_id)
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
     parseOptions(std::move(options));
 }
@@ -340,31 +348,78 @@ void DecoderImpl::decodeImpl(BatchItemCtx& batch_item)
         } else if (orig_sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR) {
             flags.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_BGR;
         }
-        auto decoded_image = libjpeg_turbo::Uncompress(ctx->encoded_stream_data_, ctx->encoded_stream_data_size_, flags);
-        if (decoded_image == nullptr) {
-            image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
-            return;
-        } else if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST) {
+
+        if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST) {
             image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
             return;
         }
 
-        const uint8_t* src = decoded_image.get();
-        uint8_t* dst = reinterpret_cast<uint8_t*>(info.buffer);
-        if (orig_sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB || orig_sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR) {
-            const int num_channels = 3;
-            uint32_t plane_size = info.plane_info[0].height * info.plane_info[0].width;
-            for (uint32_t i = 0; i < info.plane_info[0].height * info.plane_info[0].width; i++) {
-                *(dst + plane_size * 0 + i) = *(src + 0 + i * num_channels);
-                *(dst + plane_size * 1 + i) = *(src + 1 + i * num_channels);
-                *(dst + plane_size * 2 + i) = *(src + 2 + i * num_channels);
+        // Decoded rows hold channels in the output order, planes being channels for planar formats
+        std::optional<ImageStatisticsAccumulator> stats;
+        if (auto* stats_out = ImageStatisticsAccumulator::Find(info))
+            stats.emplace(stats_out, flags.components);
+
+        // Copies num_rows decoded rows to the output buffer, which holds plane_rows rows per plane
+        auto copy_rows = [&](const uint8_t* src, uint32_t num_rows, uint32_t plane_rows) {
+            uint8_t* dst = reinterpret_cast<uint8_t*>(info.buffer);
+            if (orig_sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB || orig_sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR) {
+                const int num_channels = 3;
+                uint32_t plane_size = plane_rows * info.plane_info[0].width;
+                for (uint32_t i = 0; i < num_rows * info.plane_info[0].width; i++) {
+                    *(dst + plane_size * 0 + i) = *(src + 0 + i * num_channels);
+                    *(dst + plane_size * 1 + i) = *(src + 1 + i * num_channels);
+                    *(dst + plane_size * 2 + i) = *(src + 2 + i * num_channels);
+                }
+                if (stats)
+                    stats->add(src, num_rows * info.plane_info[0].width, 0, num_channels);
+            } else {
+                uint32_t row_size_bytes = info.plane_info[0].width * flags.components * sizeof(uint8_t);
+                for (uint32_t y = 0; y < num_rows; y++, dst += info.plane_info[0].row_stride, src += row_size_bytes) {
+                    std::memcpy(dst, src, row_size_bytes);
+                    if (stats)
+                        stats->add(src, info.plane_info[0].width, 0, flags.components);
+                }
             }
-        } else {
-            uint32_t row_size_bytes = info.plane_info[0].width * flags.components * sizeof(uint8_t);
-            for (uint32_t y = 0; y < info.plane_info[0].height; y++, dst += info.plane_info[0].row_stride, src += row_size_bytes) {
-                std::memcpy(dst, src, row_size_bytes);
+        };
+
+        auto* band_output = static_cast<const nvimgcodecBandOutput_t*>(info.struct_next);
+        while (band_output && band_output->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT)
+            band_output = static_cast<const nvimgcodecBandOutput_t*>(band_output->struct_next);
+        nvimgcodecImageInfo_t band_info = info;
+        if (band_output) {
+            if (band_output->band_height == 0 || !band_output->band_ready) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Invalid band output");
+                image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+                return;
             }
+            band_info.struct_next = nullptr;
+            band_info.region.ndim = 0;
+            flags.band_height = band_output->band_height;
+            flags.band_callback = [&](const uint8_t* band, int first_row, int num_rows) {
+                copy_rows(band, num_rows, band_output->band_height);
+                for (uint32_t p = 0; p < band_info.num_planes; p++)
+                    band_info.plane_info[p].height = num_rows;
+                return band_output->band_ready(band_output->band_ctx, &band_info, first_row, num_rows) == NVIMGCODEC_STATUS_SUCCESS;
+            };
+        }
+
+        // The decoded image, or band, is only needed until it is copied to the output
+        ScratchScope scratch(framework_, GetHostAllocator(exec_params_));
+        flags.allocate_output = [&](size_t size) { return scratch.allocate(size); };
+        auto decoded_image = libjpeg_turbo::Uncompress(ctx->encoded_stream_data_, ctx->encoded_stream_data_size_, flags);
+        if (decoded_image == nullptr) {
+            image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+            return;
         }
+
+        if (!band_output)
+            copy_rows(decoded_image.get(), info.plane_info[0].height, info.plane_info[0].height);
+        if (stats)
+            stats->finish();
+    } catch (const libjpeg_turbo::TruncatedJpegError& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode jpeg code stream - " << e.what());
+        image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED);
+        return;
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode jpeg code stream - " << e.what());
         image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
@@ -400,13 +455,7 @@ nvimgcodecStatus_t DecoderImpl::decodeBatch(
             this_ptr->decodeImpl(batch_item);
         };
 
-        if (batch_size == 1) {
-            task(0, 0, this);
-        } else {
-            for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
-                executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, sample_idx, this, task);
-            }
-        }
+        AdaptiveLaunchBatch(executor, NVIMGCODEC_DEVICE_CPU_ONLY, batch_size, this, task, decode_policy_);
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode jpeg batch - " << e.what());
         for (int i = 0; i < batch_size; ++i) {
@@ -0,0 +1,686 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libjpeg_turbo_encoder.h"
+#include "nvimgcodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "error_handling.h"
+#include "jpeg_mem.h"
+#include "log.h"
+#include "../utils/host_allocator.h"
+#include "../utils/image_metrics.h"
+#include "../utils/scratch.h"
+#include "../utils/struct_chain.h"
+
+namespace libjpeg_turbo {
+
+namespace {
+
+/**
+ * @brief Input samples as an interleaved image, planar RGB input is interleaved into a copy
+ *
+ * Planar YCbCr is kept as it is and compressed as raw data. Quality metrics are then measured on the luma plane.
+ */
+struct SourceImage
+{
+    const uint8_t* data = nullptr;
+    int stride = 0;
+    int width = 0;
+    int height = 0;
+    int components = 0;
+    bool raw = false;
+    const uint8_t* planes[3] = {};
+    int strides[3] = {};
+    std::vector<uint8_t, HostAllocator<uint8_t>> storage;
+};
+
+void PrepareSource(const nvimgcodecImageInfo_t& info, nvimgcodecChromaSubsampling_t out_subsampling,
+    const nvimgcodecHostAllocator_t* host_allocator, SourceImage* src)
+{
+    src->width = info.plane_info[0].width;
+    src->height = info.plane_info[0].height;
+    auto* buffer = static_cast<const uint8_t*>(info.buffer);
+    const uint8_t* planes[3] = {buffer, nullptr, nullptr};
+    size_t offset = 0;
+    for (uint32_t p = 0; p < info.num_planes && p < 3; p++) {
+        planes[p] = buffer + offset;
+        offset += info.plane_info[p].row_stride * info.plane_info[p].height;
+    }
+    if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB) {
+        src->components = 3;
+        src->stride = src->width * 3;
+        src->storage = std::vector<uint8_t, HostAllocator<uint8_t>>(
+            static_cast<size_t>(src->stride) * src->height, HostAllocator<uint8_t>(host_allocator));
+        for (int y = 0; y < src->height; y++) {
+            uint8_t* dst = &src->storage[static_cast<size_t>(y) * src->stride];
+            for (int p = 0; p < 3; p++) {
+                const uint8_t* plane_row = planes[p] + y * info.plane_info[p].row_stride;
+                for (int x = 0; x < src->width; x++)
+                    dst[x * 3 + p] = plane_row[x];
+            }
+        }
+        src->data = src->storage.data();
+    } else if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_YUV) {
+        // Grayscale output only needs the luma plane
+        src->components = 1;
+        src->stride = info.plane_info[0].row_stride;
+        src->data = buffer;
+        src->raw = out_subsampling != NVIMGCODEC_SAMPLING_GRAY;
+        for (int p = 0; p < 3; p++) {
+            src->planes[p] = planes[p];
+            src->strides[p] = static_cast<int>(info.plane_info[p].row_stride);
+        }
+    } else {
+        src->components = info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y ? 1 : 3;
+        src->stride = info.plane_info[0].row_stride;
+        src->data = buffer;
+    }
+}
+
+bool CompressSource(const SourceImage& src, CompressFlags flags, std::string* output)
+{
+    if (src.raw)
+        return CompressRaw(src.planes, src.strides, src.width, src.height, flags, output);
+    flags.format = src.components == 1 ? FORMAT_GRAYSCALE : FORMAT_RGB;
+    flags.stride = src.stride;
+    return Compress(src.data, src.width, src.height, flags, output);
+}
+
+/**
+ * @brief Searches the quality which satisfies rate control targets of one sample
+ *
+ * Each step proposes several qualities, which are encoded concurrently, and narrows the search range
+ * depending on the results. Qualities reaching the PSNR and SSIM targets are searched first, then the size
+ * target is searched below the lowest of them.
+ */
+class QualitySearch
+{
+  public:
+    QualitySearch(const nvimgcodecRateControlParams_t& params, const CompressFlags& flags, const nvimgcodecFrameworkDesc_t* framework,
+        const nvimgcodecHostAllocator_t* host_allocator)
+        : params_(params)
+        , flags_(flags)
+        , framework_(framework)
+        , host_allocator_(host_allocator)
+        , num_candidates_(std::max(1, params.num_candidates))
+        , phase_(needsMetrics() ? Phase::QUALITY : Phase::SIZE)
+    {
+    }
+
+    SourceImage& source() { return source_; }
+
+    /**
+     * @brief Qualities to evaluate in the next step, empty when the search is over
+     */
+    const std::vector<int>& nextQualities()
+    {
+        pending_.clear();
+        while (phase_ != Phase::DONE && pending_.empty()) {
+            // The lowest quality with true predicate is in [lo_, hi_ + 1], and lo_ <= hi_ until the phase ends
+            for (int i = 0; i < num_candidates_; i++) {
+                int q = lo_ + (hi_ - lo_ + 1) * (i + 1) / (num_candidates_ + 1);
+                if (candidates_.count(q) == 0 && std::find(pending_.begin(), pending_.end(), q) == pending_.end())
+                    pending_.push_back(q);
+            }
+            if (pending_.empty())
+                narrow(); // all proposed qualities are known from the previous phase
+        }
+        if (phase_ == Phase::DONE && !failed_ && candidates_.count(result_) == 0)
+            pending_.push_back(result_);
+        for (int q : pending_)
+            candidates_[q]; // created here, so that concurrent evaluations don't modify the map
+        return pending_;
+    }
+
+    /**
+     * @brief Encodes with the given quality, can be called concurrently for different qualities
+     */
+    void evaluate(int quality)
+    {
+        auto& candidate = candidates_.at(quality);
+        CompressFlags flags = flags_;
+        flags.quality = quality;
+        candidate.ok = CompressSource(source_, flags, &candidate.data);
+        if (!candidate.ok || phase_ != Phase::QUALITY)
+            return;
+        ScratchScope scratch(framework_, host_allocator_);
+        UncompressFlags uncompress_flags;
+        uncompress_flags.allocate_output = [&](size_t size) { return scratch.allocate(size); };
+        uncompress_flags.components = source_.components;
+        uncompress_flags.sample_format = source_.components == 1 ? NVIMGCODEC_SAMPLEFORMAT_P_Y : NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        auto decoded = Uncompress(candidate.data.data(), candidate.data.size(), uncompress_flags);
+        if (!decoded) {
+            candidate.ok = false;
+            return;
+        }
+        size_t decoded_stride = static_cast<size_t>(source_.width) * source_.components;
+        if (params_.target_psnr > 0)
+            candidate.psnr = ComputePsnr(
+                source_.data, source_.stride, decoded.get(), decoded_stride, source_.width, source_.height, source_.components);
+        if (params_.target_ssim > 0)
+            candidate.ssim = ComputeSsim(
+                source_.data, source_.stride, decoded.get(), decoded_stride, source_.width, source_.height, source_.components);
+    }
+
+    /**
+     * @brief Takes the results of the qualities evaluated in the last step
+     */
+    void update()
+    {
+        for (int q : pending_) {
+            if (!candidates_.at(q).ok) {
+                failed_ = true;
+                phase_ = Phase::DONE;
+                return;
+            }
+        }
+        if (phase_ != Phase::DONE)
+            narrow();
+    }
+
+    bool failed() const { return failed_; }
+    int quality() const { return result_; }
+    const std::string& result() const { return candidates_.at(result_).data; }
+
+  private:
+    enum class Phase
+    {
+        QUALITY,
+        SIZE,
+        DONE
+    };
+
+    struct Candidate
+    {
+        std::string data;
+        double psnr = 0;
+        double ssim = 0;
+        bool ok = false;
+    };
+
+    bool needsMetrics() const { return params_.target_psnr > 0 || params_.target_ssim > 0; }
+
+    // Monotonically increasing with quality
+    bool predicate(const Candidate& candidate) const
+    {
+        if (phase_ == Phase::QUALITY)
+            return (params_.target_psnr <= 0 || candidate.psnr >= params_.target_psnr) &&
+                   (params_.target_ssim <= 0 || candidate.ssim >= params_.target_ssim);
+        return candidate.data.size() > params_.target_size;
+    }
+
+    void narrow()
+    {
+        for (int q = lo_; q <= hi_; q++) {
+            auto it = candidates_.find(q);
+            if (it == candidates_.end())
+                continue;
+            if (predicate(it->second)) {
+                hi_ = q - 1;
+                break;
+            }
+            lo_ = q + 1;
+        }
+        if (lo_ <= hi_)
+            return;
+        if (phase_ == Phase::QUALITY) {
+            // The lowest quality reaching the targets, or the highest quality if none does
+            result_ = std::min(lo_, 100);
+            if (params_.target_size > 0) {
+                phase_ = Phase::SIZE;
+                lo_ = 1;
+                hi_ = result_;
+                return;
+            }
+        } else {
+            // The highest quality which fits, or the lowest quality if none does
+            result_ = std::max(lo_ - 1, 1);
+        }
+        phase_ = Phase::DONE;
+    }
+
+    nvimgcodecRateControlParams_t params_;
+    CompressFlags flags_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecHostAllocator_t* host_allocator_;
+    int num_candidates_;
+    SourceImage source_;
+    Phase phase_;
+    int lo_ = 1;
+    int hi_ = 100;
+    int result_ = 100;
+    bool failed_ = false;
+    std::map<int, Candidate> candidates_;
+    std::vector<int> pending_;
+};
+
+// Chroma planes have to cover the luma plane subsampled with the image chroma subsampling
+bool ChromaPlanesMatch(const nvimgcodecImageInfo_t& info)
+{
+    int h_factor, v_factor;
+    switch (info.chroma_subsampling) {
+    case NVIMGCODEC_SAMPLING_444:
+        h_factor = 1, v_factor = 1;
+        break;
+    case NVIMGCODEC_SAMPLING_422:
+        h_factor = 2, v_factor = 1;
+        break;
+    case NVIMGCODEC_SAMPLING_420:
+        h_factor = 2, v_factor = 2;
+        break;
+    case NVIMGCODEC_SAMPLING_440:
+        h_factor = 1, v_factor = 2;
+        break;
+    case NVIMGCODEC_SAMPLING_411:
+        h_factor = 4, v_factor = 1;
+        break;
+    case NVIMGCODEC_SAMPLING_410:
+        h_factor = 4, v_factor = 2;
+        break;
+    default:
+        return false;
+    }
+    uint32_t width = (info.plane_info[0].width + h_factor - 1) / h_factor;
+    uint32_t height = (info.plane_info[0].height + v_factor - 1) / v_factor;
+    for (int p = 1; p < 3; p++) {
+        if (info.plane_info[p].width != width || info.plane_info[p].height != height)
+            return false;
+    }
+    return true;
+}
+
+struct EncoderImpl
+{
+    EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~EncoderImpl();
+
+    nvimgcodecProcessingStatus_t canEncodeImpl(
+        nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params);
+    nvimgcodecStatus_t canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    nvimgcodecProcessingStatus_t encodeImpl(int sample_idx);
+    void searchQualities();
+    nvimgcodecStatus_t encodeBatch(
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecEncoder_t encoder);
+    static nvimgcodecStatus_t static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecStatus_t static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct Sample
+    {
+        nvimgcodecImageDesc_t* image;
+        nvimgcodecCodeStreamDesc_t* code_stream;
+        nvimgcodecImageInfo_t image_info;
+        CompressFlags flags;
+        std::unique_ptr<QualitySearch> search;
+    };
+    std::vector<Sample> samples_;
+};
+
+} // namespace
+
+LibjpegTurboEncoderPlugin::LibjpegTurboEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : encoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_ENCODER_DESC, sizeof(nvimgcodecEncoderDesc_t), NULL, this, plugin_id_, "jpeg",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, EncoderImpl::static_destroy, EncoderImpl::static_can_encode,
+          EncoderImpl::static_encode_batch}
+    , framework_(framework)
+{
+}
+
+nvimgcodecEncoderDesc_t* LibjpegTurboEncoderPlugin::getEncoderDesc()
+{
+    return &encoder_desc_;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::canEncodeImpl(
+    nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params)
+{
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(code_stream->instance, &out_info);
+    if (strcmp(out_info.codec_name, "jpeg") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(image->instance, &info);
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (auto* jpeg_info = FindStruct<nvimgcodecJpegImageInfo_t>(out_info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO)) {
+        if (jpeg_info->encoding != NVIMGCODEC_JPEG_ENCODING_UNKNOWN && jpeg_info->encoding != NVIMGCODEC_JPEG_ENCODING_BASELINE_DCT &&
+            jpeg_info->encoding != NVIMGCODEC_JPEG_ENCODING_PROGRESSIVE_DCT_HUFFMAN)
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+    }
+    if (FindStruct<nvimgcodecBandInput_t>(info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT))
+        status |= NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED;
+    if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+
+    switch (info.sample_format) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        if (info.plane_info[0].num_channels != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+        if (info.num_planes != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_Y:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_YUV:
+        // Compressed as raw data, so the planes have to be subsampled as the output
+        if (out_info.chroma_subsampling == NVIMGCODEC_SAMPLING_GRAY)
+            break;
+        if (info.num_planes != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        else if (info.chroma_subsampling != out_info.chroma_subsampling || !ChromaPlanesMatch(info))
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
+        break;
+    }
+    for (uint32_t p = 0; p < info.num_planes && p < NVIMGCODEC_MAX_NUM_PLANES; p++) {
+        if (info.plane_info[p].sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+        if (info.sample_format != NVIMGCODEC_SAMPLEFORMAT_I_RGB && info.plane_info[p].num_channels != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+    }
+
+    switch (out_info.chroma_subsampling) {
+    case NVIMGCODEC_SAMPLING_GRAY:
+        break;
+    case NVIMGCODEC_SAMPLING_444:
+    case NVIMGCODEC_SAMPLING_422:
+    case NVIMGCODEC_SAMPLING_420:
+    case NVIMGCODEC_SAMPLING_440:
+    case NVIMGCODEC_SAMPLING_411:
+    case NVIMGCODEC_SAMPLING_410:
+        // Grayscale input has no chroma to subsample
+        if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+        break;
+    }
+    if (params->quality < 1 || params->quality > 100)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    return status;
+}
+
+nvimgcodecStatus_t EncoderImpl::canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_can_encode");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++)
+            status[i] = canEncodeImpl(images[i], code_streams[i], params);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if libjpeg_turbo can encode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->canEncode(status, images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+}
+
+EncoderImpl::~EncoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_destroy_encoder");
+}
+
+nvimgcodecStatus_t LibjpegTurboEncoderPlugin::create(
+    nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_create_encoder");
+        XM_CHECK_NULL(encoder);
+        XM_CHECK_NULL(exec_params);
+        *encoder = reinterpret_cast<nvimgcodecEncoder_t>(new EncoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create libjpeg_turbo encoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t LibjpegTurboEncoderPlugin::static_create(
+    void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<LibjpegTurboEncoderPlugin*>(instance);
+        return handle->create(encoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+nvimgcodecStatus_t EncoderImpl::static_destroy(nvimgcodecEncoder_t encoder)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::encodeImpl(int sample_idx)
+{
+    nvtx3::scoped_range marker{"libjpeg_turbo encode " + std::to_string(sample_idx)};
+    auto& sample = samples_[sample_idx];
+    try {
+        std::string encoded;
+        const std::string* output = &encoded;
+        if (sample.search) {
+            if (sample.search->failed()) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not compress jpeg during the quality search");
+                return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+            }
+            NVIMGCODEC_LOG_DEBUG(framework_, plugin_id_, "Rate control chose quality " << sample.search->quality());
+            output = &sample.search->result();
+        } else {
+            SourceImage src;
+            PrepareSource(sample.image_info, sample.flags.chroma_subsampling, GetHostAllocator(exec_params_), &src);
+            if (!CompressSource(src, sample.flags, &encoded)) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not compress jpeg");
+                return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+            }
+        }
+
+        nvimgcodecIoStreamDesc_t* io_stream = sample.code_stream->io_stream;
+        size_t written_size = 0;
+        io_stream->reserve(io_stream->instance, output->size());
+        io_stream->write(io_stream->instance, &written_size, const_cast<char*>(output->data()), output->size());
+        io_stream->flush(io_stream->instance);
+        if (written_size != output->size()) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not write jpeg code stream");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode jpeg code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+void EncoderImpl::searchQualities()
+{
+    struct Evaluation
+    {
+        QualitySearch* search;
+        int quality;
+    };
+    struct StepCtx
+    {
+        std::vector<Evaluation> evaluations;
+        std::vector<std::promise<void>> promises;
+    } step;
+    auto executor = exec_params_->executor;
+    while (true) {
+        // Candidates of all samples in a step are evaluated concurrently
+        step.evaluations.clear();
+        for (auto& sample : samples_) {
+            if (sample.search) {
+                for (int q : sample.search->nextQualities())
+                    step.evaluations.push_back({sample.search.get(), q});
+            }
+        }
+        if (step.evaluations.empty())
+            break;
+
+        step.promises = std::vector<std::promise<void>>(step.evaluations.size());
+        std::vector<std::future<void>> futures;
+        futures.reserve(step.promises.size());
+        for (auto& p : step.promises)
+            futures.push_back(p.get_future());
+        // This is not an executor thread, so it can block until the executor threads are done
+        for (size_t i = 0; i < step.evaluations.size(); i++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, static_cast<int>(i), &step,
+                [](int tid, int idx, void* context) -> void {
+                    auto* step = reinterpret_cast<StepCtx*>(context);
+                    auto& evaluation = step->evaluations[idx];
+                    evaluation.search->evaluate(evaluation.quality);
+                    step->promises[idx].set_value();
+                });
+        }
+        for (auto& f : futures)
+            f.wait();
+
+        for (auto& sample : samples_) {
+            if (sample.search)
+                sample.search->update();
+        }
+    }
+}
+
+nvimgcodecStatus_t EncoderImpl::encodeBatch(
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_encode_batch");
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        auto executor = exec_params_->executor;
+        XM_CHECK_NULL(executor);
+
+        auto* jpeg_params = FindStruct<nvimgcodecJpegEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_JPEG_ENCODE_PARAMS);
+        auto* rate_control = FindStruct<nvimgcodecRateControlParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS);
+        samples_.clear();
+        samples_.resize(batch_size);
+        for (int i = 0; i < batch_size; i++) {
+            auto& sample = samples_[i];
+            sample.image = images[i];
+            sample.code_stream = code_streams[i];
+            sample.image_info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            images[i]->getImageInfo(images[i]->instance, &sample.image_info);
+            nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            code_streams[i]->getImageInfo(code_streams[i]->instance, &out_info);
+
+            sample.flags.quality = static_cast<int>(params->quality);
+            sample.flags.chroma_subsampling = out_info.chroma_subsampling;
+            sample.flags.optimize_jpeg_size = jpeg_params && jpeg_params->optimized_huffman;
+            auto* jpeg_info = FindStruct<nvimgcodecJpegImageInfo_t>(out_info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO);
+            sample.flags.progressive = jpeg_info && jpeg_info->encoding == NVIMGCODEC_JPEG_ENCODING_PROGRESSIVE_DCT_HUFFMAN;
+            if (rate_control && (rate_control->target_size > 0 || rate_control->target_psnr > 0 || rate_control->target_ssim > 0)) {
+                auto* host_allocator = GetHostAllocator(exec_params_);
+                sample.search = std::make_unique<QualitySearch>(*rate_control, sample.flags, framework_, host_allocator);
+                PrepareSource(sample.image_info, sample.flags.chroma_subsampling, host_allocator, &sample.search->source());
+            }
+        }
+
+        if (rate_control)
+            searchQualities();
+
+        for (int i = 0; i < batch_size; i++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, i, this, [](int tid, int sample_idx, void* context) -> void {
+                auto* this_ptr = reinterpret_cast<EncoderImpl*>(context);
+                auto& sample = this_ptr->samples_[sample_idx];
+                auto result = this_ptr->encodeImpl(sample_idx);
+                sample.image->imageReady(sample.image->instance, result);
+            });
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode jpeg batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->encodeBatch(images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace libjpeg_turbo
@@ -16,7 +16,10 @@
  */
 
 #include <nvimgcodec.h>
+#include <cstddef>
 #include "libjpeg_turbo_decoder.h"
+#include "libjpeg_turbo_encoder.h"
+#include "libjpeg_turbo_transformer.h"
 #include "log.h"
 #include "error_handling.h"
 
@@ -27,11 +30,27 @@ struct LibjpegTurboImgCodecsExtension
   public:
     explicit LibjpegTurboImgCodecsExtension(const nvimgcodecFrameworkDesc_t* framework)
         : framework_(framework)
+        , has_transformers_(framework->struct_size >= offsetof(nvimgcodecFrameworkDesc_t, unregisterTransformer) + sizeof(void*) &&
+                            framework->registerTransformer && framework->unregisterTransformer)
         , jpeg_decoder_(framework)
+        , jpeg_encoder_(framework)
+        , jpeg_transformer_(framework)
     {
         framework->registerDecoder(framework->instance, jpeg_decoder_.getDecoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        framework->registerEncoder(framework->instance, jpeg_encoder_.getEncoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        // Frameworks older than extension API 0.3 have no transformers, the extension then only decodes and encodes
+        if (has_transformers_)
+            framework->registerTransformer(framework->instance, jpeg_transformer_.getTransformerDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        else
+            NVIMGCODEC_LOG_WARNING(framework, "libjpeg_turbo_ext", "Framework does not support transformers, lossless transforms are disabled");
+    }
+    ~LibjpegTurboImgCodecsExtension()
+    {
+        if (has_transformers_)
+            framework_->unregisterTransformer(framework_->instance, jpeg_transformer_.getTransformerDesc());
+        framework_->unregisterEncoder(framework_->instance, jpeg_encoder_.getEncoderDesc());
+        framework_->unregisterDecoder(framework_->instance, jpeg_decoder_.getDecoderDesc());
     }
-    ~LibjpegTurboImgCodecsExtension() { framework_->unregisterDecoder(framework_->instance, jpeg_decoder_.getDecoderDesc()); }
     static nvimgcodecStatus_t libjpegTurboExtensionCreate(
         void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
     {
@@ -63,7 +82,10 @@ struct LibjpegTurboImgCodecsExtension
 
   private:
     const nvimgcodecFrameworkDesc_t* framework_;
+    bool has_transformers_;
     LibjpegTurboDecoderPlugin jpeg_decoder_;
+    LibjpegTurboEncoderPlugin jpeg_encoder_;
+    LibjpegTurboTransformerPlugin jpeg_transformer_;
 };
 
 } // namespace libjpeg_turbo
@@ -0,0 +1,314 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libjpeg_turbo_transformer.h"
+#include "nvimgcodec.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "error_handling.h"
+#include "jpeg_transform.h"
+#include "log.h"
+#include "../utils/parallel_exec.h"
+
+namespace libjpeg_turbo {
+
+struct TransformerImpl
+{
+    TransformerImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~TransformerImpl();
+
+    nvimgcodecProcessingStatus_t canTransformImpl(
+        nvimgcodecCodeStreamDesc_t* in_code_stream, nvimgcodecCodeStreamDesc_t* out_code_stream, const nvimgcodecTransformParams_t* params);
+    nvimgcodecStatus_t canTransform(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** in_code_streams,
+        nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size, const nvimgcodecTransformParams_t* params);
+
+    nvimgcodecProcessingStatus_t transformImpl(
+        nvimgcodecCodeStreamDesc_t* in_code_stream, nvimgcodecCodeStreamDesc_t* out_code_stream, const nvimgcodecTransformParams_t* params);
+    nvimgcodecStatus_t transformBatch(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** in_code_streams,
+        nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size, const nvimgcodecTransformParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecTransformer_t transformer);
+    static nvimgcodecStatus_t static_can_transform(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+        const nvimgcodecTransformParams_t* params);
+    static nvimgcodecStatus_t static_transform_batch(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+        const nvimgcodecTransformParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct BatchItem
+    {
+        nvimgcodecCodeStreamDesc_t* in_code_stream;
+        nvimgcodecCodeStreamDesc_t* out_code_stream;
+        nvimgcodecProcessingStatus_t* status;
+    };
+    struct Batch
+    {
+        TransformerImpl* transformer;
+        const nvimgcodecTransformParams_t* params;
+        std::vector<BatchItem> items;
+    };
+};
+
+LibjpegTurboTransformerPlugin::LibjpegTurboTransformerPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : transformer_desc_{NVIMGCODEC_STRUCTURE_TYPE_TRANSFORMER_DESC, sizeof(nvimgcodecTransformerDesc_t), NULL, this, plugin_id_, "jpeg",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, TransformerImpl::static_destroy, TransformerImpl::static_can_transform,
+          TransformerImpl::static_transform_batch}
+    , framework_(framework)
+{
+}
+
+nvimgcodecTransformerDesc_t* LibjpegTurboTransformerPlugin::getTransformerDesc()
+{
+    return &transformer_desc_;
+}
+
+nvimgcodecProcessingStatus_t TransformerImpl::canTransformImpl(
+    nvimgcodecCodeStreamDesc_t* in_code_stream, nvimgcodecCodeStreamDesc_t* out_code_stream, const nvimgcodecTransformParams_t* params)
+{
+    nvimgcodecJpegImageInfo_t jpeg_info{NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO, sizeof(nvimgcodecJpegImageInfo_t), 0};
+    nvimgcodecImageInfo_t in_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &jpeg_info};
+    in_code_stream->getImageInfo(in_code_stream->instance, &in_info);
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    out_code_stream->getImageInfo(out_code_stream->instance, &out_info);
+
+    if (strcmp(in_info.codec_name, "jpeg") != 0 || strcmp(out_info.codec_name, "jpeg") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    // Lossless JPEG has no DCT coefficients to rearrange
+    switch (jpeg_info.encoding) {
+    case NVIMGCODEC_JPEG_ENCODING_LOSSLESS_HUFFMAN:
+    case NVIMGCODEC_JPEG_ENCODING_DIFFERENTIAL_LOSSLESS_HUFFMAN:
+    case NVIMGCODEC_JPEG_ENCODING_LOSSLESS_ARITHMETIC:
+    case NVIMGCODEC_JPEG_ENCODING_DIFFERENTIAL_LOSSLESS_ARITHMETIC:
+        return NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+    default:
+        break;
+    }
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (in_info.plane_info[0].sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8)
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+    if (params->region.ndim != 0 && params->region.ndim != 2)
+        status |= NVIMGCODEC_PROCESSING_STATUS_ROI_UNSUPPORTED;
+    if (params->op < NVIMGCODEC_TRANSFORM_OP_NONE || params->op > NVIMGCODEC_TRANSFORM_OP_ROT_270)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    return status;
+}
+
+nvimgcodecStatus_t TransformerImpl::canTransform(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** in_code_streams,
+    nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size, const nvimgcodecTransformParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "can_transform");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(in_code_streams);
+        XM_CHECK_NULL(out_code_streams);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++) {
+            XM_CHECK_NULL(in_code_streams[i]);
+            XM_CHECK_NULL(out_code_streams[i]);
+            status[i] = canTransformImpl(in_code_streams[i], out_code_streams[i], params);
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if libjpeg_turbo can transform - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t TransformerImpl::static_can_transform(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+    const nvimgcodecTransformParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(transformer);
+        auto handle = reinterpret_cast<TransformerImpl*>(transformer);
+        return handle->canTransform(status, in_code_streams, out_code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+TransformerImpl::TransformerImpl(
+    const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+}
+
+nvimgcodecStatus_t LibjpegTurboTransformerPlugin::create(
+    nvimgcodecTransformer_t* transformer, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_create");
+        XM_CHECK_NULL(transformer);
+        XM_CHECK_NULL(exec_params);
+        *transformer = reinterpret_cast<nvimgcodecTransformer_t>(new TransformerImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create libjpeg_turbo transformer - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t LibjpegTurboTransformerPlugin::static_create(
+    void* instance, nvimgcodecTransformer_t* transformer, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<LibjpegTurboTransformerPlugin*>(instance);
+        return handle->create(transformer, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+TransformerImpl::~TransformerImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_destroy");
+}
+
+nvimgcodecStatus_t TransformerImpl::static_destroy(nvimgcodecTransformer_t transformer)
+{
+    try {
+        XM_CHECK_NULL(transformer)
+        auto handle = reinterpret_cast<TransformerImpl*>(transformer);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecProcessingStatus_t TransformerImpl::transformImpl(
+    nvimgcodecCodeStreamDesc_t* in_code_stream, nvimgcodecCodeStreamDesc_t* out_code_stream, const nvimgcodecTransformParams_t* params)
+{
+    nvtx3::scoped_range marker{"libjpeg_turbo transform"};
+    try {
+        nvimgcodecIoStreamDesc_t* in_io_stream = in_code_stream->io_stream;
+        size_t encoded_size = 0;
+        in_io_stream->size(in_io_stream->instance, &encoded_size);
+        void* encoded_data = nullptr;
+        std::vector<uint8_t> buffer;
+        in_io_stream->map(in_io_stream->instance, &encoded_data, 0, encoded_size);
+        if (!encoded_data) {
+            buffer.resize(encoded_size);
+            in_io_stream->seek(in_io_stream->instance, 0, SEEK_SET);
+            size_t read_nbytes = 0;
+            in_io_stream->read(in_io_stream->instance, &read_nbytes, buffer.data(), encoded_size);
+            if (read_nbytes != encoded_size) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Unexpected end-of-stream");
+                return NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED;
+            }
+            encoded_data = buffer.data();
+        }
+
+        TransformFlags flags;
+        flags.op = params->op;
+        flags.apply_exif_orientation = params->apply_exif_orientation;
+        if (params->region.ndim == 2) {
+            flags.crop = true;
+            flags.crop_y = params->region.start[0];
+            flags.crop_x = params->region.start[1];
+            flags.crop_height = params->region.end[0] - params->region.start[0];
+            flags.crop_width = params->region.end[1] - params->region.start[1];
+        }
+
+        std::string transformed;
+        bool ok = Transform(encoded_data, encoded_size, flags, &transformed);
+        if (encoded_data != buffer.data())
+            in_io_stream->unmap(in_io_stream->instance, encoded_data, encoded_size);
+        if (!ok) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not transform jpeg code stream");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+
+        nvimgcodecIoStreamDesc_t* out_io_stream = out_code_stream->io_stream;
+        size_t written_size = 0;
+        out_io_stream->reserve(out_io_stream->instance, transformed.size());
+        out_io_stream->write(out_io_stream->instance, &written_size, transformed.data(), transformed.size());
+        if (written_size != transformed.size()) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not write transformed code stream");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+        if (out_io_stream->flush(out_io_stream->instance) != NVIMGCODEC_STATUS_SUCCESS) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not flush transformed code stream");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not transform jpeg code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t TransformerImpl::transformBatch(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** in_code_streams,
+    nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size, const nvimgcodecTransformParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libjpeg_turbo_transform_batch");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(in_code_streams);
+        XM_CHECK_NULL(out_code_streams);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+
+        Batch batch{this, params};
+        for (int i = 0; i < batch_size; i++)
+            batch.items.push_back({in_code_streams[i], out_code_streams[i], &status[i]});
+
+        auto task = [](int tid, int sample_idx, void* context) -> void {
+            auto* batch = reinterpret_cast<Batch*>(context);
+            auto& item = batch->items[sample_idx];
+            *item.status = batch->transformer->transformImpl(item.in_code_stream, item.out_code_stream, batch->params);
+        };
+        BlockParallelExec(&batch, task, batch_size, exec_params_);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not transform jpeg batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            status[i] = NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t TransformerImpl::static_transform_batch(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+    const nvimgcodecTransformParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(transformer);
+        auto handle = reinterpret_cast<TransformerImpl*>(transformer);
+        return handle->transformBatch(status, in_code_streams, out_code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace libjpeg_turbo
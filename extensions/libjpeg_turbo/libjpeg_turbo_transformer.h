@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "nvimgcodec.h"
+
+namespace libjpeg_turbo {
+
+class LibjpegTurboTransformerPlugin
+{
+  public:
+    explicit LibjpegTurboTransformerPlugin(const nvimgcodecFrameworkDesc_t* framework);
+    nvimgcodecTransformerDesc_t* getTransformerDesc();
+
+  private:
+    nvimgcodecStatus_t create(nvimgcodecTransformer_t* transformer, const nvimgcodecExecutionParams_t* exec_params, const char* options);
+    static nvimgcodecStatus_t static_create(
+        void* instance, nvimgcodecTransformer_t* transformer, const nvimgcodecExecutionParams_t* exec_params, const char* options);
+
+    static constexpr const char* plugin_id_ = "libjpeg_turbo_transformer";
+    nvimgcodecTransformerDesc_t transformer_desc_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+};
+
+} // namespace libjpeg_turbo
@@ -20,11 +20,14 @@
 #include <algorithm>
 #include <cstring>
 #include <future>
+#include <optional>
 
 #define NOMINMAX
 #include <nvtx3/nvtx3.hpp>
 #include "../utils/parallel_exec.h"
+#include "../utils/scratch.h"
 #include "../utils/stream_ctx.h"
+#include "../utils/image_statistics.h"
 #include "imgproc/convert.h"
 #include "error_handling.h"
 #include "imgproc/color_space_conversion_impl.h"
@@ -134,6 +137,51 @@ std::unique_ptr<TIFF, void (*)(TIFF*)> OpenTiff(nvimgcodecIoStreamDesc_t* io_str
     return {tiffptr, &TIFFClose};
 }
 
+const nvimgcodecTiffDecodeParams_t* GetTiffDecodeParams(const nvimgcodecDecodeParams_t* params)
+{
+    auto* tiff_params = static_cast<const nvimgcodecTiffDecodeParams_t*>(params->struct_next);
+    while (tiff_params && tiff_params->struct_type != NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS)
+        tiff_params = static_cast<const nvimgcodecTiffDecodeParams_t*>(tiff_params->struct_next);
+    return tiff_params;
+}
+
+/**
+ * @brief Maps the pyramid level requested in the decode parameters to an index in the levels reported by the TIFF parser.
+ *
+ * @return the level index, or -1 if the requested level does not exist
+ */
+int GetTiffLevelIndex(
+    const nvimgcodecTiffImageInfo_t& tiff_info, const nvimgcodecTiffDecodeParams_t& tiff_params, const nvimgcodecImageInfo_t& image_info)
+{
+    int num_levels = static_cast<int>(tiff_info.num_levels);
+    if (tiff_params.level == NVIMGCODEC_TIFF_LEVEL_AUTO) {
+        uint32_t target_width = tiff_params.target_width ? tiff_params.target_width : image_info.plane_info[0].width;
+        uint32_t target_height = tiff_params.target_height ? tiff_params.target_height : image_info.plane_info[0].height;
+        // Levels are sorted by decreasing size, so the last one that still covers the target is the cheapest to decode
+        int level_idx = 0;
+        for (int i = 0; i < num_levels; i++) {
+            if (tiff_info.levels[i].width >= target_width && tiff_info.levels[i].height >= target_height)
+                level_idx = i;
+        }
+        return level_idx;
+    }
+    if (tiff_params.level == 0 || (tiff_params.level > 0 && tiff_params.level < num_levels))
+        return tiff_params.level;
+    return -1;
+}
+
+/**
+ * @brief Queries the pyramid levels of the code stream and returns the index of the level requested in the decode parameters.
+ */
+int GetTiffLevelIndex(nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecTiffDecodeParams_t& tiff_params,
+    const nvimgcodecImageInfo_t& image_info, nvimgcodecTiffImageInfo_t* tiff_info)
+{
+    nvimgcodecImageInfo_t cs_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), tiff_info};
+    if (code_stream->getImageInfo(code_stream->instance, &cs_image_info) != NVIMGCODEC_STATUS_SUCCESS || tiff_info->num_levels == 0)
+        return -1;
+    return GetTiffLevelIndex(*tiff_info, tiff_params, image_info);
+}
+
 struct TiffInfo
 {
     uint32_t image_width, image_height;
@@ -310,11 +358,15 @@ struct DecoderImpl
     const nvimgcodecExecutionParams_t* exec_params_;
 
     CodeStreamCtxManager code_stream_mgr_;
+
+    // Measured costs of checking and decoding samples, to decide how to parallelize the next batches
+    AdaptiveParallelPolicy can_decode_policy_;
+    std::shared_ptr<AdaptiveParallelPolicy> decode_policy_ = std::make_shared<AdaptiveParallelPolicy>();
 };
 
 LibtiffDecoderPlugin::LibtiffDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "tiff", NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create,
-          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch}
+          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch, 1}
     , framework_(framework)
 {}
 
@@ -398,6 +450,13 @@ nvimgcodecStatus_t DecoderImpl::canDecodeImpl(CodeStreamCtx& ctx)
                 (image_info.orientation.flip_x || image_info.orientation.flip_y || image_info.orientation.rotated != 0)) {
                 *status |= NVIMGCODEC_PROCESSING_STATUS_ORIENTATION_UNSUPPORTED;
             }
+
+            auto* tiff_params = GetTiffDecodeParams(params);
+            if (tiff_params && tiff_params->level != 0) {
+                nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), nullptr};
+                if (GetTiffLevelIndex(code_stream, *tiff_params, image_info, &tiff_info) < 0)
+                    *status |= NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED;
+            }
         }
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if libtiff can decode - " << e.what());
@@ -424,7 +483,7 @@ nvimgcodecStatus_t DecoderImpl::canDecode(nvimgcodecProcessingStatus_t* status,
             auto this_ptr = reinterpret_cast<DecoderImpl*>(context);
             this_ptr->canDecodeImpl(*this_ptr->code_stream_mgr_[sample_idx]);
         };
-        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_);
+        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_, &can_decode_policy_);
         for (int i = 0; i < batch_size; i++) {
             status[i] = code_stream_mgr_.get_batch_item(i).processing_status;
         }
@@ -451,6 +510,7 @@ DecoderImpl::DecoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t*
     : plugin_id_(plugin_id)
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
 }
 
@@ -500,8 +560,8 @@ nvimgcodecStatus_t DecoderImpl::static_destroy(nvimgcodecDecoder_t decoder)
 }
 
 template <typename Output, typename Input>
-nvimgcodecProcessingStatus_t decodeImplTyped2(
-    const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t& image_info, TIFF* tiff, const TiffInfo& info)
+nvimgcodecProcessingStatus_t decodeImplTyped2(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t& image_info,
+    TIFF* tiff, const TiffInfo& info, const nvimgcodecBandOutput_t* band_output, const nvimgcodecHostAllocator_t* host_allocator)
 {
     if (info.photometric_interpretation != PHOTOMETRIC_RGB && info.photometric_interpretation != PHOTOMETRIC_MINISBLACK &&
         info.photometric_interpretation != PHOTOMETRIC_PALETTE) {
@@ -544,9 +604,8 @@ nvimgcodecProcessingStatus_t decodeImplTyped2(
         buf_nbytes = TIFFTileSize(tiff);
     }
 
-    std::unique_ptr<void, void (*)(void*)> buf{_TIFFmalloc(buf_nbytes), _TIFFfree};
-    if (buf.get() == nullptr)
-        throw std::runtime_error("Could not allocate memory");
+    ScratchScope scratch(framework, host_allocator);
+    void* buf = scratch.allocateBytes(buf_nbytes);
 
     int num_channels;
     bool planar;
@@ -606,156 +665,203 @@ nvimgcodecProcessingStatus_t decodeImplTyped2(
         // Need to read sequentially since not all the images support random access
         // If random access is not allowed, need to read sequentially all previous rows
         for (int64_t y = 0; y < region_start_y; y++) {
-            LIBTIFF_CALL(TIFFReadScanline(tiff, buf.get(), y, 0));
+            LIBTIFF_CALL(TIFFReadScanline(tiff, buf, y, 0));
         }
     }
 
     bool convert_needed = info.bit_depth != (sizeof(Input) * 8) || info.is_palette;
     Input* in;
-    std::vector<uint8_t> scratch;
     if (!convert_needed) {
-        in = static_cast<Input*>(buf.get());
+        in = static_cast<Input*>(buf);
     } else {
-        scratch.resize(info.tile_height * info.tile_width * info.channels * sizeof(Input));
-        in = reinterpret_cast<Input*>(scratch.data());
+        in = scratch.allocate<Input>(info.tile_height * info.tile_width * info.channels);
     }
 
     Output* img_out = reinterpret_cast<Output*>(image_info.buffer);
 
-    // For non-tiled TIFFs first_tile_x is always 0, because the scanline spans the whole image.
-    int64_t first_tile_y = region_start_y - region_start_y % info.tile_height;
-    int64_t first_tile_x = region_start_x - region_start_x % info.tile_width;
-
-    for (int64_t tile_y = first_tile_y; tile_y < region_end_y; tile_y += info.tile_height) {
-        for (int64_t tile_x = first_tile_x; tile_x < region_end_x; tile_x += info.tile_width) {
-            int64_t tile_begin_y = std::max(tile_y, region_start_y);
-            int64_t tile_begin_x = std::max(tile_x, region_start_x);
-            int64_t tile_end_y = std::min(tile_y + info.tile_height, region_end_y);
-            int64_t tile_end_x = std::min(tile_x + info.tile_width, region_end_x);
-            int64_t tile_size_y = tile_end_y - tile_begin_y;
-            int64_t tile_size_x = tile_end_x - tile_begin_x;
-
-            if (info.is_tiled) {
-                auto ret = TIFFReadTile(tiff, buf.get(), tile_x, tile_y, 0, 0);
-                if (ret <= 0) {
-                    throw std::runtime_error("TIFFReadTile failed");
+    // Statistics are accumulated from each tile written to the output, while it is still in cache
+    std::optional<ImageStatisticsAccumulator> stats;
+    if (auto* stats_out = ImageStatisticsAccumulator::Find(image_info))
+        stats.emplace(stats_out, planar ? image_info.num_planes : image_info.plane_info[0].num_channels);
+
+    // Decodes rows [rows_begin, rows_end) of the region into the output buffer, which holds out_plane_rows rows per plane
+    auto decode_rows = [&](int64_t rows_begin, int64_t rows_end, int64_t out_plane_rows) -> nvimgcodecProcessingStatus_t {
+        // For non-tiled TIFFs first_tile_x is always 0, because the scanline spans the whole image.
+        int64_t first_tile_y = rows_begin - rows_begin % info.tile_height;
+        int64_t first_tile_x = region_start_x - region_start_x % info.tile_width;
+
+        for (int64_t tile_y = first_tile_y; tile_y < rows_end; tile_y += info.tile_height) {
+            for (int64_t tile_x = first_tile_x; tile_x < region_end_x; tile_x += info.tile_width) {
+                int64_t tile_begin_y = std::max(tile_y, rows_begin);
+                int64_t tile_begin_x = std::max(tile_x, region_start_x);
+                int64_t tile_end_y = std::min(tile_y + info.tile_height, rows_end);
+                int64_t tile_end_x = std::min(tile_x + info.tile_width, region_end_x);
+                int64_t tile_size_y = tile_end_y - tile_begin_y;
+                int64_t tile_size_x = tile_end_x - tile_begin_x;
+
+                if (info.is_tiled) {
+                    auto ret = TIFFReadTile(tiff, buf, tile_x, tile_y, 0, 0);
+                    if (ret <= 0) {
+                        throw std::runtime_error("TIFFReadTile failed");
+                    }
+                } else {
+                    LIBTIFF_CALL(TIFFReadScanline(tiff, buf, tile_y, 0));
                 }
-            } else {
-                LIBTIFF_CALL(TIFFReadScanline(tiff, buf.get(), tile_y, 0));
-            }
 
-            if (convert_needed) {
-                size_t input_values = info.tile_height * info.tile_width * info.channels;
-                if (info.is_palette)
-                    input_values /= info.channels;
-                TiffConvert(info, in, buf.get(), input_values);
-            }
+                if (convert_needed) {
+                    size_t input_values = info.tile_height * info.tile_width * info.channels;
+                    if (info.is_palette)
+                        input_values /= info.channels;
+                    TiffConvert(info, in, buf, input_values);
+                }
 
-            Output* dst = img_out + (tile_begin_y - region_start_y) * stride_y + (tile_begin_x - region_start_x) * stride_x;
-            const Input* src = in + (tile_begin_y - tile_y) * tile_stride_y + (tile_begin_x - tile_x) * tile_stride_x;
+                Output* dst = img_out + (tile_begin_y - rows_begin) * stride_y + (tile_begin_x - region_start_x) * stride_x;
+                const Input* src = in + (tile_begin_y - tile_y) * tile_stride_y + (tile_begin_x - tile_x) * tile_stride_x;
 
-            using nvimgcodec::ConvertSatNorm;
-            using nvimgcodec::rgb_to_gray;
-            using nvimgcodec::vec;
-            switch (image_info.sample_format) {
-            case NVIMGCODEC_SAMPLEFORMAT_P_Y:
-                if (info.channels == 1) {
-                    auto* plane = dst;
-                    for (uint32_t i = 0; i < tile_size_y; i++) {
-                        auto* row = plane + i * stride_y;
-                        auto* tile_row = src + i * tile_stride_y;
-                        for (uint32_t j = 0; j < tile_size_x; j++) {
-                            *(row + j * stride_x) = ConvertSatNorm<Output>(*(tile_row + j * tile_stride_x));
+                using nvimgcodec::ConvertSatNorm;
+                using nvimgcodec::rgb_to_gray;
+                using nvimgcodec::vec;
+                switch (image_info.sample_format) {
+                case NVIMGCODEC_SAMPLEFORMAT_P_Y:
+                    if (info.channels == 1) {
+                        auto* plane = dst;
+                        for (uint32_t i = 0; i < tile_size_y; i++) {
+                            auto* row = plane + i * stride_y;
+                            auto* tile_row = src + i * tile_stride_y;
+                            for (uint32_t j = 0; j < tile_size_x; j++) {
+                                *(row + j * stride_x) = ConvertSatNorm<Output>(*(tile_row + j * tile_stride_x));
+                            }
+                        }
+                    } else if (info.channels >= 3) {
+                        uint32_t plane_stride = out_plane_rows * image_info.plane_info[0].row_stride;
+                        for (uint32_t c = 0; c < image_info.num_planes; c++) {
+                            auto* plane = dst + c * plane_stride;
+                            for (uint32_t i = 0; i < tile_size_y; i++) {
+                                auto* row = plane + i * stride_y;
+                                auto* tile_row = src + i * tile_stride_y;
+                                for (uint32_t j = 0; j < tile_size_x; j++) {
+                                    auto* pixel = tile_row + j * tile_stride_x;
+                                    auto* out_pixel = row + j * stride_x;
+                                    auto r = *(pixel + 0);
+                                    auto g = *(pixel + 1);
+                                    auto b = *(pixel + 2);
+                                    *(out_pixel) = rgb_to_gray<Output>(vec<3, Input>(r, g, b));
+                                }
+                            }
                         }
+                    } else {
+                        NVIMGCODEC_LOG_ERROR(
+                            framework, plugin_id, "Unexpected number of channels for conversion to grayscale: " << info.channels);
+                        return NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
                     }
-                } else if (info.channels >= 3) {
-                    uint32_t plane_stride = image_info.plane_info[0].height * image_info.plane_info[0].row_stride;
+                    break;
+                case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+                case NVIMGCODEC_SAMPLEFORMAT_P_BGR:
+                case NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED: {
+                    uint32_t plane_stride = out_plane_rows * image_info.plane_info[0].row_stride;
                     for (uint32_t c = 0; c < image_info.num_planes; c++) {
-                        auto* plane = dst + c * plane_stride;
+                        uint32_t dst_p = c;
+                        if (image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR)
+                            dst_p = c == 2 ? 0 : c == 0 ? 2 : c;
+                        auto* plane = dst + dst_p * plane_stride;
                         for (uint32_t i = 0; i < tile_size_y; i++) {
                             auto* row = plane + i * stride_y;
                             auto* tile_row = src + i * tile_stride_y;
                             for (uint32_t j = 0; j < tile_size_x; j++) {
-                                auto* pixel = tile_row + j * tile_stride_x;
-                                auto* out_pixel = row + j * stride_x;
-                                auto r = *(pixel + 0);
-                                auto g = *(pixel + 1);
-                                auto b = *(pixel + 2);
-                                *(out_pixel) = rgb_to_gray<Output>(vec<3, Input>(r, g, b));
+                                *(row + j * stride_x) = ConvertSatNorm<Output>(*(tile_row + j * tile_stride_x + c));
                             }
                         }
                     }
-                } else {
-                    NVIMGCODEC_LOG_ERROR(
-                        framework, plugin_id, "Unexpected number of channels for conversion to grayscale: " << info.channels);
-                    return NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
-                }
-                break;
-            case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
-            case NVIMGCODEC_SAMPLEFORMAT_P_BGR:
-            case NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED: {
-                uint32_t plane_stride = image_info.plane_info[0].height * image_info.plane_info[0].row_stride;
-                for (uint32_t c = 0; c < image_info.num_planes; c++) {
-                    uint32_t dst_p = c;
-                    if (image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR)
-                        dst_p = c == 2 ? 0 : c == 0 ? 2 : c;
-                    auto* plane = dst + dst_p * plane_stride;
+                } break;
+
+                case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+                case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
+                case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED: {
                     for (uint32_t i = 0; i < tile_size_y; i++) {
-                        auto* row = plane + i * stride_y;
+                        auto* row = dst + i * stride_y;
                         auto* tile_row = src + i * tile_stride_y;
                         for (uint32_t j = 0; j < tile_size_x; j++) {
-                            *(row + j * stride_x) = ConvertSatNorm<Output>(*(tile_row + j * tile_stride_x + c));
+                            auto* pixel = row + j * stride_x;
+                            auto* tile_pixel = tile_row + j * tile_stride_x;
+                            if (info.channels == 1) {
+                                for (uint32_t c = 0; c < image_info.plane_info[0].num_channels; c++) {
+                                    *(pixel + c) = ConvertSatNorm<Output>(*tile_pixel);
+                                }
+                            } else {
+                                assert(info.channels >= image_info.plane_info[0].num_channels);
+                                for (uint32_t c = 0; c < image_info.plane_info[0].num_channels; c++) {
+                                    uint32_t out_c = c;
+                                    if (image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_I_BGR)
+                                        out_c = c == 2 ? 0 : c == 0 ? 2 : c;
+                                    *(pixel + out_c) = ConvertSatNorm<Output>(*(tile_pixel + c));
+                                }
+                            }
                         }
                     }
+                } break;
+
+                case NVIMGCODEC_SAMPLEFORMAT_P_YUV:
+                default:
+                    NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Unsupported sample_format: " << image_info.sample_format);
+                    return NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
                 }
-            } break;
 
-            case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
-            case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
-            case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED: {
-                for (uint32_t i = 0; i < tile_size_y; i++) {
-                    auto* row = dst + i * stride_y;
-                    auto* tile_row = src + i * tile_stride_y;
-                    for (uint32_t j = 0; j < tile_size_x; j++) {
-                        auto* pixel = row + j * stride_x;
-                        auto* tile_pixel = tile_row + j * tile_stride_x;
-                        if (info.channels == 1) {
-                            for (uint32_t c = 0; c < image_info.plane_info[0].num_channels; c++) {
-                                *(pixel + c) = ConvertSatNorm<Output>(*tile_pixel);
-                            }
+                if (stats) {
+                    uint32_t plane_stride = out_plane_rows * image_info.plane_info[0].row_stride;
+                    for (int64_t i = 0; i < tile_size_y; i++) {
+                        if (planar) {
+                            for (uint32_t p = 0; p < image_info.num_planes; p++)
+                                stats->add(dst + p * plane_stride + i * stride_y, tile_size_x, p, 1);
                         } else {
-                            assert(info.channels >= image_info.plane_info[0].num_channels);
-                            for (uint32_t c = 0; c < image_info.plane_info[0].num_channels; c++) {
-                                uint32_t out_c = c;
-                                if (image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_I_BGR)
-                                    out_c = c == 2 ? 0 : c == 0 ? 2 : c;
-                                *(pixel + out_c) = ConvertSatNorm<Output>(*(tile_pixel + c));
-                            }
+                            stats->add(dst + i * stride_y, tile_size_x, 0, image_info.plane_info[0].num_channels);
                         }
                     }
                 }
-            } break;
-
-            case NVIMGCODEC_SAMPLEFORMAT_P_YUV:
-            default:
-                NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Unsupported sample_format: " << image_info.sample_format);
-                return NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
             }
         }
+        return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    };
+
+    if (!band_output) {
+        auto res = decode_rows(region_start_y, region_end_y, image_info.plane_info[0].height);
+        if (stats && res == NVIMGCODEC_PROCESSING_STATUS_SUCCESS)
+            stats->finish();
+        return res;
+    }
+
+    // Band by band output. Tiles spanning several bands are read once per band,
+    // so band heights which are multiples of the tile height perform best.
+    nvimgcodecImageInfo_t band_info = image_info;
+    band_info.struct_next = nullptr;
+    band_info.region.ndim = 0;
+    for (int64_t band_begin = region_start_y; band_begin < region_end_y; band_begin += band_output->band_height) {
+        int64_t band_end = std::min<int64_t>(band_begin + band_output->band_height, region_end_y);
+        auto res = decode_rows(band_begin, band_end, band_output->band_height);
+        if (res != NVIMGCODEC_PROCESSING_STATUS_SUCCESS)
+            return res;
+        uint32_t num_rows = band_end - band_begin;
+        for (uint32_t p = 0; p < band_info.num_planes; p++)
+            band_info.plane_info[p].height = num_rows;
+        if (band_output->band_ready(band_output->band_ctx, &band_info, band_begin - region_start_y, num_rows) != NVIMGCODEC_STATUS_SUCCESS) {
+            NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Band output was interrupted at row " << band_end);
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
     }
+    if (stats)
+        stats->finish();
     return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
 }
 
 template <typename Output>
-nvimgcodecProcessingStatus_t decodeImplTyped(
-    const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t& image_info, TIFF* tiff, const TiffInfo& info)
+nvimgcodecProcessingStatus_t decodeImplTyped(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t& image_info,
+    TIFF* tiff, const TiffInfo& info, const nvimgcodecBandOutput_t* band_output, const nvimgcodecHostAllocator_t* host_allocator)
 {
     if (info.bit_depth <= 8) {
-        return decodeImplTyped2<Output, uint8_t>(plugin_id, framework, image_info, tiff, info);
+        return decodeImplTyped2<Output, uint8_t>(plugin_id, framework, image_info, tiff, info, band_output, host_allocator);
     } else if (info.bit_depth <= 16) {
-        return decodeImplTyped2<Output, uint16_t>(plugin_id, framework, image_info, tiff, info);
+        return decodeImplTyped2<Output, uint16_t>(plugin_id, framework, image_info, tiff, info, band_output, host_allocator);
     } else if (info.bit_depth <= 32) {
-        return decodeImplTyped2<Output, uint32_t>(plugin_id, framework, image_info, tiff, info);
+        return decodeImplTyped2<Output, uint32_t>(plugin_id, framework, image_info, tiff, info, band_output, host_allocator);
     } else {
         NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Unsupported bit depth: " << info.bit_depth);
         return NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
@@ -792,23 +898,47 @@ void DecoderImpl::decodeImpl(BatchItemCtx& batch_item)
 
         io_stream->seek(io_stream->instance, 0, SEEK_SET);
         auto tiff = OpenTiff(io_stream);
+
+        auto* tiff_params = GetTiffDecodeParams(batch_item.params);
+        if (tiff_params && tiff_params->level != 0) {
+            nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), nullptr};
+            int level_idx = GetTiffLevelIndex(batch_item.code_stream_ctx->code_stream_, *tiff_params, image_info, &tiff_info);
+            if (level_idx < 0) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Invalid pyramid level: " << tiff_params->level);
+                image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+                return;
+            }
+            if (level_idx > 0)
+                LIBTIFF_CALL(TIFFSetSubDirectory(tiff.get(), tiff_info.levels[level_idx].ifd_offset));
+        }
+
+        auto* band_output = static_cast<const nvimgcodecBandOutput_t*>(image_info.struct_next);
+        while (band_output && band_output->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT)
+            band_output = static_cast<const nvimgcodecBandOutput_t*>(band_output->struct_next);
+        if (band_output && (band_output->band_height == 0 || !band_output->band_ready)) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Invalid band output");
+            image->imageReady(image->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+            return;
+        }
+
         auto info = GetTiffInfo(tiff.get());
+        auto* host_allocator = GetHostAllocator(exec_params_);
         nvimgcodecProcessingStatus_t res;
         switch (image_info.plane_info[0].sample_type) {
         case NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8:
-            res = decodeImplTyped<uint8_t>(plugin_id_, framework_, image_info, tiff.get(), info);
+            res = decodeImplTyped<uint8_t>(plugin_id_, framework_, image_info, tiff.get(), info, band_output, host_allocator);
             break;
         case NVIMGCODEC_SAMPLE_DATA_TYPE_INT8:
-            res = decodeImplTyped<int8_t>(plugin_id_, framework_, image_info, tiff.get(), info);
+            res = decodeImplTyped<int8_t>(plugin_id_, framework_, image_info, tiff.get(), info, band_output, host_allocator);
             break;
         case NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16:
-            res = decodeImplTyped<uint16_t>(plugin_id_, framework_, image_info, tiff.get(), info);
+            res = decodeImplTyped<uint16_t>(plugin_id_, framework_, image_info, tiff.get(), info, band_output, host_allocator);
             break;
         case NVIMGCODEC_SAMPLE_DATA_TYPE_INT16:
-            res = decodeImplTyped<int16_t>(plugin_id_, framework_, image_info, tiff.get(), info);
+            res = decodeImplTyped<int16_t>(plugin_id_, framework_, image_info, tiff.get(), info, band_output, host_allocator);
             break;
         case NVIMGCODEC_SAMPLE_DATA_TYPE_FLOAT32:
-            res = decodeImplTyped<float>(plugin_id_, framework_, image_info, tiff.get(), info);
+            res = decodeImplTyped<float>(plugin_id_, framework_, image_info, tiff.get(), info, band_output, host_allocator);
             break;
         default:
             NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Invalid data type: " << image_info.plane_info[0].sample_type);
@@ -851,14 +981,7 @@ nvimgcodecStatus_t DecoderImpl::decodeBatch(
             }
         };
 
-        if (code_stream_mgr_.size() == 1) {
-            task(0, 0, this);
-        } else {
-            auto executor = exec_params_->executor;
-            for (size_t stream_idx = 0; stream_idx < code_stream_mgr_.size(); stream_idx++) {
-                executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, stream_idx, this, task);
-            }
-        }
+        AdaptiveLaunchBatch(exec_params_->executor, NVIMGCODEC_DEVICE_CPU_ONLY, code_stream_mgr_.size(), this, task, decode_policy_);
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode tiff batch - " << e.what());
         return NVIMGCODEC_STATUS_INTERNAL_ERROR;
@@ -0,0 +1,702 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libtiff_encoder.h"
+#include <tiffio.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#if LIBTIFF_EXT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#define NOMINMAX
+#include <nvtx3/nvtx3.hpp>
+#include "../utils/parallel_exec.h"
+#include "error_handling.h"
+#include "log.h"
+#include "nvimgcodec.h"
+
+namespace libtiff {
+
+class EncoderHelper
+{
+  public:
+    explicit EncoderHelper(nvimgcodecIoStreamDesc_t* io_stream)
+        : io_stream_(io_stream)
+    {}
+
+    static tmsize_t read(thandle_t handle, void* buffer, tmsize_t n)
+    {
+        // libtiff reads back the directories it has written to link the following ones
+        EncoderHelper* helper = reinterpret_cast<EncoderHelper*>(handle);
+        size_t read_nbytes = 0;
+        if (helper->io_stream_->read(helper->io_stream_->instance, &read_nbytes, buffer, n) != NVIMGCODEC_STATUS_SUCCESS)
+            return 0;
+        return read_nbytes;
+    }
+
+    static tmsize_t write(thandle_t handle, void* buffer, tmsize_t n)
+    {
+        EncoderHelper* helper = reinterpret_cast<EncoderHelper*>(handle);
+        ptrdiff_t pos = 0;
+        if (helper->io_stream_->tell(helper->io_stream_->instance, &pos) != NVIMGCODEC_STATUS_SUCCESS)
+            return 0;
+        // Memory sinks only accept writes within the reserved size, so grow it geometrically
+        size_t required = static_cast<size_t>(pos) + n;
+        if (required > helper->capacity_) {
+            helper->capacity_ = std::max(required, 2 * helper->capacity_);
+            helper->io_stream_->reserve(helper->io_stream_->instance, helper->capacity_);
+        }
+        size_t written_nbytes = 0;
+        if (helper->io_stream_->write(helper->io_stream_->instance, &written_nbytes, buffer, n) != NVIMGCODEC_STATUS_SUCCESS)
+            return 0;
+        helper->end_ = std::max(helper->end_, static_cast<size_t>(pos) + written_nbytes);
+        return written_nbytes;
+    }
+
+    static toff_t seek(thandle_t handle, toff_t offset, int whence)
+    {
+        // The sink can be larger than what was written so far, so the end of data is tracked here
+        EncoderHelper* helper = reinterpret_cast<EncoderHelper*>(handle);
+        if (whence == SEEK_END) {
+            offset += helper->end_;
+            whence = SEEK_SET;
+        }
+        if (helper->io_stream_->seek(helper->io_stream_->instance, offset, whence) != NVIMGCODEC_STATUS_SUCCESS)
+            return -1;
+        ptrdiff_t curr_offset = 0;
+        if (helper->io_stream_->tell(helper->io_stream_->instance, &curr_offset) != NVIMGCODEC_STATUS_SUCCESS)
+            return -1;
+        return curr_offset;
+    }
+
+    static toff_t size(thandle_t handle)
+    {
+        EncoderHelper* helper = reinterpret_cast<EncoderHelper*>(handle);
+        return helper->end_;
+    }
+
+    static int close(thandle_t)
+    {
+        // Helper is owned by the encoder, which finalizes the stream after TIFFClose
+        return 0;
+    }
+
+    void finish()
+    {
+        io_stream_->seek(io_stream_->instance, end_, SEEK_SET);
+        io_stream_->flush(io_stream_->instance);
+    }
+
+  private:
+    nvimgcodecIoStreamDesc_t* io_stream_;
+    size_t capacity_ = 0;
+    size_t end_ = 0;
+};
+
+struct PyramidLevel
+{
+    uint32_t width, height;
+    uint32_t rows_in = 0;                     // Rows received so far
+    uint32_t band_rows = 0;                   // Rows currently held in band
+    uint32_t tile_row = 0;                    // Index of the next tile row to be compressed
+    std::vector<uint8_t> band;                // One tile row of interleaved samples
+    std::vector<uint8_t> prev_row;            // Even row waiting for its pair to be downsampled
+    std::vector<uint8_t> down_row;            // Downsampled row passed to the next level
+    std::vector<std::vector<uint8_t>> tiles;  // Compressed tiles, kept until the level can be written
+};
+
+/**
+ * @brief Writes a tiled TIFF pyramid from rows of the full resolution image, in a single pass
+ *
+ * Each level holds one tile row of uncompressed samples. Tiles of the full resolution image are written
+ * as soon as a tile row is complete. Reduced levels can't be written before the full resolution directory
+ * is finished, so their compressed tiles, about a third of the total output, are kept until then.
+ */
+class PyramidWriter
+{
+  public:
+    PyramidWriter(TIFF* tiff, const nvimgcodecExecutionParams_t* exec_params, uint32_t width, uint32_t height, uint32_t num_channels,
+        const nvimgcodecTiffEncodeParams_t& params)
+        : tiff_(tiff)
+        , exec_params_(exec_params)
+        , num_channels_(num_channels)
+        , tile_width_(params.tile_width)
+        , tile_height_(params.tile_height)
+        , compression_(params.compression)
+    {
+        uint32_t w = width, h = height;
+        for (uint32_t l = 0; l < NVIMGCODEC_TIFF_MAX_LEVELS; l++) {
+            PyramidLevel& level = levels_.emplace_back();
+            level.width = w;
+            level.height = h;
+            level.band.resize(static_cast<size_t>(tile_width_) * tilesAcross(level) * tile_height_ * num_channels_);
+            if (l > 0)
+                level.tiles.resize(static_cast<size_t>(tilesAcross(level)) * tilesDown(level));
+            bool done = params.num_levels ? l + 1 >= params.num_levels : (w <= tile_width_ && h <= tile_height_);
+            if (done || (w == 1 && h == 1))
+                break;
+            level.prev_row.resize(static_cast<size_t>(w) * num_channels_);
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+            level.down_row.resize(static_cast<size_t>(w) * num_channels_);
+        }
+        setLevelFields(0);
+    }
+
+    void pushRow(const uint8_t* row) { pushRow(0, row); }
+
+    void finish()
+    {
+        if (!TIFFWriteDirectory(tiff_))
+            throw std::runtime_error("Could not write TIFF directory");
+        for (size_t l = 1; l < levels_.size(); l++) {
+            setLevelFields(l);
+            auto& tiles = levels_[l].tiles;
+            for (size_t t = 0; t < tiles.size(); t++) {
+                if (TIFFWriteRawTile(tiff_, t, tiles[t].data(), tiles[t].size()) < 0)
+                    throw std::runtime_error("Could not write TIFF tile");
+                std::vector<uint8_t>().swap(tiles[t]);
+            }
+            if (!TIFFWriteDirectory(tiff_))
+                throw std::runtime_error("Could not write TIFF directory");
+        }
+    }
+
+  private:
+    uint32_t tilesAcross(const PyramidLevel& level) const { return (level.width + tile_width_ - 1) / tile_width_; }
+    uint32_t tilesDown(const PyramidLevel& level) const { return (level.height + tile_height_ - 1) / tile_height_; }
+
+    void setLevelFields(size_t l)
+    {
+        const PyramidLevel& level = levels_[l];
+        TIFFSetField(tiff_, TIFFTAG_SUBFILETYPE, l == 0 ? 0 : FILETYPE_REDUCEDIMAGE);
+        TIFFSetField(tiff_, TIFFTAG_IMAGEWIDTH, level.width);
+        TIFFSetField(tiff_, TIFFTAG_IMAGELENGTH, level.height);
+        TIFFSetField(tiff_, TIFFTAG_TILEWIDTH, tile_width_);
+        TIFFSetField(tiff_, TIFFTAG_TILELENGTH, tile_height_);
+        TIFFSetField(tiff_, TIFFTAG_BITSPERSAMPLE, 8);
+        TIFFSetField(tiff_, TIFFTAG_SAMPLESPERPIXEL, num_channels_);
+        TIFFSetField(tiff_, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+        TIFFSetField(tiff_, TIFFTAG_PHOTOMETRIC, num_channels_ == 1 ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB);
+        TIFFSetField(tiff_, TIFFTAG_COMPRESSION,
+            compression_ == NVIMGCODEC_TIFF_COMPRESSION_DEFLATE ? COMPRESSION_ADOBE_DEFLATE : COMPRESSION_NONE);
+    }
+
+    void pushRow(size_t l, const uint8_t* row)
+    {
+        PyramidLevel& level = levels_[l];
+        size_t row_size = static_cast<size_t>(level.width) * num_channels_;
+        size_t band_row_size = static_cast<size_t>(tilesAcross(level)) * tile_width_ * num_channels_;
+        std::memcpy(level.band.data() + level.band_rows * band_row_size, row, row_size);
+        level.band_rows++;
+        uint32_t y = level.rows_in++;
+        bool last = level.rows_in == level.height;
+        if (level.band_rows == tile_height_ || last)
+            flushBand(l);
+
+        if (l + 1 == levels_.size())
+            return;
+        if (y % 2 == 0 && !last) {
+            std::memcpy(level.prev_row.data(), row, row_size);
+            return;
+        }
+        // Odd height leaves the last row unpaired, so it is averaged with itself
+        downsampleRows(y % 2 ? level.prev_row.data() : row, row, level.width, level.down_row.data());
+        pushRow(l + 1, level.down_row.data());
+    }
+
+    // 2x2 box filter, with the last column of odd widths averaged with itself. Plain loops over bytes vectorize well.
+    void downsampleRows(const uint8_t* a, const uint8_t* b, uint32_t width, uint8_t* out) const
+    {
+        uint32_t out_width = (width + 1) / 2;
+        uint32_t even_width = width / 2;
+        const uint32_t c = num_channels_;
+        for (uint32_t x = 0; x < even_width; x++) {
+            for (uint32_t ch = 0; ch < c; ch++) {
+                uint32_t i0 = 2 * x * c + ch;
+                uint32_t i1 = i0 + c;
+                out[x * c + ch] = static_cast<uint8_t>((a[i0] + a[i1] + b[i0] + b[i1] + 2) >> 2);
+            }
+        }
+        if (out_width > even_width) {
+            for (uint32_t ch = 0; ch < c; ch++) {
+                uint32_t i0 = (width - 1) * c + ch;
+                out[even_width * c + ch] = static_cast<uint8_t>((a[i0] + b[i0] + 1) >> 1);
+            }
+        }
+    }
+
+    struct TileRowCtx
+    {
+        PyramidWriter* writer;
+        size_t level;
+        std::vector<std::vector<uint8_t>>* out;
+        std::atomic<bool> failed{false};
+    };
+
+    void flushBand(size_t l)
+    {
+        PyramidLevel& level = levels_[l];
+        uint32_t tiles_across = tilesAcross(level);
+        std::vector<std::vector<uint8_t>> out;
+        std::vector<std::vector<uint8_t>>* tiles = &out;
+        if (l == 0) {
+            out.resize(tiles_across);
+        } else {
+            // Reduced levels are written later, so tiles go straight to their final place
+            tiles = &level.tiles;
+        }
+
+        TileRowCtx ctx{this, l, tiles};
+        auto task = [](int tid, int tile_x, void* context) -> void {
+            auto* ctx = reinterpret_cast<TileRowCtx*>(context);
+            auto& level = ctx->writer->levels_[ctx->level];
+            size_t idx = ctx->level == 0 ? tile_x : static_cast<size_t>(level.tile_row) * ctx->writer->tilesAcross(level) + tile_x;
+            if (!ctx->writer->compressTile(level, tile_x, (*ctx->out)[idx]))
+                ctx->failed = true;
+        };
+        if (exec_params_) {
+            BlockParallelExec(&ctx, task, tiles_across, exec_params_);
+        } else {
+            for (uint32_t tile_x = 0; tile_x < tiles_across; tile_x++)
+                task(-1, tile_x, &ctx);
+        }
+        if (ctx.failed)
+            throw std::runtime_error("Could not compress TIFF tile");
+
+        if (l == 0) {
+            for (uint32_t tile_x = 0; tile_x < tiles_across; tile_x++) {
+                uint32_t tile_idx = level.tile_row * tiles_across + tile_x;
+                if (TIFFWriteRawTile(tiff_, tile_idx, out[tile_x].data(), out[tile_x].size()) < 0)
+                    throw std::runtime_error("Could not write TIFF tile");
+            }
+        }
+        level.tile_row++;
+        level.band_rows = 0;
+    }
+
+    bool compressTile(const PyramidLevel& level, uint32_t tile_x, std::vector<uint8_t>& out) const
+    {
+        // Tiles past the image edge are padded with zeros
+        size_t tile_row_size = static_cast<size_t>(tile_width_) * num_channels_;
+        size_t band_row_size = static_cast<size_t>(tilesAcross(level)) * tile_row_size;
+        uint32_t x0 = tile_x * tile_width_;
+        size_t copy_size = static_cast<size_t>(std::min(tile_width_, level.width - x0)) * num_channels_;
+        std::vector<uint8_t> tile(tile_row_size * tile_height_, 0);
+        for (uint32_t y = 0; y < level.band_rows; y++) {
+            std::memcpy(tile.data() + y * tile_row_size, level.band.data() + y * band_row_size + x0 * num_channels_, copy_size);
+        }
+
+#if LIBTIFF_EXT_HAVE_ZLIB
+        if (compression_ == NVIMGCODEC_TIFF_COMPRESSION_DEFLATE) {
+            uLongf compressed_size = compressBound(tile.size());
+            out.resize(compressed_size);
+            if (compress2(out.data(), &compressed_size, tile.data(), tile.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+                return false;
+            out.resize(compressed_size);
+            return true;
+        }
+#endif
+        out = std::move(tile);
+        return true;
+    }
+
+    TIFF* tiff_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+    uint32_t num_channels_;
+    uint32_t tile_width_;
+    uint32_t tile_height_;
+    nvimgcodecTiffCompression_t compression_;
+    std::vector<PyramidLevel> levels_;
+};
+
+struct EncodeState
+{
+    struct Sample
+    {
+        nvimgcodecCodeStreamDesc_t* code_stream;
+        nvimgcodecImageDesc_t* image;
+        const nvimgcodecEncodeParams_t* params;
+    };
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    std::vector<Sample> samples_;
+};
+
+struct EncoderImpl
+{
+    EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~EncoderImpl();
+
+    nvimgcodecStatus_t canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecProcessingStatus_t encode(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework,
+        const nvimgcodecExecutionParams_t* exec_params, nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream,
+        const nvimgcodecEncodeParams_t* params);
+    nvimgcodecStatus_t encodeBatch(
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecEncoder_t encoder);
+    static nvimgcodecStatus_t static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecStatus_t static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+    EncodeState encode_state_batch_;
+};
+
+static nvimgcodecTiffEncodeParams_t get_tiff_encode_params(const nvimgcodecEncodeParams_t* params)
+{
+    nvimgcodecTiffEncodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_ENCODE_PARAMS, sizeof(nvimgcodecTiffEncodeParams_t), nullptr};
+#if LIBTIFF_EXT_HAVE_ZLIB
+    tiff_params.compression = NVIMGCODEC_TIFF_COMPRESSION_DEFLATE;
+#else
+    tiff_params.compression = NVIMGCODEC_TIFF_COMPRESSION_NONE;
+#endif
+    tiff_params.num_levels = 1;
+    auto* ext = static_cast<const nvimgcodecTiffEncodeParams_t*>(params->struct_next);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_TIFF_ENCODE_PARAMS)
+        ext = static_cast<const nvimgcodecTiffEncodeParams_t*>(ext->struct_next);
+    if (ext)
+        tiff_params = *ext;
+    if (tiff_params.tile_width == 0)
+        tiff_params.tile_width = 256;
+    if (tiff_params.tile_height == 0)
+        tiff_params.tile_height = 256;
+    return tiff_params;
+}
+
+// Uncompressed size of all the levels, edge tiles being padded to the full tile size
+static uint64_t uncompressed_pyramid_size(uint32_t width, uint32_t height, uint32_t num_channels, const nvimgcodecTiffEncodeParams_t& params)
+{
+    uint64_t size = 0;
+    uint32_t w = width, h = height;
+    for (uint32_t l = 0; l < NVIMGCODEC_TIFF_MAX_LEVELS; l++) {
+        uint64_t padded_width = (static_cast<uint64_t>(w) + params.tile_width - 1) / params.tile_width * params.tile_width;
+        uint64_t padded_height = (static_cast<uint64_t>(h) + params.tile_height - 1) / params.tile_height * params.tile_height;
+        size += padded_width * padded_height * num_channels;
+        bool done = params.num_levels ? l + 1 >= params.num_levels : (w <= params.tile_width && h <= params.tile_height);
+        if (done || (w == 1 && h == 1))
+            break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    return size;
+}
+
+LibtiffEncoderPlugin::LibtiffEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : encoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_ENCODER_DESC, sizeof(nvimgcodecEncoderDesc_t), NULL, this, plugin_id_, "tiff",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, EncoderImpl::static_destroy, EncoderImpl::static_can_encode,
+          EncoderImpl::static_encode_batch}
+    , framework_(framework)
+{}
+
+nvimgcodecEncoderDesc_t* LibtiffEncoderPlugin::getEncoderDesc()
+{
+    return &encoder_desc_;
+}
+
+nvimgcodecStatus_t EncoderImpl::canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libtiff_can_encode");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(params);
+
+        auto tiff_params = get_tiff_encode_params(params);
+        bool params_supported = tiff_params.tile_width % 16 == 0 && tiff_params.tile_height % 16 == 0 &&
+                                tiff_params.num_levels <= NVIMGCODEC_TIFF_MAX_LEVELS &&
+                                (tiff_params.compression == NVIMGCODEC_TIFF_COMPRESSION_NONE ||
+                                    tiff_params.compression == NVIMGCODEC_TIFF_COMPRESSION_DEFLATE);
+#if !LIBTIFF_EXT_HAVE_ZLIB
+        params_supported = params_supported && tiff_params.compression != NVIMGCODEC_TIFF_COMPRESSION_DEFLATE;
+#endif
+        if (!params_supported) {
+            NVIMGCODEC_LOG_INFO(framework_, plugin_id_, "unsupported tiff encode parameters");
+        }
+
+        auto result = status;
+        auto code_stream = code_streams;
+        auto image = images;
+        for (int i = 0; i < batch_size; ++i, ++result, ++code_stream, ++image) {
+            *result = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+            nvimgcodecImageInfo_t cs_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            (*code_stream)->getImageInfo((*code_stream)->instance, &cs_image_info);
+
+            if (strcmp(cs_image_info.codec_name, "tiff") != 0) {
+                *result = NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+                continue;
+            }
+            if (!params_supported) {
+                *result = NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+                continue;
+            }
+
+            nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            (*image)->getImageInfo((*image)->instance, &image_info);
+
+            if (image_info.color_spec != NVIMGCODEC_COLORSPEC_SRGB && image_info.color_spec != NVIMGCODEC_COLORSPEC_GRAY) {
+                *result |= NVIMGCODEC_PROCESSING_STATUS_COLOR_SPEC_UNSUPPORTED;
+            }
+            if (image_info.chroma_subsampling != NVIMGCODEC_SAMPLING_NONE) {
+                *result |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+            }
+            if (image_info.sample_format != NVIMGCODEC_SAMPLEFORMAT_P_RGB && image_info.sample_format != NVIMGCODEC_SAMPLEFORMAT_I_RGB &&
+                image_info.sample_format != NVIMGCODEC_SAMPLEFORMAT_P_Y) {
+                *result |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
+            }
+            if ((image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB && image_info.num_planes != 3) ||
+                (image_info.sample_format != NVIMGCODEC_SAMPLEFORMAT_P_RGB && image_info.num_planes != 1)) {
+                *result |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+            }
+            for (uint32_t p = 0; p < image_info.num_planes; ++p) {
+                if (image_info.plane_info[p].sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8) {
+                    *result |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+                }
+                uint32_t expected_channels = image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_I_RGB ? 3 : 1;
+                if (image_info.plane_info[p].num_channels != expected_channels) {
+                    *result |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+                }
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if libtiff can encode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->canEncode(status, images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+    encode_state_batch_.plugin_id_ = plugin_id_;
+    encode_state_batch_.framework_ = framework_;
+}
+
+nvimgcodecStatus_t LibtiffEncoderPlugin::create(
+    nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libtiff_create_encoder");
+        XM_CHECK_NULL(encoder);
+        XM_CHECK_NULL(exec_params);
+        *encoder = reinterpret_cast<nvimgcodecEncoder_t>(new EncoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create libtiff encoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t LibtiffEncoderPlugin::static_create(
+    void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<LibtiffEncoderPlugin*>(instance);
+        return handle->create(encoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::~EncoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libtiff_destroy_encoder");
+}
+
+nvimgcodecStatus_t EncoderImpl::static_destroy(nvimgcodecEncoder_t encoder)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::encode(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework,
+    const nvimgcodecExecutionParams_t* exec_params, nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream,
+    const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework, plugin_id, "libtiff_encode");
+        nvtx3::scoped_range marker{"libtiff encode"};
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        if (image->getImageInfo(image->instance, &image_info) != NVIMGCODEC_STATUS_SUCCESS)
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+
+        auto* band_input = static_cast<const nvimgcodecBandInput_t*>(image_info.struct_next);
+        while (band_input && band_input->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT)
+            band_input = static_cast<const nvimgcodecBandInput_t*>(band_input->struct_next);
+        if (band_input && (band_input->band_height == 0 || !band_input->band_request)) {
+            NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Invalid band input");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+
+        uint32_t width = image_info.plane_info[0].width;
+        uint32_t height = image_info.plane_info[0].height;
+        bool planar = image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+        uint32_t num_channels = image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y ? 1 : 3;
+        uint32_t buffer_rows = band_input ? band_input->band_height : height;
+        auto tiff_params = get_tiff_encode_params(params);
+
+        // Classic TIFF offsets are 32-bit, so switch to BigTIFF when the uncompressed pyramid could exceed it
+        uint64_t max_output_size = uncompressed_pyramid_size(width, height, num_channels, tiff_params);
+        const char* mode = max_output_size > (uint64_t{1} << 32) - (uint64_t{1} << 28) ? "w8" : "w";
+        EncoderHelper helper(code_stream->io_stream);
+        std::unique_ptr<TIFF, void (*)(TIFF*)> tiff{TIFFClientOpen("", mode, reinterpret_cast<thandle_t>(&helper), &EncoderHelper::read,
+                                                       &EncoderHelper::write, &EncoderHelper::seek, &EncoderHelper::close,
+                                                       &EncoderHelper::size, nullptr, nullptr),
+            &TIFFClose};
+        if (!tiff)
+            throw std::runtime_error("Unable to open TIFF image for writing");
+
+        PyramidWriter writer(tiff.get(), exec_params, width, height, num_channels, tiff_params);
+        const uint8_t* buffer = static_cast<const uint8_t*>(image_info.buffer);
+        std::vector<uint8_t> row(planar ? static_cast<size_t>(width) * num_channels : 0);
+        auto push_rows = [&](uint32_t num_rows) {
+            for (uint32_t y = 0; y < num_rows; y++) {
+                if (!planar) {
+                    writer.pushRow(buffer + y * image_info.plane_info[0].row_stride);
+                    continue;
+                }
+                for (uint32_t c = 0; c < num_channels; c++) {
+                    const uint8_t* plane =
+                        buffer + static_cast<size_t>(c) * buffer_rows * image_info.plane_info[0].row_stride;
+                    const uint8_t* src = plane + y * image_info.plane_info[c].row_stride;
+                    for (uint32_t x = 0; x < width; x++)
+                        row[x * num_channels + c] = src[x];
+                }
+                writer.pushRow(row.data());
+            }
+        };
+
+        if (!band_input) {
+            push_rows(height);
+        } else {
+            nvimgcodecImageInfo_t band_info = image_info;
+            band_info.struct_next = nullptr;
+            for (uint32_t first_row = 0; first_row < height; first_row += buffer_rows) {
+                uint32_t num_rows = std::min(buffer_rows, height - first_row);
+                for (uint32_t p = 0; p < band_info.num_planes; p++)
+                    band_info.plane_info[p].height = num_rows;
+                if (band_input->band_request(band_input->band_ctx, &band_info, first_row, num_rows) != NVIMGCODEC_STATUS_SUCCESS) {
+                    NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Band input was interrupted at row " << first_row);
+                    return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+                }
+                push_rows(num_rows);
+            }
+        }
+        writer.finish();
+        tiff.reset();
+        helper.finish();
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Could not encode tiff code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::encodeBatch(
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libtiff_encode_batch");
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(images)
+        XM_CHECK_NULL(params)
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        encode_state_batch_.samples_.clear();
+        encode_state_batch_.samples_.resize(batch_size);
+        for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
+            encode_state_batch_.samples_[sample_idx] = {code_streams[sample_idx], images[sample_idx], params};
+        }
+
+        auto executor = exec_params_->executor;
+        if (batch_size < executor->getNumThreads(executor->instance)) {
+            // Too few images to keep the executor busy, so they are encoded one after another, each with its tiles
+            // compressed in parallel
+            for (auto& sample : encode_state_batch_.samples_) {
+                auto result = encode(plugin_id_, framework_, exec_params_, sample.image, sample.code_stream, sample.params);
+                sample.image->imageReady(sample.image->instance, result);
+            }
+            return NVIMGCODEC_STATUS_SUCCESS;
+        }
+
+        // Otherwise images are encoded in parallel, each one on a single thread
+        for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, sample_idx, &encode_state_batch_,
+                [](int tid, int sample_idx, void* context) -> void {
+                    auto* encode_state = reinterpret_cast<EncodeState*>(context);
+                    auto& sample = encode_state->samples_[sample_idx];
+                    auto result =
+                        encode(encode_state->plugin_id_, encode_state->framework_, nullptr, sample.image, sample.code_stream, sample.params);
+                    sample.image->imageReady(sample.image->instance, result);
+                });
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode tiff batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i) {
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        }
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->encodeBatch(images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace libtiff
@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2022-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "nvimgcodec.h"
+
+namespace libtiff {
+
+class LibtiffEncoderPlugin
+{
+  public:
+    explicit LibtiffEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework);
+    nvimgcodecEncoderDesc_t* getEncoderDesc();
+
+  private:
+    nvimgcodecStatus_t create(
+        nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options);
+    static nvimgcodecStatus_t static_create(
+        void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options);
+
+    static constexpr const char* plugin_id_ = "libtiff_encoder";
+    nvimgcodecEncoderDesc_t encoder_desc_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+};
+
+} // namespace libtiff
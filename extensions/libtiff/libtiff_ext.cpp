@@ -17,6 +17,7 @@
 
 #include <nvimgcodec.h>
 #include "libtiff_decoder.h"
+#include "libtiff_encoder.h"
 #include "log.h"
 #include "error_handling.h"
 
@@ -28,10 +29,16 @@ struct LibtiffImgCodecsExtension
     explicit LibtiffImgCodecsExtension(const nvimgcodecFrameworkDesc_t* framework)
         : framework_(framework)
         , tiff_decoder_(framework)
+        , tiff_encoder_(framework)
     {
         framework->registerDecoder(framework->instance, tiff_decoder_.getDecoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        framework->registerEncoder(framework->instance, tiff_encoder_.getEncoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+    }
+    ~LibtiffImgCodecsExtension()
+    {
+        framework_->unregisterEncoder(framework_->instance, tiff_encoder_.getEncoderDesc());
+        framework_->unregisterDecoder(framework_->instance, tiff_decoder_.getDecoderDesc());
     }
-    ~LibtiffImgCodecsExtension() { framework_->unregisterDecoder(framework_->instance, tiff_decoder_.getDecoderDesc()); }
 
     static nvimgcodecStatus_t libtiffExtensionCreate(
         void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
@@ -64,6 +71,7 @@ struct LibtiffImgCodecsExtension
   private:
     const nvimgcodecFrameworkDesc_t* framework_;
     LibtiffDecoderPlugin tiff_decoder_;
+    LibtiffEncoderPlugin tiff_encoder_;
 };
 
 } // namespace libtiff
@@ -0,0 +1,436 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "libwebp_encoder.h"
+#include <webp/encode.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "error_handling.h"
+#include "log.h"
+#include "nvimgcodec.h"
+#include "../utils/scratch.h"
+#include "../utils/struct_chain.h"
+
+namespace libwebp {
+
+namespace {
+
+/**
+ * @brief Writes the code stream chunks produced by libwebp straight to the output io stream
+ */
+class IoStreamWriter
+{
+  public:
+    IoStreamWriter(nvimgcodecIoStreamDesc_t* io_stream, size_t size_estimate)
+        : io_stream_(io_stream)
+        , capacity_(size_estimate)
+    {
+        io_stream_->reserve(io_stream_->instance, capacity_);
+    }
+
+    static int write(const uint8_t* data, size_t data_size, const WebPPicture* picture)
+    {
+        auto* writer = static_cast<IoStreamWriter*>(picture->custom_ptr);
+        // Memory sinks only accept writes within the reserved size, so grow it geometrically
+        size_t required = writer->written_ + data_size;
+        if (required > writer->capacity_) {
+            writer->capacity_ = std::max(required, 2 * writer->capacity_);
+            writer->io_stream_->reserve(writer->io_stream_->instance, writer->capacity_);
+        }
+        size_t written_nbytes = 0;
+        if (writer->io_stream_->write(writer->io_stream_->instance, &written_nbytes, const_cast<uint8_t*>(data), data_size) !=
+                NVIMGCODEC_STATUS_SUCCESS ||
+            written_nbytes != data_size)
+            return 0;
+        writer->written_ += written_nbytes;
+        return 1;
+    }
+
+    void finish() { io_stream_->flush(io_stream_->instance); }
+
+  private:
+    nvimgcodecIoStreamDesc_t* io_stream_;
+    size_t capacity_;
+    size_t written_ = 0;
+};
+
+// Initial reservation of the output, so that typical code streams are written without growing it
+size_t EstimateSize(const WebPConfig& config, const nvimgcodecImageInfo_t& info)
+{
+    constexpr size_t kHeaderSize = 1024;
+    if (config.target_size > 0)
+        return config.target_size + kHeaderSize;
+    size_t num_pixels = static_cast<size_t>(info.plane_info[0].width) * info.plane_info[0].height;
+    if (config.lossless)
+        return num_pixels * 2 + kHeaderSize;
+    // About 0.4 to 2.4 bits per pixel from the lowest to the highest quality
+    return static_cast<size_t>(num_pixels * (0.05 + 0.25 * config.quality / 100.0)) + kHeaderSize;
+}
+
+bool ImportPicture(const nvimgcodecImageInfo_t& info, ScratchScope* scratch, WebPPicture* picture)
+{
+    auto* buffer = static_cast<const uint8_t*>(info.buffer);
+    int stride = static_cast<int>(info.plane_info[0].row_stride);
+    switch (info.sample_format) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+        return WebPPictureImportRGB(picture, buffer, stride);
+    case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
+        return WebPPictureImportBGR(picture, buffer, stride);
+    case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED:
+        return info.plane_info[0].num_channels == 4 ? WebPPictureImportRGBA(picture, buffer, stride)
+                                                    : WebPPictureImportRGB(picture, buffer, stride);
+    default:
+        break;
+    }
+
+    // Planar inputs are interleaved into a copy, grayscale is replicated to all channels
+    int width = info.plane_info[0].width;
+    int height = info.plane_info[0].height;
+    const uint8_t* planes[3];
+    size_t strides[3];
+    size_t offset = 0;
+    for (uint32_t p = 0; p < info.num_planes; p++) {
+        planes[p] = buffer + offset;
+        strides[p] = info.plane_info[p].row_stride;
+        offset += info.plane_info[p].row_stride * info.plane_info[p].height;
+    }
+    if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y) {
+        planes[1] = planes[2] = planes[0];
+        strides[1] = strides[2] = strides[0];
+    } else if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR) {
+        std::swap(planes[0], planes[2]);
+        std::swap(strides[0], strides[2]);
+    }
+    uint8_t* rgb = scratch->allocate(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; y++) {
+        uint8_t* dst = rgb + static_cast<size_t>(y) * width * 3;
+        for (int c = 0; c < 3; c++) {
+            const uint8_t* plane_row = planes[c] + y * strides[c];
+            for (int x = 0; x < width; x++)
+                dst[x * 3 + c] = plane_row[x];
+        }
+    }
+    return WebPPictureImportRGB(picture, rgb, width * 3);
+}
+
+struct EncoderImpl
+{
+    EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~EncoderImpl();
+
+    nvimgcodecProcessingStatus_t canEncodeImpl(
+        nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params);
+    nvimgcodecStatus_t canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    nvimgcodecProcessingStatus_t encodeImpl(int sample_idx);
+    nvimgcodecStatus_t encodeBatch(
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecEncoder_t encoder);
+    static nvimgcodecStatus_t static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecStatus_t static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct Sample
+    {
+        nvimgcodecImageDesc_t* image;
+        nvimgcodecCodeStreamDesc_t* code_stream;
+        WebPConfig config;
+    };
+    std::vector<Sample> samples_;
+};
+
+} // namespace
+
+LibwebpEncoderPlugin::LibwebpEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : encoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_ENCODER_DESC, sizeof(nvimgcodecEncoderDesc_t), NULL, this, plugin_id_, "webp",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, EncoderImpl::static_destroy, EncoderImpl::static_can_encode,
+          EncoderImpl::static_encode_batch}
+    , framework_(framework)
+{
+}
+
+nvimgcodecEncoderDesc_t* LibwebpEncoderPlugin::getEncoderDesc()
+{
+    return &encoder_desc_;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::canEncodeImpl(
+    nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params)
+{
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(code_stream->instance, &out_info);
+    if (strcmp(out_info.codec_name, "webp") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(image->instance, &info);
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (FindStruct<nvimgcodecBandInput_t>(info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT))
+        status |= NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED;
+    if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    if (info.plane_info[0].width > WEBP_MAX_DIMENSION || info.plane_info[0].height > WEBP_MAX_DIMENSION)
+        status |= NVIMGCODEC_PROCESSING_STATUS_RESOLUTION_UNSUPPORTED;
+
+    switch (info.sample_format) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        if (info.plane_info[0].num_channels != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED:
+        // RGB or RGBA
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        if (info.plane_info[0].num_channels != 3 && info.plane_info[0].num_channels != 4)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_P_BGR:
+        if (info.num_planes != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_Y:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
+        break;
+    }
+    for (uint32_t p = 0; p < info.num_planes && p < NVIMGCODEC_MAX_NUM_PLANES; p++) {
+        if (info.plane_info[p].sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+        if (info.num_planes > 1 && info.plane_info[p].num_channels != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+    }
+
+    if (params->quality < 0 || params->quality > 100)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    if (auto* webp_params = FindStruct<nvimgcodecWebpEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_WEBP_ENCODE_PARAMS)) {
+        if (webp_params->method < 0 || webp_params->method > 6)
+            status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return status;
+}
+
+nvimgcodecStatus_t EncoderImpl::canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libwebp_can_encode");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++)
+            status[i] = canEncodeImpl(images[i], code_streams[i], params);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if libwebp can encode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->canEncode(status, images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+}
+
+EncoderImpl::~EncoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libwebp_destroy_encoder");
+}
+
+nvimgcodecStatus_t LibwebpEncoderPlugin::create(
+    nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libwebp_create_encoder");
+        XM_CHECK_NULL(encoder);
+        XM_CHECK_NULL(exec_params);
+        *encoder = reinterpret_cast<nvimgcodecEncoder_t>(new EncoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create libwebp encoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t LibwebpEncoderPlugin::static_create(
+    void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<LibwebpEncoderPlugin*>(instance);
+        return handle->create(encoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+nvimgcodecStatus_t EncoderImpl::static_destroy(nvimgcodecEncoder_t encoder)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::encodeImpl(int sample_idx)
+{
+    nvtx3::scoped_range marker{"libwebp encode " + std::to_string(sample_idx)};
+    auto& sample = samples_[sample_idx];
+    WebPPicture picture;
+    if (!WebPPictureInit(&picture)) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not initialize webp picture");
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    nvimgcodecProcessingStatus_t result = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    try {
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        sample.image->getImageInfo(sample.image->instance, &info);
+        picture.width = info.plane_info[0].width;
+        picture.height = info.plane_info[0].height;
+        // Lossless encoding works on ARGB and lossy on YUV, importing to the right one avoids a conversion
+        picture.use_argb = sample.config.lossless;
+        // The picture keeps its own copy of the pixels, so interleaved copies of planar inputs are scratch memory
+        ScratchScope scratch(framework_, GetHostAllocator(exec_params_));
+        if (!ImportPicture(info, &scratch, &picture)) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not import image to webp picture");
+            result = NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        } else {
+            IoStreamWriter writer(sample.code_stream->io_stream, EstimateSize(sample.config, info));
+            picture.writer = IoStreamWriter::write;
+            picture.custom_ptr = &writer;
+            if (!WebPEncode(&sample.config, &picture)) {
+                NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode webp code stream - error " << picture.error_code);
+                result = NVIMGCODEC_PROCESSING_STATUS_FAIL;
+            }
+            writer.finish();
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode webp code stream - " << e.what());
+        result = NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    WebPPictureFree(&picture);
+    return result;
+}
+
+nvimgcodecStatus_t EncoderImpl::encodeBatch(
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "libwebp_encode_batch");
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        auto executor = exec_params_->executor;
+        XM_CHECK_NULL(executor);
+
+        WebPConfig config;
+        if (!WebPConfigPreset(&config, WEBP_PRESET_DEFAULT, params->quality))
+            throw std::runtime_error("could not initialize webp config");
+        auto* webp_params = FindStruct<nvimgcodecWebpEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_WEBP_ENCODE_PARAMS);
+        if (webp_params) {
+            config.lossless = webp_params->lossless ? 1 : 0;
+            config.method = webp_params->method;
+            // Lossless output should decode to the very same samples, also under transparent pixels
+            config.exact = config.lossless;
+        }
+        auto* rate_control = FindStruct<nvimgcodecRateControlParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS);
+        if (rate_control && (rate_control->target_size > 0 || rate_control->target_psnr > 0)) {
+            config.target_size = static_cast<int>(std::min<size_t>(rate_control->target_size, INT32_MAX));
+            config.target_PSNR = rate_control->target_psnr;
+            config.pass = 6;
+        }
+        // Samples are encoded in parallel, a single image can use threads of libwebp instead
+        config.thread_level = batch_size == 1 ? 1 : 0;
+        if (!WebPValidateConfig(&config))
+            throw std::runtime_error("invalid webp encode parameters");
+
+        samples_.clear();
+        samples_.resize(batch_size);
+        for (int i = 0; i < batch_size; i++)
+            samples_[i] = {images[i], code_streams[i], config};
+
+        for (int i = 0; i < batch_size; i++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, i, this, [](int tid, int sample_idx, void* context) -> void {
+                auto* this_ptr = reinterpret_cast<EncoderImpl*>(context);
+                auto& sample = this_ptr->samples_[sample_idx];
+                auto result = this_ptr->encodeImpl(sample_idx);
+                sample.image->imageReady(sample.image->instance, result);
+            });
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode webp batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->encodeBatch(images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace libwebp
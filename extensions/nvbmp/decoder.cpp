@@ -28,6 +28,7 @@
 #include "log.h"
 #include "../utils/stream_ctx.h"
 #include "../utils/parallel_exec.h"
+#include "../utils/scratch.h"
 
 namespace nvbmp {
 
@@ -41,7 +42,7 @@ struct DecoderImpl
     nvimgcodecStatus_t canDecode(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** code_streams,
         nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
 
-    void decodeImpl(BatchItemCtx& batch_item, int tid);
+    void decodeImpl(BatchItemCtx& batch_item);
     nvimgcodecStatus_t decodeBatch(
         nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
 
@@ -55,16 +56,16 @@ struct DecoderImpl
     const nvimgcodecFrameworkDesc_t* framework_;
     const nvimgcodecExecutionParams_t* exec_params_;
 
-    struct PerThreadResources {
-        std::vector<uint8_t> buffer;
-    };
-    std::vector<PerThreadResources> per_thread_;
     CodeStreamCtxManager code_stream_mgr_;
+
+    // Measured costs of checking and decoding samples, to decide how to parallelize the next batches
+    AdaptiveParallelPolicy can_decode_policy_;
+    std::shared_ptr<AdaptiveParallelPolicy> decode_policy_ = std::make_shared<AdaptiveParallelPolicy>();
 };
 
 NvBmpDecoderPlugin::NvBmpDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "bmp", NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create,
-          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch}
+          DecoderImpl::static_destroy, DecoderImpl::static_can_decode, DecoderImpl::static_decode_batch, 1}
     , framework_(framework)
 {
 }
@@ -110,6 +111,15 @@ nvimgcodecStatus_t DecoderImpl::canDecodeImpl(CodeStreamCtx& ctx)
 
             nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
             image->getImageInfo(image->instance, &image_info);
+
+            // Decoding is not incremental, so the whole image has to fit in the output buffer
+            auto* band_output = static_cast<const nvimgcodecBandOutput_t*>(image_info.struct_next);
+            while (band_output && band_output->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT)
+                band_output = static_cast<const nvimgcodecBandOutput_t*>(band_output->struct_next);
+            if (band_output) {
+                *status |= NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED;
+            }
+
             if (image_info.color_spec != NVIMGCODEC_COLORSPEC_SRGB) {
                 *status |= NVIMGCODEC_PROCESSING_STATUS_COLOR_SPEC_UNSUPPORTED;
             }
@@ -166,7 +176,7 @@ nvimgcodecStatus_t DecoderImpl::canDecode(nvimgcodecProcessingStatus_t* status,
             auto this_ptr = reinterpret_cast<DecoderImpl*>(context);
             this_ptr->canDecodeImpl(*this_ptr->code_stream_mgr_[sample_idx]);
         };
-        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_);
+        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_, &can_decode_policy_);
         for (int i = 0; i < batch_size; i++) {
             status[i] = code_stream_mgr_.get_batch_item(i).processing_status;
         }
@@ -193,10 +203,8 @@ DecoderImpl::DecoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t*
     : plugin_id_(plugin_id)
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
-    auto  executor = exec_params_->executor;
-    int num_threads = executor->getNumThreads(executor->instance);
-    per_thread_.resize(num_threads);
 }
 
 nvimgcodecStatus_t NvBmpDecoderPlugin::create(
@@ -246,7 +254,7 @@ nvimgcodecStatus_t DecoderImpl::static_destroy(nvimgcodecDecoder_t decoder)
 
 
 
-void DecoderImpl::decodeImpl(BatchItemCtx& batch_item, int tid)
+void DecoderImpl::decodeImpl(BatchItemCtx& batch_item)
 {
     NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "decode");
     nvtx3::scoped_range marker{"nvbmp decode " + std::to_string(batch_item.index)};
@@ -263,8 +271,8 @@ void DecoderImpl::decodeImpl(BatchItemCtx& batch_item, int tid)
         size_t size = 0;
         size_t output_size = 0;
         io_stream->size(io_stream->instance, &size);
-        auto& buffer = per_thread_[tid].buffer;
-        buffer.resize(size);
+        ScratchScope scratch(framework_, GetHostAllocator(exec_params_));
+        uint8_t* buffer = scratch.allocate(size);
         static constexpr int kHeaderStart = 14;
         io_stream->seek(io_stream->instance, kHeaderStart, SEEK_SET);
         uint32_t header_size;
@@ -278,12 +286,19 @@ void DecoderImpl::decodeImpl(BatchItemCtx& batch_item, int tid)
 
         unsigned char* host_buffer = reinterpret_cast<unsigned char*>(image_info.buffer);
 
+        // Negative biHeight means rows are stored top to bottom
+        static constexpr int kHeightOffset = kHeaderStart + 8;
+        int32_t bmp_height;
+        std::memcpy(&bmp_height, &buffer[kHeightOffset], sizeof(bmp_height));
+        bool top_down = bmp_height < 0;
+        auto out_row = [&](size_t y, size_t height) { return top_down ? y : height - y - 1; };
+
         if (image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB) {
             for (size_t p = 0; p < image_info.num_planes; p++) {
                 for (size_t y = 0; y < image_info.plane_info[p].height; y++) {
                     for (size_t x = 0; x < image_info.plane_info[p].width; x++) {
                         host_buffer[(image_info.num_planes - p - 1) * image_info.plane_info[p].height * image_info.plane_info[p].width +
-                                    (image_info.plane_info[p].height - y - 1) * image_info.plane_info[p].width + x] =
+                                    out_row(y, image_info.plane_info[p].height) * image_info.plane_info[p].width + x] =
                             buffer[kHeaderStart + header_size + image_info.num_planes * (y * image_info.plane_info[p].width + x) + p];
                     }
                 }
@@ -294,7 +309,7 @@ void DecoderImpl::decodeImpl(BatchItemCtx& batch_item, int tid)
                     for (size_t x = 0; x < image_info.plane_info[0].width; x++) {
                         auto src_idx = kHeaderStart + header_size +
                                        image_info.plane_info[0].num_channels * (y * image_info.plane_info[0].width + x) + c;
-                        auto dst_idx = (image_info.plane_info[0].height - y - 1) * image_info.plane_info[0].width *
+                        auto dst_idx = out_row(y, image_info.plane_info[0].height) * image_info.plane_info[0].width *
                                            image_info.plane_info[0].num_channels +
                                        x * image_info.plane_info[0].num_channels + (image_info.plane_info[0].num_channels - c - 1);
                         host_buffer[dst_idx] = buffer[src_idx];
@@ -338,18 +353,11 @@ nvimgcodecStatus_t DecoderImpl::decodeBatch(
             auto* this_ptr = reinterpret_cast<DecoderImpl*>(context);
             auto stream_ctx = this_ptr->code_stream_mgr_[stream_idx];
             for (auto* batch_item : stream_ctx->batch_items_) {
-                this_ptr->decodeImpl(*batch_item, tid);
+                this_ptr->decodeImpl(*batch_item);
             }
         };
 
-        if (code_stream_mgr_.size() == 1) {
-            task(0, 0, this);
-        } else {
-            auto executor = exec_params_->executor;
-            for (size_t stream_idx = 0; stream_idx < code_stream_mgr_.size(); stream_idx++) {
-                executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, stream_idx, this, task);
-            }
-        }
+        AdaptiveLaunchBatch(exec_params_->executor, NVIMGCODEC_DEVICE_CPU_ONLY, code_stream_mgr_.size(), this, task, decode_policy_);
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode bmp batch - " << e.what());
         for (int i = 0; i < batch_size; ++i) {
@@ -16,6 +16,7 @@
  */
 
 #include <nvimgcodec.h>
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -28,33 +29,32 @@
 
 namespace nvbmp {
 
-template <typename D, int SAMPLE_FORMAT = NVIMGCODEC_SAMPLEFORMAT_P_RGB>
-int writeBMP(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecIoStreamDesc_t* io_stream, const D* chanR,
-    size_t pitchR, const D* chanG, size_t pitchG, const D* chanB, size_t pitchB, int width, int height, uint8_t precision, bool verbose)
+static int bmpExtraBytes(int width)
 {
-
-    unsigned int headers[13];
-    int extrabytes;
-    int paddedsize;
-    int x;
-    int y;
-    int n;
-    int red, green, blue;
-
-    extrabytes = 4 - ((width * 3) % 4); // How many bytes of padding to add to each
+    int extrabytes = 4 - ((width * 3) % 4); // How many bytes of padding to add to each
     // horizontal line - the size of which must
     // be a multiple of 4 bytes.
     if (extrabytes == 4)
         extrabytes = 0;
+    return extrabytes;
+}
+
+// Top-down images are stored with negative height, so rows can be written in the order they arrive
+static void writeBMPHeader(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecIoStreamDesc_t* io_stream,
+    int width, int height, bool top_down, uint8_t precision, bool verbose)
+{
+    unsigned int headers[13];
+    int paddedsize;
+    int n;
 
-    paddedsize = ((width * 3) + extrabytes) * height;
+    paddedsize = ((width * 3) + bmpExtraBytes(width)) * height;
 
     headers[0] = paddedsize + 54; // bfSize (whole file size)
     headers[1] = 0;               // bfReserved (both)
     headers[2] = 54;              // bfOffbits
     headers[3] = 40;              // biSize
     headers[4] = width;           // biWidth
-    headers[5] = height;          // biHeight
+    headers[5] = top_down ? static_cast<unsigned int>(-height) : height; // biHeight
 
     headers[7] = 0;               // biCompression
     headers[8] = paddedsize;      // biSizeImage
@@ -93,12 +93,20 @@ int writeBMP(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework,
     if (verbose && precision > 8) {
         NVIMGCODEC_LOG_WARNING(framework, plugin_id, "BMP write - truncating " << (int)precision << " bit data to 8 bit");
     }
+}
 
-    //
-    // Headers done, now write the data...
-    //
-    for (y = height - 1; y >= 0; y--) // BMP image format is written from bottom to top...
-    {
+template <typename D, int SAMPLE_FORMAT = NVIMGCODEC_SAMPLEFORMAT_P_RGB>
+void writeBMPRows(nvimgcodecIoStreamDesc_t* io_stream, const D* chanR, size_t pitchR, const D* chanG, size_t pitchG, const D* chanB,
+    size_t pitchB, int width, int height, bool top_down, uint8_t precision)
+{
+    size_t written_size;
+    int extrabytes = bmpExtraBytes(width);
+    int x;
+    int n;
+    int red, green, blue;
+
+    for (int i = 0; i < height; i++) {
+        int y = top_down ? i : height - 1 - i; // BMP image format is written from bottom to top, unless height is negative
         for (x = 0; x <= width - 1; x++) {
 
             if (SAMPLE_FORMAT == NVIMGCODEC_SAMPLEFORMAT_P_RGB) {
@@ -142,8 +150,6 @@ int writeBMP(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework,
             }
         }
     }
-    io_stream->flush(io_stream->instance);
-    return 0;
 }
 
 struct EncodeState
@@ -342,19 +348,53 @@ nvimgcodecProcessingStatus_t EncoderImpl::encode(const char* plugin_id, const nv
         if (ret != NVIMGCODEC_STATUS_SUCCESS)
             return NVIMGCODEC_PROCESSING_STATUS_FAIL;
 
-    unsigned char* host_buffer = reinterpret_cast<unsigned char*>(image_info.buffer);
-
-    if (NVIMGCODEC_SAMPLEFORMAT_I_RGB == image_info.sample_format) {
-            writeBMP<unsigned char, NVIMGCODEC_SAMPLEFORMAT_I_RGB>(plugin_id, framework, code_stream->io_stream, host_buffer,
-                image_info.plane_info[0].row_stride, NULL, 0, NULL, 0, image_info.plane_info[0].width, image_info.plane_info[0].height, 8,
-                true);
-    } else {
-            writeBMP<unsigned char>(plugin_id, framework, code_stream->io_stream, host_buffer, image_info.plane_info[0].row_stride,
-            host_buffer + image_info.plane_info[0].row_stride * image_info.plane_info[0].height, image_info.plane_info[1].row_stride,
-            host_buffer + +image_info.plane_info[0].row_stride * image_info.plane_info[0].height +
-                image_info.plane_info[1].row_stride * image_info.plane_info[0].height,
-            image_info.plane_info[2].row_stride, image_info.plane_info[0].width, image_info.plane_info[0].height, 8, true);
-    }
+        unsigned char* host_buffer = reinterpret_cast<unsigned char*>(image_info.buffer);
+
+        auto* band_input = static_cast<const nvimgcodecBandInput_t*>(image_info.struct_next);
+        while (band_input && band_input->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT)
+            band_input = static_cast<const nvimgcodecBandInput_t*>(band_input->struct_next);
+        if (band_input && (band_input->band_height == 0 || !band_input->band_request)) {
+            NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Invalid band input");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+
+        int width = image_info.plane_info[0].width;
+        int height = image_info.plane_info[0].height;
+        bool top_down = band_input != nullptr;
+        auto* io_stream = code_stream->io_stream;
+        writeBMPHeader(plugin_id, framework, io_stream, width, height, top_down, 8, true);
+
+        // Writes num_rows rows from the buffer, which holds plane_rows rows per plane
+        auto write_rows = [&](int num_rows, size_t plane_rows) {
+            if (NVIMGCODEC_SAMPLEFORMAT_I_RGB == image_info.sample_format) {
+                writeBMPRows<unsigned char, NVIMGCODEC_SAMPLEFORMAT_I_RGB>(
+                    io_stream, host_buffer, image_info.plane_info[0].row_stride, NULL, 0, NULL, 0, width, num_rows, top_down, 8);
+            } else {
+                writeBMPRows<unsigned char>(io_stream, host_buffer, image_info.plane_info[0].row_stride,
+                    host_buffer + image_info.plane_info[0].row_stride * plane_rows, image_info.plane_info[1].row_stride,
+                    host_buffer + image_info.plane_info[0].row_stride * plane_rows + image_info.plane_info[1].row_stride * plane_rows,
+                    image_info.plane_info[2].row_stride, width, num_rows, top_down, 8);
+            }
+        };
+
+        if (!band_input) {
+            write_rows(height, height);
+        } else {
+            nvimgcodecImageInfo_t band_info = image_info;
+            band_info.struct_next = nullptr;
+            int band_height = static_cast<int>(band_input->band_height);
+            for (int first_row = 0; first_row < height; first_row += band_height) {
+                int num_rows = std::min(band_height, height - first_row);
+                for (uint32_t p = 0; p < band_info.num_planes; p++)
+                    band_info.plane_info[p].height = num_rows;
+                if (band_input->band_request(band_input->band_ctx, &band_info, first_row, num_rows) != NVIMGCODEC_STATUS_SUCCESS) {
+                    NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Band input was interrupted at row " << first_row);
+                    return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+                }
+                write_rows(num_rows, band_height);
+            }
+        }
+        io_stream->flush(io_stream->instance);
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Could not encode bmp code stream - " << e.what());
         return NVIMGCODEC_PROCESSING_STATUS_FAIL;
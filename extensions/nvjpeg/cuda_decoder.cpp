@@ -42,7 +42,7 @@ namespace nvjpeg {
 
 NvJpegCudaDecoderPlugin::NvJpegCudaDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "jpeg", NVIMGCODEC_BACKEND_KIND_HYBRID_CPU_GPU,
-          static_create, Decoder::static_destroy, Decoder::static_can_decode, Decoder::static_decode_batch}
+          static_create, Decoder::static_destroy, Decoder::static_can_decode, Decoder::static_decode_batch, 1}
     , framework_(framework)
 {}
 
@@ -215,6 +215,7 @@ Decoder::Decoder(
     , pinned_allocator_{nullptr, nullptr, nullptr}
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
     parseOptions(options);
 
@@ -563,10 +564,7 @@ nvimgcodecStatus_t Decoder::decodeBatch(
         if (batch_size == 1) {
             task(0, 0, this);
         } else {
-            auto executor = exec_params_->executor;
-            for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
-                executor->launch(executor->instance, exec_params_->device_id, sample_idx, this, task);
-            }
+            LaunchBatch(exec_params_->executor, exec_params_->device_id, batch_size, this, task);
         }
     } catch (const NvJpegException& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode jpeg batch - " << e.info());
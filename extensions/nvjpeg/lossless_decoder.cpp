@@ -41,7 +41,7 @@ namespace nvjpeg {
 
 NvJpegLosslessDecoderPlugin::NvJpegLosslessDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "jpeg", NVIMGCODEC_BACKEND_KIND_HYBRID_CPU_GPU,
-          static_create, Decoder::static_destroy, Decoder::static_can_decode, Decoder::static_decode_batch}
+          static_create, Decoder::static_destroy, Decoder::static_can_decode, Decoder::static_decode_batch, 0}
     , framework_(framework)
 {
 }
@@ -191,6 +191,7 @@ NvJpegLosslessDecoderPlugin::Decoder::Decoder(
     , device_allocator_{nullptr, nullptr, nullptr}
     , pinned_allocator_{nullptr, nullptr, nullptr}
     , framework_(framework)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
     , exec_params_(exec_params)
 {
     bool use_nvjpeg_create_ex_v2 = false;
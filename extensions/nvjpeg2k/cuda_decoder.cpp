@@ -45,7 +45,7 @@ namespace nvjpeg2k {
 NvJpeg2kDecoderPlugin::NvJpeg2kDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
     : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "jpeg2k",
           NVIMGCODEC_BACKEND_KIND_GPU_ONLY, static_create, Decoder::static_destroy, Decoder::static_can_decode,
-          Decoder::static_decode_batch}
+          Decoder::static_decode_batch, 1}
     , framework_(framework)
 {
 }
@@ -201,6 +201,7 @@ NvJpeg2kDecoderPlugin::Decoder::Decoder(
     , pinned_allocator_{nullptr, nullptr, nullptr}
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
     parseOptions(options);
     if (exec_params_->device_allocator && exec_params_->device_allocator->device_malloc && exec_params_->device_allocator->device_free) {
@@ -752,10 +753,7 @@ nvimgcodecStatus_t NvJpeg2kDecoderPlugin::Decoder::decodeBatch(
         if (batch_size == 1) {
             task(0, 0, this);
         } else {
-            auto executor = exec_params_->executor;
-            for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
-                executor->launch(executor->instance, exec_params_->device_id, sample_idx, this, task);
-            }
+            LaunchBatch(exec_params_->executor, exec_params_->device_id, batch_size, this, task);
         }
         return NVIMGCODEC_STATUS_SUCCESS;
     } catch (const NvJpeg2kException& e) {
@@ -16,6 +16,7 @@
  */
 
 #include <nvimgcodec.h>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <sstream>
@@ -28,15 +29,9 @@
 
 namespace nvpnm {
 
-template <typename D, int SAMPLE_FORMAT = NVIMGCODEC_SAMPLEFORMAT_P_RGB>
-static int write_pnm(nvimgcodecIoStreamDesc_t* io_stream, const D* chanR, size_t pitchR, const D* chanG, size_t pitchG, const D* chanB,
-    size_t pitchB, const D* chanA, size_t pitchA, size_t width, size_t height, int num_components, uint8_t precision)
+static void write_pnm_header(nvimgcodecIoStreamDesc_t* io_stream, size_t width, size_t height, int num_components, uint8_t precision)
 {
     size_t written_size;
-    int red = 0;
-    int green = 0;
-    int blue = 0;
-    int alpha = 0;
     std::stringstream ss{};
     if (num_components == 4) {
         ss << "P7\n";
@@ -62,7 +57,17 @@ static int write_pnm(nvimgcodecIoStreamDesc_t* io_stream, const D* chanR, size_t
     size_t length = header.size() + (precision / 8) * num_components * height * width;
     io_stream->reserve(io_stream->instance, length);
     io_stream->write(io_stream->instance, &written_size, static_cast<void*>(header.data()), header.size());
+}
 
+template <typename D, int SAMPLE_FORMAT = NVIMGCODEC_SAMPLEFORMAT_P_RGB>
+static void write_pnm_rows(nvimgcodecIoStreamDesc_t* io_stream, const D* chanR, size_t pitchR, const D* chanG, size_t pitchG,
+    const D* chanB, size_t pitchB, const D* chanA, size_t pitchA, size_t width, size_t height, int num_components, uint8_t precision)
+{
+    size_t written_size;
+    int red = 0;
+    int green = 0;
+    int blue = 0;
+    int alpha = 0;
     for (size_t y = 0; y < height; y++) {
         for (size_t x = 0; x < width; x++) {
             if (SAMPLE_FORMAT == NVIMGCODEC_SAMPLEFORMAT_P_RGB) {
@@ -109,8 +114,6 @@ static int write_pnm(nvimgcodecIoStreamDesc_t* io_stream, const D* chanR, size_t
             }
         }
     }
-    io_stream->flush(io_stream->instance);
-    return 0;
 }
 
 NvPnmEncoderPlugin::NvPnmEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
@@ -274,23 +277,57 @@ nvimgcodecProcessingStatus_t NvPnmEncoderPlugin::Encoder::encode(const char* plu
         nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
         image->getImageInfo(image->instance, &image_info);
         unsigned char* host_buffer = reinterpret_cast<unsigned char*>(image_info.buffer);
+        if (NVIMGCODEC_SAMPLEFORMAT_I_RGB != image_info.sample_format && NVIMGCODEC_SAMPLEFORMAT_P_RGB != image_info.sample_format) {
+            return NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED | NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+
+        auto* band_input = static_cast<const nvimgcodecBandInput_t*>(image_info.struct_next);
+        while (band_input && band_input->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT)
+            band_input = static_cast<const nvimgcodecBandInput_t*>(band_input->struct_next);
+        if (band_input && (band_input->band_height == 0 || !band_input->band_request)) {
+            NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Invalid band input");
+            return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        }
+
+        uint32_t width = image_info.plane_info[0].width;
+        uint32_t height = image_info.plane_info[0].height;
+        uint8_t precision = image_info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 ? 8 : 16;
+        int num_components = NVIMGCODEC_SAMPLEFORMAT_I_RGB == image_info.sample_format ? image_info.plane_info[0].num_channels
+                                                                                        : image_info.num_planes;
+        auto* io_stream = code_stream->io_stream;
+        write_pnm_header(io_stream, width, height, num_components, precision);
 
-        if (NVIMGCODEC_SAMPLEFORMAT_I_RGB == image_info.sample_format) {
-            write_pnm<unsigned char, NVIMGCODEC_SAMPLEFORMAT_I_RGB>(code_stream->io_stream, host_buffer,
-                image_info.plane_info[0].row_stride, NULL, 0, NULL, 0, NULL, 0, image_info.plane_info[0].width,
-                image_info.plane_info[0].height, image_info.plane_info[0].num_channels,
-                image_info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 ? 8 : 16);
-        } else if (NVIMGCODEC_SAMPLEFORMAT_P_RGB == image_info.sample_format) {
-            write_pnm<unsigned char>(code_stream->io_stream, host_buffer, image_info.plane_info[0].row_stride,
-                host_buffer + (size_t)image_info.plane_info[0].row_stride * (size_t)image_info.plane_info[0].height,
-                image_info.plane_info[1].row_stride,
-                host_buffer + (size_t)image_info.plane_info[0].row_stride * (size_t)image_info.plane_info[0].height +
-                    image_info.plane_info[1].row_stride * image_info.plane_info[0].height,
-                image_info.plane_info[2].row_stride, NULL, 0, image_info.plane_info[0].width, image_info.plane_info[0].height,
-                image_info.num_planes, image_info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 ? 8 : 16);
+        // Writes num_rows rows from the buffer, which holds plane_rows rows per plane
+        auto write_rows = [&](uint32_t num_rows, uint32_t plane_rows) {
+            if (NVIMGCODEC_SAMPLEFORMAT_I_RGB == image_info.sample_format) {
+                write_pnm_rows<unsigned char, NVIMGCODEC_SAMPLEFORMAT_I_RGB>(io_stream, host_buffer, image_info.plane_info[0].row_stride,
+                    NULL, 0, NULL, 0, NULL, 0, width, num_rows, num_components, precision);
+            } else {
+                write_pnm_rows<unsigned char>(io_stream, host_buffer, image_info.plane_info[0].row_stride,
+                    host_buffer + (size_t)image_info.plane_info[0].row_stride * plane_rows, image_info.plane_info[1].row_stride,
+                    host_buffer + (size_t)image_info.plane_info[0].row_stride * plane_rows +
+                        (size_t)image_info.plane_info[1].row_stride * plane_rows,
+                    image_info.plane_info[2].row_stride, NULL, 0, width, num_rows, num_components, precision);
+            }
+        };
+
+        if (!band_input) {
+            write_rows(height, height);
         } else {
-            return NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED | NVIMGCODEC_PROCESSING_STATUS_FAIL;
+            nvimgcodecImageInfo_t band_info = image_info;
+            band_info.struct_next = nullptr;
+            for (uint32_t first_row = 0; first_row < height; first_row += band_input->band_height) {
+                uint32_t num_rows = std::min(band_input->band_height, height - first_row);
+                for (uint32_t p = 0; p < band_info.num_planes; p++)
+                    band_info.plane_info[p].height = num_rows;
+                if (band_input->band_request(band_input->band_ctx, &band_info, first_row, num_rows) != NVIMGCODEC_STATUS_SUCCESS) {
+                    NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Band input was interrupted at row " << first_row);
+                    return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+                }
+                write_rows(num_rows, band_input->band_height);
+            }
         }
+        io_stream->flush(io_stream->instance);
         return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Could not encode pnm code stream - " << e.what());
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <zstd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+    #include <lz4.h>
+#endif
+#include "nvimgcodec_type_utils.h"
+#include "../utils/host_allocator.h"
+
+namespace nvtensor {
+
+// Buffer taking its memory from the host allocator of the execution parameters, if there is one
+using HostBuffer = std::vector<uint8_t, HostAllocator<uint8_t>>;
+
+inline bool IsCompressionSupported(nvimgcodecNvTensorCompression_t compression)
+{
+    switch (compression) {
+    case NVIMGCODEC_NVTENSOR_COMPRESSION_NONE:
+    case NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD:
+        return true;
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+    case NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+inline size_t RowSize(const nvimgcodecImagePlaneInfo_t& plane)
+{
+    return static_cast<size_t>(plane.width) * plane.num_channels * sample_type_to_bytes_per_element(plane.sample_type);
+}
+
+/**
+ * @brief Tells whether the planes of the image buffer are already laid out like the payload, without row padding
+ */
+inline bool IsTight(const nvimgcodecImageInfo_t& info)
+{
+    for (uint32_t p = 0; p < info.num_planes; p++) {
+        if (info.plane_info[p].row_stride != RowSize(info.plane_info[p]))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Visits the row segments of the image buffer holding bytes [offset, offset + size) of the payload
+ *
+ * The visitor is called with the position relative to offset, the position in the image buffer and the length.
+ */
+template <typename Visitor>
+void ForEachRowSegment(const nvimgcodecImageInfo_t& info, size_t offset, size_t size, Visitor&& visit)
+{
+    size_t end = offset + size;
+    size_t plane_start = 0;
+    size_t buffer_start = 0;
+    for (uint32_t p = 0; p < info.num_planes && plane_start < end; p++) {
+        auto& plane = info.plane_info[p];
+        size_t row_size = RowSize(plane);
+        size_t plane_end = plane_start + row_size * plane.height;
+        for (size_t pos = std::max(offset, plane_start); pos < std::min(end, plane_end);) {
+            size_t y = (pos - plane_start) / row_size;
+            size_t x = (pos - plane_start) % row_size;
+            size_t nbytes = std::min(row_size - x, std::min(end, plane_end) - pos);
+            visit(pos - offset, buffer_start + y * plane.row_stride + x, nbytes);
+            pos += nbytes;
+        }
+        plane_start = plane_end;
+        buffer_start += plane.row_stride * plane.height;
+    }
+}
+
+/**
+ * @brief Compresses and decompresses chunks, keeping the library contexts around between calls
+ *
+ * An instance must not be used by more than one thread at a time.
+ */
+class ChunkCodec
+{
+  public:
+    static size_t compressBound(nvimgcodecNvTensorCompression_t compression, size_t size)
+    {
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+        if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4)
+            return LZ4_compressBound(static_cast<int>(size));
+#endif
+        return compression == NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD ? ZSTD_compressBound(size) : size;
+    }
+
+    size_t compress(
+        nvimgcodecNvTensorCompression_t compression, int level, uint8_t* dst, size_t capacity, const uint8_t* src, size_t size)
+    {
+        if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD) {
+            if (!cctx_)
+                cctx_.reset(ZSTD_createCCtx());
+            if (!cctx_)
+                throw std::runtime_error("Could not create zstd context");
+            size_t compressed_size = ZSTD_compressCCtx(cctx_.get(), dst, capacity, src, size, level);
+            if (ZSTD_isError(compressed_size))
+                throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(compressed_size));
+            return compressed_size;
+        }
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+        if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4) {
+            if (size > LZ4_MAX_INPUT_SIZE)
+                throw std::runtime_error("Chunk too large for lz4");
+            int compressed_size = LZ4_compress_default(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+                static_cast<int>(size), static_cast<int>(std::min<size_t>(capacity, LZ4_MAX_INPUT_SIZE)));
+            if (compressed_size <= 0)
+                throw std::runtime_error("lz4 compression failed");
+            return compressed_size;
+        }
+#endif
+        throw std::runtime_error("Unsupported compression");
+    }
+
+    /**
+     * @brief Decompresses a chunk, which has to expand to exactly size bytes
+     */
+    void decompress(nvimgcodecNvTensorCompression_t compression, uint8_t* dst, size_t size, const uint8_t* src, size_t compressed_size)
+    {
+        if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD) {
+            if (!dctx_)
+                dctx_.reset(ZSTD_createDCtx());
+            if (!dctx_)
+                throw std::runtime_error("Could not create zstd context");
+            size_t decompressed_size = ZSTD_decompressDCtx(dctx_.get(), dst, size, src, compressed_size);
+            if (ZSTD_isError(decompressed_size))
+                throw std::runtime_error(std::string("zstd: ") + ZSTD_getErrorName(decompressed_size));
+            if (decompressed_size != size)
+                throw std::runtime_error("Unexpected chunk size");
+            return;
+        }
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+        if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4) {
+            if (size > LZ4_MAX_INPUT_SIZE || compressed_size > LZ4_MAX_INPUT_SIZE)
+                throw std::runtime_error("Chunk too large for lz4");
+            int decompressed_size = LZ4_decompress_safe(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+                static_cast<int>(compressed_size), static_cast<int>(size));
+            if (decompressed_size < 0 || static_cast<size_t>(decompressed_size) != size)
+                throw std::runtime_error("Unexpected chunk size");
+            return;
+        }
+#endif
+        throw std::runtime_error("Unsupported compression");
+    }
+
+  private:
+    struct CCtxDeleter
+    {
+        void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+    };
+    struct DCtxDeleter
+    {
+        void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+    };
+    std::unique_ptr<ZSTD_CCtx, CCtxDeleter> cctx_;
+    std::unique_ptr<ZSTD_DCtx, DCtxDeleter> dctx_;
+};
+
+} // namespace nvtensor
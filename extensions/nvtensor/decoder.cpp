@@ -0,0 +1,422 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "decoder.h"
+#include <nvimgcodec.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "chunks.h"
+#include "error_handling.h"
+#include "log.h"
+#include "../utils/parallel_exec.h"
+#include "../utils/struct_chain.h"
+#include "parsers/nvtensor_format.h"
+
+namespace nvtensor {
+
+namespace format = nvimgcodec::nvtensor;
+
+namespace {
+
+struct DecoderImpl
+{
+    DecoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~DecoderImpl();
+
+    nvimgcodecProcessingStatus_t canDecodeImpl(
+        nvimgcodecCodeStreamDesc_t* code_stream, nvimgcodecImageDesc_t* image, const nvimgcodecDecodeParams_t* params);
+    nvimgcodecStatus_t canDecode(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** code_streams,
+        nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
+
+    nvimgcodecProcessingStatus_t prepareSample(int sample_idx);
+    void decodeChunk(int tid, int task_idx);
+    void finishSample(int sample_idx);
+    nvimgcodecStatus_t decodeBatch(
+        nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecDecoder_t decoder);
+    static nvimgcodecStatus_t static_can_decode(nvimgcodecDecoder_t decoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
+    static nvimgcodecStatus_t static_decode_batch(nvimgcodecDecoder_t decoder, nvimgcodecCodeStreamDesc_t** code_streams,
+        nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct Sample
+    {
+        nvimgcodecImageDesc_t* image;
+        nvimgcodecCodeStreamDesc_t* code_stream;
+        nvimgcodecImageInfo_t info;
+        format::Header header;
+        bool tight;
+        // Stored payload, either mapped from the io stream or read into data
+        const uint8_t* payload;
+        void* mapped;
+        size_t payload_size;
+        HostBuffer data;
+        std::vector<size_t> chunk_offsets;
+        std::atomic<size_t> pending_chunks;
+        std::atomic<bool> failed;
+    };
+    std::vector<std::unique_ptr<Sample>> samples_;
+    // Sample and chunk index of each task launched on the executor
+    std::vector<std::pair<int, size_t>> tasks_;
+
+    struct PerThreadResources
+    {
+        ChunkCodec codec;
+        HostBuffer buffer;
+    };
+    std::vector<PerThreadResources> per_thread_;
+};
+
+} // namespace
+
+NvTensorDecoderPlugin::NvTensorDecoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_, "nvtensor",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, DecoderImpl::static_destroy, DecoderImpl::static_can_decode,
+          DecoderImpl::static_decode_batch, 0}
+    , framework_(framework)
+{
+}
+
+nvimgcodecDecoderDesc_t* NvTensorDecoderPlugin::getDecoderDesc()
+{
+    return &decoder_desc_;
+}
+
+nvimgcodecProcessingStatus_t DecoderImpl::canDecodeImpl(
+    nvimgcodecCodeStreamDesc_t* code_stream, nvimgcodecImageDesc_t* image, const nvimgcodecDecodeParams_t* params)
+{
+    nvimgcodecImageInfo_t cs_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(code_stream->instance, &cs_image_info);
+    if (strcmp(cs_image_info.codec_name, "nvtensor") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    format::Header header;
+    try {
+        header = format::ReadHeader(code_stream->io_stream);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_WARNING(framework_, plugin_id_, "Invalid nvtensor code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED;
+    }
+    if (!IsCompressionSupported(header.compression))
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(image->instance, &info);
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (params->enable_roi && info.region.ndim > 0)
+        status |= NVIMGCODEC_PROCESSING_STATUS_ROI_UNSUPPORTED;
+    if (FindStruct<nvimgcodecBandOutput_t>(info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT))
+        status |= NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED;
+    if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+
+    // Samples are restored as they were stored, no conversion is done
+    if (info.sample_format != header.sample_format)
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
+    if (info.num_planes != header.num_planes) {
+        status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        return status;
+    }
+    for (uint32_t p = 0; p < header.num_planes; p++) {
+        auto& plane = info.plane_info[p];
+        if (plane.width != header.planes[p].width || plane.height != header.planes[p].height ||
+            plane.row_stride < RowSize(plane))
+            status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+        if (plane.num_channels != header.planes[p].num_channels)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+        if (plane.sample_type != header.planes[p].sample_type)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+    }
+    return status;
+}
+
+nvimgcodecStatus_t DecoderImpl::canDecode(nvimgcodecProcessingStatus_t* status, nvimgcodecCodeStreamDesc_t** code_streams,
+    nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_can_decode");
+        nvtx3::scoped_range marker{"nvtensor_can_decode"};
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++)
+            status[i] = canDecodeImpl(code_streams[i], images[i], params);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if nvtensor can decode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t DecoderImpl::static_can_decode(nvimgcodecDecoder_t decoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(decoder);
+        auto handle = reinterpret_cast<DecoderImpl*>(decoder);
+        return handle->canDecode(status, code_streams, images, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+DecoderImpl::DecoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+    auto executor = exec_params_->executor;
+    int num_threads = executor->getNumThreads(executor->instance);
+    per_thread_.resize(num_threads);
+    for (auto& resources : per_thread_)
+        resources.buffer = HostBuffer(HostAllocator<uint8_t>(GetHostAllocator(exec_params_)));
+}
+
+DecoderImpl::~DecoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_destroy_decoder");
+}
+
+nvimgcodecStatus_t NvTensorDecoderPlugin::create(
+    nvimgcodecDecoder_t* decoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_create_decoder");
+        XM_CHECK_NULL(decoder);
+        XM_CHECK_NULL(exec_params);
+        XM_CHECK_NULL(exec_params->executor);
+        *decoder = reinterpret_cast<nvimgcodecDecoder_t>(new DecoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create nvtensor decoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorDecoderPlugin::static_create(
+    void* instance, nvimgcodecDecoder_t* decoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<NvTensorDecoderPlugin*>(instance);
+        return handle->create(decoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+nvimgcodecStatus_t DecoderImpl::static_destroy(nvimgcodecDecoder_t decoder)
+{
+    try {
+        XM_CHECK_NULL(decoder);
+        auto handle = reinterpret_cast<DecoderImpl*>(decoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Reads the header and gets hold of the stored payload, on the calling thread so that io streams are not shared
+ *
+ * Returns SUCCESS when the sample still has chunks to decode, anything else finishes the sample.
+ */
+nvimgcodecProcessingStatus_t DecoderImpl::prepareSample(int sample_idx)
+{
+    auto& sample = *samples_[sample_idx];
+    try {
+        auto* io_stream = sample.code_stream->io_stream;
+        sample.header = format::ReadHeader(io_stream);
+        auto& header = sample.header;
+        if (!IsCompressionSupported(header.compression))
+            return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+        sample.payload_size = header.payloadSize();
+        if (header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_NONE) {
+            sample.payload_size = 0;
+            sample.chunk_offsets.resize(header.compressed_chunk_sizes.size());
+            for (size_t c = 0; c < header.compressed_chunk_sizes.size(); c++) {
+                sample.chunk_offsets[c] = sample.payload_size;
+                sample.payload_size += header.compressed_chunk_sizes[c];
+            }
+        }
+        if (sample.payload_size == 0)
+            return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+
+        // Uncompressed samples are read straight into a tight output buffer, without going through the chunks
+        if (header.compression == NVIMGCODEC_NVTENSOR_COMPRESSION_NONE && sample.tight) {
+            io_stream->seek(io_stream->instance, header.payload_offset, SEEK_SET);
+            format::ReadExactly(io_stream, sample.info.buffer, sample.payload_size);
+            return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+        }
+
+        void* mapped = nullptr;
+        io_stream->map(io_stream->instance, &mapped, header.payload_offset, sample.payload_size);
+        if (mapped) {
+            sample.mapped = mapped;
+            sample.payload = static_cast<const uint8_t*>(mapped);
+        } else {
+            sample.data = HostBuffer(sample.payload_size, HostAllocator<uint8_t>(GetHostAllocator(exec_params_)));
+            io_stream->seek(io_stream->instance, header.payload_offset, SEEK_SET);
+            format::ReadExactly(io_stream, sample.data.data(), sample.data.size());
+            sample.payload = sample.data.data();
+        }
+        size_t num_chunks = header.numChunks();
+        sample.pending_chunks = num_chunks;
+        for (size_t c = 0; c < num_chunks; c++)
+            tasks_.emplace_back(sample_idx, c);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not read nvtensor code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+void DecoderImpl::decodeChunk(int tid, int task_idx)
+{
+    int sample_idx = tasks_[task_idx].first;
+    auto& sample = *samples_[sample_idx];
+    size_t chunk_idx = tasks_[task_idx].second;
+    try {
+        if (!sample.failed) {
+            nvtx3::scoped_range marker{"nvtensor decode chunk " + std::to_string(chunk_idx)};
+            auto& header = sample.header;
+            size_t offset = chunk_idx * header.chunk_size;
+            size_t size = std::min<size_t>(header.chunk_size, header.payloadSize() - offset);
+            auto* buffer = static_cast<uint8_t*>(sample.info.buffer);
+            auto scatter = [&](const uint8_t* src) {
+                ForEachRowSegment(sample.info, offset, size,
+                    [&](size_t pos, size_t buffer_pos, size_t nbytes) { memcpy(buffer + buffer_pos, src + pos, nbytes); });
+            };
+            if (header.compression == NVIMGCODEC_NVTENSOR_COMPRESSION_NONE) {
+                scatter(sample.payload + offset);
+            } else {
+                auto& resources = per_thread_[tid];
+                const uint8_t* src = sample.payload + sample.chunk_offsets[chunk_idx];
+                size_t compressed_size = header.compressed_chunk_sizes[chunk_idx];
+                // Tight output buffers are decompressed into in place
+                if (sample.tight) {
+                    resources.codec.decompress(header.compression, buffer + offset, size, src, compressed_size);
+                } else {
+                    resources.buffer.resize(size);
+                    resources.codec.decompress(header.compression, resources.buffer.data(), size, src, compressed_size);
+                    scatter(resources.buffer.data());
+                }
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode nvtensor chunk - " << e.what());
+        sample.failed = true;
+    }
+
+    if (sample.pending_chunks.fetch_sub(1) == 1)
+        finishSample(sample_idx);
+}
+
+void DecoderImpl::finishSample(int sample_idx)
+{
+    auto& sample = *samples_[sample_idx];
+    if (sample.mapped) {
+        auto* io_stream = sample.code_stream->io_stream;
+        io_stream->unmap(io_stream->instance, sample.mapped, sample.payload_size);
+        sample.mapped = nullptr;
+    }
+    sample.data.clear();
+    sample.image->imageReady(
+        sample.image->instance, sample.failed ? NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED : NVIMGCODEC_PROCESSING_STATUS_SUCCESS);
+}
+
+nvimgcodecStatus_t DecoderImpl::decodeBatch(
+    nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_decode_batch");
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        auto executor = exec_params_->executor;
+        XM_CHECK_NULL(executor);
+
+        samples_.clear();
+        tasks_.clear();
+        for (int i = 0; i < batch_size; i++) {
+            auto sample = std::make_unique<Sample>();
+            sample->image = images[i];
+            sample->code_stream = code_streams[i];
+            sample->info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            images[i]->getImageInfo(images[i]->instance, &sample->info);
+            sample->tight = IsTight(sample->info);
+            sample->payload = nullptr;
+            sample->mapped = nullptr;
+            sample->payload_size = 0;
+            sample->pending_chunks = 0;
+            sample->failed = false;
+            samples_.push_back(std::move(sample));
+        }
+
+        // Samples without chunks left to decode are done once their payload is read
+        for (int i = 0; i < batch_size; i++) {
+            auto result = prepareSample(i);
+            if (result != NVIMGCODEC_PROCESSING_STATUS_SUCCESS || samples_[i]->pending_chunks == 0)
+                images[i]->imageReady(images[i]->instance, result);
+        }
+        // Chunks are independent, so large images are spread over the whole pool instead of a single thread
+        LaunchBatch(executor, NVIMGCODEC_DEVICE_CPU_ONLY, static_cast<int>(tasks_.size()), this,
+            [](int tid, int task_idx, void* context) -> void {
+                auto* this_ptr = reinterpret_cast<DecoderImpl*>(context);
+                this_ptr->decodeChunk(tid, task_idx);
+            });
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode nvtensor batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t DecoderImpl::static_decode_batch(nvimgcodecDecoder_t decoder, nvimgcodecCodeStreamDesc_t** code_streams,
+    nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(decoder);
+        auto handle = reinterpret_cast<DecoderImpl*>(decoder);
+        return handle->decodeBatch(code_streams, images, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace nvtensor
@@ -0,0 +1,413 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "encoder.h"
+#include <nvimgcodec.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "chunks.h"
+#include "error_handling.h"
+#include "log.h"
+#include "../utils/struct_chain.h"
+#include "parsers/nvtensor_format.h"
+
+namespace nvtensor {
+
+namespace format = nvimgcodec::nvtensor;
+
+namespace {
+
+constexpr size_t kDefaultChunkSize = 1 << 20;
+constexpr int kDefaultZstdLevel = 1;
+
+struct EncoderImpl
+{
+    EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~EncoderImpl();
+
+    nvimgcodecProcessingStatus_t canEncodeImpl(
+        nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params);
+    nvimgcodecStatus_t canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    void encodeChunk(int tid, int task_idx);
+    nvimgcodecProcessingStatus_t writeStream(int sample_idx);
+    nvimgcodecStatus_t encodeBatch(
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecEncoder_t encoder);
+    static nvimgcodecStatus_t static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecStatus_t static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct Sample
+    {
+        nvimgcodecImageDesc_t* image;
+        nvimgcodecCodeStreamDesc_t* code_stream;
+        nvimgcodecImageInfo_t info;
+        format::Header header;
+        bool tight;
+        // Compressed chunks, or copies of the rows when the payload is stored as is from a padded buffer
+        std::vector<HostBuffer> chunks;
+        std::atomic<size_t> pending_chunks;
+        std::atomic<bool> failed;
+    };
+    std::vector<std::unique_ptr<Sample>> samples_;
+    // Sample and chunk index of each task launched on the executor
+    std::vector<std::pair<int, size_t>> tasks_;
+
+    struct PerThreadResources
+    {
+        ChunkCodec codec;
+        HostBuffer buffer;
+    };
+    std::vector<PerThreadResources> per_thread_;
+
+    // Parameters shared by the samples of the current batch
+    nvimgcodecNvTensorEncodeParams_t nvtensor_params_;
+};
+
+} // namespace
+
+NvTensorEncoderPlugin::NvTensorEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : encoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_ENCODER_DESC, sizeof(nvimgcodecEncoderDesc_t), NULL, this, plugin_id_, "nvtensor",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, EncoderImpl::static_destroy, EncoderImpl::static_can_encode,
+          EncoderImpl::static_encode_batch}
+    , framework_(framework)
+{
+}
+
+nvimgcodecEncoderDesc_t* NvTensorEncoderPlugin::getEncoderDesc()
+{
+    return &encoder_desc_;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::canEncodeImpl(
+    nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params)
+{
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(code_stream->instance, &out_info);
+    if (strcmp(out_info.codec_name, "nvtensor") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(image->instance, &info);
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (FindStruct<nvimgcodecBandInput_t>(info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT))
+        status |= NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED;
+    if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+
+    if (auto* nvtensor_params =
+            FindStruct<nvimgcodecNvTensorEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_NVTENSOR_ENCODE_PARAMS)) {
+        if (!IsCompressionSupported(nvtensor_params->compression)) {
+            NVIMGCODEC_LOG_WARNING(framework_, plugin_id_, "Unsupported compression: " << nvtensor_params->compression);
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+        }
+#ifdef NVTENSOR_EXT_HAVE_LZ4
+        if (nvtensor_params->compression == NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4 && nvtensor_params->chunk_size > LZ4_MAX_INPUT_SIZE)
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+#endif
+    }
+
+    // Samples are stored as they are, so any layout is accepted as long as it can be described by the header
+    if (info.num_planes < 1 || info.num_planes > NVIMGCODEC_MAX_NUM_PLANES)
+        status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+    for (uint32_t p = 0; p < info.num_planes && p < NVIMGCODEC_MAX_NUM_PLANES; p++) {
+        if (sample_type_to_bytes_per_element(info.plane_info[p].sample_type) == 0)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+        if (info.plane_info[p].num_channels == 0)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+    }
+    return status;
+}
+
+nvimgcodecStatus_t EncoderImpl::canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_can_encode");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++)
+            status[i] = canEncodeImpl(images[i], code_streams[i], params);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if nvtensor can encode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->canEncode(status, images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+    auto executor = exec_params_->executor;
+    int num_threads = executor->getNumThreads(executor->instance);
+    per_thread_.resize(num_threads);
+    for (auto& resources : per_thread_)
+        resources.buffer = HostBuffer(HostAllocator<uint8_t>(GetHostAllocator(exec_params_)));
+}
+
+EncoderImpl::~EncoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_destroy_encoder");
+}
+
+nvimgcodecStatus_t NvTensorEncoderPlugin::create(
+    nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_create_encoder");
+        XM_CHECK_NULL(encoder);
+        XM_CHECK_NULL(exec_params);
+        XM_CHECK_NULL(exec_params->executor);
+        *encoder = reinterpret_cast<nvimgcodecEncoder_t>(new EncoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create nvtensor encoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorEncoderPlugin::static_create(
+    void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<NvTensorEncoderPlugin*>(instance);
+        return handle->create(encoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+nvimgcodecStatus_t EncoderImpl::static_destroy(nvimgcodecEncoder_t encoder)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+void EncoderImpl::encodeChunk(int tid, int task_idx)
+{
+    auto& sample = *samples_[tasks_[task_idx].first];
+    size_t chunk_idx = tasks_[task_idx].second;
+    try {
+        if (!sample.failed) {
+            nvtx3::scoped_range marker{"nvtensor encode chunk " + std::to_string(chunk_idx)};
+            size_t offset = chunk_idx * sample.header.chunk_size;
+            size_t size = std::min<size_t>(sample.header.chunk_size, sample.header.payloadSize() - offset);
+            auto* buffer = static_cast<const uint8_t*>(sample.info.buffer);
+            auto& chunk = sample.chunks[chunk_idx];
+            auto compression = sample.header.compression;
+            if (compression == NVIMGCODEC_NVTENSOR_COMPRESSION_NONE) {
+                // Tight buffers are written directly, only padded rows need to be gathered
+                if (!sample.tight) {
+                    chunk.resize(size);
+                    ForEachRowSegment(sample.info, offset, size,
+                        [&](size_t pos, size_t buffer_pos, size_t nbytes) { memcpy(chunk.data() + pos, buffer + buffer_pos, nbytes); });
+                }
+            } else {
+                auto& resources = per_thread_[tid];
+                const uint8_t* src = buffer + offset;
+                if (!sample.tight) {
+                    resources.buffer.resize(size);
+                    ForEachRowSegment(sample.info, offset, size, [&](size_t pos, size_t buffer_pos, size_t nbytes) {
+                        memcpy(resources.buffer.data() + pos, buffer + buffer_pos, nbytes);
+                    });
+                    src = resources.buffer.data();
+                }
+                chunk.resize(ChunkCodec::compressBound(compression, size));
+                chunk.resize(resources.codec.compress(compression, nvtensor_params_.level, chunk.data(), chunk.size(), src, size));
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode nvtensor chunk - " << e.what());
+        sample.failed = true;
+    }
+
+    // The last chunk of a sample writes the code stream
+    if (sample.pending_chunks.fetch_sub(1) == 1) {
+        int sample_idx = tasks_[task_idx].first;
+        auto result = sample.failed ? NVIMGCODEC_PROCESSING_STATUS_FAIL : writeStream(sample_idx);
+        sample.image->imageReady(sample.image->instance, result);
+    }
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::writeStream(int sample_idx)
+{
+    nvtx3::scoped_range marker{"nvtensor write " + std::to_string(sample_idx)};
+    auto& sample = *samples_[sample_idx];
+    try {
+        auto* io_stream = sample.code_stream->io_stream;
+        auto& header = sample.header;
+        size_t data_size = 0;
+        if (header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_NONE) {
+            header.compressed_chunk_sizes.resize(sample.chunks.size());
+            for (size_t c = 0; c < sample.chunks.size(); c++) {
+                header.compressed_chunk_sizes[c] = sample.chunks[c].size();
+                data_size += sample.chunks[c].size();
+            }
+        } else {
+            data_size = header.payloadSize();
+        }
+        auto header_data = header.serialize();
+        io_stream->reserve(io_stream->instance, header_data.size() + data_size);
+
+        auto write = [&](const void* data, size_t size) {
+            size_t written_nbytes = 0;
+            if (io_stream->write(io_stream->instance, &written_nbytes, const_cast<void*>(data), size) != NVIMGCODEC_STATUS_SUCCESS ||
+                written_nbytes != size)
+                throw std::runtime_error("Could not write to the output stream");
+        };
+        write(header_data.data(), header_data.size());
+        if (header.compression == NVIMGCODEC_NVTENSOR_COMPRESSION_NONE && sample.tight) {
+            write(sample.info.buffer, data_size);
+        } else {
+            for (auto& chunk : sample.chunks)
+                write(chunk.data(), chunk.size());
+        }
+        io_stream->flush(io_stream->instance);
+        sample.chunks.clear();
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not write nvtensor code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::encodeBatch(
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_encode_batch");
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        auto executor = exec_params_->executor;
+        XM_CHECK_NULL(executor);
+
+        nvtensor_params_ = {NVIMGCODEC_STRUCTURE_TYPE_NVTENSOR_ENCODE_PARAMS, sizeof(nvimgcodecNvTensorEncodeParams_t), nullptr,
+            NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD, kDefaultZstdLevel, kDefaultChunkSize};
+        if (auto* nvtensor_params =
+                FindStruct<nvimgcodecNvTensorEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_NVTENSOR_ENCODE_PARAMS))
+            nvtensor_params_ = *nvtensor_params;
+        if (nvtensor_params_.chunk_size == 0)
+            nvtensor_params_.chunk_size = kDefaultChunkSize;
+
+        samples_.clear();
+        tasks_.clear();
+        for (int i = 0; i < batch_size; i++) {
+            auto sample = std::make_unique<Sample>();
+            sample->image = images[i];
+            sample->code_stream = code_streams[i];
+            sample->info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            images[i]->getImageInfo(images[i]->instance, &sample->info);
+            sample->tight = IsTight(sample->info);
+
+            auto& header = sample->header;
+            header.compression = nvtensor_params_.compression;
+            header.sample_format = sample->info.sample_format;
+            header.color_spec = sample->info.color_spec;
+            header.chroma_subsampling = sample->info.chroma_subsampling;
+            header.num_planes = sample->info.num_planes;
+            header.chunk_size = nvtensor_params_.chunk_size;
+            for (uint32_t p = 0; p < header.num_planes; p++) {
+                auto& plane = sample->info.plane_info[p];
+                header.planes[p] = {plane.width, plane.height, plane.num_channels, plane.sample_type, plane.precision};
+            }
+            size_t num_chunks = header.numChunks();
+            sample->chunks.assign(num_chunks, HostBuffer(HostAllocator<uint8_t>(GetHostAllocator(exec_params_))));
+            sample->pending_chunks = num_chunks;
+            sample->failed = false;
+            for (size_t c = 0; c < num_chunks; c++)
+                tasks_.emplace_back(i, c);
+            samples_.push_back(std::move(sample));
+        }
+
+        for (int i = 0; i < batch_size; i++) {
+            auto& sample = *samples_[i];
+            if (sample.chunks.empty())
+                sample.image->imageReady(sample.image->instance, writeStream(i));
+        }
+        // Chunks are independent, so large images are spread over the whole pool instead of a single thread
+        for (size_t t = 0; t < tasks_.size(); t++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, static_cast<int>(t), this,
+                [](int tid, int task_idx, void* context) -> void {
+                    auto* this_ptr = reinterpret_cast<EncoderImpl*>(context);
+                    this_ptr->encodeChunk(tid, task_idx);
+                });
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode nvtensor batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->encodeBatch(images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace nvtensor
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nvimgcodec.h>
+#include "encoder.h"
+#include "decoder.h"
+#include "log.h"
+#include "error_handling.h"
+
+namespace nvtensor {
+
+struct NvTensorImgCodecsExtension
+{
+  public:
+    explicit NvTensorImgCodecsExtension(const nvimgcodecFrameworkDesc_t* framework)
+        : framework_(framework)
+        , nvtensor_encoder_(framework)
+        , nvtensor_decoder_(framework)
+    {
+        framework->registerEncoder(framework->instance, nvtensor_encoder_.getEncoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        framework->registerDecoder(framework->instance, nvtensor_decoder_.getDecoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+    }
+    ~NvTensorImgCodecsExtension()
+    {
+        framework_->unregisterEncoder(framework_->instance, nvtensor_encoder_.getEncoderDesc());
+        framework_->unregisterDecoder(framework_->instance, nvtensor_decoder_.getDecoderDesc());
+    }
+
+    static nvimgcodecStatus_t nvtensorExtensionCreate(
+        void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
+    {
+        try {
+            XM_CHECK_NULL(framework)
+            NVIMGCODEC_LOG_TRACE(framework, "nvtensor_ext", "nvimgcodecExtensionCreate");
+
+            XM_CHECK_NULL(extension)
+            *extension = reinterpret_cast<nvimgcodecExtension_t>(new nvtensor::NvTensorImgCodecsExtension(framework));
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    static nvimgcodecStatus_t nvtensorExtensionDestroy(nvimgcodecExtension_t extension)
+    {
+        try {
+            XM_CHECK_NULL(extension)
+            auto ext_handle = reinterpret_cast<nvtensor::NvTensorImgCodecsExtension*>(extension);
+            NVIMGCODEC_LOG_TRACE(ext_handle->framework_, "nvtensor_ext", "nvimgcodecExtensionDestroy");
+            delete ext_handle;
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+  private:
+    const nvimgcodecFrameworkDesc_t* framework_;
+    NvTensorEncoderPlugin nvtensor_encoder_;
+    NvTensorDecoderPlugin nvtensor_decoder_;
+};
+
+} // namespace nvtensor
+
+// clang-format off
+nvimgcodecExtensionDesc_t nvtensor_extension = {
+    NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC,
+    sizeof(nvimgcodecExtensionDesc_t),
+    NULL,
+
+    NULL,
+    "nvtensor_extension",
+    NVIMGCODEC_VER,
+    NVIMGCODEC_EXT_API_VER,
+
+    nvtensor::NvTensorImgCodecsExtension::nvtensorExtensionCreate,
+    nvtensor::NvTensorImgCodecsExtension::nvtensorExtensionDestroy
+};
+// clang-format on
+
+nvimgcodecStatus_t get_nvtensor_extension_desc(nvimgcodecExtensionDesc_t* ext_desc)
+{
+    if (ext_desc == nullptr) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (ext_desc->struct_type != NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    *ext_desc = nvtensor_extension;
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
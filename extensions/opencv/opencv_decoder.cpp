@@ -18,6 +18,7 @@
 #include "opencv_decoder.h"
 #include <cstring>
 #include <future>
+#include <optional>
 #include <nvtx3/nvtx3.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
@@ -27,6 +28,7 @@
 #include "nvimgcodec.h"
 #include "../utils/stream_ctx.h"
 #include "../utils/parallel_exec.h"
+#include "../utils/image_statistics.h"
 
 namespace opencv {
 
@@ -38,7 +40,8 @@ static void color_convert(cv::Mat& img, cv::ColorConversionCodes conversion)
 }
 
 template <typename DestType, typename SrcType>
-nvimgcodecStatus_t ConvertPlanar(DestType* destinationBuffer, uint32_t plane_stride, uint32_t row_stride_bytes, const cv::Mat& image)
+nvimgcodecStatus_t ConvertPlanar(
+    DestType* destinationBuffer, uint32_t plane_stride, uint32_t row_stride_bytes, const cv::Mat& image, ImageStatisticsAccumulator* stats)
 {
     using nvimgcodec::ConvertSatNorm;
     std::vector<cv::Mat> planes;
@@ -55,13 +58,15 @@ nvimgcodecStatus_t ConvertPlanar(DestType* destinationBuffer, uint32_t plane_str
             for (size_t j = 0; j < width; ++j) {
                 destRow[j] = ConvertSatNorm<DestType>(srcRow[j]);
             }
+            if (stats)
+                stats->add(destRow, width, ch, 1);
         }
     }
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
 template <typename DestType, typename SrcType>
-nvimgcodecStatus_t ConvertInterleaved(DestType* destinationBuffer, uint32_t row_stride_bytes, const cv::Mat& image)
+nvimgcodecStatus_t ConvertInterleaved(DestType* destinationBuffer, uint32_t row_stride_bytes, const cv::Mat& image, ImageStatisticsAccumulator* stats)
 {
     using nvimgcodec::ConvertSatNorm;
     size_t height = image.size[0];
@@ -75,11 +80,13 @@ nvimgcodecStatus_t ConvertInterleaved(DestType* destinationBuffer, uint32_t row_
                 destRow[j * channels + c] = ConvertSatNorm<DestType>(srcRow[j * channels + c]);
             }
         }
+        if (stats)
+            stats->add(destRow, width, 0, channels);
     }
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
-nvimgcodecStatus_t ConvertPlanar(nvimgcodecImageInfo_t& info, const cv::Mat& decoded)
+nvimgcodecStatus_t ConvertPlanar(nvimgcodecImageInfo_t& info, const cv::Mat& decoded, ImageStatisticsAccumulator* stats)
 {
 
 #define CaseConvertPlanar(OUT_SAMPLE_TYPE, OutType, img_info, image)                                                          \
@@ -87,10 +94,12 @@ nvimgcodecStatus_t ConvertPlanar(nvimgcodecImageInfo_t& info, const cv::Mat& dec
         switch (image.depth()) {                                                                                              \
         case CV_8U:                                                                                                           \
             return ConvertPlanar<OutType, uint8_t>(reinterpret_cast<OutType*>(img_info.buffer),                               \
-                img_info.plane_info[0].row_stride * img_info.plane_info[0].height, img_info.plane_info[0].row_stride, image); \
+                img_info.plane_info[0].row_stride * img_info.plane_info[0].height, img_info.plane_info[0].row_stride, image,  \
+                stats);                                                                                                       \
         case CV_16U:                                                                                                          \
             return ConvertPlanar<OutType, uint16_t>(reinterpret_cast<OutType*>(img_info.buffer),                              \
-                img_info.plane_info[0].row_stride * img_info.plane_info[0].height, img_info.plane_info[0].row_stride, image); \
+                img_info.plane_info[0].row_stride * img_info.plane_info[0].height, img_info.plane_info[0].row_stride, image,  \
+                stats);                                                                                                       \
         default:                                                                                                              \
             return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED;                                                               \
         }                                                                                                                     \
@@ -108,7 +117,7 @@ nvimgcodecStatus_t ConvertPlanar(nvimgcodecImageInfo_t& info, const cv::Mat& dec
 #undef CaseConvertPlanar
 }
 
-nvimgcodecStatus_t ConvertInterleaved(nvimgcodecImageInfo_t& info, const cv::Mat& decoded)
+nvimgcodecStatus_t ConvertInterleaved(nvimgcodecImageInfo_t& info, const cv::Mat& decoded, ImageStatisticsAccumulator* stats)
 {
 
 #define CaseConvertInterleaved(OUT_SAMPLE_TYPE, OutType, img_info, image)                               \
@@ -116,10 +125,12 @@ nvimgcodecStatus_t ConvertInterleaved(nvimgcodecImageInfo_t& info, const cv::Mat
         switch (image.depth()) {                                                                        \
         case CV_8U:                                                                                     \
             return ConvertInterleaved<OutType, uint8_t>(                                                \
-                reinterpret_cast<OutType*>(img_info.buffer), img_info.plane_info[0].row_stride, image); \
+                reinterpret_cast<OutType*>(img_info.buffer), img_info.plane_info[0].row_stride, image,  \
+                stats);                                                                         \
         case CV_16U:                                                                                    \
             return ConvertInterleaved<OutType, uint16_t>(                                               \
-                reinterpret_cast<OutType*>(img_info.buffer), img_info.plane_info[0].row_stride, image); \
+                reinterpret_cast<OutType*>(img_info.buffer), img_info.plane_info[0].row_stride, image,  \
+                stats);                                                                         \
         default:                                                                                        \
             return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED;                                         \
         }                                                                                               \
@@ -140,12 +151,25 @@ nvimgcodecStatus_t ConvertInterleaved(nvimgcodecImageInfo_t& info, const cv::Mat
 
 nvimgcodecStatus_t Convert(nvimgcodecImageInfo_t& info, const cv::Mat& decoded)
 {
+    // The output buffer is sized from the image info, so a decoded image of a different size must not be copied into it
+    if (decoded.rows != static_cast<int>(info.plane_info[0].height) || decoded.cols != static_cast<int>(info.plane_info[0].width))
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+
+    // Statistics are accumulated from each output row as it is converted
+    std::optional<ImageStatisticsAccumulator> stats;
+    if (auto* stats_out = ImageStatisticsAccumulator::Find(info))
+        stats.emplace(stats_out, decoded.channels());
+
+    nvimgcodecStatus_t ret;
     if (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB || info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR ||
         info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED) {
-        return ConvertPlanar(info, decoded);
+        ret = ConvertPlanar(info, decoded, stats ? &*stats : nullptr);
     } else {
-        return ConvertInterleaved(info, decoded);
+        ret = ConvertInterleaved(info, decoded, stats ? &*stats : nullptr);
     }
+    if (stats && ret == NVIMGCODEC_STATUS_SUCCESS)
+        stats->finish();
+    return ret;
 }
 
 struct DecoderImpl
@@ -172,6 +196,10 @@ struct DecoderImpl
     const nvimgcodecExecutionParams_t* exec_params_;
 
     CodeStreamCtxManager code_stream_mgr_;
+
+    // Measured costs of checking and decoding samples, to decide how to parallelize the next batches
+    AdaptiveParallelPolicy can_decode_policy_;
+    std::shared_ptr<AdaptiveParallelPolicy> decode_policy_ = std::make_shared<AdaptiveParallelPolicy>();
 };
 
 OpenCVDecoderPlugin::OpenCVDecoderPlugin(const std::string& codec_name, const nvimgcodecFrameworkDesc_t* framework)
@@ -179,7 +207,7 @@ OpenCVDecoderPlugin::OpenCVDecoderPlugin(const std::string& codec_name, const nv
     , plugin_id_("opencv_" + codec_name_ + "_decoder")
     , decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), NULL, this, plugin_id_.c_str(), codec_name_.c_str(),
           NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, DecoderImpl::static_destroy, DecoderImpl::static_can_decode,
-          DecoderImpl::static_decode_batch}
+          DecoderImpl::static_decode_batch, 1}
     , framework_(framework)
 {}
 
@@ -226,6 +254,22 @@ nvimgcodecStatus_t DecoderImpl::canDecodeImpl(CodeStreamCtx& ctx)
             nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
             image->getImageInfo(image->instance, &info);
 
+            // Decoding is not incremental, so the whole image has to fit in the output buffer
+            auto* band_output = static_cast<const nvimgcodecBandOutput_t*>(info.struct_next);
+            while (band_output && band_output->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT)
+                band_output = static_cast<const nvimgcodecBandOutput_t*>(band_output->struct_next);
+            if (band_output) {
+                *status |= NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED;
+            }
+
+            // OpenCV always decodes the first page at full resolution, so reduced pyramid levels are left to libtiff
+            auto* tiff_params = static_cast<const nvimgcodecTiffDecodeParams_t*>(params->struct_next);
+            while (tiff_params && tiff_params->struct_type != NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS)
+                tiff_params = static_cast<const nvimgcodecTiffDecodeParams_t*>(tiff_params->struct_next);
+            if (tiff_params && tiff_params->level != 0) {
+                *status |= NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED;
+            }
+
             switch (info.sample_format) {
             case NVIMGCODEC_SAMPLEFORMAT_P_YUV:
                 *status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
@@ -293,7 +337,7 @@ nvimgcodecStatus_t DecoderImpl::canDecode(nvimgcodecProcessingStatus_t* status,
             auto this_ptr = reinterpret_cast<DecoderImpl*>(context);
             this_ptr->canDecodeImpl(*this_ptr->code_stream_mgr_[sample_idx]);
         };
-        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_);
+        BlockParallelExec(this, task, code_stream_mgr_.size(), exec_params_, &can_decode_policy_);
         for (int i = 0; i < batch_size; i++) {
             status[i] = code_stream_mgr_.get_batch_item(i).processing_status;
         }
@@ -320,6 +364,7 @@ DecoderImpl::DecoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t*
     : plugin_id_(plugin_id)
     , framework_(framework)
     , exec_params_(exec_params)
+    , code_stream_mgr_(GetHostAllocator(exec_params))
 {
 }
 
@@ -487,13 +532,7 @@ nvimgcodecStatus_t DecoderImpl::decodeBatch(
             auto& batch_item = this_ptr->code_stream_mgr_.get_batch_item(sample_idx);
             this_ptr->decodeImpl(batch_item);
         };
-        if (batch_size == 1) {
-            task(0, 0, this);
-        } else {
-            for (int sample_idx = 0; sample_idx < batch_size; sample_idx++) {
-                executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, sample_idx, this, task);
-            }
-        }
+        AdaptiveLaunchBatch(executor, NVIMGCODEC_DEVICE_CPU_ONLY, batch_size, this, task, decode_policy_);
         return NVIMGCODEC_STATUS_SUCCESS;
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not decode batch - " << e.what());
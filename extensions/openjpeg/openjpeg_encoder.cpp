@@ -0,0 +1,619 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "openjpeg_encoder.h"
+#include <openjpeg.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nvtx3/nvtx3.hpp>
+#include "error_handling.h"
+#include "log.h"
+#include "nvimgcodec.h"
+#include "../utils/struct_chain.h"
+
+namespace openjpeg {
+
+namespace {
+
+/**
+ * @brief Exposes the output io stream as an OpenJPEG write stream
+ */
+class IoStreamWriter
+{
+  public:
+    IoStreamWriter(nvimgcodecIoStreamDesc_t* io_stream, size_t size_estimate)
+        : io_stream_(io_stream)
+        , capacity_(size_estimate)
+    {
+        io_stream_->reserve(io_stream_->instance, capacity_);
+    }
+
+    static OPJ_SIZE_T write(void* buffer, OPJ_SIZE_T nbytes, void* user_data)
+    {
+        auto* writer = static_cast<IoStreamWriter*>(user_data);
+        ptrdiff_t pos = 0;
+        if (writer->io_stream_->tell(writer->io_stream_->instance, &pos) != NVIMGCODEC_STATUS_SUCCESS)
+            return static_cast<OPJ_SIZE_T>(-1);
+        // Memory sinks only accept writes within the reserved size, so grow it geometrically
+        size_t required = static_cast<size_t>(pos) + nbytes;
+        if (required > writer->capacity_) {
+            writer->capacity_ = std::max(required, 2 * writer->capacity_);
+            writer->io_stream_->reserve(writer->io_stream_->instance, writer->capacity_);
+        }
+        size_t written_nbytes = 0;
+        if (writer->io_stream_->write(writer->io_stream_->instance, &written_nbytes, buffer, nbytes) != NVIMGCODEC_STATUS_SUCCESS ||
+            written_nbytes != nbytes)
+            return static_cast<OPJ_SIZE_T>(-1);
+        writer->end_ = std::max(writer->end_, required);
+        return written_nbytes;
+    }
+
+    static OPJ_OFF_T skip(OPJ_OFF_T nbytes, void* user_data)
+    {
+        auto* writer = static_cast<IoStreamWriter*>(user_data);
+        if (writer->io_stream_->seek(writer->io_stream_->instance, nbytes, SEEK_CUR) != NVIMGCODEC_STATUS_SUCCESS)
+            return -1;
+        return nbytes;
+    }
+
+    // JP2 box lengths are patched by seeking back, so the end of data is tracked here
+    static OPJ_BOOL seek(OPJ_OFF_T offset, void* user_data)
+    {
+        auto* writer = static_cast<IoStreamWriter*>(user_data);
+        return writer->io_stream_->seek(writer->io_stream_->instance, offset, SEEK_SET) == NVIMGCODEC_STATUS_SUCCESS ? OPJ_TRUE
+                                                                                                                   : OPJ_FALSE;
+    }
+
+    void finish()
+    {
+        io_stream_->seek(io_stream_->instance, end_, SEEK_SET);
+        io_stream_->flush(io_stream_->instance);
+    }
+
+  private:
+    nvimgcodecIoStreamDesc_t* io_stream_;
+    size_t capacity_;
+    size_t end_ = 0;
+};
+
+struct CodecDeleter
+{
+    void operator()(opj_codec_t* codec) const { opj_destroy_codec(codec); }
+};
+struct StreamDeleter
+{
+    void operator()(opj_stream_t* stream) const { opj_stream_destroy(stream); }
+};
+struct ImageDeleter
+{
+    void operator()(opj_image_t* image) const { opj_image_destroy(image); }
+};
+
+struct MessageContext
+{
+    const nvimgcodecFrameworkDesc_t* framework;
+    const char* plugin_id;
+};
+
+void LogError(const char* msg, void* client_data)
+{
+    auto* ctx = static_cast<MessageContext*>(client_data);
+    NVIMGCODEC_LOG_ERROR(ctx->framework, ctx->plugin_id, "openjpeg: " << msg);
+}
+
+void LogWarning(const char* msg, void* client_data)
+{
+    auto* ctx = static_cast<MessageContext*>(client_data);
+    NVIMGCODEC_LOG_WARNING(ctx->framework, ctx->plugin_id, "openjpeg: " << msg);
+}
+
+bool IsInterleaved(nvimgcodecSampleFormat_t sample_format)
+{
+    return sample_format == NVIMGCODEC_SAMPLEFORMAT_I_RGB || sample_format == NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED;
+}
+
+uint32_t NumComponents(const nvimgcodecImageInfo_t& info)
+{
+    return IsInterleaved(info.sample_format) ? info.plane_info[0].num_channels : info.num_planes;
+}
+
+uint32_t Precision(const nvimgcodecImageInfo_t& info)
+{
+    if (info.plane_info[0].precision != 0)
+        return info.plane_info[0].precision;
+    return info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16 ? 16 : 8;
+}
+
+OPJ_COLOR_SPACE ToOpjColorSpace(const nvimgcodecImageInfo_t& info)
+{
+    if (NumComponents(info) < 3)
+        return OPJ_CLRSPC_GRAY;
+    switch (info.color_spec) {
+    case NVIMGCODEC_COLORSPEC_SRGB:
+        return OPJ_CLRSPC_SRGB;
+    case NVIMGCODEC_COLORSPEC_SYCC:
+        return OPJ_CLRSPC_SYCC;
+    default:
+        return OPJ_CLRSPC_UNSPECIFIED;
+    }
+}
+
+template <typename T>
+void CopyComponent(const nvimgcodecImageInfo_t& info, uint32_t c, opj_image_comp_t* comp)
+{
+    bool interleaved = IsInterleaved(info.sample_format);
+    uint32_t plane = interleaved ? 0 : c;
+    uint32_t step = interleaved ? info.plane_info[0].num_channels : 1;
+    auto* ptr = static_cast<const uint8_t*>(info.buffer);
+    for (uint32_t p = 0; p < plane; p++)
+        ptr += info.plane_info[p].row_stride * info.plane_info[p].height;
+    if (interleaved)
+        ptr += c * sizeof(T);
+    for (uint32_t y = 0; y < comp->h; y++) {
+        auto* row = reinterpret_cast<const T*>(ptr + y * info.plane_info[plane].row_stride);
+        OPJ_INT32* dst = comp->data + static_cast<size_t>(y) * comp->w;
+        for (uint32_t x = 0; x < comp->w; x++)
+            dst[x] = row[x * step];
+    }
+}
+
+/**
+ * @brief Creates an OpenJPEG image with a copy of the samples, chroma planes of P_YUV keep their subsampling
+ */
+opj_image_t* CreateImage(const nvimgcodecImageInfo_t& info)
+{
+    uint32_t num_components = NumComponents(info);
+    bool interleaved = IsInterleaved(info.sample_format);
+    uint32_t precision = Precision(info);
+    std::vector<opj_image_cmptparm_t> comp_params(num_components);
+    for (uint32_t c = 0; c < num_components; c++) {
+        auto& plane_info = info.plane_info[interleaved ? 0 : c];
+        auto& param = comp_params[c];
+        memset(&param, 0, sizeof(param));
+        param.dx = 1;
+        param.dy = 1;
+        if (c > 0 && info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_YUV) {
+            param.dx = info.chroma_subsampling == NVIMGCODEC_SAMPLING_422 || info.chroma_subsampling == NVIMGCODEC_SAMPLING_420 ? 2 : 1;
+            param.dy = info.chroma_subsampling == NVIMGCODEC_SAMPLING_420 ? 2 : 1;
+        }
+        param.w = plane_info.width;
+        param.h = plane_info.height;
+        param.prec = precision;
+        param.sgnd = 0;
+    }
+
+    opj_image_t* image = opj_image_create(num_components, comp_params.data(), ToOpjColorSpace(info));
+    if (!image)
+        return nullptr;
+    image->x0 = 0;
+    image->y0 = 0;
+    image->x1 = info.plane_info[0].width;
+    image->y1 = info.plane_info[0].height;
+    // Gray with alpha or RGBA, JP2 records it in the channel definition box
+    if (num_components == 2 || num_components == 4)
+        image->comps[num_components - 1].alpha = 1;
+
+    for (uint32_t c = 0; c < num_components; c++) {
+        if (info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16)
+            CopyComponent<uint16_t>(info, c, &image->comps[c]);
+        else
+            CopyComponent<uint8_t>(info, c, &image->comps[c]);
+    }
+    return image;
+}
+
+// Initial reservation of the output, so that typical code streams are written without growing it
+size_t EstimateSize(const nvimgcodecImageInfo_t& info, size_t target_size)
+{
+    constexpr size_t kHeaderSize = 1024;
+    if (target_size > 0)
+        return target_size + kHeaderSize;
+    size_t raw_size = 0;
+    for (uint32_t p = 0; p < info.num_planes; p++)
+        raw_size += info.plane_info[p].row_stride * info.plane_info[p].height;
+    return raw_size / 2 + kHeaderSize;
+}
+
+struct EncoderImpl
+{
+    EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params);
+    ~EncoderImpl();
+
+    nvimgcodecProcessingStatus_t canEncodeImpl(
+        nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params);
+    nvimgcodecStatus_t canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    nvimgcodecProcessingStatus_t encodeImpl(int sample_idx);
+    nvimgcodecStatus_t encodeBatch(
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    static nvimgcodecStatus_t static_destroy(nvimgcodecEncoder_t encoder);
+    static nvimgcodecStatus_t static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+    static nvimgcodecStatus_t static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+        nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params);
+
+    const char* plugin_id_;
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecExecutionParams_t* exec_params_;
+
+    struct Sample
+    {
+        nvimgcodecImageDesc_t* image;
+        nvimgcodecCodeStreamDesc_t* code_stream;
+    };
+    std::vector<Sample> samples_;
+
+    // Parameters shared by the samples of the current batch
+    nvimgcodecJpeg2kEncodeParams_t j2k_params_;
+    float target_psnr_ = 0;
+    size_t target_size_ = 0;
+    int threads_per_image_ = 1;
+};
+
+} // namespace
+
+OpenjpegEncoderPlugin::OpenjpegEncoderPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : encoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_ENCODER_DESC, sizeof(nvimgcodecEncoderDesc_t), NULL, this, plugin_id_, "jpeg2k",
+          NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, EncoderImpl::static_destroy, EncoderImpl::static_can_encode,
+          EncoderImpl::static_encode_batch}
+    , framework_(framework)
+{
+}
+
+nvimgcodecEncoderDesc_t* OpenjpegEncoderPlugin::getEncoderDesc()
+{
+    return &encoder_desc_;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::canEncodeImpl(
+    nvimgcodecImageDesc_t* image, nvimgcodecCodeStreamDesc_t* code_stream, const nvimgcodecEncodeParams_t* params)
+{
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(code_stream->instance, &out_info);
+    if (strcmp(out_info.codec_name, "jpeg2k") != 0)
+        return NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED;
+
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(image->instance, &info);
+
+    nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+    if (FindStruct<nvimgcodecBandInput_t>(info.struct_next, NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT))
+        status |= NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED;
+    if (info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        status |= NVIMGCODEC_PROCESSING_STATUS_FAIL;
+
+    if (auto* j2k_params = FindStruct<nvimgcodecJpeg2kEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_JPEG2K_ENCODE_PARAMS)) {
+        if ((j2k_params->code_block_w != 32 || j2k_params->code_block_h != 32) &&
+            (j2k_params->code_block_w != 64 || j2k_params->code_block_h != 64)) {
+            NVIMGCODEC_LOG_WARNING(framework_, plugin_id_,
+                "Unsupported block size: " << j2k_params->code_block_w << "x" << j2k_params->code_block_h << "(Valid values: 32, 64)");
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+        }
+        if (j2k_params->num_resolutions == 0 || j2k_params->num_resolutions > OPJ_J2K_MAXRLVLS) {
+            NVIMGCODEC_LOG_WARNING(framework_, plugin_id_,
+                "Unsupported number of resolutions: " << j2k_params->num_resolutions << " (max = " << OPJ_J2K_MAXRLVLS << ") ");
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+        }
+        if (j2k_params->prog_order < NVIMGCODEC_JPEG2K_PROG_ORDER_LRCP || j2k_params->prog_order > NVIMGCODEC_JPEG2K_PROG_ORDER_CPRL)
+            status |= NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED;
+    }
+
+    switch (info.color_spec) {
+    case NVIMGCODEC_COLORSPEC_UNKNOWN:
+    case NVIMGCODEC_COLORSPEC_SRGB:
+    case NVIMGCODEC_COLORSPEC_GRAY:
+    case NVIMGCODEC_COLORSPEC_SYCC:
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_COLOR_SPEC_UNSUPPORTED;
+        break;
+    }
+    switch (info.chroma_subsampling) {
+    case NVIMGCODEC_SAMPLING_444:
+    case NVIMGCODEC_SAMPLING_422:
+    case NVIMGCODEC_SAMPLING_420:
+    case NVIMGCODEC_SAMPLING_GRAY:
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+        break;
+    }
+    if (out_info.chroma_subsampling != info.chroma_subsampling)
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+
+    switch (info.sample_format) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        if (info.plane_info[0].num_channels < 1 || info.plane_info[0].num_channels > 4 ||
+            (info.sample_format == NVIMGCODEC_SAMPLEFORMAT_I_RGB && info.plane_info[0].num_channels != 3))
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_P_YUV:
+        if (info.num_planes != 3)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED:
+        if (info.num_planes < 1 || info.num_planes > 4)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_Y:
+        if (info.num_planes != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED;
+        if (info.chroma_subsampling != NVIMGCODEC_SAMPLING_GRAY)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+        break;
+    default:
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED;
+        break;
+    }
+    // Only P_YUV carries subsampled planes, every other layout has full size components
+    if (info.sample_format != NVIMGCODEC_SAMPLEFORMAT_P_YUV && info.chroma_subsampling != NVIMGCODEC_SAMPLING_444 &&
+        info.chroma_subsampling != NVIMGCODEC_SAMPLING_GRAY)
+        status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED;
+
+    for (uint32_t p = 0; p < info.num_planes && p < NVIMGCODEC_MAX_NUM_PLANES; p++) {
+        auto sample_type = info.plane_info[p].sample_type;
+        if (sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 && sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+        if (sample_type != info.plane_info[0].sample_type)
+            status |= NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED;
+        if (info.num_planes > 1 && info.plane_info[p].num_channels != 1)
+            status |= NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED;
+    }
+    return status;
+}
+
+nvimgcodecStatus_t EncoderImpl::canEncode(nvimgcodecProcessingStatus_t* status, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "openjpeg_can_encode");
+        XM_CHECK_NULL(status);
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        for (int i = 0; i < batch_size; i++)
+            status[i] = canEncodeImpl(images[i], code_streams[i], params);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if openjpeg can encode - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_can_encode(nvimgcodecEncoder_t encoder, nvimgcodecProcessingStatus_t* status,
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->canEncode(status, images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+EncoderImpl::EncoderImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecExecutionParams_t* exec_params)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+    , exec_params_(exec_params)
+{
+}
+
+EncoderImpl::~EncoderImpl()
+{
+    NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "openjpeg_destroy_encoder");
+}
+
+nvimgcodecStatus_t OpenjpegEncoderPlugin::create(
+    nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "openjpeg_create_encoder");
+        XM_CHECK_NULL(encoder);
+        XM_CHECK_NULL(exec_params);
+        *encoder = reinterpret_cast<nvimgcodecEncoder_t>(new EncoderImpl(plugin_id_, framework_, exec_params));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create openjpeg encoder - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t OpenjpegEncoderPlugin::static_create(
+    void* instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    try {
+        XM_CHECK_NULL(instance);
+        auto handle = reinterpret_cast<OpenjpegEncoderPlugin*>(instance);
+        return handle->create(encoder, exec_params, options);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+nvimgcodecStatus_t EncoderImpl::static_destroy(nvimgcodecEncoder_t encoder)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecProcessingStatus_t EncoderImpl::encodeImpl(int sample_idx)
+{
+    nvtx3::scoped_range marker{"openjpeg encode " + std::to_string(sample_idx)};
+    auto& sample = samples_[sample_idx];
+    try {
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        sample.image->getImageInfo(sample.image->instance, &info);
+        nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        sample.code_stream->getImageInfo(sample.code_stream->instance, &out_info);
+        uint32_t width = info.plane_info[0].width;
+        uint32_t height = info.plane_info[0].height;
+
+        std::unique_ptr<opj_image_t, ImageDeleter> image(CreateImage(info));
+        if (!image)
+            throw std::runtime_error("could not create openjpeg image");
+
+        opj_cparameters_t parameters;
+        opj_set_default_encoder_parameters(&parameters);
+        parameters.cblockw_init = j2k_params_.code_block_w;
+        parameters.cblockh_init = j2k_params_.code_block_h;
+        parameters.prog_order = static_cast<OPJ_PROG_ORDER>(j2k_params_.prog_order);
+        parameters.irreversible = j2k_params_.irreversible;
+        uint32_t max_num_resolutions = static_cast<uint32_t>(log2(static_cast<float>(std::min(height, width)))) + 1;
+        parameters.numresolution = std::min(j2k_params_.num_resolutions, max_num_resolutions);
+        parameters.tcp_numlayers = 1;
+        if (target_size_ > 0) {
+            // Rates are compression ratios against the uncompressed size of the components
+            double raw_size = 0;
+            for (uint32_t c = 0; c < image->numcomps; c++)
+                raw_size += static_cast<double>(image->comps[c].w) * image->comps[c].h * image->comps[c].prec / 8;
+            parameters.tcp_rates[0] = static_cast<float>(std::max(1.0, raw_size / target_size_));
+            parameters.cp_disto_alloc = 1;
+        } else if (parameters.irreversible && target_psnr_ > 0) {
+            parameters.tcp_distoratio[0] = target_psnr_;
+            parameters.cp_fixed_quality = 1;
+        } else {
+            parameters.tcp_rates[0] = 0; // All coding passes are kept
+            parameters.cp_disto_alloc = 1;
+        }
+        // Same decision as the nvjpeg2k encoder, RGB is decorrelated when YCC is requested for the code stream
+        bool mct = image->numcomps >= 3 && info.sample_format != NVIMGCODEC_SAMPLEFORMAT_P_YUV &&
+                   (out_info.color_spec == NVIMGCODEC_COLORSPEC_SYCC || out_info.color_spec == NVIMGCODEC_COLORSPEC_GRAY) &&
+                   info.color_spec != NVIMGCODEC_COLORSPEC_SYCC && info.color_spec != NVIMGCODEC_COLORSPEC_GRAY;
+        parameters.tcp_mct = mct ? 1 : 0;
+
+        OPJ_CODEC_FORMAT format = j2k_params_.stream_type == NVIMGCODEC_JPEG2K_STREAM_J2K ? OPJ_CODEC_J2K : OPJ_CODEC_JP2;
+        std::unique_ptr<opj_codec_t, CodecDeleter> codec(opj_create_compress(format));
+        if (!codec)
+            throw std::runtime_error("could not create openjpeg codec");
+        MessageContext message_ctx{framework_, plugin_id_};
+        opj_set_error_handler(codec.get(), LogError, &message_ctx);
+        opj_set_warning_handler(codec.get(), LogWarning, &message_ctx);
+        if (!opj_setup_encoder(codec.get(), &parameters, image.get()))
+            throw std::runtime_error("could not set up openjpeg encoder");
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 5)
+        if (threads_per_image_ > 1)
+            opj_codec_set_threads(codec.get(), threads_per_image_);
+#endif
+
+        IoStreamWriter writer(sample.code_stream->io_stream, EstimateSize(info, target_size_));
+        std::unique_ptr<opj_stream_t, StreamDeleter> stream(opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, OPJ_FALSE));
+        if (!stream)
+            throw std::runtime_error("could not create openjpeg stream");
+        opj_stream_set_user_data(stream.get(), &writer, nullptr);
+        opj_stream_set_write_function(stream.get(), IoStreamWriter::write);
+        opj_stream_set_skip_function(stream.get(), IoStreamWriter::skip);
+        opj_stream_set_seek_function(stream.get(), IoStreamWriter::seek);
+
+        if (!opj_start_compress(codec.get(), image.get(), stream.get()) || !opj_encode(codec.get(), stream.get()) ||
+            !opj_end_compress(codec.get(), stream.get()))
+            throw std::runtime_error("could not encode jpeg2k code stream");
+        stream.reset();
+        writer.finish();
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode jpeg2k code stream - " << e.what());
+        return NVIMGCODEC_PROCESSING_STATUS_FAIL;
+    }
+    return NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::encodeBatch(
+    nvimgcodecImageDesc_t** images, nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "openjpeg_encode_batch");
+        XM_CHECK_NULL(images);
+        XM_CHECK_NULL(code_streams);
+        XM_CHECK_NULL(params);
+        if (batch_size < 1) {
+            NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Batch size lower than 1");
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        auto executor = exec_params_->executor;
+        XM_CHECK_NULL(executor);
+
+        // Defaults of the nvjpeg2k encoder
+        j2k_params_ = {NVIMGCODEC_STRUCTURE_TYPE_JPEG2K_ENCODE_PARAMS, sizeof(nvimgcodecJpeg2kEncodeParams_t), nullptr,
+            NVIMGCODEC_JPEG2K_STREAM_JP2, NVIMGCODEC_JPEG2K_PROG_ORDER_LRCP, 6, 64, 64, 0};
+        if (auto* j2k_params = FindStruct<nvimgcodecJpeg2kEncodeParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_JPEG2K_ENCODE_PARAMS))
+            j2k_params_ = *j2k_params;
+        target_psnr_ = params->target_psnr;
+        target_size_ = 0;
+        auto* rate_control = FindStruct<nvimgcodecRateControlParams_t>(params->struct_next, NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS);
+        if (rate_control) {
+            target_size_ = rate_control->target_size;
+            if (rate_control->target_psnr > 0)
+                target_psnr_ = rate_control->target_psnr;
+        }
+        // Samples are encoded in parallel on the executor, threads left over when the batch is smaller than
+        // the pool are given to OpenJPEG to encode the code-blocks of each image
+        int num_threads = executor->getNumThreads(executor->instance);
+        threads_per_image_ = std::max(1, num_threads / batch_size);
+
+        samples_.clear();
+        samples_.resize(batch_size);
+        for (int i = 0; i < batch_size; i++)
+            samples_[i] = {images[i], code_streams[i]};
+
+        for (int i = 0; i < batch_size; i++) {
+            executor->launch(executor->instance, NVIMGCODEC_DEVICE_CPU_ONLY, i, this, [](int tid, int sample_idx, void* context) -> void {
+                auto* this_ptr = reinterpret_cast<EncoderImpl*>(context);
+                auto& sample = this_ptr->samples_[sample_idx];
+                auto result = this_ptr->encodeImpl(sample_idx);
+                sample.image->imageReady(sample.image->instance, result);
+            });
+        }
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not encode jpeg2k batch - " << e.what());
+        for (int i = 0; i < batch_size; ++i)
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_FAIL);
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t EncoderImpl::static_encode_batch(nvimgcodecEncoder_t encoder, nvimgcodecImageDesc_t** images,
+    nvimgcodecCodeStreamDesc_t** code_streams, int batch_size, const nvimgcodecEncodeParams_t* params)
+{
+    try {
+        XM_CHECK_NULL(encoder);
+        auto handle = reinterpret_cast<EncoderImpl*>(encoder);
+        return handle->encodeBatch(images, code_streams, batch_size, params);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+} // namespace openjpeg
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nvimgcodec.h>
+#include "openjpeg_encoder.h"
+#include "log.h"
+#include "error_handling.h"
+
+namespace openjpeg {
+
+struct OpenjpegImgCodecsExtension
+{
+  public:
+    explicit OpenjpegImgCodecsExtension(const nvimgcodecFrameworkDesc_t* framework)
+        : framework_(framework)
+        , j2k_encoder_(framework)
+    {
+        framework->registerEncoder(framework->instance, j2k_encoder_.getEncoderDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+    }
+    ~OpenjpegImgCodecsExtension()
+    {
+        framework_->unregisterEncoder(framework_->instance, j2k_encoder_.getEncoderDesc());
+    }
+
+    static nvimgcodecStatus_t openjpegExtensionCreate(
+        void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
+    {
+        try {
+            XM_CHECK_NULL(framework)
+            NVIMGCODEC_LOG_TRACE(framework, "openjpeg_ext", "nvimgcodecExtensionCreate");
+
+            XM_CHECK_NULL(extension)
+            *extension = reinterpret_cast<nvimgcodecExtension_t>(new openjpeg::OpenjpegImgCodecsExtension(framework));
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    static nvimgcodecStatus_t openjpegExtensionDestroy(nvimgcodecExtension_t extension)
+    {
+        try {
+            XM_CHECK_NULL(extension)
+            auto ext_handle = reinterpret_cast<openjpeg::OpenjpegImgCodecsExtension*>(extension);
+            NVIMGCODEC_LOG_TRACE(ext_handle->framework_, "openjpeg_ext", "nvimgcodecExtensionDestroy");
+            delete ext_handle;
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+  private:
+    const nvimgcodecFrameworkDesc_t* framework_;
+    OpenjpegEncoderPlugin j2k_encoder_;
+};
+
+} // namespace openjpeg
+
+// clang-format off
+nvimgcodecExtensionDesc_t openjpeg_extension = {
+    NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC,
+    sizeof(nvimgcodecExtensionDesc_t),
+    NULL,
+
+    NULL,
+    "openjpeg_extension",
+    NVIMGCODEC_VER,
+    NVIMGCODEC_EXT_API_VER,
+
+    openjpeg::OpenjpegImgCodecsExtension::openjpegExtensionCreate,
+    openjpeg::OpenjpegImgCodecsExtension::openjpegExtensionDestroy
+};
+// clang-format on
+
+nvimgcodecStatus_t get_openjpeg_extension_desc(nvimgcodecExtensionDesc_t* ext_desc)
+{
+    if (ext_desc == nullptr) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (ext_desc->struct_type != NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    *ext_desc = openjpeg_extension;
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Decides how to spread a batch of tasks over the executor threads, from the cost of a task and of handing work off to
+// another thread, both measured while running previous batches. Each decoder keeps one policy per parallel stage, so
+// the cost is tracked per codec. Thread safe.
+class AdaptiveParallelPolicy
+{
+  public:
+    // Work given to a thread has to take this many times the hand-off latency to be worth it
+    static constexpr int64_t kMinWorkPerHandoff = 4;
+    // Hand-off latency assumed until it is measured, in ns
+    static constexpr int64_t kDefaultHandoffNs = 20000;
+
+    struct Plan
+    {
+        int num_workers; // 0 means the batch runs in the calling thread
+        int chunk_size;  // Tasks handed to a thread at once
+    };
+
+    /**
+     * @brief Plans a batch of num_tasks tasks, on up to num_threads executor threads
+     */
+    Plan plan(int num_tasks, int num_threads) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (num_tasks <= 1 || num_threads < 1)
+            return {0, num_tasks};
+        if (task_ns_ < 0) // Nothing measured yet, one task per thread hand-off
+            return {std::min(num_tasks, num_threads), 1};
+
+        int64_t handoff_ns = handoff_ns_ < 0 ? kDefaultHandoffNs : handoff_ns_;
+        int64_t total_ns = task_ns_ * num_tasks;
+        int64_t min_chunk_ns = kMinWorkPerHandoff * handoff_ns;
+        if (total_ns < 2 * min_chunk_ns)
+            return {0, num_tasks};
+
+        int num_workers = static_cast<int>(std::min<int64_t>({total_ns / min_chunk_ns, num_threads, num_tasks}));
+        int max_chunk = (num_tasks + num_workers - 1) / num_workers;
+        int64_t min_chunk = (min_chunk_ns + std::max<int64_t>(task_ns_, 1) - 1) / std::max<int64_t>(task_ns_, 1);
+        return {num_workers, static_cast<int>(std::clamp<int64_t>(min_chunk, 1, max_chunk))};
+    }
+
+    /**
+     * @brief Records that num_tasks tasks took busy_ns in total to execute
+     */
+    void recordTasks(int num_tasks, int64_t busy_ns)
+    {
+        if (num_tasks <= 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        update(task_ns_, busy_ns / num_tasks);
+    }
+
+    /**
+     * @brief Records the latency between launching work on the executor and a thread starting it
+     */
+    void recordHandoff(int64_t handoff_ns)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update(handoff_ns_, handoff_ns);
+    }
+
+    int64_t taskCost() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return task_ns_;
+    }
+
+    int64_t handoffCost() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return handoff_ns_;
+    }
+
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+  private:
+    // Exponential moving average, following changes of the content over a few batches
+    static void update(int64_t& avg, int64_t value)
+    {
+        avg = avg < 0 ? value : avg + (value - avg) / 4;
+    }
+
+    mutable std::mutex mutex_;
+    int64_t task_ns_ = -1;
+    int64_t handoff_ns_ = -1;
+};
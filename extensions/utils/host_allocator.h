@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include "nvimgcodec.h"
+
+// Host allocator of the execution parameters, or nullptr if the system allocator is to be used
+static const nvimgcodecHostAllocator_t* GetHostAllocator(const nvimgcodecExecutionParams_t* exec_params)
+{
+    if (!exec_params || exec_params->struct_size < offsetof(nvimgcodecExecutionParams_t, host_allocator) + sizeof(void*))
+        return nullptr;
+    auto* host_allocator = exec_params->host_allocator;
+    return host_allocator && host_allocator->host_malloc && host_allocator->host_free ? host_allocator : nullptr;
+}
+
+// Standard library allocator forwarding to the host allocator of the execution parameters, if there is one
+template <typename T>
+class HostAllocator
+{
+  public:
+    using value_type = T;
+    // Containers assigned from one another take the allocator along with the memory
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    HostAllocator(const nvimgcodecHostAllocator_t* host_allocator = nullptr) noexcept
+        : host_allocator_(host_allocator)
+    {
+    }
+
+    template <typename U>
+    HostAllocator(const HostAllocator<U>& other) noexcept
+        : host_allocator_(other.hostAllocator())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (!host_allocator_)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        void* ptr = nullptr;
+        if (host_allocator_->host_malloc(host_allocator_->host_ctx, &ptr, n * sizeof(T), alignof(T)) != 0 || (!ptr && n > 0))
+            throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if (!host_allocator_)
+            ::operator delete(ptr);
+        else
+            host_allocator_->host_free(host_allocator_->host_ctx, ptr, n * sizeof(T));
+    }
+
+    const nvimgcodecHostAllocator_t* hostAllocator() const noexcept { return host_allocator_; }
+
+    template <typename U>
+    bool operator==(const HostAllocator<U>& other) const noexcept
+    {
+        return host_allocator_ == other.hostAllocator();
+    }
+
+    template <typename U>
+    bool operator!=(const HostAllocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+  private:
+    const nvimgcodecHostAllocator_t* host_allocator_;
+};
@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Quality metrics of a lossy reconstruction against its source, for 8-bit interleaved images.
+// Inner loops run over contiguous bytes with fixed-width accumulators, so they are vectorized by the compiler.
+
+// Sum of squared differences of n bytes
+static uint64_t SumSquaredDiff(const uint8_t* a, const uint8_t* b, size_t n)
+{
+    // 255^2 * 65536 still fits in a 32-bit accumulator
+    constexpr size_t kChunk = 1 << 16;
+    uint64_t total = 0;
+    for (size_t start = 0; start < n; start += kChunk) {
+        size_t end = std::min(n, start + kChunk);
+        uint32_t sum = 0;
+        for (size_t i = start; i < end; i++) {
+            int32_t d = static_cast<int32_t>(a[i]) - static_cast<int32_t>(b[i]);
+            sum += static_cast<uint32_t>(d * d);
+        }
+        total += sum;
+    }
+    return total;
+}
+
+/**
+ * @brief Peak signal to noise ratio in dB, infinity if the images are identical
+ */
+static double ComputePsnr(const uint8_t* a, size_t a_stride, const uint8_t* b, size_t b_stride, int width, int height, int components)
+{
+    size_t row_size = static_cast<size_t>(width) * components;
+    uint64_t sse = 0;
+    for (int y = 0; y < height; y++)
+        sse += SumSquaredDiff(a + y * a_stride, b + y * b_stride, row_size);
+    if (sse == 0)
+        return std::numeric_limits<double>::infinity();
+    double mse = static_cast<double>(sse) / (static_cast<double>(row_size) * height);
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+// Converts a row to BT.601 luma, in fixed point
+static void RowToLuma(const uint8_t* src, uint8_t* dst, int width, int components)
+{
+    if (components == 1) {
+        std::copy(src, src + width, dst);
+        return;
+    }
+    for (int x = 0; x < width; x++) {
+        const uint8_t* px = src + x * components;
+        dst[x] = static_cast<uint8_t>((77 * px[0] + 150 * px[1] + 29 * px[2] + 128) >> 8);
+    }
+}
+
+/**
+ * @brief Structural similarity of the luma, averaged over 8x8 windows
+ *
+ * Windows do not overlap, which is a common fast approximation of the Gaussian-weighted SSIM.
+ */
+static double ComputeSsim(const uint8_t* a, size_t a_stride, const uint8_t* b, size_t b_stride, int width, int height, int components)
+{
+    constexpr int kWindow = 8;
+    constexpr double C1 = (0.01 * 255) * (0.01 * 255);
+    constexpr double C2 = (0.03 * 255) * (0.03 * 255);
+    std::vector<uint8_t> luma_a(static_cast<size_t>(width) * kWindow), luma_b(static_cast<size_t>(width) * kWindow);
+    std::vector<uint32_t> sum_a(width), sum_b(width), sum_aa(width), sum_bb(width), sum_ab(width);
+    double total = 0;
+    int64_t num_windows = 0;
+    for (int y0 = 0; y0 < height; y0 += kWindow) {
+        int rows = std::min(kWindow, height - y0);
+        for (int r = 0; r < rows; r++) {
+            RowToLuma(a + (y0 + r) * a_stride, &luma_a[r * width], width, components);
+            RowToLuma(b + (y0 + r) * b_stride, &luma_b[r * width], width, components);
+        }
+        // Column sums over the rows of the window band
+        std::fill(sum_a.begin(), sum_a.end(), 0);
+        std::fill(sum_b.begin(), sum_b.end(), 0);
+        std::fill(sum_aa.begin(), sum_aa.end(), 0);
+        std::fill(sum_bb.begin(), sum_bb.end(), 0);
+        std::fill(sum_ab.begin(), sum_ab.end(), 0);
+        for (int r = 0; r < rows; r++) {
+            const uint8_t* la = &luma_a[r * width];
+            const uint8_t* lb = &luma_b[r * width];
+            for (int x = 0; x < width; x++) {
+                uint32_t va = la[x], vb = lb[x];
+                sum_a[x] += va;
+                sum_b[x] += vb;
+                sum_aa[x] += va * va;
+                sum_bb[x] += vb * vb;
+                sum_ab[x] += va * vb;
+            }
+        }
+        for (int x0 = 0; x0 < width; x0 += kWindow) {
+            int cols = std::min(kWindow, width - x0);
+            uint64_t sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0;
+            for (int x = x0; x < x0 + cols; x++) {
+                sa += sum_a[x];
+                sb += sum_b[x];
+                saa += sum_aa[x];
+                sbb += sum_bb[x];
+                sab += sum_ab[x];
+            }
+            double n = static_cast<double>(rows) * cols;
+            double mu_a = sa / n, mu_b = sb / n;
+            double var_a = saa / n - mu_a * mu_a;
+            double var_b = sbb / n - mu_b * mu_b;
+            double cov = sab / n - mu_a * mu_b;
+            total += ((2 * mu_a * mu_b + C1) * (2 * cov + C2)) / ((mu_a * mu_a + mu_b * mu_b + C1) * (var_a + var_b + C2));
+            num_windows++;
+        }
+    }
+    return num_windows ? total / num_windows : 1.0;
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "nvimgcodec.h"
+
+// Per-channel statistics of decoded samples, accumulated by decoders while they write the output.
+// Each run of samples (a row, a tile row) is reduced with fixed-width accumulators, so contiguous runs are vectorized
+// by the compiler, and then merged into the running statistics with the parallel variance formula, which stays
+// accurate over large images.
+class ImageStatisticsAccumulator
+{
+  public:
+    /**
+     * @brief Returns the statistics requested for the output image, or nullptr
+     */
+    static nvimgcodecImageStatistics_t* Find(const nvimgcodecImageInfo_t& image_info)
+    {
+        auto* stats = static_cast<nvimgcodecImageStatistics_t*>(image_info.struct_next);
+        while (stats && stats->struct_type != NVIMGCODEC_STRUCTURE_TYPE_IMAGE_STATISTICS)
+            stats = static_cast<nvimgcodecImageStatistics_t*>(stats->struct_next);
+        return stats;
+    }
+
+    ImageStatisticsAccumulator(nvimgcodecImageStatistics_t* out, uint32_t num_channels)
+        : out_(out)
+        , num_channels_(std::min<uint32_t>(num_channels, NVIMGCODEC_MAX_NUM_PLANES))
+        , channels_(num_channels_)
+    {
+        out_->num_channels = 0;
+        size_t histogram_size = static_cast<size_t>(out_->histogram_bins) * num_channels_;
+        if (histogram_size > 0 && out_->histogram && out_->histogram_size >= histogram_size) {
+            bins_ = out_->histogram_bins;
+            histogram_ = out_->histogram;
+            std::fill(histogram_, histogram_ + histogram_size, 0);
+        }
+    }
+
+    /**
+     * @brief Accumulates num_pixels pixels of num_channels interleaved samples, which belong to output channels
+     * [first_channel, first_channel + num_channels)
+     */
+    template <typename T>
+    void add(const T* data, size_t num_pixels, uint32_t first_channel, uint32_t num_channels)
+    {
+        static_assert(sizeof(T) <= 2 || std::is_floating_point<T>::value, "Unsupported sample type");
+        if (num_pixels == 0)
+            return;
+        for (uint32_t c = 0; c < num_channels && first_channel + c < num_channels_; c++) {
+            addRun(channels_[first_channel + c], data + c, num_pixels, num_channels);
+            if (histogram_)
+                addHistogram(histogram_ + static_cast<size_t>(first_channel + c) * bins_, data + c, num_pixels, num_channels);
+        }
+    }
+
+    /**
+     * @brief Writes the statistics to the output structure, once the whole image was accumulated
+     */
+    void finish()
+    {
+        for (uint32_t c = 0; c < num_channels_; c++) {
+            const auto& ch = channels_[c];
+            if (ch.n > 0)
+                out_->channels[c] = {ch.min, ch.max, ch.mean, ch.m2 / ch.n};
+            else
+                out_->channels[c] = {0, 0, 0, 0};
+        }
+        out_->num_channels = num_channels_;
+    }
+
+  private:
+    struct Channel
+    {
+        double n = 0;
+        double mean = 0;
+        double m2 = 0; // Sum of squared deviations from the mean
+        double min = std::numeric_limits<double>::max();
+        double max = std::numeric_limits<double>::lowest();
+    };
+
+    template <typename T>
+    static void addRun(Channel& ch, const T* data, size_t n, uint32_t stride)
+    {
+        // Squares of 16-bit samples summed over a run fit in 64 bits
+        using Acc = std::conditional_t<std::is_floating_point<T>::value, double,
+            std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+        T lo = data[0], hi = data[0];
+        Acc sum = 0, sum_sq = 0;
+        if (stride == 1) {
+            for (size_t i = 0; i < n; i++) {
+                T v = data[i];
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+                sum += v;
+                sum_sq += static_cast<Acc>(v) * v;
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                T v = data[i * stride];
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+                sum += v;
+                sum_sq += static_cast<Acc>(v) * v;
+            }
+        }
+
+        double run_n = static_cast<double>(n);
+        double run_mean = static_cast<double>(sum) / run_n;
+        double run_m2 = std::max(0.0, static_cast<double>(sum_sq) - static_cast<double>(sum) * run_mean);
+        double total_n = ch.n + run_n;
+        double delta = run_mean - ch.mean;
+        ch.mean += delta * run_n / total_n;
+        ch.m2 += run_m2 + delta * delta * ch.n * run_n / total_n;
+        ch.n = total_n;
+        ch.min = std::min<double>(ch.min, lo);
+        ch.max = std::max<double>(ch.max, hi);
+    }
+
+    template <typename T>
+    void addHistogram(uint64_t* histogram, const T* data, size_t n, uint32_t stride) const
+    {
+        if constexpr (std::is_floating_point<T>::value) {
+            for (size_t i = 0; i < n; i++) {
+                T v = data[i * stride];
+                uint32_t bin = v > 0 ? static_cast<uint32_t>(std::min<double>(v * bins_, bins_ - 1)) : 0;
+                histogram[bin]++;
+            }
+        } else {
+            constexpr int kBits = 8 * sizeof(T);
+            constexpr int64_t kLowest = std::numeric_limits<T>::min();
+            for (size_t i = 0; i < n; i++) {
+                uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(data[i * stride]) - kLowest);
+                histogram[(offset * bins_) >> kBits]++;
+            }
+        }
+    }
+
+    nvimgcodecImageStatistics_t* out_;
+    uint32_t num_channels_;
+    std::vector<Channel> channels_;
+    uint32_t bins_ = 0;
+    uint64_t* histogram_ = nullptr;
+};
@@ -17,9 +17,28 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <future>
 #include "nvimgcodec.h"
+#include "adaptive_parallel.h"
+
+// Schedules the task for sample indices [0, num_tasks), with a single call if the executor supports batches
+static nvimgcodecStatus_t LaunchBatch(nvimgcodecExecutorDesc_t* executor, int device_id, int num_tasks, void* task_ctx,
+    void (*task)(int thread_id, int sample_idx, void* task_context))
+{
+    if (executor->struct_size >= offsetof(nvimgcodecExecutorDesc_t, launchBatch) + sizeof(void*) && executor->launchBatch)
+        return executor->launchBatch(executor->instance, device_id, num_tasks, task_ctx, task);
+    for (int i = 0; i < num_tasks; i++) {
+        auto status = executor->launch(executor->instance, device_id, i, task_ctx, task);
+        if (status != NVIMGCODEC_STATUS_SUCCESS)
+            return status;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
 
 
 struct BlockParallelCtx {
@@ -28,44 +47,119 @@ struct BlockParallelCtx {
     int num_tasks;
     int num_blocks;
     std::vector<std::promise<void>> promise;
+    int64_t launch_ns = 0;
+    std::atomic<int64_t> busy_ns{0};
+    std::atomic<int64_t> handoff_ns{std::numeric_limits<int64_t>::max()};
 };
 
+// Keeps the lowest latency between launching work and a thread starting it
+static void RecordHandoff(std::atomic<int64_t>& min_handoff_ns, int64_t handoff_ns)
+{
+    int64_t current = min_handoff_ns.load();
+    while (handoff_ns < current && !min_handoff_ns.compare_exchange_weak(current, handoff_ns)) {
+    }
+}
+
+// Runs the tasks split in blocks, one per worker plus one in the current thread, and waits for them.
+// If a policy is given, it decides how many workers are worth using, and is updated with the measured costs.
 static void BlockParallelExec(void* task_ctx, void (*task)(int thread_id, int sample_idx, void* task_context), int num_tasks,
-    const nvimgcodecExecutionParams_t* exec_params)
+    const nvimgcodecExecutionParams_t* exec_params, AdaptiveParallelPolicy* policy = nullptr)
 {
     auto executor = exec_params->executor;
     int num_threads = executor->getNumThreads(executor->instance);
 
-    if (num_tasks < (num_threads + 1) || num_threads < 2) {  // not worth parallelizing
+    int num_workers = 0;
+    if (policy)
+        num_workers = policy->plan(num_tasks, num_threads).num_workers;
+    else if (num_tasks >= num_threads + 1 && num_threads >= 2)
+        num_workers = num_threads;
+
+    if (num_workers == 0 || num_tasks < 2) {  // not worth parallelizing
+        int64_t start_ns = AdaptiveParallelPolicy::Now();
         for (int i = 0; i < num_tasks; i++)
             task(-1, i, task_ctx);
+        if (policy)
+            policy->recordTasks(num_tasks, AdaptiveParallelPolicy::Now() - start_ns);
     } else {
         // Divide `num_tasks` tasks into `num_blocks` blocks
-        int num_blocks = num_threads + 1; // the last block is processed in the current thread
+        num_workers = std::min(num_workers, num_tasks - 1);
+        int num_blocks = num_workers + 1; // the last block is processed in the current thread
         BlockParallelCtx block_ctx{task, task_ctx, num_tasks, num_blocks};
-        block_ctx.promise.resize(num_threads);
+        block_ctx.promise.resize(num_workers);
         std::vector<std::future<void>> fut;
-        fut.reserve(num_threads);
+        fut.reserve(num_workers);
         for (auto& pr : block_ctx.promise)
             fut.push_back(pr.get_future());
 
         auto block_task = [](int tid, int block_idx, void* context) -> void {
             auto* block_ctx = reinterpret_cast<BlockParallelCtx*>(context);
+            int64_t start_ns = AdaptiveParallelPolicy::Now();
+            if (tid != -1)
+                RecordHandoff(block_ctx->handoff_ns, start_ns - block_ctx->launch_ns);
             int64_t i_start = block_ctx->num_tasks * block_idx / block_ctx->num_blocks;
             int64_t i_end = block_ctx->num_tasks * (block_idx + 1) / block_ctx->num_blocks;
             for (int i = i_start; i < i_end; i++)
                 block_ctx->task(tid, i, block_ctx->task_ctx);
+            block_ctx->busy_ns += AdaptiveParallelPolicy::Now() - start_ns;
             if (block_idx < static_cast<int>(block_ctx->promise.size()))
                 block_ctx->promise[block_idx].set_value();
         };
-        int block_idx = 0;
-        for (; block_idx < num_threads; ++block_idx) {
-            executor->launch(executor->instance, exec_params->device_id, block_idx, &block_ctx, block_task);
-        }
-        block_task(-1, block_idx, &block_ctx);
+        block_ctx.launch_ns = AdaptiveParallelPolicy::Now();
+        LaunchBatch(executor, exec_params->device_id, num_workers, &block_ctx, block_task);
+        block_task(-1, num_workers, &block_ctx);
 
         // wait for it to finish
         for (auto& f : fut)
             f.wait();
+        if (policy) {
+            policy->recordTasks(num_tasks, block_ctx.busy_ns);
+            policy->recordHandoff(block_ctx.handoff_ns);
+        }
     }
 }
+
+struct AdaptiveBatchCtx {
+    void (*task)(int thread_id, int sample_idx, void* task_context);
+    void* task_ctx;
+    int num_tasks;
+    int chunk_size;
+    std::shared_ptr<AdaptiveParallelPolicy> policy;
+    int64_t launch_ns;
+    std::atomic<int> remaining_chunks;
+    std::atomic<int64_t> busy_ns{0};
+    std::atomic<int64_t> handoff_ns{std::numeric_limits<int64_t>::max()};
+};
+
+// Schedules the task for sample indices [0, num_tasks) as planned by the policy: in the current thread, with thread id -1,
+// if handing the batch off costs more than running it, or in chunks of samples otherwise. Doesn't wait for the tasks.
+// The costs are recorded in the policy when the last chunk finishes, so it is shared with the chunks.
+static nvimgcodecStatus_t AdaptiveLaunchBatch(nvimgcodecExecutorDesc_t* executor, int device_id, int num_tasks, void* task_ctx,
+    void (*task)(int thread_id, int sample_idx, void* task_context), const std::shared_ptr<AdaptiveParallelPolicy>& policy)
+{
+    auto plan = policy->plan(num_tasks, executor->getNumThreads(executor->instance));
+    if (plan.num_workers == 0) {
+        int64_t start_ns = AdaptiveParallelPolicy::Now();
+        for (int i = 0; i < num_tasks; i++)
+            task(-1, i, task_ctx);
+        policy->recordTasks(num_tasks, AdaptiveParallelPolicy::Now() - start_ns);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    int num_chunks = (num_tasks + plan.chunk_size - 1) / plan.chunk_size;
+    auto* batch_ctx = new AdaptiveBatchCtx{task, task_ctx, num_tasks, plan.chunk_size, policy, AdaptiveParallelPolicy::Now(), {num_chunks}};
+    auto chunk_task = [](int tid, int chunk_idx, void* context) -> void {
+        auto* batch_ctx = reinterpret_cast<AdaptiveBatchCtx*>(context);
+        int64_t start_ns = AdaptiveParallelPolicy::Now();
+        RecordHandoff(batch_ctx->handoff_ns, start_ns - batch_ctx->launch_ns);
+        int i_end = std::min(batch_ctx->num_tasks, (chunk_idx + 1) * batch_ctx->chunk_size);
+        for (int i = chunk_idx * batch_ctx->chunk_size; i < i_end; i++)
+            batch_ctx->task(tid, i, batch_ctx->task_ctx);
+        batch_ctx->busy_ns += AdaptiveParallelPolicy::Now() - start_ns;
+        if (--batch_ctx->remaining_chunks == 0) {
+            batch_ctx->policy->recordTasks(batch_ctx->num_tasks, batch_ctx->busy_ns);
+            batch_ctx->policy->recordHandoff(batch_ctx->handoff_ns);
+            delete batch_ctx;
+        }
+    };
+    return LaunchBatch(executor, device_id, num_chunks, batch_ctx, chunk_task);
+}
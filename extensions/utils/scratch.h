@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "nvimgcodec.h"
+#include "host_allocator.h"
+
+// Scratch memory of a task, taken from the framework arena of the calling thread, and released when the scope ends.
+// With a framework which doesn't provide arenas, allocations go to the heap. If the execution parameters of the codec
+// come with a host allocator, allocations go to it instead of the arena, so that the application can account for all
+// of them, and are returned when the scope ends. Scopes must not be nested in one thread, since ending one releases
+// all the scratch memory of the thread.
+//
+// Longer lived host buffers of the extensions, e.g. local copies of code streams or compressed chunks, use HostAllocator
+// instead. Neither covers:
+// - memory allocated inside the codec libraries (libjpeg-turbo, libwebp, libtiff, OpenJPEG, zstd, LZ4, nvJPEG), which
+//   use their own allocators, nor the encoded candidates of the JPEG rate control, which libjpeg-turbo writes,
+// - images of the OpenCV decoder, which are cv::Mat allocated by OpenCV,
+// - allocations of the core library, e.g. code stream parsers, which run before any execution parameters are known.
+class ScratchScope
+{
+  public:
+    explicit ScratchScope(const nvimgcodecFrameworkDesc_t* framework, const nvimgcodecHostAllocator_t* host_allocator = nullptr)
+        : framework_(framework)
+        , host_allocator_(host_allocator)
+        , has_arena_(!host_allocator && framework->struct_size >= offsetof(nvimgcodecFrameworkDesc_t, scratchReset) + sizeof(void*) &&
+                     framework->scratchAlloc && framework->scratchReset)
+    {
+    }
+
+    ~ScratchScope()
+    {
+        if (has_arena_)
+            framework_->scratchReset(framework_->instance);
+        for (auto& [ptr, size] : host_allocations_)
+            host_allocator_->host_free(host_allocator_->host_ctx, ptr, size);
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    /**
+     * @brief Allocates size bytes, aligned at most to std::max_align_t. Throws std::runtime_error on failure.
+     */
+    void* allocateBytes(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        void* ptr = nullptr;
+        if (has_arena_) {
+            ptr = framework_->scratchAlloc(framework_->instance, size, alignment);
+        } else if (host_allocator_) {
+            if (host_allocator_->host_malloc(host_allocator_->host_ctx, &ptr, size, alignment) != 0)
+                ptr = nullptr;
+            if (ptr)
+                host_allocations_.emplace_back(ptr, size);
+        } else {
+            heap_.emplace_back(new (std::nothrow) std::max_align_t[(size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+            ptr = heap_.back().get();
+        }
+        if (!ptr && size > 0)
+            throw std::runtime_error("Could not allocate scratch memory");
+        return ptr;
+    }
+
+    /**
+     * @brief Allocates count elements, uninitialized. Throws std::runtime_error on failure.
+     */
+    template <typename T = uint8_t>
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+  private:
+    const nvimgcodecFrameworkDesc_t* framework_;
+    const nvimgcodecHostAllocator_t* host_allocator_;
+    bool has_arena_;
+    std::vector<std::unique_ptr<std::max_align_t[]>> heap_;
+    std::vector<std::pair<void*, size_t>> host_allocations_;
+};
@@ -24,6 +24,7 @@
 #include <vector>
 #include <future>
 #include "nvimgcodec.h"
+#include "host_allocator.h"
 #include <iostream>
 
 struct CodeStreamCtx;
@@ -43,6 +44,11 @@ struct BatchItemCtx {
  * @brief Context for a single encoded stream
  */
 struct CodeStreamCtx {
+    explicit CodeStreamCtx(const nvimgcodecHostAllocator_t* host_allocator = nullptr)
+        : buffer_(HostAllocator<unsigned char>(host_allocator))
+    {
+    }
+
     // Code stream pointer;
     nvimgcodecCodeStreamDesc_t* code_stream_;
     // Unique stream id
@@ -56,7 +62,7 @@ struct CodeStreamCtx {
     size_t encoded_stream_data_size_ = 0;
 
     // Local copy of the stream, in case map is not supported
-    std::vector<unsigned char> buffer_;
+    std::vector<unsigned char, HostAllocator<unsigned char>> buffer_;
 
     size_t size() const {
         return batch_items_.size();
@@ -116,9 +122,15 @@ struct CodeStreamCtx {
 struct CodeStreamCtxManager {
     using CodeStreamCtxPtr = std::shared_ptr<CodeStreamCtx>;
 
+    // Local copies of code streams are allocated with the host allocator, if given
+    explicit CodeStreamCtxManager(const nvimgcodecHostAllocator_t* host_allocator = nullptr)
+        : host_allocator_(host_allocator)
+    {
+    }
+
     CodeStreamCtxPtr acquireCtx() {
         if (free_ctx_.empty())
-            return std::make_shared<CodeStreamCtx>();
+            return std::make_shared<CodeStreamCtx>(host_allocator_);
 
         auto ret = std::move(free_ctx_.back());
         free_ctx_.pop_back();
@@ -196,6 +208,7 @@ struct CodeStreamCtxManager {
     }
 
   private:
+    const nvimgcodecHostAllocator_t* host_allocator_;
     std::map<uint64_t, CodeStreamCtxPtr> stream_ctx_;
     std::vector<CodeStreamCtxPtr> free_ctx_;
     std::vector<CodeStreamCtxPtr> stream_ctx_view_;
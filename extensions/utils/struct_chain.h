@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "nvimgcodec.h"
+
+/**
+ * @brief Returns the first structure of the given type in the struct_next chain, or nullptr
+ */
+template <typename T>
+const T* FindStruct(const void* struct_next, nvimgcodecStructureType_t struct_type)
+{
+    auto* ptr = static_cast<const T*>(struct_next);
+    while (ptr && ptr->struct_type != struct_type)
+        ptr = static_cast<const T*>(ptr->struct_next);
+    return ptr;
+}
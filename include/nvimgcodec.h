@@ -76,6 +76,16 @@ extern "C"
  */
 #define NVIMGCODEC_JPEG2K_MAXRES 33
 
+/**
+ * @brief Maximum number of TIFF pyramid levels.
+ */
+#define NVIMGCODEC_TIFF_MAX_LEVELS 32
+
+/**
+ * @brief Defines TIFF pyramid level selection based on the requested output size.
+ */
+#define NVIMGCODEC_TIFF_LEVEL_AUTO -1
+
     /**
      * @brief Opaque nvImageCodec library instance type.
      */
@@ -136,6 +146,16 @@ extern "C"
      */
     typedef struct nvimgcodecDecoder* nvimgcodecDecoder_t;
 
+    /**
+     * @brief Opaque Transformer type.
+     */
+    struct nvimgcodecTransformer;
+
+    /**
+     * @brief Handle to opaque Transformer type.
+     */
+    typedef struct nvimgcodecTransformer* nvimgcodecTransformer_t;
+
     /**
      * @brief Opaque Debug Messenger type.
      */
@@ -201,6 +221,28 @@ extern "C"
         NVIMGCODEC_STRUCTURE_TYPE_EXECUTOR_DESC,
         NVIMGCODEC_STRUCTURE_TYPE_BACKEND_PARAMS,
         NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO,
+        NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT,
+        NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT,
+        NVIMGCODEC_STRUCTURE_TYPE_TIFF_ENCODE_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_TRANSFORM_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_TRANSFORMER_DESC,
+        NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_JPEG_QUANTIZATION_INFO,
+        NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_WEBP_ENCODE_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_NVTENSOR_ENCODE_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE,
+        NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_IMAGE_STATISTICS,
+        NVIMGCODEC_STRUCTURE_TYPE_CODE_STREAM_VALIDATION,
+        NVIMGCODEC_STRUCTURE_TYPE_CORRUPTED_STREAM_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_STATS,
+        NVIMGCODEC_STRUCTURE_TYPE_SCRATCH_ARENA_PARAMS,
+        NVIMGCODEC_STRUCTURE_TYPE_SCRATCH_ARENA_STATS,
+        NVIMGCODEC_STRUCTURE_TYPE_HOST_ALLOCATOR,
         NVIMGCODEC_STRUCTURE_TYPE_ENUM_FORCE_INT = INT32_MAX
     } nvimgcodecStructureType_t;
 
@@ -267,6 +309,28 @@ extern "C"
      */
     typedef int (*nvimgcodecPinnedFree_t)(void* ctx, void* ptr, size_t size, cudaStream_t stream);
 
+    /** 
+     * @brief Function type for regular host memory allocation.
+     *
+     * @param [in] ctx Pointer to user context.
+     * @param [in] ptr Pointer where to write pointer to allocated memory.
+     * @param [in] size How many bytes to allocate.
+     * @param [in] alignment Required alignment of the memory, a power of two.
+     * @returns They will return 0 in case of success, and non-zero otherwise
+     */
+    typedef int (*nvimgcodecHostMalloc_t)(void* ctx, void** ptr, size_t size, size_t alignment);
+
+    /** 
+     * @brief Function type for regular host memory deallocation.
+     *
+     * @param [in] ctx Pointer to user context.
+     * @param [in] ptr Pointer to memory buffer to be deallocated.
+     *                 If NULL, the operation must do nothing, successfully.
+     * @param [in] size How many bytes was allocated (size passed during allocation).
+     * @returns They will return 0 in case of success, and non-zero otherwise
+     */
+    typedef int (*nvimgcodecHostFree_t)(void* ctx, void* ptr, size_t size);
+
     /**
      * @brief Device memory allocator.
      */
@@ -302,6 +366,25 @@ extern "C"
                                                     would be padded to the multiple of specified number of bytes */
     } nvimgcodecPinnedAllocator_t;
 
+    /** 
+     * @brief Regular (pageable) host memory allocator.
+     *
+     * Used for temporary host buffers of the library and of the extensions which support it, e.g. local copies of code
+     * streams which can't be mapped, intermediate images and decoding scratch memory. Memory allocated internally by
+     * the third-party codec libraries, and by the code stream parsers, still goes through their own allocators.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        nvimgcodecHostMalloc_t host_malloc; /**< Allocate host memory. */
+        nvimgcodecHostFree_t host_free;     /**< Frees host memory. */
+        void* host_ctx;                     /**< When invoking the allocators, this context will
+                                                be pass as input to allocator functions.*/
+    } nvimgcodecHostAllocator_t;
+
     /** 
      * @brief The return status codes of the nvImageCodec API
      */
@@ -538,6 +621,27 @@ extern "C"
         nvimgcodecJpegEncoding_t encoding; /**< JPEG encoding type. */
     } nvimgcodecJpegImageInfo_t;
 
+    /** 
+     * @brief Defines quantization of a JPEG code stream.
+     * 
+     * This structure extends information provided in nvimgcodecImageInfo_t
+    */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        int num_tables;                  /**< Number of quantization tables defined before the first scan of each component. */
+        uint16_t tables[4][64];          /**< Quantization tables in natural (row-major) order, indexed by table id. */
+        int component_tables[4];         /**< Quantization table id used by each component. */
+        /**
+         * Quality, on the 1 to 100 scale of the IJG reference tables, which reproduces the tables the closest.
+         * 0 if the code stream has no quantization tables, e.g. when it is lossless.
+         */
+        int estimated_quality;
+    } nvimgcodecJpegQuantizationInfo_t;
+
     /**
      * @brief Defines image information related to JPEG2000 format.
      *
@@ -555,6 +659,71 @@ extern "C"
         uint32_t tile_width;                   /**< Width of the tile. */
     } nvimgcodecJpeg2kImageInfo_t;
 
+    /**
+     * @brief Defines a single resolution level of a pyramidal TIFF.
+     */
+    typedef struct
+    {
+        uint32_t width;       /**< Width of the level. */
+        uint32_t height;      /**< Height of the level. */
+        uint32_t tile_width;  /**< Width of the tile. Equals width for stripped levels. */
+        uint32_t tile_height; /**< Height of the tile. Equals rows per strip for stripped levels. */
+        uint64_t ifd_offset;  /**< Offset of the image file directory of the level in the code stream. */
+    } nvimgcodecTiffLevelInfo_t;
+
+    /**
+     * @brief Defines image information related to TIFF format.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t.
+     * Levels are reduced-resolution images stored either as SubIFDs of the first page or as successive pages.
+     * Level 0 is always the full-resolution image and the remaining levels are sorted by decreasing size.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        uint32_t num_levels;                                          /**< Number of pyramid levels. */
+        nvimgcodecTiffLevelInfo_t levels[NVIMGCODEC_TIFF_MAX_LEVELS]; /**< Array with information about pyramid levels. */
+    } nvimgcodecTiffImageInfo_t;
+
+    /**
+     * @brief Defines the ICC profile embedded in a code stream.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t.
+     * Profiles are read from JPEG APP2 markers, PNG iCCP chunks (when the library is built with zlib) and TIFF tag 34675.
+     * The profile is copied only when the buffer is large enough, so it can be queried with buffer set to NULL first.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        unsigned char* buffer; /**< Is NULL or a buffer receiving the profile. */
+        size_t buffer_size;    /**< Size of the buffer, in bytes. */
+        size_t profile_size;   /**< Size of the embedded profile, in bytes. 0 if the code stream has none. */
+    } nvimgcodecIccProfile_t;
+
+    /**
+     * @brief Result of the structural validation of a code stream.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t. When present, parsers which support it walk
+     * the whole code stream and check that its structure is consistent: JPEG marker segment lengths and the entropy-coded
+     * data up to the EOI marker, PNG chunk lengths and CRCs up to the IEND chunk, TIFF IFD, strip and tile bounds.
+     * The pixel data itself is not decoded. The result is reported even when the rest of the image info can't be read.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        int checked;   /**< [out] 1 if the parser validated the code stream, 0 if it does not support validation. */
+        int corrupted; /**< [out] 1 if the code stream is truncated or its structure is inconsistent, 0 otherwise. */
+    } nvimgcodecCodeStreamValidation_t;
+
     /**
      * @brief Defines decoding/encoding backend kind.
      */
@@ -625,6 +794,8 @@ extern "C"
         NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED = 0x81, /**< Selected unsupported sample format. */
         NVIMGCODEC_PROCESSING_STATUS_NUM_PLANES_UNSUPPORTED = 0x101,   /**< Unsupported number of planes to decode/encode. */
         NVIMGCODEC_PROCESSING_STATUS_NUM_CHANNELS_UNSUPPORTED = 0x201, /**< Unsupported number of channels to decode/encode. */
+        NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED = 0x401,  /**< Decoding to successive row bands is unsupported. */
+        NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED = 0x801,   /**< Encoding from successive row bands is unsupported. */
 
         NVIMGCODEC_PROCESSING_STATUS_ENUM_FORCE_INT = INT32_MAX
     } nvimgcodecProcessingStatus;
@@ -634,6 +805,109 @@ extern "C"
     */
     typedef uint32_t nvimgcodecProcessingStatus_t;
 
+    /**
+     * @brief Function type to receive a decoded row band.
+     *
+     * @param [in] ctx Pointer to user context.
+     * @param [in] band_info Image information describing the band. Plane heights are set to the number of rows in the band.
+     * @param [in] first_row Index of the first row of the band, relative to the decoded region.
+     * @param [in] num_rows Number of rows in the band.
+     * @return nvimgcodecStatus_t - Any other value than NVIMGCODEC_STATUS_SUCCESS stops decoding of the image.
+     */
+    typedef nvimgcodecStatus_t (*nvimgcodecBandReadyFunc_t)(
+        void* ctx, const nvimgcodecImageInfo_t* band_info, uint32_t first_row, uint32_t num_rows);
+
+    /**
+     * @brief Defines decoding to successive row bands.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t of the output image. Image information
+     * still describes the whole decoded image, but the buffer holds only band_height rows and is reused for each band,
+     * so peak memory is bounded by the band size. Planes of planar formats are band_height rows apart.
+     * Only host buffers are supported and decoders which cannot produce bands incrementally
+     * report NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        uint32_t band_height;                 /**< Number of rows which fit in the image buffer. */
+        nvimgcodecBandReadyFunc_t band_ready; /**< Called, from a decoder thread, each time a band is complete. */
+        void* band_ctx;                       /**< Band ready function context. */
+    } nvimgcodecBandOutput_t;
+
+    /**
+     * @brief Function type to provide a row band to be encoded.
+     *
+     * @param [in] ctx Pointer to user context.
+     * @param [in] band_info Image information describing the band to fill. Plane heights are set to the number of rows in the band.
+     * @param [in] first_row Index of the first row of the band.
+     * @param [in] num_rows Number of rows in the band.
+     * @return nvimgcodecStatus_t - Any other value than NVIMGCODEC_STATUS_SUCCESS stops encoding of the image.
+     */
+    typedef nvimgcodecStatus_t (*nvimgcodecBandRequestFunc_t)(
+        void* ctx, const nvimgcodecImageInfo_t* band_info, uint32_t first_row, uint32_t num_rows);
+
+    /**
+     * @brief Defines encoding from successive row bands.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t of the input image. Image information
+     * still describes the whole image, but the buffer holds only band_height rows. Encoder requests bands
+     * top to bottom, fills the buffer through band_request and writes compressed data to the output stream
+     * as bands arrive, so peak memory is bounded by the band size. Planes of planar formats are band_height rows apart.
+     * Only host buffers are supported and encoders which cannot consume bands incrementally
+     * report NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        uint32_t band_height;                     /**< Number of rows which fit in the image buffer. */
+        nvimgcodecBandRequestFunc_t band_request; /**< Called, from an encoder thread, each time a band is needed. */
+        void* band_ctx;                           /**< Band request function context. */
+    } nvimgcodecBandInput_t;
+
+    /**
+     * @brief Statistics of a single channel of the decoded image.
+     */
+    typedef struct
+    {
+        double min;      /**< Smallest sample value. */
+        double max;      /**< Largest sample value. */
+        double mean;     /**< Mean of sample values. */
+        double variance; /**< Population variance of sample values. */
+    } nvimgcodecChannelStatistics_t;
+
+    /**
+     * @brief Defines per-channel statistics to compute while decoding.
+     *
+     * This structure extends information provided in nvimgcodecImageInfo_t of the output image. CPU decoders
+     * accumulate the statistics while writing decoded samples to the output, tile by tile or band by band,
+     * so they come without another pass over the image. Statistics cover the decoded region and follow the channel
+     * order of the output image, planes being channels for planar formats.
+     * nvimgcodecDecoderDecode resets num_channels to 0, and decoders which do not compute statistics leave it so.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        /**
+         * Number of histogram bins per channel, or 0 to skip histograms. Bins split the range of the sample type
+         * uniformly, and [0, 1] for floating point samples.
+         */
+        uint32_t histogram_bins;
+        uint64_t* histogram;   /**< Is NULL or points to histogram_bins counters per channel, stored channel after channel. */
+        size_t histogram_size; /**< Number of counters the histogram can hold. Histograms are skipped if it is too small. */
+
+        uint32_t num_channels; /**< [out] Number of channels with statistics, 0 if the decoder did not compute them. */
+        nvimgcodecChannelStatistics_t channels[NVIMGCODEC_MAX_NUM_PLANES]; /**< [out] Statistics of each channel. */
+    } nvimgcodecImageStatistics_t;
+
     /**
      * @brief Decode parameters
      */
@@ -648,6 +922,103 @@ extern "C"
 
     } nvimgcodecDecodeParams_t;
 
+    /**
+     * @brief Color management parameters
+     *
+     * This structure extends nvimgcodecDecodeParams_t. When present, decoded RGB images of code streams with an embedded
+     * ICC profile are converted from that profile to the target profile. Only matrix/TRC profiles are supported.
+     * The transform between a pair of profiles is sampled once into a 3D lookup table, which is cached by the decoder
+     * and applied with tetrahedral interpolation to 8 and 16-bit host outputs, one executor task per image. Images decoded
+     * to device memory, to row bands, or whose profile is unsupported are left unchanged.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        const unsigned char* target_profile; /**< Is NULL for sRGB or an RGB matrix/TRC ICC profile to convert to. */
+        size_t target_profile_size;          /**< Size of the target profile, in bytes. */
+        int lut_size;                        /**< Number of lookup table points per dimension, 2 to 65. 0 means 33. */
+    } nvimgcodecColorManagementParams_t;
+
+    /**
+     * @brief Corrupted code stream handling parameters
+     *
+     * This structure extends nvimgcodecDecodeParams_t. By default, a sample which fails to decode is retried with every
+     * fallback decoder. These options let truncated or corrupted code streams fail early instead, with
+     * NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        int validate;      /**< Validate code streams before decoding, see nvimgcodecCodeStreamValidation_t. Valid values 0 or 1. */
+        int stop_fallback; /**< Don't retry samples reported as corrupted by a decoder with the fallback decoders. Valid values 0 or 1. */
+        /**
+         * Remember the contents of code streams found corrupted, by size and two independent 64-bit hashes, and fail them
+         * without decoding in later calls of the same decoder instance. Valid values 0 or 1.
+         */
+        int remember_corrupted;
+    } nvimgcodecCorruptedStreamParams_t;
+
+    /**
+     * @brief Duplicate code stream handling parameters
+     *
+     * This structure extends nvimgcodecDecodeParams_t. When enabled, the contents of all code streams of a batch are
+     * hashed before decoding, and samples with the same contents as an earlier sample of the batch are not decoded.
+     * Contents with the same hash are compared byte by byte before a sample is taken for a duplicate.
+     * Once the earlier sample is decoded, its output is copied to theirs, and they get the same processing status.
+     * Only samples whose output images have the same layout, buffer kind and size, and no extension structures, are
+     * deduplicated.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        int enable; /**< Decode samples with the same contents once. Valid values 0 or 1. */
+    } nvimgcodecDeduplicationParams_t;
+
+    /**
+     * @brief Deduplication counters of a decoder
+     *
+     * Counts cover all decode calls of the decoder with deduplication enabled.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        uint64_t num_samples;    /**< [out] Number of samples submitted for decoding. */
+        uint64_t num_duplicates; /**< [out] Number of samples whose output was copied from another sample instead of decoded. */
+    } nvimgcodecDeduplicationStats_t;
+
+    /**
+     * @brief TIFF decode parameters
+     *
+     * This structure extends nvimgcodecDecodeParams_t. Output image and region of interest are expressed
+     * in coordinates of the selected level.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        /**
+         * Pyramid level to decode, as reported in nvimgcodecTiffImageInfo_t.
+         * With NVIMGCODEC_TIFF_LEVEL_AUTO, the smallest level which is not smaller than the requested size is selected.
+         */
+        int level;
+        uint32_t target_width;  /**< Requested width for automatic level selection. 0 means output image width. */
+        uint32_t target_height; /**< Requested height for automatic level selection. 0 means output image height. */
+    } nvimgcodecTiffDecodeParams_t;
+
     /**
      * @brief Encode parameters
      */
@@ -674,6 +1045,32 @@ extern "C"
         float target_psnr;
     } nvimgcodecEncodeParams_t;
 
+    /**
+     * @brief Rate control parameters
+     *
+     * This structure extends nvimgcodecEncodeParams_t. When it is present, the encoder searches for the quality to
+     * encode with instead of using nvimgcodecEncodeParams_t::quality. Qualities which reach target_psnr and target_ssim
+     * are found first, then the highest of them which fits target_size is chosen. If even the lowest quality does not
+     * fit target_size, the image is encoded with the lowest quality.
+     *
+     * @note It is supported by CPU encoders of lossy codecs only.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        size_t target_size; /**< Largest code stream size, in bytes. 0 means no size target. */
+        float target_psnr;  /**< Lowest PSNR, in dB, of the decoded image against the input. 0 means no PSNR target. */
+        float target_ssim;  /**< Lowest SSIM, in the range (0, 1], of the decoded image luma against the input. 0 means no SSIM target. */
+        /**
+         * Number of qualities encoded concurrently in each search step. The search range shrinks by a factor of
+         * num_candidates + 1 per step. 0 or 1 means bisection.
+         */
+        int num_candidates;
+    } nvimgcodecRateControlParams_t;
+
     /**
      * @brief Progression orders defined in the JPEG2000 standard.
      */
@@ -731,6 +1128,176 @@ extern "C"
         int optimized_huffman;
     } nvimgcodecJpegEncodeParams_t;
 
+    /**
+     * @brief TIFF compression schemes supported for encoding.
+     */
+    typedef enum
+    {
+        NVIMGCODEC_TIFF_COMPRESSION_NONE = 0,    /**< Tiles are stored uncompressed. */
+        NVIMGCODEC_TIFF_COMPRESSION_DEFLATE = 1, /**< Tiles are compressed with Deflate. */
+        NVIMGCODEC_TIFF_COMPRESSION_ENUM_FORCE_INT = INT32_MAX
+    } nvimgcodecTiffCompression_t;
+
+    /**
+     * @brief TIFF encode parameters
+     *
+     * This structure extends nvimgcodecEncodeParams_t. Image is written as a tiled TIFF, followed by reduced
+     * resolution levels, each downsampled 2x2 from the previous one and stored as a successive page marked
+     * as a reduced resolution image. All levels are generated in a single pass over the input rows.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        /**
+         * Compression of tiles. Without this structure, tiles are compressed with Deflate if the encoder supports it,
+         * and stored uncompressed otherwise.
+         */
+        nvimgcodecTiffCompression_t compression;
+        uint32_t tile_width;                     /**< Tile width. Must be a multiple of 16. 0 means 256. */
+        uint32_t tile_height;                    /**< Tile height. Must be a multiple of 16. 0 means 256. */
+        /**
+         * Number of levels, including the full resolution one, up to NVIMGCODEC_TIFF_MAX_LEVELS.
+         * 0 means that levels are added until the smallest one fits in a single tile.
+         */
+        uint32_t num_levels;
+    } nvimgcodecTiffEncodeParams_t;
+
+    /**
+     * @brief WebP encode parameters
+     *
+     * This structure extends nvimgcodecEncodeParams_t. For lossy encoding nvimgcodecEncodeParams_t::quality is
+     * the quality factor in range 0-100. For lossless encoding it is the compression effort in the same range,
+     * where higher values give smaller code streams at the cost of speed. Without this structure, images are
+     * encoded lossy with method 4.
+     *
+     * @note When nvimgcodecRateControlParams_t is also present, its target_size and target_psnr are passed to
+     *       the multi-pass search of libwebp, target_ssim is not supported. libwebp gets close to target_size, within
+     *       a few percent, but may exceed it, and measures the PSNR in YUV rather than against the input image.
+     *       target_size takes precedence over target_psnr.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        int lossless; /**< Sets whether or not to use lossless encoding. Valid values 0 or 1. */
+        int method;   /**< Quality and speed trade-off, from 0 (fastest) to 6 (slowest, smallest). */
+    } nvimgcodecWebpEncodeParams_t;
+
+    /**
+     * @brief Compression of the chunks of an nvtensor code stream.
+     */
+    typedef enum
+    {
+        NVIMGCODEC_NVTENSOR_COMPRESSION_NONE = 0, /**< Samples are stored as they are, so the payload can be mapped in place. */
+        NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD = 1, /**< Chunks are compressed with Zstandard. */
+        NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4 = 2,  /**< Chunks are compressed with LZ4, if the extension was built with it. */
+        NVIMGCODEC_NVTENSOR_COMPRESSION_ENUM_FORCE_INT = INT32_MAX
+    } nvimgcodecNvTensorCompression_t;
+
+    /**
+     * @brief nvtensor encode parameters
+     *
+     * This structure extends nvimgcodecEncodeParams_t. nvtensor is a lossless container of decoded samples meant for
+     * caching: a small header with the image info is followed by the samples of all planes, tightly packed and split
+     * into independently compressed chunks, which are encoded and decoded in parallel. Without this structure, chunks
+     * of 1 MiB are compressed with Zstandard level 1.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        nvimgcodecNvTensorCompression_t compression; /**< Compression of the chunks. */
+        int level;                                   /**< Zstandard compression level, 0 means the library default. Ignored for LZ4. */
+        size_t chunk_size;                           /**< Uncompressed size of a chunk, in bytes. 0 means 1 MiB. */
+    } nvimgcodecNvTensorEncodeParams_t;
+
+    /**
+     * @brief Lossless geometric operations applied by transformers.
+     */
+    typedef enum
+    {
+        NVIMGCODEC_TRANSFORM_OP_NONE = 0,       /**< No geometric operation, only crop if requested. */
+        NVIMGCODEC_TRANSFORM_OP_FLIP_X = 1,     /**< Mirror left to right. */
+        NVIMGCODEC_TRANSFORM_OP_FLIP_Y = 2,     /**< Mirror top to bottom. */
+        NVIMGCODEC_TRANSFORM_OP_TRANSPOSE = 3,  /**< Swap rows and columns, across the top-left to bottom-right diagonal. */
+        NVIMGCODEC_TRANSFORM_OP_TRANSVERSE = 4, /**< Swap rows and columns, across the top-right to bottom-left diagonal. */
+        NVIMGCODEC_TRANSFORM_OP_ROT_90 = 5,     /**< Rotate 90 degrees clockwise. */
+        NVIMGCODEC_TRANSFORM_OP_ROT_180 = 6,    /**< Rotate 180 degrees. */
+        NVIMGCODEC_TRANSFORM_OP_ROT_270 = 7,    /**< Rotate 270 degrees clockwise. */
+        NVIMGCODEC_TRANSFORM_OP_ENUM_FORCE_INT = INT32_MAX
+    } nvimgcodecTransformOp_t;
+
+    /**
+     * @brief Transform parameters
+     *
+     * Describes an operation which rewrites a code stream into another code stream of the same codec without
+     * going through decoded samples. Crop is applied first, then the geometric operation.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        nvimgcodecTransformOp_t op; /**< Geometric operation to apply. */
+        /**
+         * Region of the input to keep, ndim equal to 0 means whole image. Codecs may require the start to be aligned,
+         * e.g. for JPEG it is moved up and left to the closest MCU boundary.
+         */
+        nvimgcodecRegion_t region;
+        /**
+         * If true, the operation which brings the image to its EXIF orientation is used instead of op,
+         * and the orientation stored in the output is reset to normal.
+         */
+        int apply_exif_orientation;
+    } nvimgcodecTransformParams_t;
+
+    /**
+     * @brief Transcode parameters
+     *
+     * Controls the intermediate images a transcode goes through. Each sample is handed over to the encoder
+     * as soon as it is decoded, and its intermediate buffer is reused for a later sample once it is encoded.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        /**
+         * Sample format of intermediate images. NVIMGCODEC_SAMPLEFORMAT_UNKNOWN means NVIMGCODEC_SAMPLEFORMAT_P_RGB.
+         * Unchanged formats keep the number of channels and the sample type of the input.
+         */
+        nvimgcodecSampleFormat_t sample_format;
+        /**
+         * Buffer kind of intermediate images. NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN means device buffers,
+         * or host buffers when the decoder runs with NVIMGCODEC_DEVICE_CPU_ONLY.
+         */
+        nvimgcodecImageBufferKind_t buffer_kind;
+        /**
+         * Upper bound, in bytes, of intermediate buffers allocated at a time. Decoding of further samples waits
+         * until encoded samples return their buffers. 0 means unlimited. A single sample larger than
+         * the limit is still processed, alone.
+         */
+        size_t max_in_flight_bytes;
+        /**
+         * If true, a JPEG input is copied to a JPEG output unchanged, without decoding and encoding it, when it already
+         * satisfies the target: its estimated quality is not higher than the encode quality, the chroma subsampling and
+         * the JPEG encoding match the output code stream, it needs no EXIF orientation to be applied and it fits
+         * within max_width and max_height.
+         */
+        int enable_passthrough;
+        uint32_t max_width;  /**< Largest width allowed to pass through, 0 means unlimited. */
+        uint32_t max_height; /**< Largest height allowed to pass through, 0 means unlimited. */
+    } nvimgcodecTranscodeParams_t;
+
     /**
      * @brief Bitmask specifying which severities of events cause a debug messenger callback
      */
@@ -843,6 +1410,23 @@ extern "C"
          * @return Number of threads in executor.
         */
         int (*getNumThreads)(void* instance);
+
+        /**
+         * @brief Schedule execution of a batch of asynchronous tasks.
+         *
+         * The task is called once for each sample index in [0, num_tasks). Executors can enqueue the whole batch at once
+         * and wake up only as many threads as needed. It can be NULL, or left out by struct_size, in which case the library
+         * schedules the tasks one by one with launch.
+         *
+         * @param instance [in] Pointer to nvimgcodecExecutorDesc_t instance.
+         * @param device_id [in] Device id on which tasks will be executed.
+         * @param num_tasks [in] Number of tasks to schedule.
+         * @param task_context [in] Pointer to task context which will be passed back as an argument in task function.
+         * @param task [in] Pointer to task function to schedule.
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+        */
+        nvimgcodecStatus_t (*launchBatch)(void* instance, int device_id, int num_tasks, void* task_context,
+            void (*task)(int thread_id, int sample_idx, void* task_context));
     } nvimgcodecExecutorDesc_t;
 
     /** 
@@ -867,6 +1451,8 @@ extern "C"
                                                            in backends parameter. For 0, all backends are allowed.*/
         const nvimgcodecBackend_t* backends;           /**< Points a nvimgcodecBackend_t array with defined allowed backends.
                                                            For nullptr, all backends are allowed. */
+        nvimgcodecHostAllocator_t* host_allocator;     /**< Custom allocator for regular host memory. If NULL, or left out by
+                                                           struct_size, the system allocator is used. */
     } nvimgcodecExecutionParams_t;
 
     /**
@@ -1225,8 +1811,83 @@ extern "C"
          */
         nvimgcodecStatus_t (*decode)(nvimgcodecDecoder_t decoder, nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images,
             int batch_size, const nvimgcodecDecodeParams_t* params);
+
+        /**
+         * Set to 1 if canDecode results depend only on the image info of the code stream and of the output image, and on
+         * the decode parameters, but not on other contents of the code stream. The framework then remembers them for
+         * samples alike. Valid values 0 or 1.
+         */
+        int can_decode_memoizable;
     } nvimgcodecDecoderDesc_t;
 
+    /**
+     * Transformer description.
+    */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        void* instance;                       /**< Transformer description instance pointer which will be passed back in functions */
+        const char* id;                       /**< Codec named identifier e.g. libjpeg_turbo_transformer */
+        const char* codec;                    /**< Codec name e.g. jpeg */
+        nvimgcodecBackendKind_t backend_kind; /**< Backend kind */
+
+        /**
+         * @brief Creates transformer.
+         * 
+         * @param instance [in] Pointer to nvimgcodecTransformerDesc_t instance.
+         * @param transformer [in/out] Points where to return handle to created transformer.
+         * @param exec_params [in] Points an execution parameters.
+         * @param options [in] String with optional, space separated, list of parameters for transformers, in format 
+         *                     "<transformer_id>:<parameter_name>=<parameter_value>".
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+         */
+        nvimgcodecStatus_t (*create)(
+            void* instance, nvimgcodecTransformer_t* transformer, const nvimgcodecExecutionParams_t* exec_params, const char* options);
+
+        /** 
+         * Destroys transformer.
+         * 
+         * @param transformer [in] Transformer handle to destroy.
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+        */
+        nvimgcodecStatus_t (*destroy)(nvimgcodecTransformer_t transformer);
+
+        /**
+         * @brief Checks whether transformer can transform given batch of code streams with provided parameters.
+         * 
+         * @param transformer [in] Transformer handle to use for check.
+         * @param status [in/out] Points to array of batch size and nvimgcodecProcessingStatus_t type, where result will be returned.
+         * @param in_code_streams [in] Pointer to array of pointers of batch size with input code streams to check.
+         * @param out_code_streams [in] Pointer to array of pointers of batch size with output code streams to check.
+         * @param batch_size [in] Number of items in batch to check.
+         * @param params [in] Transform parameters which will be used with check.
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+         */
+        nvimgcodecStatus_t (*canTransform)(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+            nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+            const nvimgcodecTransformParams_t* params);
+
+        /**
+         * @brief Transforms given batch of code streams with provided parameters.
+         *
+         * Returns when all samples are processed.
+         * 
+         * @param transformer [in] Transformer handle to use.
+         * @param status [in/out] Points to array of batch size and nvimgcodecProcessingStatus_t type, where result will be returned.
+         * @param in_code_streams [in] Pointer to array of pointers of batch size with input code streams.
+         * @param out_code_streams [in/out] Pointer to array of pointers of batch size with output code streams.
+         * @param batch_size [in] Number of items in batch to transform.
+         * @param params [in] Transform parameters.
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+         */
+        nvimgcodecStatus_t (*transform)(nvimgcodecTransformer_t transformer, nvimgcodecProcessingStatus_t* status,
+            nvimgcodecCodeStreamDesc_t** in_code_streams, nvimgcodecCodeStreamDesc_t** out_code_streams, int batch_size,
+            const nvimgcodecTransformParams_t* params);
+    } nvimgcodecTransformerDesc_t;
+
     /**
      * @brief Defines decoder or encoder priority in codec.
      * 
@@ -1331,6 +1992,46 @@ extern "C"
          */
         nvimgcodecStatus_t (*unregisterParser)(void* instance, const nvimgcodecParserDesc_t* desc);
 
+        /**
+         * @brief Registers transformer plugin.
+         *
+         * Available since extension API 0.3. Extensions check struct_size before using this and the following functions.
+         *
+         * @param instance [in] Pointer to nvimgcodecFrameworkDesc_t instance.
+         * @param desc [in] Pointer to transformer description.
+         * @param priority [in] Priority of transformer. @see nvimgcodecPriority_t
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+        */
+        nvimgcodecStatus_t (*registerTransformer)(void* instance, const nvimgcodecTransformerDesc_t* desc, float priority);
+
+        /**
+         * @brief Unregisters transformer plugin.
+         *
+         * @param instance [in] Pointer to nvimgcodecFrameworkDesc_t instance.
+         * @param desc [in] Pointer to transformer description to unregister.
+         * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+         */
+        nvimgcodecStatus_t (*unregisterTransformer)(void* instance, const nvimgcodecTransformerDesc_t* desc);
+
+        /**
+         * @brief Allocates host scratch memory from the arena of the calling thread.
+         *
+         * The memory stays valid until the thread calls scratchReset, which a task does once it no longer needs its
+         * temporaries. Tasks running on the same thread must not keep scratch memory across each other.
+         *
+         * @param instance [in] Pointer to nvimgcodecFrameworkDesc_t instance.
+         * @param size [in] Size of the allocation, in bytes.
+         * @param alignment [in] Alignment of the allocation, a power of two, or 0 for the alignment of std::max_align_t.
+         * @return Pointer to the memory, or NULL if it could not be allocated.
+         */
+        void* (*scratchAlloc)(void* instance, size_t size, size_t alignment);
+
+        /**
+         * @brief Releases all the scratch memory allocated by the calling thread, keeping it for its next allocations.
+         *
+         * @param instance [in] Pointer to nvimgcodecFrameworkDesc_t instance.
+         */
+        void (*scratchReset)(void* instance);
     } nvimgcodecFrameworkDesc_t;
 
     /**
@@ -1410,6 +2111,45 @@ extern "C"
         uint32_t message_category; /**< Message category for default debug messenger */
     } nvimgcodecInstanceCreateInfo_t;
 
+    /**
+     * @brief Scratch arena parameters
+     *
+     * This structure extends nvimgcodecInstanceCreateInfo_t. Extensions can allocate host scratch memory from an arena of
+     * the calling thread, see nvimgcodecFrameworkDesc_t::scratchAlloc. Each arena grows to the largest amount of memory
+     * used between two resets, so that later tasks are served without system allocations.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        /**
+         * Largest amount of memory, in bytes, kept by the arena of a thread between resets. Memory needed above it is
+         * allocated from the system and released on reset. 0 means the default of 64 MiB.
+         */
+        size_t max_retained_size;
+    } nvimgcodecScratchArenaParams_t;
+
+    /**
+     * @brief Scratch arena counters of a library instance, summed over the arenas of all threads
+     *
+     * The arena of a thread is released when the thread exits. Allocation counts and the peak size include
+     * released arenas.
+     */
+    typedef struct
+    {
+        nvimgcodecStructureType_t struct_type; /**< The type of the structure. */
+        size_t struct_size;                    /**< The size of the structure, in bytes. */
+        void* struct_next;                     /**< Is NULL or a pointer to an extension structure type. */
+
+        uint64_t num_arenas;             /**< [out] Number of running threads which allocated scratch memory. */
+        uint64_t num_allocations;        /**< [out] Number of scratch allocations. */
+        uint64_t num_system_allocations; /**< [out] Number of allocations from the system made by the arenas. */
+        uint64_t retained_size;          /**< [out] Memory currently kept by the arenas, in bytes. */
+        uint64_t peak_size;              /**< [out] Largest amount of memory used by a thread between two resets, in bytes. */
+    } nvimgcodecScratchArenaStats_t;
+
     /**
      * @brief Creates an instance of the library using the input arguments.
      * 
@@ -1428,6 +2168,18 @@ extern "C"
      */
     NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecInstanceDestroy(nvimgcodecInstance_t instance);
 
+    /**
+     * @brief Retrieves scratch arena counters of the library instance.
+     *
+     * @param instance [in] The library instance handle.
+     * @param stats [in/out] Points a nvimgcodecScratchArenaStats_t struct which will receive the counters.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+     *
+     * @see nvimgcodecScratchArenaParams_t
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecInstanceGetScratchArenaStats(
+        nvimgcodecInstance_t instance, nvimgcodecScratchArenaStats_t* stats);
+
     /**
      * @brief Creates library extension.
      *  
@@ -1512,6 +2264,9 @@ extern "C"
     /**
      * @brief Destroys image.
      * 
+     * Released handles are kept in a pool of the instance the image was created with, and returned by the following calls
+     * to nvimgcodecImageCreate with that instance. Images have to be destroyed before their instance.
+     * 
      * @param image [in] The image handle to destroy 
      * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
      */
@@ -1526,6 +2281,50 @@ extern "C"
      */
     NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecImageGetImageInfo(nvimgcodecImage_t image, nvimgcodecImageInfo_t* image_info);
 
+    /**
+     * @brief Points an existing image at a new sample buffer and format.
+     *
+     * Allows to reuse image handles across batches instead of creating and destroying one for every sample.
+     * Must not be called while the image is used by a decoding or encoding operation which is not finished yet.
+     * Images created with nvimgcodecImageCreateFileMapped cannot be updated.
+     *
+     * @param image [in] The image handle to update.
+     * @param image_info [in] Points a nvimgcodecImageInfo_t struct which describes the new sample buffer together with format.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecImageSetImageInfo(nvimgcodecImage_t image, const nvimgcodecImageInfo_t* image_info);
+
+    /**
+     * @brief Creates Image with sample buffer backed by a memory mapped file.
+     *
+     * The file is created, or truncated, to image_info->buffer_size bytes and mapped in shared, writable mode.
+     * Decoded samples are written through the mapping, so images larger than the host memory can be decoded
+     * and the result persists in the file. The mapping is owned by the image and released when it is destroyed.
+     *
+     * buffer_size has to hold row_stride * height bytes for each plane.
+     *
+     * @note Only supported on POSIX platforms, other platforms return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED.
+     *
+     * @param instance [in] The library instance handle the image will be used with.
+     * @param image [in/out] Points a nvimgcodecImage_t handle in which the resulting image is returned.
+     * @param image_info [in/out] Points a nvimgcodecImageInfo_t struct which describes the image format and buffer size.
+     *                            On return, buffer points to the mapping and buffer_kind is set to host.
+     * @param file_path [in] Path of the file to create.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecImageCreateFileMapped(
+        nvimgcodecInstance_t instance, nvimgcodecImage_t* image, nvimgcodecImageInfo_t* image_info, const char* file_path);
+
+    /**
+     * @brief Writes samples of an image created with nvimgcodecImageCreateFileMapped back to its file.
+     *
+     * Blocks until the data is written. Should be called after decoding of the image is finished.
+     *
+     * @param image [in] The image handle to synchronize.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecImageSync(nvimgcodecImage_t image);
+
     /**
      * @brief Creates code stream which wraps file source of compressed data 
      *  
@@ -1665,6 +2464,18 @@ extern "C"
     NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecDecoderDecode(nvimgcodecDecoder_t decoder, const nvimgcodecCodeStream_t* streams,
         const nvimgcodecImage_t* images, int batch_size, const nvimgcodecDecodeParams_t* params, nvimgcodecFuture_t* future);
 
+    /**
+     * @brief Retrieves deduplication counters of the decoder.
+     *
+     * @param decoder [in] The decoder handle.
+     * @param stats [in/out] Points a nvimgcodecDeduplicationStats_t struct which will receive the counters.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes}
+     *
+     * @see nvimgcodecDeduplicationParams_t
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecDecoderGetDeduplicationStats(
+        nvimgcodecDecoder_t decoder, nvimgcodecDeduplicationStats_t* stats);
+
     /**
      * @brief Creates generic image encoder.
      *  
@@ -1724,6 +2535,78 @@ extern "C"
     NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecEncoderEncode(nvimgcodecEncoder_t encoder, const nvimgcodecImage_t* images,
         const nvimgcodecCodeStream_t* streams, int batch_size, const nvimgcodecEncodeParams_t* params, nvimgcodecFuture_t* future);
 
+    /**
+     * @brief Creates generic transformer.
+     * 
+     * Transformers rewrite code streams without decoding them, e.g. rotate a JPEG in the DCT domain.
+     * 
+     * @param instance [in] The library instance handle the transformer will be used with.
+     * @param transformer [in/out] Points a nvimgcodecTransformer_t handle in which the transformer will be returned.
+     * @param exec_params [in] Points an execution parameters.
+     * @param options [in] String with optional, space separated, list of parameters for specific transformers, in format 
+     *                     "<transformer_id>:<parameter_name>=<parameter_value>".
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes} 
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerCreate(nvimgcodecInstance_t instance, nvimgcodecTransformer_t* transformer,
+        const nvimgcodecExecutionParams_t* exec_params, const char* options);
+
+    /**
+     * @brief Destroys transformer.
+     * 
+     * @param transformer [in] The transformer handle to destroy.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes} 
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerDestroy(nvimgcodecTransformer_t transformer);
+
+    /**
+     * @brief Transforms batch of provided code streams to given output code streams with specified parameters.
+     * 
+     * Output code streams need to be of the same codec as the input ones.
+     * 
+     * @param transformer [in] The transformer handle to use.
+     * @param in_streams [in] Pointer to input nvimgcodecCodeStream_t array to transform.
+     * @param out_streams [in] Pointer to output nvimgcodecCodeStream_t array to write to.
+     * @param batch_size [in] Batch size of provided code streams.
+     * @param params [in] Pointer to nvimgcodecTransformParams_t struct to transform with.
+     * @param future  [in/out] Points a nvimgcodecFuture_t handle in which the future is returned. 
+     *                 The future object can be used to waiting and getting processing statuses.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes} 
+     * 
+     * @see nvimgcodecFutureGetProcessingStatus
+     * @see nvimgcodecFutureWaitForAll
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerTransform(nvimgcodecTransformer_t transformer,
+        const nvimgcodecCodeStream_t* in_streams, const nvimgcodecCodeStream_t* out_streams, int batch_size,
+        const nvimgcodecTransformParams_t* params, nvimgcodecFuture_t* future);
+
+    /**
+     * @brief Transcodes batch of provided code streams to given output code streams.
+     * 
+     * Decoding and encoding overlap: every sample is passed to the encoder as soon as it is decoded,
+     * so the throughput approaches the slower of the two stages instead of their sum.
+     * The decoder, the encoder, the code streams and the parameters (including chained extension structures)
+     * have to stay valid until the future reports all results.
+     * 
+     * @param decoder [in] The decoder handle to use for decoding.
+     * @param encoder [in] The encoder handle to use for encoding.
+     * @param in_streams [in] Pointer to input nvimgcodecCodeStream_t array to decode.
+     * @param out_streams [in] Pointer to output nvimgcodecCodeStream_t array to encode to.
+     * @param batch_size [in] Batch size of provided code streams.
+     * @param decode_params [in] Pointer to nvimgcodecDecodeParams_t struct to decode with.
+     * @param encode_params [in] Pointer to nvimgcodecEncodeParams_t struct to encode with.
+     * @param transcode_params [in] Pointer to nvimgcodecTranscodeParams_t struct or NULL for defaults.
+     * @param future  [in/out] Points a nvimgcodecFuture_t handle in which the future is returned. 
+     *                 The future object can be used to waiting and getting processing statuses.
+     * @return nvimgcodecStatus_t - An error code as specified in {@link nvimgcodecStatus_t API Return Status Codes} 
+     * 
+     * @see nvimgcodecFutureGetProcessingStatus
+     * @see nvimgcodecFutureWaitForAll
+     */
+    NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTranscode(nvimgcodecDecoder_t decoder, nvimgcodecEncoder_t encoder,
+        const nvimgcodecCodeStream_t* in_streams, const nvimgcodecCodeStream_t* out_streams, int batch_size,
+        const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+        const nvimgcodecTranscodeParams_t* transcode_params, nvimgcodecFuture_t* future);
+
 #if defined(__cplusplus)
 }
 #endif
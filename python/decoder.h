@@ -56,6 +56,8 @@ class Decoder
     void exit(const std::optional<pybind11::type>& exc_type, const std::optional<pybind11::object>& exc_value,
         const std::optional<pybind11::object>& traceback);
 
+    std::shared_ptr<std::remove_pointer<nvimgcodecDecoder_t>::type> getNvImgCdcsDecoder() const { return decoder_; }
+
     static void exportToPython(py::module& m, nvimgcodecInstance_t instance, ILogger* logger);
 
   private:
@@ -87,7 +87,8 @@ Encoder::~Encoder()
 {
 }
 
-void Encoder::convertPyImagesToImages(const std::vector<py::handle>& py_images, std::vector<Image*>* images, intptr_t cuda_stream)
+void Encoder::convertPyImagesToImages(const std::vector<py::handle>& py_images, std::vector<Image*>* images,
+    std::vector<std::unique_ptr<Image>>* array_images, bool reuse_handles, intptr_t cuda_stream)
 {
     images->reserve(py_images.size());
     int i = 0;
@@ -96,7 +97,14 @@ void Encoder::convertPyImagesToImages(const std::vector<py::handle>& py_images,
         try {
             image = pi.cast<Image*>();
         } catch (...) {
-            image = new Image(instance_, pi.ptr(), cuda_stream);
+            std::shared_ptr<std::remove_pointer<nvimgcodecImage_t>::type>* reusable_handle = nullptr;
+            if (reuse_handles) {
+                if (array_handles_.size() <= array_images->size())
+                    array_handles_.resize(array_images->size() + 1);
+                reusable_handle = &array_handles_[array_images->size()];
+            }
+            array_images->push_back(std::make_unique<Image>(instance_, pi.ptr(), cuda_stream, reusable_handle));
+            image = array_images->back().get();
         }
         if (image) {
             images->push_back(image);
@@ -190,16 +198,20 @@ void Encoder::encode(const std::vector<Image*>& images, std::optional<EncodePara
 std::vector<py::bytes> Encoder::encode(
     const std::vector<py::handle>& py_images, const std::string& codec, std::optional<EncodeParams> params, intptr_t cuda_stream)
 {
+    std::unique_lock<std::mutex> lock(array_handles_mutex_, std::try_to_lock);
     std::vector<Image*> images;
-    convertPyImagesToImages(py_images, &images, cuda_stream);
+    std::vector<std::unique_ptr<Image>> array_images;
+    convertPyImagesToImages(py_images, &images, &array_images, lock.owns_lock(), cuda_stream);
     return encode(images, codec, params, cuda_stream);
 }
 
 void Encoder::encode(const std::vector<std::string>& file_names, const std::vector<py::handle>& py_images, const std::string& codec,
     std::optional<EncodeParams> params, intptr_t cuda_stream)
 {
+    std::unique_lock<std::mutex> lock(array_handles_mutex_, std::try_to_lock);
     std::vector<Image*> images;
-    convertPyImagesToImages(py_images, &images, cuda_stream);
+    std::vector<std::unique_ptr<Image>> array_images;
+    convertPyImagesToImages(py_images, &images, &array_images, lock.owns_lock(), cuda_stream);
     return encode(file_names, images, codec, params, cuda_stream);
 }
 
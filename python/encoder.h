@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -57,10 +59,13 @@ class Encoder
     void exit(const std::optional<pybind11::type>& exc_type, const std::optional<pybind11::object>& exc_value,
         const std::optional<pybind11::object>& traceback);
 
+    std::shared_ptr<std::remove_pointer<nvimgcodecEncoder_t>::type> getNvImgCdcsEncoder() const { return encoder_; }
+
     static void exportToPython(py::module& m, nvimgcodecInstance_t instance, ILogger* logger);
 
   private:
-    void convertPyImagesToImages(const std::vector<py::handle>& py_images, std::vector<Image*>* images, intptr_t cuda_stream);
+    void convertPyImagesToImages(const std::vector<py::handle>& py_images, std::vector<Image*>* images,
+        std::vector<std::unique_ptr<Image>>* array_images, bool reuse_handles, intptr_t cuda_stream);
     std::vector<py::bytes> encode(
         const std::vector<py::handle>& images, const std::string& codec, std::optional<EncodeParams> params, intptr_t cuda_stream);
 
@@ -75,6 +80,11 @@ class Encoder
     std::shared_ptr<std::remove_pointer<nvimgcodecEncoder_t>::type> encoder_;
     nvimgcodecInstance_t instance_;
     ILogger* logger_;
+
+    // Image handles wrapping the arrays passed to encode, repointed with nvimgcodecImageSetImageInfo on every call.
+    // Only the call holding the mutex uses them, concurrent calls create their own handles.
+    std::mutex array_handles_mutex_;
+    std::vector<std::shared_ptr<std::remove_pointer<nvimgcodecImage_t>::type>> array_handles_;
 };
 
 } // namespace nvimgcodec
@@ -162,7 +162,8 @@ void Image::initImageInfoFromInterfaceDict(const py::dict& iface, nvimgcodecImag
     image_info->buffer_size = buffer_size;
 }
 
-Image::Image(nvimgcodecInstance_t instance, PyObject* o, intptr_t cuda_stream)
+Image::Image(nvimgcodecInstance_t instance, PyObject* o, intptr_t cuda_stream,
+    std::shared_ptr<std::remove_pointer<nvimgcodecImage_t>::type>* reusable_handle)
     : instance_(instance)
 {
     if (!o) {
@@ -231,10 +232,17 @@ Image::Image(nvimgcodecInstance_t instance, PyObject* o, intptr_t cuda_stream)
     }
 
     py::gil_scoped_release release;
+    if (reusable_handle && *reusable_handle) {
+        CHECK_NVIMGCODEC(nvimgcodecImageSetImageInfo(reusable_handle->get(), &image_info));
+        image_ = *reusable_handle;
+        return;
+    }
     nvimgcodecImage_t image;
     CHECK_NVIMGCODEC(nvimgcodecImageCreate(instance, &image, &image_info));
     image_ = std::shared_ptr<std::remove_pointer<nvimgcodecImage_t>::type>(
         image, [](nvimgcodecImage_t image) { nvimgcodecImageDestroy(image); });
+    if (reusable_handle)
+        *reusable_handle = image_;
 }
 
 void Image::initInterfaceDictFromImageInfo(py::dict* d) const
@@ -38,7 +38,9 @@ class Image
 {
   public:
     Image(nvimgcodecInstance_t instance, nvimgcodecImageInfo_t* image_info);
-    Image(nvimgcodecInstance_t instance, PyObject* o, intptr_t cuda_stream);
+    // With a reusable handle, the array is wrapped into it with nvimgcodecImageSetImageInfo, and a new handle is stored there if it is empty
+    Image(nvimgcodecInstance_t instance, PyObject* o, intptr_t cuda_stream,
+        std::shared_ptr<std::remove_pointer<nvimgcodecImage_t>::type>* reusable_handle = nullptr);
 
     int getWidth() const;
     int getHeight() const;
@@ -42,6 +42,7 @@
 #include "jpeg_encode_params.h"
 #include "module.h"
 #include "region.h"
+#include "transcoder.h"
 
 #include <iostream>
 
@@ -86,5 +87,6 @@ PYBIND11_MODULE(nvimgcodec_impl, m)
     Image::exportToPython(m);
     Decoder::exportToPython(m, module.instance_, module.logger_.get());
     Encoder::exportToPython(m, module.instance_, module.logger_.get());
+    Transcoder::exportToPython(m, module.instance_, module.logger_.get());
     Module::exportToPython(m, module.instance_);
 }
@@ -0,0 +1,220 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transcoder.h"
+
+#include <string.h>
+#include <memory>
+#include <type_traits>
+
+#include <ilogger.h>
+#include <log.h>
+
+#include "../src/file_ext_codec.h"
+#include "error_handling.h"
+
+namespace nvimgcodec {
+
+Transcoder::Transcoder(
+    nvimgcodecInstance_t instance, ILogger* logger, const Decoder& decoder, const Encoder& encoder, size_t max_in_flight_bytes,
+    bool passthrough)
+    : decoder_(decoder.getNvImgCdcsDecoder())
+    , encoder_(encoder.getNvImgCdcsEncoder())
+    , max_in_flight_bytes_(max_in_flight_bytes)
+    , passthrough_(passthrough)
+    , instance_(instance)
+    , logger_(logger)
+{
+}
+
+Transcoder::~Transcoder()
+{
+}
+
+py::object Transcoder::transcode(
+    const DecodeSource* src, const std::string& codec, std::optional<DecodeParams> decode_params, std::optional<EncodeParams> encode_params)
+{
+    std::vector<py::object> data_list = transcode(std::vector<const DecodeSource*>{src}, codec, decode_params, encode_params);
+    return data_list.size() == 1 ? data_list[0] : py::none();
+}
+
+std::vector<py::object> Transcoder::transcode(const std::vector<const DecodeSource*>& src, const std::string& codec,
+    std::optional<DecodeParams> decode_params_opt, std::optional<EncodeParams> encode_params_opt)
+{
+    std::vector<py::object> data_list;
+    std::string codec_name = codec.empty() || codec[0] != '.' ? codec : file_ext_to_codec(codec);
+    if (codec_name.empty()) {
+        NVIMGCODEC_LOG_ERROR(logger_, "Unsupported codec.");
+        return data_list;
+    }
+
+    DecodeParams decode_params = decode_params_opt.has_value() ? decode_params_opt.value() : DecodeParams();
+    EncodeParams encode_params = encode_params_opt.has_value() ? encode_params_opt.value() : EncodeParams();
+    encode_params.jpeg2k_encode_params_.nvimgcodec_jpeg2k_encode_params_.struct_next = nullptr;
+    encode_params.jpeg_encode_params_.nvimgcodec_jpeg_encode_params_.struct_next =
+        &encode_params.jpeg2k_encode_params_.nvimgcodec_jpeg2k_encode_params_;
+    encode_params.encode_params_.struct_next = &encode_params.jpeg_encode_params_.nvimgcodec_jpeg_encode_params_;
+
+    nvimgcodecTranscodeParams_t transcode_params{NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS, sizeof(nvimgcodecTranscodeParams_t), 0};
+    transcode_params.max_in_flight_bytes = max_in_flight_bytes_;
+    transcode_params.enable_passthrough = passthrough_;
+    if (decode_params.color_spec_ == NVIMGCODEC_COLORSPEC_GRAY)
+        transcode_params.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    else if (decode_params.color_spec_ == NVIMGCODEC_COLORSPEC_UNCHANGED)
+        transcode_params.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED;
+    else
+        transcode_params.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+
+    struct PyObjectWrap
+    {
+        unsigned char* getBuffer(size_t bytes)
+        {
+            ptr_ = PyBytes_FromStringAndSize(nullptr, bytes);
+            return (unsigned char*)PyBytes_AsString(ptr_);
+        }
+
+        static unsigned char* resize_buffer_static(void* ctx, size_t bytes)
+        {
+            py::gil_scoped_acquire acquire;
+            auto handle = reinterpret_cast<PyObjectWrap*>(ctx);
+            return handle->getBuffer(bytes);
+        }
+
+        PyObject* ptr_ = nullptr;
+    };
+
+    // Output code streams are destroyed by their guards, also when any of the calls below throws
+    using CodeStreamGuard = std::unique_ptr<std::remove_pointer<nvimgcodecCodeStream_t>::type, decltype(&nvimgcodecCodeStreamDestroy)>;
+    std::vector<nvimgcodecCodeStream_t> in_code_streams;
+    std::vector<nvimgcodecCodeStream_t> out_code_streams;
+    std::vector<CodeStreamGuard> out_code_stream_guards;
+    std::vector<PyObjectWrap> py_objects(src.size());
+    in_code_streams.reserve(src.size());
+    out_code_streams.reserve(src.size());
+    out_code_stream_guards.reserve(src.size());
+    for (size_t i = 0; i < src.size(); i++) {
+        if (src[i]->region())
+            NVIMGCODEC_LOG_WARNING(logger_, "Region of interest is not supported when transcoding. Sample #" << i << " is transcoded whole");
+        nvimgcodecImageInfo_t out_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        CHECK_NVIMGCODEC(nvimgcodecCodeStreamGetImageInfo(src[i]->code_stream()->handle(), &out_image_info));
+        strcpy(out_image_info.codec_name, codec_name.c_str());
+        out_image_info.chroma_subsampling = encode_params.chroma_subsampling_;
+        out_image_info.color_spec = encode_params.color_spec_;
+        out_image_info.struct_next = (void*)(&encode_params.jpeg_encode_params_.nvimgcodec_jpeg_image_info_);
+
+        nvimgcodecCodeStream_t out_code_stream;
+        CHECK_NVIMGCODEC(nvimgcodecCodeStreamCreateToHostMem(
+            instance_, &out_code_stream, (void*)&py_objects[i], &PyObjectWrap::resize_buffer_static, &out_image_info));
+        out_code_stream_guards.emplace_back(out_code_stream, &nvimgcodecCodeStreamDestroy);
+        in_code_streams.push_back(src[i]->code_stream()->handle());
+        out_code_streams.push_back(out_code_stream);
+    }
+
+    std::vector<nvimgcodecProcessingStatus_t> transcode_status;
+    {
+        py::gil_scoped_release release;
+        nvimgcodecFuture_t future;
+        CHECK_NVIMGCODEC(nvimgcodecTranscode(decoder_.get(), encoder_.get(), in_code_streams.data(), out_code_streams.data(),
+            in_code_streams.size(), &decode_params.decode_params_, &encode_params.encode_params_, &transcode_params, &future));
+        nvimgcodecFutureWaitForAll(future);
+        size_t status_size;
+        nvimgcodecFutureGetProcessingStatus(future, nullptr, &status_size);
+        transcode_status.resize(status_size);
+        nvimgcodecFutureGetProcessingStatus(future, transcode_status.data(), &status_size);
+        nvimgcodecFutureDestroy(future);
+        out_code_stream_guards.clear();
+    }
+
+    data_list.reserve(src.size());
+    for (size_t i = 0; i < transcode_status.size(); ++i) {
+        if (transcode_status[i] != NVIMGCODEC_PROCESSING_STATUS_SUCCESS) {
+            NVIMGCODEC_LOG_WARNING(logger_, "Something went wrong during transcoding image #" << i << " it will not be included in output");
+            if (py_objects[i].ptr_)
+                Py_DECREF(py_objects[i].ptr_);
+            data_list.push_back(py::none());
+        } else {
+            data_list.push_back(py::reinterpret_steal<py::object>(py_objects[i].ptr_));
+        }
+    }
+    return data_list;
+}
+
+void Transcoder::exportToPython(py::module& m, nvimgcodecInstance_t instance, ILogger* logger)
+{
+    py::class_<Transcoder>(m, "Transcoder")
+        .def(py::init<>([instance, logger](const Decoder& decoder, const Encoder& encoder, size_t max_in_flight_bytes,
+                         bool passthrough) {
+            return new Transcoder(instance, logger, decoder, encoder, max_in_flight_bytes, passthrough);
+        }),
+            R"pbdoc(
+            Initialize transcoder.
+
+            Every image is handed over to the encoder as soon as it is decoded, so decoding and encoding overlap.
+
+            Args:
+                decoder: Decoder to decode with.
+
+                encoder: Encoder to encode with.
+
+                max_in_flight_bytes: Upper bound of memory used by intermediate images at a time (0 means unlimited).
+
+                passthrough: Copy JPEG images to JPEG outputs unchanged when their estimated quality is not higher than
+                the encode quality and their chroma subsampling already matches.
+
+            )pbdoc",
+            "decoder"_a, "encoder"_a, "max_in_flight_bytes"_a = 0, "passthrough"_a = false)
+        .def("transcode",
+            py::overload_cast<const DecodeSource*, const std::string&, std::optional<DecodeParams>, std::optional<EncodeParams>>(
+                &Transcoder::transcode),
+            R"pbdoc(
+            Transcode data from a DecodeSource handle to a buffer.
+
+            Args:
+                src: Decode source object. Region of interest is ignored.
+
+                codec: String that defines the output format e.g.'jpeg2k'. When it is file extension it must include a leading period e.g. '.jp2'.
+
+                decode_params: Decode parameters.
+
+                encode_params: Encode parameters.
+
+            Returns:
+                Buffer with compressed code stream. None if the image cannot be transcoded because of any reason.
+            )pbdoc",
+            "src"_a, "codec"_a, "decode_params"_a = py::none(), "encode_params"_a = py::none())
+        .def("transcode",
+            py::overload_cast<const std::vector<const DecodeSource*>&, const std::string&, std::optional<DecodeParams>,
+                std::optional<EncodeParams>>(&Transcoder::transcode),
+            R"pbdoc(
+            Transcode batch of data from DecodeSource handles to buffers.
+
+            Args:
+                srcs: List of decode source objects. Region of interest is ignored.
+
+                codec: String that defines the output format e.g.'jpeg2k'. When it is file extension it must include a leading period e.g. '.jp2'.
+
+                decode_params: Decode parameters.
+
+                encode_params: Encode parameters.
+
+            Returns:
+                List of buffers with compressed code streams. None in place of images which cannot be transcoded because of any reason.
+            )pbdoc",
+            "srcs"_a, "codec"_a, "decode_params"_a = py::none(), "encode_params"_a = py::none());
+}
+
+} // namespace nvimgcodec
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nvimgcodec.h>
+
+#include <pybind11/pybind11.h>
+
+#include "decode_params.h"
+#include "decode_source.h"
+#include "decoder.h"
+#include "encode_params.h"
+#include "encoder.h"
+
+namespace nvimgcodec {
+
+namespace py = pybind11;
+using namespace py::literals;
+
+class ILogger;
+
+class Transcoder
+{
+  public:
+    Transcoder(nvimgcodecInstance_t instance, ILogger* logger, const Decoder& decoder, const Encoder& encoder, size_t max_in_flight_bytes,
+        bool passthrough);
+    ~Transcoder();
+
+    py::object transcode(const DecodeSource* src, const std::string& codec, std::optional<DecodeParams> decode_params,
+        std::optional<EncodeParams> encode_params);
+    std::vector<py::object> transcode(const std::vector<const DecodeSource*>& src, const std::string& codec,
+        std::optional<DecodeParams> decode_params, std::optional<EncodeParams> encode_params);
+
+    static void exportToPython(py::module& m, nvimgcodecInstance_t instance, ILogger* logger);
+
+  private:
+    std::shared_ptr<std::remove_pointer<nvimgcodecDecoder_t>::type> decoder_;
+    std::shared_ptr<std::remove_pointer<nvimgcodecEncoder_t>::type> encoder_;
+    size_t max_in_flight_bytes_;
+    bool passthrough_;
+    nvimgcodecInstance_t instance_;
+    ILogger* logger_;
+};
+
+} // namespace nvimgcodec
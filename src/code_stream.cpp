@@ -54,6 +54,7 @@ void CodeStream::parse()
             "CodeStream::parse - Encoded stream parsing");
 
     parser_ = std::move(parser);
+    icc_profile_.reset();
 }
 
 void CodeStream::parseFromFile(const std::string& file_name)
@@ -111,6 +112,36 @@ nvimgcodecStatus_t CodeStream::setImageInfo(const nvimgcodecImageInfo_t* image_i
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
+const std::vector<uint8_t>& CodeStream::getIccProfile()
+{
+    std::lock_guard<std::mutex> lock(icc_profile_mutex_);
+    if (!icc_profile_) {
+        assert(parser_);
+        // A profile stored as is can't be larger than its stream, so it is read with a single parse. Pages of the buffer
+        // past the profile are never touched. Compressed profiles may be larger and are parsed again.
+        auto profile = std::make_unique<std::vector<uint8_t>>();
+        size_t capacity = io_stream_->size();
+        std::unique_ptr<unsigned char[]> buffer(new unsigned char[capacity]);
+        nvimgcodecIccProfile_t icc_info{NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE, sizeof(nvimgcodecIccProfile_t), nullptr};
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &icc_info};
+        icc_info.buffer = buffer.get();
+        icc_info.buffer_size = capacity;
+        if (parser_->getImageInfo(&code_stream_desc_, &image_info) == NVIMGCODEC_STATUS_SUCCESS && icc_info.profile_size > 0) {
+            if (icc_info.profile_size <= capacity) {
+                profile->assign(buffer.get(), buffer.get() + icc_info.profile_size);
+            } else {
+                profile->resize(icc_info.profile_size);
+                icc_info.buffer = profile->data();
+                icc_info.buffer_size = profile->size();
+                if (parser_->getImageInfo(&code_stream_desc_, &image_info) != NVIMGCODEC_STATUS_SUCCESS)
+                    profile->clear();
+            }
+        }
+        icc_profile_ = std::move(profile);
+    }
+    return *icc_profile_;
+}
+
 std::string CodeStream::getCodecName() const
 {
     return image_info_ ? std::string(image_info_->codec_name) : parser_->getCodecName();
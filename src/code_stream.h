@@ -20,6 +20,8 @@
 #include <nvimgcodec.h>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "io_stream.h"
 #include "iimage_parser.h"
 #include "icode_stream.h"
@@ -41,6 +43,7 @@ class CodeStream : public ICodeStream
     void setOutputToHostMem(void* ctx, nvimgcodecResizeBufferFunc_t get_buffer_func) override;
     nvimgcodecStatus_t getImageInfo(nvimgcodecImageInfo_t* image_info) override;
     nvimgcodecStatus_t setImageInfo(const nvimgcodecImageInfo_t* image_info) override;
+    const std::vector<uint8_t>& getIccProfile() override;
     std::string getCodecName() const override;
     ICodec* getCodec() const override;
     nvimgcodecIoStreamDesc_t* getInputStreamDesc() override;
@@ -82,5 +85,7 @@ class CodeStream : public ICodeStream
     nvimgcodecIoStreamDesc_t io_stream_desc_;
     nvimgcodecCodeStreamDesc_t code_stream_desc_;
     std::unique_ptr<nvimgcodecImageInfo_t> image_info_;
+    std::mutex icc_profile_mutex_;
+    std::unique_ptr<std::vector<uint8_t>> icc_profile_;
 };
 } // namespace nvimgcodec
\ No newline at end of file
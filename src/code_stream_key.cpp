@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_stream_key.h"
+#include <nvimgcodec.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "icode_stream.h"
+
+namespace nvimgcodec {
+
+namespace {
+
+constexpr size_t kReadBlockSize = 64 * 1024; // Multiple of 8, so that blocks hash the same way as a mapped stream
+
+// Both hashes of a key, fed 8 bytes at a time
+struct KeyHasher
+{
+    uint64_t hash;
+    uint64_t check;
+
+    void mix(uint64_t word)
+    {
+        uint64_t w = word * 0x9e3779b97f4a7c15ull;
+        w ^= w >> 32;
+        hash = (hash ^ w) * 0xff51afd7ed558ccdull;
+        hash ^= hash >> 29;
+        // Another multiplier and rotation, so that words colliding in one hash don't collide in the other
+        check = ((check + word) * 0xc2b2ae3d27d4eb4full);
+        check = (check << 31) | (check >> 33);
+    }
+
+    // The last partial word is padded with zeros
+    void update(const uint8_t* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            memcpy(&word, data + i, 8);
+            mix(word);
+        }
+        if (i < size) {
+            uint64_t word = 0;
+            memcpy(&word, data + i, size - i);
+            mix(word);
+        }
+    }
+};
+
+// Reads exactly size bytes, however many bytes each read returns. Returns false at an early end of the stream.
+bool ReadBlock(nvimgcodecIoStreamDesc_t* io_stream, uint8_t* buffer, size_t size)
+{
+    for (size_t filled = 0; filled < size;) {
+        size_t read_nbytes = 0;
+        io_stream->read(io_stream->instance, &read_nbytes, buffer + filled, size - filled);
+        if (read_nbytes == 0)
+            return false;
+        filled += read_nbytes;
+    }
+    return true;
+}
+
+} // namespace
+
+bool GetCodeStreamKey(ICodeStream* code_stream, CodeStreamKey* key)
+{
+    nvimgcodecIoStreamDesc_t* io_stream = code_stream->getInputStreamDesc();
+    size_t size = 0;
+    if (io_stream->size(io_stream->instance, &size) != NVIMGCODEC_STATUS_SUCCESS)
+        return false;
+    KeyHasher hasher{0xcbf29ce484222325ull ^ size, 0x84222325cbf29ce4ull + size};
+
+    void* mapped = nullptr;
+    if (size > 0 && io_stream->map(io_stream->instance, &mapped, 0, size) == NVIMGCODEC_STATUS_SUCCESS && mapped) {
+        hasher.update(static_cast<const uint8_t*>(mapped), size);
+        io_stream->unmap(io_stream->instance, mapped, size);
+    } else {
+        std::vector<uint8_t> buffer(std::min(size, kReadBlockSize));
+        io_stream->seek(io_stream->instance, 0, SEEK_SET);
+        for (size_t offset = 0; offset < size;) {
+            size_t block_size = std::min(buffer.size(), size - offset);
+            if (!ReadBlock(io_stream, buffer.data(), block_size))
+                return false;
+            hasher.update(buffer.data(), block_size);
+            offset += block_size;
+        }
+    }
+    *key = {hasher.hash, hasher.check, size};
+    return true;
+}
+
+bool CodeStreamsEqual(ICodeStream* a, ICodeStream* b)
+{
+    if (a == b)
+        return true;
+    nvimgcodecIoStreamDesc_t* io_streams[2] = {a->getInputStreamDesc(), b->getInputStreamDesc()};
+    size_t sizes[2] = {0, 0};
+    for (int i = 0; i < 2; i++)
+        if (io_streams[i]->size(io_streams[i]->instance, &sizes[i]) != NVIMGCODEC_STATUS_SUCCESS)
+            return false;
+    size_t size = sizes[0];
+    if (size != sizes[1])
+        return false;
+    if (size == 0)
+        return true;
+
+    void* mapped[2] = {nullptr, nullptr};
+    std::vector<uint8_t> buffers[2];
+    for (int i = 0; i < 2; i++) {
+        if (io_streams[i]->map(io_streams[i]->instance, &mapped[i], 0, size) != NVIMGCODEC_STATUS_SUCCESS || !mapped[i]) {
+            mapped[i] = nullptr;
+            buffers[i].resize(std::min(size, kReadBlockSize));
+            io_streams[i]->seek(io_streams[i]->instance, 0, SEEK_SET);
+        }
+    }
+    bool equal = true;
+    for (size_t offset = 0; equal && offset < size;) {
+        // Mapped streams are compared at once, read ones block by block
+        size_t block_size = mapped[0] && mapped[1] ? size : std::min(kReadBlockSize, size - offset);
+        const uint8_t* blocks[2];
+        for (int i = 0; i < 2 && equal; i++) {
+            if (mapped[i]) {
+                blocks[i] = static_cast<const uint8_t*>(mapped[i]) + offset;
+            } else {
+                blocks[i] = buffers[i].data();
+                equal = ReadBlock(io_streams[i], buffers[i].data(), block_size);
+            }
+        }
+        equal = equal && memcmp(blocks[0], blocks[1], block_size) == 0;
+        offset += block_size;
+    }
+    for (int i = 0; i < 2; i++)
+        if (mapped[i])
+            io_streams[i]->unmap(io_streams[i]->instance, mapped[i], size);
+    return equal;
+}
+
+} // namespace nvimgcodec
@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nvimgcodec {
+
+class ICodeStream;
+
+/**
+ * @brief Identifies the contents of a code stream by their size and two independent 64-bit hashes
+ */
+struct CodeStreamKey
+{
+    uint64_t hash;
+    uint64_t check; // Second hash, of another function, compared on a match of the first one
+    size_t size;
+
+    bool operator==(const CodeStreamKey& other) const { return hash == other.hash && check == other.check && size == other.size; }
+};
+
+struct CodeStreamKeyHash
+{
+    size_t operator()(const CodeStreamKey& key) const { return static_cast<size_t>(key.hash); }
+};
+
+/**
+ * @brief Hashes the whole contents of the code stream, mapping it if possible. Returns false if the stream can't be read.
+ */
+bool GetCodeStreamKey(ICodeStream* code_stream, CodeStreamKey* key);
+
+/**
+ * @brief Compares the whole contents of two code streams, mapping them if possible. Returns false if either can't be read.
+ */
+bool CodeStreamsEqual(ICodeStream* a, ICodeStream* b);
+
+} // namespace nvimgcodec
@@ -134,4 +134,37 @@ void Codec::unregisterDecoderFactory(const std::string decoder_id)
     }
 }
 
+int Codec::getTransformersNum() const
+{
+    return transformers_.size();
+}
+
+const nvimgcodecTransformerDesc_t* Codec::getTransformerDesc(int index) const
+{
+    if (size_t(index) >= transformers_.size()) {
+        return nullptr;
+    }
+    auto it = transformers_.begin();
+    for (int i = 0; i < index; ++i)
+        it++;
+    return it != transformers_.end() ? it->second : nullptr;
+}
+
+void Codec::registerTransformer(const nvimgcodecTransformerDesc_t* desc, float priority)
+{
+    NVIMGCODEC_LOG_TRACE(logger_, "Codec::registerTransformer");
+    transformers_.emplace(priority, desc);
+}
+
+void Codec::unregisterTransformer(const std::string transformer_id)
+{
+    NVIMGCODEC_LOG_TRACE(logger_, "Codec::unregisterTransformer");
+    for (auto it = transformers_.begin(); it != transformers_.end(); ++it) {
+        if (transformer_id == it->second->id) {
+            transformers_.erase(it);
+            return;
+        }
+    }
+}
+
 } // namespace nvimgcodec
@@ -50,6 +50,10 @@ class Codec : public ICodec
     void unregisterDecoderFactory(const std::string decoder_id) override;
     void registerParserFactory(std::unique_ptr<IImageParserFactory> factory, float priority) override;
     void unregisterParserFactory(const std::string parser_id) override;
+    int getTransformersNum() const override;
+    const nvimgcodecTransformerDesc_t* getTransformerDesc(int index) const override;
+    void registerTransformer(const nvimgcodecTransformerDesc_t* desc, float priority) override;
+    void unregisterTransformer(const std::string transformer_id) override;
 
   private:
     ILogger* logger_;
@@ -57,5 +61,6 @@ class Codec : public ICodec
     std::multimap<float, std::unique_ptr<IImageParserFactory>> parsers_;
     std::multimap<float, std::unique_ptr<IImageEncoderFactory>> encoders_;
     std::multimap<float, std::unique_ptr<IImageDecoderFactory>> decoders_;
+    std::multimap<float, const nvimgcodecTransformerDesc_t*> transformers_;
 };
 } // namespace nvimgcodec
@@ -0,0 +1,498 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "color_management.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "parsers/byte_io.h"
+
+namespace nvimgcodec {
+
+namespace {
+
+// https://www.color.org/specification/ICC.1-2022-05.pdf
+
+constexpr uint32_t Signature(const char (&s)[5])
+{
+    return (uint32_t(uint8_t(s[0])) << 24) | (uint32_t(uint8_t(s[1])) << 16) | (uint32_t(uint8_t(s[2])) << 8) | uint32_t(uint8_t(s[3]));
+}
+
+constexpr size_t kHeaderSize = 128;
+constexpr size_t kTagEntrySize = 12;
+// Number of samples of the tone curves which are not given as a table
+constexpr size_t kCurveSize = 4096;
+// Number of segments of the shaper curves
+constexpr uint32_t kShaperSegments = 4096;
+
+// D50 illuminant of the profile connection space
+constexpr std::array<double, 3> kD50 = {0.9642, 1.0, 0.8249};
+
+struct TagData
+{
+    const uint8_t* data;
+    size_t size;
+};
+
+class IccReader
+{
+  public:
+    IccReader(const uint8_t* data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+        if (!data_ || size_ < kHeaderSize + sizeof(uint32_t))
+            throw std::runtime_error("ICC profile too short");
+        size_t declared_size = ReadValueBE<uint32_t>(data_);
+        if (declared_size > size_ || declared_size < kHeaderSize + sizeof(uint32_t))
+            throw std::runtime_error("Invalid ICC profile size");
+        size_ = declared_size;
+        if (ReadValueBE<uint32_t>(data_ + 36) != Signature("acsp"))
+            throw std::runtime_error("Invalid ICC profile signature");
+    }
+
+    uint32_t colorSpace() const { return ReadValueBE<uint32_t>(data_ + 16); }
+    uint32_t pcs() const { return ReadValueBE<uint32_t>(data_ + 20); }
+
+    bool findTag(uint32_t signature, TagData* tag) const
+    {
+        uint32_t tag_count = ReadValueBE<uint32_t>(data_ + kHeaderSize);
+        if (tag_count > (size_ - kHeaderSize - sizeof(uint32_t)) / kTagEntrySize)
+            throw std::runtime_error("Invalid ICC tag count");
+        for (uint32_t i = 0; i < tag_count; i++) {
+            const uint8_t* entry = data_ + kHeaderSize + sizeof(uint32_t) + i * kTagEntrySize;
+            if (ReadValueBE<uint32_t>(entry) != signature)
+                continue;
+            size_t offset = ReadValueBE<uint32_t>(entry + 4);
+            size_t size = ReadValueBE<uint32_t>(entry + 8);
+            if (offset > size_ || size > size_ - offset || size < 8)
+                throw std::runtime_error("Invalid ICC tag");
+            *tag = {data_ + offset, size};
+            return true;
+        }
+        return false;
+    }
+
+    TagData tag(uint32_t signature) const
+    {
+        TagData tag;
+        if (!findTag(signature, &tag))
+            throw std::runtime_error("Missing ICC tag, only matrix/TRC profiles are supported");
+        return tag;
+    }
+
+  private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+double ReadS15Fixed16(const uint8_t* data)
+{
+    return static_cast<int32_t>(ReadValueBE<uint32_t>(data)) / 65536.0;
+}
+
+std::array<double, 3> ParseXYZ(const TagData& tag)
+{
+    if (ReadValueBE<uint32_t>(tag.data) != Signature("XYZ ") || tag.size < 20)
+        throw std::runtime_error("Invalid ICC XYZ tag");
+    return {ReadS15Fixed16(tag.data + 8), ReadS15Fixed16(tag.data + 12), ReadS15Fixed16(tag.data + 16)};
+}
+
+double EvalParametric(int type, const double* p, double x)
+{
+    auto power = [](double base, double exponent) { return std::pow(std::max(base, 0.0), exponent); };
+    const double g = p[0], a = p[1], b = p[2], c = p[3], d = p[4], e = p[5], f = p[6];
+    switch (type) {
+    case 0:
+        return power(x, g);
+    case 1:
+        return x >= -b / a ? power(a * x + b, g) : 0.0;
+    case 2:
+        return x >= -b / a ? power(a * x + b, g) + c : c;
+    case 3:
+        return x >= d ? power(a * x + b, g) : c * x;
+    default:
+        return x >= d ? power(a * x + b, g) + e : c * x + f;
+    }
+}
+
+std::vector<float> SampleParametric(int type, const double* params)
+{
+    std::vector<float> curve(kCurveSize);
+    for (size_t i = 0; i < kCurveSize; i++)
+        curve[i] = static_cast<float>(std::clamp(EvalParametric(type, params, static_cast<double>(i) / (kCurveSize - 1)), 0.0, 1.0));
+    return curve;
+}
+
+std::vector<float> ParseCurve(const TagData& tag)
+{
+    uint32_t type = ReadValueBE<uint32_t>(tag.data);
+    if (type == Signature("curv") && tag.size >= 12) {
+        uint32_t count = ReadValueBE<uint32_t>(tag.data + 8);
+        if (count > (tag.size - 12) / 2)
+            throw std::runtime_error("Invalid ICC curve");
+        if (count == 0)
+            return {0.0f, 1.0f};
+        if (count == 1) {
+            double params[7] = {ReadValueBE<uint16_t>(tag.data + 12) / 256.0};
+            return SampleParametric(0, params);
+        }
+        std::vector<float> curve(count);
+        for (uint32_t i = 0; i < count; i++)
+            curve[i] = ReadValueBE<uint16_t>(tag.data + 12 + 2 * i) / 65535.0f;
+        return curve;
+    } else if (type == Signature("para") && tag.size >= 12) {
+        static constexpr int num_params[] = {1, 3, 4, 5, 7};
+        uint16_t function_type = ReadValueBE<uint16_t>(tag.data + 8);
+        if (function_type > 4 || tag.size < 12 + 4 * static_cast<size_t>(num_params[function_type]))
+            throw std::runtime_error("Invalid ICC parametric curve");
+        double params[7] = {};
+        for (int i = 0; i < num_params[function_type]; i++)
+            params[i] = ReadS15Fixed16(tag.data + 12 + 4 * i);
+        return SampleParametric(function_type, params);
+    }
+    throw std::runtime_error("Unsupported ICC curve type");
+}
+
+double EvalCurve(const std::vector<float>& curve, double x)
+{
+    double pos = std::clamp(x, 0.0, 1.0) * (curve.size() - 1);
+    size_t i = std::min(static_cast<size_t>(pos), curve.size() - 2);
+    double t = pos - i;
+    return curve[i] + t * (curve[i + 1] - curve[i]);
+}
+
+// Inverse of a non-decreasing curve
+double EvalInverseCurve(const std::vector<float>& curve, double y)
+{
+    if (y <= curve.front())
+        return 0.0;
+    if (y >= curve.back())
+        return 1.0;
+    size_t i = std::lower_bound(curve.begin(), curve.end(), static_cast<float>(y)) - curve.begin();
+    if (i == 0)
+        return 0.0;
+    double lo = curve[i - 1], hi = curve[i];
+    double t = hi > lo ? (y - lo) / (hi - lo) : 0.0;
+    return std::clamp((i - 1 + t) / (curve.size() - 1), 0.0, 1.0);
+}
+
+using Matrix3 = std::array<std::array<double, 3>, 3>;
+
+Matrix3 Invert(const Matrix3& m)
+{
+    double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                 m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    if (std::abs(det) < 1e-12)
+        throw std::runtime_error("ICC profile matrix is not invertible");
+    Matrix3 inv;
+    inv[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) / det;
+    inv[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) / det;
+    inv[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) / det;
+    inv[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) / det;
+    inv[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) / det;
+    inv[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) / det;
+    inv[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) / det;
+    inv[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) / det;
+    inv[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) / det;
+    return inv;
+}
+
+std::array<double, 3> Multiply(const Matrix3& m, const std::array<double, 3>& v)
+{
+    return {m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2], m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2],
+        m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2]};
+}
+
+uint64_t Hash(const uint8_t* data, size_t size)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+IccProfile ParseIccProfile(const uint8_t* data, size_t size)
+{
+    IccReader reader(data, size);
+    if (reader.pcs() != Signature("XYZ "))
+        throw std::runtime_error("Unsupported ICC profile connection space, only matrix/TRC profiles are supported");
+
+    IccProfile profile;
+    if (reader.colorSpace() == Signature("RGB ")) {
+        auto r = ParseXYZ(reader.tag(Signature("rXYZ")));
+        auto g = ParseXYZ(reader.tag(Signature("gXYZ")));
+        auto b = ParseXYZ(reader.tag(Signature("bXYZ")));
+        for (int i = 0; i < 3; i++)
+            profile.to_xyz[i] = {r[i], g[i], b[i]};
+        profile.trc[0] = ParseCurve(reader.tag(Signature("rTRC")));
+        profile.trc[1] = ParseCurve(reader.tag(Signature("gTRC")));
+        profile.trc[2] = ParseCurve(reader.tag(Signature("bTRC")));
+    } else if (reader.colorSpace() == Signature("GRAY")) {
+        for (int i = 0; i < 3; i++)
+            profile.to_xyz[i] = {kD50[i] / 3, kD50[i] / 3, kD50[i] / 3};
+        auto curve = ParseCurve(reader.tag(Signature("kTRC")));
+        profile.trc = {curve, curve, curve};
+    } else {
+        throw std::runtime_error("Unsupported ICC profile color space");
+    }
+    return profile;
+}
+
+const IccProfile& SrgbProfile()
+{
+    static const IccProfile srgb = []() {
+        IccProfile profile;
+        // Primaries adapted to D50, as in the ICC sRGB profile
+        profile.to_xyz = {{{0.4360747, 0.3850649, 0.1430804}, {0.2225045, 0.7168786, 0.0606169}, {0.0139322, 0.0971045, 0.7141733}}};
+        const double params[7] = {2.4, 1 / 1.055, 0.055 / 1.055, 1 / 12.92, 0.04045};
+        auto curve = SampleParametric(3, params);
+        profile.trc = {curve, curve, curve};
+        return profile;
+    }();
+    return srgb;
+}
+
+ColorTransform::ColorTransform(const IccProfile& src, const IccProfile& dst, int lut_size)
+    : lut_size_(lut_size)
+{
+    if (lut_size_ < 2 || lut_size_ > 65)
+        throw std::runtime_error("Invalid color lookup table size");
+    Matrix3 from_xyz = Invert(dst.to_xyz);
+    for (int c = 0; c < 3; c++) {
+        shapers_[c].resize(kShaperSegments + 1);
+        for (uint32_t i = 0; i <= kShaperSegments; i++) {
+            double value = EvalInverseCurve(dst.trc[c], EvalCurve(src.trc[c], static_cast<double>(i) / kShaperSegments));
+            shapers_[c][i] = static_cast<uint32_t>(std::lround(value * ((lut_size_ - 1) << 16)));
+        }
+    }
+
+    // Grid nodes are in the target encoding, so the source linear values are given by the target tone curves
+    lut_.resize(static_cast<size_t>(lut_size_) * lut_size_ * lut_size_ * 3);
+    uint16_t* node = lut_.data();
+    for (int r = 0; r < lut_size_; r++) {
+        for (int g = 0; g < lut_size_; g++) {
+            for (int b = 0; b < lut_size_; b++, node += 3) {
+                std::array<int, 3> idx = {r, g, b};
+                std::array<double, 3> linear;
+                for (int c = 0; c < 3; c++)
+                    linear[c] = EvalCurve(dst.trc[c], static_cast<double>(idx[c]) / (lut_size_ - 1));
+                auto dst_linear = Multiply(from_xyz, Multiply(src.to_xyz, linear));
+                for (int c = 0; c < 3; c++) {
+                    double value = EvalInverseCurve(dst.trc[c], std::clamp(dst_linear[c], 0.0, 1.0));
+                    node[c] = static_cast<uint16_t>(std::lround(value * 65535));
+                }
+            }
+        }
+    }
+}
+
+bool ColorTransform::isSupported(const nvimgcodecImageInfo_t& image_info)
+{
+    auto& plane = image_info.plane_info[0];
+    if (plane.sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 && plane.sample_type != NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16)
+        return false;
+    switch (image_info.sample_format) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
+        return image_info.num_planes == 1 && plane.num_channels >= 3;
+    case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_P_BGR:
+        if (image_info.num_planes < 3)
+            return false;
+        for (int p = 0; p < 3; p++) {
+            auto& other = image_info.plane_info[p];
+            if (other.num_channels != 1 || other.sample_type != plane.sample_type || other.width != plane.width ||
+                other.height != plane.height)
+                return false;
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+template <typename T>
+void ColorTransform::applyRow(T* r, T* g, T* b, ptrdiff_t step, uint32_t width) const
+{
+    constexpr uint64_t max_value = std::numeric_limits<T>::max();
+    const uint32_t n = lut_size_;
+    const ptrdiff_t stride_r = 3 * n * n, stride_g = 3 * n, stride_b = 3;
+    // Position in the grid, in 16.16 fixed point, interpolated from the shaper curve
+    auto grid_pos = [](const std::vector<uint32_t>& shaper, uint64_t value) {
+        uint32_t t = static_cast<uint32_t>((value * (static_cast<uint64_t>(kShaperSegments) << 16)) / max_value);
+        uint32_t i = std::min(t >> 16, kShaperSegments - 1);
+        int64_t f = t - (i << 16);
+        return static_cast<uint32_t>(shaper[i] + ((f * (static_cast<int64_t>(shaper[i + 1]) - shaper[i])) >> 16));
+    };
+    for (uint32_t x = 0; x < width; x++, r += step, g += step, b += step) {
+        // The last node is reached with a fraction of 1
+        uint32_t pos_r = grid_pos(shapers_[0], *r), pos_g = grid_pos(shapers_[1], *g), pos_b = grid_pos(shapers_[2], *b);
+        uint32_t ir = std::min(pos_r >> 16, n - 2), ig = std::min(pos_g >> 16, n - 2), ib = std::min(pos_b >> 16, n - 2);
+        int64_t fr = pos_r - (ir << 16), fg = pos_g - (ig << 16), fb = pos_b - (ib << 16);
+
+        // Tetrahedron containing the point, walking from the first to the last node of the cube along
+        // the dimensions sorted by decreasing fraction
+        ptrdiff_t step1, step2;
+        int64_t f1, f2, f3;
+        if (fr >= fg) {
+            if (fg >= fb) {
+                step1 = stride_r, step2 = stride_g, f1 = fr, f2 = fg, f3 = fb;
+            } else if (fr >= fb) {
+                step1 = stride_r, step2 = stride_b, f1 = fr, f2 = fb, f3 = fg;
+            } else {
+                step1 = stride_b, step2 = stride_r, f1 = fb, f2 = fr, f3 = fg;
+            }
+        } else {
+            if (fr >= fb) {
+                step1 = stride_g, step2 = stride_r, f1 = fg, f2 = fr, f3 = fb;
+            } else if (fg >= fb) {
+                step1 = stride_g, step2 = stride_b, f1 = fg, f2 = fb, f3 = fr;
+            } else {
+                step1 = stride_b, step2 = stride_g, f1 = fb, f2 = fg, f3 = fr;
+            }
+        }
+        const uint16_t* c0 = lut_.data() + ir * stride_r + ig * stride_g + ib * stride_b;
+        const uint16_t* c1 = c0 + step1;
+        const uint16_t* c2 = c1 + step2;
+        const uint16_t* c3 = c0 + stride_r + stride_g + stride_b;
+
+        T out[3];
+        for (int c = 0; c < 3; c++) {
+            int64_t value = (static_cast<int64_t>(c0[c]) << 16) + f1 * (c1[c] - c0[c]) + f2 * (c2[c] - c1[c]) + f3 * (c3[c] - c2[c]);
+            value = (value + (1 << 15)) >> 16;
+            if constexpr (sizeof(T) == 1)
+                out[c] = static_cast<T>((value * 255 + 32767) / 65535);
+            else
+                out[c] = static_cast<T>(value);
+        }
+        *r = out[0];
+        *g = out[1];
+        *b = out[2];
+    }
+}
+
+template <typename T>
+void ColorTransform::applyImage(const nvimgcodecImageInfo_t& image_info) const
+{
+    auto* buffer = static_cast<uint8_t*>(image_info.buffer);
+    auto& plane = image_info.plane_info[0];
+    bool bgr = image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_I_BGR || image_info.sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR;
+    if (image_info.num_planes == 1) {
+        for (uint32_t y = 0; y < plane.height; y++) {
+            T* row = reinterpret_cast<T*>(buffer + y * plane.row_stride);
+            applyRow(row + (bgr ? 2 : 0), row + 1, row + (bgr ? 0 : 2), plane.num_channels, plane.width);
+        }
+    } else {
+        uint8_t* planes[3];
+        size_t offset = 0;
+        for (int p = 0; p < 3; p++) {
+            planes[p] = buffer + offset;
+            offset += image_info.plane_info[p].row_stride * image_info.plane_info[p].height;
+        }
+        if (bgr)
+            std::swap(planes[0], planes[2]);
+        for (uint32_t y = 0; y < plane.height; y++) {
+            applyRow(reinterpret_cast<T*>(planes[0] + y * image_info.plane_info[0].row_stride),
+                reinterpret_cast<T*>(planes[1] + y * image_info.plane_info[1].row_stride),
+                reinterpret_cast<T*>(planes[2] + y * image_info.plane_info[2].row_stride), 1, plane.width);
+        }
+    }
+}
+
+void ColorTransform::apply(const nvimgcodecImageInfo_t& image_info) const
+{
+    if (!isSupported(image_info))
+        throw std::runtime_error("Unsupported image layout for color management");
+    if (image_info.plane_info[0].sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8)
+        applyImage<uint8_t>(image_info);
+    else
+        applyImage<uint16_t>(image_info);
+}
+
+bool ColorTransformCache::Key::matches(uint64_t src_hash, const uint8_t* src_data, size_t src_size, uint64_t dst_hash,
+    const uint8_t* dst_data, size_t dst_size, int lut_size) const
+{
+    // Hashes are compared first, the bytes only on a match
+    return this->src_hash == src_hash && this->dst_hash == dst_hash && this->lut_size == lut_size && src_profile.size() == src_size &&
+           std::equal(src_profile.begin(), src_profile.end(), src_data) && dst_profile.size() == (dst_data ? dst_size : 0) &&
+           (!dst_data || std::equal(dst_profile.begin(), dst_profile.end(), dst_data));
+}
+
+ColorTransformCache::ColorTransformCache(size_t capacity)
+    : capacity_(capacity)
+{
+}
+
+std::shared_ptr<const ColorTransform> ColorTransformCache::get(
+    const uint8_t* src_profile, size_t src_size, const uint8_t* dst_profile, size_t dst_size, int lut_size)
+{
+    uint64_t src_hash = Hash(src_profile, src_size);
+    uint64_t dst_hash = dst_profile ? Hash(dst_profile, dst_size) : 0;
+    lut_size = lut_size > 0 ? lut_size : kDefaultLutSize;
+    auto matches = [&](auto& entry) {
+        return entry.first.matches(src_hash, src_profile, src_size, dst_hash, dst_profile, dst_size, lut_size);
+    };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(entries_.begin(), entries_.end(), matches);
+        if (it != entries_.end()) {
+            entries_.splice(entries_.begin(), entries_, it);
+            return it->second;
+        }
+    }
+
+    // Built without holding the lock, two threads may occasionally build the same transform
+    std::shared_ptr<const ColorTransform> transform;
+    std::exception_ptr error;
+    try {
+        auto src = ParseIccProfile(src_profile, src_size);
+        if (dst_profile) {
+            auto dst = ParseIccProfile(dst_profile, dst_size);
+            transform = std::make_shared<ColorTransform>(src, dst, lut_size);
+        } else {
+            transform = std::make_shared<ColorTransform>(src, SrgbProfile(), lut_size);
+        }
+    } catch (const std::runtime_error&) {
+        // Remembered as nullptr, so that unsupported profiles are not parsed again
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (std::none_of(entries_.begin(), entries_.end(), matches)) {
+            Key key{src_hash, dst_hash, lut_size, std::vector<uint8_t>(src_profile, src_profile + src_size),
+                dst_profile ? std::vector<uint8_t>(dst_profile, dst_profile + dst_size) : std::vector<uint8_t>()};
+            entries_.emplace_front(std::move(key), transform);
+            if (entries_.size() > capacity_)
+                entries_.pop_back();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+    return transform;
+}
+
+} // namespace nvimgcodec
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nvimgcodec {
+
+/**
+ * @brief Matrix/TRC ICC profile, mapping device values to the D50 XYZ profile connection space.
+ *
+ * Gray profiles are represented as RGB profiles whose channels all map to the white point, so that they apply to
+ * gray images decoded to RGB.
+ */
+struct IccProfile
+{
+    std::array<std::array<double, 3>, 3> to_xyz; // Linear device values to XYZ, colorants in columns
+    std::array<std::vector<float>, 3> trc;       // Tone curve of each channel, sampled uniformly over [0, 1]
+};
+
+/**
+ * @brief Parses an RGB or gray matrix/TRC ICC profile.
+ *
+ * Throws std::runtime_error if the profile is invalid or is not a matrix/TRC profile, e.g. when it is LUT based.
+ */
+IccProfile ParseIccProfile(const uint8_t* data, size_t size);
+
+/**
+ * @brief Returns the sRGB (IEC 61966-2.1) profile.
+ */
+const IccProfile& SrgbProfile();
+
+/**
+ * @brief Conversion between two profiles, sampled into a 3D lookup table.
+ *
+ * Each channel first goes through a 1D shaper curve, mapping the source tone curve to the target one, so that the grid
+ * is uniform in the target encoding and the gray axis is reproduced exactly. The table holds lut_size^3 16-bit RGB nodes
+ * and is applied with tetrahedral interpolation in fixed point.
+ */
+class ColorTransform
+{
+  public:
+    ColorTransform(const IccProfile& src, const IccProfile& dst, int lut_size);
+
+    /**
+     * @brief Tells whether apply supports the layout of the image. Supported are 8 and 16-bit RGB and BGR images.
+     */
+    static bool isSupported(const nvimgcodecImageInfo_t& image_info);
+
+    /**
+     * @brief Converts the image in place. The buffer has to be in host memory.
+     */
+    void apply(const nvimgcodecImageInfo_t& image_info) const;
+
+    int lutSize() const { return lut_size_; }
+
+  private:
+    template <typename T>
+    void applyRow(T* r, T* g, T* b, ptrdiff_t step, uint32_t width) const;
+
+    template <typename T>
+    void applyImage(const nvimgcodecImageInfo_t& image_info) const;
+
+    int lut_size_;
+    std::array<std::vector<uint32_t>, 3> shapers_; // Position in the grid, in 16.16 fixed point, sampled uniformly over [0, 1]
+    std::vector<uint16_t> lut_;                    // Indexed by (r * lut_size + g) * lut_size + b, 3 values per node
+};
+
+/**
+ * @brief Transforms built so far, keyed by the source and target profiles and the table size.
+ *
+ * Profiles are looked up by hash and their bytes compared on a match, so that colliding profiles don't share a transform.
+ * Only the most recently used transforms are kept. Thread safe.
+ */
+class ColorTransformCache
+{
+  public:
+    static constexpr int kDefaultLutSize = 33;
+
+    explicit ColorTransformCache(size_t capacity = 16);
+
+    /**
+     * @brief Returns the transform from the source profile to the target one, building it if needed.
+     *
+     * Target profile set to nullptr means sRGB, lut_size set to 0 means kDefaultLutSize.
+     * Throws if a profile is unsupported, and returns nullptr when asked for the same pair again.
+     */
+    std::shared_ptr<const ColorTransform> get(
+        const uint8_t* src_profile, size_t src_size, const uint8_t* dst_profile, size_t dst_size, int lut_size);
+
+  private:
+    struct Key
+    {
+        uint64_t src_hash;
+        uint64_t dst_hash;
+        int lut_size;
+        std::vector<uint8_t> src_profile;
+        std::vector<uint8_t> dst_profile; // Empty for sRGB
+
+        bool matches(uint64_t src_hash, const uint8_t* src_data, size_t src_size, uint64_t dst_hash, const uint8_t* dst_data,
+            size_t dst_size, int lut_size) const;
+    };
+
+    std::mutex mutex_;
+    size_t capacity_;
+    std::list<std::pair<Key, std::shared_ptr<const ColorTransform>>> entries_; // Most recently used first
+};
+
+} // namespace nvimgcodec
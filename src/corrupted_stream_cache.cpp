@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "corrupted_stream_cache.h"
+
+namespace nvimgcodec {
+
+const nvimgcodecCorruptedStreamParams_t* GetCorruptedStreamParams(const nvimgcodecDecodeParams_t* params)
+{
+    auto* ext = static_cast<const nvimgcodecCorruptedStreamParams_t*>(params ? params->struct_next : nullptr);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_CORRUPTED_STREAM_PARAMS)
+        ext = static_cast<const nvimgcodecCorruptedStreamParams_t*>(ext->struct_next);
+    return ext;
+}
+
+CorruptedStreamCache::CorruptedStreamCache(size_t capacity)
+    : capacity_(capacity)
+{
+}
+
+bool CorruptedStreamCache::empty()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_.empty();
+}
+
+bool CorruptedStreamCache::contains(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return keys_.count(key) > 0;
+}
+
+void CorruptedStreamCache::insert(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || !keys_.insert(key).second)
+        return;
+    order_.push_back(key);
+    if (order_.size() > capacity_) {
+        keys_.erase(order_.front());
+        order_.pop_front();
+    }
+}
+
+} // namespace nvimgcodec
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include "code_stream_key.h"
+
+namespace nvimgcodec {
+
+/**
+ * @brief Returns the corrupted code stream handling parameters chained to the decode parameters, or nullptr
+ */
+const nvimgcodecCorruptedStreamParams_t* GetCorruptedStreamParams(const nvimgcodecDecodeParams_t* params);
+
+/**
+ * @brief Contents of code streams found corrupted, identified by their size and two independent hashes.
+ *
+ * Only the most recently added contents are kept. Thread safe.
+ */
+class CorruptedStreamCache
+{
+  public:
+    using Key = CodeStreamKey;
+
+    explicit CorruptedStreamCache(size_t capacity = 4096);
+
+    bool empty();
+    bool contains(const Key& key);
+    void insert(const Key& key);
+
+  private:
+    std::mutex mutex_;
+    size_t capacity_;
+    std::unordered_set<Key, CodeStreamKeyHash> keys_;
+    std::deque<Key> order_; // Oldest first
+};
+
+} // namespace nvimgcodec
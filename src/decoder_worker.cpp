@@ -16,10 +16,21 @@
  */
 #include "decoder_worker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <string_view>
 
 #include <nvtx3/nvtx3.hpp>
 #include <imgproc/device_guard.h>
+#include "color_management.h"
+#include "corrupted_stream_cache.h"
+#include "icode_stream.h"
 #include "icodec.h"
 #include "iimage_decoder_factory.h"
 #include "log.h"
@@ -27,13 +38,16 @@
 namespace nvimgcodec {
 
 DecoderWorker::DecoderWorker(ILogger* logger, IWorkManager<nvimgcodecDecodeParams_t>* work_manager,
-    const nvimgcodecExecutionParams_t* exec_params, const std::string& options, const ICodec* codec, int index)
+    const nvimgcodecExecutionParams_t* exec_params, const std::string& options, const ICodec* codec, int index,
+    ColorTransformCache* color_transforms, CorruptedStreamCache* corrupted_streams)
     : logger_(logger)
     , work_manager_(work_manager)
     , codec_(codec)
     , index_(index)
     , exec_params_(exec_params)
     , options_(options)
+    , color_transforms_(color_transforms)
+    , corrupted_streams_(corrupted_streams)
 {
     if (exec_params_->pre_init) {
         DecoderWorker* current = this;
@@ -54,7 +68,8 @@ DecoderWorker* DecoderWorker::getFallback()
     if (!fallback_) {
         int n = codec_->getDecodersNum();
         if (index_ + 1 < n) {
-            fallback_ = std::make_unique<DecoderWorker>(logger_, work_manager_, exec_params_, options_, codec_, index_ + 1);
+            fallback_ = std::make_unique<DecoderWorker>(
+                logger_, work_manager_, exec_params_, options_, codec_, index_ + 1, color_transforms_, corrupted_streams_);
         }
     }
     return fallback_.get();
@@ -155,6 +170,116 @@ void DecoderWorker::addWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work
     }
 }
 
+static bool has_band_output(IImage* image);
+
+static const nvimgcodecColorManagementParams_t* get_color_management_params(const nvimgcodecDecodeParams_t* params)
+{
+    auto* ext = static_cast<const nvimgcodecColorManagementParams_t*>(params ? params->struct_next : nullptr);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS)
+        ext = static_cast<const nvimgcodecColorManagementParams_t*>(ext->struct_next);
+    return ext;
+}
+
+void DecoderWorker::convertColors(IImage* image, ICodeStream* code_stream, const nvimgcodecColorManagementParams_t* color_params)
+{
+    nvtx3::scoped_range marker{"convertColors"};
+    try {
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image->getImageInfo(&image_info);
+        if (image_info.buffer_kind != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST) {
+            NVIMGCODEC_LOG_WARNING(logger_, "Color management skipped, the image was decoded to device memory");
+            return;
+        }
+        if (has_band_output(image)) {
+            NVIMGCODEC_LOG_WARNING(logger_, "Color management skipped, the image was decoded to row bands");
+            return;
+        }
+        if (!ColorTransform::isSupported(image_info)) {
+            NVIMGCODEC_LOG_DEBUG(logger_, "Color management skipped, unsupported sample format or type");
+            return;
+        }
+
+        const auto& icc_profile = code_stream->getIccProfile();
+        if (icc_profile.empty())
+            return;
+        auto transform = color_transforms_->get(icc_profile.data(), icc_profile.size(), color_params->target_profile,
+            color_params->target_profile_size, color_params->lut_size);
+        if (!transform)
+            return;
+        if (is_device_output_) // decoded on the device and copied back asynchronously
+            CHECK_CUDA(cudaStreamSynchronize(image_info.cuda_stream));
+        transform->apply(image_info);
+    } catch (const std::exception& e) {
+        NVIMGCODEC_LOG_WARNING(logger_, "Color management skipped - " << e.what());
+    }
+}
+
+/**
+ * @brief Color conversions of a (sub)batch, running on the executor while the worker processes further results
+ */
+struct DecoderWorker::ColorConversions
+{
+    struct Sample
+    {
+        ColorConversions* conversions;
+        int sub_idx;
+        ProcessingResult result;
+    };
+
+    DecoderWorker* worker;
+    Work<nvimgcodecDecodeParams_t>* work;
+    const nvimgcodecColorManagementParams_t* params;
+    std::deque<Sample> samples; // Stable addresses, passed to the tasks
+    std::mutex work_mutex;      // Guards the buffers of the work, which failed samples are moved out of meanwhile
+    std::mutex mutex;
+    std::condition_variable cv;
+    int pending = 0;
+
+    void launch(int sub_idx, ProcessingResult result)
+    {
+        samples.push_back(Sample{this, sub_idx, std::move(result)});
+        auto& sample = samples.back();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending++;
+        }
+        auto executor = worker->exec_params_->executor;
+        if (executor->launch(executor->instance, worker->exec_params_->device_id, sub_idx, &sample, &DecoderWorker::convertColorsTask) !=
+            NVIMGCODEC_STATUS_SUCCESS)
+            convertColorsTask(-1, sub_idx, &sample);
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this]() { return pending == 0; });
+    }
+};
+
+void DecoderWorker::convertColorsTask(int /*tid*/, int /*sample_idx*/, void* context)
+{
+    auto sample = static_cast<ColorConversions::Sample*>(context);
+    auto conversions = sample->conversions;
+    auto worker = conversions->worker;
+    auto work = conversions->work;
+    worker->convertColors(work->images_[sample->sub_idx], work->code_streams_[sample->sub_idx], conversions->params);
+    // Decoded to host memory, the image is copied to its device buffer once converted
+    if (!worker->is_device_output_) {
+        std::lock_guard<std::mutex> lock(conversions->work_mutex);
+        work->copy_buffer_if_necessary(false, sample->sub_idx, &sample->result);
+    }
+    // The result is set last, as the decoder may be destroyed as soon as the batch is complete
+    auto results = work->results_;
+    int index = work->indices_[sample->sub_idx];
+    auto result = std::move(sample->result);
+    {
+        std::lock_guard<std::mutex> lock(conversions->mutex);
+        if (--conversions->pending == 0)
+            conversions->cv.notify_all();
+    }
+    results.set(index, std::move(result));
+}
+
 void DecoderWorker::processCurrentResults(
     std::unique_ptr<Work<nvimgcodecDecodeParams_t>> curr_work, std::unique_ptr<ProcessingResultsFuture> curr_results, bool immediate)
 {
@@ -162,6 +287,9 @@ void DecoderWorker::processCurrentResults(
     assert(curr_results);
     std::unique_ptr<Work<nvimgcodecDecodeParams_t>> fallback_work;
     auto fallback_worker = getFallback();
+    auto color_params = color_transforms_ ? get_color_management_params(curr_work->params_) : nullptr;
+    auto corrupted_params = GetCorruptedStreamParams(curr_work->params_);
+    ColorConversions color_conversions{this, curr_work.get(), color_params};
     for (;;) {
         auto indices = curr_results->waitForNew();
         if (indices.second == 0)
@@ -173,20 +301,40 @@ void DecoderWorker::processCurrentResults(
             if (r.isSuccess()) {
                 NVIMGCODEC_LOG_INFO(logger_, "[" << decoder_->decoderId() << "]"
                                                  << " decode #" << sub_idx << " success");
-                curr_work->copy_buffer_if_necessary(is_device_output_, sub_idx, &r);
+                if (color_params) {
+                    // Colors are converted in host memory, before a copy to the device or after a copy from it
+                    if (is_device_output_) {
+                        std::lock_guard<std::mutex> lock(color_conversions.work_mutex);
+                        curr_work->copy_buffer_if_necessary(true, sub_idx, &r);
+                    }
+                    if (r.isSuccess()) {
+                        color_conversions.launch(sub_idx, std::move(r));
+                        continue;
+                    }
+                } else {
+                    curr_work->copy_buffer_if_necessary(is_device_output_, sub_idx, &r);
+                }
                 curr_work->results_.set(curr_work->indices_[sub_idx], r);
             } else { // failed to decode
                 NVIMGCODEC_LOG_INFO(logger_, "[" << decoder_->decoderId() << "]"
                                                  << " decode #" << sub_idx << " failure with code " << r.status_);
-                if (fallback_worker) {
+                bool corrupted = r.status_ == NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED;
+                bool stop_fallback = corrupted && corrupted_params && corrupted_params->stop_fallback;
+                if (fallback_worker && !stop_fallback) {
                     // if there's fallback, we don't set the result, but try to use the fallback first
                     NVIMGCODEC_LOG_WARNING(logger_, "[" << decoder_->decoderId() << "]"
                                                      << " decode #" << sub_idx << " fallback");
                     if (!fallback_work) 
                         fallback_work = work_manager_->createNewWork(curr_work->results_, curr_work->params_);
+                    std::lock_guard<std::mutex> lock(color_conversions.work_mutex);
                     fallback_work->moveEntry(curr_work.get(), sub_idx);
                 } else {
                     // no fallback - just propagate the result to the original promise
+                    if (corrupted && corrupted_params && corrupted_params->remember_corrupted && corrupted_streams_) {
+                        CorruptedStreamCache::Key key;
+                        if (GetCodeStreamKey(curr_work->code_streams_[sub_idx], &key))
+                            corrupted_streams_->insert(key);
+                    }
                     curr_work->results_.set(curr_work->indices_[sub_idx], r);
                 }
             }
@@ -195,6 +343,7 @@ void DecoderWorker::processCurrentResults(
         if (fallback_work && !fallback_work->empty())
             fallback_worker->addWork(std::move(fallback_work), immediate);
     }
+    color_conversions.wait();
     work_manager_->recycleWork(std::move(curr_work));
 }
 
@@ -214,6 +363,16 @@ void DecoderWorker::updateCurrentWork(std::unique_ptr<Work<nvimgcodecDecodeParam
     start();
 }
 
+static bool has_band_output(IImage* image)
+{
+    nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(&image_info);
+    auto* ext = static_cast<const nvimgcodecBandOutput_t*>(image_info.struct_next);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT)
+        ext = static_cast<const nvimgcodecBandOutput_t*>(ext->struct_next);
+    return ext != nullptr;
+}
+
 static void move_work_to_fallback(Work<nvimgcodecDecodeParams_t>* fb, Work<nvimgcodecDecodeParams_t>* work, const std::vector<bool>& keep)
 {
     int moved = 0;
@@ -232,6 +391,8 @@ static void move_work_to_fallback(Work<nvimgcodecDecodeParams_t>* fb, Work<nvimg
                     work->idx2orig_buffer_[i - moved] = std::move(work->idx2orig_buffer_[i]);
                 if (!work->code_streams_.empty())
                     work->code_streams_[i - moved] = work->code_streams_[i];
+                if (!work->signatures_.empty())
+                    work->signatures_[i - moved] = std::move(work->signatures_[i]);
                 work->indices_[i - moved] = work->indices_[i];
             }
         } else {
@@ -249,6 +410,239 @@ static void filter_work(Work<nvimgcodecDecodeParams_t>* work, const std::vector<
     move_work_to_fallback(nullptr, work, keep);
 }
 
+// Maximum number of sample signatures whose canDecode status is remembered, per decoder
+static constexpr size_t kMaxCanDecodeCacheSize = 1024;
+
+namespace {
+
+// Common header of extension structures
+struct ExtensionHeader
+{
+    nvimgcodecStructureType_t struct_type;
+    size_t struct_size;
+    const ExtensionHeader* struct_next;
+};
+
+} // namespace
+
+/**
+ * @brief Properties of a sample which decoders base their canDecode decision on
+ *
+ * Buffers and streams are left out, so that samples of the same kind share the signature.
+ */
+static std::string sample_signature(ICodeStream* code_stream, IImage* image, const nvimgcodecDecodeParams_t* params)
+{
+    std::string sig;
+    auto append = [&sig](auto value) { sig.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto append_image_info = [&](const nvimgcodecImageInfo_t& info) {
+        append(info.color_spec);
+        append(info.chroma_subsampling);
+        append(info.sample_format);
+        append(info.orientation.rotated);
+        append(info.orientation.flip_x);
+        append(info.orientation.flip_y);
+        append(info.region.ndim);
+        for (int d = 0; d < std::min(info.region.ndim, NVIMGCODEC_MAX_NUM_DIM); d++) {
+            append(info.region.start[d]);
+            append(info.region.end[d]);
+        }
+        append(info.num_planes);
+        for (uint32_t p = 0; p < std::min<uint32_t>(info.num_planes, NVIMGCODEC_MAX_NUM_PLANES); p++) {
+            const auto& plane = info.plane_info[p];
+            append(plane.width);
+            append(plane.height);
+            append(plane.row_stride);
+            append(plane.num_channels);
+            append(plane.sample_type);
+            append(plane.precision);
+        }
+    };
+
+    nvimgcodecImageInfo_t stream_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    code_stream->getImageInfo(&stream_info);
+    sig.append(stream_info.codec_name, strnlen(stream_info.codec_name, NVIMGCODEC_MAX_CODEC_NAME_SIZE));
+    append_image_info(stream_info);
+    if (strcmp(stream_info.codec_name, "jpeg") == 0) {
+        // JPEG decoders support different encodings
+        nvimgcodecJpegImageInfo_t jpeg_info{NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO, sizeof(nvimgcodecJpegImageInfo_t), nullptr};
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &jpeg_info};
+        code_stream->getImageInfo(&info);
+        append(jpeg_info.encoding);
+    }
+
+    nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(&image_info);
+    append_image_info(image_info);
+    append(image_info.buffer_kind);
+    // Only the kinds of output extensions matter, their contents are specific to each image
+    for (auto* ext = static_cast<const ExtensionHeader*>(image_info.struct_next); ext; ext = ext->struct_next)
+        append(ext->struct_type);
+
+    append(params->apply_exif_orientation);
+    append(params->enable_roi);
+    // Value fields only, so that the same parameters in a rebuilt chain give the same signature
+    for (auto* ext = static_cast<const ExtensionHeader*>(params->struct_next); ext; ext = ext->struct_next) {
+        append(ext->struct_type);
+        switch (ext->struct_type) {
+        case NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS: {
+            auto* cm = reinterpret_cast<const nvimgcodecColorManagementParams_t*>(ext);
+            append(cm->lut_size);
+            append(cm->target_profile_size);
+            if (cm->target_profile)
+                append(std::hash<std::string_view>()(
+                    std::string_view(reinterpret_cast<const char*>(cm->target_profile), cm->target_profile_size)));
+            break;
+        }
+        case NVIMGCODEC_STRUCTURE_TYPE_CORRUPTED_STREAM_PARAMS: {
+            auto* corrupted = reinterpret_cast<const nvimgcodecCorruptedStreamParams_t*>(ext);
+            append(corrupted->validate);
+            append(corrupted->stop_fallback);
+            append(corrupted->remember_corrupted);
+            break;
+        }
+        case NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_PARAMS:
+            append(reinterpret_cast<const nvimgcodecDeduplicationParams_t*>(ext)->enable);
+            break;
+        case NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS: {
+            auto* tiff = reinterpret_cast<const nvimgcodecTiffDecodeParams_t*>(ext);
+            append(tiff->level);
+            append(tiff->target_width);
+            append(tiff->target_height);
+            break;
+        }
+        default:
+            // Unknown to the framework, everything past the header is taken as is
+            if (ext->struct_size > sizeof(ExtensionHeader))
+                sig.append(reinterpret_cast<const char*>(ext + 1), ext->struct_size - sizeof(ExtensionHeader));
+            break;
+        }
+    }
+    return sig;
+}
+
+/**
+ * @brief Tells whether a canDecode status can be remembered for samples with the same signature
+ *
+ * Generic failures might be transient, e.g. a stream which couldn't be read, and corrupted or unsupported streams are
+ * specific to the contents of each stream.
+ */
+static bool is_memoizable_status(nvimgcodecProcessingStatus_t status)
+{
+    return status != NVIMGCODEC_PROCESSING_STATUS_FAIL &&
+           (status & NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED) != NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED &&
+           (status & NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED) != NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED;
+}
+
+void DecoderWorker::canDecode(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
+    const nvimgcodecDecodeParams_t* params, std::vector<bool>* result, std::vector<nvimgcodecProcessingStatus_t>* status)
+{
+    std::vector<std::string> signatures;
+    canDecode(code_streams, images, params, &signatures, result, status);
+}
+
+void DecoderWorker::canDecode(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
+    const nvimgcodecDecodeParams_t* params, std::vector<std::string>* signatures, std::vector<bool>* result,
+    std::vector<nvimgcodecProcessingStatus_t>* status)
+{
+    size_t n = code_streams.size();
+    result->resize(n);
+    status->resize(n);
+
+    // Decoders which look into the streams, e.g. for a compression method, can accept a stream and reject another alike
+    IImageDecoder* decoder = getDecoder();
+    bool memoizable = decoder && decoder->isCanDecodeMemoizable();
+
+    std::vector<size_t> misses;
+    if (memoizable) {
+        signatures->resize(n);
+        for (size_t i = 0; i < n; i++) {
+            if ((*signatures)[i].empty())
+                (*signatures)[i] = sample_signature(code_streams[i], images[i], params);
+        }
+        std::lock_guard lock(can_decode_mutex_);
+        for (size_t i = 0; i < n; i++) {
+            auto it = can_decode_cache_.find((*signatures)[i]);
+            if (it != can_decode_cache_.end())
+                (*status)[i] = it->second;
+            else
+                misses.push_back(i);
+        }
+    } else {
+        misses.resize(n);
+        std::iota(misses.begin(), misses.end(), 0);
+    }
+
+    if (!misses.empty()) {
+        std::vector<ICodeStream*> miss_code_streams(misses.size());
+        std::vector<IImage*> miss_images(misses.size());
+        for (size_t j = 0; j < misses.size(); j++) {
+            miss_code_streams[j] = code_streams[misses[j]];
+            miss_images[j] = images[misses[j]];
+        }
+        std::vector<bool> miss_mask(misses.size());
+        std::vector<nvimgcodecProcessingStatus_t> miss_status(misses.size(), NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED);
+        if (decoder) {
+            decoder->canDecode(miss_code_streams, miss_images, params, &miss_mask, &miss_status);
+            if (is_device_output_) {
+                // Device output goes through a temporary buffer sized for the whole image, so bands can't be produced
+                for (size_t j = 0; j < misses.size(); j++) {
+                    if (has_band_output(miss_images[j]))
+                        miss_status[j] |= NVIMGCODEC_PROCESSING_STATUS_BAND_OUTPUT_UNSUPPORTED;
+                }
+            }
+        }
+
+        for (size_t j = 0; j < misses.size(); j++)
+            (*status)[misses[j]] = miss_status[j];
+
+        if (memoizable) {
+            std::lock_guard lock(can_decode_mutex_);
+            if (can_decode_cache_.size() + misses.size() > kMaxCanDecodeCacheSize)
+                can_decode_cache_.clear();
+            for (size_t j = 0; j < misses.size(); j++) {
+                if (is_memoizable_status(miss_status[j]))
+                    can_decode_cache_.emplace((*signatures)[misses[j]], miss_status[j]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        (*result)[i] = (*status)[i] == NVIMGCODEC_PROCESSING_STATUS_SUCCESS;
+}
+
+bool DecoderWorker::lookupCanDecode(Work<nvimgcodecDecodeParams_t>* work, size_t sample_idx, nvimgcodecProcessingStatus_t* status)
+{
+    {
+        // Nothing is memoised by decoders which aren't memoizable, or which weren't asked yet
+        std::lock_guard lock(can_decode_mutex_);
+        if (can_decode_cache_.empty())
+            return false;
+    }
+    auto& signatures = work->signatures_;
+    signatures.resize(work->code_streams_.size());
+    if (signatures[sample_idx].empty())
+        signatures[sample_idx] = sample_signature(work->code_streams_[sample_idx], work->images_[sample_idx], work->params_);
+
+    std::lock_guard lock(can_decode_mutex_);
+    auto it = can_decode_cache_.find(signatures[sample_idx]);
+    if (it == can_decode_cache_.end())
+        return false;
+    *status = it->second;
+    return true;
+}
+
+DecoderWorker* DecoderWorker::routeRejected(Work<nvimgcodecDecodeParams_t>* work, size_t sample_idx, nvimgcodecProcessingStatus_t* status)
+{
+    // Only memoised results are used, as fallback decoders may be busy decoding on their own threads
+    DecoderWorker* worker = getFallback();
+    nvimgcodecProcessingStatus_t worker_status;
+    while (worker && worker->lookupCanDecode(work, sample_idx, &worker_status) && worker_status != NVIMGCODEC_PROCESSING_STATUS_SUCCESS) {
+        *status = worker_status;
+        worker = worker->getFallback();
+    }
+    return worker;
+}
+
 void DecoderWorker::processBatch(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work, bool immediate) noexcept
 {
     nvtx3::scoped_range marker{"processBatch"};
@@ -256,13 +650,15 @@ void DecoderWorker::processBatch(std::unique_ptr<Work<nvimgcodecDecodeParams_t>>
     assert(work->images_.size() == work->code_streams_.size());
 
     IImageDecoder* decoder = getDecoder();
-    std::vector<bool> mask(work->code_streams_.size());
-    std::vector<nvimgcodecProcessingStatus_t> status(work->code_streams_.size());
+    size_t n = work->code_streams_.size();
+    std::vector<bool> mask(n);
+    std::vector<nvimgcodecProcessingStatus_t> status(n);
     if (decoder) {
-        NVIMGCODEC_LOG_DEBUG(logger_, "code streams: " << work->code_streams_.size());
-        decoder->canDecode(work->code_streams_, work->images_, work->params_, &mask, &status);
+        NVIMGCODEC_LOG_DEBUG(logger_, "code streams: " << n);
+        // Signatures computed by a decoder earlier in the chain come with the work
+        canDecode(work->code_streams_, work->images_, work->params_, &work->signatures_, &mask, &status);
 #ifndef NDEBUG
-        for (size_t i = 0; i < work->code_streams_.size(); i++) {
+        for (size_t i = 0; i < n; i++) {
             NVIMGCODEC_LOG_DEBUG(logger_, "[" << decoder->decoderId() << "]"
                                               << " canDecode status sample #" << i << " : " << status[i]);
         }
@@ -272,27 +668,31 @@ void DecoderWorker::processBatch(std::unique_ptr<Work<nvimgcodecDecodeParams_t>>
         work->results_.setAll(ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED));
         return;
     }
-    std::unique_ptr<Work<nvimgcodecDecodeParams_t>> fallback_work;
-    auto fallback_worker = getFallback();
-    if (fallback_worker) {
-        fallback_work = work_manager_->createNewWork(work->results_, work->params_);
-        move_work_to_fallback(fallback_work.get(), work.get(), mask);
-        if (!fallback_work->empty()) {
-            for (auto idx : fallback_work->indices_) {
-                NVIMGCODEC_LOG_INFO(logger_, "[" << decoder_->decoderId() << "]"
-                                                 << " canDecode #" << idx << " fallback");
-            }
-            // if all samples go to the fallback, we can afford using the current thread
-            bool fallback_immediate = immediate && work->code_streams_.empty();
-            fallback_worker->addWork(std::move(fallback_work), fallback_immediate);
-        }
-    } else {
-        for (size_t i = 0; i < mask.size(); i++) {
-            if (!mask[i]) {
-                work->results_.set(work->indices_[i], ProcessingResult::failure(status[i]));
-            }
+
+    // Rejected samples are sent at once to the fallback expected to decode them, in the order of the chain
+    std::vector<std::pair<DecoderWorker*, std::unique_ptr<Work<nvimgcodecDecodeParams_t>>>> routed;
+    for (size_t i = 0; i < n; i++) {
+        if (mask[i])
+            continue;
+        DecoderWorker* target = routeRejected(work.get(), i, &status[i]);
+        if (!target) {
+            // no fallback can decode it - just propagate the result to the original promise
+            work->results_.set(work->indices_[i], ProcessingResult::failure(status[i]));
+            continue;
         }
-        filter_work(work.get(), mask);
+        NVIMGCODEC_LOG_INFO(logger_, "[" << decoder_->decoderId() << "]"
+                                         << " canDecode #" << work->indices_[i] << " fallback");
+        auto it = std::find_if(routed.begin(), routed.end(), [target](const auto& entry) { return entry.first == target; });
+        if (it == routed.end())
+            it = routed.emplace(routed.end(), target, work_manager_->createNewWork(work->results_, work->params_));
+        it->second->moveEntry(work.get(), i);
+    }
+    filter_work(work.get(), mask);
+    std::sort(routed.begin(), routed.end(), [](const auto& a, const auto& b) { return a.first->index_ < b.first->index_; });
+    for (auto& [target, routed_work] : routed) {
+        // if all samples go to fallbacks, we can afford using the current thread for the first one
+        bool fallback_immediate = immediate && work->code_streams_.empty() && target == routed.front().first;
+        target->addWork(std::move(routed_work), fallback_immediate);
     }
 
     if (!work->code_streams_.empty()) {
@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -34,6 +35,8 @@ namespace nvimgcodec {
 
 class ICodec;
 class ILogger;
+class ColorTransformCache;
+class CorruptedStreamCache;
 
 /**
  * @brief A worker that processes sub-batches of work to be processed by a particular decoder.
@@ -54,9 +57,12 @@ class DecoderWorker
    *
    * @param work_manager   - creates and recycles work
    * @param codec   - the factory that constructs the decoder for this worker
+   * @param color_transforms   - transforms used for color management, if nullptr decoded colors are not converted
+   * @param corrupted_streams   - contents found corrupted, if nullptr they are not remembered
    */
     DecoderWorker(ILogger* logger, IWorkManager<nvimgcodecDecodeParams_t>* work_manager, const nvimgcodecExecutionParams_t* exec_params,
-        const std::string& options, const ICodec* codec, int index);
+        const std::string& options, const ICodec* codec, int index, ColorTransformCache* color_transforms = nullptr,
+        CorruptedStreamCache* corrupted_streams = nullptr);
     ~DecoderWorker();
 
     void addWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work, bool immediate);
@@ -64,6 +70,16 @@ class DecoderWorker
     DecoderWorker* getFallback();
     IImageDecoder* getDecoder();
 
+    /**
+   * @brief Checks which samples the decoder can decode.
+   *
+   * Results of memoizable decoders are memoised per sample signature, made of code stream and output image properties
+   * and of decode parameters, so samples alike to ones already checked skip the decoder check. Signatures aren't
+   * computed for other decoders.
+   */
+    void canDecode(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
+        const nvimgcodecDecodeParams_t* params, std::vector<bool>* result, std::vector<nvimgcodecProcessingStatus_t>* status);
+
   private:
     void start();
     void stop();
@@ -80,6 +96,31 @@ class DecoderWorker
    */
     void processBatch(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work, bool immediate) noexcept;
 
+  /**
+   * @brief Memoised canDecode, reusing the signatures of samples already computed
+   *
+   * Signatures are computed, into empty entries, only if the decoder results are memoizable.
+   */
+  void canDecode(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
+      const nvimgcodecDecodeParams_t* params, std::vector<std::string>* signatures, std::vector<bool>* result,
+      std::vector<nvimgcodecProcessingStatus_t>* status);
+
+  /**
+   * @brief Returns the memoised canDecode status of a sample of the work, or false if no sample alike was checked yet
+   *
+   * The sample signature is computed into the work if missing and anything is memoised.
+   */
+  bool lookupCanDecode(Work<nvimgcodecDecodeParams_t>* work, size_t sample_idx, nvimgcodecProcessingStatus_t* status);
+
+  /**
+   * @brief Returns the worker to send a sample of the work rejected by this decoder to
+   *
+   * Fallbacks whose decoders are known to reject samples alike are skipped, so that the sample doesn't go through
+   * their canDecode and worker threads. Returns nullptr if all the fallbacks are known to reject it, in which case
+   * status is set to the status of the last one.
+   */
+  DecoderWorker* routeRejected(Work<nvimgcodecDecodeParams_t>* work, size_t sample_idx, nvimgcodecProcessingStatus_t* status);
+
   /**
    * @brief Waits for and process current work results
    * 
@@ -98,6 +139,20 @@ class DecoderWorker
    */
   void updateCurrentWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work, std::unique_ptr<ProcessingResultsFuture> future);
 
+  /**
+   * @brief Converts the decoded image from the profile embedded in the code stream to the target profile
+   *
+   * Images which can't be converted are left unchanged, with a warning.
+   */
+  void convertColors(IImage* image, ICodeStream* code_stream, const nvimgcodecColorManagementParams_t* color_params);
+
+  struct ColorConversions;
+
+  /**
+   * @brief Executor task converting the colors of one decoded sample and setting its result
+   */
+  static void convertColorsTask(int tid, int sample_idx, void* context);
+
     /**
    * @brief The main loop of the worker thread.
    */
@@ -124,6 +179,11 @@ class DecoderWorker
     bool is_device_output_ = false;
     std::unique_ptr<IDecodeState> decode_state_batch_;
     std::unique_ptr<DecoderWorker> fallback_ = nullptr;
+    ColorTransformCache* color_transforms_ = nullptr;
+    CorruptedStreamCache* corrupted_streams_ = nullptr;
+
+    std::mutex can_decode_mutex_;
+    std::unordered_map<std::string, nvimgcodecProcessingStatus_t> can_decode_cache_;  // canDecode status per sample signature
 };
 
 
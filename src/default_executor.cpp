@@ -16,15 +16,19 @@
  */
 #include "default_executor.h"
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include "exception.h"
 #include "log.h"
+#include "numa_topology.h"
 
 namespace nvimgcodec {
 
 DefaultExecutor::DefaultExecutor(ILogger* logger, int num_threads)
     : logger_(logger)
-    , desc_{NVIMGCODEC_STRUCTURE_TYPE_EXECUTOR_DESC, sizeof(nvimgcodecExecutorDesc_t), nullptr, this, &static_launch, &static_get_num_threads}
+    , desc_{NVIMGCODEC_STRUCTURE_TYPE_EXECUTOR_DESC, sizeof(nvimgcodecExecutorDesc_t), nullptr, this, &static_launch, &static_get_num_threads,
+          &static_launch_batch}
     , num_threads_(num_threads)
 {
     if (num_threads_ == 0) {
@@ -42,16 +46,61 @@ nvimgcodecExecutorDesc_t* DefaultExecutor::getExecutorDesc()
     return &desc_;
 }
 
+ThreadPool& DefaultExecutor::get_thread_pool(int device_id)
+{
+    std::stringstream ss;
+    ss << "Executor-" << device_id;
+    auto it = device_id2thread_pool_.try_emplace(device_id, num_threads_, device_id, false, ss.str());
+    return it.first->second;
+}
+
+std::vector<DefaultExecutor::NodePool>& DefaultExecutor::get_node_pools()
+{
+    // Tasks can be launched from several threads at once
+    std::call_once(node_pools_once_, [this]() { init_node_pools(); });
+    return node_pools_;
+}
+
+void DefaultExecutor::init_node_pools()
+{
+    const char* env_numa = std::getenv("NVIMGCODEC_NUMA_AWARE");
+    if (env_numa && std::strcmp(env_numa, "0") == 0)
+        return;
+    auto nodes = GetNumaTopology();
+    if (nodes.size() < 2)
+        return;
+    auto threads_per_node = PartitionThreads(nodes, num_threads_);
+    if (threads_per_node.empty())
+        return;
+
+    int first_thread = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        std::stringstream ss;
+        ss << "Executor-Node" << nodes[i].id;
+        auto pool = std::make_unique<ThreadPool>(threads_per_node[i], CPU_ONLY_DEVICE_ID, false, ss.str(), nodes[i].cpus);
+        NVIMGCODEC_LOG_INFO(logger_, "NUMA node " << nodes[i].id << " runs " << threads_per_node[i] << " executor threads");
+        node_pools_.push_back({{first_thread, threads_per_node[i], num_threads_}, std::move(pool)});
+        first_thread += threads_per_node[i];
+    }
+}
+
 nvimgcodecStatus_t DefaultExecutor::launch(int device_id, int sample_idx, void* task_context,
     void (*task)(int thread_id, int sample_idx, void* task_context))
 {
     try {
-        std::stringstream ss;
-        ss << "Executor-" << device_id;
-        auto it =
-            device_id2thread_pool_.try_emplace(device_id, num_threads_, device_id, false, ss.str());
-
-        auto& thread_pool = it.first->second;
+        if (device_id == NVIMGCODEC_DEVICE_CPU_ONLY) {
+            auto& node_pools = get_node_pools();
+            for (auto& node : node_pools) {
+                if (!node.samples.contains(sample_idx))
+                    continue;
+                int first_thread = node.samples.first_thread;
+                node.pool->addWork(
+                    [task_context, sample_idx, task, first_thread](int thread_id) { task(first_thread + thread_id, sample_idx, task_context); },
+                    0, true);
+                return NVIMGCODEC_STATUS_SUCCESS;
+            }
+        }
+        auto& thread_pool = get_thread_pool(device_id);
         auto task_wrapper = [task_context, sample_idx, task](int thread_id) {
             task(thread_id, sample_idx, task_context); 
         };
@@ -64,6 +113,36 @@ nvimgcodecStatus_t DefaultExecutor::launch(int device_id, int sample_idx, void*
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
+nvimgcodecStatus_t DefaultExecutor::launch_batch(int device_id, int num_tasks, void* task_context,
+    void (*task)(int thread_id, int sample_idx, void* task_context))
+{
+    try {
+        if (device_id == NVIMGCODEC_DEVICE_CPU_ONLY) {
+            auto& node_pools = get_node_pools();
+            if (!node_pools.empty()) {
+                // Samples go to the same nodes as if they were launched one at a time
+                for (auto& node : node_pools) {
+                    int count = node.samples.count(num_tasks);
+                    if (count == 0)
+                        continue;
+                    NodeSamples samples = node.samples;
+                    node.pool->addBatch(count, [task_context, task, samples](int thread_id, int task_idx) {
+                        task(samples.first_thread + thread_id, samples.sample(task_idx), task_context);
+                    });
+                }
+                return NVIMGCODEC_STATUS_SUCCESS;
+            }
+        }
+        auto& thread_pool = get_thread_pool(device_id);
+        thread_pool.addBatch(num_tasks, [task_context, task](int thread_id, int sample_idx) { task(thread_id, sample_idx, task_context); });
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(logger_, e.what());
+        return NVIMGCODEC_STATUS_INTERNAL_ERROR;
+    }
+
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
 int DefaultExecutor::get_num_threads() const
 {
     return num_threads_;
@@ -82,4 +161,11 @@ int DefaultExecutor::static_get_num_threads(void* instance)
     return handle->get_num_threads();
 }
 
+nvimgcodecStatus_t DefaultExecutor::static_launch_batch(void* instance, int device_id, int num_tasks, void* task_context,
+    void (*task)(int thread_id, int sample_idx, void* task_context))
+{
+    DefaultExecutor* handle = reinterpret_cast<DefaultExecutor*>(instance);
+    return handle->launch_batch(device_id, num_tasks, task_context, task);
+}
+
 } // namespace nvimgcodec
\ No newline at end of file
@@ -19,7 +19,11 @@
 
 #include <nvimgcodec.h>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "iexecutor.h"
+#include "numa_topology.h"
 #include "thread_pool.h"
 
 namespace nvimgcodec {
@@ -34,19 +38,37 @@ class DefaultExecutor : public IExecutor
     nvimgcodecExecutorDesc_t* getExecutorDesc() override;
 
   private:
+    // Thread pool of a NUMA node, running threads [first_thread, first_thread + num_threads) of the executor
+    struct NodePool
+    {
+        NodeSamples samples;
+        std::unique_ptr<ThreadPool> pool;
+    };
+
+    ThreadPool& get_thread_pool(int device_id);
+    std::vector<NodePool>& get_node_pools();
+    void init_node_pools();
     nvimgcodecStatus_t launch(int device_id, int sample_idx, void* task_context,
         void (*task)(int thread_id, int sample_idx, void* task_context));
+    nvimgcodecStatus_t launch_batch(int device_id, int num_tasks, void* task_context,
+        void (*task)(int thread_id, int sample_idx, void* task_context));
     int get_num_threads() const;
 
     static nvimgcodecStatus_t static_launch(
         void* instance, int device_id, int sample_idx, void* task_context,
         void (*task)(int thread_id, int sample_idx, void* task_context));
     static int static_get_num_threads(void* instance);
+    static nvimgcodecStatus_t static_launch_batch(
+        void* instance, int device_id, int num_tasks, void* task_context,
+        void (*task)(int thread_id, int sample_idx, void* task_context));
 
     ILogger* logger_;
     nvimgcodecExecutorDesc_t desc_;
     int num_threads_;
     std::map<int, ThreadPool> device_id2thread_pool_;
+    // CPU only tasks are run by one pool per NUMA node, if the host has more than one
+    std::vector<NodePool> node_pools_;
+    std::once_flag node_pools_once_;
 };
 
 } // namespace nvimgcodec
\ No newline at end of file
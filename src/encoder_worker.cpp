@@ -179,6 +179,16 @@ static void filter_work(Work<nvimgcodecEncodeParams_t>* work, const std::vector<
     move_work_to_fallback(nullptr, work, keep);
 }
 
+static bool has_band_input(IImage* image)
+{
+    nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image->getImageInfo(&image_info);
+    auto* ext = static_cast<const nvimgcodecBandInput_t*>(image_info.struct_next);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT)
+        ext = static_cast<const nvimgcodecBandInput_t*>(ext->struct_next);
+    return ext != nullptr;
+}
+
 void EncoderWorker::processBatch(std::unique_ptr<Work<nvimgcodecEncodeParams_t>> work) noexcept
 {
     NVIMGCODEC_LOG_TRACE(logger_, "processBatch");
@@ -191,6 +201,15 @@ void EncoderWorker::processBatch(std::unique_ptr<Work<nvimgcodecEncodeParams_t>>
     if (encoder) {
         NVIMGCODEC_LOG_DEBUG(logger_, "code streams: " << work->code_streams_.size());
         encoder->canEncode(work->images_, work->code_streams_, work->params_, &mask, &status);
+        if (is_input_expected_in_device_) {
+            // Device input is staged in a buffer sized for the whole image, so bands can't be consumed
+            for (size_t i = 0; i < work->images_.size(); i++) {
+                if (has_band_input(work->images_[i])) {
+                    mask[i] = false;
+                    status[i] |= NVIMGCODEC_PROCESSING_STATUS_BAND_INPUT_UNSUPPORTED;
+                }
+            }
+        }
     } else {
         NVIMGCODEC_LOG_ERROR(logger_, "Could not create encoder");
         work->results_.setAll(ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED));
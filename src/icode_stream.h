@@ -21,6 +21,7 @@
 #include <nvimgcodec.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace nvimgcodec {
 
@@ -37,6 +38,10 @@ class ICodeStream
     virtual void setOutputToHostMem(void* ctx, nvimgcodecResizeBufferFunc_t get_buffer_func) = 0;
     virtual nvimgcodecStatus_t getImageInfo(nvimgcodecImageInfo_t* image_info) = 0;
     virtual nvimgcodecStatus_t setImageInfo(const nvimgcodecImageInfo_t* image_info) = 0;
+    /**
+     * @brief Returns the ICC profile embedded in the code stream, empty if there is none. It is parsed once and kept.
+     */
+    virtual const std::vector<uint8_t>& getIccProfile() = 0;
     virtual std::string getCodecName() const = 0;
     virtual ICodec* getCodec() const = 0;
     virtual nvimgcodecIoStreamDesc_t* getInputStreamDesc() = 0;
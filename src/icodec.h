@@ -49,5 +49,9 @@ class ICodec
     virtual void unregisterDecoderFactory(const std::string decoder_id) = 0;
     virtual void registerParserFactory(std::unique_ptr<IImageParserFactory> factory, float priority) = 0;
     virtual void unregisterParserFactory(const std::string parser_id) = 0;
+    virtual int getTransformersNum() const = 0;
+    virtual const nvimgcodecTransformerDesc_t* getTransformerDesc(int index) const = 0;
+    virtual void registerTransformer(const nvimgcodecTransformerDesc_t* desc, float priority) = 0;
+    virtual void unregisterTransformer(const std::string transformer_id) = 0;
 };
 } // namespace nvimgcodec
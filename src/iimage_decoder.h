@@ -41,6 +41,8 @@ class IImageDecoder
         const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
         const nvimgcodecDecodeParams_t* params) = 0;
     virtual const char* decoderId() const = 0;
+    // Whether canDecode results depend only on image info and parameters, so that they can be remembered
+    virtual bool isCanDecodeMemoizable() const = 0;
 };
 
 } // namespace nvimgcodec
\ No newline at end of file
@@ -39,6 +39,15 @@ Image::~Image()
 {
 }
 
+void Image::reset()
+{
+    index_ = 0;
+    image_info_ = {};
+    decode_state_ = nullptr;
+    encode_state_ = nullptr;
+    promise_.reset();
+}
+
 void Image::setIndex(int index)
 {
     index_ = index;
@@ -36,6 +36,8 @@ class Image : public IImage
     void getImageInfo(nvimgcodecImageInfo_t* image_info) override;
     nvimgcodecImageDesc_t* getImageDesc() override;
     void setPromise(const ProcessingResultsPromise& promise) override;
+    // Brings the image back to its freshly constructed state
+    void reset();
   private:
     nvimgcodecStatus_t imageReady(nvimgcodecProcessingStatus_t processing_status);
 
@@ -17,6 +17,7 @@
 #include "image_decoder.h"
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include "decode_state_batch.h"
 #include "exception.h"
 #include "icode_stream.h"
@@ -111,4 +112,11 @@ const char* ImageDecoder::decoderId() const {
     return decoder_desc_->id;
 }
 
+bool ImageDecoder::isCanDecodeMemoizable() const
+{
+    // Older extensions don't have the field, their canDecode results are not remembered
+    return decoder_desc_->struct_size >= offsetof(nvimgcodecDecoderDesc_t, can_decode_memoizable) + sizeof(int) &&
+           decoder_desc_->can_decode_memoizable;
+}
+
 } // namespace nvimgcodec
@@ -41,6 +41,7 @@ class ImageDecoder : public IImageDecoder
         const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
         const nvimgcodecDecodeParams_t* params) override;
     const char* decoderId() const override;
+    bool isCanDecodeMemoizable() const override;
 
   private:
     const nvimgcodecDecoderDesc_t* decoder_desc_;
@@ -20,7 +20,9 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <nvtx3/nvtx3.hpp>
+#include "code_stream_key.h"
 #include "decode_state_batch.h"
 #include "decoder_worker.h"
 #include "default_executor.h"
@@ -32,6 +34,7 @@
 #include "iimage_decoder.h"
 #include "iimage_decoder_factory.h"
 #include "log.h"
+#include "nvimgcodec_type_utils.h"
 #include "processing_results.h"
 #include "user_executor.h"
 #include "work.h"
@@ -52,7 +55,7 @@ ImageGenericDecoder::ImageGenericDecoder(
     ILogger* logger, ICodecRegistry* codec_registry, const nvimgcodecExecutionParams_t* exec_params, const char* options)
     : logger_(logger)
     , codec_registry_(codec_registry)
-    , exec_params_(*exec_params)
+    , exec_params_(copy_execution_params(exec_params))
     , backends_(exec_params->num_backends)
     , options_(options ? options : "")
     , executor_(std::move(GetExecutor(exec_params, logger)))
@@ -72,7 +75,8 @@ ImageGenericDecoder::ImageGenericDecoder(
     if (exec_params_.pre_init) {
         for (size_t codec_idx = 0; codec_idx < codec_registry_->getCodecsCount(); codec_idx++) {
             auto* codec = codec_registry_->getCodecByIndex(codec_idx);
-            workers_.emplace(codec, std::make_unique<DecoderWorker>(logger_, this, &exec_params_, options_, codec, 0));
+            workers_.emplace(codec,
+                std::make_unique<DecoderWorker>(logger_, this, &exec_params_, options_, codec, 0, &color_transforms_, &corrupted_streams_));
         }
     }
 }
@@ -107,11 +111,9 @@ void ImageGenericDecoder::canDecode(const std::vector<ICodeStream*>& code_stream
         }
         auto worker = getWorker(entry.first);
         while (worker && codec_code_streams.size() != 0) {
-            auto decoder = worker->getDecoder();
-
             std::vector<bool> mask(codec_code_streams.size());
             std::vector<nvimgcodecProcessingStatus_t> status(codec_code_streams.size());
-            decoder->canDecode(codec_code_streams, codec_images, params, &mask, &status);
+            worker->canDecode(codec_code_streams, codec_images, params, &mask, &status);
 
             //filter out ready items
             int removed = 0;
@@ -178,18 +180,137 @@ static void sortSamples(std::vector<size_t>& order, ICodeStream *const * streams
 }
 
 
+// Statistics requested for the outputs are reported only by decoders which compute them
+static void resetImageStatistics(const std::vector<IImage*>& images)
+{
+    for (auto* image : images) {
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image->getImageInfo(&image_info);
+        auto* stats = static_cast<nvimgcodecImageStatistics_t*>(image_info.struct_next);
+        while (stats && stats->struct_type != NVIMGCODEC_STRUCTURE_TYPE_IMAGE_STATISTICS)
+            stats = static_cast<nvimgcodecImageStatistics_t*>(stats->struct_next);
+        if (stats)
+            stats->num_channels = 0;
+    }
+}
+
+static const nvimgcodecDeduplicationParams_t* getDeduplicationParams(const nvimgcodecDecodeParams_t* params)
+{
+    auto* ext = static_cast<const nvimgcodecDeduplicationParams_t*>(params ? params->struct_next : nullptr);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_PARAMS)
+        ext = static_cast<const nvimgcodecDeduplicationParams_t*>(ext->struct_next);
+    return ext;
+}
+
+// Outputs of duplicates are copies of the whole output buffer, so they need the same layout
+static bool haveSameLayout(const nvimgcodecImageInfo_t& a, const nvimgcodecImageInfo_t& b)
+{
+    if (a.struct_next || b.struct_next || a.buffer_kind != b.buffer_kind || a.buffer_size != b.buffer_size ||
+        a.sample_format != b.sample_format || a.color_spec != b.color_spec || a.chroma_subsampling != b.chroma_subsampling ||
+        a.num_planes != b.num_planes || a.region.ndim != b.region.ndim)
+        return false;
+    for (int d = 0; d < a.region.ndim; d++) {
+        if (a.region.start[d] != b.region.start[d] || a.region.end[d] != b.region.end[d])
+            return false;
+    }
+    for (uint32_t p = 0; p < a.num_planes; p++) {
+        const auto& pa = a.plane_info[p];
+        const auto& pb = b.plane_info[p];
+        if (pa.width != pb.width || pa.height != pb.height || pa.row_stride != pb.row_stride || pa.num_channels != pb.num_channels ||
+            pa.sample_type != pb.sample_type || pa.precision != pb.precision)
+            return false;
+    }
+    return true;
+}
+
+// Copies the output, ordered after the work on the stream of the source image
+static ProcessingResult copyOutput(IImage* src, IImage* dst)
+{
+    try {
+        nvimgcodecImageInfo_t src_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        src->getImageInfo(&src_info);
+        nvimgcodecImageInfo_t dst_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        dst->getImageInfo(&dst_info);
+        if (src_info.buffer == dst_info.buffer)
+            return ProcessingResult::success();
+        CHECK_CUDA(cudaMemcpyAsync(dst_info.buffer, src_info.buffer, src_info.buffer_size, cudaMemcpyDefault, src_info.cuda_stream));
+        if (dst_info.cuda_stream != src_info.cuda_stream) {
+            cudaEvent_t event;
+            CHECK_CUDA(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+            CHECK_CUDA(cudaEventRecord(event, src_info.cuda_stream));
+            CHECK_CUDA(cudaStreamWaitEvent(dst_info.cuda_stream, event));
+            CHECK_CUDA(cudaEventDestroy(event));
+        }
+        return ProcessingResult::success();
+    } catch (...) {
+        return ProcessingResult::failure(std::current_exception());
+    }
+}
+
+void ImageGenericDecoder::skipDuplicates(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
+    ProcessingResultsPromise& results, std::vector<size_t>& order)
+{
+    nvtx3::scoped_range marker{"skipDuplicates"};
+    int N = images.size();
+    // Samples decoded so far for each contents, the first one with a matching output layout is the one to copy from
+    std::unordered_map<CodeStreamKey, std::vector<int>, CodeStreamKeyHash> decoded;
+    std::vector<nvimgcodecImageInfo_t> infos(N);
+    auto duplicates = std::make_shared<std::vector<std::vector<int>>>(N);
+    std::vector<bool> is_duplicate(N);
+    int num_duplicates = 0;
+    for (int i = 0; i < N; i++) {
+        infos[i] = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        images[i]->getImageInfo(&infos[i]);
+        CodeStreamKey key;
+        if (infos[i].struct_next || !GetCodeStreamKey(code_streams[i], &key))
+            continue;
+        auto& candidates = decoded[key];
+        // Contents are compared as well, so that colliding keys don't make a sample a copy of another one
+        auto it = std::find_if(candidates.begin(), candidates.end(),
+            [&](int c) { return haveSameLayout(infos[c], infos[i]) && CodeStreamsEqual(code_streams[c], code_streams[i]); });
+        if (it == candidates.end()) {
+            candidates.push_back(i);
+        } else {
+            (*duplicates)[*it].push_back(i);
+            is_duplicate[i] = true;
+            num_duplicates++;
+        }
+    }
+    num_deduplicated_samples_ += N;
+    num_duplicates_ += num_duplicates;
+    if (num_duplicates == 0)
+        return;
+
+    order.erase(std::remove_if(order.begin(), order.end(), [&](size_t i) { return is_duplicate[i]; }), order.end());
+    results.setOnResult([duplicates, images](ProcessingResultsPromise& promise, int index, const ProcessingResult& res) {
+        for (int dup : (*duplicates)[index])
+            promise.set(dup, res.isSuccess() ? copyOutput(images[index], images[dup]) : res);
+    });
+}
+
+void ImageGenericDecoder::getDeduplicationStats(nvimgcodecDeduplicationStats_t* stats) const
+{
+    stats->num_samples = num_deduplicated_samples_;
+    stats->num_duplicates = num_duplicates_;
+}
+
 std::unique_ptr<ProcessingResultsFuture> ImageGenericDecoder::decode(
     const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images, const nvimgcodecDecodeParams_t* params)
 {
     int N = images.size();
     assert(static_cast<int>(code_streams.size()) == N);
+    resetImageStatistics(images);
 
     ProcessingResultsPromise results(N);
     auto future = results.getFuture();
-    auto work = createNewWork(std::move(results), params);
 
     std::vector<size_t> order;
     sortSamples(order, code_streams.data(), code_streams.size());
+    auto dedup_params = getDeduplicationParams(params);
+    if (dedup_params && dedup_params->enable)
+        skipDuplicates(code_streams, images, results, order);
+
+    auto work = createNewWork(std::move(results), params);
     work->init(code_streams, images, order);
 
     distributeWork(std::move(work));
@@ -256,19 +377,50 @@ DecoderWorker* ImageGenericDecoder::getWorker(const ICodec* codec)
 {
     auto it = workers_.find(codec);
     if (it == workers_.end()) {
-        it = workers_.emplace(codec, std::make_unique<DecoderWorker>(logger_, this, &exec_params_, options_, codec, 0)).first;
+        it = workers_
+                 .emplace(codec,
+                     std::make_unique<DecoderWorker>(logger_, this, &exec_params_, options_, codec, 0, &color_transforms_, &corrupted_streams_))
+                 .first;
     }
 
     return it->second.get();
 }
 
+bool ImageGenericDecoder::isCorrupted(ICodeStream* code_stream, const nvimgcodecCorruptedStreamParams_t* params)
+{
+    CorruptedStreamCache::Key key;
+    bool has_key = false;
+    if (params->remember_corrupted && !corrupted_streams_.empty()) {
+        has_key = GetCodeStreamKey(code_stream, &key);
+        if (has_key && corrupted_streams_.contains(key))
+            return true;
+    }
+    if (!params->validate)
+        return false;
+
+    nvimgcodecCodeStreamValidation_t validation{
+        NVIMGCODEC_STRUCTURE_TYPE_CODE_STREAM_VALIDATION, sizeof(nvimgcodecCodeStreamValidation_t), nullptr};
+    nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &validation};
+    code_stream->getImageInfo(&image_info); // Validation is reported even if the rest of the info can't be read
+    if (!validation.checked || !validation.corrupted)
+        return false;
+    if (params->remember_corrupted && (has_key || GetCodeStreamKey(code_stream, &key)))
+        corrupted_streams_.insert(key);
+    return true;
+}
+
 void ImageGenericDecoder::distributeWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work)
 {
     std::map<const ICodec*, std::unique_ptr<Work<nvimgcodecDecodeParams_t>>> dist;
+    auto corrupted_params = GetCorruptedStreamParams(work->params_);
     for (int i = 0; i < work->getSamplesNum(); i++) {
+        if (corrupted_params && isCorrupted(work->code_streams_[i], corrupted_params)) {
+            work->results_.set(work->indices_[i], ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED));
+            continue;
+        }
         ICodec* codec = work->code_streams_[i]->getCodec();
         if (!codec) {
-            work->results_.set(i, ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED));
+            work->results_.set(work->indices_[i], ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED));
             continue;
         }
         auto& w = dist[codec];
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <nvimgcodec.h>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -25,6 +26,8 @@
 #include <vector>
 #include <mutex>
 
+#include "color_management.h"
+#include "corrupted_stream_cache.h"
 #include "iexecutor.h"
 #include "iimage_decoder.h"
 #include "iwork_manager.h"
@@ -50,6 +53,9 @@ class ImageGenericDecoder : public IWorkManager <nvimgcodecDecodeParams_t>
         nvimgcodecProcessingStatus_t* processing_status, int force_format);
     std::unique_ptr<ProcessingResultsFuture> decode(
         const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images, const nvimgcodecDecodeParams_t* params);
+    int getDeviceId() const { return exec_params_.device_id; }
+    const nvimgcodecHostAllocator_t* getHostAllocator() const { return exec_params_.host_allocator; }
+    void getDeduplicationStats(nvimgcodecDeduplicationStats_t* stats) const;
 
   private:
     DecoderWorker* getWorker(const ICodec* codec);
@@ -58,11 +64,18 @@ class ImageGenericDecoder : public IWorkManager <nvimgcodecDecodeParams_t>
     void recycleWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work) override;
     void combineWork(Work<nvimgcodecDecodeParams_t>* target, std::unique_ptr<Work<nvimgcodecDecodeParams_t>> source);
     void distributeWork(std::unique_ptr<Work<nvimgcodecDecodeParams_t>> work);
+    bool isCorrupted(ICodeStream* code_stream, const nvimgcodecCorruptedStreamParams_t* params);
+    void skipDuplicates(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images, ProcessingResultsPromise& results,
+        std::vector<size_t>& order);
 
     ILogger* logger_;
     ICodecRegistry* codec_registry_;
     std::mutex work_mutex_;
     std::unique_ptr<Work<nvimgcodecDecodeParams_t>> free_work_items_;
+    ColorTransformCache color_transforms_;
+    CorruptedStreamCache corrupted_streams_;
+    std::atomic<uint64_t> num_deduplicated_samples_ = 0;
+    std::atomic<uint64_t> num_duplicates_ = 0;
     std::map<const ICodec*, std::unique_ptr<DecoderWorker>> workers_;
     nvimgcodecExecutionParams_t exec_params_;
     std::vector<nvimgcodecBackend_t> backends_;
@@ -31,6 +31,7 @@
 #include "iimage_encoder.h"
 #include "iimage_encoder_factory.h"
 #include "log.h"
+#include "nvimgcodec_type_utils.h"
 #include "processing_results.h"
 #include "user_executor.h"
 
@@ -49,7 +50,7 @@ static std::unique_ptr<IExecutor> GetExecutor(const nvimgcodecExecutionParams_t*
 ImageGenericEncoder::ImageGenericEncoder(ILogger* logger, ICodecRegistry* codec_registry, const nvimgcodecExecutionParams_t* exec_params, const char* options)
     : logger_(logger)
     , codec_registry_(codec_registry)
-    , exec_params_(*exec_params)
+    , exec_params_(copy_execution_params(exec_params))
     , backends_(exec_params->num_backends)
     , options_(options ? options : "")
     , executor_(std::move(GetExecutor(exec_params, logger)))
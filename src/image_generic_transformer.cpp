@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_generic_transformer.h"
+#include <cassert>
+#include "default_executor.h"
+#include "exception.h"
+#include "icode_stream.h"
+#include "icodec.h"
+#include "icodec_registry.h"
+#include "log.h"
+#include "nvimgcodec_type_utils.h"
+#include "user_executor.h"
+
+namespace nvimgcodec {
+
+static std::unique_ptr<IExecutor> GetExecutor(const nvimgcodecExecutionParams_t* exec_params, ILogger* logger)
+{
+    std::unique_ptr<IExecutor> exec;
+    if (exec_params->executor)
+        exec = std::make_unique<UserExecutor>(exec_params->executor);
+    else
+        exec = std::make_unique<DefaultExecutor>(logger, exec_params->max_num_cpu_threads);
+    return exec;
+}
+
+ImageGenericTransformer::ImageGenericTransformer(
+    ILogger* logger, ICodecRegistry* codec_registry, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+    : logger_(logger)
+    , codec_registry_(codec_registry)
+    , exec_params_(copy_execution_params(exec_params))
+    , backends_(exec_params->num_backends)
+    , options_(options ? options : "")
+    , executor_(std::move(GetExecutor(exec_params, logger)))
+{
+    if (exec_params_.device_id == NVIMGCODEC_DEVICE_CURRENT)
+        CHECK_CUDA(cudaGetDevice(&exec_params_.device_id));
+    auto backend = exec_params->backends;
+    for (int i = 0; i < exec_params_.num_backends; ++i) {
+        backends_[i] = *backend;
+        ++backend;
+    }
+    exec_params_.backends = backends_.data();
+    exec_params_.executor = executor_->getExecutorDesc();
+}
+
+ImageGenericTransformer::~ImageGenericTransformer()
+{
+    for (auto& entry : transformers_) {
+        for (auto& transformer : entry.second)
+            transformer.desc_->destroy(transformer.handle_);
+    }
+}
+
+const std::vector<ImageGenericTransformer::Transformer>& ImageGenericTransformer::getTransformers(const ICodec* codec)
+{
+    auto it = transformers_.find(codec);
+    if (it != transformers_.end())
+        return it->second;
+
+    std::vector<Transformer> transformers;
+    for (int i = 0; i < codec->getTransformersNum(); i++) {
+        auto desc = codec->getTransformerDesc(i);
+        bool backend_allowed = exec_params_.num_backends == 0;
+        for (int b = 0; b < exec_params_.num_backends && !backend_allowed; ++b)
+            backend_allowed = exec_params_.backends[b].kind == desc->backend_kind;
+        if (!backend_allowed)
+            continue;
+
+        nvimgcodecTransformer_t handle = nullptr;
+        if (desc->create(desc->instance, &handle, &exec_params_, options_.c_str()) != NVIMGCODEC_STATUS_SUCCESS) {
+            NVIMGCODEC_LOG_WARNING(logger_, "Could not create transformer " << desc->id);
+            continue;
+        }
+        transformers.push_back({desc, handle});
+    }
+    return transformers_.emplace(codec, std::move(transformers)).first->second;
+}
+
+std::unique_ptr<ProcessingResultsFuture> ImageGenericTransformer::transform(const std::vector<ICodeStream*>& in_code_streams,
+    const std::vector<ICodeStream*>& out_code_streams, const nvimgcodecTransformParams_t* params)
+{
+    assert(in_code_streams.size() == out_code_streams.size());
+    int N = in_code_streams.size();
+    ProcessingResultsPromise results(N);
+    auto future = results.getFuture();
+
+    std::map<const ICodec*, std::vector<int>> codec2indices;
+    for (int i = 0; i < N; i++) {
+        ICodec* codec = in_code_streams[i]->getCodec();
+        if (!codec || codec->getTransformersNum() == 0 || out_code_streams[i]->getCodecName() != codec->name()) {
+            results.set(i, ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED));
+            continue;
+        }
+        codec2indices[codec].push_back(i);
+    }
+
+    std::vector<nvimgcodecProcessingStatus_t> processing_status(N, NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED);
+    for (auto& entry : codec2indices) {
+        std::vector<int> pending = entry.second;
+        std::vector<Transformer> transformers;
+        {
+            // Transformers are created on first use, which can happen in concurrent calls
+            std::lock_guard<std::mutex> lock(transformers_mutex_);
+            transformers = getTransformers(entry.first);
+        }
+        for (auto& transformer : transformers) {
+            if (pending.empty())
+                break;
+            std::vector<nvimgcodecCodeStreamDesc_t*> in_descs(pending.size());
+            std::vector<nvimgcodecCodeStreamDesc_t*> out_descs(pending.size());
+            for (size_t i = 0; i < pending.size(); i++) {
+                in_descs[i] = in_code_streams[pending[i]]->getCodeStreamDesc();
+                out_descs[i] = out_code_streams[pending[i]]->getCodeStreamDesc();
+            }
+            std::vector<nvimgcodecProcessingStatus_t> status(pending.size(), NVIMGCODEC_PROCESSING_STATUS_UNKNOWN);
+            if (transformer.desc_->canTransform(
+                    transformer.handle_, status.data(), in_descs.data(), out_descs.data(), pending.size(), params) !=
+                NVIMGCODEC_STATUS_SUCCESS) {
+                continue;
+            }
+
+            std::vector<int> accepted, rejected;
+            std::vector<nvimgcodecCodeStreamDesc_t*> accepted_in_descs, accepted_out_descs;
+            for (size_t i = 0; i < pending.size(); i++) {
+                processing_status[pending[i]] = status[i];
+                if (status[i] == NVIMGCODEC_PROCESSING_STATUS_SUCCESS) {
+                    accepted.push_back(pending[i]);
+                    accepted_in_descs.push_back(in_descs[i]);
+                    accepted_out_descs.push_back(out_descs[i]);
+                } else {
+                    rejected.push_back(pending[i]);
+                }
+            }
+            pending = std::move(rejected);
+            if (accepted.empty())
+                continue;
+
+            std::vector<nvimgcodecProcessingStatus_t> transform_status(accepted.size(), NVIMGCODEC_PROCESSING_STATUS_FAIL);
+            auto ret = transformer.desc_->transform(transformer.handle_, transform_status.data(), accepted_in_descs.data(),
+                accepted_out_descs.data(), accepted.size(), params);
+            for (size_t i = 0; i < accepted.size(); i++) {
+                if (ret == NVIMGCODEC_STATUS_SUCCESS && transform_status[i] == NVIMGCODEC_PROCESSING_STATUS_SUCCESS)
+                    results.set(accepted[i], ProcessingResult::success());
+                else
+                    results.set(accepted[i], ProcessingResult::failure(transform_status[i]));
+            }
+        }
+        for (int idx : pending)
+            results.set(idx, ProcessingResult::failure(processing_status[idx]));
+    }
+    return future;
+}
+
+} // namespace nvimgcodec
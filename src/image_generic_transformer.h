@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "iexecutor.h"
+#include "processing_results.h"
+
+namespace nvimgcodec {
+
+class ICodeStream;
+class ICodecRegistry;
+class ICodec;
+class ILogger;
+
+/**
+ * @brief Dispatches code stream transforms to the transformers registered for the input codec
+ *
+ * Transformers are tried in priority order. Samples rejected by one transformer fall back to the next one.
+ */
+class ImageGenericTransformer
+{
+  public:
+    explicit ImageGenericTransformer(
+        ILogger* logger, ICodecRegistry* codec_registry, const nvimgcodecExecutionParams_t* exec_params, const char* options = nullptr);
+    ~ImageGenericTransformer();
+    std::unique_ptr<ProcessingResultsFuture> transform(const std::vector<ICodeStream*>& in_code_streams,
+        const std::vector<ICodeStream*>& out_code_streams, const nvimgcodecTransformParams_t* params);
+
+  private:
+    struct Transformer
+    {
+        const nvimgcodecTransformerDesc_t* desc_;
+        nvimgcodecTransformer_t handle_;
+    };
+
+    const std::vector<Transformer>& getTransformers(const ICodec* codec);
+
+    ILogger* logger_;
+    std::mutex transformers_mutex_;
+    std::map<const ICodec*, std::vector<Transformer>> transformers_;
+    ICodecRegistry* codec_registry_;
+    nvimgcodecExecutionParams_t exec_params_;
+    std::vector<nvimgcodecBackend_t> backends_;
+    std::string options_;
+    std::unique_ptr<IExecutor> executor_;
+};
+
+} // namespace nvimgcodec
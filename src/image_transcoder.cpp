@@ -0,0 +1,494 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_transcoder.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <map>
+#include "exception.h"
+#include "icode_stream.h"
+#include "image.h"
+#include "image_generic_decoder.h"
+#include "image_generic_encoder.h"
+#include "log.h"
+#include "nvimgcodec_type_utils.h"
+
+namespace nvimgcodec {
+
+/**
+ * @brief Recycles intermediate buffers and bounds the bytes handed out at a time
+ */
+class ImageTranscoder::BufferPool
+{
+  public:
+    BufferPool(nvimgcodecImageBufferKind_t buffer_kind, size_t max_bytes, const nvimgcodecHostAllocator_t* host_allocator)
+        : buffer_kind_(buffer_kind)
+        , max_bytes_(max_bytes)
+        , host_allocator_(host_allocator && host_allocator->host_malloc && host_allocator->host_free ? host_allocator : nullptr)
+    {
+    }
+
+    ~BufferPool()
+    {
+        assert(in_use_.empty());
+        for (auto& buffer : free_)
+            deallocate(buffer.first, buffer.second);
+    }
+
+    /**
+     * @brief Waits until the buffer fits the budget. A buffer is always granted when nothing else is in use.
+     */
+    void* acquire(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&]() { return fits(size); });
+        return take(size);
+    }
+
+    /**
+     * @brief Returns nullptr instead of waiting when the buffer does not fit the budget
+     */
+    void* tryAcquire(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return fits(size) ? take(size) : nullptr;
+    }
+
+    void release(void* ptr)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = in_use_.find(ptr);
+            assert(it != in_use_.end());
+            in_use_bytes_ -= it->second;
+            free_.emplace_back(it->first, it->second);
+            in_use_.erase(it);
+        }
+        cv_.notify_all();
+    }
+
+  private:
+    bool fits(size_t size) const { return max_bytes_ == 0 || in_use_bytes_ == 0 || in_use_bytes_ + size <= max_bytes_; }
+
+    void* take(size_t size)
+    {
+        // Best fit among the recycled buffers
+        auto best = free_.end();
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if (it->second >= size && (best == free_.end() || it->second < best->second))
+                best = it;
+        }
+        std::pair<void*, size_t> buffer;
+        if (best != free_.end()) {
+            buffer = *best;
+            free_.erase(best);
+        } else {
+            // Drop recycled buffers which are too small, so allocated memory stays within the budget
+            while (!free_.empty() && max_bytes_ != 0 && in_use_bytes_ + cachedBytes() + size > max_bytes_) {
+                deallocate(free_.front().first, free_.front().second);
+                free_.erase(free_.begin());
+            }
+            buffer = {allocate(size), size};
+        }
+        in_use_bytes_ += buffer.second;
+        in_use_.insert(buffer);
+        return buffer.first;
+    }
+
+    size_t cachedBytes() const
+    {
+        size_t total = 0;
+        for (auto& buffer : free_)
+            total += buffer.second;
+        return total;
+    }
+
+    void* allocate(size_t size)
+    {
+        void* ptr = nullptr;
+        if (buffer_kind_ == NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE) {
+            CHECK_CUDA(cudaMalloc(&ptr, size));
+        } else {
+            if (!host_allocator_)
+                ptr = std::malloc(size);
+            else if (host_allocator_->host_malloc(host_allocator_->host_ctx, &ptr, size, alignof(std::max_align_t)) != 0)
+                ptr = nullptr;
+            if (!ptr)
+                throw Exception(INTERNAL_ERROR, "Could not allocate intermediate host buffer");
+        }
+        return ptr;
+    }
+
+    void deallocate(void* ptr, size_t size)
+    {
+        if (buffer_kind_ == NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE)
+            cudaFree(ptr);
+        else if (host_allocator_)
+            host_allocator_->host_free(host_allocator_->host_ctx, ptr, size);
+        else
+            std::free(ptr);
+    }
+
+    nvimgcodecImageBufferKind_t buffer_kind_;
+    size_t max_bytes_;
+    const nvimgcodecHostAllocator_t* host_allocator_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::pair<void*, size_t>> free_;
+    std::map<void*, size_t> in_use_;
+    size_t in_use_bytes_ = 0;
+};
+
+ImageTranscoder::ImageTranscoder(ILogger* logger, ImageGenericDecoder* decoder, ImageGenericEncoder* encoder,
+    const std::vector<ICodeStream*>& in_code_streams, const std::vector<ICodeStream*>& out_code_streams,
+    const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+    const nvimgcodecTranscodeParams_t* transcode_params)
+    : logger_(logger)
+    , decoder_(decoder)
+    , encoder_(encoder)
+    , in_code_streams_(in_code_streams)
+    , out_code_streams_(out_code_streams)
+    , decode_params_(*decode_params)
+    , encode_params_(*encode_params)
+    , sample_format_(NVIMGCODEC_SAMPLEFORMAT_P_RGB)
+    , buffer_kind_(NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN)
+    , device_id_(decoder->getDeviceId())
+    , passthrough_(false)
+    , max_width_(0)
+    , max_height_(0)
+    , images_(in_code_streams.size())
+    , buffers_(in_code_streams.size(), nullptr)
+    , promise_(in_code_streams.size())
+{
+    assert(in_code_streams_.size() == out_code_streams_.size());
+    size_t max_in_flight_bytes = 0;
+    if (transcode_params) {
+        if (transcode_params->sample_format != NVIMGCODEC_SAMPLEFORMAT_UNKNOWN)
+            sample_format_ = transcode_params->sample_format;
+        buffer_kind_ = transcode_params->buffer_kind;
+        max_in_flight_bytes = transcode_params->max_in_flight_bytes;
+        passthrough_ = transcode_params->enable_passthrough;
+        max_width_ = transcode_params->max_width;
+        max_height_ = transcode_params->max_height;
+    }
+    if (buffer_kind_ == NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN)
+        buffer_kind_ = device_id_ == NVIMGCODEC_DEVICE_CPU_ONLY ? NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST
+                                                                : NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE;
+    if (buffer_kind_ != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE && buffer_kind_ != NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST)
+        throw Exception(INVALID_PARAMETER, "Unsupported buffer kind of intermediate images");
+    buffer_pool_ = std::make_unique<BufferPool>(buffer_kind_, max_in_flight_bytes, decoder->getHostAllocator());
+    for (auto& image : images_)
+        image = std::make_unique<Image>();
+}
+
+ImageTranscoder::~ImageTranscoder()
+{
+    if (decode_thread_.joinable())
+        decode_thread_.join();
+    if (encode_thread_.joinable())
+        encode_thread_.join();
+}
+
+std::unique_ptr<ProcessingResultsFuture> ImageTranscoder::start()
+{
+    auto future = promise_.getFuture();
+    if (in_code_streams_.empty())
+        return future;
+    encode_thread_ = std::thread(&ImageTranscoder::encodeLoop, this);
+    decode_thread_ = std::thread(&ImageTranscoder::decodeLoop, this);
+    return future;
+}
+
+bool ImageTranscoder::prepareImageInfo(int sample_idx, nvimgcodecImageInfo_t* image_info)
+{
+    *image_info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), nullptr};
+    if (in_code_streams_[sample_idx]->getImageInfo(image_info) != NVIMGCODEC_STATUS_SUCCESS)
+        return false;
+    if (image_info->num_planes == 0 || image_info->num_planes > NVIMGCODEC_MAX_NUM_PLANES)
+        return false;
+    image_info->struct_next = nullptr;
+
+    uint32_t height = image_info->plane_info[0].height;
+    uint32_t width = image_info->plane_info[0].width;
+    if (decode_params_.apply_exif_orientation && ((image_info->orientation.rotated / 90) % 2))
+        std::swap(height, width);
+
+    auto sample_type = image_info->plane_info[0].sample_type;
+    uint32_t precision = image_info->plane_info[0].precision;
+    uint32_t num_channels = std::max(image_info->num_planes, image_info->plane_info[0].num_channels);
+    uint32_t num_planes = 1;
+    switch (sample_format_) {
+    case NVIMGCODEC_SAMPLEFORMAT_I_UNCHANGED:
+        image_info->color_spec = NVIMGCODEC_COLORSPEC_UNCHANGED;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED:
+        image_info->color_spec = NVIMGCODEC_COLORSPEC_UNCHANGED;
+        num_planes = num_channels;
+        num_channels = 1;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_Y:
+        image_info->color_spec = NVIMGCODEC_COLORSPEC_GRAY;
+        num_channels = 1;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_I_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_I_BGR:
+        image_info->color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        num_channels = 3;
+        break;
+    case NVIMGCODEC_SAMPLEFORMAT_P_RGB:
+    case NVIMGCODEC_SAMPLEFORMAT_P_BGR:
+        image_info->color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        num_planes = 3;
+        num_channels = 1;
+        break;
+    default:
+        NVIMGCODEC_LOG_ERROR(logger_, "Unsupported sample format of intermediate images");
+        return false;
+    }
+
+    size_t row_stride = static_cast<size_t>(width) * num_channels * sample_type_to_bytes_per_element(sample_type);
+    image_info->sample_format = sample_format_;
+    image_info->chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+    image_info->num_planes = num_planes;
+    for (uint32_t p = 0; p < num_planes; p++) {
+        auto& plane = image_info->plane_info[p];
+        plane.height = height;
+        plane.width = width;
+        plane.num_channels = num_channels;
+        plane.sample_type = sample_type;
+        plane.precision = precision;
+        plane.row_stride = row_stride;
+    }
+    image_info->buffer_kind = buffer_kind_;
+    image_info->buffer_size = row_stride * height * num_planes;
+    image_info->buffer = nullptr;
+    image_info->cuda_stream = 0;
+    return true;
+}
+
+bool ImageTranscoder::canPassThrough(int sample_idx)
+{
+    if (!passthrough_)
+        return false;
+    auto in_code_stream = in_code_streams_[sample_idx];
+    auto out_code_stream = out_code_streams_[sample_idx];
+    if (in_code_stream->getCodecName() != "jpeg" || out_code_stream->getCodecName() != "jpeg")
+        return false;
+
+    nvimgcodecJpegQuantizationInfo_t quant_info{
+        NVIMGCODEC_STRUCTURE_TYPE_JPEG_QUANTIZATION_INFO, sizeof(nvimgcodecJpegQuantizationInfo_t), nullptr};
+    nvimgcodecJpegImageInfo_t jpeg_info{NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO, sizeof(nvimgcodecJpegImageInfo_t), &quant_info};
+    nvimgcodecImageInfo_t in_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &jpeg_info};
+    if (in_code_stream->getImageInfo(&in_info) != NVIMGCODEC_STATUS_SUCCESS)
+        return false;
+    nvimgcodecImageInfo_t out_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), nullptr};
+    if (out_code_stream->getImageInfo(&out_info) != NVIMGCODEC_STATUS_SUCCESS)
+        return false;
+
+    if (quant_info.estimated_quality <= 0 || quant_info.estimated_quality > static_cast<int>(encode_params_.quality))
+        return false;
+    if (in_info.chroma_subsampling != out_info.chroma_subsampling)
+        return false;
+    auto out_jpeg_info = static_cast<nvimgcodecJpegImageInfo_t*>(out_info.struct_next);
+    while (out_jpeg_info && out_jpeg_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO)
+        out_jpeg_info = static_cast<nvimgcodecJpegImageInfo_t*>(out_jpeg_info->struct_next);
+    if (out_jpeg_info && out_jpeg_info->encoding != NVIMGCODEC_JPEG_ENCODING_UNKNOWN && out_jpeg_info->encoding != jpeg_info.encoding)
+        return false;
+    if (decode_params_.apply_exif_orientation &&
+        (in_info.orientation.rotated % 360 != 0 || in_info.orientation.flip_x || in_info.orientation.flip_y))
+        return false;
+    if ((max_width_ && in_info.plane_info[0].width > max_width_) || (max_height_ && in_info.plane_info[0].height > max_height_))
+        return false;
+    return true;
+}
+
+ProcessingResult ImageTranscoder::passThrough(int sample_idx)
+{
+    nvimgcodecIoStreamDesc_t* in_io_stream = in_code_streams_[sample_idx]->getCodeStreamDesc()->io_stream;
+    nvimgcodecIoStreamDesc_t* out_io_stream = out_code_streams_[sample_idx]->getCodeStreamDesc()->io_stream;
+    size_t size = 0;
+    in_io_stream->size(in_io_stream->instance, &size);
+    void* data = nullptr;
+    std::vector<uint8_t> buffer;
+    in_io_stream->map(in_io_stream->instance, &data, 0, size);
+    if (!data) {
+        buffer.resize(size);
+        in_io_stream->seek(in_io_stream->instance, 0, SEEK_SET);
+        size_t read_nbytes = 0;
+        in_io_stream->read(in_io_stream->instance, &read_nbytes, buffer.data(), size);
+        if (read_nbytes != size)
+            return ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED);
+        data = buffer.data();
+    }
+
+    size_t written_size = 0;
+    out_io_stream->reserve(out_io_stream->instance, size);
+    out_io_stream->write(out_io_stream->instance, &written_size, data, size);
+    out_io_stream->flush(out_io_stream->instance);
+    if (data != buffer.data())
+        in_io_stream->unmap(in_io_stream->instance, data, size);
+    if (written_size != size)
+        return ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_FAIL);
+    return ProcessingResult::success();
+}
+
+void ImageTranscoder::decodeLoop()
+{
+    if (buffer_kind_ == NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE && device_id_ >= 0)
+        cudaSetDevice(device_id_);
+
+    int num_samples = static_cast<int>(in_code_streams_.size());
+    int next = 0;
+    while (next < num_samples) {
+        std::vector<int> chunk;
+        std::vector<bool> reported;
+        int admitting = -1;
+        try {
+            // Admit as many samples as the budget allows right now, waiting only for the first one
+            while (next < num_samples) {
+                admitting = next;
+                if (canPassThrough(next)) {
+                    NVIMGCODEC_LOG_DEBUG(logger_, "Passing sample #" << next << " through unchanged");
+                    finish(next, passThrough(next));
+                    next++;
+                    continue;
+                }
+                nvimgcodecImageInfo_t image_info;
+                if (!prepareImageInfo(next, &image_info)) {
+                    NVIMGCODEC_LOG_WARNING(logger_, "Could not prepare intermediate image for sample #" << next);
+                    finish(next++, ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED));
+                    continue;
+                }
+                void* buffer =
+                    chunk.empty() ? buffer_pool_->acquire(image_info.buffer_size) : buffer_pool_->tryAcquire(image_info.buffer_size);
+                if (!buffer)
+                    break;
+                image_info.buffer = buffer;
+                buffers_[next] = buffer;
+                images_[next]->setImageInfo(&image_info);
+                chunk.push_back(next++);
+            }
+            admitting = -1;
+            if (chunk.empty())
+                continue;
+
+            reported.resize(chunk.size(), false);
+            std::vector<ICodeStream*> code_streams(chunk.size());
+            std::vector<IImage*> images(chunk.size());
+            for (size_t i = 0; i < chunk.size(); i++) {
+                code_streams[i] = in_code_streams_[chunk[i]];
+                images[i] = images_[chunk[i]].get();
+            }
+            auto future = decoder_->decode(code_streams, images, &decode_params_);
+            size_t num_reported = 0;
+            while (num_reported < chunk.size()) {
+                auto ready = future->waitForNew();
+                for (size_t k = 0; k < ready.second; k++) {
+                    int i = ready.first[k];
+                    int sample_idx = chunk[i];
+                    auto result = future->getOne(i);
+                    reported[i] = true;
+                    if (result.isSuccess()) {
+                        pushDecoded(sample_idx);
+                    } else {
+                        buffer_pool_->release(buffers_[sample_idx]);
+                        finish(sample_idx, result);
+                    }
+                }
+                num_reported += ready.second;
+            }
+        } catch (...) {
+            NVIMGCODEC_LOG_ERROR(logger_, "Transcode failed to decode a batch of samples");
+            if (admitting >= 0) {
+                finish(admitting, ProcessingResult::failure(std::current_exception()));
+                next = admitting + 1;
+            }
+            for (size_t i = 0; i < chunk.size(); i++) {
+                if (i < reported.size() && reported[i])
+                    continue;
+                buffer_pool_->release(buffers_[chunk[i]]);
+                finish(chunk[i], ProcessingResult::failure(std::current_exception()));
+            }
+        }
+    }
+    closeQueue();
+}
+
+void ImageTranscoder::encodeLoop()
+{
+    if (buffer_kind_ == NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_DEVICE && device_id_ >= 0)
+        cudaSetDevice(device_id_);
+
+    std::vector<int> batch;
+    while (popDecoded(&batch)) {
+        std::vector<ProcessingResult> results;
+        try {
+            std::vector<ICodeStream*> code_streams(batch.size());
+            std::vector<IImage*> images(batch.size());
+            for (size_t i = 0; i < batch.size(); i++) {
+                code_streams[i] = out_code_streams_[batch[i]];
+                images[i] = images_[batch[i]].get();
+            }
+            results = encoder_->encode(images, code_streams, &encode_params_)->getAllCopy();
+        } catch (...) {
+            NVIMGCODEC_LOG_ERROR(logger_, "Transcode failed to encode a batch of samples");
+            results.assign(batch.size(), ProcessingResult::failure(std::current_exception()));
+        }
+        for (size_t i = 0; i < batch.size(); i++) {
+            buffer_pool_->release(buffers_[batch[i]]);
+            finish(batch[i], results[i]);
+        }
+    }
+}
+
+void ImageTranscoder::pushDecoded(int sample_idx)
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        decoded_.push_back(sample_idx);
+    }
+    queue_cv_.notify_one();
+}
+
+bool ImageTranscoder::popDecoded(std::vector<int>* sample_indices)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    queue_cv_.wait(lock, [&]() { return !decoded_.empty() || decoding_done_; });
+    // Everything decoded so far goes into one encode batch
+    sample_indices->assign(decoded_.begin(), decoded_.end());
+    decoded_.clear();
+    return !sample_indices->empty();
+}
+
+void ImageTranscoder::closeQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        decoding_done_ = true;
+    }
+    queue_cv_.notify_one();
+}
+
+void ImageTranscoder::finish(int sample_idx, ProcessingResult result)
+{
+    buffers_[sample_idx] = nullptr;
+    promise_.set(sample_idx, std::move(result));
+}
+
+} // namespace nvimgcodec
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "processing_results.h"
+
+namespace nvimgcodec {
+
+class ICodeStream;
+class ILogger;
+class Image;
+class ImageGenericDecoder;
+class ImageGenericEncoder;
+
+/**
+ * @brief Streams samples from a decoder straight into an encoder
+ *
+ * Decoding and encoding run on their own threads. Every decoded sample is queued for the encoder immediately,
+ * so both stages are busy at the same time. Intermediate buffers come from a pool bounded by
+ * max_in_flight_bytes and are recycled as soon as a sample is encoded.
+ * With passthrough enabled, JPEG samples which already satisfy the target are copied as they are.
+ */
+class ImageTranscoder
+{
+  public:
+    ImageTranscoder(ILogger* logger, ImageGenericDecoder* decoder, ImageGenericEncoder* encoder,
+        const std::vector<ICodeStream*>& in_code_streams, const std::vector<ICodeStream*>& out_code_streams,
+        const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+        const nvimgcodecTranscodeParams_t* transcode_params);
+    ~ImageTranscoder();
+
+    /**
+     * @brief Starts the pipeline and returns the future of per sample results
+     */
+    std::unique_ptr<ProcessingResultsFuture> start();
+
+  private:
+    class BufferPool;
+
+    bool prepareImageInfo(int sample_idx, nvimgcodecImageInfo_t* image_info);
+    bool canPassThrough(int sample_idx);
+    ProcessingResult passThrough(int sample_idx);
+    void decodeLoop();
+    void encodeLoop();
+    void pushDecoded(int sample_idx);
+    bool popDecoded(std::vector<int>* sample_indices);
+    void closeQueue();
+    void finish(int sample_idx, ProcessingResult result);
+
+    ILogger* logger_;
+    ImageGenericDecoder* decoder_;
+    ImageGenericEncoder* encoder_;
+    std::vector<ICodeStream*> in_code_streams_;
+    std::vector<ICodeStream*> out_code_streams_;
+    nvimgcodecDecodeParams_t decode_params_;
+    nvimgcodecEncodeParams_t encode_params_;
+    nvimgcodecSampleFormat_t sample_format_;
+    nvimgcodecImageBufferKind_t buffer_kind_;
+    int device_id_;
+    bool passthrough_;
+    uint32_t max_width_;
+    uint32_t max_height_;
+
+    std::unique_ptr<BufferPool> buffer_pool_;
+    std::vector<std::unique_ptr<Image>> images_;
+    std::vector<void*> buffers_;
+    ProcessingResultsPromise promise_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::deque<int> decoded_;
+    bool decoding_done_ = false;
+
+    std::thread decode_thread_;
+    std::thread encode_thread_;
+};
+
+} // namespace nvimgcodec
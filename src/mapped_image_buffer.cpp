@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_image_buffer.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace nvimgcodec {
+
+MappedImageBuffer::MappedImageBuffer(const std::string& path, size_t size)
+    : path_(path)
+    , size_(size)
+{
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw std::runtime_error("Could not create file " + path + ": " + std::strerror(errno));
+    // A truncated file is sparse, so space is only allocated for pages which are written
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        int err = errno;
+        close(fd_);
+        throw std::runtime_error("Could not resize file " + path + ": " + std::strerror(err));
+    }
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        int err = errno;
+        close(fd_);
+        throw std::runtime_error("File mapping failed: " + path + ": " + std::strerror(err));
+    }
+    data_ = p;
+    // Decoders write rows, or rows of tiles, from top to bottom
+    madvise(data_, size_, MADV_SEQUENTIAL);
+}
+
+MappedImageBuffer::~MappedImageBuffer()
+{
+    // Dirty pages stay in the page cache and are written back by the kernel after unmapping
+    munmap(data_, size_);
+    close(fd_);
+}
+
+void MappedImageBuffer::sync()
+{
+    if (msync(data_, size_, MS_SYNC) != 0)
+        throw std::runtime_error("Could not sync file " + path_ + ": " + std::strerror(errno));
+}
+
+} // namespace nvimgcodec
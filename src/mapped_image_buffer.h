@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace nvimgcodec {
+
+/**
+ * @brief Image buffer backed by a shared, writable mapping of a file
+ *
+ * The file is created, or truncated, to the requested size. Decoded samples written to the buffer
+ * end up in the file, so images larger than the host memory can be decoded and persisted.
+ */
+class MappedImageBuffer
+{
+  public:
+    MappedImageBuffer(const std::string& path, size_t size);
+    ~MappedImageBuffer();
+    MappedImageBuffer(const MappedImageBuffer&) = delete;
+    MappedImageBuffer& operator=(const MappedImageBuffer&) = delete;
+
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /** Writes dirty pages back to the file and waits for completion. */
+    void sync();
+
+  private:
+    std::string path_;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+};
+
+} // namespace nvimgcodec
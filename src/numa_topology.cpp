@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "numa_topology.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+namespace nvimgcodec {
+
+std::vector<int> ParseCpuList(const std::string& cpu_list)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(cpu_list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
+            range.end());
+        if (range.empty())
+            continue;
+        char* end = nullptr;
+        long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (end == range.c_str())
+            return {};
+        if (*end == '-') {
+            const char* last_str = end + 1;
+            last = std::strtol(last_str, &end, 10);
+            if (end == last_str)
+                return {};
+        }
+        if (*end != '\0' || first < 0 || last < first)
+            return {};
+        for (long cpu = first; cpu <= last; cpu++)
+            cpus.push_back(static_cast<int>(cpu));
+    }
+    return cpus;
+}
+
+std::vector<NumaNode> ReadNumaTopology(const std::string& sysfs_node_dir)
+{
+    namespace fs = std::filesystem;
+    std::vector<NumaNode> nodes;
+    std::error_code ec;
+    for (fs::directory_iterator it(sysfs_node_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+            continue;
+        std::ifstream cpulist(it->path() / "cpulist");
+        std::string line;
+        if (!std::getline(cpulist, line))
+            continue;
+        auto cpus = ParseCpuList(line);
+        if (!cpus.empty())
+            nodes.push_back({std::stoi(name.substr(4)), std::move(cpus)});
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+std::vector<NumaNode> GetNumaTopology()
+{
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return {};
+    auto nodes = ReadNumaTopology("/sys/devices/system/node");
+    for (auto& node : nodes) {
+        node.cpus.erase(std::remove_if(node.cpus.begin(), node.cpus.end(),
+                            [&allowed](int cpu) { return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed); }),
+            node.cpus.end());
+    }
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const NumaNode& node) { return node.cpus.empty(); }), nodes.end());
+    return nodes;
+#else
+    return {};
+#endif
+}
+
+std::vector<int> PartitionThreads(const std::vector<NumaNode>& nodes, int num_threads)
+{
+    int num_nodes = static_cast<int>(nodes.size());
+    if (num_nodes == 0 || num_threads < num_nodes)
+        return {};
+    size_t total_cpus = 0;
+    for (auto& node : nodes)
+        total_cpus += node.cpus.size();
+
+    // One thread per node, and the rest split by the largest remainder method
+    int extra = num_threads - num_nodes;
+    std::vector<int> threads(num_nodes, 1);
+    std::vector<std::pair<size_t, int>> remainders(num_nodes);
+    int assigned = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        size_t share = static_cast<size_t>(extra) * nodes[i].cpus.size();
+        threads[i] += static_cast<int>(share / total_cpus);
+        assigned += static_cast<int>(share / total_cpus);
+        remainders[i] = {share % total_cpus, i};
+    }
+    std::stable_sort(remainders.begin(), remainders.end(), [](auto& a, auto& b) { return a.first > b.first; });
+    for (int i = 0; assigned < extra; i++, assigned++)
+        threads[remainders[i].second]++;
+    return threads;
+}
+
+bool SetThreadCpus(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+    return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace nvimgcodec
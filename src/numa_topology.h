@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace nvimgcodec {
+
+/**
+ * @brief NUMA node and the CPUs it contains
+ */
+struct NumaNode
+{
+    int id;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief Parses a sysfs CPU list, e.g. "0-3,8,10-11". Returns an empty list if it is malformed.
+ */
+std::vector<int> ParseCpuList(const std::string& cpu_list);
+
+/**
+ * @brief Reads the nodes with CPUs from a sysfs node directory, e.g. /sys/devices/system/node, sorted by id.
+ *
+ * Returns an empty list if the directory doesn't exist.
+ */
+std::vector<NumaNode> ReadNumaTopology(const std::string& sysfs_node_dir);
+
+/**
+ * @brief Nodes of the host with CPUs the process is allowed to run on. Empty if the topology is unknown.
+ */
+std::vector<NumaNode> GetNumaTopology();
+
+/**
+ * @brief Splits num_threads threads between the nodes proportionally to their number of CPUs, at least one per node.
+ *
+ * Returns an empty list if there are fewer threads than nodes.
+ */
+std::vector<int> PartitionThreads(const std::vector<NumaNode>& nodes, int num_threads);
+
+/**
+ * @brief Samples run by the node with threads [first_thread, first_thread + num_threads) out of total_threads.
+ *
+ * Samples are dealt in rounds of total_threads, each node taking a contiguous run of as many samples as it has threads,
+ * i.e. sample i goes to the node running thread i % total_threads. The node of a sample only depends on its index,
+ * so that tasks launched one at a time and in batches are placed alike.
+ */
+struct NodeSamples
+{
+    int first_thread;
+    int num_threads;
+    int total_threads;
+
+    bool contains(int sample_idx) const
+    {
+        int slot = sample_idx % total_threads;
+        return slot >= first_thread && slot < first_thread + num_threads;
+    }
+
+    // Number of samples of the node among samples [0, num_samples)
+    int count(int num_samples) const
+    {
+        int rest = num_samples % total_threads - first_thread;
+        return num_samples / total_threads * num_threads + std::clamp(rest, 0, num_threads);
+    }
+
+    // Index of the task_idx-th sample of the node
+    int sample(int task_idx) const { return task_idx / num_threads * total_threads + first_thread + task_idx % num_threads; }
+};
+
+/**
+ * @brief Restricts the calling thread to the given CPUs. Returns false if it is not supported or fails.
+ */
+bool SetThreadCpus(const std::vector<int>& cpus);
+
+} // namespace nvimgcodec
@@ -19,8 +19,11 @@
 #include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "code_stream.h"
 #include "codec_registry.h"
@@ -34,7 +37,10 @@
 #include "image.h"
 #include "image_generic_decoder.h"
 #include "image_generic_encoder.h"
+#include "image_generic_transformer.h"
+#include "image_transcoder.h"
 #include "log.h"
+#include "mapped_image_buffer.h"
 #include "nvimgcodec_director.h"
 #include "nvimgcodec_type_utils.h"
 #include "plugin_framework.h"
@@ -115,6 +121,64 @@ __inline__ nvimgcodecStatus_t getCAPICode(Status status)
         }
 #endif
 
+struct nvimgcodecImage
+{
+    nvimgcodecInstance_t nvimgcodec_instance_;
+    Image image_;
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+    std::unique_ptr<MappedImageBuffer> mapped_buffer_;
+#endif
+};
+
+// Image handles released by nvimgcodecImageDestroy, handed out again by nvimgcodecImageCreate, so that creating images
+// for every sample of every batch doesn't construct and register a new object each time
+class ImageHandlePool
+{
+  public:
+    static constexpr size_t kMaxPooled = 1024;
+
+    ~ImageHandlePool()
+    {
+        for (auto* image : free_)
+            delete image;
+    }
+
+    nvimgcodecImage* acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                auto* image = free_.back();
+                free_.pop_back();
+                return image;
+            }
+        }
+        return new nvimgcodecImage();
+    }
+
+    void release(nvimgcodecImage* image)
+    {
+        // A reused handle must not carry anything over from its previous life, e.g. a dangling struct_next or promise
+        image->nvimgcodec_instance_ = nullptr;
+        image->image_.reset();
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+        image->mapped_buffer_.reset();
+#endif
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (free_.size() < kMaxPooled) {
+                free_.push_back(image);
+                return;
+            }
+        }
+        delete image;
+    }
+
+  private:
+    std::mutex mutex_;
+    std::vector<nvimgcodecImage*> free_;
+};
+
 struct nvimgcodecInstance
 {
     nvimgcodecInstance(const nvimgcodecInstanceCreateInfo_t* create_info)
@@ -122,11 +186,13 @@ struct nvimgcodecInstance
     {
     }
     NvImgCodecDirector director_;
+    ImageHandlePool image_pool_;
 };
 
 struct nvimgcodecFuture
 {
     std::unique_ptr<ProcessingResultsFuture> handle_;
+    std::unique_ptr<ImageTranscoder> transcoder_;
 };
 
 struct nvimgcodecDecoder
@@ -141,6 +207,12 @@ struct nvimgcodecEncoder
     std::unique_ptr<ImageGenericEncoder> image_encoder_;
 };
 
+struct nvimgcodecTransformer
+{
+    nvimgcodecInstance_t instance_;
+    std::unique_ptr<ImageGenericTransformer> image_transformer_;
+};
+
 struct nvimgcodecDebugMessenger
 {
     nvimgcodecInstance_t instance_;
@@ -163,11 +235,41 @@ struct nvimgcodecCodeStream
     std::unique_ptr<CodeStream> code_stream_;
 };
 
-struct nvimgcodecImage
+static nvimgcodecStatus_t checkImageInfo(const nvimgcodecImageInfo_t* image_info)
 {
-    nvimgcodecInstance_t nvimgcodec_instance_;
-    Image image_;
-};
+    if (image_info->buffer_kind == NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN || image_info->buffer_kind == NVIMGCODEC_IMAGE_BUFFER_KIND_UNSUPPORTED) {
+        NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Unknown or unsupported buffer kind");
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+// The mapping is sized by buffer_size alone, so it has to hold every plane the decoders will write
+static nvimgcodecStatus_t checkMappedImageInfo(const nvimgcodecImageInfo_t* image_info)
+{
+    if (image_info->num_planes == 0 || image_info->num_planes > NVIMGCODEC_MAX_NUM_PLANES) {
+        NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Invalid number of planes: " << image_info->num_planes);
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+    size_t required_size = 0;
+    for (uint32_t p = 0; p < image_info->num_planes; p++) {
+        const auto& plane = image_info->plane_info[p];
+        size_t row_size = static_cast<size_t>(plane.width) * plane.num_channels * sample_type_to_bytes_per_element(plane.sample_type);
+        if (plane.row_stride < row_size) {
+            NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Row stride of plane " << p << " is smaller than its row: " << plane.row_stride);
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        required_size += plane.row_stride * plane.height;
+    }
+    if (image_info->buffer_size < required_size) {
+        NVIMGCODEC_LOG_ERROR(Logger::get_default(),
+            "Buffer size of a file mapped image is too small: " << image_info->buffer_size << " < " << required_size);
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+#endif
 
 nvimgcodecStatus_t nvimgcodecGetProperties(nvimgcodecProperties_t* properties)
 {
@@ -221,6 +323,19 @@ nvimgcodecStatus_t nvimgcodecInstanceDestroy(nvimgcodecInstance_t instance)
     return ret;
 }
 
+nvimgcodecStatus_t nvimgcodecInstanceGetScratchArenaStats(nvimgcodecInstance_t instance, nvimgcodecScratchArenaStats_t* stats)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(instance)
+            CHECK_NULL(stats)
+            instance->director_.plugin_framework_.getScratchArenaStats(stats);
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
 nvimgcodecStatus_t nvimgcodecExtensionCreate(
     nvimgcodecInstance_t instance, nvimgcodecExtension_t* extension, nvimgcodecExtensionDesc_t* extension_desc)
 {
@@ -454,6 +569,19 @@ nvimgcodecStatus_t nvimgcodecDecoderDecode(nvimgcodecDecoder_t decoder, const nv
     return ret;
 }
 
+nvimgcodecStatus_t nvimgcodecDecoderGetDeduplicationStats(nvimgcodecDecoder_t decoder, nvimgcodecDeduplicationStats_t* stats)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(decoder)
+            CHECK_NULL(stats)
+            decoder->image_decoder_->getDeduplicationStats(stats);
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
 nvimgcodecStatus_t nvimgcodecImageCreate(nvimgcodecInstance_t instance, nvimgcodecImage_t* image, const nvimgcodecImageInfo_t* image_info)
 {
     nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
@@ -464,15 +592,67 @@ nvimgcodecStatus_t nvimgcodecImageCreate(nvimgcodecInstance_t instance, nvimgcod
             CHECK_NULL(instance)
             CHECK_NULL(image_info)
             CHECK_NULL(image_info->buffer)
-            if (image_info->buffer_kind == NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN ||
-                image_info->buffer_kind == NVIMGCODEC_IMAGE_BUFFER_KIND_UNSUPPORTED) {
-                NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Unknown or unsupported buffer kind");
+            if (auto status = checkImageInfo(image_info); status != NVIMGCODEC_STATUS_SUCCESS)
+                return status;
+
+            *image = instance->image_pool_.acquire();
+            (*image)->image_.setImageInfo(image_info);
+            (*image)->nvimgcodec_instance_ = instance;
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
+nvimgcodecStatus_t nvimgcodecImageCreateFileMapped(
+    nvimgcodecInstance_t instance, nvimgcodecImage_t* image, nvimgcodecImageInfo_t* image_info, const char* file_path)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(image)
+            CHECK_NULL(instance)
+            CHECK_NULL(image_info)
+            CHECK_NULL(file_path)
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+            if (image_info->buffer_size == 0) {
+                NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Buffer size of a file mapped image has to be provided");
                 return NVIMGCODEC_STATUS_INVALID_PARAMETER;
             }
+            if (auto status = checkMappedImageInfo(image_info); status != NVIMGCODEC_STATUS_SUCCESS)
+                return status;
+            auto mapped_buffer = std::make_unique<MappedImageBuffer>(file_path, image_info->buffer_size);
+            image_info->buffer = mapped_buffer->data();
+            image_info->buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
 
-            *image = new nvimgcodecImage();
+            *image = instance->image_pool_.acquire();
             (*image)->image_.setImageInfo(image_info);
             (*image)->nvimgcodec_instance_ = instance;
+            (*image)->mapped_buffer_ = std::move(mapped_buffer);
+#else
+            NVIMGCODEC_LOG_ERROR(Logger::get_default(), "File mapped images are not supported by platform");
+            return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED;
+#endif
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
+nvimgcodecStatus_t nvimgcodecImageSync(nvimgcodecImage_t image)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(image)
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+            if (!image->mapped_buffer_) {
+                NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Image is not backed by a file");
+                return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+            }
+            image->mapped_buffer_->sync();
+#else
+            return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED;
+#endif
         }
     NVIMGCODECAPI_CATCH(ret)
     return ret;
@@ -484,7 +664,7 @@ nvimgcodecStatus_t nvimgcodecImageDestroy(nvimgcodecImage_t image)
     NVIMGCODECAPI_TRY
         {
             CHECK_NULL(image)
-            delete image;
+            image->nvimgcodec_instance_->image_pool_.release(image);
         }
     NVIMGCODECAPI_CATCH(ret)
     return ret;
@@ -502,6 +682,28 @@ nvimgcodecStatus_t nvimgcodecImageGetImageInfo(nvimgcodecImage_t image, nvimgcod
     return ret;
 }
 
+nvimgcodecStatus_t nvimgcodecImageSetImageInfo(nvimgcodecImage_t image, const nvimgcodecImageInfo_t* image_info)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(image)
+            CHECK_NULL(image_info)
+            CHECK_NULL(image_info->buffer)
+            if (auto status = checkImageInfo(image_info); status != NVIMGCODEC_STATUS_SUCCESS)
+                return status;
+#ifdef NVIMGCODEC_HAVE_MAPPED_IMAGES
+            if (image->mapped_buffer_) {
+                NVIMGCODEC_LOG_ERROR(Logger::get_default(), "Image backed by a file cannot be updated");
+                return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+            }
+#endif
+            image->image_.setImageInfo(image_info);
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
 NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecEncoderCreate(nvimgcodecInstance_t instance, nvimgcodecEncoder_t* encoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
 {
     nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
@@ -589,6 +791,105 @@ nvimgcodecStatus_t nvimgcodecEncoderEncode(nvimgcodecEncoder_t encoder, const nv
     return ret;
 }
 
+NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerCreate(nvimgcodecInstance_t instance, nvimgcodecTransformer_t* transformer,
+    const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(instance)
+            CHECK_NULL(transformer)
+            CHECK_NULL(exec_params)
+            std::unique_ptr<ImageGenericTransformer> image_transformer =
+                instance->director_.createGenericTransformer(exec_params, options);
+            *transformer = new nvimgcodecTransformer();
+            (*transformer)->image_transformer_ = std::move(image_transformer);
+            (*transformer)->instance_ = instance;
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
+NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerDestroy(nvimgcodecTransformer_t transformer)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(transformer)
+            delete transformer;
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
+NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTransformerTransform(nvimgcodecTransformer_t transformer,
+    const nvimgcodecCodeStream_t* in_streams, const nvimgcodecCodeStream_t* out_streams, int batch_size,
+    const nvimgcodecTransformParams_t* params, nvimgcodecFuture_t* future)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(transformer)
+            CHECK_NULL(in_streams)
+            CHECK_NULL(out_streams)
+            CHECK_NULL(params)
+            CHECK_NULL(future)
+
+            std::vector<nvimgcodec::ICodeStream*> internal_in_streams;
+            std::vector<nvimgcodec::ICodeStream*> internal_out_streams;
+
+            for (int i = 0; i < batch_size; ++i) {
+                internal_in_streams.push_back(in_streams[i]->code_stream_.get());
+                internal_out_streams.push_back(out_streams[i]->code_stream_.get());
+            }
+
+            *future = new nvimgcodecFuture();
+
+            (*future)->handle_ =
+                std::move(transformer->image_transformer_->transform(internal_in_streams, internal_out_streams, params));
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
+NVIMGCODECAPI nvimgcodecStatus_t nvimgcodecTranscode(nvimgcodecDecoder_t decoder, nvimgcodecEncoder_t encoder,
+    const nvimgcodecCodeStream_t* in_streams, const nvimgcodecCodeStream_t* out_streams, int batch_size,
+    const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+    const nvimgcodecTranscodeParams_t* transcode_params, nvimgcodecFuture_t* future)
+{
+    nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
+
+    NVIMGCODECAPI_TRY
+        {
+            CHECK_NULL(decoder)
+            CHECK_NULL(encoder)
+            CHECK_NULL(in_streams)
+            CHECK_NULL(out_streams)
+            CHECK_NULL(decode_params)
+            CHECK_NULL(encode_params)
+            CHECK_NULL(future)
+
+            std::vector<nvimgcodec::ICodeStream*> internal_in_streams;
+            std::vector<nvimgcodec::ICodeStream*> internal_out_streams;
+
+            for (int i = 0; i < batch_size; ++i) {
+                internal_in_streams.push_back(in_streams[i]->code_stream_.get());
+                internal_out_streams.push_back(out_streams[i]->code_stream_.get());
+            }
+
+            auto transcoder = decoder->instance_->director_.createTranscoder(decoder->image_decoder_.get(), encoder->image_encoder_.get(),
+                internal_in_streams, internal_out_streams, decode_params, encode_params, transcode_params);
+            *future = new nvimgcodecFuture();
+            (*future)->handle_ = transcoder->start();
+            // Destroying the future joins the pipeline threads before the results go away
+            (*future)->transcoder_ = std::move(transcoder);
+        }
+    NVIMGCODECAPI_CATCH(ret)
+    return ret;
+}
+
 nvimgcodecStatus_t nvimgcodecDebugMessengerCreate(
     nvimgcodecInstance_t instance, nvimgcodecDebugMessenger_t* dbgMessenger, const nvimgcodecDebugMessengerDesc_t* messengerDesc)
 {
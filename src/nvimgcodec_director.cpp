@@ -27,12 +27,21 @@
 
 namespace nvimgcodec {
 
+static size_t getMaxScratchRetainedSize(const nvimgcodecInstanceCreateInfo_t* create_info)
+{
+    auto* ext = static_cast<const nvimgcodecScratchArenaParams_t*>(create_info->struct_next);
+    while (ext && ext->struct_type != NVIMGCODEC_STRUCTURE_TYPE_SCRATCH_ARENA_PARAMS)
+        ext = static_cast<const nvimgcodecScratchArenaParams_t*>(ext->struct_next);
+    return ext && ext->max_retained_size ? ext->max_retained_size : ScratchArenas::kDefaultMaxRetainedSize;
+}
+
 NvImgCodecDirector::NvImgCodecDirector(const nvimgcodecInstanceCreateInfo_t* create_info)
     : logger_("nvimgcodec")
     , default_debug_messenger_manager_(&logger_, create_info)
     , codec_registry_(&logger_)
     , plugin_framework_(&logger_, &codec_registry_, std::move(std::make_unique<Environment>()),
-          std::move(std::make_unique<DirectoryScaner>()), std::move(std::make_unique<LibraryLoader>()), create_info->extension_modules_path ? create_info->extension_modules_path : "")
+          std::move(std::make_unique<DirectoryScaner>()), std::move(std::make_unique<LibraryLoader>()), create_info->extension_modules_path ? create_info->extension_modules_path : "",
+          getMaxScratchRetainedSize(create_info))
 {
     if (create_info->load_builtin_modules) {
         for (auto builtin_ext : get_builtin_modules())
@@ -65,6 +74,21 @@ std::unique_ptr<ImageGenericEncoder> NvImgCodecDirector::createGenericEncoder(
     return std::make_unique<ImageGenericEncoder>(&logger_, &codec_registry_, exec_params, options);
 }
 
+std::unique_ptr<ImageGenericTransformer> NvImgCodecDirector::createGenericTransformer(
+    const nvimgcodecExecutionParams_t* exec_params, const char* options)
+{
+    return std::make_unique<ImageGenericTransformer>(&logger_, &codec_registry_, exec_params, options);
+}
+
+std::unique_ptr<ImageTranscoder> NvImgCodecDirector::createTranscoder(ImageGenericDecoder* decoder, ImageGenericEncoder* encoder,
+    const std::vector<ICodeStream*>& in_code_streams, const std::vector<ICodeStream*>& out_code_streams,
+    const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+    const nvimgcodecTranscodeParams_t* transcode_params)
+{
+    return std::make_unique<ImageTranscoder>(
+        &logger_, decoder, encoder, in_code_streams, out_code_streams, decode_params, encode_params, transcode_params);
+}
+
 void NvImgCodecDirector::registerDebugMessenger(IDebugMessenger* messenger)
 {
     logger_.registerDebugMessenger(messenger);
@@ -26,6 +26,8 @@
 #include "default_debug_messenger.h"
 #include "image_generic_decoder.h"
 #include "image_generic_encoder.h"
+#include "image_generic_transformer.h"
+#include "image_transcoder.h"
 #include "log.h"
 #include "logger.h"
 #include "plugin_framework.h"
@@ -68,6 +70,11 @@ class NvImgCodecDirector
     std::unique_ptr<CodeStream> createCodeStream();
     std::unique_ptr<ImageGenericDecoder> createGenericDecoder(const nvimgcodecExecutionParams_t* exec_params, const char* options);
     std::unique_ptr<ImageGenericEncoder> createGenericEncoder(const nvimgcodecExecutionParams_t* exec_params, const char* options);
+    std::unique_ptr<ImageGenericTransformer> createGenericTransformer(const nvimgcodecExecutionParams_t* exec_params, const char* options);
+    std::unique_ptr<ImageTranscoder> createTranscoder(ImageGenericDecoder* decoder, ImageGenericEncoder* encoder,
+        const std::vector<ICodeStream*>& in_code_streams, const std::vector<ICodeStream*>& out_code_streams,
+        const nvimgcodecDecodeParams_t* decode_params, const nvimgcodecEncodeParams_t* encode_params,
+        const nvimgcodecTranscodeParams_t* transcode_params);
     void registerDebugMessenger(IDebugMessenger* messenger);
     void unregisterDebugMessenger(IDebugMessenger* messenger);
 
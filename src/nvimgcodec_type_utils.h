@@ -18,9 +18,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include "nvimgcodec.h"
 
 inline size_t sample_type_to_bytes_per_element(nvimgcodecSampleDataType_t sample_type)
 {
     return static_cast<unsigned int>(sample_type)>> (8+3);
-}
\ No newline at end of file
+}
+
+// Copies execution parameters of a client which may be built against an older, smaller structure.
+// Only struct_size bytes are read, the members past them are zeroed and struct_size is set to the current size.
+inline nvimgcodecExecutionParams_t copy_execution_params(const nvimgcodecExecutionParams_t* exec_params)
+{
+    nvimgcodecExecutionParams_t copy{};
+    std::memcpy(&copy, exec_params, std::min(exec_params->struct_size, sizeof(copy)));
+    copy.struct_size = sizeof(copy);
+    return copy;
+}
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <cstdint>
+#include <cstring>
+
+namespace nvimgcodec {
+
+/**
+ * @brief Returns the ICC profile structure chained to the image info, or nullptr if there is none
+ */
+inline nvimgcodecIccProfile_t* GetIccProfileInfo(nvimgcodecImageInfo_t* image_info)
+{
+    auto* icc_info = reinterpret_cast<nvimgcodecIccProfile_t*>(image_info->struct_next);
+    while (icc_info && icc_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE)
+        icc_info = reinterpret_cast<nvimgcodecIccProfile_t*>(icc_info->struct_next);
+    return icc_info;
+}
+
+/**
+ * @brief Reports the embedded profile, copying it only if the buffer provided is large enough
+ */
+inline void SetIccProfile(nvimgcodecIccProfile_t* icc_info, const uint8_t* data, size_t size)
+{
+    icc_info->profile_size = size;
+    if (size > 0 && icc_info->buffer && icc_info->buffer_size >= size)
+        memcpy(icc_info->buffer, data, size);
+}
+
+} // namespace nvimgcodec
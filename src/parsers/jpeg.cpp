@@ -18,7 +18,10 @@
 #include "parsers/jpeg.h"
 #include <nvimgcodec.h>
 #include <string.h>
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <limits>
 #include <vector>
 
 #include "exception.h"
@@ -27,11 +30,14 @@
 
 #include "parsers/byte_io.h"
 #include "parsers/exif.h"
+#include "parsers/icc_profile.h"
+#include "parsers/stream_validation.h"
 
 namespace nvimgcodec {
 
 using jpeg_marker_t = std::array<uint8_t, 2>;
 using jpeg_exif_header_t = std::array<uint8_t, 6>;
+using jpeg_icc_header_t = std::array<uint8_t, 12>;
 
 namespace {
 
@@ -39,9 +45,58 @@ constexpr jpeg_marker_t sos_marker = {0xff, 0xda};
 constexpr jpeg_marker_t soi_marker = {0xff, 0xd8};
 constexpr jpeg_marker_t eoi_marker = {0xff, 0xd9};
 constexpr jpeg_marker_t app1_marker = {0xff, 0xe1};
+constexpr jpeg_marker_t app2_marker = {0xff, 0xe2};
 constexpr jpeg_marker_t app14_marker = {0xff, 0xee};
+constexpr jpeg_marker_t dqt_marker = {0xff, 0xdb};
 
 constexpr jpeg_exif_header_t exif_header = {'E', 'x', 'i', 'f', 0, 0};
+constexpr jpeg_icc_header_t icc_header = {'I', 'C', 'C', '_', 'P', 'R', 'O', 'F', 'I', 'L', 'E', 0};
+
+using quant_table_t = std::array<uint16_t, 64>;
+
+// Natural (row-major) position of the n-th coefficient in zigzag order, as stored in DQT segments
+constexpr std::array<uint8_t, 64> zigzag_to_natural = {0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26,
+    33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59,
+    52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+// Reference tables from https://www.w3.org/Graphics/JPEG/itu-t81.pdf Annex K.1, in natural order
+constexpr quant_table_t std_luma_table = {16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55, 14, 13, 16, 24, 40, 57,
+    69, 56, 14, 17, 22, 29, 51, 87, 80, 62, 18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92, 49, 64, 78, 87,
+    103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+constexpr quant_table_t std_chroma_table = {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99, 24, 26, 56, 99, 99,
+    99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+
+// Sum of absolute differences between a table and a reference table scaled to the given quality, the way IJG libjpeg does it
+int64_t ScaledTableDistance(const quant_table_t& table, const quant_table_t& reference, int quality)
+{
+    int64_t scale = quality < 50 ? 5000 / quality : 200 - 2 * quality;
+    int64_t distance = 0;
+    for (int i = 0; i < 64; i++) {
+        int64_t value = std::min<int64_t>(std::max<int64_t>((reference[i] * scale + 50) / 100, 1), 255);
+        distance += std::abs(value - static_cast<int64_t>(table[i]));
+    }
+    return distance;
+}
+
+// Estimates the quality the tables were generated with. Returns 0 if there is no luma table.
+int EstimateQuality(const quant_table_t* luma, const quant_table_t* chroma)
+{
+    if (!luma)
+        return 0;
+    int best_quality = 0;
+    int64_t best_distance = std::numeric_limits<int64_t>::max();
+    for (int quality = 1; quality <= 100; quality++) {
+        int64_t distance = ScaledTableDistance(*luma, std_luma_table, quality);
+        if (chroma)
+            distance += ScaledTableDistance(*chroma, std_chroma_table, quality);
+        if (distance <= best_distance) { // on ties, prefer the higher quality
+            best_distance = distance;
+            best_quality = quality;
+        }
+    }
+    return best_quality;
+}
 
 bool IsValidMarker(const jpeg_marker_t& marker)
 {
@@ -57,6 +112,89 @@ bool IsSofMarker(const jpeg_marker_t& marker)
     return marker[1] != 0xc4 && marker[1] != 0xc8 && marker[1] != 0xcc;
 }
 
+bool IsRstMarker(uint8_t marker_code)
+{
+    return marker_code >= 0xd0 && marker_code <= 0xd7;
+}
+
+// Reads a marker code, skipping the fill bytes which may precede it
+bool ReadMarkerCode(StreamScanner& scanner, uint8_t* marker_code)
+{
+    uint8_t value;
+    if (!scanner.read(&value) || value != 0xff)
+        return false;
+    do {
+        if (!scanner.read(&value))
+            return false;
+    } while (value == 0xff);
+    *marker_code = value;
+    return value != 0x00;
+}
+
+/**
+ * @brief Walks the marker segments and the entropy-coded data of all scans up to the EOI marker.
+ *
+ * Fails if a segment runs past the end of the stream, if a segment isn't followed by a marker,
+ * or if the stream ends before EOI.
+ */
+bool IsJpegStructureValid(nvimgcodecIoStreamDesc_t* io_stream)
+{
+    StreamScanner scanner(io_stream);
+    uint8_t marker_code;
+    if (!ReadMarkerCode(scanner, &marker_code) || marker_code != soi_marker[1] || !ReadMarkerCode(scanner, &marker_code))
+        return false;
+    bool has_frame = false, has_scan = false;
+    while (marker_code != eoi_marker[1]) {
+        if (IsRstMarker(marker_code) || marker_code == 0x01) { // TEM and RSTn markers stand alone, without a segment
+            if (!ReadMarkerCode(scanner, &marker_code))
+                return false;
+            continue;
+        }
+        uint16_t length = 0;
+        if (!scanner.readBE16(&length) || length < 2 || !scanner.skip(length - 2))
+            return false;
+        has_frame |= IsSofMarker({0xff, marker_code});
+        if (marker_code != sos_marker[1]) {
+            if (!ReadMarkerCode(scanner, &marker_code))
+                return false;
+            continue;
+        }
+        has_scan = true;
+        // Entropy-coded data runs until the first marker other than RSTn, 0xFF data bytes are followed by a 0x00 byte
+        do {
+            if (!scanner.find(0xff))
+                return false;
+            do {
+                if (!scanner.read(&marker_code))
+                    return false;
+            } while (marker_code == 0xff);
+        } while (marker_code == 0x00 || IsRstMarker(marker_code));
+    }
+    return has_frame && has_scan;
+}
+
+// Skips the entropy-coded data of a scan, leaving the stream at the next marker other than RSTn. Returns false at the end of the stream.
+bool SkipEntropyCodedData(nvimgcodecIoStreamDesc_t* io_stream)
+{
+    ptrdiff_t offset = 0;
+    if (io_stream->tell(io_stream->instance, &offset) != NVIMGCODEC_STATUS_SUCCESS)
+        return false;
+    StreamScanner scanner(io_stream);
+    if (!scanner.seek(offset))
+        return false;
+    uint8_t marker_code;
+    do {
+        if (!scanner.find(0xff))
+            return false;
+        do {
+            if (!scanner.read(&marker_code))
+                return false;
+        } while (marker_code == 0xff);
+    } while (marker_code == 0x00 || IsRstMarker(marker_code));
+    io_stream->seek(io_stream->instance, scanner.position() - 2, SEEK_SET);
+    return true;
+}
+
 nvimgcodecSampleDataType_t precision_to_sample_type(int precision)
 {
     if (precision <= 8)
@@ -208,6 +346,10 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
         size_t size = 0;
         nvimgcodecIoStreamDesc_t* io_stream = code_stream->io_stream;
         io_stream->size(io_stream->instance, &size);
+        if (auto* validation = GetCodeStreamValidation(image_info)) {
+            validation->checked = 1;
+            validation->corrupted = !IsJpegStructureValid(io_stream);
+        }
         io_stream->seek(io_stream->instance, 0, SEEK_SET);
 
         std::array<uint8_t, 2> signature;
@@ -230,6 +372,21 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
         int adobe_transform = -1;
         nvimgcodecChromaSubsampling_t subsampling = NVIMGCODEC_SAMPLING_NONE;
         jpeg_marker_t sof_marker = {};
+        std::array<quant_table_t, 4> quant_tables = {};
+        std::array<bool, 4> quant_table_defined = {};
+        std::array<uint8_t, 4> component_quant_tables = {};
+        nvimgcodecIccProfile_t* icc_info = GetIccProfileInfo(image_info);
+        std::vector<std::vector<uint8_t>> icc_chunks;
+        nvimgcodecJpegQuantizationInfo_t* quant_info = reinterpret_cast<nvimgcodecJpegQuantizationInfo_t*>(image_info->struct_next);
+        while (quant_info && quant_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_JPEG_QUANTIZATION_INFO)
+            quant_info = reinterpret_cast<nvimgcodecJpegQuantizationInfo_t*>(quant_info->struct_next);
+        auto component_tables_defined = [&]() {
+            for (int c = 0; c < num_components; c++) {
+                if (!quant_table_defined[component_quant_tables[c]])
+                    return false;
+            }
+            return true;
+        };
         while (!read_shape || !read_orientation || !read_app14) {
             jpeg_marker_t marker;
             marker[0] = ReadValue<uint8_t>(io_stream);
@@ -244,7 +401,16 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
                 NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Invalid marker");
                 return NVIMGCODEC_STATUS_BAD_CODESTREAM;
             }
-            if (marker == sos_marker)
+            if (marker == sos_marker) {
+                // Tables of the components of later scans can be defined between scans
+                if (!quant_info || !read_shape || component_tables_defined())
+                    break;
+                io_stream->skip(io_stream->instance, ReadValueBE<uint16_t>(io_stream) - 2);
+                if (!SkipEntropyCodedData(io_stream))
+                    break;
+                continue;
+            }
+            if (marker == eoi_marker)
                 break;
 
             uint16_t size = ReadValueBE<uint16_t>(io_stream);
@@ -269,7 +435,7 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
                     auto horizontal_sampling_factor = temp >> 4;
                     auto vertical_sampling_factor = temp & 0x0F;
                     sampling_factors[c] = {horizontal_sampling_factor, vertical_sampling_factor};
-                    io_stream->skip(io_stream->instance, 1); // quantization table selector
+                    component_quant_tables[c] = ReadValue<uint8_t>(io_stream) & 0x03; // quantization table selector
                 }
                 uint8_t yh = num_components > 0 ? sampling_factors[0].first : 0;
                 uint8_t yv = num_components > 0 ? sampling_factors[0].second : 0;
@@ -280,6 +446,17 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
                 subsampling = chroma_subsampling_from_factors(num_components, yh, yv, uh, uv, vh, vv);
 
                 read_shape = true;
+            } else if (marker == dqt_marker) {
+                // A DQT segment can define several tables, each is a Pq/Tq byte followed by 64 8-bit or 16-bit entries in zigzag order
+                while (offset + 1 <= next_marker_offset) {
+                    auto pq_tq = ReadValue<uint8_t>(io_stream);
+                    bool is_16bit = (pq_tq >> 4) != 0;
+                    int table_id = pq_tq & 0x03;
+                    for (int i = 0; i < 64; i++)
+                        quant_tables[table_id][zigzag_to_natural[i]] = is_16bit ? ReadValueBE<uint16_t>(io_stream) : ReadValue<uint8_t>(io_stream);
+                    quant_table_defined[table_id] = true;
+                    offset += 1 + (is_16bit ? 128 : 64);
+                }
             } else if (marker == app1_marker && ReadValue<jpeg_exif_header_t>(io_stream) == exif_header) {
                 std::vector<uint8_t> exif_block(size - 8);
                 io_stream->read(io_stream->instance, &read_nbytes, exif_block.data(), exif_block.size());
@@ -296,6 +473,24 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
                     orientation = FromExifOrientation(static_cast<ExifOrientation>(entry.field_u16));
                     read_orientation = true;
                 }
+            } else if (marker == app2_marker && icc_info && size > 2 + icc_header.size() + 2 &&
+                       ReadValue<jpeg_icc_header_t>(io_stream) == icc_header) {
+                // Profiles which don't fit in a single segment are split into chunks, numbered from 1
+                auto seq_no = ReadValue<uint8_t>(io_stream);
+                auto num_chunks = ReadValue<uint8_t>(io_stream);
+                if (seq_no == 0 || seq_no > num_chunks) {
+                    NVIMGCODEC_LOG_WARNING(framework_, plugin_id_, "Invalid ICC profile chunk number");
+                } else {
+                    if (icc_chunks.size() < num_chunks)
+                        icc_chunks.resize(num_chunks);
+                    auto& chunk = icc_chunks[seq_no - 1];
+                    chunk.resize(size - 2 - icc_header.size() - 2);
+                    io_stream->read(io_stream->instance, &read_nbytes, chunk.data(), chunk.size());
+                    if (read_nbytes != chunk.size()) {
+                        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Failed to read ICC profile");
+                        return NVIMGCODEC_STATUS_BAD_CODESTREAM;
+                    }
+                }
             } else if (marker == app14_marker) {
                 constexpr uint16_t app14_data_len = 14;
                 constexpr std::array<uint8_t, 5> adobe_signature = {0x41, 0x64, 0x6F, 0x62, 0x65}; /// Adobe in ASCII
@@ -343,6 +538,19 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
             image_info->plane_info[p].precision = precision;
         }
 
+        if (icc_info) {
+            std::vector<uint8_t> profile;
+            for (auto& chunk : icc_chunks) {
+                if (chunk.empty()) {
+                    NVIMGCODEC_LOG_WARNING(framework_, plugin_id_, "Incomplete ICC profile");
+                    profile.clear();
+                    break;
+                }
+                profile.insert(profile.end(), chunk.begin(), chunk.end());
+            }
+            SetIccProfile(icc_info, profile.data(), profile.size());
+        }
+
         nvimgcodecJpegImageInfo_t* jpeg_image_info = reinterpret_cast<nvimgcodecJpegImageInfo_t*>(image_info->struct_next);
         while (jpeg_image_info && jpeg_image_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_JPEG_IMAGE_INFO)
             jpeg_image_info = reinterpret_cast<nvimgcodecJpegImageInfo_t*>(jpeg_image_info->struct_next);
@@ -352,6 +560,23 @@ nvimgcodecStatus_t JPEGParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
                 jpeg_image_info->encoding = static_cast<nvimgcodecJpegEncoding_t>(sof_marker[1]);
         }
 
+        if (quant_info) {
+            quant_info->num_tables = 0;
+            for (int t = 0; t < 4; t++) {
+                quant_info->num_tables += quant_table_defined[t] ? 1 : 0;
+                std::copy(quant_tables[t].begin(), quant_tables[t].end(), quant_info->tables[t]);
+            }
+            for (int c = 0; c < 4; c++)
+                quant_info->component_tables[c] = c < num_components ? component_quant_tables[c] : 0;
+            const quant_table_t* luma = quant_table_defined[component_quant_tables[0]] ? &quant_tables[component_quant_tables[0]] : nullptr;
+            const quant_table_t* chroma = num_components > 1 && quant_table_defined[component_quant_tables[1]]
+                                              ? &quant_tables[component_quant_tables[1]]
+                                              : nullptr;
+            // Lossless code streams have no quantization
+            bool lossless = sof_marker[1] == 0xc3 || sof_marker[1] == 0xc7 || sof_marker[1] == 0xcb || sof_marker[1] == 0xcf;
+            quant_info->estimated_quality = lossless ? 0 : EstimateQuality(luma, chroma);
+        }
+
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not retrieve image info from jpeg stream - " << e.what());
         return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
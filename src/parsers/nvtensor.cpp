@@ -0,0 +1,254 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "parsers/nvtensor.h"
+#include <nvimgcodec.h>
+#include <string.h>
+#include <array>
+
+#include "exception.h"
+#include "log_ext.h"
+
+#include "parsers/byte_io.h"
+#include "parsers/nvtensor_format.h"
+
+namespace nvimgcodec {
+
+namespace {
+
+nvimgcodecStatus_t GetImageInfoImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t* image_info, nvimgcodecCodeStreamDesc_t* code_stream)
+{
+    if (image_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO) {
+        NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Unexpected structure type");
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+    strcpy(image_info->codec_name, "nvtensor");
+
+    nvtensor::Header header;
+    try {
+        header = nvtensor::ReadHeader(code_stream->io_stream);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework, plugin_id, e.what());
+        return NVIMGCODEC_STATUS_BAD_CODESTREAM;
+    }
+
+    image_info->sample_format = header.sample_format;
+    image_info->orientation = {NVIMGCODEC_STRUCTURE_TYPE_ORIENTATION, sizeof(nvimgcodecOrientation_t), nullptr, 0, false, false};
+    image_info->chroma_subsampling = header.chroma_subsampling;
+    image_info->color_spec = header.color_spec;
+    image_info->num_planes = header.num_planes;
+    for (uint32_t p = 0; p < header.num_planes; p++) {
+        image_info->plane_info[p].width = header.planes[p].width;
+        image_info->plane_info[p].height = header.planes[p].height;
+        image_info->plane_info[p].num_channels = header.planes[p].num_channels;
+        image_info->plane_info[p].sample_type = header.planes[p].sample_type;
+        image_info->plane_info[p].precision = header.planes[p].precision;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+} // namespace
+
+NvTensorParserPlugin::NvTensorParserPlugin(const nvimgcodecFrameworkDesc_t* framework)
+    : framework_(framework)
+    , parser_desc_{NVIMGCODEC_STRUCTURE_TYPE_PARSER_DESC, sizeof(nvimgcodecParserDesc_t), nullptr, this, plugin_id_, "nvtensor", static_can_parse, static_create,
+          Parser::static_destroy, Parser::static_get_image_info}
+{
+}
+
+nvimgcodecParserDesc_t* NvTensorParserPlugin::getParserDesc()
+{
+    return &parser_desc_;
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::canParse(int* result, nvimgcodecCodeStreamDesc_t* code_stream)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_parser_can_parse");
+        CHECK_NULL(result);
+        CHECK_NULL(code_stream);
+        nvimgcodecIoStreamDesc_t* io_stream = code_stream->io_stream;
+        size_t length;
+        io_stream->size(io_stream->instance, &length);
+        io_stream->seek(io_stream->instance, 0, SEEK_SET);
+        if (length < sizeof(nvtensor::kMagic)) {
+            *result = 0;
+            return NVIMGCODEC_STATUS_SUCCESS;
+        }
+        auto magic = ReadValue<std::array<uint8_t, sizeof(nvtensor::kMagic)>>(io_stream);
+        *result = nvtensor::HasMagic(magic.data(), magic.size());
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if code stream can be parsed - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::static_can_parse(void* instance, int* result, nvimgcodecCodeStreamDesc_t* code_stream)
+{
+    try {
+        CHECK_NULL(instance);
+        auto handle = reinterpret_cast<NvTensorParserPlugin*>(instance);
+        return handle->canParse(result, code_stream);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+NvTensorParserPlugin::Parser::Parser(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework)
+    : plugin_id_(plugin_id)
+    , framework_(framework)
+{
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::create(nvimgcodecParser_t* parser)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_parser_create");
+        CHECK_NULL(parser);
+        *parser = reinterpret_cast<nvimgcodecParser_t>(new NvTensorParserPlugin::Parser(plugin_id_, framework_));
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not create nvtensor parser - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::static_create(void* instance, nvimgcodecParser_t* parser)
+{
+    try {
+        CHECK_NULL(instance);
+        auto handle = reinterpret_cast<NvTensorParserPlugin*>(instance);
+        handle->create(parser);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::Parser::static_destroy(nvimgcodecParser_t parser)
+{
+    try {
+        CHECK_NULL(parser);
+        auto handle = reinterpret_cast<NvTensorParserPlugin::Parser*>(parser);
+        delete handle;
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t* image_info, nvimgcodecCodeStreamDesc_t* code_stream)
+{
+    try {
+        NVIMGCODEC_LOG_TRACE(framework_, plugin_id_, "nvtensor_parser_get_image_info");
+        CHECK_NULL(code_stream);
+        CHECK_NULL(image_info);
+        return GetImageInfoImpl(plugin_id_, framework_, image_info, code_stream);
+    } catch (const std::runtime_error& e) {
+        NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not retrieve image info from nvtensor stream - " << e.what());
+        return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
+    }
+}
+
+nvimgcodecStatus_t NvTensorParserPlugin::Parser::static_get_image_info(
+    nvimgcodecParser_t parser, nvimgcodecImageInfo_t* image_info, nvimgcodecCodeStreamDesc_t* code_stream)
+{
+    try {
+        CHECK_NULL(parser);
+        auto handle = reinterpret_cast<NvTensorParserPlugin::Parser*>(parser);
+        return handle->getImageInfo(image_info, code_stream);
+    } catch (const std::runtime_error& e) {
+        return NVIMGCODEC_STATUS_EXTENSION_INVALID_PARAMETER;
+    }
+}
+
+class NvTensorParserExtension
+{
+  public:
+    explicit NvTensorParserExtension(const nvimgcodecFrameworkDesc_t* framework)
+        : framework_(framework)
+        , nvtensor_parser_plugin_(framework)
+    {
+        framework->registerParser(framework->instance, nvtensor_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+    }
+    ~NvTensorParserExtension() { framework_->unregisterParser(framework_->instance, nvtensor_parser_plugin_.getParserDesc()); }
+
+    static nvimgcodecStatus_t nvtensor_parser_extension_create(
+        void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
+    {
+        try {
+            CHECK_NULL(framework)
+            NVIMGCODEC_LOG_TRACE(framework, "nvtensor_parser_ext", "nvtensor_parser_extension_create");
+            CHECK_NULL(extension)
+            *extension = reinterpret_cast<nvimgcodecExtension_t>(new NvTensorParserExtension(framework));
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    static nvimgcodecStatus_t nvtensor_parser_extension_destroy(nvimgcodecExtension_t extension)
+    {
+        try {
+            CHECK_NULL(extension)
+            auto ext_handle = reinterpret_cast<nvimgcodec::NvTensorParserExtension*>(extension);
+            NVIMGCODEC_LOG_TRACE(ext_handle->framework_, "nvtensor_parser_ext", "nvtensor_parser_extension_destroy");
+            delete ext_handle;
+        } catch (const std::runtime_error& e) {
+            return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+  private:
+    const nvimgcodecFrameworkDesc_t* framework_;
+    NvTensorParserPlugin nvtensor_parser_plugin_;
+};
+
+// clang-format off
+nvimgcodecExtensionDesc_t nvtensor_parser_extension = {
+    NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC,
+    sizeof(nvimgcodecExtensionDesc_t),
+    NULL,
+
+    NULL,
+    "nvtensor_parser_extension",
+    NVIMGCODEC_VER,
+    NVIMGCODEC_EXT_API_VER,
+
+    NvTensorParserExtension::nvtensor_parser_extension_create,
+    NvTensorParserExtension::nvtensor_parser_extension_destroy
+};
+// clang-format on
+
+nvimgcodecStatus_t get_nvtensor_parser_extension_desc(nvimgcodecExtensionDesc_t* ext_desc)
+{
+    if (ext_desc == nullptr) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    if (ext_desc->struct_type != NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC) {
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+
+    *ext_desc = nvtensor_parser_extension;
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+} // namespace nvimgcodec
\ No newline at end of file
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace nvimgcodec { namespace nvtensor {
+
+/*
+ * Layout of an nvtensor code stream, shared by the parser and the nvtensor extension. All values are little-endian.
+ *
+ *   offset  size             field
+ *   0       8                magic "NVTENSOR"
+ *   8       4                version
+ *   12      4                payload offset, a multiple of kPayloadAlignment
+ *   16      4                compression, nvimgcodecNvTensorCompression_t
+ *   20      4                sample format
+ *   24      4                color spec
+ *   28      4                chroma subsampling
+ *   32      4                number of planes
+ *   36      4                number of chunks
+ *   40      8                uncompressed size of a chunk
+ *   48      20 * planes      width, height, number of channels, sample type and precision of each plane
+ *   ...     8 * chunks       compressed size of each chunk, only when compressed
+ *
+ * The payload holds the rows of all planes without padding, one plane after another, in the byte order of the
+ * encoding host. It is split into chunks of the given size, the last one shorter. Compressed chunks are stored one
+ * after another, uncompressed payload can be used in place, e.g. from a memory mapped file.
+ */
+
+constexpr char kMagic[8] = {'N', 'V', 'T', 'E', 'N', 'S', 'O', 'R'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kPayloadAlignment = 64;
+constexpr size_t kFixedHeaderSize = 48;
+constexpr size_t kPlaneInfoSize = 20;
+
+template <typename T>
+void StoreLE(uint8_t* dst, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++)
+        dst[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+}
+
+template <typename T>
+T LoadLE(const uint8_t* src)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+        value |= static_cast<uint64_t>(src[i]) << (8 * i);
+    return static_cast<T>(value);
+}
+
+// Sizes in the header come from untrusted streams, so arithmetic on them must not wrap around
+inline size_t CheckedMul(size_t a, size_t b)
+{
+    if (a != 0 && b > std::numeric_limits<size_t>::max() / a)
+        throw std::runtime_error("Size overflow");
+    return a * b;
+}
+
+inline size_t CheckedAdd(size_t a, size_t b)
+{
+    if (b > std::numeric_limits<size_t>::max() - a)
+        throw std::runtime_error("Size overflow");
+    return a + b;
+}
+
+struct Header
+{
+    uint32_t payload_offset = 0;
+    nvimgcodecNvTensorCompression_t compression = NVIMGCODEC_NVTENSOR_COMPRESSION_NONE;
+    nvimgcodecSampleFormat_t sample_format = NVIMGCODEC_SAMPLEFORMAT_UNKNOWN;
+    nvimgcodecColorSpec_t color_spec = NVIMGCODEC_COLORSPEC_UNKNOWN;
+    nvimgcodecChromaSubsampling_t chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+    uint32_t num_planes = 0;
+    uint64_t chunk_size = 0;
+    struct Plane
+    {
+        uint32_t width, height, num_channels;
+        nvimgcodecSampleDataType_t sample_type;
+        uint32_t precision;
+    } planes[NVIMGCODEC_MAX_NUM_PLANES] = {};
+    std::vector<uint64_t> compressed_chunk_sizes; // Empty when uncompressed
+
+    size_t planeSize(uint32_t p) const
+    {
+        auto& plane = planes[p];
+        size_t size = CheckedMul(plane.width, plane.height);
+        size = CheckedMul(size, plane.num_channels);
+        return CheckedMul(size, static_cast<unsigned int>(plane.sample_type) >> 11);
+    }
+
+    size_t payloadSize() const
+    {
+        size_t size = 0;
+        for (uint32_t p = 0; p < num_planes; p++)
+            size = CheckedAdd(size, planeSize(p));
+        return size;
+    }
+
+    size_t numChunks() const
+    {
+        if (chunk_size == 0)
+            return 0;
+        size_t payload_size = payloadSize();
+        return payload_size / chunk_size + (payload_size % chunk_size != 0);
+    }
+
+    size_t headerSize() const
+    {
+        size_t size = kFixedHeaderSize + kPlaneInfoSize * num_planes + sizeof(uint64_t) * compressed_chunk_sizes.size();
+        return (size + kPayloadAlignment - 1) / kPayloadAlignment * kPayloadAlignment;
+    }
+
+    /**
+     * @brief Serializes the header, padded with zeros up to the payload offset
+     */
+    std::vector<uint8_t> serialize() const
+    {
+        std::vector<uint8_t> data(headerSize(), 0);
+        uint8_t* ptr = data.data();
+        memcpy(ptr, kMagic, sizeof(kMagic));
+        StoreLE<uint32_t>(ptr + 8, kVersion);
+        StoreLE<uint32_t>(ptr + 12, static_cast<uint32_t>(data.size()));
+        StoreLE<uint32_t>(ptr + 16, compression);
+        StoreLE<uint32_t>(ptr + 20, sample_format);
+        StoreLE<uint32_t>(ptr + 24, color_spec);
+        StoreLE<uint32_t>(ptr + 28, chroma_subsampling);
+        StoreLE<uint32_t>(ptr + 32, num_planes);
+        StoreLE<uint32_t>(ptr + 36, static_cast<uint32_t>(numChunks()));
+        StoreLE<uint64_t>(ptr + 40, chunk_size);
+        ptr += kFixedHeaderSize;
+        for (uint32_t p = 0; p < num_planes; p++, ptr += kPlaneInfoSize) {
+            StoreLE<uint32_t>(ptr, planes[p].width);
+            StoreLE<uint32_t>(ptr + 4, planes[p].height);
+            StoreLE<uint32_t>(ptr + 8, planes[p].num_channels);
+            StoreLE<uint32_t>(ptr + 12, planes[p].sample_type);
+            StoreLE<uint32_t>(ptr + 16, planes[p].precision);
+        }
+        for (auto chunk_size : compressed_chunk_sizes) {
+            StoreLE<uint64_t>(ptr, chunk_size);
+            ptr += sizeof(uint64_t);
+        }
+        return data;
+    }
+};
+
+inline bool HasMagic(const uint8_t* data, size_t size)
+{
+    return size >= sizeof(kMagic) && memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+inline void ReadExactly(nvimgcodecIoStreamDesc_t* io_stream, void* dst, size_t size)
+{
+    size_t read_nbytes = 0;
+    if (io_stream->read(io_stream->instance, &read_nbytes, dst, size) != NVIMGCODEC_STATUS_SUCCESS || read_nbytes != size)
+        throw std::runtime_error("Unexpected end of stream");
+}
+
+/**
+ * @brief Reads and validates the header from the beginning of the stream
+ */
+inline Header ReadHeader(nvimgcodecIoStreamDesc_t* io_stream)
+{
+    size_t stream_size = 0;
+    io_stream->size(io_stream->instance, &stream_size);
+    io_stream->seek(io_stream->instance, 0, SEEK_SET);
+
+    uint8_t fixed[kFixedHeaderSize];
+    ReadExactly(io_stream, fixed, sizeof(fixed));
+    if (!HasMagic(fixed, sizeof(fixed)))
+        throw std::runtime_error("Unexpected magic");
+    if (LoadLE<uint32_t>(fixed + 8) != kVersion)
+        throw std::runtime_error("Unsupported version");
+
+    Header header;
+    header.payload_offset = LoadLE<uint32_t>(fixed + 12);
+    header.compression = static_cast<nvimgcodecNvTensorCompression_t>(LoadLE<uint32_t>(fixed + 16));
+    header.sample_format = static_cast<nvimgcodecSampleFormat_t>(LoadLE<uint32_t>(fixed + 20));
+    header.color_spec = static_cast<nvimgcodecColorSpec_t>(LoadLE<uint32_t>(fixed + 24));
+    header.chroma_subsampling = static_cast<nvimgcodecChromaSubsampling_t>(LoadLE<uint32_t>(fixed + 28));
+    header.num_planes = LoadLE<uint32_t>(fixed + 32);
+    uint32_t num_chunks = LoadLE<uint32_t>(fixed + 36);
+    header.chunk_size = LoadLE<uint64_t>(fixed + 40);
+    if (header.num_planes == 0 || header.num_planes > NVIMGCODEC_MAX_NUM_PLANES)
+        throw std::runtime_error("Invalid number of planes");
+    if (header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_NONE && header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD &&
+        header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_LZ4)
+        throw std::runtime_error("Unknown compression");
+    if (header.chunk_size == 0)
+        throw std::runtime_error("Invalid chunk size");
+
+    std::vector<uint8_t> planes(kPlaneInfoSize * header.num_planes);
+    ReadExactly(io_stream, planes.data(), planes.size());
+    for (uint32_t p = 0; p < header.num_planes; p++) {
+        const uint8_t* ptr = planes.data() + kPlaneInfoSize * p;
+        auto& plane = header.planes[p];
+        plane.width = LoadLE<uint32_t>(ptr);
+        plane.height = LoadLE<uint32_t>(ptr + 4);
+        plane.num_channels = LoadLE<uint32_t>(ptr + 8);
+        plane.sample_type = static_cast<nvimgcodecSampleDataType_t>(LoadLE<uint32_t>(ptr + 12));
+        plane.precision = LoadLE<uint32_t>(ptr + 16);
+        if (plane.num_channels == 0 || (static_cast<unsigned int>(plane.sample_type) >> 11) == 0)
+            throw std::runtime_error("Invalid plane info");
+    }
+    if (num_chunks != header.numChunks())
+        throw std::runtime_error("Invalid number of chunks");
+
+    size_t data_size = header.payloadSize();
+    if (header.compression != NVIMGCODEC_NVTENSOR_COMPRESSION_NONE) {
+        // The chunk table has to be in the stream before it is worth allocating
+        size_t table_offset = kFixedHeaderSize + kPlaneInfoSize * header.num_planes;
+        if (stream_size < table_offset || sizeof(uint64_t) * static_cast<size_t>(num_chunks) > stream_size - table_offset)
+            throw std::runtime_error("Unexpected end of stream");
+        std::vector<uint8_t> sizes(sizeof(uint64_t) * num_chunks);
+        ReadExactly(io_stream, sizes.data(), sizes.size());
+        header.compressed_chunk_sizes.resize(num_chunks);
+        data_size = 0;
+        for (uint32_t c = 0; c < num_chunks; c++) {
+            header.compressed_chunk_sizes[c] = LoadLE<uint64_t>(sizes.data() + sizeof(uint64_t) * c);
+            data_size = CheckedAdd(data_size, header.compressed_chunk_sizes[c]);
+        }
+    }
+    if (header.payload_offset < header.headerSize() || header.payload_offset > stream_size || data_size > stream_size - header.payload_offset)
+        throw std::runtime_error("Unexpected end of stream");
+    return header;
+}
+
+}} // namespace nvimgcodec::nvtensor
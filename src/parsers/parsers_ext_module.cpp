@@ -21,6 +21,7 @@
 #include "parsers/bmp.h"
 #include "parsers/jpeg.h"
 #include "parsers/jpeg2k.h"
+#include "parsers/nvtensor.h"
 #include "parsers/png.h"
 #include "parsers/pnm.h"
 #include "parsers/tiff.h"
@@ -36,6 +37,7 @@ class ParsersExtension
         , bmp_parser_plugin_(framework)
         , jpeg_parser_plugin_(framework)
         , jpeg2k_parser_plugin_(framework)
+        , nvtensor_parser_plugin_(framework)
         , png_parser_plugin_(framework)
         , pnm_parser_plugin_(framework)
         , tiff_parser_plugin_(framework)
@@ -44,6 +46,7 @@ class ParsersExtension
         framework->registerParser(framework->instance, bmp_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
         framework->registerParser(framework->instance, jpeg_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
         framework->registerParser(framework->instance, jpeg2k_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
+        framework->registerParser(framework->instance, nvtensor_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
         framework->registerParser(framework->instance, png_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
         framework->registerParser(framework->instance, pnm_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
         framework->registerParser(framework->instance, tiff_parser_plugin_.getParserDesc(), NVIMGCODEC_PRIORITY_NORMAL);
@@ -53,6 +56,7 @@ class ParsersExtension
         framework_->unregisterParser(framework_->instance, bmp_parser_plugin_.getParserDesc());
         framework_->unregisterParser(framework_->instance, jpeg_parser_plugin_.getParserDesc());
         framework_->unregisterParser(framework_->instance, jpeg2k_parser_plugin_.getParserDesc());
+        framework_->unregisterParser(framework_->instance, nvtensor_parser_plugin_.getParserDesc());
         framework_->unregisterParser(framework_->instance, png_parser_plugin_.getParserDesc());
         framework_->unregisterParser(framework_->instance, pnm_parser_plugin_.getParserDesc());
         framework_->unregisterParser(framework_->instance, tiff_parser_plugin_.getParserDesc());
@@ -90,6 +94,7 @@ class ParsersExtension
     BMPParserPlugin bmp_parser_plugin_;
     JPEGParserPlugin jpeg_parser_plugin_;
     JPEG2KParserPlugin jpeg2k_parser_plugin_;
+    NvTensorParserPlugin nvtensor_parser_plugin_;
     PNGParserPlugin png_parser_plugin_;
     PNMParserPlugin pnm_parser_plugin_;
     TIFFParserPlugin tiff_parser_plugin_;
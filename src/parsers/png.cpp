@@ -18,13 +18,20 @@
 #include "parsers/png.h"
 #include <nvimgcodec.h>
 #include <string.h>
+#include <algorithm>
+#include <array>
 #include <vector>
+#ifdef NVIMGCODEC_HAVE_ZLIB
+    #include <zlib.h>
+#endif
 
 #include "exception.h"
 #include "exif_orientation.h"
 #include "log_ext.h"
 #include "parsers/byte_io.h"
 #include "parsers/exif.h"
+#include "parsers/icc_profile.h"
+#include "parsers/stream_validation.h"
 
 namespace nvimgcodec {
 
@@ -69,17 +76,105 @@ struct IhdrChunk
 using chunk_type_field_t = std::array<uint8_t, 4>;
 static constexpr chunk_type_field_t IHDR_TAG{'I', 'H', 'D', 'R'};
 static constexpr chunk_type_field_t EXIF_TAG{'e', 'X', 'I', 'f'};
+static constexpr chunk_type_field_t ICCP_TAG{'i', 'C', 'C', 'P'};
+static constexpr chunk_type_field_t IDAT_TAG{'I', 'D', 'A', 'T'};
 static constexpr chunk_type_field_t IEND_TAG{'I', 'E', 'N', 'D'};
 
 using png_signature_t = std::array<uint8_t, 8>;
 static constexpr png_signature_t PNG_SIGNATURE = {137, 80, 78, 71, 13, 10, 26, 10};
 
+#ifdef NVIMGCODEC_HAVE_ZLIB
+bool Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>* out)
+{
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK)
+        return false;
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = static_cast<uInt>(size);
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        size_t pos = out->size();
+        out->resize(pos + std::max<size_t>(2 * size, 4096));
+        stream.next_out = out->data() + pos;
+        stream.avail_out = static_cast<uInt>(out->size() - pos);
+        ret = inflate(&stream, Z_NO_FLUSH);
+        out->resize(out->size() - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return ret == Z_STREAM_END;
+}
+#endif
+
+// CRC-32 of chunks, see Annex D. Starts from 0 and continues from the value returned for the previous bytes
+uint32_t UpdateCrc(uint32_t crc, const uint8_t* data, size_t size)
+{
+#ifdef NVIMGCODEC_HAVE_ZLIB
+    // Parsed chunks are read in pieces of at most 64 KiB
+    return crc32(crc, data, static_cast<uInt>(size));
+#else
+    static const auto table = [] {
+        std::array<uint32_t, 256> t;
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+#endif
+}
+
+/**
+ * @brief Walks the chunks up to IEND, checking their lengths against the end of the stream and their CRCs.
+ */
+bool IsPngStructureValid(nvimgcodecIoStreamDesc_t* io_stream)
+{
+    constexpr uint32_t max_chunk_length = 0x7fffffffu; // see 5.3
+    StreamScanner scanner(io_stream);
+    std::vector<uint8_t> data;
+    bool has_idat = false;
+    if (!scanner.skip(sizeof(png_signature_t)))
+        return false;
+    for (int chunk_idx = 0;; chunk_idx++) {
+        uint32_t length = 0, crc = 0;
+        chunk_type_field_t chunk_type;
+        if (!scanner.readBE32(&length) || length > max_chunk_length || length > scanner.remaining() ||
+            !scanner.read(chunk_type.data(), chunk_type.size()))
+            return false;
+        if ((chunk_idx == 0) != (chunk_type == IHDR_TAG))
+            return false;
+        uint32_t computed_crc = UpdateCrc(0, chunk_type.data(), chunk_type.size());
+        data.resize(std::min<size_t>(length, 64 * 1024));
+        for (uint32_t left = length; left > 0;) {
+            uint32_t n = std::min<uint32_t>(left, data.size());
+            if (!scanner.read(data.data(), n))
+                return false;
+            computed_crc = UpdateCrc(computed_crc, data.data(), n);
+            left -= n;
+        }
+        if (!scanner.readBE32(&crc) || crc != computed_crc)
+            return false;
+        has_idat |= chunk_type == IDAT_TAG;
+        if (chunk_type == IEND_TAG)
+            return has_idat;
+    }
+}
+
 nvimgcodecStatus_t GetImageInfoImpl(const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t* image_info, nvimgcodecCodeStreamDesc_t* code_stream)
 {
 
     nvimgcodecIoStreamDesc_t* io_stream = code_stream->io_stream;
     size_t io_stream_length;
     io_stream->size(io_stream->instance, &io_stream_length);
+    if (auto* validation = GetCodeStreamValidation(image_info)) {
+        validation->checked = 1;
+        validation->corrupted = !IsPngStructureValid(io_stream);
+    }
     io_stream->seek(io_stream->instance, 0, SEEK_SET);
 
     size_t read_nbytes = 0;
@@ -185,6 +280,9 @@ nvimgcodecStatus_t GetImageInfoImpl(const char* plugin_id, const nvimgcodecFrame
 
     io_stream->skip(io_stream->instance, 3 + 4); // Skip the other fields and the CRC checksum.
     image_info->orientation = {NVIMGCODEC_STRUCTURE_TYPE_ORIENTATION, sizeof(nvimgcodecOrientation_t), nullptr, 0, false, false};
+    nvimgcodecIccProfile_t* icc_info = GetIccProfileInfo(image_info);
+    if (icc_info)
+        icc_info->profile_size = 0;
     while (true) {
         uint32_t chunk_length = ReadValueBE<uint32_t>(io_stream);
         auto chunk_type = ReadValue<chunk_type_field_t>(io_stream);
@@ -209,6 +307,32 @@ nvimgcodecStatus_t GetImageInfoImpl(const char* plugin_id, const nvimgcodecFrame
                 }
             }
             io_stream->skip(io_stream->instance, 4);                // 4 bytes of CRC
+        } else if (chunk_type == ICCP_TAG && icc_info) {
+            std::vector<uint8_t> chunk(chunk_length);
+            size_t read_chunk_nbytes;
+            io_stream->read(io_stream->instance, &read_chunk_nbytes, chunk.data(), chunk_length);
+            if (read_chunk_nbytes != chunk_length) {
+                NVIMGCODEC_LOG_ERROR(framework, plugin_id, "Unexpected end of stream");
+                return NVIMGCODEC_STATUS_BAD_CODESTREAM;
+            }
+
+            // Profile name, null separator, compression method (0 - deflate) and the compressed profile
+            auto name_end = std::find(chunk.begin(), chunk.end(), 0);
+            if (chunk.end() - name_end < 2 || name_end[1] != 0) {
+                NVIMGCODEC_LOG_WARNING(framework, plugin_id, "Invalid iCCP chunk");
+            } else {
+#ifdef NVIMGCODEC_HAVE_ZLIB
+                std::vector<uint8_t> profile;
+                const uint8_t* compressed = &name_end[2];
+                if (Inflate(compressed, chunk.data() + chunk.size() - compressed, &profile))
+                    SetIccProfile(icc_info, profile.data(), profile.size());
+                else
+                    NVIMGCODEC_LOG_WARNING(framework, plugin_id, "Could not decompress ICC profile");
+#else
+                NVIMGCODEC_LOG_WARNING(framework, plugin_id, "ICC profile ignored, nvImageCodec was built without zlib");
+#endif
+            }
+            io_stream->skip(io_stream->instance, 4);                // 4 bytes of CRC
         } else {
             io_stream->skip(io_stream->instance, chunk_length + 4); // + 4 bytes of CRC
         }
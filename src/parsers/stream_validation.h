@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace nvimgcodec {
+
+/**
+ * @brief Returns the validation structure chained to the image info, or nullptr if there is none
+ */
+inline nvimgcodecCodeStreamValidation_t* GetCodeStreamValidation(nvimgcodecImageInfo_t* image_info)
+{
+    auto* validation = reinterpret_cast<nvimgcodecCodeStreamValidation_t*>(image_info->struct_next);
+    while (validation && validation->struct_type != NVIMGCODEC_STRUCTURE_TYPE_CODE_STREAM_VALIDATION)
+        validation = reinterpret_cast<nvimgcodecCodeStreamValidation_t*>(validation->struct_next);
+    return validation;
+}
+
+/**
+ * @brief Sequential reader over a whole io stream, reading it in large blocks
+ *
+ * Used to walk the structure of code streams. Reads past the end of the stream fail instead of throwing,
+ * as a truncated stream is an expected outcome of validation.
+ */
+class StreamScanner
+{
+  public:
+    explicit StreamScanner(nvimgcodecIoStreamDesc_t* io_stream, size_t block_size = 64 * 1024)
+        : io_stream_(io_stream)
+        , buffer_(block_size)
+    {
+        io_stream_->size(io_stream_->instance, &size_);
+    }
+
+    size_t size() const { return size_; }
+    size_t position() const { return pos_; }
+    size_t remaining() const { return size_ - pos_; }
+
+    bool seek(size_t pos)
+    {
+        if (pos > size_)
+            return false;
+        pos_ = pos;
+        return true;
+    }
+
+    bool skip(size_t count) { return count <= remaining() && seek(pos_ + count); }
+
+    bool read(uint8_t* value)
+    {
+        if (!fill())
+            return false;
+        *value = buffer_[pos_ - buffer_pos_];
+        pos_++;
+        return true;
+    }
+
+    bool read(uint8_t* data, size_t count)
+    {
+        if (count > remaining())
+            return false;
+        while (count > 0) {
+            if (!fill())
+                return false;
+            size_t n = std::min(count, buffer_pos_ + buffer_size_ - pos_);
+            memcpy(data, &buffer_[pos_ - buffer_pos_], n);
+            data += n;
+            pos_ += n;
+            count -= n;
+        }
+        return true;
+    }
+
+    bool readBE16(uint16_t* value)
+    {
+        uint8_t bytes[2];
+        if (!read(bytes, 2))
+            return false;
+        *value = (bytes[0] << 8) | bytes[1];
+        return true;
+    }
+
+    bool readBE32(uint32_t* value)
+    {
+        uint8_t bytes[4];
+        if (!read(bytes, 4))
+            return false;
+        *value = (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | bytes[3];
+        return true;
+    }
+
+    /**
+     * @brief Moves past the next occurrence of the byte, returns false if there is none
+     */
+    bool find(uint8_t value)
+    {
+        while (fill()) {
+            const uint8_t* begin = &buffer_[pos_ - buffer_pos_];
+            const uint8_t* end = buffer_.data() + buffer_size_;
+            auto* found = static_cast<const uint8_t*>(memchr(begin, value, end - begin));
+            if (found) {
+                pos_ += found - begin + 1;
+                return true;
+            }
+            pos_ += end - begin;
+        }
+        return false;
+    }
+
+  private:
+    // Makes sure the byte at the current position is buffered
+    bool fill()
+    {
+        if (pos_ >= size_)
+            return false;
+        if (pos_ >= buffer_pos_ && pos_ < buffer_pos_ + buffer_size_)
+            return true;
+        size_t read_nbytes = 0;
+        io_stream_->seek(io_stream_->instance, pos_, SEEK_SET);
+        io_stream_->read(io_stream_->instance, &read_nbytes, buffer_.data(), std::min(buffer_.size(), size_ - pos_));
+        buffer_pos_ = pos_;
+        buffer_size_ = read_nbytes;
+        if (read_nbytes == 0) {
+            size_ = pos_; // the stream is shorter than reported
+            return false;
+        }
+        return true;
+    }
+
+    nvimgcodecIoStreamDesc_t* io_stream_;
+    std::vector<uint8_t> buffer_;
+    size_t size_ = 0;
+    size_t pos_ = 0;
+    size_t buffer_pos_ = 0;
+    size_t buffer_size_ = 0;
+};
+
+} // namespace nvimgcodec
@@ -18,6 +18,9 @@
 #include "parsers/tiff.h"
 #include <nvimgcodec.h>
 #include <string.h>
+#include <algorithm>
+#include <set>
+#include <type_traits>
 #include <vector>
 
 #include "exception.h"
@@ -26,13 +29,13 @@
 
 #include "parsers/byte_io.h"
 #include "parsers/exif.h"
+#include "parsers/icc_profile.h"
+#include "parsers/stream_validation.h"
 
 namespace nvimgcodec {
 
 namespace {
 
-constexpr int ENTRY_SIZE = 12;
-
 enum TiffTag : uint16_t
 {
     WIDTH_TAG = 256,
@@ -40,19 +43,56 @@ enum TiffTag : uint16_t
     PHOTOMETRIC_INTERPRETATION_TAG = 262,
     ORIENTATION_TAG = 274,
     SAMPLESPERPIXEL_TAG = 277,
-    BITSPERSAMPLE_TAG = 258
+    BITSPERSAMPLE_TAG = 258,
+    NEW_SUBFILE_TYPE_TAG = 254,
+    STRIP_OFFSETS_TAG = 273,
+    ROWS_PER_STRIP_TAG = 278,
+    STRIP_BYTE_COUNTS_TAG = 279,
+    TILE_WIDTH_TAG = 322,
+    TILE_LENGTH_TAG = 323,
+    TILE_OFFSETS_TAG = 324,
+    TILE_BYTE_COUNTS_TAG = 325,
+    SUB_IFDS_TAG = 330,
+    ICC_PROFILE_TAG = 34675
 };
 
 enum TiffDataType : uint16_t
 {
     TYPE_WORD = 3,
-    TYPE_DWORD = 4
+    TYPE_DWORD = 4,
+    TYPE_IFD = 13,
+    TYPE_QWORD = 16,
+    TYPE_IFD8 = 18
 };
 
+constexpr uint32_t SUBFILE_REDUCED_IMAGE = 1;
+// Guards against IFD chains that loop back on themselves
+constexpr int MAX_NUM_IFDS = 1024;
+
 constexpr int PHOTOMETRIC_PALETTE = 3;
 
 using tiff_magic_t = std::array<uint8_t, 4>;
 constexpr tiff_magic_t le_header = {'I', 'I', 42, 0}, be_header = {'M', 'M', 0, 42};
+constexpr tiff_magic_t le_big_header = {'I', 'I', 43, 0}, be_big_header = {'M', 'M', 0, 43};
+
+/**
+ * @brief Sizes of the structures of classic TIFF, with 32-bit offsets, or of BigTIFF, with 64-bit offsets.
+ *
+ * Entries hold their values in place of the offset when they fit in it.
+ */
+template <bool is_big_tiff>
+struct TiffLayout
+{
+    using offset_t = std::conditional_t<is_big_tiff, uint64_t, uint32_t>;      // offsets and value counts
+    using entry_count_t = std::conditional_t<is_big_tiff, uint64_t, uint16_t>; // number of entries of an IFD
+    static constexpr size_t kFirstIfdOffsetPos = is_big_tiff ? 8 : 4;
+    static constexpr size_t kEntrySize = 2 * sizeof(uint16_t) + 2 * sizeof(offset_t);
+
+    static uint64_t entryOffset(uint64_t ifd_offset, uint64_t entry_idx)
+    {
+        return ifd_offset + sizeof(entry_count_t) + entry_idx * kEntrySize;
+    }
+};
 
 template <typename T, bool is_little_endian>
 T TiffRead(nvimgcodecIoStreamDesc_t* io_stream)
@@ -64,14 +104,344 @@ T TiffRead(nvimgcodecIoStreamDesc_t* io_stream)
     }
 }
 
+// Size of a single value of the type, 0 for unknown types
+size_t TiffTypeSize(uint16_t value_type)
+{
+    switch (value_type) {
+    case 1: // BYTE
+    case 2: // ASCII
+    case 6: // SBYTE
+    case 7: // UNDEFINED
+        return 1;
+    case 3: // SHORT
+    case 8: // SSHORT
+        return 2;
+    case 4:  // LONG
+    case 9:  // SLONG
+    case 11: // FLOAT
+    case 13: // IFD
+        return 4;
+    case 5:  // RATIONAL
+    case 10: // SRATIONAL
+    case 12: // DOUBLE
+    case 16: // LONG8
+    case 17: // SLONG8
+    case 18: // IFD8
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+struct IfdLevel
+{
+    nvimgcodecTiffLevelInfo_t info = {};
+    uint32_t subfile_type = 0;
+    bool is_tiled = false;
+    uint64_t next_ifd_offset = 0;
+    std::vector<uint64_t> sub_ifd_offsets;
+};
+
+template <bool is_little_endian>
+uint64_t ReadScalarEntry(nvimgcodecIoStreamDesc_t* io_stream, uint16_t value_type)
+{
+    if (value_type == TYPE_WORD)
+        return TiffRead<uint16_t, is_little_endian>(io_stream);
+    else if (value_type == TYPE_DWORD || value_type == TYPE_IFD)
+        return TiffRead<uint32_t, is_little_endian>(io_stream);
+    else if (value_type == TYPE_QWORD || value_type == TYPE_IFD8)
+        return TiffRead<uint64_t, is_little_endian>(io_stream);
+    throw std::runtime_error("Unexpected TIFF tag type");
+}
+
+/**
+ * @brief Reads the geometry of a single IFD, together with the links to the following and the child IFDs.
+ */
+template <bool is_little_endian, bool is_big_tiff>
+IfdLevel ReadIfdLevel(nvimgcodecIoStreamDesc_t* io_stream, uint64_t ifd_offset)
+{
+    using Layout = TiffLayout<is_big_tiff>;
+    IfdLevel level;
+    level.info.ifd_offset = ifd_offset;
+    uint32_t rows_per_strip = 0;
+    io_stream->seek(io_stream->instance, ifd_offset, SEEK_SET);
+    const auto entry_count = TiffRead<typename Layout::entry_count_t, is_little_endian>(io_stream);
+    for (uint64_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+        io_stream->seek(io_stream->instance, Layout::entryOffset(ifd_offset, entry_idx), SEEK_SET);
+        const auto tag_id = TiffRead<uint16_t, is_little_endian>(io_stream);
+        const auto value_type = TiffRead<uint16_t, is_little_endian>(io_stream);
+        const auto value_count = TiffRead<typename Layout::offset_t, is_little_endian>(io_stream);
+        switch (tag_id) {
+        case WIDTH_TAG:
+            level.info.width = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            break;
+        case HEIGHT_TAG:
+            level.info.height = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            break;
+        case TILE_WIDTH_TAG:
+            level.info.tile_width = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            level.is_tiled = true;
+            break;
+        case TILE_LENGTH_TAG:
+            level.info.tile_height = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            break;
+        case ROWS_PER_STRIP_TAG:
+            rows_per_strip = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            break;
+        case NEW_SUBFILE_TYPE_TAG:
+            level.subfile_type = ReadScalarEntry<is_little_endian>(io_stream, value_type);
+            break;
+        case SUB_IFDS_TAG:
+            if (value_count * TiffTypeSize(value_type) > sizeof(typename Layout::offset_t))
+                io_stream->seek(io_stream->instance, TiffRead<typename Layout::offset_t, is_little_endian>(io_stream), SEEK_SET);
+            for (uint64_t i = 0; i < value_count && i < NVIMGCODEC_TIFF_MAX_LEVELS; i++)
+                level.sub_ifd_offsets.push_back(ReadScalarEntry<is_little_endian>(io_stream, value_type));
+            break;
+        default:
+            break;
+        }
+    }
+    io_stream->seek(io_stream->instance, Layout::entryOffset(ifd_offset, entry_count), SEEK_SET);
+    level.next_ifd_offset = TiffRead<typename Layout::offset_t, is_little_endian>(io_stream);
+
+    if (!level.is_tiled) {
+        level.info.tile_width = level.info.width;
+        level.info.tile_height = rows_per_strip == 0 ? level.info.height : std::min(rows_per_strip, level.info.height);
+    }
+    return level;
+}
+
+/**
+ * @brief Enumerates the pyramid levels of the stream.
+ *
+ * Reduced-resolution images are taken from the SubIFDs of the first page if present, otherwise from the following pages
+ * which are either marked as reduced-resolution images or are tiled. Only images strictly smaller than the previous level
+ * are accepted, so that the levels are sorted by decreasing size and thumbnails or label images are skipped.
+ * Decoders locate the directory of a level from its IFD offset.
+ */
+template <bool is_little_endian, bool is_big_tiff>
+void GetPyramidInfoImpl(nvimgcodecTiffImageInfo_t* tiff_info, nvimgcodecIoStreamDesc_t* io_stream)
+{
+    using Layout = TiffLayout<is_big_tiff>;
+    io_stream->seek(io_stream->instance, Layout::kFirstIfdOffsetPos, SEEK_SET);
+    const auto first_ifd_offset = TiffRead<typename Layout::offset_t, is_little_endian>(io_stream);
+    IfdLevel first = ReadIfdLevel<is_little_endian, is_big_tiff>(io_stream, first_ifd_offset);
+    tiff_info->num_levels = 1;
+    tiff_info->levels[0] = first.info;
+
+    auto try_add_level = [&](const IfdLevel& level) {
+        const auto& prev = tiff_info->levels[tiff_info->num_levels - 1];
+        if (level.info.width == 0 || level.info.height == 0 || level.info.width >= prev.width || level.info.height >= prev.height)
+            return;
+        tiff_info->levels[tiff_info->num_levels++] = level.info;
+    };
+
+    if (!first.sub_ifd_offsets.empty()) {
+        for (auto offset : first.sub_ifd_offsets) {
+            if (tiff_info->num_levels == NVIMGCODEC_TIFF_MAX_LEVELS)
+                break;
+            try_add_level(ReadIfdLevel<is_little_endian, is_big_tiff>(io_stream, offset));
+        }
+        return;
+    }
+
+    uint64_t ifd_offset = first.next_ifd_offset;
+    for (int i = 0; ifd_offset != 0 && i < MAX_NUM_IFDS && tiff_info->num_levels < NVIMGCODEC_TIFF_MAX_LEVELS; i++) {
+        IfdLevel level = ReadIfdLevel<is_little_endian, is_big_tiff>(io_stream, ifd_offset);
+        if ((level.subfile_type & SUBFILE_REDUCED_IMAGE) || level.is_tiled)
+            try_add_level(level);
+        ifd_offset = level.next_ifd_offset;
+    }
+}
+
+/**
+ * @brief Reads the ICC profile of the IFD, returns an empty vector if there is none.
+ */
+template <bool is_little_endian, bool is_big_tiff>
+std::vector<uint8_t> ReadIccProfile(nvimgcodecIoStreamDesc_t* io_stream, uint64_t ifd_offset)
+{
+    using Layout = TiffLayout<is_big_tiff>;
+    size_t stream_size = 0;
+    io_stream->size(io_stream->instance, &stream_size);
+    io_stream->seek(io_stream->instance, ifd_offset, SEEK_SET);
+    const auto entry_count = TiffRead<typename Layout::entry_count_t, is_little_endian>(io_stream);
+    for (uint64_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+        io_stream->seek(io_stream->instance, Layout::entryOffset(ifd_offset, entry_idx), SEEK_SET);
+        const auto tag_id = TiffRead<uint16_t, is_little_endian>(io_stream);
+        io_stream->skip(io_stream->instance, sizeof(uint16_t)); // value type, UNDEFINED bytes
+        const auto value_count = TiffRead<typename Layout::offset_t, is_little_endian>(io_stream);
+        if (tag_id != ICC_PROFILE_TAG)
+            continue;
+        if (value_count > stream_size)
+            throw std::runtime_error("Unexpected end of stream");
+        if (value_count > sizeof(typename Layout::offset_t))
+            io_stream->seek(io_stream->instance, TiffRead<typename Layout::offset_t, is_little_endian>(io_stream), SEEK_SET);
+        std::vector<uint8_t> profile(value_count);
+        size_t read_nbytes = 0;
+        io_stream->read(io_stream->instance, &read_nbytes, profile.data(), profile.size());
+        if (read_nbytes != profile.size())
+            throw std::runtime_error("Unexpected end of stream");
+        return profile;
+    }
+    return {};
+}
+
+template <typename T, bool is_little_endian>
+bool TiffScan(StreamScanner& scanner, T* value)
+{
+    uint8_t bytes[sizeof(T)];
+    if (!scanner.read(bytes, sizeof(T)))
+        return false;
+    if constexpr (is_little_endian) {
+        *value = ReadValueLE<T>(bytes);
+    } else {
+        *value = ReadValueBE<T>(bytes);
+    }
+    return true;
+}
+
+struct TiffArrayEntry
+{
+    uint16_t value_type = 0;
+    uint64_t value_count = 0;
+    size_t values_offset = 0;
+};
+
 template <bool is_little_endian>
+bool ReadTiffArray(StreamScanner& scanner, const TiffArrayEntry& entry, std::vector<uint64_t>* values)
+{
+    values->resize(entry.value_count);
+    if (!scanner.seek(entry.values_offset))
+        return false;
+    for (auto& value : *values) {
+        if (entry.value_type == TYPE_WORD) {
+            uint16_t word;
+            if (!TiffScan<uint16_t, is_little_endian>(scanner, &word))
+                return false;
+            value = word;
+        } else if (entry.value_type == TYPE_DWORD || entry.value_type == TYPE_IFD) {
+            uint32_t dword;
+            if (!TiffScan<uint32_t, is_little_endian>(scanner, &dword))
+                return false;
+            value = dword;
+        } else if (entry.value_type == TYPE_QWORD || entry.value_type == TYPE_IFD8) {
+            if (!TiffScan<uint64_t, is_little_endian>(scanner, &value))
+                return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Walks the IFD chain and the SubIFDs, checking that IFDs, out-of-line tag values, strips and tiles lie
+ * within the stream, and that the chain doesn't loop.
+ */
+template <bool is_little_endian, bool is_big_tiff>
+bool IsTiffStructureValid(nvimgcodecIoStreamDesc_t* io_stream)
+{
+    using Layout = TiffLayout<is_big_tiff>;
+    using offset_t = typename Layout::offset_t;
+    StreamScanner scanner(io_stream, 4096);
+    offset_t first_ifd_offset = 0;
+    if (!scanner.seek(Layout::kFirstIfdOffsetPos) || !TiffScan<offset_t, is_little_endian>(scanner, &first_ifd_offset) ||
+        first_ifd_offset == 0)
+        return false;
+    std::vector<uint64_t> pending = {first_ifd_offset};
+    std::set<uint64_t> visited;
+    std::vector<uint64_t> offsets, byte_counts;
+    while (!pending.empty()) {
+        uint64_t ifd_offset = pending.back();
+        pending.pop_back();
+        if (!visited.insert(ifd_offset).second || visited.size() > MAX_NUM_IFDS)
+            return false;
+        typename Layout::entry_count_t entry_count = 0;
+        if (!scanner.seek(ifd_offset) || !TiffScan<typename Layout::entry_count_t, is_little_endian>(scanner, &entry_count) ||
+            entry_count > scanner.remaining() / Layout::kEntrySize ||
+            entry_count * Layout::kEntrySize + sizeof(offset_t) > scanner.remaining())
+            return false;
+
+        TiffArrayEntry strip_offsets, strip_byte_counts, tile_offsets, tile_byte_counts, sub_ifds;
+        for (uint64_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+            uint16_t tag_id = 0;
+            offset_t value_count = 0;
+            TiffArrayEntry entry;
+            scanner.seek(Layout::entryOffset(ifd_offset, entry_idx));
+            if (!TiffScan<uint16_t, is_little_endian>(scanner, &tag_id) ||
+                !TiffScan<uint16_t, is_little_endian>(scanner, &entry.value_type) ||
+                !TiffScan<offset_t, is_little_endian>(scanner, &value_count) || value_count > scanner.size())
+                return false;
+            entry.value_count = value_count;
+            // Values are stored in the entry itself only if they fit in the offset
+            uint64_t values_size = entry.value_count * TiffTypeSize(entry.value_type);
+            entry.values_offset = scanner.position();
+            if (values_size > sizeof(offset_t)) {
+                offset_t values_offset = 0;
+                if (!TiffScan<offset_t, is_little_endian>(scanner, &values_offset) || values_offset > scanner.size() ||
+                    values_offset + values_size > scanner.size())
+                    return false;
+                entry.values_offset = values_offset;
+            }
+            switch (tag_id) {
+            case STRIP_OFFSETS_TAG:
+                strip_offsets = entry;
+                break;
+            case STRIP_BYTE_COUNTS_TAG:
+                strip_byte_counts = entry;
+                break;
+            case TILE_OFFSETS_TAG:
+                tile_offsets = entry;
+                break;
+            case TILE_BYTE_COUNTS_TAG:
+                tile_byte_counts = entry;
+                break;
+            case SUB_IFDS_TAG:
+                sub_ifds = entry;
+                break;
+            default:
+                break;
+            }
+        }
+        offset_t next_ifd_offset = 0;
+        scanner.seek(Layout::entryOffset(ifd_offset, entry_count));
+        if (!TiffScan<offset_t, is_little_endian>(scanner, &next_ifd_offset))
+            return false;
+        if (next_ifd_offset != 0)
+            pending.push_back(next_ifd_offset);
+        if (sub_ifds.value_count > 0) {
+            if (!ReadTiffArray<is_little_endian>(scanner, sub_ifds, &offsets))
+                return false;
+            pending.insert(pending.end(), offsets.begin(), offsets.end());
+        }
+
+        // Every image has its data split into either strips or tiles
+        bool is_tiled = tile_offsets.value_count > 0;
+        const auto& data_offsets = is_tiled ? tile_offsets : strip_offsets;
+        const auto& data_byte_counts = is_tiled ? tile_byte_counts : strip_byte_counts;
+        if (data_offsets.value_count == 0 || data_offsets.value_count != data_byte_counts.value_count)
+            return false;
+        if (!ReadTiffArray<is_little_endian>(scanner, data_offsets, &offsets) ||
+            !ReadTiffArray<is_little_endian>(scanner, data_byte_counts, &byte_counts))
+            return false;
+        for (size_t i = 0; i < offsets.size(); i++) {
+            if (offsets[i] > scanner.size() || offsets[i] + byte_counts[i] > scanner.size())
+                return false;
+        }
+    }
+    return true;
+}
+
+template <bool is_little_endian, bool is_big_tiff>
 nvimgcodecStatus_t GetInfoImpl(
     const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t* info, nvimgcodecIoStreamDesc_t* io_stream)
 {
-    io_stream->seek(io_stream->instance, 4, SEEK_SET);
-    const auto ifd_offset = TiffRead<uint32_t, is_little_endian>(io_stream);
+    using Layout = TiffLayout<is_big_tiff>;
+    using offset_t = typename Layout::offset_t;
+    io_stream->seek(io_stream->instance, Layout::kFirstIfdOffsetPos, SEEK_SET);
+    const auto ifd_offset = TiffRead<offset_t, is_little_endian>(io_stream);
     io_stream->seek(io_stream->instance, ifd_offset, SEEK_SET);
-    const auto entry_count = TiffRead<uint16_t, is_little_endian>(io_stream);
+    const auto entry_count = TiffRead<typename Layout::entry_count_t, is_little_endian>(io_stream);
 
     strcpy(info->codec_name, "tiff");
     info->color_spec = NVIMGCODEC_COLORSPEC_UNKNOWN;
@@ -82,15 +452,14 @@ nvimgcodecStatus_t GetInfoImpl(
     bool width_read = false, height_read = false, samples_per_px_read = false, palette_read = false, bitdepth_read = false;
     int64_t width = 0, height = 0, nchannels = 0;
     std::array<uint16_t, NVIMGCODEC_MAX_NUM_PLANES> bitdepth = {0};
-    for (int entry_idx = 0; entry_idx < entry_count; entry_idx++) {
-        const auto entry_offset = ifd_offset + sizeof(uint16_t) + entry_idx * ENTRY_SIZE;
-        io_stream->seek(io_stream->instance, entry_offset, SEEK_SET);
+    for (uint64_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
+        io_stream->seek(io_stream->instance, Layout::entryOffset(ifd_offset, entry_idx), SEEK_SET);
         const auto tag_id = TiffRead<uint16_t, is_little_endian>(io_stream);
         const auto value_type = TiffRead<uint16_t, is_little_endian>(io_stream);
-        const auto value_count = TiffRead<uint32_t, is_little_endian>(io_stream);
+        const auto value_count = TiffRead<offset_t, is_little_endian>(io_stream);
         if (tag_id == BITSPERSAMPLE_TAG) {
-            if (value_count > 1) {
-                uint32_t value_offset = TiffRead<uint32_t, is_little_endian>(io_stream);
+            if (value_count * TiffTypeSize(value_type) > sizeof(offset_t)) {
+                offset_t value_offset = TiffRead<offset_t, is_little_endian>(io_stream);
                 io_stream->seek(io_stream->instance, value_offset, SEEK_SET);
             }
 
@@ -177,9 +546,32 @@ nvimgcodecStatus_t GetInfoImpl(
         info->sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
     else
         info->sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+
+    auto* tiff_info = reinterpret_cast<nvimgcodecTiffImageInfo_t*>(info->struct_next);
+    while (tiff_info && tiff_info->struct_type != NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO)
+        tiff_info = reinterpret_cast<nvimgcodecTiffImageInfo_t*>(tiff_info->struct_next);
+    if (tiff_info && tiff_info->struct_type == NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO) {
+        GetPyramidInfoImpl<is_little_endian, is_big_tiff>(tiff_info, io_stream);
+    }
+
+    if (auto* icc_info = GetIccProfileInfo(info)) {
+        auto profile = ReadIccProfile<is_little_endian, is_big_tiff>(io_stream, ifd_offset);
+        SetIccProfile(icc_info, profile.data(), profile.size());
+    }
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
+template <bool is_little_endian, bool is_big_tiff>
+nvimgcodecStatus_t ParseTiff(
+    const char* plugin_id, const nvimgcodecFrameworkDesc_t* framework, nvimgcodecImageInfo_t* info, nvimgcodecIoStreamDesc_t* io_stream)
+{
+    if (auto* validation = GetCodeStreamValidation(info)) {
+        validation->checked = 1;
+        validation->corrupted = !IsTiffStructureValid<is_little_endian, is_big_tiff>(io_stream);
+    }
+    return GetInfoImpl<is_little_endian, is_big_tiff>(plugin_id, framework, info, io_stream);
+}
+
 } // namespace
 
 TIFFParserPlugin::TIFFParserPlugin(const nvimgcodecFrameworkDesc_t* framework)
@@ -209,7 +601,7 @@ nvimgcodecStatus_t TIFFParserPlugin::canParse(int* result, nvimgcodecCodeStreamD
             return NVIMGCODEC_STATUS_SUCCESS;
         }
         tiff_magic_t header = ReadValue<tiff_magic_t>(io_stream);
-        *result = header == le_header || header == be_header;
+        *result = header == le_header || header == be_header || header == le_big_header || header == be_big_header;
     } catch (const std::runtime_error& e) {
         NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Could not check if code stream can be parsed - " << e.what());
         return NVIMGCODEC_STATUS_EXTENSION_INTERNAL_ERROR;
@@ -286,9 +678,13 @@ nvimgcodecStatus_t TIFFParserPlugin::Parser::getImageInfo(nvimgcodecImageInfo_t*
         tiff_magic_t header = ReadValue<tiff_magic_t>(io_stream);
         nvimgcodecStatus_t ret = NVIMGCODEC_STATUS_SUCCESS;
         if (header == le_header) {
-            ret = GetInfoImpl<true>(plugin_id_, framework_, image_info, io_stream);
+            ret = ParseTiff<true, false>(plugin_id_, framework_, image_info, io_stream);
         } else if (header == be_header) {
-            ret = GetInfoImpl<false>(plugin_id_, framework_, image_info, io_stream);
+            ret = ParseTiff<false, false>(plugin_id_, framework_, image_info, io_stream);
+        } else if (header == le_big_header) {
+            ret = ParseTiff<true, true>(plugin_id_, framework_, image_info, io_stream);
+        } else if (header == be_big_header) {
+            ret = ParseTiff<false, true>(plugin_id_, framework_, image_info, io_stream);
         } else {
             // should not happen (because canParse returned result==true)
             NVIMGCODEC_LOG_ERROR(framework_, plugin_id_, "Logic error");
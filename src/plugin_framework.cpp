@@ -115,16 +115,19 @@ char GetPathSeparator()
 #endif
 
 PluginFramework::PluginFramework(ILogger* logger, ICodecRegistry* codec_registry, std::unique_ptr<IEnvironment> env,
-    std::unique_ptr<IDirectoryScaner> directory_scaner, std::unique_ptr<ILibraryLoader> library_loader, const std::string& extensions_path)
+    std::unique_ptr<IDirectoryScaner> directory_scaner, std::unique_ptr<ILibraryLoader> library_loader, const std::string& extensions_path,
+    size_t max_scratch_retained_size)
     : logger_(logger)
     , env_(std::move(env))
     , directory_scaner_(std::move(directory_scaner))
     , library_loader_(std::move(library_loader))
     , framework_desc_{NVIMGCODEC_STRUCTURE_TYPE_FRAMEWORK_DESC, sizeof(nvimgcodecFrameworkDesc_t), nullptr, this, "nvImageCodec", NVIMGCODEC_VER, NVIMGCODEC_EXT_API_VER,
           CUDART_VERSION, &static_log, &static_register_encoder, &static_unregister_encoder, &static_register_decoder,
-          &static_unregister_decoder, &static_register_parser, &static_unregister_parser}
+          &static_unregister_decoder, &static_register_parser, &static_unregister_parser,
+          &static_register_transformer, &static_unregister_transformer, &static_scratch_alloc, &static_scratch_reset}
     , codec_registry_(codec_registry)
     , extension_paths_{}
+    , scratch_arenas_(max_scratch_retained_size)
 {
 
     std::string effective_ext_path = extensions_path;
@@ -181,6 +184,18 @@ nvimgcodecStatus_t PluginFramework::static_unregister_parser(void* instance, con
     return handle->unregisterParser(desc);
 }
 
+nvimgcodecStatus_t PluginFramework::static_register_transformer(void* instance, const nvimgcodecTransformerDesc_t* desc, float priority)
+{
+    PluginFramework* handle = reinterpret_cast<PluginFramework*>(instance);
+    return handle->registerTransformer(desc, priority);
+}
+
+nvimgcodecStatus_t PluginFramework::static_unregister_transformer(void* instance, const nvimgcodecTransformerDesc_t* desc)
+{
+    PluginFramework* handle = reinterpret_cast<PluginFramework*>(instance);
+    return handle->unregisterTransformer(desc);
+}
+
 nvimgcodecStatus_t PluginFramework::static_log(void* instance, const nvimgcodecDebugMessageSeverity_t message_severity,
     const nvimgcodecDebugMessageCategory_t message_category, const nvimgcodecDebugMessageData_t* data)
 {
@@ -188,6 +203,18 @@ nvimgcodecStatus_t PluginFramework::static_log(void* instance, const nvimgcodecD
     return handle->log(message_severity, message_category, data);
 }
 
+void* PluginFramework::static_scratch_alloc(void* instance, size_t size, size_t alignment)
+{
+    PluginFramework* handle = reinterpret_cast<PluginFramework*>(instance);
+    return handle->scratch_arenas_.local().allocate(size, alignment);
+}
+
+void PluginFramework::static_scratch_reset(void* instance)
+{
+    PluginFramework* handle = reinterpret_cast<PluginFramework*>(instance);
+    handle->scratch_arenas_.local().reset();
+}
+
 nvimgcodecStatus_t PluginFramework::registerExtension(
     nvimgcodecExtension_t* extension, const nvimgcodecExtensionDesc_t* extension_desc, const Module& module)
 {
@@ -456,6 +483,26 @@ nvimgcodecStatus_t PluginFramework::unregisterParser(const nvimgcodecParserDesc_
     return NVIMGCODEC_STATUS_SUCCESS;
 }
 
+nvimgcodecStatus_t PluginFramework::registerTransformer(const nvimgcodecTransformerDesc_t* desc, float priority)
+{
+    NVIMGCODEC_LOG_INFO(logger_, "Framework is registering transformer (id:" << desc->id << " codec:" << desc->codec << ")");
+    ICodec* codec = ensureExistsAndRetrieveCodec(desc->codec);
+    codec->registerTransformer(desc, priority);
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+nvimgcodecStatus_t PluginFramework::unregisterTransformer(const nvimgcodecTransformerDesc_t* desc)
+{
+    NVIMGCODEC_LOG_INFO(logger_, "Framework is unregistering transformer (id:" << desc->id << " codec:" << desc->codec << ")");
+    ICodec* codec = codec_registry_->getCodecByName(desc->codec);
+    if (codec == nullptr) {
+        NVIMGCODEC_LOG_WARNING(logger_, "Codec " << desc->codec << " not registered");
+        return NVIMGCODEC_STATUS_INVALID_PARAMETER;
+    }
+    codec->unregisterTransformer(desc->id);
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
 nvimgcodecStatus_t PluginFramework::log(const nvimgcodecDebugMessageSeverity_t message_severity,
     const nvimgcodecDebugMessageCategory_t message_category, const nvimgcodecDebugMessageData_t* data)
 {
@@ -23,6 +23,7 @@
 #include <vector>
 #include "idirectory_scaner.h"
 #include "ilibrary_loader.h"
+#include "scratch_arena.h"
 
 namespace nvimgcodec {
 
@@ -38,7 +39,7 @@ class PluginFramework
   public:
     explicit PluginFramework(ILogger* logger, ICodecRegistry* codec_registry, std::unique_ptr<IEnvironment> env,
         std::unique_ptr<IDirectoryScaner> directory_scaner, std::unique_ptr<ILibraryLoader> library_loader,
-        const std::string& extensions_path);
+        const std::string& extensions_path, size_t max_scratch_retained_size = ScratchArenas::kDefaultMaxRetainedSize);
     ~PluginFramework();
     nvimgcodecStatus_t registerExtension(nvimgcodecExtension_t* extension, const nvimgcodecExtensionDesc_t* extension_desc);
     nvimgcodecStatus_t unregisterExtension(nvimgcodecExtension_t extension);
@@ -47,6 +48,8 @@ class PluginFramework
     void discoverAndLoadExtModules();
     void loadExtModule(const std::string& modulePath);
 
+    void getScratchArenaStats(nvimgcodecScratchArenaStats_t* stats) const { scratch_arenas_.getStats(stats); }
+
   private:
     struct Module
     {
@@ -74,6 +77,8 @@ class PluginFramework
     nvimgcodecStatus_t unregisterDecoder(const nvimgcodecDecoderDesc_t* desc);
     nvimgcodecStatus_t registerParser(const nvimgcodecParserDesc_t* desc, float priority);
     nvimgcodecStatus_t unregisterParser(const nvimgcodecParserDesc_t* desc);
+    nvimgcodecStatus_t registerTransformer(const nvimgcodecTransformerDesc_t* desc, float priority);
+    nvimgcodecStatus_t unregisterTransformer(const nvimgcodecTransformerDesc_t* desc);
 
     nvimgcodecStatus_t log(const nvimgcodecDebugMessageSeverity_t message_severity, const nvimgcodecDebugMessageCategory_t message_category,
         const nvimgcodecDebugMessageData_t* callback_data);
@@ -84,9 +89,13 @@ class PluginFramework
     static nvimgcodecStatus_t static_unregister_decoder(void* instance, const nvimgcodecDecoderDesc_t* desc);
     static nvimgcodecStatus_t static_register_parser(void* instance, const nvimgcodecParserDesc_t* desc, float priority);
     static nvimgcodecStatus_t static_unregister_parser(void* instance, const nvimgcodecParserDesc_t* desc);
+    static nvimgcodecStatus_t static_register_transformer(void* instance, const nvimgcodecTransformerDesc_t* desc, float priority);
+    static nvimgcodecStatus_t static_unregister_transformer(void* instance, const nvimgcodecTransformerDesc_t* desc);
 
     static nvimgcodecStatus_t static_log(void* instance, const nvimgcodecDebugMessageSeverity_t message_severity,
         const nvimgcodecDebugMessageCategory_t message_category, const nvimgcodecDebugMessageData_t* callback_data);
+    static void* static_scratch_alloc(void* instance, size_t size, size_t alignment);
+    static void static_scratch_reset(void* instance);
 
     ILogger* logger_;
     std::unique_ptr<IEnvironment> env_;
@@ -96,5 +105,6 @@ class PluginFramework
     nvimgcodecFrameworkDesc_t framework_desc_;
     ICodecRegistry* codec_registry_;
     std::vector<std::string> extension_paths_;
+    ScratchArenas scratch_arenas_;
 };
 } // namespace nvimgcodec
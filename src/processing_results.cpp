@@ -44,6 +44,7 @@ class ProcessingResultsSharedState {
   }
 
   static void deleter(ProcessingResultsSharedState *ptr) {
+    ptr->on_result_ = nullptr;
     free_.emplace_back(ptr);
   }
 
@@ -56,6 +57,7 @@ class ProcessingResultsSharedState {
     ready_mask_.resize(n);
     last_checked_ = 0;
     has_future_.clear();
+    on_result_ = nullptr;
   }
 
   void reset() {
@@ -141,6 +143,7 @@ class ProcessingResultsSharedState {
   std::vector<uint8_t> ready_mask_;  // avoid vector<bool>
   size_t last_checked_ = 0;
   std::atomic_int num_promises_;
+  ProcessingResultsPromise::OnResultFunc on_result_;
 
   static thread_local std::deque<std::unique_ptr<ProcessingResultsSharedState>> free_;
 };
@@ -209,7 +212,13 @@ ProcessingResult ProcessingResultsFuture::getOne(int index) const {
 }
 
 void ProcessingResultsPromise::set(int index, ProcessingResult res) {
+  if (!impl_->on_result_) {
+    impl_->set(index, std::move(res));
+    return;
+  }
+  ProcessingResult copy = res;
   impl_->set(index, std::move(res));
+  impl_->on_result_(*this, index, copy);
 }
 
 void ProcessingResultsPromise::setAll(ProcessingResult* res, size_t size) {
@@ -223,6 +232,10 @@ void ProcessingResultsPromise::setAll(ProcessingResult res)
   }
 }
 
+void ProcessingResultsPromise::setOnResult(OnResultFunc on_result) {
+  impl_->on_result_ = std::move(on_result);
+}
+
 int ProcessingResultsPromise::getNumSamples() const {
   return impl_->results_.size();
 }
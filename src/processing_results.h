@@ -18,6 +18,7 @@
 #pragma once
 
 #include <nvimgcodec.h>
+#include <functional>
 #include <memory>
 #include <stdexcept>
 #include <utility>
@@ -56,6 +57,8 @@ class ProcessingResultsFuture;
 class ProcessingResultsPromise
 {
   public:
+    using OnResultFunc = std::function<void(ProcessingResultsPromise& promise, int index, const ProcessingResult& res)>;
+
     explicit ProcessingResultsPromise(int num_samples);
     ~ProcessingResultsPromise();
 
@@ -89,6 +92,13 @@ class ProcessingResultsPromise
     */
     void setAll(ProcessingResult res);
 
+    /**
+   * @brief Sets a function called on the setting thread after each result is set, which can set other results
+   *
+   * It has to be set before the promise is shared with the workers.
+   */
+    void setOnResult(OnResultFunc on_result);
+
     /**
    * @brief Checks if two promises point to the same shared state.
    */
@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scratch_arena.h"
+#include <algorithm>
+
+namespace nvimgcodec {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64 << 10;
+
+} // namespace
+
+ScratchArena::ScratchArena(size_t max_retained_size)
+    : max_retained_size_(max_retained_size)
+{
+}
+
+void* ScratchArena::bump(Block& block, size_t size, size_t alignment)
+{
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+    uintptr_t start = (base + block.offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (!block.data || start + size > base + block.size)
+        return nullptr;
+    block.offset = start + size - base;
+    return reinterpret_cast<void*>(start);
+}
+
+ScratchArena::Block ScratchArena::systemBlock(size_t size)
+{
+    Block block{std::unique_ptr<uint8_t[]>(new uint8_t[size]), size, 0};
+    num_system_allocations_.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void* ScratchArena::allocate(size_t size, size_t alignment)
+{
+    if (alignment == 0)
+        alignment = alignof(std::max_align_t);
+    if ((alignment & (alignment - 1)) != 0)
+        return nullptr;
+    num_allocations_.fetch_add(1, std::memory_order_relaxed);
+    // Worst case padding is counted, so that the retained block grown to the peak fits the same allocations
+    used_ += size + alignment - 1;
+
+    void* ptr = bump(retained_, size, alignment);
+    if (!ptr && !spilled_.empty())
+        ptr = bump(spilled_.back(), size, alignment);
+    if (!ptr) {
+        size_t last_size = spilled_.empty() ? retained_.size : spilled_.back().size;
+        size_t block_size = std::max({size + alignment - 1, kMinBlockSize, 2 * last_size});
+        try {
+            spilled_.push_back(systemBlock(block_size));
+            ptr = bump(spilled_.back(), size, alignment);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+    return ptr;
+}
+
+void ScratchArena::reset()
+{
+    if (used_ > peak_size_.load(std::memory_order_relaxed))
+        peak_size_.store(used_, std::memory_order_relaxed);
+    if (!spilled_.empty()) {
+        spilled_.clear();
+        size_t new_size = std::min(used_, max_retained_size_);
+        if (new_size > retained_.size) {
+            retained_ = {nullptr, 0, 0};
+            try {
+                retained_ = systemBlock(new_size);
+            } catch (const std::bad_alloc&) {
+            }
+            retained_size_.store(retained_.size, std::memory_order_relaxed);
+        }
+    }
+    retained_.offset = 0;
+    used_ = 0;
+}
+
+void ScratchArenas::Registry::release(std::thread::id thread_id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = arenas.find(thread_id);
+    if (it == arenas.end())
+        return;
+    released_allocations += it->second->numAllocations();
+    released_system_allocations += it->second->numSystemAllocations();
+    released_peak_size = std::max(released_peak_size, it->second->peakSize());
+    arenas.erase(it);
+}
+
+// Arenas of the calling thread, released when it exits
+struct ScratchArenas::ThreadArenas
+{
+    ~ThreadArenas()
+    {
+        for (auto& weak_registry : registries) {
+            if (auto registry = weak_registry.lock())
+                registry->release(std::this_thread::get_id());
+        }
+    }
+
+    // Last used arena
+    uint64_t id = 0;
+    ScratchArena* arena = nullptr;
+    std::vector<std::weak_ptr<Registry>> registries;
+};
+
+ScratchArenas::ScratchArenas(size_t max_retained_size)
+    : id_([] {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id++;
+    }())
+    , max_retained_size_(max_retained_size)
+    , registry_(std::make_shared<Registry>())
+{
+}
+
+ScratchArena& ScratchArenas::local()
+{
+    thread_local ThreadArenas thread_arenas;
+    if (thread_arenas.id == id_)
+        return *thread_arenas.arena;
+
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+    auto& arena = registry_->arenas[std::this_thread::get_id()];
+    if (!arena) {
+        arena = std::make_unique<ScratchArena>(max_retained_size_);
+        auto& registries = thread_arenas.registries;
+        registries.erase(std::remove_if(registries.begin(), registries.end(), [](auto& weak) { return weak.expired(); }), registries.end());
+        registries.push_back(registry_);
+    }
+    thread_arenas.id = id_;
+    thread_arenas.arena = arena.get();
+    return *arena;
+}
+
+void ScratchArenas::getStats(nvimgcodecScratchArenaStats_t* stats) const
+{
+    std::lock_guard<std::mutex> lock(registry_->mutex);
+    stats->num_arenas = registry_->arenas.size();
+    stats->num_allocations = registry_->released_allocations;
+    stats->num_system_allocations = registry_->released_system_allocations;
+    stats->retained_size = 0;
+    stats->peak_size = registry_->released_peak_size;
+    for (auto& [thread_id, arena] : registry_->arenas) {
+        stats->num_allocations += arena->numAllocations();
+        stats->num_system_allocations += arena->numSystemAllocations();
+        stats->retained_size += arena->retainedSize();
+        stats->peak_size = std::max(stats->peak_size, arena->peakSize());
+    }
+}
+
+} // namespace nvimgcodec
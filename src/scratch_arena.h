@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nvimgcodec {
+
+/**
+ * @brief Bump allocator for the temporaries of the tasks of one thread.
+ *
+ * Allocations are carved from a single retained block. When it is too small, they spill to extra system allocations,
+ * released on reset, and the block then grows to the largest amount used so far (capped at max_retained_size),
+ * so that the next tasks fit in it. Only the owning thread allocates, the counters can be read from any thread.
+ */
+class ScratchArena
+{
+  public:
+    explicit ScratchArena(size_t max_retained_size);
+
+    void* allocate(size_t size, size_t alignment);
+    void reset();
+
+    uint64_t numAllocations() const { return num_allocations_.load(std::memory_order_relaxed); }
+    uint64_t numSystemAllocations() const { return num_system_allocations_.load(std::memory_order_relaxed); }
+    uint64_t retainedSize() const { return retained_size_.load(std::memory_order_relaxed); }
+    uint64_t peakSize() const { return peak_size_.load(std::memory_order_relaxed); }
+
+  private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+        size_t offset;
+    };
+
+    static void* bump(Block& block, size_t size, size_t alignment);
+    Block systemBlock(size_t size);
+
+    size_t max_retained_size_;
+    Block retained_{nullptr, 0, 0};
+    std::vector<Block> spilled_; // Released on reset
+    size_t used_ = 0;            // Bytes used since the last reset, including alignment padding
+
+    std::atomic<uint64_t> num_allocations_{0};
+    std::atomic<uint64_t> num_system_allocations_{0};
+    std::atomic<uint64_t> retained_size_{0};
+    std::atomic<uint64_t> peak_size_{0};
+};
+
+/**
+ * @brief Scratch arenas of a library instance, one per thread using it. Thread safe.
+ *
+ * The arena of a thread is released when the thread exits, so that short-lived threads don't leave their retained
+ * blocks behind. Counters of released arenas are kept in the stats.
+ */
+class ScratchArenas
+{
+  public:
+    static constexpr size_t kDefaultMaxRetainedSize = 64 << 20;
+
+    explicit ScratchArenas(size_t max_retained_size = kDefaultMaxRetainedSize);
+
+    /**
+     * @brief Returns the arena of the calling thread, creating it if needed
+     */
+    ScratchArena& local();
+
+    void getStats(nvimgcodecScratchArenaStats_t* stats) const;
+
+  private:
+    // Arenas by thread. Threads hold weak references to it, to release their arena at exit if the instance still exists.
+    struct Registry
+    {
+        void release(std::thread::id thread_id);
+
+        mutable std::mutex mutex;
+        std::unordered_map<std::thread::id, std::unique_ptr<ScratchArena>> arenas;
+        uint64_t released_allocations = 0;
+        uint64_t released_system_allocations = 0;
+        uint64_t released_peak_size = 0;
+    };
+    struct ThreadArenas;
+
+    const uint64_t id_; // Unique among all instances, so that a thread doesn't use an arena cached for a destroyed one
+    size_t max_retained_size_;
+    std::shared_ptr<Registry> registry_;
+};
+
+} // namespace nvimgcodec
@@ -29,7 +29,8 @@ namespace nvimgcodec {
 StdFileIoStream::StdFileIoStream(const std::string& path, bool to_write)
     : FileIoStream(path)
 {
-    fp_ = std::fopen(path.c_str(), to_write ? "wb" : "rb");
+    // Output files are readable too, as some encoders (e.g. libtiff) read back what they have written
+    fp_ = std::fopen(path.c_str(), to_write ? "w+b" : "rb");
     if (fp_ == nullptr)
         throw std::runtime_error("Could not open file " + path + ": " + std::strerror(errno));
 }
@@ -21,11 +21,12 @@
 
 #include <imgproc/device_guard.h>
 #include "log.h"
+#include "numa_topology.h"
 
 namespace nvimgcodec {
 
-ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const char* name)
-    : threads_(num_thread), running_(true), work_complete_(true), started_(false)
+ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity, const char* name, const std::vector<int>& cpus)
+    : threads_(num_thread), cpus_(cpus), running_(true), work_complete_(true), started_(false)
     , active_threads_(0) {
   if (num_thread == 0) {
     NVIMGCODEC_LOG_FATAL(Logger::get_default(), "Thread pool must have non-zero size");
@@ -66,7 +67,7 @@ void ThreadPool::addWork(Work work, int64_t priority, bool start_immediately) {
   bool started_before = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    work_queue_.push({priority, std::move(work)});
+    work_queue_.push({priority, std::move(work), nullptr, 0});
     work_complete_ = false;
     started_before = started_;
     started_ |= start_immediately;
@@ -79,6 +80,27 @@ void ThreadPool::addWork(Work work, int64_t priority, bool start_immediately) {
   }
 }
 
+void ThreadPool::addBatch(int num_tasks, BatchWork batch_work, int64_t priority) {
+  if (num_tasks <= 0)
+    return;
+  auto shared_work = std::make_shared<const BatchWork>(std::move(batch_work));
+  bool started_before = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < num_tasks; i++)
+      work_queue_.push({priority, nullptr, shared_work, i});
+    work_complete_ = false;
+    started_before = started_;
+    started_ = true;
+  }
+  if (!started_before || num_tasks >= static_cast<int>(threads_.size())) {
+    condition_.notify_all();
+  } else {
+    for (int i = 0; i < num_tasks; i++)
+      condition_.notify_one();
+  }
+}
+
 // Blocks until all work issued to the thread pool is complete
 void ThreadPool::waitForWork(bool checkForErrors) {
   std::unique_lock<std::mutex> lock(mutex_);
@@ -147,6 +169,9 @@ void ThreadPool::threadMain(int thread_id, int device_id, bool set_affinity,
       nvml::SetCPUAffinity(core);
     }
 #endif
+    if (!cpus_.empty() && !SetThreadCpus(cpus_)) {
+      NVIMGCODEC_LOG_WARNING(Logger::get_default(), "Could not restrict thread " << thread_id << " of " << name << " to its CPUs");
+    }
   } catch (std::exception &e) {
     tl_errors_[thread_id].push(e.what());
   } catch (...) {
@@ -162,7 +187,9 @@ void ThreadPool::threadMain(int thread_id, int device_id, bool set_affinity,
 
     // Get work from the queue & mark
     // this thread as active
-    Work work = std::move(work_queue_.top().second);
+    Work work = std::move(work_queue_.top().work);
+    auto batch_work = std::move(work_queue_.top().batch_work);
+    int task_idx = work_queue_.top().task_idx;
     work_queue_.pop();
     ++active_threads_;
 
@@ -173,7 +200,10 @@ void ThreadPool::threadMain(int thread_id, int device_id, bool set_affinity,
     // WaitForWork is called, we will check for any errors
     // in the threads and return an error if one occured.
     try {
-      work(thread_id);
+      if (batch_work)
+        (*batch_work)(thread_id, task_idx);
+      else
+        work(thread_id);
     } catch (std::exception &e) {
       lock.lock();
       tl_errors_[thread_id].push(e.what());
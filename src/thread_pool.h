@@ -20,6 +20,7 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -38,10 +39,11 @@ class ThreadPool
     // Basic unit of work that our threads do
     typedef std::function<void(int)> Work;
 
-    ThreadPool(int num_thread, int device_id, bool set_affinity, const char* name);
+    // If cpus is not empty, the threads are restricted to these CPUs, e.g. the CPUs of a NUMA node
+    ThreadPool(int num_thread, int device_id, bool set_affinity, const char* name, const std::vector<int>& cpus = {});
 
-    ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string& name)
-        : ThreadPool(num_thread, device_id, set_affinity, name.c_str())
+    ThreadPool(int num_thread, int device_id, bool set_affinity, const std::string& name, const std::vector<int>& cpus = {})
+        : ThreadPool(num_thread, device_id, set_affinity, name.c_str(), cpus)
     {
     }
 
@@ -57,6 +59,16 @@ class ThreadPool
    */
     void addWork(Work work, int64_t priority = 0, bool start_immediately = false);
 
+    // Work item of a batch, called with the index of the item
+    typedef std::function<void(int thread_id, int task_idx)> BatchWork;
+
+    /**
+   * @brief Adds num_tasks work items running batch_work with task indices [0, num_tasks), and starts processing
+   *
+   * The queue is locked once for the whole batch, and only as many threads as there are tasks are woken up.
+   */
+    void addBatch(int num_tasks, BatchWork batch_work, int64_t priority = 0);
+
     /**
    * @brief Wakes up all the threads to complete all the queued work,
    *        optionally not waiting for the work to be finished before return
@@ -82,13 +94,21 @@ class ThreadPool
     void threadMain(int thread_id, int device_id, bool set_affinity, const std::string& name);
 
     std::vector<std::thread> threads_;
+    std::vector<int> cpus_;
 
-    using PrioritizedWork = std::pair<int64_t, Work>;
+    // Either a single work item, or the item `task_idx` of a batch, whose function is shared by all its items
+    struct PrioritizedWork
+    {
+        int64_t priority;
+        Work work;
+        std::shared_ptr<const BatchWork> batch_work;
+        int task_idx;
+    };
     struct SortByPriority
     {
         bool operator()(const PrioritizedWork& a, const PrioritizedWork& b)
         {
-            return a.first < b.first;
+            return a.priority < b.priority;
         }
     };
     std::priority_queue<PrioritizedWork, std::vector<PrioritizedWork>, SortByPriority> work_queue_;
@@ -18,20 +18,65 @@
 #pragma once
 
 #include <nvimgcodec.h>
+#include <cstddef>
 #include <map>
 #include "iexecutor.h"
 #include "thread_pool.h"
 
 namespace nvimgcodec {
 
+/**
+ * @brief Executor provided by the user.
+ *
+ * Executors which don't implement launchBatch, e.g. written against an older version of the library, are wrapped
+ * with a descriptor which launches batches task by task, so that plugins can always use it.
+ */
 class UserExecutor : public IExecutor
 {
   public:
-    explicit UserExecutor(nvimgcodecExecutorDesc_t* executor_desc) : desc_(executor_desc) {}
+    explicit UserExecutor(nvimgcodecExecutorDesc_t* executor_desc)
+        : user_desc_(executor_desc)
+        , desc_(executor_desc)
+    {
+        bool has_launch_batch = executor_desc->struct_size >= offsetof(nvimgcodecExecutorDesc_t, launchBatch) + sizeof(void*) &&
+                                executor_desc->launchBatch;
+        if (!has_launch_batch) {
+            shim_desc_ = {NVIMGCODEC_STRUCTURE_TYPE_EXECUTOR_DESC, sizeof(nvimgcodecExecutorDesc_t), nullptr, this, &static_launch,
+                &static_get_num_threads, &static_launch_batch};
+            desc_ = &shim_desc_;
+        }
+    }
     ~UserExecutor() override = default;
     nvimgcodecExecutorDesc_t* getExecutorDesc() override { return desc_; }
 
   private:
+    static nvimgcodecStatus_t static_launch(
+        void* instance, int device_id, int sample_idx, void* task_context, void (*task)(int thread_id, int sample_idx, void* task_context))
+    {
+        auto* user_desc = reinterpret_cast<UserExecutor*>(instance)->user_desc_;
+        return user_desc->launch(user_desc->instance, device_id, sample_idx, task_context, task);
+    }
+
+    static int static_get_num_threads(void* instance)
+    {
+        auto* user_desc = reinterpret_cast<UserExecutor*>(instance)->user_desc_;
+        return user_desc->getNumThreads(user_desc->instance);
+    }
+
+    static nvimgcodecStatus_t static_launch_batch(
+        void* instance, int device_id, int num_tasks, void* task_context, void (*task)(int thread_id, int sample_idx, void* task_context))
+    {
+        auto* user_desc = reinterpret_cast<UserExecutor*>(instance)->user_desc_;
+        for (int i = 0; i < num_tasks; i++) {
+            auto status = user_desc->launch(user_desc->instance, device_id, i, task_context, task);
+            if (status != NVIMGCODEC_STATUS_SUCCESS)
+                return status;
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    nvimgcodecExecutorDesc_t* user_desc_;
+    nvimgcodecExecutorDesc_t shim_desc_{};
     nvimgcodecExecutorDesc_t* desc_;
 };
 
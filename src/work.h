@@ -20,6 +20,7 @@
 #include <nvimgcodec.h>
 #include <cassert>
 #include <map>
+#include <string>
 #include <vector>
 #include "exception.h"
 #include "icode_stream.h"
@@ -52,6 +53,7 @@ struct Work
         host_temp_buffers_.clear();
         device_temp_buffers_.clear();
         idx2orig_buffer_.clear();
+        signatures_.clear();
     }
 
     int getSamplesNum() const { return indices_.size(); }
@@ -64,18 +66,21 @@ struct Work
         code_streams_.resize(num_samples);
         if (!images_.empty())
             images_.resize(num_samples);
+        if (!signatures_.empty())
+            signatures_.resize(num_samples);
     }
 
     void init(const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>& images,
               const std::vector<size_t>& order)
     {
         int N = images.size();
-        assert(static_cast<int>(order.size()) == N || order.empty());
+        assert(static_cast<int>(order.size()) <= N);
         indices_.reserve(N);
         images_.reserve(N);
         code_streams_.reserve(N);
         if (!order.empty()) {
-            for (int i = 0; i < N; i++) {
+            // Samples missing from the order are not processed
+            for (size_t i = 0; i < order.size(); i++) {
                 int sample_idx = order[i];
                 indices_.push_back(sample_idx);
                 images_.push_back(images[sample_idx]);
@@ -107,6 +112,10 @@ struct Work
             auto entry = from->idx2orig_buffer_.extract(which);
             idx2orig_buffer_.insert(std::move(entry));
         }
+        if (!from->signatures_.empty() || !signatures_.empty()) {
+            signatures_.resize(indices_.size() - 1);
+            signatures_.push_back(from->signatures_.empty() ? std::string() : std::move(from->signatures_[which]));
+        }
     }
 
     /**
@@ -259,6 +268,8 @@ struct Work
     std::vector<std::unique_ptr<void, decltype(&cudaFreeHost)>> host_temp_buffers_;
     std::vector<std::unique_ptr<void, decltype(&cudaFree)>> device_temp_buffers_;
     std::map<int, void*> idx2orig_buffer_;
+    // Decoder canDecode signatures, kept through fallbacks so they are computed once. Empty, or empty strings, if not computed yet
+    std::vector<std::string> signatures_;
     const T* params_;
     std::unique_ptr<Work> next_;
 };
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "../extensions/utils/parallel_exec.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+// Runs the launched tasks immediately, in the calling thread
+struct CountingExecutor
+{
+    CountingExecutor()
+        : desc{NVIMGCODEC_STRUCTURE_TYPE_EXECUTOR_DESC, sizeof(nvimgcodecExecutorDesc_t), nullptr, this, &launch, &getNumThreads, &launchBatch}
+    {
+    }
+
+    static nvimgcodecStatus_t launch(void* instance, int device_id, int sample_idx, void* task_context,
+        void (*task)(int thread_id, int sample_idx, void* task_context))
+    {
+        reinterpret_cast<CountingExecutor*>(instance)->num_launched++;
+        task(0, sample_idx, task_context);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    static int getNumThreads(void* instance) { return 4; }
+
+    static nvimgcodecStatus_t launchBatch(void* instance, int device_id, int num_tasks, void* task_context,
+        void (*task)(int thread_id, int sample_idx, void* task_context))
+    {
+        for (int i = 0; i < num_tasks; i++)
+            launch(instance, device_id, i, task_context, task);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    nvimgcodecExecutorDesc_t desc;
+    int num_launched = 0;
+};
+
+} // namespace
+
+TEST(AdaptiveParallelPolicy, NotMeasured)
+{
+    AdaptiveParallelPolicy policy;
+    auto plan = policy.plan(8, 4);
+    EXPECT_EQ(4, plan.num_workers);
+    EXPECT_EQ(1, plan.chunk_size);
+    EXPECT_EQ(0, policy.plan(1, 4).num_workers);
+}
+
+TEST(AdaptiveParallelPolicy, CheapTasksRunInline)
+{
+    AdaptiveParallelPolicy policy;
+    policy.recordTasks(10, 10 * 100);
+    policy.recordHandoff(10000);
+    EXPECT_EQ(0, policy.plan(16, 4).num_workers);
+}
+
+TEST(AdaptiveParallelPolicy, ExpensiveTasksUseAllThreads)
+{
+    AdaptiveParallelPolicy policy;
+    policy.recordTasks(1, 1000000);
+    policy.recordHandoff(10000);
+    auto plan = policy.plan(16, 4);
+    EXPECT_EQ(4, plan.num_workers);
+    EXPECT_EQ(1, plan.chunk_size);
+}
+
+TEST(AdaptiveParallelPolicy, ChunksAmortizeHandoff)
+{
+    AdaptiveParallelPolicy policy;
+    policy.recordTasks(1, 10000);
+    policy.recordHandoff(10000);
+    auto plan = policy.plan(100, 8);
+    EXPECT_EQ(8, plan.num_workers);
+    EXPECT_EQ(4, plan.chunk_size);
+
+    // Only 2 threads worth of work
+    plan = policy.plan(10, 8);
+    EXPECT_EQ(2, plan.num_workers);
+    EXPECT_EQ(4, plan.chunk_size);
+}
+
+TEST(AdaptiveParallelPolicy, MovingAverage)
+{
+    AdaptiveParallelPolicy policy;
+    EXPECT_EQ(-1, policy.taskCost());
+    policy.recordTasks(2, 200);
+    EXPECT_EQ(100, policy.taskCost());
+    policy.recordTasks(1, 500);
+    EXPECT_EQ(200, policy.taskCost());
+}
+
+TEST(AdaptiveParallelPolicy, AdaptiveLaunchBatch)
+{
+    CountingExecutor executor;
+    auto policy = std::make_shared<AdaptiveParallelPolicy>();
+    std::vector<int> runs(16);
+    auto task = [](int tid, int sample_idx, void* context) { (*reinterpret_cast<std::vector<int>*>(context))[sample_idx]++; };
+
+    // Not measured yet, each sample is handed off
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, AdaptiveLaunchBatch(&executor.desc, 0, 16, &runs, task, policy));
+    EXPECT_EQ(16, executor.num_launched);
+    EXPECT_GE(policy->taskCost(), 0);
+    EXPECT_GE(policy->handoffCost(), 0);
+
+    // Tasks are much cheaper than a hand-off
+    policy->recordHandoff(AdaptiveParallelPolicy::kDefaultHandoffNs * 100);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, AdaptiveLaunchBatch(&executor.desc, 0, 16, &runs, task, policy));
+    EXPECT_EQ(16, executor.num_launched);
+    for (int r : runs)
+        EXPECT_EQ(2, r);
+}
+
+TEST(AdaptiveParallelPolicy, AdaptiveLaunchBatchInlineUsesCallerThreadId)
+{
+    // The executor threads have ids from 0, so the calling thread must not take one of them
+    CountingExecutor executor;
+    auto policy = std::make_shared<AdaptiveParallelPolicy>();
+    policy->recordTasks(16, 16);
+    policy->recordHandoff(AdaptiveParallelPolicy::kDefaultHandoffNs * 100);
+    std::vector<int> thread_ids(16, 0);
+    auto task = [](int tid, int sample_idx, void* context) { (*reinterpret_cast<std::vector<int>*>(context))[sample_idx] = tid; };
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, AdaptiveLaunchBatch(&executor.desc, 0, 16, &thread_ids, task, policy));
+    EXPECT_EQ(0, executor.num_launched);
+    EXPECT_EQ(std::vector<int>(16, -1), thread_ids);
+}
+
+TEST(AdaptiveParallelPolicy, BlockParallelExec)
+{
+    CountingExecutor executor;
+    nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), nullptr};
+    exec_params.executor = &executor.desc;
+    AdaptiveParallelPolicy policy;
+    std::vector<int> runs(100);
+    auto task = [](int tid, int sample_idx, void* context) { (*reinterpret_cast<std::vector<int>*>(context))[sample_idx]++; };
+
+    BlockParallelExec(&runs, task, 100, &exec_params, &policy);
+    EXPECT_EQ(4, executor.num_launched);
+    EXPECT_GE(policy.taskCost(), 0);
+
+    policy.recordHandoff(AdaptiveParallelPolicy::kDefaultHandoffNs * 100);
+    BlockParallelExec(&runs, task, 100, &exec_params, &policy);
+    EXPECT_EQ(4, executor.num_launched);
+    for (int r : runs)
+        EXPECT_EQ(2, r);
+}
+
+}} // namespace nvimgcodec::test
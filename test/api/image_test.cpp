@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <vector>
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+class ImageApiTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        nvimgcodecInstanceCreateInfo_t create_info{NVIMGCODEC_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, sizeof(nvimgcodecInstanceCreateInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecInstanceCreate(&instance_, &create_info));
+    }
+
+    void TearDown() override
+    {
+        if (instance_) {
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecInstanceDestroy(instance_));
+        }
+    }
+
+    nvimgcodecImageInfo_t hostImageInfo(unsigned char* buffer, uint32_t width, uint32_t height)
+    {
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image_info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        image_info.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        image_info.num_planes = 1;
+        image_info.plane_info[0].width = width;
+        image_info.plane_info[0].height = height;
+        image_info.plane_info[0].num_channels = 3;
+        image_info.plane_info[0].row_stride = width * 3;
+        image_info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        image_info.buffer = buffer;
+        image_info.buffer_size = static_cast<size_t>(width) * height * 3;
+        image_info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        return image_info;
+    }
+
+    nvimgcodecInstance_t instance_ = nullptr;
+};
+
+} // namespace
+
+TEST_F(ImageApiTest, SetImageInfoRepointsImage)
+{
+    std::vector<unsigned char> first(4 * 2 * 3), second(8 * 6 * 3);
+    auto image_info = hostImageInfo(first.data(), 4, 2);
+    nvimgcodecImage_t image = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &image_info));
+
+    auto new_info = hostImageInfo(second.data(), 8, 6);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageSetImageInfo(image, &new_info));
+
+    nvimgcodecImageInfo_t result{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageGetImageInfo(image, &result));
+    EXPECT_EQ(second.data(), result.buffer);
+    EXPECT_EQ(8u, result.plane_info[0].width);
+    EXPECT_EQ(6u, result.plane_info[0].height);
+    EXPECT_EQ(second.size(), result.buffer_size);
+
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+}
+
+TEST_F(ImageApiTest, SetImageInfoRejectsInvalidInfo)
+{
+    std::vector<unsigned char> buffer(4 * 2 * 3);
+    auto image_info = hostImageInfo(buffer.data(), 4, 2);
+    nvimgcodecImage_t image = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &image_info));
+
+    auto invalid = image_info;
+    invalid.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_UNKNOWN;
+    EXPECT_EQ(NVIMGCODEC_STATUS_INVALID_PARAMETER, nvimgcodecImageSetImageInfo(image, &invalid));
+    invalid = image_info;
+    invalid.buffer = nullptr;
+    EXPECT_EQ(NVIMGCODEC_STATUS_INVALID_PARAMETER, nvimgcodecImageSetImageInfo(image, &invalid));
+
+    nvimgcodecImageInfo_t result{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageGetImageInfo(image, &result));
+    EXPECT_EQ(buffer.data(), result.buffer);
+
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+}
+
+TEST_F(ImageApiTest, DestroyedHandlesAreReused)
+{
+    std::vector<unsigned char> buffer(4 * 2 * 3);
+    auto image_info = hostImageInfo(buffer.data(), 4, 2);
+    nvimgcodecImage_t image = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &image_info));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+
+    nvimgcodecImage_t reused = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &reused, &image_info));
+    EXPECT_EQ(image, reused);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(reused));
+}
+
+TEST_F(ImageApiTest, HandlesArePooledPerInstance)
+{
+    std::vector<unsigned char> buffer(4 * 2 * 3);
+    auto image_info = hostImageInfo(buffer.data(), 4, 2);
+    nvimgcodecImage_t image = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &image_info));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+
+    nvimgcodecInstanceCreateInfo_t create_info{NVIMGCODEC_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, sizeof(nvimgcodecInstanceCreateInfo_t), 0};
+    nvimgcodecInstance_t other_instance = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecInstanceCreate(&other_instance, &create_info));
+    nvimgcodecImage_t other = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(other_instance, &other, &image_info));
+    EXPECT_NE(image, other);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(other));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecInstanceDestroy(other_instance));
+
+    nvimgcodecImage_t reused = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &reused, &image_info));
+    EXPECT_EQ(image, reused);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(reused));
+}
+
+}} // namespace nvimgcodec::test
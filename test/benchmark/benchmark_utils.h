@@ -0,0 +1,532 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <nvimgcodec.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nvimgcodec { namespace bench {
+
+/**
+ * @brief Interleaved 8-bit image with smooth gradients and some texture, different for every seed
+ */
+inline std::vector<uint8_t> SyntheticImage(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed = 0)
+{
+    std::vector<uint8_t> image(static_cast<size_t>(width) * height * channels);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* px = &image[(static_cast<size_t>(y) * width + x) * channels];
+            for (uint32_t c = 0; c < channels; c++) {
+                double texture = 100 * std::sin((x + seed) * (0.1 + 0.02 * c)) * std::cos((y + 3 * seed) * 0.07);
+                double gradient = c % 2 ? y * 127.0 / height : x * 127.0 / width;
+                px[c] = static_cast<uint8_t>(64 + gradient + texture / 2 + 0.5);
+            }
+        }
+    }
+    return image;
+}
+
+inline void PutBE(std::vector<uint8_t>& out, uint32_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--)
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+inline void PutLE(std::vector<uint8_t>& out, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+/**
+ * @brief BMP with a 24-bit bottom-up pixel array, from an interleaved RGB image.
+ *
+ * dib_header_size selects the header version, 40 (BITMAPINFOHEADER), 108 (V4) or 124 (V5).
+ */
+inline std::vector<uint8_t> MakeBmp(uint32_t width, uint32_t height, const uint8_t* rgb, uint32_t dib_header_size = 40)
+{
+    uint32_t row_size = (width * 3 + 3) & ~3u;
+    uint32_t data_offset = 14 + dib_header_size;
+    std::vector<uint8_t> out{'B', 'M'};
+    PutLE(out, data_offset + row_size * height, 4);
+    PutLE(out, 0, 4);
+    PutLE(out, data_offset, 4);
+    PutLE(out, dib_header_size, 4);
+    PutLE(out, width, 4);
+    PutLE(out, height, 4);
+    PutLE(out, 1, 2);  // planes
+    PutLE(out, 24, 2); // bits per pixel
+    out.resize(data_offset, 0);
+    for (uint32_t y = height; y-- > 0;) {
+        const uint8_t* row = rgb + static_cast<size_t>(y) * width * 3;
+        for (uint32_t x = 0; x < width; x++) {
+            out.push_back(row[3 * x + 2]);
+            out.push_back(row[3 * x + 1]);
+            out.push_back(row[3 * x + 0]);
+        }
+        out.resize(out.size() + row_size - width * 3, 0);
+    }
+    return out;
+}
+
+/**
+ * @brief Binary PPM from an interleaved RGB image, with about comment_size bytes of comments in the header
+ */
+inline std::vector<uint8_t> MakePnm(uint32_t width, uint32_t height, const uint8_t* rgb, uint32_t comment_size = 0)
+{
+    std::string header = "P6\n";
+    for (uint32_t left = comment_size; left >= 2;) {
+        uint32_t line = std::min<uint32_t>(left, 72);
+        header += "#" + std::string(line - 2, 'c') + "\n";
+        left -= line;
+    }
+    header += std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    std::vector<uint8_t> out(header.begin(), header.end());
+    out.insert(out.end(), rgb, rgb + static_cast<size_t>(width) * height * 3);
+    return out;
+}
+
+/**
+ * @brief Uncompressed little-endian RGB TIFF in a single strip, with an image description of description_size bytes
+ */
+inline std::vector<uint8_t> MakeTiff(uint32_t width, uint32_t height, const uint8_t* rgb, uint32_t description_size = 0)
+{
+    struct Entry
+    {
+        uint16_t tag, type;
+        uint32_t count, value;
+    };
+    constexpr uint16_t kShort = 3, kLong = 4, kAscii = 2;
+    uint32_t num_entries = description_size > 0 ? 11 : 10;
+    uint32_t ifd_size = 2 + 12 * num_entries + 4;
+    uint32_t bps_offset = 8 + ifd_size;
+    uint32_t description_offset = bps_offset + 6;
+    uint32_t data_offset = description_offset + (description_size > 0 ? description_size + 1 : 0);
+    uint32_t data_size = width * height * 3;
+
+    std::vector<Entry> entries = {{256, kLong, 1, width}, {257, kLong, 1, height}, {258, kShort, 3, bps_offset}, {259, kShort, 1, 1},
+        {262, kShort, 1, 2}};
+    if (description_size > 0)
+        entries.push_back({270, kAscii, description_size + 1, description_offset});
+    entries.insert(entries.end(), {{273, kLong, 1, data_offset}, {277, kShort, 1, 3}, {278, kLong, 1, height},
+                                      {279, kLong, 1, data_size}, {284, kShort, 1, 1}});
+
+    std::vector<uint8_t> out{'I', 'I', 42, 0};
+    PutLE(out, 8, 4);
+    PutLE(out, num_entries, 2);
+    for (auto& e : entries) {
+        PutLE(out, e.tag, 2);
+        PutLE(out, e.type, 2);
+        PutLE(out, e.count, 4);
+        PutLE(out, e.value, e.type == kShort && e.count == 1 ? 2 : 4);
+        if (e.type == kShort && e.count == 1)
+            PutLE(out, 0, 2);
+    }
+    PutLE(out, 0, 4);
+    for (int c = 0; c < 3; c++)
+        PutLE(out, 8, 2);
+    if (description_size > 0) {
+        out.resize(out.size() + description_size, 'd');
+        out.push_back(0);
+    }
+    out.insert(out.end(), rgb, rgb + data_size);
+    return out;
+}
+
+/**
+ * @brief Baseline JPEG header of an RGB image, with comment_size bytes of COM segments before the frame header.
+ *
+ * There is no entropy coded data, so it can only be parsed.
+ */
+inline std::vector<uint8_t> MakeJpegHeader(uint32_t width, uint32_t height, uint32_t comment_size = 0)
+{
+    std::vector<uint8_t> out{0xFF, 0xD8};
+    for (uint32_t left = comment_size; left > 0;) {
+        uint32_t payload = std::min<uint32_t>(left, 65533);
+        PutBE(out, 0xFFFE, 2);
+        PutBE(out, payload + 2, 2);
+        out.resize(out.size() + payload, 'c');
+        left -= payload;
+    }
+    PutBE(out, 0xFFC0, 2);
+    PutBE(out, 17, 2);
+    out.push_back(8);
+    PutBE(out, height, 2);
+    PutBE(out, width, 2);
+    out.push_back(3);
+    for (uint8_t c = 1; c <= 3; c++)
+        out.insert(out.end(), {c, 0x11, 0});
+    PutBE(out, 0xFFDA, 2);
+    PutBE(out, 12, 2);
+    out.push_back(3);
+    for (uint8_t c = 1; c <= 3; c++)
+        out.insert(out.end(), {c, 0});
+    out.insert(out.end(), {0, 63, 0});
+    PutBE(out, 0xFFD9, 2);
+    return out;
+}
+
+inline uint32_t Crc32(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+inline void PutPngChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+{
+    PutBE(out, data.size(), 4);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBE(out, Crc32(out.data() + start, out.size() - start), 4);
+}
+
+/**
+ * @brief PNG header of an 8-bit RGB image, with text_size bytes of tEXt chunks before the image data.
+ *
+ * The image data is empty, so it can only be parsed.
+ */
+inline std::vector<uint8_t> MakePngHeader(uint32_t width, uint32_t height, uint32_t text_size = 0)
+{
+    std::vector<uint8_t> out{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> ihdr;
+    PutBE(ihdr, width, 4);
+    PutBE(ihdr, height, 4);
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0});
+    PutPngChunk(out, "IHDR", ihdr);
+    for (uint32_t left = text_size; left > 0;) {
+        uint32_t size = std::min<uint32_t>(left, 4096);
+        std::vector<uint8_t> text{'C', 'o', 'm', 'm', 'e', 'n', 't', 0};
+        text.resize(std::max<size_t>(size, text.size() + 1), 't');
+        PutPngChunk(out, "tEXt", text);
+        left -= size;
+    }
+    PutPngChunk(out, "IDAT", {});
+    PutPngChunk(out, "IEND", {});
+    return out;
+}
+
+/**
+ * @brief JPEG 2000 code stream main header of an 8-bit RGB image, with comment_size bytes of COM segments.
+ *
+ * There are no tiles, so it can only be parsed.
+ */
+inline std::vector<uint8_t> MakeJpeg2kHeader(uint32_t width, uint32_t height, uint32_t comment_size = 0)
+{
+    std::vector<uint8_t> out;
+    PutBE(out, 0xFF4F, 2); // SOC
+    PutBE(out, 0xFF51, 2); // SIZ
+    PutBE(out, 38 + 3 * 3, 2);
+    PutBE(out, 0, 2);
+    for (uint32_t v : {width, height, 0u, 0u, width, height, 0u, 0u})
+        PutBE(out, v, 4);
+    PutBE(out, 3, 2);
+    for (int c = 0; c < 3; c++)
+        out.insert(out.end(), {7, 1, 1});
+    for (uint32_t left = comment_size; left > 0;) {
+        uint32_t payload = std::min<uint32_t>(left, 65531);
+        PutBE(out, 0xFF64, 2); // COM
+        PutBE(out, payload + 4, 2);
+        PutBE(out, 1, 2);
+        out.resize(out.size() + payload, 'c');
+        left -= payload;
+    }
+    PutBE(out, 0xFFD9, 2); // EOC
+    return out;
+}
+
+/**
+ * @brief Lossless WebP header. There is no image data, so it can only be parsed.
+ */
+inline std::vector<uint8_t> MakeWebpHeader(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> out{'R', 'I', 'F', 'F'};
+    PutLE(out, 4 + 8 + 6, 4);
+    out.insert(out.end(), {'W', 'E', 'B', 'P', 'V', 'P', '8', 'L'});
+    PutLE(out, 5, 4);
+    out.push_back(0x2F);
+    PutLE(out, (width - 1) | ((height - 1) << 14), 4);
+    out.push_back(0); // padding to an even chunk size
+    return out;
+}
+
+using ExtensionDescGetter = nvimgcodecStatus_t (*)(nvimgcodecExtensionDesc_t*);
+
+/**
+ * @brief Instance with the builtin parsers and one codec extension, with a CPU only encoder and decoder
+ */
+class CodecBench
+{
+  public:
+    CodecBench(ExtensionDescGetter get_extension_desc, int num_threads)
+    {
+        nvimgcodecInstanceCreateInfo_t create_info{NVIMGCODEC_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, sizeof(nvimgcodecInstanceCreateInfo_t), 0};
+        create_info.load_builtin_modules = 1;
+        check(nvimgcodecInstanceCreate(&instance_, &create_info), "create instance");
+        nvimgcodecExtensionDesc_t extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        check(get_extension_desc(&extension_desc), "get extension description");
+        check(nvimgcodecExtensionCreate(instance_, &extension_, &extension_desc), "create extension");
+
+        nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+        exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+        exec_params.max_num_cpu_threads = num_threads;
+        check(nvimgcodecEncoderCreate(instance_, &encoder_, &exec_params, nullptr), "create encoder");
+        check(nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr), "create decoder");
+    }
+
+    ~CodecBench()
+    {
+        for (auto* image : images_)
+            nvimgcodecImageDestroy(image);
+        for (auto* code_stream : code_streams_)
+            nvimgcodecCodeStreamDestroy(code_stream);
+        if (decoder_)
+            nvimgcodecDecoderDestroy(decoder_);
+        if (encoder_)
+            nvimgcodecEncoderDestroy(encoder_);
+        if (extension_)
+            nvimgcodecExtensionDestroy(extension_);
+        if (instance_)
+            nvimgcodecInstanceDestroy(instance_);
+    }
+
+    CodecBench(const CodecBench&) = delete;
+    CodecBench& operator=(const CodecBench&) = delete;
+
+    static nvimgcodecImageInfo_t RgbImageInfo(uint32_t width, uint32_t height, uint8_t* buffer)
+    {
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image_info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        image_info.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        image_info.chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+        image_info.num_planes = 1;
+        image_info.plane_info[0].width = width;
+        image_info.plane_info[0].height = height;
+        image_info.plane_info[0].num_channels = 3;
+        image_info.plane_info[0].row_stride = width * 3;
+        image_info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        image_info.plane_info[0].precision = 8;
+        image_info.buffer = buffer;
+        image_info.buffer_size = static_cast<size_t>(width) * height * 3;
+        image_info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        return image_info;
+    }
+
+    /**
+     * @brief Encodes the images to the given codec, returns false if any of them failed
+     */
+    bool encode(std::vector<std::vector<uint8_t>>& images, uint32_t width, uint32_t height, const char* codec_name,
+        std::vector<std::vector<uint8_t>>* encoded)
+    {
+        encoded->resize(images.size());
+        prepareImages(images, width, height);
+        std::vector<nvimgcodecCodeStream_t> code_streams(images.size());
+        for (size_t i = 0; i < images.size(); i++) {
+            auto out_info = RgbImageInfo(width, height, nullptr);
+            strcpy(out_info.codec_name, codec_name);
+            check(nvimgcodecCodeStreamCreateToHostMem(instance_, &code_streams[i], &(*encoded)[i], &ResizeBuffer, &out_info),
+                "create output code stream");
+        }
+        nvimgcodecEncodeParams_t params{NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        params.quality = 90;
+        nvimgcodecFuture_t future = nullptr;
+        check(nvimgcodecEncoderEncode(encoder_, images_.data(), code_streams.data(), static_cast<int>(images.size()), &params, &future),
+            "encode");
+        bool success = waitForAll(future);
+        for (auto* code_stream : code_streams)
+            nvimgcodecCodeStreamDestroy(code_stream);
+        return success;
+    }
+
+    /**
+     * @brief Creates the code streams of the next decode calls
+     */
+    void setCodeStreams(const std::vector<std::vector<uint8_t>>& encoded)
+    {
+        for (auto* code_stream : code_streams_)
+            nvimgcodecCodeStreamDestroy(code_stream);
+        code_streams_.assign(encoded.size(), nullptr);
+        for (size_t i = 0; i < encoded.size(); i++)
+            check(nvimgcodecCodeStreamCreateFromHostMem(instance_, &code_streams_[i], encoded[i].data(), encoded[i].size()),
+                "create input code stream");
+    }
+
+    /**
+     * @brief Decodes the code streams to the images, returns false if any of them failed
+     */
+    bool decode(std::vector<std::vector<uint8_t>>& images, uint32_t width, uint32_t height)
+    {
+        prepareImages(images, width, height);
+        nvimgcodecDecodeParams_t params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+        nvimgcodecFuture_t future = nullptr;
+        check(nvimgcodecDecoderDecode(decoder_, code_streams_.data(), images_.data(), static_cast<int>(images_.size()), &params, &future),
+            "decode");
+        return waitForAll(future);
+    }
+
+  private:
+    static void check(nvimgcodecStatus_t status, const char* what)
+    {
+        if (status != NVIMGCODEC_STATUS_SUCCESS)
+            throw std::runtime_error(std::string("Could not ") + what + ", status " + std::to_string(status));
+    }
+
+    static unsigned char* ResizeBuffer(void* ctx, size_t bytes)
+    {
+        auto* buffer = static_cast<std::vector<uint8_t>*>(ctx);
+        buffer->resize(bytes);
+        return buffer->data();
+    }
+
+    // Image handles are kept across batches and pointed at the buffers of the current one
+    void prepareImages(std::vector<std::vector<uint8_t>>& images, uint32_t width, uint32_t height)
+    {
+        while (images_.size() > images.size()) {
+            nvimgcodecImageDestroy(images_.back());
+            images_.pop_back();
+        }
+        for (size_t i = 0; i < images.size(); i++) {
+            auto image_info = RgbImageInfo(width, height, images[i].data());
+            if (i < images_.size()) {
+                check(nvimgcodecImageSetImageInfo(images_[i], &image_info), "update image");
+            } else {
+                images_.push_back(nullptr);
+                check(nvimgcodecImageCreate(instance_, &images_.back(), &image_info), "create image");
+            }
+        }
+    }
+
+    static bool waitForAll(nvimgcodecFuture_t future)
+    {
+        check(nvimgcodecFutureWaitForAll(future), "wait for results");
+        size_t size = 0;
+        check(nvimgcodecFutureGetProcessingStatus(future, nullptr, &size), "get processing status");
+        std::vector<nvimgcodecProcessingStatus_t> status(size);
+        check(nvimgcodecFutureGetProcessingStatus(future, status.data(), &size), "get processing status");
+        nvimgcodecFutureDestroy(future);
+        for (auto s : status) {
+            if (s != NVIMGCODEC_PROCESSING_STATUS_SUCCESS)
+                return false;
+        }
+        return true;
+    }
+
+    nvimgcodecInstance_t instance_ = nullptr;
+    nvimgcodecExtension_t extension_ = nullptr;
+    nvimgcodecEncoder_t encoder_ = nullptr;
+    nvimgcodecDecoder_t decoder_ = nullptr;
+    std::vector<nvimgcodecImage_t> images_;
+    std::vector<nvimgcodecCodeStream_t> code_streams_;
+};
+
+constexpr uint32_t kCodecBenchWidth = 640;
+constexpr uint32_t kCodecBenchHeight = 480;
+
+/**
+ * @brief Batch sizes and thread counts of the codec benchmarks
+ */
+inline void CodecArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"batch", "threads"});
+    for (int64_t batch : {1, 16})
+        for (int64_t threads : {1, 4})
+            b->Args({batch, threads});
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+/**
+ * @brief Encodes batches of distinct synthetic images with the extension
+ */
+inline void Encode(benchmark::State& state, ExtensionDescGetter get_extension_desc, const char* codec_name)
+{
+    int batch = static_cast<int>(state.range(0));
+    CodecBench codec(get_extension_desc, static_cast<int>(state.range(1)));
+    std::vector<std::vector<uint8_t>> images, encoded;
+    for (int i = 0; i < batch; i++)
+        images.push_back(SyntheticImage(kCodecBenchWidth, kCodecBenchHeight, 3, i));
+
+    for (auto _ : state) {
+        if (!codec.encode(images, kCodecBenchWidth, kCodecBenchHeight, codec_name, &encoded)) {
+            state.SkipWithError("Encoding failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.SetBytesProcessed(state.iterations() * batch * kCodecBenchWidth * kCodecBenchHeight * 3);
+}
+
+using StreamWriter = std::vector<uint8_t> (*)(uint32_t width, uint32_t height, const uint8_t* rgb);
+
+inline std::vector<uint8_t> WriteBmp(uint32_t width, uint32_t height, const uint8_t* rgb)
+{
+    return MakeBmp(width, height, rgb);
+}
+
+inline std::vector<uint8_t> WritePnm(uint32_t width, uint32_t height, const uint8_t* rgb)
+{
+    return MakePnm(width, height, rgb);
+}
+
+inline std::vector<uint8_t> WriteTiff(uint32_t width, uint32_t height, const uint8_t* rgb)
+{
+    return MakeTiff(width, height, rgb);
+}
+
+/**
+ * @brief Decodes batches of distinct synthetic images, written by the given function, or by the encoder of the extension
+ * to codec_name if there is none
+ */
+inline void Decode(benchmark::State& state, ExtensionDescGetter get_extension_desc, const char* codec_name, StreamWriter writer = nullptr)
+{
+    int batch = static_cast<int>(state.range(0));
+    CodecBench codec(get_extension_desc, static_cast<int>(state.range(1)));
+    std::vector<std::vector<uint8_t>> images, encoded;
+    for (int i = 0; i < batch; i++)
+        images.push_back(SyntheticImage(kCodecBenchWidth, kCodecBenchHeight, 3, i));
+    if (writer) {
+        for (auto& image : images)
+            encoded.push_back(writer(kCodecBenchWidth, kCodecBenchHeight, image.data()));
+    } else if (!codec.encode(images, kCodecBenchWidth, kCodecBenchHeight, codec_name, &encoded)) {
+        state.SkipWithError("Encoding of the input failed");
+        return;
+    }
+    codec.setCodeStreams(encoded);
+
+    for (auto _ : state) {
+        if (!codec.decode(images, kCodecBenchWidth, kCodecBenchHeight)) {
+            state.SkipWithError("Decoding failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+    state.SetBytesProcessed(state.iterations() * batch * kCodecBenchWidth * kCodecBenchHeight * 3);
+}
+
+}} // namespace nvimgcodec::bench
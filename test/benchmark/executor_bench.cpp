@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "../../src/default_executor.h"
+#include "../../src/logger.h"
+#include "../../src/numa_topology.h"
+#include "../../src/processing_results.h"
+#include "../../src/thread_pool.h"
+
+namespace nvimgcodec { namespace bench {
+
+namespace {
+
+void WaitFor(std::atomic<int>& done, int num_tasks)
+{
+    while (done.load(std::memory_order_acquire) < num_tasks)
+        std::this_thread::yield();
+}
+
+} // namespace
+
+// Scheduling cost of one work item per task, which bounds the smallest task worth running in parallel
+static void ThreadPoolAddWork(benchmark::State& state)
+{
+    int num_tasks = static_cast<int>(state.range(0));
+    ThreadPool pool(static_cast<int>(state.range(1)), CPU_ONLY_DEVICE_ID, false, "bench");
+
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        for (int i = 0; i < num_tasks; i++)
+            pool.addWork([&done](int) { done.fetch_add(1, std::memory_order_release); }, 0, true);
+        pool.waitForWork();
+        benchmark::DoNotOptimize(done.load());
+    }
+    state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK(ThreadPoolAddWork)->ArgNames({"tasks", "threads"})->ArgsProduct({{1, 64, 1024, 10000}, {1, 4}})->UseRealTime();
+
+static void ThreadPoolAddBatch(benchmark::State& state)
+{
+    int num_tasks = static_cast<int>(state.range(0));
+    ThreadPool pool(static_cast<int>(state.range(1)), CPU_ONLY_DEVICE_ID, false, "bench");
+
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        pool.addBatch(num_tasks, [&done](int, int) { done.fetch_add(1, std::memory_order_release); });
+        pool.waitForWork();
+        benchmark::DoNotOptimize(done.load());
+    }
+    state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK(ThreadPoolAddBatch)->ArgNames({"tasks", "threads"})->ArgsProduct({{1, 64, 1024, 10000}, {1, 4}})->UseRealTime();
+
+// The executor as extensions see it, through its descriptor, tasks being counted down as they finish
+static void ExecutorLaunch(benchmark::State& state, bool batch)
+{
+    int num_tasks = static_cast<int>(state.range(0));
+    DefaultExecutor executor(Logger::get_default(), static_cast<int>(state.range(1)));
+    auto* desc = executor.getExecutorDesc();
+    auto task = [](int, int, void* context) { static_cast<std::atomic<int>*>(context)->fetch_add(1, std::memory_order_release); };
+
+    for (auto _ : state) {
+        std::atomic<int> done{0};
+        if (batch) {
+            desc->launchBatch(desc->instance, NVIMGCODEC_DEVICE_CPU_ONLY, num_tasks, &done, task);
+        } else {
+            for (int i = 0; i < num_tasks; i++)
+                desc->launch(desc->instance, NVIMGCODEC_DEVICE_CPU_ONLY, i, &done, task);
+        }
+        WaitFor(done, num_tasks);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+BENCHMARK_CAPTURE(ExecutorLaunch, single, false)->ArgNames({"tasks", "threads"})->ArgsProduct({{1, 64, 1024, 10000}, {1, 4}})->UseRealTime();
+BENCHMARK_CAPTURE(ExecutorLaunch, batch, true)->ArgNames({"tasks", "threads"})->ArgsProduct({{1, 64, 1024, 10000}, {1, 4}})->UseRealTime();
+
+// Cost of handing results of a batch over to the waiting user thread
+static void ProcessingResults(benchmark::State& state)
+{
+    int num_samples = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        ProcessingResultsPromise promise(num_samples);
+        auto future = promise.getFuture();
+        for (int i = 0; i < num_samples; i++)
+            promise.set(i, ProcessingResult::success());
+        future->waitForAll();
+    }
+    state.SetItemsProcessed(state.iterations() * num_samples);
+}
+
+BENCHMARK(ProcessingResults)->ArgName("samples")->Arg(1)->Arg(64)->Arg(1024);
+
+// Throughput of a memory bound task on one single threaded pool per NUMA node, with the buffers allocated by the
+// calling thread, so they all land on one node, or by each pool, as the NUMA aware executor does
+static void NumaMemoryBandwidth(benchmark::State& state, bool node_local)
+{
+    auto nodes = GetNumaTopology();
+    if (nodes.size() < 2) {
+        state.SkipWithError("Single NUMA node");
+        return;
+    }
+    constexpr size_t kBufferSize = 64 << 20;
+
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    for (auto& node : nodes)
+        pools.push_back(std::make_unique<ThreadPool>(1, CPU_ONLY_DEVICE_ID, false, "bench", node.cpus));
+    std::vector<std::vector<uint8_t>> buffers(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (node_local)
+            pools[i]->addWork([&buffers, i](int) { buffers[i].assign(kBufferSize, 1); }, 0, true);
+        else
+            buffers[i].assign(kBufferSize, 1);
+    }
+    for (auto& pool : pools)
+        pool->waitForWork();
+
+    std::vector<uint64_t> sums(nodes.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < nodes.size(); i++) {
+            pools[i]->addBatch(1, [&buffers, &sums, i](int, int) {
+                sums[i] = std::accumulate(buffers[i].begin(), buffers[i].end(), uint64_t{0});
+            });
+        }
+        for (auto& pool : pools)
+            pool->waitForWork();
+        benchmark::DoNotOptimize(sums.data());
+    }
+    state.SetBytesProcessed(state.iterations() * nodes.size() * kBufferSize);
+}
+
+BENCHMARK_CAPTURE(NumaMemoryBandwidth, interleaved, false)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(NumaMemoryBandwidth, node_local, true)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}} // namespace nvimgcodec::bench
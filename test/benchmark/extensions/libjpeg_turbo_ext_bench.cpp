@@ -0,0 +1,27 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <extensions/libjpeg_turbo/libjpeg_turbo_ext.h>
+#include "../benchmark_utils.h"
+
+namespace nvimgcodec { namespace bench {
+
+BENCHMARK_CAPTURE(Encode, libjpeg_turbo/jpeg, get_libjpeg_turbo_extension_desc, "jpeg")->Apply(CodecArgs);
+BENCHMARK_CAPTURE(Decode, libjpeg_turbo/jpeg, get_libjpeg_turbo_extension_desc, "jpeg")->Apply(CodecArgs);
+
+}} // namespace nvimgcodec::bench
@@ -0,0 +1,28 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <extensions/opencv/opencv_ext.h>
+#include "../benchmark_utils.h"
+
+namespace nvimgcodec { namespace bench {
+
+BENCHMARK_CAPTURE(Decode, opencv/bmp, get_opencv_extension_desc, "bmp", WriteBmp)->Apply(CodecArgs);
+BENCHMARK_CAPTURE(Decode, opencv/pnm, get_opencv_extension_desc, "pnm", WritePnm)->Apply(CodecArgs);
+BENCHMARK_CAPTURE(Decode, opencv/tiff, get_opencv_extension_desc, "tiff", WriteTiff)->Apply(CodecArgs);
+
+}} // namespace nvimgcodec::bench
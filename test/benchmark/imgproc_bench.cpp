@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+#include "imgproc/color_space_conversion_impl.h"
+#include "imgproc/convert.h"
+#include "benchmark_utils.h"
+
+namespace nvimgcodec { namespace bench {
+
+namespace {
+
+constexpr int kImageWidth = 1920;
+constexpr int kImageHeight = 1080;
+
+template <typename T>
+std::vector<T> Samples(size_t n)
+{
+    auto bytes = SyntheticImage(static_cast<uint32_t>(n), 1, 1, 0);
+    std::vector<T> samples(n);
+    for (size_t i = 0; i < n; i++)
+        samples[i] = ConvertNorm<T>(bytes[i]);
+    return samples;
+}
+
+} // namespace
+
+// Sample type conversions used when decoders write to a different output type, per sample of a full HD RGB image
+template <typename From, typename To>
+static void ConvertSamples(benchmark::State& state)
+{
+    size_t n = static_cast<size_t>(kImageWidth) * kImageHeight * 3;
+    auto in = Samples<From>(n);
+    std::vector<To> out(n);
+
+    for (auto _ : state) {
+        if constexpr (needs_clamp<From, To>::value) {
+            for (size_t i = 0; i < n; i++)
+                out[i] = ConvertSatNorm<To>(in[i]);
+        } else {
+            for (size_t i = 0; i < n; i++)
+                out[i] = ConvertNorm<To>(in[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(ConvertSamples, uint8_t, float);
+BENCHMARK_TEMPLATE(ConvertSamples, float, uint8_t);
+BENCHMARK_TEMPLATE(ConvertSamples, uint16_t, uint8_t);
+BENCHMARK_TEMPLATE(ConvertSamples, uint8_t, uint16_t);
+
+enum class ColorConversion
+{
+    RgbToYCbCr,
+    YCbCrToRgb,
+    RgbToGray
+};
+
+// Color space conversions of interleaved pixels, per pixel of a full HD image
+template <typename T, ColorConversion conversion>
+static void ConvertColor(benchmark::State& state)
+{
+    size_t n = static_cast<size_t>(kImageWidth) * kImageHeight;
+    auto in = Samples<T>(n * 3);
+    std::vector<T> out(n * 3);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            vec<3, T> px{in[3 * i], in[3 * i + 1], in[3 * i + 2]};
+            if constexpr (conversion == ColorConversion::RgbToYCbCr) {
+                auto res = jpeg::rgb_to_ycbcr<T>(px);
+                out[3 * i] = res[0], out[3 * i + 1] = res[1], out[3 * i + 2] = res[2];
+            } else if constexpr (conversion == ColorConversion::YCbCrToRgb) {
+                auto res = jpeg::ycbcr_to_rgb<T>(px);
+                out[3 * i] = res[0], out[3 * i + 1] = res[1], out[3 * i + 2] = res[2];
+            } else {
+                out[i] = rgb_to_gray<T>(px);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(ConvertColor, uint8_t, ColorConversion::RgbToYCbCr);
+BENCHMARK_TEMPLATE(ConvertColor, uint8_t, ColorConversion::YCbCrToRgb);
+BENCHMARK_TEMPLATE(ConvertColor, uint8_t, ColorConversion::RgbToGray);
+BENCHMARK_TEMPLATE(ConvertColor, float, ColorConversion::RgbToYCbCr);
+BENCHMARK_TEMPLATE(ConvertColor, float, ColorConversion::YCbCrToRgb);
+
+}} // namespace nvimgcodec::bench
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../src/file_io_stream.h"
+#include "../../src/mem_io_stream.h"
+#include "benchmark_utils.h"
+
+namespace nvimgcodec { namespace bench {
+
+namespace {
+
+enum class StreamKind
+{
+    Std,
+    Mmap,
+    Mem
+};
+
+constexpr size_t kMaxFileSize = 16 << 20;
+constexpr size_t kChunkSize = 64 << 10;
+
+// File of kMaxFileSize bytes in the temporary directory, removed at exit
+class BenchFile
+{
+  public:
+    static BenchFile& get()
+    {
+        static BenchFile file;
+        return file;
+    }
+
+    ~BenchFile() { std::filesystem::remove(path_); }
+
+    const std::string& path() const { return path_; }
+    const std::vector<uint8_t>& data() const { return data_; }
+
+  private:
+    BenchFile()
+        : path_((std::filesystem::temp_directory_path() / ("nvimgcodec_bench_" + std::to_string(std::rand()) + ".bin")).string())
+        , data_(kMaxFileSize)
+    {
+        for (size_t i = 0; i < data_.size(); i++)
+            data_[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+        std::ofstream(path_, std::ios::binary).write(reinterpret_cast<const char*>(data_.data()), data_.size());
+    }
+
+    std::string path_;
+    std::vector<uint8_t> data_;
+};
+
+std::unique_ptr<IoStream> Open(StreamKind kind)
+{
+    auto& file = BenchFile::get();
+    if (kind == StreamKind::Mem)
+        return std::make_unique<MemIoStream<const unsigned char>>(file.data().data(), file.data().size());
+    return FileIoStream::open(file.path(), false, kind == StreamKind::Mmap, false);
+}
+
+} // namespace
+
+// Opening a stream and reading its first bytes in chunks, as decoders which can't map the stream do
+static void IoStreamRead(benchmark::State& state, StreamKind kind)
+{
+    size_t size = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> buffer(kChunkSize);
+    Open(kind);
+
+    for (auto _ : state) {
+        auto stream = Open(kind);
+        for (size_t offset = 0; offset < size;) {
+            size_t n = stream->read(buffer.data(), std::min(kChunkSize, size - offset));
+            if (n == 0) {
+                state.SkipWithError("Unexpected end of stream");
+                break;
+            }
+            offset += n;
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK_CAPTURE(IoStreamRead, std, StreamKind::Std)->ArgName("bytes")->Arg(4 << 10)->Arg(1 << 20)->Arg(kMaxFileSize);
+BENCHMARK_CAPTURE(IoStreamRead, mmap, StreamKind::Mmap)->ArgName("bytes")->Arg(4 << 10)->Arg(1 << 20)->Arg(kMaxFileSize);
+BENCHMARK_CAPTURE(IoStreamRead, mem, StreamKind::Mem)->ArgName("bytes")->Arg(4 << 10)->Arg(1 << 20)->Arg(kMaxFileSize);
+
+// Small seeks and reads on an open stream, as parsers do when probing a header
+static void IoStreamProbe(benchmark::State& state, StreamKind kind)
+{
+    auto stream = Open(kind);
+    uint8_t buffer[64];
+
+    for (auto _ : state) {
+        stream->seek(0, SEEK_SET);
+        stream->read(buffer, 12);
+        stream->seek(2, SEEK_SET);
+        stream->read(buffer, 4);
+        stream->seek(4096, SEEK_SET);
+        stream->read(buffer, sizeof(buffer));
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(IoStreamProbe, std, StreamKind::Std);
+BENCHMARK_CAPTURE(IoStreamProbe, mmap, StreamKind::Mmap);
+BENCHMARK_CAPTURE(IoStreamProbe, mem, StreamKind::Mem);
+
+}} // namespace nvimgcodec::bench
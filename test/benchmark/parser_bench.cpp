@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <nvimgcodec.h>
+#include <memory>
+#include <vector>
+#include "../../src/code_stream.h"
+#include "../../src/codec.h"
+#include "../../src/codec_registry.h"
+#include "../../src/image_parser_factory.h"
+#include "../../src/iostream_factory.h"
+#include "../../src/logger.h"
+#include "../../src/parsers/bmp.h"
+#include "../../src/parsers/jpeg.h"
+#include "../../src/parsers/jpeg2k.h"
+#include "../../src/parsers/nvtensor.h"
+#include "../../src/parsers/png.h"
+#include "../../src/parsers/pnm.h"
+#include "../../src/parsers/tiff.h"
+#include "../../src/parsers/webp.h"
+#include "benchmark_utils.h"
+
+namespace nvimgcodec { namespace bench {
+
+namespace {
+
+enum class Format
+{
+    Bmp,
+    Jpeg,
+    Jpeg2k,
+    Png,
+    Pnm,
+    Tiff,
+    Webp
+};
+
+constexpr uint32_t kWidth = 64;
+constexpr uint32_t kHeight = 48;
+
+// Stream of the format whose header takes about header_size bytes, or whose DIB header has that size for BMP
+std::vector<uint8_t> MakeStream(Format format, uint32_t header_size)
+{
+    static const std::vector<uint8_t> rgb = SyntheticImage(kWidth, kHeight, 3);
+    switch (format) {
+    case Format::Bmp:
+        return MakeBmp(kWidth, kHeight, rgb.data(), header_size);
+    case Format::Jpeg:
+        return MakeJpegHeader(kWidth, kHeight, header_size);
+    case Format::Jpeg2k:
+        return MakeJpeg2kHeader(kWidth, kHeight, header_size);
+    case Format::Png:
+        return MakePngHeader(kWidth, kHeight, header_size);
+    case Format::Pnm:
+        return MakePnm(kWidth, kHeight, rgb.data(), header_size);
+    case Format::Tiff:
+        return MakeTiff(kWidth, kHeight, rgb.data(), header_size);
+    case Format::Webp:
+    default:
+        return MakeWebpHeader(kWidth, kHeight);
+    }
+}
+
+nvimgcodecStatus_t IgnoreLog(void*, const nvimgcodecDebugMessageSeverity_t, const nvimgcodecDebugMessageCategory_t,
+    const nvimgcodecDebugMessageData_t*)
+{
+    return NVIMGCODEC_STATUS_SUCCESS;
+}
+
+// Registry with the builtin parsers, registered in the same order as by the builtin module
+class BuiltinParsers
+{
+  public:
+    BuiltinParsers()
+        : framework_{NVIMGCODEC_STRUCTURE_TYPE_FRAMEWORK_DESC, sizeof(nvimgcodecFrameworkDesc_t), nullptr}
+        , bmp_(&framework_)
+        , jpeg_(&framework_)
+        , jpeg2k_(&framework_)
+        , nvtensor_(&framework_)
+        , png_(&framework_)
+        , pnm_(&framework_)
+        , tiff_(&framework_)
+        , webp_(&framework_)
+        , registry_(Logger::get_default())
+    {
+        framework_.log = &IgnoreLog;
+        add(bmp_.getParserDesc());
+        add(jpeg_.getParserDesc());
+        add(jpeg2k_.getParserDesc());
+        add(nvtensor_.getParserDesc());
+        add(png_.getParserDesc());
+        add(pnm_.getParserDesc());
+        add(tiff_.getParserDesc());
+        add(webp_.getParserDesc());
+    }
+
+    CodecRegistry& registry() { return registry_; }
+
+  private:
+    void add(const nvimgcodecParserDesc_t* desc)
+    {
+        auto codec = std::make_unique<Codec>(Logger::get_default(), desc->codec);
+        codec->registerParserFactory(std::make_unique<ImageParserFactory>(desc), NVIMGCODEC_PRIORITY_NORMAL);
+        registry_.registerCodec(std::move(codec));
+    }
+
+    nvimgcodecFrameworkDesc_t framework_;
+    BMPParserPlugin bmp_;
+    JPEGParserPlugin jpeg_;
+    JPEG2KParserPlugin jpeg2k_;
+    NvTensorParserPlugin nvtensor_;
+    PNGParserPlugin png_;
+    PNMParserPlugin pnm_;
+    TIFFParserPlugin tiff_;
+    WebpParserPlugin webp_;
+    CodecRegistry registry_;
+};
+
+} // namespace
+
+// Creating a code stream and reading its image info through the C API, for headers of growing size
+static void Parser(benchmark::State& state, Format format)
+{
+    auto stream = MakeStream(format, static_cast<uint32_t>(state.range(0)));
+    nvimgcodecInstance_t instance = nullptr;
+    nvimgcodecInstanceCreateInfo_t create_info{NVIMGCODEC_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, sizeof(nvimgcodecInstanceCreateInfo_t), 0};
+    create_info.load_builtin_modules = 1;
+    if (nvimgcodecInstanceCreate(&instance, &create_info) != NVIMGCODEC_STATUS_SUCCESS) {
+        state.SkipWithError("Could not create instance");
+        return;
+    }
+
+    for (auto _ : state) {
+        nvimgcodecCodeStream_t code_stream = nullptr;
+        nvimgcodecImageInfo_t image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        if (nvimgcodecCodeStreamCreateFromHostMem(instance, &code_stream, stream.data(), stream.size()) != NVIMGCODEC_STATUS_SUCCESS ||
+            nvimgcodecCodeStreamGetImageInfo(code_stream, &image_info) != NVIMGCODEC_STATUS_SUCCESS ||
+            image_info.plane_info[0].width != kWidth) {
+            state.SkipWithError("Parsing failed");
+            if (code_stream)
+                nvimgcodecCodeStreamDestroy(code_stream);
+            break;
+        }
+        nvimgcodecCodeStreamDestroy(code_stream);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["stream_bytes"] = static_cast<double>(stream.size());
+    nvimgcodecInstanceDestroy(instance);
+}
+
+BENCHMARK_CAPTURE(Parser, bmp, Format::Bmp)->ArgName("dib_header_size")->Arg(40)->Arg(124);
+BENCHMARK_CAPTURE(Parser, jpeg, Format::Jpeg)->ArgName("header_bytes")->Arg(0)->Arg(4 << 10)->Arg(256 << 10);
+BENCHMARK_CAPTURE(Parser, jpeg2k, Format::Jpeg2k)->ArgName("header_bytes")->Arg(0)->Arg(4 << 10)->Arg(256 << 10);
+BENCHMARK_CAPTURE(Parser, png, Format::Png)->ArgName("header_bytes")->Arg(0)->Arg(4 << 10)->Arg(256 << 10);
+BENCHMARK_CAPTURE(Parser, pnm, Format::Pnm)->ArgName("header_bytes")->Arg(0)->Arg(4 << 10);
+BENCHMARK_CAPTURE(Parser, tiff, Format::Tiff)->ArgName("header_bytes")->Arg(0)->Arg(4 << 10)->Arg(256 << 10);
+BENCHMARK_CAPTURE(Parser, webp, Format::Webp)->ArgName("header_bytes")->Arg(0);
+
+// Probing the registered codecs for the parser of a stream, formats registered later are probed after the earlier ones
+static void CodecRegistryGetParser(benchmark::State& state, Format format)
+{
+    static BuiltinParsers parsers;
+    auto stream = MakeStream(format, format == Format::Bmp ? 40 : 0);
+    CodeStream code_stream(&parsers.registry(), std::make_unique<IoStreamFactory>());
+    code_stream.parseFromMem(stream.data(), stream.size());
+
+    for (auto _ : state) {
+        auto parser = parsers.registry().getParser(code_stream.getCodeStreamDesc());
+        if (!parser) {
+            state.SkipWithError("No parser found");
+            break;
+        }
+        benchmark::DoNotOptimize(parser.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(CodecRegistryGetParser, bmp, Format::Bmp);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, jpeg, Format::Jpeg);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, jpeg2k, Format::Jpeg2k);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, png, Format::Png);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, pnm, Format::Pnm);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, tiff, Format::Tiff);
+BENCHMARK_CAPTURE(CodecRegistryGetParser, webp, Format::Webp);
+
+}} // namespace nvimgcodec::bench
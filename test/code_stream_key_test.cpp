@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "../src/code_stream_key.h"
+#include "mock_code_stream.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+// Input stream over a host buffer, which optionally can't be mapped and returns at most max_read bytes per read
+struct MemoryStream
+{
+    std::vector<uint8_t> data;
+    bool mappable = true;
+    size_t max_read = SIZE_MAX;
+    size_t pos = 0;
+    nvimgcodecIoStreamDesc_t desc{};
+
+    explicit MemoryStream(std::vector<uint8_t> contents)
+        : data(std::move(contents))
+    {
+        desc.struct_type = NVIMGCODEC_STRUCTURE_TYPE_IO_STREAM_DESC;
+        desc.struct_size = sizeof(nvimgcodecIoStreamDesc_t);
+        desc.instance = this;
+        desc.read = [](void* instance, size_t* output_size, void* buf, size_t bytes) {
+            auto* s = static_cast<MemoryStream*>(instance);
+            *output_size = std::min({bytes, s->max_read, s->data.size() - s->pos});
+            memcpy(buf, s->data.data() + s->pos, *output_size);
+            s->pos += *output_size;
+            return NVIMGCODEC_STATUS_SUCCESS;
+        };
+        desc.seek = [](void* instance, ptrdiff_t offset, int whence) {
+            auto* s = static_cast<MemoryStream*>(instance);
+            s->pos = whence == SEEK_SET ? offset : whence == SEEK_CUR ? s->pos + offset : s->data.size() + offset;
+            return NVIMGCODEC_STATUS_SUCCESS;
+        };
+        desc.size = [](void* instance, size_t* size) {
+            *size = static_cast<MemoryStream*>(instance)->data.size();
+            return NVIMGCODEC_STATUS_SUCCESS;
+        };
+        desc.map = [](void* instance, void** addr, size_t offset, size_t size) {
+            auto* s = static_cast<MemoryStream*>(instance);
+            if (!s->mappable)
+                return NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED;
+            *addr = s->data.data() + offset;
+            return NVIMGCODEC_STATUS_SUCCESS;
+        };
+        desc.unmap = [](void* instance, void* addr, size_t size) { return NVIMGCODEC_STATUS_SUCCESS; };
+    }
+};
+
+CodeStreamKey GetKey(MemoryStream& stream)
+{
+    MockCodeStream code_stream;
+    EXPECT_CALL(code_stream, getInputStreamDesc()).WillRepeatedly(Return(&stream.desc));
+    CodeStreamKey key{};
+    EXPECT_TRUE(GetCodeStreamKey(&code_stream, &key));
+    return key;
+}
+
+std::vector<uint8_t> MakeContents(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> contents(size);
+    for (size_t i = 0; i < size; i++)
+        contents[i] = static_cast<uint8_t>(i * 31 + seed);
+    return contents;
+}
+
+} // namespace
+
+TEST(CodeStreamKeyTest, KeyDoesNotDependOnHowStreamIsRead)
+{
+    // Larger than the read block, with a partial last word
+    auto contents = MakeContents(200003, 1);
+    MemoryStream mapped(contents);
+    MemoryStream read(contents);
+    read.mappable = false;
+    MemoryStream short_reads(contents);
+    short_reads.mappable = false;
+    short_reads.max_read = 1001;
+
+    auto key = GetKey(mapped);
+    EXPECT_EQ(contents.size(), key.size);
+    EXPECT_TRUE(key == GetKey(read));
+    EXPECT_TRUE(key == GetKey(short_reads));
+}
+
+TEST(CodeStreamKeyTest, KeyDependsOnContents)
+{
+    auto contents = MakeContents(1000, 1);
+    MemoryStream stream(contents);
+    auto key = GetKey(stream);
+
+    contents[500] ^= 1;
+    MemoryStream changed(contents);
+    EXPECT_FALSE(key == GetKey(changed));
+
+    // Trailing zeros are not ignored
+    contents[500] ^= 1;
+    contents.push_back(0);
+    MemoryStream extended(contents);
+    EXPECT_FALSE(key == GetKey(extended));
+}
+
+TEST(CodeStreamKeyTest, StreamsAreComparedByContents)
+{
+    auto contents = MakeContents(200003, 1);
+    MemoryStream mapped(contents);
+    MemoryStream short_reads(contents);
+    short_reads.mappable = false;
+    short_reads.max_read = 1001;
+    auto changed_contents = contents;
+    changed_contents[150000] ^= 1;
+    MemoryStream changed(changed_contents);
+    changed.mappable = false;
+    MemoryStream shorter(MakeContents(1000, 1));
+
+    NiceMock<MockCodeStream> code_streams[4];
+    MemoryStream* streams[4] = {&mapped, &short_reads, &changed, &shorter};
+    for (int i = 0; i < 4; i++)
+        ON_CALL(code_streams[i], getInputStreamDesc()).WillByDefault(Return(&streams[i]->desc));
+
+    EXPECT_TRUE(CodeStreamsEqual(&code_streams[0], &code_streams[0]));
+    EXPECT_TRUE(CodeStreamsEqual(&code_streams[0], &code_streams[1]));
+    EXPECT_TRUE(CodeStreamsEqual(&code_streams[1], &code_streams[0]));
+    EXPECT_FALSE(CodeStreamsEqual(&code_streams[0], &code_streams[2]));
+    EXPECT_FALSE(CodeStreamsEqual(&code_streams[1], &code_streams[2]));
+    EXPECT_FALSE(CodeStreamsEqual(&code_streams[0], &code_streams[3]));
+}
+
+}} // namespace nvimgcodec::test
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "../src/color_management.h"
+#include "icc_profile_test_utils.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+nvimgcodecImageInfo_t MakeImageInfo(nvimgcodecSampleFormat_t sample_format, nvimgcodecSampleDataType_t sample_type, uint32_t width,
+    uint32_t height, void* buffer)
+{
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), nullptr};
+    bool planar = sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB || sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR;
+    size_t bytes_per_sample = sample_type == NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8 ? 1 : 2;
+    info.sample_format = sample_format;
+    info.num_planes = planar ? 3 : 1;
+    for (uint32_t p = 0; p < info.num_planes; p++) {
+        info.plane_info[p].width = width;
+        info.plane_info[p].height = height;
+        info.plane_info[p].num_channels = planar ? 1 : 3;
+        info.plane_info[p].sample_type = sample_type;
+        info.plane_info[p].row_stride = width * info.plane_info[p].num_channels * bytes_per_sample;
+    }
+    info.buffer = buffer;
+    info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+    return info;
+}
+
+} // namespace
+
+TEST(ColorManagementTest, ParseRgbProfile)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(2.2));
+    auto profile = ParseIccProfile(data.data(), data.size());
+    EXPECT_NEAR(0.4360747, profile.to_xyz[0][0], 1e-4);
+    EXPECT_NEAR(0.7168786, profile.to_xyz[1][1], 1e-4);
+    EXPECT_NEAR(0.7141733, profile.to_xyz[2][2], 1e-4);
+    for (auto& curve : profile.trc) {
+        ASSERT_GE(curve.size(), 2u);
+        EXPECT_NEAR(std::pow(0.5, 2.2), curve[(curve.size() - 1) / 2], 1e-3);
+    }
+}
+
+TEST(ColorManagementTest, ParseInvalidProfile)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(2.2));
+    EXPECT_THROW(ParseIccProfile(data.data(), 100), std::runtime_error);
+    auto bad_signature = data;
+    bad_signature[36] = 'x';
+    EXPECT_THROW(ParseIccProfile(bad_signature.data(), bad_signature.size()), std::runtime_error);
+    auto lut_based = data;
+    memcpy(&lut_based[20], "Lab ", 4);
+    EXPECT_THROW(ParseIccProfile(lut_based.data(), lut_based.size()), std::runtime_error);
+}
+
+TEST(ColorManagementTest, SrgbToSrgbIsIdentity)
+{
+    auto data = MakeRgbProfile(MakeSrgbCurve());
+    ColorTransformCache cache;
+    auto transform = cache.get(data.data(), data.size(), nullptr, 0, 0);
+    ASSERT_NE(nullptr, transform);
+    EXPECT_EQ(ColorTransformCache::kDefaultLutSize, transform->lutSize());
+
+    std::vector<uint8_t> pixels;
+    for (int v = 0; v < 256; v += 5) {
+        pixels.insert(pixels.end(), {static_cast<uint8_t>(v), static_cast<uint8_t>(255 - v), static_cast<uint8_t>(v / 2)});
+    }
+    auto expected = pixels;
+    auto info = MakeImageInfo(NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, pixels.size() / 3, 1, pixels.data());
+    transform->apply(info);
+    for (size_t i = 0; i < pixels.size(); i++)
+        EXPECT_NEAR(expected[i], pixels[i], 1) << "at " << i;
+}
+
+TEST(ColorManagementTest, LinearToSrgb)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(1.0));
+    ColorTransformCache cache;
+    auto transform = cache.get(data.data(), data.size(), nullptr, 0, 17);
+    ASSERT_NE(nullptr, transform);
+
+    // Gray values keep R = G = B, so each channel only goes through the tone curves
+    const std::vector<uint16_t> values = {0, 1000, 16384, 32768, 50000, 65535};
+    std::vector<uint16_t> pixels;
+    for (int p = 0; p < 3; p++)
+        pixels.insert(pixels.end(), values.begin(), values.end());
+    auto expected = pixels;
+    auto info = MakeImageInfo(NVIMGCODEC_SAMPLEFORMAT_P_RGB, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16, pixels.size() / 3, 1, pixels.data());
+    transform->apply(info);
+    for (size_t i = 0; i < pixels.size(); i++)
+        EXPECT_NEAR(65535 * SrgbEncode(expected[i] / 65535.0), pixels[i], 0.01 * 65535) << "at " << i;
+    EXPECT_EQ(0, pixels.front());
+    EXPECT_EQ(65535, pixels.back());
+}
+
+TEST(ColorManagementTest, PlanarAndInterleavedMatch)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(1.8));
+    ColorTransformCache cache;
+    auto transform = cache.get(data.data(), data.size(), nullptr, 0, 0);
+    ASSERT_NE(nullptr, transform);
+
+    constexpr uint32_t width = 7, height = 5;
+    std::vector<uint8_t> interleaved(width * height * 3), planar(width * height * 3);
+    for (uint32_t i = 0; i < width * height; i++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            uint8_t value = static_cast<uint8_t>((i * 37 + c * 91) % 256);
+            interleaved[3 * i + (2 - c)] = value; // BGR
+            planar[c * width * height + i] = value;
+        }
+    }
+    transform->apply(MakeImageInfo(NVIMGCODEC_SAMPLEFORMAT_I_BGR, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, width, height, interleaved.data()));
+    transform->apply(MakeImageInfo(NVIMGCODEC_SAMPLEFORMAT_P_RGB, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, width, height, planar.data()));
+    for (uint32_t i = 0; i < width * height; i++) {
+        for (uint32_t c = 0; c < 3; c++)
+            EXPECT_EQ(planar[c * width * height + i], interleaved[3 * i + (2 - c)]);
+    }
+}
+
+TEST(ColorManagementTest, UnsupportedLayout)
+{
+    std::vector<uint8_t> pixels(16);
+    auto info = MakeImageInfo(NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, 4, 1, pixels.data());
+    EXPECT_TRUE(ColorTransform::isSupported(info));
+    info.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    EXPECT_FALSE(ColorTransform::isSupported(info));
+    info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+    info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_FLOAT32;
+    EXPECT_FALSE(ColorTransform::isSupported(info));
+}
+
+TEST(ColorManagementTest, CacheReusesTransforms)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(2.2));
+    auto other = MakeRgbProfile(MakeGammaCurve(1.0));
+    ColorTransformCache cache(2);
+    auto transform = cache.get(data.data(), data.size(), nullptr, 0, 0);
+    EXPECT_EQ(transform, cache.get(data.data(), data.size(), nullptr, 0, 0));
+    EXPECT_NE(transform, cache.get(data.data(), data.size(), nullptr, 0, 9));
+    EXPECT_NE(transform, cache.get(data.data(), data.size(), other.data(), other.size(), 0));
+    // The first transform was the least recently used one and got evicted
+    EXPECT_NE(transform, cache.get(data.data(), data.size(), nullptr, 0, 0));
+}
+
+TEST(ColorManagementTest, CacheMatchesProfileBytes)
+{
+    auto data = MakeRgbProfile(MakeGammaCurve(2.2));
+    auto copy = data;
+    auto other = MakeRgbProfile(MakeGammaCurve(1.0));
+    ColorTransformCache cache;
+    auto transform = cache.get(data.data(), data.size(), nullptr, 0, 0);
+    EXPECT_EQ(transform, cache.get(copy.data(), copy.size(), nullptr, 0, 0));
+    EXPECT_NE(transform, cache.get(other.data(), other.size(), nullptr, 0, 0));
+    EXPECT_NE(transform, cache.get(data.data(), data.size(), data.data(), data.size(), 0));
+}
+
+TEST(ColorManagementTest, CacheRemembersUnsupportedProfiles)
+{
+    std::vector<uint8_t> data(200, 0);
+    ColorTransformCache cache;
+    EXPECT_THROW(cache.get(data.data(), data.size(), nullptr, 0, 0), std::runtime_error);
+    EXPECT_EQ(nullptr, cache.get(data.data(), data.size(), nullptr, 0, 0));
+}
+
+}} // namespace nvimgcodec::test
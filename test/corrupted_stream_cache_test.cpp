@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include "../src/corrupted_stream_cache.h"
+
+namespace nvimgcodec { namespace test {
+
+TEST(CorruptedStreamCacheTest, InsertAndEvict)
+{
+    CorruptedStreamCache cache(2);
+    EXPECT_TRUE(cache.empty());
+    CorruptedStreamCache::Key a{1, 1, 10}, b{2, 2, 10}, c{3, 3, 10};
+    cache.insert(a);
+    cache.insert(b);
+    cache.insert(a);
+    EXPECT_FALSE(cache.empty());
+    EXPECT_TRUE(cache.contains(a));
+    EXPECT_TRUE(cache.contains(b));
+    EXPECT_FALSE(cache.contains({1, 1, 11}));
+    // Keys whose first hash collides are told apart by the second one
+    EXPECT_FALSE(cache.contains({1, 2, 10}));
+
+    // The oldest key is evicted first
+    cache.insert(c);
+    EXPECT_FALSE(cache.contains(a));
+    EXPECT_TRUE(cache.contains(b));
+    EXPECT_TRUE(cache.contains(c));
+}
+
+TEST(CorruptedStreamCacheTest, GetParams)
+{
+    nvimgcodecCorruptedStreamParams_t corrupted_params{
+        NVIMGCODEC_STRUCTURE_TYPE_CORRUPTED_STREAM_PARAMS, sizeof(nvimgcodecCorruptedStreamParams_t), nullptr, 1, 1, 0};
+    nvimgcodecColorManagementParams_t color_params{
+        NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS, sizeof(nvimgcodecColorManagementParams_t), &corrupted_params};
+    nvimgcodecDecodeParams_t params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), &color_params};
+    EXPECT_EQ(&corrupted_params, GetCorruptedStreamParams(&params));
+    color_params.struct_next = nullptr;
+    EXPECT_EQ(nullptr, GetCorruptedStreamParams(&params));
+    EXPECT_EQ(nullptr, GetCorruptedStreamParams(nullptr));
+}
+
+}} // namespace nvimgcodec::test
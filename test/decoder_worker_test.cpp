@@ -20,7 +20,9 @@
 #include <memory>
 
 #include "../src/decoder_worker.h"
+#include "mock_code_stream.h"
 #include "mock_codec.h"
+#include "mock_image.h"
 #include "mock_image_decoder.h"
 #include "mock_image_decoder_factory.h"
 #include "mock_logger.h"
@@ -29,6 +31,8 @@ namespace nvimgcodec { namespace test {
 
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::Invoke;
+using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::TestWithParam;
 using ::testing::Values;
@@ -170,4 +174,159 @@ test_case_tuple_t test_cases[] = {
 
 INSTANTIATE_TEST_SUITE_P(DECODER_WORKER_GET_DECODER_TEST, DecoderWorkerTest, ::testing::ValuesIn(test_cases));
 
+class DecoderWorkerCanDecodeTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        auto image_dec = std::make_unique<MockImageDecoder>();
+        image_dec_ = image_dec.get();
+        EXPECT_CALL(codec_, getDecodersNum()).WillRepeatedly(Return(1));
+        EXPECT_CALL(codec_, getDecoderFactory(0)).WillRepeatedly(Return(&image_dec_factory_));
+        ON_CALL(image_dec_factory_, getDecoderId()).WillByDefault(Return("decoder_id"));
+        EXPECT_CALL(image_dec_factory_, getBackendKind()).WillRepeatedly(Return(NVIMGCODEC_BACKEND_KIND_CPU_ONLY));
+        EXPECT_CALL(image_dec_factory_, createDecoder(_, _)).WillOnce(Return(ByMove(std::move(image_dec))));
+        EXPECT_CALL(*image_dec_, isCanDecodeMemoizable()).WillRepeatedly(Invoke([this]() { return memoizable_; }));
+        exec_params_.struct_type = NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS;
+        exec_params_.struct_size = sizeof(nvimgcodecExecutionParams_t);
+        exec_params_.struct_next = nullptr;
+        exec_params_.device_id = NVIMGCODEC_DEVICE_CURRENT;
+        exec_params_.num_backends = 0;
+        exec_params_.backends = nullptr;
+        decoder_worker_ = std::make_unique<DecoderWorker>(&logger_, nullptr, &exec_params_, "", &codec_, 0);
+    }
+
+    void clearExpectations()
+    {
+        ::testing::Mock::VerifyAndClearExpectations(image_dec_);
+        EXPECT_CALL(*image_dec_, isCanDecodeMemoizable()).WillRepeatedly(Invoke([this]() { return memoizable_; }));
+    }
+
+    void expectCanDecode(nvimgcodecProcessingStatus_t result, size_t expected_batch_size)
+    {
+        EXPECT_CALL(*image_dec_, canDecode(_, _, _, _, _))
+            .WillOnce(Invoke([=](const std::vector<ICodeStream*>& code_streams, const std::vector<IImage*>&,
+                                 const nvimgcodecDecodeParams_t*, std::vector<bool>* mask,
+                                 std::vector<nvimgcodecProcessingStatus_t>* status) {
+                EXPECT_EQ(expected_batch_size, code_streams.size());
+                mask->assign(code_streams.size(), result == NVIMGCODEC_PROCESSING_STATUS_SUCCESS);
+                status->assign(code_streams.size(), result);
+            }));
+    }
+
+    std::vector<nvimgcodecProcessingStatus_t> canDecode(
+        std::vector<ICodeStream*> code_streams, std::vector<IImage*> images, void* params_next = nullptr)
+    {
+        nvimgcodecDecodeParams_t params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), params_next};
+        std::vector<bool> mask;
+        std::vector<nvimgcodecProcessingStatus_t> status;
+        decoder_worker_->canDecode(code_streams, images, &params, &mask, &status);
+        EXPECT_EQ(code_streams.size(), mask.size());
+        for (size_t i = 0; i < mask.size(); i++)
+            EXPECT_EQ(status[i] == NVIMGCODEC_PROCESSING_STATUS_SUCCESS, mask[i]);
+        return status;
+    }
+
+    NiceMock<MockLogger> logger_;
+    MockCodec codec_;
+    MockImageDecoderFactory image_dec_factory_;
+    MockImageDecoder* image_dec_ = nullptr;
+    bool memoizable_ = true;
+    nvimgcodecExecutionParams_t exec_params_;
+    std::unique_ptr<DecoderWorker> decoder_worker_;
+    NiceMock<MockCodeStream> code_stream_;
+    NiceMock<MockImage> image_;
+};
+
+TEST_F(DecoderWorkerCanDecodeTest, decoder_is_queried_once_for_samples_of_the_same_kind)
+{
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED, 2);
+    auto status = canDecode({&code_stream_, &code_stream_}, {&image_, &image_});
+    EXPECT_EQ(std::vector<nvimgcodecProcessingStatus_t>(2, NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED), status);
+
+    // The status is remembered, so the decoder is not queried again
+    status = canDecode({&code_stream_, &code_stream_, &code_stream_}, {&image_, &image_, &image_});
+    EXPECT_EQ(std::vector<nvimgcodecProcessingStatus_t>(3, NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED), status);
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, decoder_is_queried_only_for_new_kinds_of_samples)
+{
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    canDecode({&code_stream_}, {&image_});
+
+    NiceMock<MockImage> other_image;
+    ON_CALL(other_image, getImageInfo(_)).WillByDefault(Invoke([](nvimgcodecImageInfo_t* info) {
+        info->sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+    }));
+    clearExpectations();
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED, 1);
+    auto status = canDecode({&code_stream_, &code_stream_}, {&image_, &other_image});
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status[0]);
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SAMPLE_FORMAT_UNSUPPORTED, status[1]);
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, failures_are_not_remembered)
+{
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_FAIL, 1);
+    canDecode({&code_stream_}, {&image_});
+
+    clearExpectations();
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    auto status = canDecode({&code_stream_}, {&image_});
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status[0]);
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, stream_specific_statuses_are_not_remembered)
+{
+    for (auto result : {NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED}) {
+        expectCanDecode(result, 1);
+        canDecode({&code_stream_}, {&image_});
+        clearExpectations();
+    }
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    auto status = canDecode({&code_stream_}, {&image_});
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status[0]);
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, decoder_is_queried_for_every_sample_if_its_results_are_not_memoizable)
+{
+    memoizable_ = false;
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_CODEC_UNSUPPORTED, 1);
+    canDecode({&code_stream_}, {&image_});
+
+    clearExpectations();
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    auto status = canDecode({&code_stream_}, {&image_});
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status[0]);
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, signatures_are_not_computed_if_results_are_not_memoizable)
+{
+    memoizable_ = false;
+    EXPECT_CALL(code_stream_, getImageInfo(_)).Times(0);
+    EXPECT_CALL(image_, getImageInfo(_)).Times(0);
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 2);
+    canDecode({&code_stream_, &code_stream_}, {&image_, &image_});
+}
+
+TEST_F(DecoderWorkerCanDecodeTest, same_parameters_in_another_chain_are_the_same_kind_of_samples)
+{
+    nvimgcodecColorManagementParams_t color{NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS, sizeof(nvimgcodecColorManagementParams_t), nullptr, nullptr, 0, 17};
+    nvimgcodecTiffDecodeParams_t tiff{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), &color, 1, 0, 0};
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    canDecode({&code_stream_}, {&image_}, &tiff);
+
+    // Copies of the structures, linked at other addresses
+    auto other_color = color;
+    auto other_tiff = tiff;
+    other_tiff.struct_next = &other_color;
+    canDecode({&code_stream_}, {&image_}, &other_tiff);
+
+    // A different value is another kind of sample
+    clearExpectations();
+    expectCanDecode(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, 1);
+    other_tiff.level = 2;
+    canDecode({&code_stream_}, {&image_}, &other_tiff);
+}
+
 }} // namespace nvimgcodec::test
\ No newline at end of file
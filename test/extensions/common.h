@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <vector>
 
 #include <nvimgcodec.h>
@@ -237,4 +238,115 @@ class ExtensionTestBase
     std::vector<unsigned char> image_buffer_;
     std::vector<unsigned char> code_stream_buffer_;
 };
+
+// Fixture for a host codec extension with its parser extension, encoding (and optionally decoding) on 4 CPU threads.
+// Batches encoded with EncodeBatch are written to outputs_ and released on the next batch or at tear down.
+class CpuCodecExtensionTestBase : public ExtensionTestBase
+{
+  public:
+    using GetExtensionDesc = nvimgcodecStatus_t (*)(nvimgcodecExtensionDesc_t*);
+
+    void SetUpCodec(GetExtensionDesc get_parser_desc, GetExtensionDesc get_codec_desc, bool create_decoder)
+    {
+        ExtensionTestBase::SetUp();
+
+        nvimgcodecExtensionDesc_t parser_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_parser_desc(&parser_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &parser_extension_, &parser_extension_desc));
+
+        nvimgcodecExtensionDesc_t codec_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_codec_desc(&codec_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &codec_extension_, &codec_extension_desc));
+
+        nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+        exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+        exec_params.max_num_cpu_threads = 4;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCreate(instance_, &encoder_, &exec_params, nullptr));
+        if (create_decoder)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr));
+    }
+
+    // sRGB input image of the given size, the buffer is allocated by PrepareImageForFormat
+    void SetUpImageInfo(uint32_t width, uint32_t height, nvimgcodecSampleFormat_t sample_format,
+        nvimgcodecChromaSubsampling_t chroma_subsampling)
+    {
+        image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image_info_.plane_info[0].width = width;
+        image_info_.plane_info[0].height = height;
+        sample_format_ = sample_format;
+        color_spec_ = NVIMGCODEC_COLORSPEC_SRGB;
+        chroma_subsampling_ = chroma_subsampling;
+    }
+
+    void TearDown() override
+    {
+        ReleaseBatch();
+        if (decoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+        if (encoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderDestroy(encoder_));
+        ExtensionTestBase::TearDownCodecResources();
+        if (codec_extension_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(codec_extension_));
+        if (parser_extension_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(parser_extension_));
+        ExtensionTestBase::TearDown();
+    }
+
+    struct OutputBuffer
+    {
+        std::vector<unsigned char> data;
+        static unsigned char* resize(void* ctx, size_t bytes)
+        {
+            auto* buffer = reinterpret_cast<OutputBuffer*>(ctx);
+            buffer->data.resize(bytes);
+            return buffer->data.data();
+        }
+    };
+
+    void ReleaseBatch()
+    {
+        for (auto& stream : out_code_streams_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(stream));
+        for (auto& image : images_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+        out_code_streams_.clear();
+        images_.clear();
+        if (future_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+    }
+
+    // Encodes the input image batch_size times in a single batch
+    void EncodeBatch(const char* codec_name, int batch_size, const nvimgcodecEncodeParams_t* params)
+    {
+        ReleaseBatch();
+        nvimgcodecImageInfo_t cs_image_info(image_info_);
+        strcpy(cs_image_info.codec_name, codec_name);
+        outputs_.resize(batch_size);
+        out_code_streams_.resize(batch_size);
+        images_.resize(batch_size);
+        for (int i = 0; i < batch_size; i++) {
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &images_[i], &image_info_));
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_streams_[i], &outputs_[i],
+                                                     &OutputBuffer::resize, &cs_image_info));
+        }
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecEncoderEncode(encoder_, images_.data(), out_code_streams_.data(), batch_size, params, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        std::vector<nvimgcodecProcessingStatus_t> statuses(batch_size);
+        size_t status_size;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, statuses.data(), &status_size));
+        ASSERT_EQ(static_cast<size_t>(batch_size), status_size);
+        for (int i = 0; i < batch_size; i++)
+            ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, statuses[i]);
+    }
+
+    nvimgcodecExtension_t parser_extension_ = nullptr;
+    nvimgcodecExtension_t codec_extension_ = nullptr;
+    nvimgcodecEncoder_t encoder_ = nullptr;
+    nvimgcodecDecoder_t decoder_ = nullptr;
+    std::vector<OutputBuffer> outputs_;
+    std::vector<nvimgcodecCodeStream_t> out_code_streams_;
+};
 }} // namespace nvimgcodec::test
@@ -21,6 +21,7 @@
 #include <nvimgcodec.h>
 #include <parsers/parser_test_utils.h>
 #include <test_utils.h>
+#include <algorithm>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
@@ -183,6 +184,144 @@ class CommonExtDecoderTest
         }
     }
 
+    void TestBandOutput(const std::string& rel_path, nvimgcodecSampleFormat_t sample_format, uint32_t band_height)
+    {
+        int num_channels = sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y ? 1 : 3;
+
+        // Reference is the same image decoded in one go
+        TestSingleImage(rel_path, sample_format);
+        std::vector<uint8_t> ref = out_buffer_;
+        uint32_t width = image_info_.plane_info[0].width;
+        uint32_t height = image_info_.plane_info[0].height;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image_));
+        image_ = nullptr;
+
+        struct BandCollector
+        {
+            std::vector<uint8_t>* out;
+            uint32_t height;
+            uint32_t band_height;
+            uint32_t next_row;
+            uint32_t num_bands;
+        } collector{&out_buffer_, height, band_height, 0, 0};
+        auto band_ready = [](void* ctx, const nvimgcodecImageInfo_t* band_info, uint32_t first_row,
+                              uint32_t num_rows) -> nvimgcodecStatus_t {
+            auto* c = static_cast<BandCollector*>(ctx);
+            if (first_row != c->next_row || num_rows == 0 || num_rows > c->band_height)
+                return NVIMGCODEC_STATUS_INTERNAL_ERROR;
+            const uint8_t* band = static_cast<const uint8_t*>(band_info->buffer);
+            size_t row_size = band_info->plane_info[0].row_stride;
+            for (uint32_t p = 0; p < band_info->num_planes; p++) {
+                const uint8_t* src = band + p * c->band_height * row_size;
+                uint8_t* dst = c->out->data() + (p * c->height + first_row) * row_size;
+                std::memcpy(dst, src, num_rows * row_size);
+            }
+            c->next_row += num_rows;
+            c->num_bands++;
+            return NVIMGCODEC_STATUS_SUCCESS;
+        };
+
+        nvimgcodecBandOutput_t band_output{NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT, sizeof(nvimgcodecBandOutput_t), nullptr};
+        band_output.band_height = band_height;
+        band_output.band_ready = band_ready;
+        band_output.band_ctx = &collector;
+
+        std::fill(out_buffer_.begin(), out_buffer_.end(), 0);
+        std::vector<uint8_t> band_buffer(band_height * width * num_channels);
+        image_info_.struct_next = &band_output;
+        image_info_.buffer = band_buffer.data();
+        image_info_.buffer_size = band_buffer.size();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image_, &image_info_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &image_, 1, &params_, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        image_info_.struct_next = nullptr;
+
+        nvimgcodecProcessingStatus_t status;
+        size_t status_size;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(height, collector.next_row);
+        ASSERT_EQ((height + band_height - 1) / band_height, collector.num_bands);
+        ASSERT_EQ(ref.size(), static_cast<size_t>(height) * width * num_channels);
+        for (size_t i = 0; i < ref.size(); i++) {
+            ASSERT_EQ(ref[i], out_buffer_[i]) << "@" << i;
+        }
+    }
+
+    void TestStatistics(const std::string& rel_path, nvimgcodecSampleFormat_t sample_format, uint32_t band_height = 0)
+    {
+        int num_channels = sample_format == NVIMGCODEC_SAMPLEFORMAT_P_Y ? 1 : 3;
+        bool planar = sample_format == NVIMGCODEC_SAMPLEFORMAT_P_RGB || sample_format == NVIMGCODEC_SAMPLEFORMAT_P_BGR ||
+                      sample_format == NVIMGCODEC_SAMPLEFORMAT_P_UNCHANGED;
+
+        // Reference is computed from the same image decoded in one go
+        TestSingleImage(rel_path, sample_format);
+        std::vector<uint8_t> ref = out_buffer_;
+        uint32_t width = image_info_.plane_info[0].width;
+        uint32_t height = image_info_.plane_info[0].height;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image_));
+        image_ = nullptr;
+
+        constexpr uint32_t kBins = 16;
+        std::vector<uint64_t> histogram(kBins * num_channels);
+        nvimgcodecImageStatistics_t stats{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_STATISTICS, sizeof(nvimgcodecImageStatistics_t), nullptr};
+        stats.histogram_bins = kBins;
+        stats.histogram = histogram.data();
+        stats.histogram_size = histogram.size();
+
+        // Statistics have to be accumulated before each band is handed over, as the buffer is reused
+        nvimgcodecBandOutput_t band_output{NVIMGCODEC_STRUCTURE_TYPE_BAND_OUTPUT, sizeof(nvimgcodecBandOutput_t), nullptr};
+        band_output.band_height = band_height;
+        band_output.band_ready = [](void*, const nvimgcodecImageInfo_t*, uint32_t, uint32_t) { return NVIMGCODEC_STATUS_SUCCESS; };
+        std::vector<uint8_t> band_buffer(band_height * width * num_channels);
+        if (band_height > 0) {
+            stats.struct_next = &band_output;
+            image_info_.buffer = band_buffer.data();
+            image_info_.buffer_size = band_buffer.size();
+        }
+
+        image_info_.struct_next = &stats;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image_, &image_info_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &image_, 1, &params_, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        image_info_.struct_next = nullptr;
+
+        nvimgcodecProcessingStatus_t status;
+        size_t status_size;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(static_cast<uint32_t>(num_channels), stats.num_channels);
+
+        size_t num_pixels = static_cast<size_t>(width) * height;
+        for (int c = 0; c < num_channels; c++) {
+            auto value = [&](size_t i) { return planar ? ref[c * num_pixels + i] : ref[i * num_channels + c]; };
+            uint8_t ref_min = 255, ref_max = 0;
+            double sum = 0;
+            std::vector<uint64_t> ref_histogram(kBins);
+            for (size_t i = 0; i < num_pixels; i++) {
+                ref_min = std::min(ref_min, value(i));
+                ref_max = std::max(ref_max, value(i));
+                sum += value(i);
+                ref_histogram[value(i) * kBins / 256]++;
+            }
+            double mean = sum / num_pixels;
+            double sum_sq = 0;
+            for (size_t i = 0; i < num_pixels; i++)
+                sum_sq += (value(i) - mean) * (value(i) - mean);
+
+            EXPECT_EQ(ref_min, stats.channels[c].min) << "channel " << c;
+            EXPECT_EQ(ref_max, stats.channels[c].max) << "channel " << c;
+            EXPECT_NEAR(mean, stats.channels[c].mean, 1e-6) << "channel " << c;
+            EXPECT_NEAR(sum_sq / num_pixels, stats.channels[c].variance, 1e-3) << "channel " << c;
+            for (uint32_t b = 0; b < kBins; b++)
+                EXPECT_EQ(ref_histogram[b], histogram[c * kBins + b]) << "channel " << c << " bin " << b;
+        }
+    }
+
     void TestNotSupported(const std::string& rel_path, nvimgcodecSampleFormat_t sample_format, nvimgcodecSampleDataType_t sample_type,
         nvimgcodecProcessingStatus_t expected_status)
     {
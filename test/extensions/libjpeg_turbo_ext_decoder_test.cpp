@@ -22,6 +22,8 @@
 #include <parsers/jpeg.h>
 #include <parsers/parser_test_utils.h>
 #include <test_utils.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -30,6 +32,70 @@
 
 namespace nvimgcodec { namespace test {
 
+namespace {
+
+// Decoder of jpeg registered with a lower priority than libjpeg-turbo, which counts the samples it gets as a fallback
+class FallbackDecoderExtension
+{
+  public:
+    FallbackDecoderExtension()
+        : decoder_desc_{NVIMGCODEC_STRUCTURE_TYPE_DECODER_DESC, sizeof(nvimgcodecDecoderDesc_t), nullptr, this, "test_fallback_decoder", "jpeg",
+              NVIMGCODEC_BACKEND_KIND_CPU_ONLY, static_create, static_destroy, static_can_decode, static_decode}
+        , extension_desc_{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), nullptr, this,
+              "test_fallback_extension", NVIMGCODEC_VER, NVIMGCODEC_EXT_API_VER, static_extension_create, static_extension_destroy}
+    {
+    }
+
+    nvimgcodecExtensionDesc_t* getExtensionDesc() { return &extension_desc_; }
+    int numDecoded() const { return num_decoded_; }
+
+  private:
+    static nvimgcodecStatus_t static_create(
+        void* instance, nvimgcodecDecoder_t* decoder, const nvimgcodecExecutionParams_t* exec_params, const char* options)
+    {
+        *decoder = static_cast<nvimgcodecDecoder_t>(instance);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+    static nvimgcodecStatus_t static_destroy(nvimgcodecDecoder_t decoder) { return NVIMGCODEC_STATUS_SUCCESS; }
+    static nvimgcodecStatus_t static_can_decode(nvimgcodecDecoder_t decoder, nvimgcodecProcessingStatus_t* status,
+        nvimgcodecCodeStreamDesc_t** code_streams, nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+    {
+        std::fill(status, status + batch_size, NVIMGCODEC_PROCESSING_STATUS_SUCCESS);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+    static nvimgcodecStatus_t static_decode(nvimgcodecDecoder_t decoder, nvimgcodecCodeStreamDesc_t** code_streams,
+        nvimgcodecImageDesc_t** images, int batch_size, const nvimgcodecDecodeParams_t* params)
+    {
+        auto handle = reinterpret_cast<FallbackDecoderExtension*>(decoder);
+        for (int i = 0; i < batch_size; i++) {
+            handle->num_decoded_++;
+            images[i]->imageReady(images[i]->instance, NVIMGCODEC_PROCESSING_STATUS_SUCCESS);
+        }
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+    static nvimgcodecStatus_t static_extension_create(void* instance, nvimgcodecExtension_t* extension, const nvimgcodecFrameworkDesc_t* framework)
+    {
+        auto handle = static_cast<FallbackDecoderExtension*>(instance);
+        handle->framework_ = framework;
+        framework->registerDecoder(framework->instance, &handle->decoder_desc_, NVIMGCODEC_PRIORITY_LOW);
+        *extension = reinterpret_cast<nvimgcodecExtension_t>(handle);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+    static nvimgcodecStatus_t static_extension_destroy(nvimgcodecExtension_t extension)
+    {
+        auto handle = reinterpret_cast<FallbackDecoderExtension*>(extension);
+        handle->framework_->unregisterDecoder(handle->framework_->instance, &handle->decoder_desc_);
+        return NVIMGCODEC_STATUS_SUCCESS;
+    }
+
+    nvimgcodecDecoderDesc_t decoder_desc_;
+    nvimgcodecExtensionDesc_t extension_desc_;
+    const nvimgcodecFrameworkDesc_t* framework_ = nullptr;
+    std::atomic<int> num_decoded_{0};
+};
+
+} // namespace
+
 class LibjpegTurboExtDecoderTest : public ::testing::Test, public CommonExtDecoderTest
 {
   public:
@@ -54,6 +120,54 @@ class LibjpegTurboExtDecoderTest : public ::testing::Test, public CommonExtDecod
     {
         CommonExtDecoderTest::TearDown();
     }
+
+    // Registers the fallback decoder and returns the first half of a JPEG, which libjpeg-turbo can't decode
+    std::vector<uint8_t> PrepareTruncatedJpeg()
+    {
+        extensions_.emplace_back();
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &extensions_.back(), fallback_.getExtensionDesc()));
+        auto data = read_file(resources_dir + "/jpeg/padlock-406986_640_420.jpg");
+        data.resize(data.size() / 2);
+        return data;
+    }
+
+    nvimgcodecProcessingStatus_t DecodeWithCorruptedStreamParams(
+        const std::vector<uint8_t>& data, int validate, int stop_fallback, int remember_corrupted)
+    {
+        nvimgcodecCodeStream_t code_stream = nullptr;
+        nvimgcodecImage_t image = nullptr;
+        nvimgcodecFuture_t future = nullptr;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &code_stream, data.data(), data.size()));
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(code_stream, &info));
+        info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        info.num_planes = 1;
+        info.plane_info[0].num_channels = 3;
+        info.plane_info[0].row_stride = info.plane_info[0].width * 3;
+        info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        info.buffer_size = info.plane_info[0].row_stride * info.plane_info[0].height;
+        out_buffer_.assign(info.buffer_size, 0);
+        info.buffer = out_buffer_.data();
+        info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &info));
+
+        nvimgcodecCorruptedStreamParams_t corrupted_params{NVIMGCODEC_STRUCTURE_TYPE_CORRUPTED_STREAM_PARAMS,
+            sizeof(nvimgcodecCorruptedStreamParams_t), nullptr, validate, stop_fallback, remember_corrupted};
+        params_.struct_next = &corrupted_params;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &code_stream, &image, 1, &params_, &future));
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future));
+        params_.struct_next = nullptr;
+        nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_UNKNOWN;
+        size_t status_size;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future, &status, &status_size));
+
+        nvimgcodecFutureDestroy(future);
+        nvimgcodecImageDestroy(image);
+        nvimgcodecCodeStreamDestroy(code_stream);
+        return status;
+    }
+
+    FallbackDecoderExtension fallback_;
 };
 
 TEST_F(LibjpegTurboExtDecoderTest, SingleImage_RGB_410_RGB_I)
@@ -173,4 +287,67 @@ TEST_F(LibjpegTurboExtDecoderTest, SampleTypeUnsupported)
     }
 }
 
+TEST_F(LibjpegTurboExtDecoderTest, BandOutput_RGB_I)
+{
+    TestBandOutput("jpeg/padlock-406986_640_420.jpg", NVIMGCODEC_SAMPLEFORMAT_I_RGB, 37);
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, BandOutput_RGB_P)
+{
+    TestBandOutput("jpeg/padlock-406986_640_420.jpg", NVIMGCODEC_SAMPLEFORMAT_P_RGB, 64);
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, Statistics_RGB_I)
+{
+    TestStatistics("jpeg/padlock-406986_640_420.jpg", NVIMGCODEC_SAMPLEFORMAT_I_RGB);
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, Statistics_BGR_P)
+{
+    TestStatistics("jpeg/padlock-406986_640_420.jpg", NVIMGCODEC_SAMPLEFORMAT_P_BGR);
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, Statistics_BandOutput)
+{
+    TestStatistics("jpeg/padlock-406986_640_420.jpg", NVIMGCODEC_SAMPLEFORMAT_I_RGB, 37);
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, TruncatedStreamGoesToFallback)
+{
+    auto data = PrepareTruncatedJpeg();
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodeWithCorruptedStreamParams(data, 0, 0, 0));
+    EXPECT_EQ(1, fallback_.numDecoded());
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, TruncatedStreamIsCorruptedWithoutFallback)
+{
+    auto data = PrepareTruncatedJpeg();
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, DecodeWithCorruptedStreamParams(data, 0, 1, 0));
+    EXPECT_EQ(0, fallback_.numDecoded());
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, TruncatedStreamFailsValidation)
+{
+    auto data = PrepareTruncatedJpeg();
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, DecodeWithCorruptedStreamParams(data, 1, 0, 0));
+    EXPECT_EQ(0, fallback_.numDecoded());
+}
+
+TEST_F(LibjpegTurboExtDecoderTest, TruncatedStreamIsRememberedAsCorrupted)
+{
+    auto data = PrepareTruncatedJpeg();
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, DecodeWithCorruptedStreamParams(data, 0, 1, 1));
+
+    // Fails before decoding, as a decode would now go to the fallback, and so does a copy of the contents
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, DecodeWithCorruptedStreamParams(data, 0, 0, 1));
+    auto copy = data;
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, DecodeWithCorruptedStreamParams(copy, 0, 0, 1));
+    EXPECT_EQ(0, fallback_.numDecoded());
+
+    // Contents differing in the last byte are decoded
+    copy.back() ^= 1;
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodeWithCorruptedStreamParams(copy, 0, 0, 1));
+    EXPECT_EQ(1, fallback_.numDecoded());
+}
+
 }} // namespace nvimgcodec::test
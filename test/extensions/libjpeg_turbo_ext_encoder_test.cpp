@@ -0,0 +1,363 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/libjpeg_turbo/libjpeg_turbo_ext.h>
+#include <extensions/utils/image_metrics.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/jpeg.h>
+#include <parsers/parser_test_utils.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+// Host allocator keeping track of the live allocations, which can come from several threads
+struct CountingHostAllocator
+{
+    std::mutex mutex;
+    std::map<void*, size_t> live;
+    int num_allocations = 0;
+
+    static int Malloc(void* ctx, void** ptr, size_t size, size_t alignment)
+    {
+        auto* self = static_cast<CountingHostAllocator*>(ctx);
+        *ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (!*ptr)
+            return 1;
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->live[*ptr] = size;
+        self->num_allocations++;
+        return 0;
+    }
+
+    static int Free(void* ctx, void* ptr, size_t size)
+    {
+        auto* self = static_cast<CountingHostAllocator*>(ctx);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        EXPECT_EQ(self->live.at(ptr), size);
+        self->live.erase(ptr);
+        std::free(ptr);
+        return 0;
+    }
+
+    nvimgcodecHostAllocator_t desc()
+    {
+        return {NVIMGCODEC_STRUCTURE_TYPE_HOST_ALLOCATOR, sizeof(nvimgcodecHostAllocator_t), nullptr, Malloc, Free, this};
+    }
+};
+
+} // namespace
+
+class LibjpegTurboExtEncoderTest : public CpuCodecExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        SetUpCodec(get_jpeg_parser_extension_desc, get_libjpeg_turbo_extension_desc, true);
+        SetUpImageInfo(320, 240, NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLING_NONE);
+        PrepareImageForFormat();
+        // Smooth gradients with some texture, so that the size and the error depend on the quality
+        for (uint32_t y = 0; y < image_info_.plane_info[0].height; y++) {
+            for (uint32_t x = 0; x < image_info_.plane_info[0].width; x++) {
+                unsigned char* px = &image_buffer_[y * image_info_.plane_info[0].row_stride + x * 3];
+                px[0] = static_cast<unsigned char>(x * 255 / image_info_.plane_info[0].width);
+                px[1] = static_cast<unsigned char>(y * 255 / image_info_.plane_info[0].height);
+                px[2] = static_cast<unsigned char>(128 + 100 * std::sin(x * 0.1) * std::cos(y * 0.07));
+            }
+        }
+        params_ = {NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        params_.quality = 75;
+    }
+
+    void TearDown() override { CpuCodecExtensionTestBase::TearDown(); }
+
+    void Encode(nvimgcodecChromaSubsampling_t out_subsampling)
+    {
+        nvimgcodecImageInfo_t cs_image_info(image_info_);
+        cs_image_info.chroma_subsampling = out_subsampling;
+        strcpy(cs_image_info.codec_name, "jpeg");
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                                 &LibjpegTurboExtEncoderTest::ResizeBufferStatic<LibjpegTurboExtEncoderTest>,
+                                                 &cs_image_info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, &in_image_, &out_code_stream_, 1, &params_, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+    }
+
+    // Decodes code_stream_buffer_ to an image described by out_info
+    void Decode(nvimgcodecImageInfo_t out_info, std::vector<unsigned char>* decoded, nvimgcodecImageInfo_t* load_info)
+    {
+        LoadImageFromHostMemory(instance_, in_code_stream_, code_stream_buffer_.data(), code_stream_buffer_.size());
+        *load_info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, load_info));
+
+        decoded->resize(out_info.buffer_size);
+        out_info.buffer = decoded->data();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &out_image_, &out_info));
+        nvimgcodecDecodeParams_t decode_params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &out_image_, 1, &decode_params, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+    }
+
+    // Decodes code_stream_buffer_ and compares it with the input image
+    void DecodeAndCompare(nvimgcodecImageInfo_t* load_info, double* psnr)
+    {
+        std::vector<unsigned char> decode_buffer;
+        Decode(image_info_, &decode_buffer, load_info);
+        *psnr = ComputePsnr(image_buffer_.data(), image_info_.plane_info[0].row_stride, decode_buffer.data(),
+            image_info_.plane_info[0].row_stride, image_info_.plane_info[0].width, image_info_.plane_info[0].height, 3);
+    }
+
+    // Transcodes input to a JPEG of the given subsampling and quality, allowing the input to pass through unchanged
+    void TranscodeWithPassthrough(
+        const std::vector<unsigned char>& input, nvimgcodecChromaSubsampling_t out_subsampling, float quality, OutputBuffer* output)
+    {
+        LoadImageFromHostMemory(instance_, in_code_stream_, input.data(), input.size());
+        nvimgcodecImageInfo_t cs_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &cs_image_info));
+        cs_image_info.chroma_subsampling = out_subsampling;
+        nvimgcodecCodeStream_t out_code_stream = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream, (void*)output, &OutputBuffer::resize, &cs_image_info));
+
+        nvimgcodecDecodeParams_t decode_params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+        nvimgcodecEncodeParams_t encode_params{NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        encode_params.quality = quality;
+        nvimgcodecTranscodeParams_t transcode_params{NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS, sizeof(nvimgcodecTranscodeParams_t), 0};
+        transcode_params.enable_passthrough = 1;
+        nvimgcodecFuture_t future = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecTranscode(decoder_, encoder_, &in_code_stream_, &out_code_stream, 1, &decode_params,
+                                                 &encode_params, &transcode_params, &future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future, &status, &status_size));
+        EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(out_code_stream));
+    }
+
+    nvimgcodecEncodeParams_t params_;
+};
+
+TEST_F(LibjpegTurboExtEncoderTest, EncodeRGB)
+{
+    Encode(NVIMGCODEC_SAMPLING_420);
+    nvimgcodecImageInfo_t load_info;
+    double psnr = 0;
+    DecodeAndCompare(&load_info, &psnr);
+    EXPECT_EQ(image_info_.plane_info[0].width, load_info.plane_info[0].width);
+    EXPECT_EQ(image_info_.plane_info[0].height, load_info.plane_info[0].height);
+    EXPECT_EQ(NVIMGCODEC_SAMPLING_420, load_info.chroma_subsampling);
+    EXPECT_GT(psnr, 30.0);
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, RateControlTargetSize)
+{
+    Encode(NVIMGCODEC_SAMPLING_444);
+    const size_t reference_size = code_stream_buffer_.size();
+    ExtensionTestBase::TearDownCodecResources();
+    in_image_ = nullptr;
+    out_code_stream_ = nullptr;
+    future_ = nullptr;
+
+    nvimgcodecRateControlParams_t rate_control{NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS, sizeof(nvimgcodecRateControlParams_t), 0};
+    rate_control.target_size = reference_size / 2;
+    rate_control.num_candidates = 3;
+    params_.struct_next = &rate_control;
+    Encode(NVIMGCODEC_SAMPLING_444);
+    EXPECT_LE(code_stream_buffer_.size(), rate_control.target_size);
+    EXPECT_GT(code_stream_buffer_.size(), 0u);
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, RateControlTargetPsnr)
+{
+    nvimgcodecRateControlParams_t rate_control{NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS, sizeof(nvimgcodecRateControlParams_t), 0};
+    rate_control.target_psnr = 38;
+    params_.struct_next = &rate_control;
+    Encode(NVIMGCODEC_SAMPLING_420);
+    nvimgcodecImageInfo_t load_info;
+    double psnr = 0;
+    DecodeAndCompare(&load_info, &psnr);
+    EXPECT_GE(psnr, rate_control.target_psnr);
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, HostAllocatorServesIntermediateImages)
+{
+    CountingHostAllocator counting;
+    auto host_allocator = counting.desc();
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderDestroy(encoder_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+    nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+    exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+    exec_params.max_num_cpu_threads = 4;
+    exec_params.host_allocator = &host_allocator;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCreate(instance_, &encoder_, &exec_params, nullptr));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr));
+
+    // Candidates of the rate control are decoded to measure their PSNR
+    nvimgcodecRateControlParams_t rate_control{NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS, sizeof(nvimgcodecRateControlParams_t), 0};
+    rate_control.target_psnr = 38;
+    params_.struct_next = &rate_control;
+    Encode(NVIMGCODEC_SAMPLING_420);
+    const int encode_allocations = counting.num_allocations;
+    EXPECT_GT(encode_allocations, 0);
+    EXPECT_TRUE(counting.live.empty());
+
+    nvimgcodecImageInfo_t load_info;
+    double psnr = 0;
+    DecodeAndCompare(&load_info, &psnr);
+    EXPECT_GE(psnr, rate_control.target_psnr);
+    EXPECT_GT(counting.num_allocations, encode_allocations);
+
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderDestroy(encoder_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+    encoder_ = nullptr;
+    decoder_ = nullptr;
+    EXPECT_TRUE(counting.live.empty());
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, EncodeRawYUV420)
+{
+    // Odd sizes, so that the planes have to be padded to whole blocks
+    const uint32_t width = 321, height = 241;
+    const uint32_t chroma_width = (width + 1) / 2, chroma_height = (height + 1) / 2;
+    image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    image_info_.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_YUV;
+    image_info_.color_spec = NVIMGCODEC_COLORSPEC_SYCC;
+    image_info_.chroma_subsampling = NVIMGCODEC_SAMPLING_420;
+    image_info_.num_planes = 3;
+    for (int p = 0; p < 3; p++) {
+        image_info_.plane_info[p].width = p == 0 ? width : chroma_width;
+        image_info_.plane_info[p].height = p == 0 ? height : chroma_height;
+        image_info_.plane_info[p].row_stride = image_info_.plane_info[p].width;
+        image_info_.plane_info[p].num_channels = 1;
+        image_info_.plane_info[p].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        image_info_.plane_info[p].precision = 8;
+    }
+    image_info_.buffer_size = width * height + 2 * chroma_width * chroma_height;
+    image_buffer_.resize(image_info_.buffer_size);
+    image_info_.buffer = image_buffer_.data();
+    image_info_.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+    unsigned char* cb = &image_buffer_[width * height];
+    unsigned char* cr = cb + chroma_width * chroma_height;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++)
+            image_buffer_[y * width + x] = static_cast<unsigned char>(128 + 100 * std::sin(x * 0.1) * std::cos(y * 0.07));
+    }
+    for (uint32_t y = 0; y < chroma_height; y++) {
+        for (uint32_t x = 0; x < chroma_width; x++) {
+            cb[y * chroma_width + x] = static_cast<unsigned char>(x * 255 / chroma_width);
+            cr[y * chroma_width + x] = static_cast<unsigned char>(y * 255 / chroma_height);
+        }
+    }
+
+    params_.quality = 95;
+    Encode(NVIMGCODEC_SAMPLING_420);
+
+    // The luma plane is compressed as it is, so decoding to grayscale gives it back
+    nvimgcodecImageInfo_t out_info(image_info_);
+    out_info.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    out_info.color_spec = NVIMGCODEC_COLORSPEC_GRAY;
+    out_info.chroma_subsampling = NVIMGCODEC_SAMPLING_GRAY;
+    out_info.num_planes = 1;
+    out_info.buffer_size = width * height;
+    std::vector<unsigned char> decoded;
+    nvimgcodecImageInfo_t load_info;
+    Decode(out_info, &decoded, &load_info);
+    EXPECT_EQ(width, load_info.plane_info[0].width);
+    EXPECT_EQ(height, load_info.plane_info[0].height);
+    EXPECT_EQ(NVIMGCODEC_SAMPLING_420, load_info.chroma_subsampling);
+    EXPECT_GT(ComputePsnr(image_buffer_.data(), width, decoded.data(), width, width, height, 1), 45.0);
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, RawYUVWithOtherSubsamplingIsUnsupported)
+{
+    sample_format_ = NVIMGCODEC_SAMPLEFORMAT_P_YUV;
+    color_spec_ = NVIMGCODEC_COLORSPEC_SYCC;
+    chroma_subsampling_ = NVIMGCODEC_SAMPLING_444;
+    PrepareImageForFormat();
+
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    cs_image_info.chroma_subsampling = NVIMGCODEC_SAMPLING_420;
+    strcpy(cs_image_info.codec_name, "jpeg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                             &LibjpegTurboExtEncoderTest::ResizeBufferStatic<LibjpegTurboExtEncoderTest>,
+                                             &cs_image_info));
+    nvimgcodecProcessingStatus_t status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCanEncode(encoder_, &in_image_, &out_code_stream_, 1, &params_, &status, true));
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SAMPLING_UNSUPPORTED, status);
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, TranscodePassesThroughSourceOfLowerQuality)
+{
+    Encode(NVIMGCODEC_SAMPLING_420);
+    const std::vector<unsigned char> source = code_stream_buffer_;
+
+    // Re-encoding at the same or a higher quality only adds loss, so the source is copied as it is
+    for (float quality : {75.0f, 90.0f}) {
+        OutputBuffer output;
+        TranscodeWithPassthrough(source, NVIMGCODEC_SAMPLING_420, quality, &output);
+        EXPECT_EQ(source, output.data) << "quality " << quality;
+    }
+}
+
+TEST_F(LibjpegTurboExtEncoderTest, TranscodeReencodesSourceOfHigherQualityOrOtherSubsampling)
+{
+    params_.quality = 95;
+    Encode(NVIMGCODEC_SAMPLING_420);
+    const std::vector<unsigned char> source = code_stream_buffer_;
+
+    OutputBuffer lower_quality;
+    TranscodeWithPassthrough(source, NVIMGCODEC_SAMPLING_420, 50, &lower_quality);
+    EXPECT_FALSE(lower_quality.data.empty());
+    EXPECT_LT(lower_quality.data.size(), source.size());
+
+    OutputBuffer other_subsampling;
+    TranscodeWithPassthrough(source, NVIMGCODEC_SAMPLING_444, 95, &other_subsampling);
+    EXPECT_FALSE(other_subsampling.data.empty());
+    EXPECT_NE(source, other_subsampling.data);
+    code_stream_buffer_ = other_subsampling.data;
+    nvimgcodecImageInfo_t load_info;
+    double psnr = 0;
+    DecodeAndCompare(&load_info, &psnr);
+    EXPECT_EQ(NVIMGCODEC_SAMPLING_444, load_info.chroma_subsampling);
+    EXPECT_GT(psnr, 30.0);
+}
+
+}} // namespace nvimgcodec::test
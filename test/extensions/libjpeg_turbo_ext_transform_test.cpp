@@ -0,0 +1,382 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/libjpeg_turbo/libjpeg_turbo_ext.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/jpeg.h>
+#include <parsers/parser_test_utils.h>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+bool IsTransposed(nvimgcodecTransformOp_t op)
+{
+    return op == NVIMGCODEC_TRANSFORM_OP_TRANSPOSE || op == NVIMGCODEC_TRANSFORM_OP_TRANSVERSE || op == NVIMGCODEC_TRANSFORM_OP_ROT_90 ||
+           op == NVIMGCODEC_TRANSFORM_OP_ROT_270;
+}
+
+// Position in a width x height source of the pixel which op moves to (x, y) of the output
+std::pair<uint32_t, uint32_t> SourcePixel(nvimgcodecTransformOp_t op, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    switch (op) {
+    case NVIMGCODEC_TRANSFORM_OP_FLIP_X:
+        return {width - 1 - x, y};
+    case NVIMGCODEC_TRANSFORM_OP_FLIP_Y:
+        return {x, height - 1 - y};
+    case NVIMGCODEC_TRANSFORM_OP_TRANSPOSE:
+        return {y, x};
+    case NVIMGCODEC_TRANSFORM_OP_TRANSVERSE:
+        return {width - 1 - y, height - 1 - x};
+    case NVIMGCODEC_TRANSFORM_OP_ROT_90:
+        return {y, height - 1 - x};
+    case NVIMGCODEC_TRANSFORM_OP_ROT_180:
+        return {width - 1 - x, height - 1 - y};
+    case NVIMGCODEC_TRANSFORM_OP_ROT_270:
+        return {width - 1 - y, x};
+    default:
+        return {x, y};
+    }
+}
+
+struct RgbImage
+{
+    std::vector<unsigned char> data;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    const unsigned char* pixel(uint32_t x, uint32_t y) const { return &data[(static_cast<size_t>(y) * width + x) * 3]; }
+};
+
+} // namespace
+
+class LibjpegTurboExtTransformTest : public ExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        ExtensionTestBase::SetUp();
+
+        nvimgcodecExtensionDesc_t jpeg_parser_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_jpeg_parser_extension_desc(&jpeg_parser_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &jpeg_parser_extension_, &jpeg_parser_extension_desc));
+
+        nvimgcodecExtensionDesc_t libjpeg_turbo_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_libjpeg_turbo_extension_desc(&libjpeg_turbo_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &libjpeg_turbo_extension_, &libjpeg_turbo_extension_desc));
+
+        nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+        exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+        exec_params.max_num_cpu_threads = 4;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecTransformerCreate(instance_, &transformer_, &exec_params, nullptr));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr));
+
+        image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        params_ = {NVIMGCODEC_STRUCTURE_TYPE_TRANSFORM_PARAMS, sizeof(nvimgcodecTransformParams_t), 0};
+        params_.region = {NVIMGCODEC_STRUCTURE_TYPE_REGION, sizeof(nvimgcodecRegion_t), nullptr, 0};
+    }
+
+    void TearDown() override
+    {
+        if (transformer_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecTransformerDestroy(transformer_));
+        if (decoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+        ExtensionTestBase::TearDownCodecResources();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(libjpeg_turbo_extension_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(jpeg_parser_extension_));
+        ExtensionTestBase::TearDown();
+    }
+
+    // Transforms in_code_stream_ into code_stream_buffer_ and parses the result into out_info
+    void Transform(nvimgcodecImageInfo_t* out_info)
+    {
+        if (out_code_stream_) {
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(out_code_stream_));
+            out_code_stream_ = nullptr;
+        }
+        if (future_) {
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+            future_ = nullptr;
+        }
+        nvimgcodecImageInfo_t cs_image_info(image_info_);
+        strcpy(cs_image_info.codec_name, "jpeg");
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                                 &LibjpegTurboExtTransformTest::ResizeBufferStatic<LibjpegTurboExtTransformTest>,
+                                                 &cs_image_info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecTransformerTransform(transformer_, &in_code_stream_, &out_code_stream_, 1, &params_, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+
+        nvimgcodecCodeStream_t result = nullptr;
+        LoadImageFromHostMemory(instance_, result, code_stream_buffer_.data(), code_stream_buffer_.size());
+        *out_info = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(result, out_info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(result));
+    }
+
+    // Decodes a code stream to interleaved RGB, as it is stored, without applying its EXIF orientation
+    void Decode(nvimgcodecCodeStream_t code_stream, RgbImage* rgb)
+    {
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(code_stream, &info));
+        rgb->width = info.plane_info[0].width;
+        rgb->height = info.plane_info[0].height;
+        info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        info.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        info.chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+        info.num_planes = 1;
+        info.plane_info[0].num_channels = 3;
+        info.plane_info[0].row_stride = rgb->width * 3;
+        info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        info.buffer_size = info.plane_info[0].row_stride * rgb->height;
+        rgb->data.resize(info.buffer_size);
+        info.buffer = rgb->data.data();
+        info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+
+        nvimgcodecImage_t image = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &info));
+        nvimgcodecDecodeParams_t decode_params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+        nvimgcodecFuture_t future = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &code_stream, &image, 1, &decode_params, &future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future, &status, &status_size));
+        EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+    }
+
+    // Decodes the output of the last transform, in code_stream_buffer_
+    void DecodeOutput(RgbImage* output)
+    {
+        nvimgcodecCodeStream_t result = nullptr;
+        LoadImageFromHostMemory(instance_, result, code_stream_buffer_.data(), code_stream_buffer_.size());
+        Decode(result, output);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(result));
+    }
+
+    // Decodes the output in code_stream_buffer_ and compares it with the decoded source moved by op in memory. Edges
+    // dropped by the transform are at the right and bottom of the source, so the source window starts at the top-left corner.
+    void ExpectTransformedPixels(const RgbImage& source, nvimgcodecTransformOp_t op)
+    {
+        RgbImage output;
+        DecodeOutput(&output);
+        uint32_t window_width = IsTransposed(op) ? output.height : output.width;
+        uint32_t window_height = IsTransposed(op) ? output.width : output.height;
+        ASSERT_LE(window_width, source.width);
+        ASSERT_LE(window_height, source.height);
+        ExpectSimilar(source, output, [&](uint32_t x, uint32_t y) { return SourcePixel(op, x, y, window_width, window_height); }, 0);
+    }
+
+    // Compares output with the reference pixels given by source_pixel, leaving out a border of the output
+    template <typename SourcePixelFn>
+    void ExpectSimilar(const RgbImage& reference, const RgbImage& output, SourcePixelFn source_pixel, uint32_t border)
+    {
+        // Coefficients are moved exactly, only the rounding of the inverse DCT and of the chroma upsampling can differ,
+        // by a few levels at most, while any misplaced block gives a far larger error
+        double squared_error = 0;
+        size_t count = 0;
+        for (uint32_t y = border; y + border < output.height; y++) {
+            for (uint32_t x = border; x + border < output.width; x++) {
+                auto [src_x, src_y] = source_pixel(x, y);
+                for (int c = 0; c < 3; c++) {
+                    int diff = output.pixel(x, y)[c] - reference.pixel(src_x, src_y)[c];
+                    squared_error += diff * diff;
+                    count++;
+                }
+            }
+        }
+        ASSERT_GT(count, 0u);
+        EXPECT_LT(squared_error / count, 2.0);
+    }
+
+    nvimgcodecExtension_t jpeg_parser_extension_;
+    nvimgcodecExtension_t libjpeg_turbo_extension_;
+    nvimgcodecTransformer_t transformer_ = nullptr;
+    nvimgcodecDecoder_t decoder_ = nullptr;
+    nvimgcodecTransformParams_t params_;
+};
+
+TEST_F(LibjpegTurboExtTransformTest, Rotate90SwapsDimensions)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_444.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+    const uint32_t width = image_info_.plane_info[0].width;
+    const uint32_t height = image_info_.plane_info[0].height;
+
+    params_.op = NVIMGCODEC_TRANSFORM_OP_ROT_90;
+    nvimgcodecImageInfo_t out_info;
+    Transform(&out_info);
+    // A partial iMCU row at the bottom edge can't be moved and is dropped
+    EXPECT_EQ(height / 8 * 8, out_info.plane_info[0].width);
+    EXPECT_EQ(width, out_info.plane_info[0].height);
+    EXPECT_EQ(image_info_.num_planes, out_info.num_planes);
+    EXPECT_EQ(image_info_.chroma_subsampling, out_info.chroma_subsampling);
+}
+
+TEST_F(LibjpegTurboExtTransformTest, TransposeSwapsChromaSubsampling)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_422.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+    ASSERT_EQ(NVIMGCODEC_SAMPLING_422, image_info_.chroma_subsampling);
+
+    params_.op = NVIMGCODEC_TRANSFORM_OP_TRANSPOSE;
+    nvimgcodecImageInfo_t out_info;
+    Transform(&out_info);
+    EXPECT_EQ(NVIMGCODEC_SAMPLING_440, out_info.chroma_subsampling);
+    EXPECT_EQ(image_info_.plane_info[0].height, out_info.plane_info[0].width);
+    EXPECT_EQ(image_info_.plane_info[0].width, out_info.plane_info[0].height);
+}
+
+TEST_F(LibjpegTurboExtTransformTest, CropAlignedWindow)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_420.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+
+    params_.op = NVIMGCODEC_TRANSFORM_OP_NONE;
+    params_.region.ndim = 2;
+    params_.region.start[0] = 32;
+    params_.region.start[1] = 64;
+    params_.region.end[0] = 32 + 100;
+    params_.region.end[1] = 64 + 200;
+    nvimgcodecImageInfo_t out_info;
+    Transform(&out_info);
+    EXPECT_EQ(200u, out_info.plane_info[0].width);
+    EXPECT_EQ(100u, out_info.plane_info[0].height);
+}
+
+TEST_F(LibjpegTurboExtTransformTest, UnalignedCropIsExtendedToIMCU)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_420.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+
+    params_.op = NVIMGCODEC_TRANSFORM_OP_NONE;
+    params_.region.ndim = 2;
+    params_.region.start[0] = 20;
+    params_.region.start[1] = 40;
+    params_.region.end[0] = 20 + 100;
+    params_.region.end[1] = 40 + 200;
+    nvimgcodecImageInfo_t out_info;
+    Transform(&out_info);
+    // 4:2:0 iMCU is 16x16, so the top-left corner moves to (32, 16)
+    EXPECT_EQ(200u + 8, out_info.plane_info[0].width);
+    EXPECT_EQ(100u + 4, out_info.plane_info[0].height);
+}
+
+TEST_F(LibjpegTurboExtTransformTest, OperationsMovePixels)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_444.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+    RgbImage source;
+    Decode(in_code_stream_, &source);
+
+    for (auto op : {NVIMGCODEC_TRANSFORM_OP_FLIP_X, NVIMGCODEC_TRANSFORM_OP_FLIP_Y, NVIMGCODEC_TRANSFORM_OP_TRANSPOSE,
+             NVIMGCODEC_TRANSFORM_OP_TRANSVERSE, NVIMGCODEC_TRANSFORM_OP_ROT_90, NVIMGCODEC_TRANSFORM_OP_ROT_180,
+             NVIMGCODEC_TRANSFORM_OP_ROT_270}) {
+        SCOPED_TRACE(op);
+        params_.op = op;
+        nvimgcodecImageInfo_t out_info;
+        Transform(&out_info);
+        ExpectTransformedPixels(source, op);
+    }
+}
+
+TEST_F(LibjpegTurboExtTransformTest, CropAndRotateMovePixelsOfTheWindow)
+{
+    LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/padlock-406986_640_420.jpg");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+    RgbImage decoded;
+    Decode(in_code_stream_, &decoded);
+
+    // Window aligned to the 4:2:0 iMCU, the part of the last iMCU row moved by the rotation is dropped
+    const uint32_t x0 = 64, y0 = 32, width = 200, height = 100;
+    params_.op = NVIMGCODEC_TRANSFORM_OP_ROT_90;
+    params_.region.ndim = 2;
+    params_.region.start[0] = y0;
+    params_.region.start[1] = x0;
+    params_.region.end[0] = y0 + height;
+    params_.region.end[1] = x0 + width;
+    nvimgcodecImageInfo_t out_info;
+    Transform(&out_info);
+    EXPECT_EQ(height / 16 * 16, out_info.plane_info[0].width);
+    EXPECT_EQ(width, out_info.plane_info[0].height);
+
+    // Chroma is upsampled from other neighbours at the edges of the window, so only its inside is compared
+    RgbImage window;
+    window.width = width;
+    window.height = height;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            auto* px = decoded.pixel(x0 + x, y0 + y);
+            window.data.insert(window.data.end(), px, px + 3);
+        }
+    }
+    RgbImage output;
+    DecodeOutput(&output);
+    ExpectSimilar(
+        window, output, [&](uint32_t x, uint32_t y) { return SourcePixel(NVIMGCODEC_TRANSFORM_OP_ROT_90, x, y, width, output.width); }, 2);
+}
+
+TEST_F(LibjpegTurboExtTransformTest, ApplyExifOrientation)
+{
+    // Operation which brings each EXIF orientation to normal
+    const std::vector<std::pair<std::string, nvimgcodecTransformOp_t>> images = {
+        {"mirror_horizontal", NVIMGCODEC_TRANSFORM_OP_FLIP_X},
+        {"rotate_180", NVIMGCODEC_TRANSFORM_OP_ROT_180},
+        {"mirror_vertical", NVIMGCODEC_TRANSFORM_OP_FLIP_Y},
+        {"mirror_horizontal_rotate_270", NVIMGCODEC_TRANSFORM_OP_TRANSPOSE},
+        {"rotate_90", NVIMGCODEC_TRANSFORM_OP_ROT_90},
+        {"mirror_horizontal_rotate_90", NVIMGCODEC_TRANSFORM_OP_TRANSVERSE},
+        {"rotate_270", NVIMGCODEC_TRANSFORM_OP_ROT_270}};
+    for (auto& [name, op] : images) {
+        SCOPED_TRACE(name);
+        if (in_code_stream_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(in_code_stream_));
+        in_code_stream_ = nullptr;
+        LoadImageFromFilename(instance_, in_code_stream_, resources_dir + "/jpeg/exif/padlock-406986_640_" + name + ".jpg");
+        image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+        RgbImage source;
+        Decode(in_code_stream_, &source);
+
+        // The operation given in the parameters is ignored
+        params_.op = NVIMGCODEC_TRANSFORM_OP_FLIP_Y;
+        params_.apply_exif_orientation = 1;
+        nvimgcodecImageInfo_t out_info;
+        Transform(&out_info);
+        EXPECT_EQ(0, out_info.orientation.rotated);
+        EXPECT_FALSE(out_info.orientation.flip_x);
+        EXPECT_FALSE(out_info.orientation.flip_y);
+        ExpectTransformedPixels(source, op);
+    }
+}
+
+}} // namespace nvimgcodec::test
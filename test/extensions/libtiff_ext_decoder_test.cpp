@@ -17,11 +17,13 @@
 
 #include <extensions/libtiff/libtiff_ext.h>
 #include "common_ext_decoder_test.h"
+#include "../icc_profile_test_utils.h"
 #include <gtest/gtest.h>
 #include <nvimgcodec.h>
 #include <parsers/tiff.h>
 #include <parsers/parser_test_utils.h>
 #include <test_utils.h>
+#include <array>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -31,6 +33,104 @@
 
 namespace nvimgcodec { namespace test {
 
+namespace {
+
+uint8_t PyramidPixel(int level, uint32_t x, uint32_t y, uint32_t width)
+{
+    return static_cast<uint8_t>(level * 100 + y * width + x);
+}
+
+/**
+ * @brief Builds a little-endian, uncompressed 8-bit grayscale TIFF where each page after the first one is a reduced-resolution
+ * image of half the size of the previous one.
+ */
+std::vector<uint8_t> MakeGrayPyramidTiff(uint32_t width, uint32_t height, int num_levels)
+{
+    auto put16 = [](std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(value & 0xFF);
+        out.push_back(value >> 8);
+    };
+    auto put32 = [](std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            out.push_back((value >> (8 * i)) & 0xFF);
+    };
+    constexpr uint32_t kNumEntries = 10;
+    constexpr uint32_t kIfdSize = 2 + kNumEntries * 12 + 4;
+
+    std::vector<uint8_t> out = {'I', 'I', 42, 0};
+    put32(out, 8);
+    for (int l = 0; l < num_levels; l++, width /= 2, height /= 2) {
+        uint32_t strip_offset = out.size() + kIfdSize;
+        uint32_t next_ifd = l + 1 < num_levels ? strip_offset + width * height : 0;
+        std::array<std::array<uint32_t, 3>, kNumEntries> entries = {{{254, 4, l > 0 ? 1u : 0u}, {256, 4, width}, {257, 4, height},
+            {258, 3, 8}, {259, 3, 1}, {262, 3, 1}, {273, 4, strip_offset}, {277, 3, 1}, {278, 4, height}, {279, 4, width * height}}};
+        put16(out, kNumEntries);
+        for (auto& e : entries) {
+            put16(out, e[0]);
+            put16(out, e[1]);
+            put32(out, 1);
+            if (e[1] == 3) {
+                put16(out, e[2]);
+                put16(out, 0);
+            } else {
+                put32(out, e[2]);
+            }
+        }
+        put32(out, next_ifd);
+        for (uint32_t y = 0; y < height; y++)
+            for (uint32_t x = 0; x < width; x++)
+                out.push_back(PyramidPixel(l, x, y, width));
+    }
+    return out;
+}
+
+/**
+ * @brief Builds a little-endian, uncompressed 8-bit RGB TIFF with an embedded ICC profile.
+ */
+std::vector<uint8_t> MakeRgbTiffWithProfile(uint32_t width, uint32_t height, const std::vector<uint8_t>& pixels,
+    const std::vector<uint8_t>& profile)
+{
+    auto put16 = [](std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(value & 0xFF);
+        out.push_back(value >> 8);
+    };
+    auto put32 = [](std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            out.push_back((value >> (8 * i)) & 0xFF);
+    };
+    constexpr uint32_t kNumEntries = 11;
+    constexpr uint32_t kBitsPerSampleOffset = 8 + 2 + kNumEntries * 12 + 4;
+    constexpr uint32_t kProfileOffset = kBitsPerSampleOffset + 6;
+    uint32_t strip_offset = kProfileOffset + profile.size();
+    // tag, type, count, value or offset
+    std::array<std::array<uint32_t, 4>, kNumEntries> entries = {{{256, 4, 1, width}, {257, 4, 1, height}, {258, 3, 3, kBitsPerSampleOffset},
+        {259, 3, 1, 1}, {262, 3, 1, 2}, {273, 4, 1, strip_offset}, {277, 3, 1, 3}, {278, 4, 1, height}, {279, 4, 1, width * height * 3},
+        {284, 3, 1, 1}, {34675, 7, static_cast<uint32_t>(profile.size()), kProfileOffset}}};
+
+    std::vector<uint8_t> out = {'I', 'I', 42, 0};
+    put32(out, 8);
+    put16(out, kNumEntries);
+    for (auto& e : entries) {
+        put16(out, e[0]);
+        put16(out, e[1]);
+        put32(out, e[2]);
+        if (e[1] == 3 && e[2] == 1) {
+            put16(out, e[3]);
+            put16(out, 0);
+        } else {
+            put32(out, e[3]);
+        }
+    }
+    put32(out, 0);
+    for (int c = 0; c < 3; c++)
+        put16(out, 8);
+    out.insert(out.end(), profile.begin(), profile.end());
+    out.insert(out.end(), pixels.begin(), pixels.end());
+    return out;
+}
+
+} // namespace
+
 class LibtiffExtDecoderTest : public ::testing::Test, public CommonExtDecoderTest
 {
   public:
@@ -56,6 +156,72 @@ class LibtiffExtDecoderTest : public ::testing::Test, public CommonExtDecoderTes
     {
         CommonExtDecoderTest::TearDown();
     }
+
+    nvimgcodecProcessingStatus_t DecodePyramidLevel(
+        const std::vector<uint8_t>& tiff_data, nvimgcodecTiffDecodeParams_t& tiff_params, uint32_t width, uint32_t height)
+    {
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &in_code_stream_, tiff_data.data(), tiff_data.size()));
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+        image_info_.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+        image_info_.color_spec = NVIMGCODEC_COLORSPEC_GRAY;
+        image_info_.num_planes = 1;
+        image_info_.plane_info[0].width = width;
+        image_info_.plane_info[0].height = height;
+        image_info_.plane_info[0].row_stride = width;
+        image_info_.plane_info[0].num_channels = 1;
+        image_info_.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        image_info_.buffer_size = width * height;
+        out_buffer_.assign(image_info_.buffer_size, 0);
+        image_info_.buffer = out_buffer_.data();
+        image_info_.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image_, &image_info_));
+
+        params_.struct_next = &tiff_params;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &image_, 1, &params_, &future_));
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        params_.struct_next = nullptr;
+
+        nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_UNKNOWN;
+        size_t status_size;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        return status;
+    }
+
+    nvimgcodecProcessingStatus_t DecodeRgb(const std::vector<uint8_t>& tiff_data, uint32_t width, uint32_t height, void* params_ext)
+    {
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &in_code_stream_, tiff_data.data(), tiff_data.size()));
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+        image_info_.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        image_info_.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        image_info_.num_planes = 1;
+        image_info_.plane_info[0].width = width;
+        image_info_.plane_info[0].height = height;
+        image_info_.plane_info[0].row_stride = width * 3;
+        image_info_.plane_info[0].num_channels = 3;
+        image_info_.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        image_info_.buffer_size = width * height * 3;
+        image_info_.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        out_buffer_.assign(image_info_.buffer_size, 0);
+        image_info_.buffer = out_buffer_.data();
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image_, &image_info_));
+
+        params_.struct_next = params_ext;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &image_, 1, &params_, &future_));
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        params_.struct_next = nullptr;
+
+        nvimgcodecProcessingStatus_t status = NVIMGCODEC_PROCESSING_STATUS_UNKNOWN;
+        size_t status_size;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        return status;
+    }
+
+    void ExpectPyramidLevel(int level, uint32_t width, uint32_t height)
+    {
+        for (uint32_t y = 0; y < height; y++)
+            for (uint32_t x = 0; x < width; x++)
+                ASSERT_EQ(PyramidPixel(level, x, y, width), out_buffer_[y * width + x]) << "@" << y << "x" << x;
+    }
 };
 
 TEST_F(LibtiffExtDecoderTest, TIFF_SingleImage_RGB_I)
@@ -93,4 +259,92 @@ TEST_F(LibtiffExtDecoderTest, TIFF_SingleImage_Grayscale)
     TestSingleImage("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_P_Y);
 }
 
+TEST_F(LibtiffExtDecoderTest, TIFF_BandOutput_RGB_I)
+{
+    TestBandOutput("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_I_RGB, 37);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_BandOutput_RGB_P)
+{
+    TestBandOutput("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_P_RGB, 64);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_Statistics_RGB_I)
+{
+    TestStatistics("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_I_RGB);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_Statistics_BGR_P)
+{
+    TestStatistics("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_P_BGR);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_Statistics_BandOutput)
+{
+    TestStatistics("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_I_RGB, 37);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_PyramidLevel)
+{
+    auto tiff_data = MakeGrayPyramidTiff(16, 8, 3);
+    nvimgcodecTiffDecodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr};
+    tiff_params.level = 1;
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodePyramidLevel(tiff_data, tiff_params, 8, 4));
+    ExpectPyramidLevel(1, 8, 4);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_PyramidLevel_Auto)
+{
+    auto tiff_data = MakeGrayPyramidTiff(16, 8, 3);
+    nvimgcodecTiffDecodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr};
+    tiff_params.level = NVIMGCODEC_TIFF_LEVEL_AUTO;
+    tiff_params.target_width = 5;
+    tiff_params.target_height = 3;
+    // The 4x2 level is too small for the target, so the 8x4 one is the smallest that covers it
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodePyramidLevel(tiff_data, tiff_params, 8, 4));
+    ExpectPyramidLevel(1, 8, 4);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_PyramidLevel_Auto_OutputSize)
+{
+    auto tiff_data = MakeGrayPyramidTiff(16, 8, 3);
+    nvimgcodecTiffDecodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr};
+    tiff_params.level = NVIMGCODEC_TIFF_LEVEL_AUTO;
+    // Without a target, the level is chosen from the size of the output image
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodePyramidLevel(tiff_data, tiff_params, 4, 2));
+    ExpectPyramidLevel(2, 4, 2);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_PyramidLevel_NotPresent)
+{
+    auto tiff_data = MakeGrayPyramidTiff(16, 8, 3);
+    nvimgcodecTiffDecodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr};
+    tiff_params.level = 3;
+    EXPECT_NE(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodePyramidLevel(tiff_data, tiff_params, 2, 1));
+    EXPECT_EQ(std::vector<uint8_t>(2, 0), out_buffer_);
+}
+
+TEST_F(LibtiffExtDecoderTest, TIFF_ColorManagement_LinearToSrgb)
+{
+    // Gray ramp encoded with a linear profile, converted to sRGB on decode
+    std::vector<uint8_t> pixels;
+    for (int v : {0, 16, 64, 128, 192, 255})
+        pixels.insert(pixels.end(), 3, static_cast<uint8_t>(v));
+    auto tiff_data = MakeRgbTiffWithProfile(3, 2, pixels, MakeRgbProfile(MakeGammaCurve(1.0)));
+
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodeRgb(tiff_data, 3, 2, nullptr));
+    EXPECT_EQ(pixels, out_buffer_);
+    nvimgcodecImageDestroy(image_);
+    nvimgcodecFutureDestroy(future_);
+    nvimgcodecCodeStreamDestroy(in_code_stream_);
+
+    nvimgcodecColorManagementParams_t color_params{
+        NVIMGCODEC_STRUCTURE_TYPE_COLOR_MANAGEMENT_PARAMS, sizeof(nvimgcodecColorManagementParams_t), nullptr};
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, DecodeRgb(tiff_data, 3, 2, &color_params));
+    for (size_t i = 0; i < pixels.size(); i++) {
+        int expected = static_cast<int>(std::lround(255 * SrgbEncode(pixels[i] / 255.0)));
+        EXPECT_NEAR(expected, out_buffer_[i], 1) << "@" << i;
+    }
+}
+
 }} // namespace nvimgcodec::test
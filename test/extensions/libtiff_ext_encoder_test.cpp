@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/libtiff/libtiff_ext.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/parser_test_utils.h>
+#include <parsers/tiff.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+class LibtiffExtEncoderTest : public ExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        ExtensionTestBase::SetUp();
+
+        nvimgcodecExtensionDesc_t tiff_parser_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_tiff_parser_extension_desc(&tiff_parser_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &tiff_parser_extension_, &tiff_parser_extension_desc));
+
+        nvimgcodecExtensionDesc_t libtiff_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_libtiff_extension_desc(&libtiff_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &libtiff_extension_, &libtiff_extension_desc));
+
+        nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+        exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+        exec_params.max_num_cpu_threads = 4;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCreate(instance_, &encoder_, &exec_params, nullptr));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr));
+
+        image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        sample_format_ = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        color_spec_ = NVIMGCODEC_COLORSPEC_SRGB;
+        chroma_subsampling_ = NVIMGCODEC_SAMPLING_NONE;
+    }
+
+    void TearDown() override
+    {
+        if (decoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+        if (encoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderDestroy(encoder_));
+        ExtensionTestBase::TearDownCodecResources();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(libtiff_extension_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(tiff_parser_extension_));
+        ExtensionTestBase::TearDown();
+    }
+
+    nvimgcodecExtension_t tiff_parser_extension_;
+    nvimgcodecExtension_t libtiff_extension_;
+    nvimgcodecEncoder_t encoder_ = nullptr;
+    nvimgcodecDecoder_t decoder_ = nullptr;
+};
+
+TEST_F(LibtiffExtEncoderTest, TiledPyramid)
+{
+    const uint32_t width = 600, height = 500;
+    image_info_.plane_info[0].width = width;
+    image_info_.plane_info[0].height = height;
+    PrepareImageForFormat();
+    std::vector<unsigned char> ref_buffer(image_buffer_.size());
+    srand(4771);
+    for (auto& v : ref_buffer)
+        v = rand() % 255;
+    image_buffer_ = ref_buffer;
+    image_info_.buffer = image_buffer_.data();
+
+    nvimgcodecTiffEncodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_ENCODE_PARAMS, sizeof(nvimgcodecTiffEncodeParams_t), nullptr};
+    tiff_params.compression = NVIMGCODEC_TIFF_COMPRESSION_DEFLATE;
+    tiff_params.tile_width = 128;
+    tiff_params.tile_height = 128;
+    tiff_params.num_levels = 0;
+    nvimgcodecEncodeParams_t params{NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), &tiff_params};
+
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    strcpy(cs_image_info.codec_name, "tiff");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                             &LibtiffExtEncoderTest::ResizeBufferStatic<LibtiffExtEncoderTest>, &cs_image_info));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, &in_image_, &out_code_stream_, 1, &params, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+    size_t status_size;
+    nvimgcodecProcessingStatus_t status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+    future_ = nullptr;
+
+    // Levels are halved until the smallest one fits in a single tile
+    LoadImageFromHostMemory(instance_, in_code_stream_, code_stream_buffer_.data(), code_stream_buffer_.size());
+    nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), nullptr};
+    nvimgcodecImageInfo_t load_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &tiff_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &load_info));
+    ASSERT_EQ(width, load_info.plane_info[0].width);
+    ASSERT_EQ(height, load_info.plane_info[0].height);
+    const uint32_t expected_levels[][2] = {{600, 500}, {300, 250}, {150, 125}, {75, 63}};
+    ASSERT_EQ(4, tiff_info.num_levels);
+    for (int l = 0; l < 4; l++) {
+        EXPECT_EQ(expected_levels[l][0], tiff_info.levels[l].width);
+        EXPECT_EQ(expected_levels[l][1], tiff_info.levels[l].height);
+        EXPECT_EQ(128, tiff_info.levels[l].tile_width);
+        EXPECT_EQ(128, tiff_info.levels[l].tile_height);
+    }
+
+    // Full resolution level is lossless
+    std::vector<unsigned char> decode_buffer(ref_buffer.size());
+    nvimgcodecImageInfo_t out_info(image_info_);
+    out_info.buffer = decode_buffer.data();
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &out_image_, &out_info));
+    nvimgcodecDecodeParams_t decode_params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &out_image_, 1, &decode_params, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+    ASSERT_EQ(ref_buffer, decode_buffer);
+
+    // Reduced levels are the previous level filtered with a 2x2 box, pairing the last row or column of odd sizes with itself
+    std::vector<unsigned char> level_ref = ref_buffer;
+    for (int l = 1; l < 4; l++) {
+        const uint32_t prev_width = expected_levels[l - 1][0], prev_height = expected_levels[l - 1][1];
+        const uint32_t level_width = expected_levels[l][0], level_height = expected_levels[l][1];
+        std::vector<unsigned char> prev_ref = std::move(level_ref);
+        level_ref.assign(level_width * level_height * 3, 0);
+        for (uint32_t y = 0; y < level_height; y++) {
+            uint32_t y0 = 2 * y, y1 = std::min(2 * y + 1, prev_height - 1);
+            for (uint32_t x = 0; x < level_width; x++) {
+                uint32_t x0 = 2 * x, x1 = std::min(2 * x + 1, prev_width - 1);
+                for (uint32_t c = 0; c < 3; c++) {
+                    auto at = [&](uint32_t py, uint32_t px) { return prev_ref[(py * prev_width + px) * 3 + c]; };
+                    level_ref[(y * level_width + x) * 3 + c] = (at(y0, x0) + at(y0, x1) + at(y1, x0) + at(y1, x1) + 2) >> 2;
+                }
+            }
+        }
+
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(out_image_));
+        out_image_ = nullptr;
+        std::vector<unsigned char> level_buffer(level_ref.size());
+        nvimgcodecImageInfo_t level_info(image_info_);
+        level_info.plane_info[0].width = level_width;
+        level_info.plane_info[0].height = level_height;
+        level_info.plane_info[0].row_stride = level_width * 3;
+        level_info.buffer_size = level_buffer.size();
+        level_info.buffer = level_buffer.data();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &out_image_, &level_info));
+        nvimgcodecTiffDecodeParams_t tiff_decode_params{
+            NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr, l, 0, 0};
+        decode_params.struct_next = &tiff_decode_params;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &out_image_, 1, &decode_params, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(level_ref, level_buffer) << "level " << l;
+    }
+}
+
+}} // namespace nvimgcodec::test
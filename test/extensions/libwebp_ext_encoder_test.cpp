@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/libwebp/libwebp_ext.h>
+#include <extensions/utils/image_metrics.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/parser_test_utils.h>
+#include <parsers/webp.h>
+#include <webp/decode.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+class LibwebpExtEncoderTest : public CpuCodecExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        SetUpCodec(get_webp_parser_extension_desc, get_libwebp_extension_desc, false);
+        SetUpImageInfo(123, 77, NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLING_NONE);
+        PrepareImageForFormat();
+        for (size_t i = 0; i < image_buffer_.size(); i++)
+            image_buffer_[i] = static_cast<unsigned char>(i * 7 % 251);
+
+        params_ = {NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        params_.quality = 75;
+        webp_params_ = {NVIMGCODEC_STRUCTURE_TYPE_WEBP_ENCODE_PARAMS, sizeof(nvimgcodecWebpEncodeParams_t), 0};
+        webp_params_.method = 4;
+        params_.struct_next = &webp_params_;
+    }
+
+    void TearDown() override { CpuCodecExtensionTestBase::TearDown(); }
+
+    void EncodeBatch(int batch_size) { CpuCodecExtensionTestBase::EncodeBatch("webp", batch_size, &params_); }
+
+    // Checks the RIFF container of an encoded image and returns the fourcc of its image chunk
+    std::string CheckCodeStream(const std::vector<unsigned char>& data)
+    {
+        EXPECT_GT(data.size(), 20u);
+        if (data.size() <= 20)
+            return "";
+        EXPECT_EQ(0, memcmp(data.data(), "RIFF", 4));
+        EXPECT_EQ(0, memcmp(data.data() + 8, "WEBP", 4));
+        uint32_t riff_size = data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24);
+        EXPECT_EQ(data.size(), riff_size + 8u);
+
+        nvimgcodecCodeStream_t code_stream;
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &code_stream, data.data(), data.size()));
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(code_stream, &info));
+        EXPECT_STREQ("webp", info.codec_name);
+        EXPECT_EQ(image_info_.plane_info[0].width, info.plane_info[0].width);
+        EXPECT_EQ(image_info_.plane_info[0].height, info.plane_info[0].height);
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(code_stream));
+        return std::string(reinterpret_cast<const char*>(data.data()) + 12, 4);
+    }
+
+    // Decodes an encoded image with libwebp, to interleaved RGB of the input size
+    std::vector<unsigned char> Decode(const std::vector<unsigned char>& data)
+    {
+        int width = 0, height = 0;
+        uint8_t* rgb = WebPDecodeRGB(data.data(), data.size(), &width, &height);
+        EXPECT_NE(nullptr, rgb);
+        if (!rgb)
+            return {};
+        EXPECT_EQ(image_info_.plane_info[0].width, static_cast<uint32_t>(width));
+        EXPECT_EQ(image_info_.plane_info[0].height, static_cast<uint32_t>(height));
+        std::vector<unsigned char> decoded(rgb, rgb + static_cast<size_t>(width) * height * 3);
+        WebPFree(rgb);
+        return decoded;
+    }
+
+    double DecodePsnr(const std::vector<unsigned char>& data)
+    {
+        auto decoded = Decode(data);
+        if (decoded.size() != image_buffer_.size())
+            return 0;
+        uint32_t width = image_info_.plane_info[0].width;
+        return ComputePsnr(image_buffer_.data(), image_info_.plane_info[0].row_stride, decoded.data(), width * 3, width,
+            image_info_.plane_info[0].height, 3);
+    }
+
+    // Smooth colors with gray texture, so that the detail is in the luma and survives the 4:2:0 subsampling of lossy WebP
+    void SetUpTexturedImage(uint32_t width, uint32_t height)
+    {
+        SetUpImageInfo(width, height, NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLING_NONE);
+        PrepareImageForFormat();
+        srand(1234);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                unsigned char* px = &image_buffer_[y * image_info_.plane_info[0].row_stride + x * 3];
+                int texture = rand() % 41 - 20;
+                px[0] = static_cast<unsigned char>(128 + 80 * std::sin(x * 0.05) * std::cos(y * 0.08) + texture);
+                px[1] = static_cast<unsigned char>(20 + x * 200 / width + texture);
+                px[2] = static_cast<unsigned char>(20 + y * 200 / height + texture);
+            }
+        }
+    }
+
+    nvimgcodecEncodeParams_t params_;
+    nvimgcodecWebpEncodeParams_t webp_params_;
+};
+
+TEST_F(LibwebpExtEncoderTest, EncodeLossy)
+{
+    SetUpTexturedImage(123, 77);
+    EncodeBatch(1);
+    EXPECT_EQ("VP8 ", CheckCodeStream(outputs_[0].data));
+    EXPECT_GT(DecodePsnr(outputs_[0].data), 30.0);
+}
+
+TEST_F(LibwebpExtEncoderTest, EncodeLossless)
+{
+    webp_params_.lossless = 1;
+    EncodeBatch(1);
+    EXPECT_EQ("VP8L", CheckCodeStream(outputs_[0].data));
+    EXPECT_EQ(image_buffer_, Decode(outputs_[0].data));
+}
+
+TEST_F(LibwebpExtEncoderTest, EncodeBatch)
+{
+    // Samples are encoded concurrently, each to its own output
+    webp_params_.lossless = 1;
+    webp_params_.method = 0;
+    params_.quality = 0;
+    EncodeBatch(5);
+    for (auto& output : outputs_) {
+        EXPECT_EQ("VP8L", CheckCodeStream(output.data));
+        EXPECT_EQ(outputs_[0].data, output.data);
+        EXPECT_EQ(image_buffer_, Decode(output.data));
+    }
+}
+
+TEST_F(LibwebpExtEncoderTest, RateControlTargetSize)
+{
+    SetUpTexturedImage(320, 240);
+    EncodeBatch(1);
+    const size_t reference_size = outputs_[0].data.size();
+
+    // The multi-pass search of libwebp gets close to the target, without guaranteeing to stay below it
+    nvimgcodecRateControlParams_t rate_control{NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS, sizeof(nvimgcodecRateControlParams_t), 0};
+    rate_control.target_size = reference_size / 2;
+    webp_params_.struct_next = &rate_control;
+    EncodeBatch(1);
+    EXPECT_EQ("VP8 ", CheckCodeStream(outputs_[0].data));
+    EXPECT_LT(outputs_[0].data.size(), reference_size);
+    EXPECT_NEAR(static_cast<double>(rate_control.target_size), static_cast<double>(outputs_[0].data.size()), 0.05 * rate_control.target_size);
+}
+
+TEST_F(LibwebpExtEncoderTest, RateControlTargetPsnr)
+{
+    // libwebp measures the distortion in YUV, so the PSNR of the decoded RGB image only follows the target
+    SetUpTexturedImage(320, 240);
+    nvimgcodecRateControlParams_t rate_control{NVIMGCODEC_STRUCTURE_TYPE_RATE_CONTROL_PARAMS, sizeof(nvimgcodecRateControlParams_t), 0};
+    webp_params_.struct_next = &rate_control;
+    double prev_psnr = 0;
+    for (float target_psnr : {30.f, 35.f, 40.f}) {
+        rate_control.target_psnr = target_psnr;
+        EncodeBatch(1);
+        double psnr = DecodePsnr(outputs_[0].data);
+        EXPECT_GT(psnr, prev_psnr);
+        EXPECT_GT(psnr, target_psnr - 5);
+        prev_psnr = psnr;
+    }
+}
+
+TEST_F(LibwebpExtEncoderTest, InvalidMethodIsUnsupported)
+{
+    webp_params_.method = 7;
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    strcpy(cs_image_info.codec_name, "webp");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                             &LibwebpExtEncoderTest::ResizeBufferStatic<LibwebpExtEncoderTest>, &cs_image_info));
+    nvimgcodecProcessingStatus_t status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCanEncode(encoder_, &in_image_, &out_code_stream_, 1, &params_, &status, true));
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_FAIL, status);
+}
+
+}} // namespace nvimgcodec::test
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <cuda_runtime_api.h>
 #include <extensions/nvbmp/nvbmp_ext.h>
 #include "common_ext_decoder_test.h"
 #include <gtest/gtest.h>
@@ -24,6 +25,7 @@
 #include <test_utils.h>
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <string>
 #include <vector>
 #include <filesystem>
@@ -31,6 +33,44 @@
 
 namespace nvimgcodec { namespace test {
 
+namespace {
+
+// Builds a bottom-up 24-bit BMP from interleaved RGB rows given top to bottom. Rows are not padded, so width * 3 must be a multiple of 4.
+std::vector<uint8_t> MakeBmp24(uint32_t width, uint32_t height, const std::vector<uint8_t>& rgb)
+{
+    auto put16 = [](std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(value & 0xFF);
+        out.push_back(value >> 8);
+    };
+    auto put32 = [](std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; i++)
+            out.push_back((value >> (8 * i)) & 0xFF);
+    };
+    uint32_t data_size = width * height * 3;
+    std::vector<uint8_t> out = {'B', 'M'};
+    put32(out, 54 + data_size);
+    put32(out, 0);
+    put32(out, 54);
+    put32(out, 40);
+    put32(out, width);
+    put32(out, height);
+    put16(out, 1);
+    put16(out, 24);
+    put32(out, 0);
+    put32(out, data_size);
+    for (int i = 0; i < 4; i++)
+        put32(out, 0);
+    for (uint32_t y = height; y-- > 0;) {
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t* pixel = &rgb[(y * width + x) * 3];
+            out.insert(out.end(), {pixel[2], pixel[1], pixel[0]});
+        }
+    }
+    return out;
+}
+
+} // namespace
+
 class NvbmpExtDecoderTest : public ::testing::Test, public CommonExtDecoderTest
 {
   public:
@@ -67,4 +107,131 @@ TEST_F(NvbmpExtDecoderTest, NVBMP_SingleImage_RGB_P)
     TestSingleImage("bmp/cat-111793_640.bmp", NVIMGCODEC_SAMPLEFORMAT_P_RGB);
 }
 
+TEST_F(NvbmpExtDecoderTest, NVBMP_DecodeToFileMappedImage)
+{
+    constexpr uint32_t width = 4, height = 3;
+    std::vector<uint8_t> rgb(width * height * 3);
+    for (size_t i = 0; i < rgb.size(); i++)
+        rgb[i] = static_cast<uint8_t>(i * 7);
+    auto bmp = MakeBmp24(width, height, rgb);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &in_code_stream_, bmp.data(), bmp.size()));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &image_info_));
+    image_info_.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+    image_info_.num_planes = 1;
+    image_info_.plane_info[0].num_channels = 3;
+    image_info_.plane_info[0].row_stride = width * 3;
+    image_info_.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+    image_info_.buffer_size = rgb.size();
+
+    auto path = std::filesystem::temp_directory_path() / "nvimgcodec_nvbmp_file_mapped_decode.raw";
+    auto ret = nvimgcodecImageCreateFileMapped(instance_, &image_, &image_info_, path.string().c_str());
+    if (ret == NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED)
+        GTEST_SKIP() << "File mapped images are not supported on this platform";
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, ret);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &image_, 1, &params_, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+    nvimgcodecProcessingStatus_t status;
+    size_t status_size;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageSync(image_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image_));
+    image_ = nullptr;
+
+    std::ifstream f(path, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::filesystem::remove(path);
+    EXPECT_EQ(rgb, content);
+}
+
+TEST_F(NvbmpExtDecoderTest, NVBMP_FileMappedImageTooSmall)
+{
+    image_info_.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+    image_info_.num_planes = 3;
+    for (int p = 0; p < 3; p++) {
+        image_info_.plane_info[p].width = 4;
+        image_info_.plane_info[p].height = 3;
+        image_info_.plane_info[p].num_channels = 1;
+        image_info_.plane_info[p].row_stride = 4;
+        image_info_.plane_info[p].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+    }
+    // Large enough for one plane only
+    image_info_.buffer_size = 4 * 3;
+    auto path = std::filesystem::temp_directory_path() / "nvimgcodec_nvbmp_file_mapped_too_small.raw";
+    auto ret = nvimgcodecImageCreateFileMapped(instance_, &image_, &image_info_, path.string().c_str());
+    if (ret == NVIMGCODEC_STATUS_IMPLEMENTATION_UNSUPPORTED)
+        GTEST_SKIP() << "File mapped images are not supported on this platform";
+    EXPECT_EQ(NVIMGCODEC_STATUS_INVALID_PARAMETER, ret);
+    EXPECT_EQ(nullptr, image_);
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(NvbmpExtDecoderTest, NVBMP_BatchDeduplication)
+{
+    constexpr uint32_t width = 4, height = 3;
+    constexpr int batch_size = 5;
+    std::vector<uint8_t> rgb(width * height * 3), other_rgb(rgb.size()), changed_rgb;
+    for (size_t i = 0; i < rgb.size(); i++) {
+        rgb[i] = static_cast<uint8_t>(i * 7);
+        other_rgb[i] = static_cast<uint8_t>(255 - i);
+    }
+    changed_rgb = rgb;
+    changed_rgb[20] ^= 1;
+    auto bmp = MakeBmp24(width, height, rgb);
+    auto bmp_copy = bmp;
+    auto other_bmp = MakeBmp24(width, height, other_rgb);
+    auto changed_bmp = MakeBmp24(width, height, changed_rgb);
+    // The same contents, in the same and in another buffer, a different image and one of the same size differing in one byte
+    const std::vector<uint8_t>* inputs[batch_size] = {&bmp, &other_bmp, &bmp_copy, &bmp, &changed_bmp};
+    const std::vector<uint8_t>* expected[batch_size] = {&rgb, &other_rgb, &rgb, &rgb, &changed_rgb};
+
+    std::vector<nvimgcodecCodeStream_t> code_streams(batch_size);
+    std::vector<nvimgcodecImage_t> images(batch_size);
+    std::vector<std::vector<uint8_t>> outputs(batch_size, std::vector<uint8_t>(rgb.size(), 0));
+    for (int i = 0; i < batch_size; i++) {
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecCodeStreamCreateFromHostMem(instance_, &code_streams[i], inputs[i]->data(), inputs[i]->size()));
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(code_streams[i], &info));
+        info.sample_format = NVIMGCODEC_SAMPLEFORMAT_I_RGB;
+        info.num_planes = 1;
+        info.plane_info[0].num_channels = 3;
+        info.plane_info[0].row_stride = width * 3;
+        info.plane_info[0].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+        info.buffer_size = rgb.size();
+        info.buffer = outputs[i].data();
+        info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &images[i], &info));
+    }
+
+    nvimgcodecDeduplicationParams_t dedup_params{
+        NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_PARAMS, sizeof(nvimgcodecDeduplicationParams_t), nullptr, 1};
+    params_.struct_next = &dedup_params;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+        nvimgcodecDecoderDecode(decoder_, code_streams.data(), images.data(), batch_size, &params_, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+    params_.struct_next = nullptr;
+    std::vector<nvimgcodecProcessingStatus_t> statuses(batch_size);
+    size_t status_size;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, statuses.data(), &status_size));
+    ASSERT_EQ(static_cast<size_t>(batch_size), status_size);
+    // Outputs of duplicates are copied on the CUDA stream of the image
+    ASSERT_EQ(cudaSuccess, cudaStreamSynchronize(nullptr));
+    for (int i = 0; i < batch_size; i++) {
+        EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, statuses[i]) << "sample " << i;
+        EXPECT_EQ(*expected[i], outputs[i]) << "sample " << i;
+    }
+
+    nvimgcodecDeduplicationStats_t stats{NVIMGCODEC_STRUCTURE_TYPE_DEDUPLICATION_STATS, sizeof(nvimgcodecDeduplicationStats_t), nullptr};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderGetDeduplicationStats(decoder_, &stats));
+    EXPECT_EQ(static_cast<uint64_t>(batch_size), stats.num_samples);
+    EXPECT_EQ(2u, stats.num_duplicates);
+
+    for (int i = 0; i < batch_size; i++) {
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(images[i]));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(code_streams[i]));
+    }
+}
+
 }} // namespace nvimgcodec::test
@@ -228,6 +228,113 @@ TEST_P(NvbmpExtEncoderTest, ValidFormatAndParameters)
         memcmp(reinterpret_cast<void*>(decode_buffer.data()), reinterpret_cast<void*>(ref_buffer_.data()), ref_buffer_.size()));
 }
 
+TEST_P(NvbmpExtEncoderTest, BandInputIsWrittenTopDown)
+{
+    genRandomImage();
+
+    image_info_.plane_info[0].width = image_width_;
+    image_info_.plane_info[0].height = image_height_;
+    PrepareImageForFormat();
+    if (sample_format_ == NVIMGCODEC_SAMPLEFORMAT_I_RGB) {
+        Convert_P_RGB_to_I_RGB(image_buffer_, ref_buffer_, image_info_);
+    } else {
+        memcpy(image_buffer_.data(), ref_buffer_.data(), ref_buffer_.size());
+    }
+    // The whole image is kept aside, the image buffer only holds one band
+    std::vector<unsigned char> full_image(image_buffer_);
+
+    // Source image is provided 37 rows at a time, the last band being shorter
+    struct BandSource
+    {
+        const std::vector<unsigned char>* image;
+        uint32_t height;
+        uint32_t band_height;
+        uint32_t next_row;
+    } source{&full_image, static_cast<uint32_t>(image_height_), 37, 0};
+    auto band_request = [](void* ctx, const nvimgcodecImageInfo_t* band_info, uint32_t first_row,
+                            uint32_t num_rows) -> nvimgcodecStatus_t {
+        auto* src = static_cast<BandSource*>(ctx);
+        if (first_row != src->next_row || num_rows == 0 || num_rows > src->band_height)
+            return NVIMGCODEC_STATUS_INTERNAL_ERROR;
+        size_t row_size = band_info->plane_info[0].row_stride;
+        for (uint32_t p = 0; p < band_info->num_planes; p++) {
+            memcpy(static_cast<unsigned char*>(band_info->buffer) + p * src->band_height * row_size,
+                src->image->data() + (p * src->height + first_row) * row_size, num_rows * row_size);
+        }
+        src->next_row += num_rows;
+        return NVIMGCODEC_STATUS_SUCCESS;
+    };
+    nvimgcodecBandInput_t band_input{NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT, sizeof(nvimgcodecBandInput_t), nullptr};
+    band_input.band_height = source.band_height;
+    band_input.band_request = band_request;
+    band_input.band_ctx = &source;
+
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    strcpy(cs_image_info.codec_name, "bmp");
+    image_buffer_.resize(image_buffer_.size() / image_height_ * source.band_height);
+    image_info_.buffer = image_buffer_.data();
+    image_info_.buffer_size = image_buffer_.size();
+    image_info_.struct_next = &band_input;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    image_info_.struct_next = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this, &NvbmpExtEncoderTest::ResizeBufferStatic<NvbmpExtEncoderTest>, &cs_image_info));
+    images_.push_back(in_image_);
+    streams_.push_back(out_code_stream_);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, images_.data(), streams_.data(), 1, &params_, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+
+    size_t status_size;
+    nvimgcodecProcessingStatus_t encode_status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &encode_status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, encode_status);
+    ASSERT_EQ(source.next_row, source.height);
+
+    // Rows are written in the order they arrive, so the height in the header is negative
+    ASSERT_GT(code_stream_buffer_.size(), 26u);
+    int32_t bmp_height;
+    memcpy(&bmp_height, code_stream_buffer_.data() + 22, sizeof(bmp_height));
+    EXPECT_EQ(-image_height_, bmp_height);
+
+    // Decode the top-down image back to planar RGB
+    LoadImageFromHostMemory(instance_, in_code_stream_, code_stream_buffer_.data(), code_stream_buffer_.size());
+    nvimgcodecImageInfo_t load_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &load_info));
+    ASSERT_EQ(NVIMGCODEC_SAMPLEFORMAT_P_RGB, load_info.sample_format);
+    ASSERT_EQ(static_cast<uint32_t>(image_width_), load_info.plane_info[0].width);
+    ASSERT_EQ(static_cast<uint32_t>(image_height_), load_info.plane_info[0].height);
+
+    std::vector<uint8_t> decode_buffer(ref_buffer_.size());
+    load_info.buffer_size = decode_buffer.size();
+    load_info.buffer = decode_buffer.data();
+    load_info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+    for (int p = 0; p < load_info.num_planes; p++)
+        load_info.plane_info[p].row_stride = image_width_;
+
+    nvimgcodecDecoder_t decoder;
+    nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+    exec_params.device_id = NVIMGCODEC_DEVICE_CURRENT;
+    exec_params.max_num_cpu_threads = 1;
+    nvimgcodecStatus_t decoder_create_status = nvimgcodecDecoderCreate(instance_, &decoder, &exec_params, nullptr);
+    std::unique_ptr<std::remove_pointer<nvimgcodecDecoder_t>::type, decltype(&nvimgcodecDecoderDestroy)> decoder_raii(
+            decoder, &nvimgcodecDecoderDestroy);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, decoder_create_status);
+
+    nvimgcodecDecodeParams_t decode_params{NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &out_image_, &load_info));
+
+    nvimgcodecFuture_t decoder_future = nullptr;
+    nvimgcodecStatus_t decoder_decode_status = nvimgcodecDecoderDecode(decoder, &in_code_stream_, &out_image_, 1, &decode_params, &decoder_future);
+    std::unique_ptr<std::remove_pointer<nvimgcodecFuture_t>::type, decltype(&nvimgcodecFutureDestroy)> decoder_future_raii(
+            decoder_future, &nvimgcodecFutureDestroy);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, decoder_decode_status);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(decoder_future));
+    nvimgcodecProcessingStatus_t decode_status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(decoder_future, &decode_status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, decode_status);
+
+    ASSERT_EQ(0, memcmp(decode_buffer.data(), ref_buffer_.data(), ref_buffer_.size()));
+}
+
 INSTANTIATE_TEST_SUITE_P(NVBMP_ENCODE_VALID_SRGB_INPUT_FORMATS,
     NvbmpExtEncoderTest,
     Values(NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLEFORMAT_P_RGB)
@@ -220,6 +220,79 @@ TEST_P(NvpnmExtEncoderTest, ValidFormatAndParameters)
     }
 }
 
+TEST_P(NvpnmExtEncoderTest, BandInput)
+{
+    genRandomImage();
+
+    image_info_.plane_info[0].width = image_width_;
+    image_info_.plane_info[0].height = image_height_;
+    PrepareImageForFormat();
+    if (sample_format_ == NVIMGCODEC_SAMPLEFORMAT_I_RGB) {
+        Convert_P_RGB_to_I_RGB(image_buffer_, ref_buffer_, image_info_);
+    } else {
+        memcpy(image_buffer_.data(), ref_buffer_.data(), ref_buffer_.size());
+    }
+    // The whole image is kept aside, the image buffer only holds one band
+    std::vector<unsigned char> full_image(image_buffer_);
+
+    // Source image is provided 37 rows at a time, through a buffer which only holds one band
+    struct BandSource
+    {
+        const std::vector<unsigned char>* image;
+        uint32_t height;
+        uint32_t band_height;
+        uint32_t next_row;
+    } source{&full_image, static_cast<uint32_t>(image_height_), 37, 0};
+    auto band_request = [](void* ctx, const nvimgcodecImageInfo_t* band_info, uint32_t first_row,
+                            uint32_t num_rows) -> nvimgcodecStatus_t {
+        auto* src = static_cast<BandSource*>(ctx);
+        if (first_row != src->next_row || num_rows == 0 || num_rows > src->band_height)
+            return NVIMGCODEC_STATUS_INTERNAL_ERROR;
+        size_t row_size = band_info->plane_info[0].row_stride;
+        for (uint32_t p = 0; p < band_info->num_planes; p++) {
+            memcpy(static_cast<unsigned char*>(band_info->buffer) + p * src->band_height * row_size,
+                src->image->data() + (p * src->height + first_row) * row_size, num_rows * row_size);
+        }
+        src->next_row += num_rows;
+        return NVIMGCODEC_STATUS_SUCCESS;
+    };
+    nvimgcodecBandInput_t band_input{NVIMGCODEC_STRUCTURE_TYPE_BAND_INPUT, sizeof(nvimgcodecBandInput_t), nullptr};
+    band_input.band_height = source.band_height;
+    band_input.band_request = band_request;
+    band_input.band_ctx = &source;
+
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    strcpy(cs_image_info.codec_name, "pnm");
+    image_buffer_.resize(image_buffer_.size() / image_height_ * source.band_height);
+    image_info_.buffer = image_buffer_.data();
+    image_info_.buffer_size = image_buffer_.size();
+    image_info_.struct_next = &band_input;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    image_info_.struct_next = nullptr;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this, &NvpnmExtEncoderTest::ResizeBufferStatic<NvpnmExtEncoderTest>, &cs_image_info));
+    images_.push_back(in_image_);
+    streams_.push_back(out_code_stream_);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, images_.data(), streams_.data(), 1, &params_, &future_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+
+    size_t status_size;
+    nvimgcodecProcessingStatus_t encode_status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &encode_status, &status_size));
+    ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, encode_status);
+    ASSERT_EQ(source.next_row, source.height);
+
+    size_t header_size = code_stream_buffer_.size() - ref_buffer_.size();
+    int w = image_width_;
+    int h = image_height_;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            for (int c = 0; c < num_components_; ++c) {
+                ASSERT_EQ(code_stream_buffer_[header_size + y*w*num_components_ + x*num_components_ + c], ref_buffer_[c*h*w + y*w + x]);
+            }
+        }
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P(NVPNM_ENCODE_VALID_SRGB_INPUT_FORMATS,
     NvpnmExtEncoderTest,
     Values(NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLEFORMAT_P_RGB)
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/nvtensor/nvtensor_ext.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/nvtensor.h>
+#include <parsers/nvtensor_format.h>
+#include <parsers/parser_test_utils.h>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+class NvTensorExtTest : public CpuCodecExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        SetUpCodec(get_nvtensor_parser_extension_desc, get_nvtensor_extension_desc, true);
+
+        encode_params_ = {NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        nvtensor_params_ = {NVIMGCODEC_STRUCTURE_TYPE_NVTENSOR_ENCODE_PARAMS, sizeof(nvimgcodecNvTensorEncodeParams_t), 0};
+        nvtensor_params_.compression = NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD;
+        nvtensor_params_.level = 3;
+        nvtensor_params_.chunk_size = 1000; // Many chunks, some of them spanning rows and planes
+        encode_params_.struct_next = &nvtensor_params_;
+        decode_params_ = {NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+    }
+
+    void TearDown() override { CpuCodecExtensionTestBase::TearDown(); }
+
+    // Planar 16-bit image, with row_padding bytes at the end of each row
+    nvimgcodecImageInfo_t MakeImageInfo(std::vector<unsigned char>& buffer, size_t row_padding)
+    {
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        info.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+        info.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        info.chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+        info.num_planes = 3;
+        for (uint32_t p = 0; p < info.num_planes; p++) {
+            info.plane_info[p].width = 123;
+            info.plane_info[p].height = 77;
+            info.plane_info[p].num_channels = 1;
+            info.plane_info[p].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16;
+            info.plane_info[p].precision = 16;
+            info.plane_info[p].row_stride = info.plane_info[p].width * sizeof(uint16_t) + row_padding;
+        }
+        info.buffer_size = info.plane_info[0].row_stride * info.plane_info[0].height * info.num_planes;
+        buffer.resize(info.buffer_size);
+        info.buffer = buffer.data();
+        info.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+        return info;
+    }
+
+    void Encode(const nvimgcodecImageInfo_t& info)
+    {
+        nvimgcodecImageInfo_t cs_image_info(info);
+        strcpy(cs_image_info.codec_name, "nvtensor");
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, &encoded_,
+                                                 &OutputBuffer::resize, &cs_image_info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, &in_image_, &out_code_stream_, 1, &encode_params_, &future_));
+        ExpectStatus(NVIMGCODEC_PROCESSING_STATUS_SUCCESS);
+    }
+
+    void Decode(const nvimgcodecImageInfo_t& info, nvimgcodecProcessingStatus_t expected_status = NVIMGCODEC_PROCESSING_STATUS_SUCCESS)
+    {
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecCodeStreamCreateFromHostMem(instance_, &in_code_stream_, encoded_.data.data(), encoded_.data.size()));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &out_image_, &info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDecode(decoder_, &in_code_stream_, &out_image_, 1, &decode_params_, &future_));
+        ExpectStatus(expected_status);
+    }
+
+    void ExpectStatus(nvimgcodecProcessingStatus_t expected_status)
+    {
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        nvimgcodecProcessingStatus_t status;
+        size_t status_size;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, &status, &status_size));
+        ASSERT_EQ(1u, status_size);
+        ASSERT_EQ(expected_status, status);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+    }
+
+    // Encodes an image with input_padding bytes after each row and decodes it to one with output_padding
+    void TestRoundTrip(size_t input_padding, size_t output_padding)
+    {
+        std::vector<unsigned char> input;
+        auto in_info = MakeImageInfo(input, input_padding);
+        for (size_t i = 0; i < input.size(); i++)
+            input[i] = static_cast<unsigned char>(i * 7 % 251);
+        Encode(in_info);
+
+        nvimgcodecImageInfo_t cs_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecCodeStreamCreateFromHostMem(instance_, &in_code_stream_, encoded_.data.data(), encoded_.data.size()));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_code_stream_, &cs_info));
+        EXPECT_STREQ("nvtensor", cs_info.codec_name);
+        expect_eq(in_info, cs_info);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(in_code_stream_));
+        in_code_stream_ = nullptr;
+
+        std::vector<unsigned char> output;
+        auto out_info = MakeImageInfo(output, output_padding);
+        Decode(out_info);
+        for (uint32_t p = 0; p < in_info.num_planes; p++) {
+            auto& in_plane = in_info.plane_info[p];
+            auto& out_plane = out_info.plane_info[p];
+            size_t row_size = in_plane.width * sizeof(uint16_t);
+            for (uint32_t y = 0; y < in_plane.height; y++) {
+                auto* in_row = input.data() + (p * in_plane.height + y) * in_plane.row_stride;
+                auto* out_row = output.data() + (p * out_plane.height + y) * out_plane.row_stride;
+                ASSERT_EQ(0, memcmp(in_row, out_row, row_size)) << "plane " << p << " row " << y;
+            }
+        }
+    }
+
+    nvimgcodecEncodeParams_t encode_params_;
+    nvimgcodecNvTensorEncodeParams_t nvtensor_params_;
+    nvimgcodecDecodeParams_t decode_params_;
+    OutputBuffer encoded_;
+};
+
+TEST_F(NvTensorExtTest, ZstdRoundTrip)
+{
+    TestRoundTrip(0, 0);
+}
+
+TEST_F(NvTensorExtTest, ZstdRoundTripPaddedRows)
+{
+    TestRoundTrip(10, 6);
+}
+
+TEST_F(NvTensorExtTest, UncompressedRoundTrip)
+{
+    nvtensor_params_.compression = NVIMGCODEC_NVTENSOR_COMPRESSION_NONE;
+    TestRoundTrip(0, 0);
+    size_t payload_offset = nvtensor::LoadLE<uint32_t>(encoded_.data.data() + 12);
+    EXPECT_EQ(0u, payload_offset % nvtensor::kPayloadAlignment);
+    EXPECT_EQ(payload_offset + 3 * 123 * 77 * sizeof(uint16_t), encoded_.data.size());
+}
+
+TEST_F(NvTensorExtTest, UncompressedRoundTripPaddedRows)
+{
+    nvtensor_params_.compression = NVIMGCODEC_NVTENSOR_COMPRESSION_NONE;
+    TestRoundTrip(4, 2);
+}
+
+TEST_F(NvTensorExtTest, DefaultParams)
+{
+    encode_params_.struct_next = nullptr;
+    TestRoundTrip(0, 0);
+    EXPECT_EQ(NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD, nvtensor::LoadLE<uint32_t>(encoded_.data.data() + 16));
+}
+
+TEST_F(NvTensorExtTest, MismatchedOutputIsNotDecoded)
+{
+    std::vector<unsigned char> input;
+    auto in_info = MakeImageInfo(input, 0);
+    Encode(in_info);
+
+    std::vector<unsigned char> output;
+    auto out_info = MakeImageInfo(output, 0);
+    for (uint32_t p = 0; p < out_info.num_planes; p++)
+        out_info.plane_info[p].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8;
+    Decode(out_info, NVIMGCODEC_PROCESSING_STATUS_SAMPLE_TYPE_UNSUPPORTED);
+}
+
+}} // namespace nvimgcodec::test
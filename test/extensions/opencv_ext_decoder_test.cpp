@@ -285,4 +285,22 @@ TEST_F(OpenCVExtDecoderTest, TIFF_SingleImage_Grayscale)
     TestSingleImage("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_P_Y);
 }
 
+TEST_F(OpenCVExtDecoderTest, TIFF_PyramidLevelUnsupported)
+{
+    // OpenCV only decodes the full resolution image, which would not fit an output sized for a reduced level
+    nvimgcodecTiffDecodeParams_t tiff_params{NVIMGCODEC_STRUCTURE_TYPE_TIFF_DECODE_PARAMS, sizeof(nvimgcodecTiffDecodeParams_t), nullptr};
+    params_.struct_next = &tiff_params;
+    for (int level : {1, NVIMGCODEC_TIFF_LEVEL_AUTO}) {
+        tiff_params.level = level;
+        TestNotSupported("tiff/cat-1245673_640.tiff", NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8,
+            NVIMGCODEC_PROCESSING_STATUS_CODESTREAM_UNSUPPORTED);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future_));
+        future_ = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image_));
+        image_ = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(in_code_stream_));
+        in_code_stream_ = nullptr;
+    }
+}
+
 }} // namespace nvimgcodec::test
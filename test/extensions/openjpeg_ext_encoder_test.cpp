@@ -0,0 +1,204 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/openjpeg/openjpeg_ext.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <openjpeg.h>
+#include <parsers/jpeg2k.h>
+#include <parsers/parser_test_utils.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+class OpenjpegExtEncoderTest : public CpuCodecExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        SetUpCodec(get_jpeg2k_parser_extension_desc, get_openjpeg_extension_desc, false);
+        SetUpImageInfo(123, 77, NVIMGCODEC_SAMPLEFORMAT_I_RGB, NVIMGCODEC_SAMPLING_444);
+
+        params_ = {NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+        jpeg2k_params_ = {NVIMGCODEC_STRUCTURE_TYPE_JPEG2K_ENCODE_PARAMS, sizeof(nvimgcodecJpeg2kEncodeParams_t), 0};
+        jpeg2k_params_.stream_type = NVIMGCODEC_JPEG2K_STREAM_JP2;
+        jpeg2k_params_.prog_order = NVIMGCODEC_JPEG2K_PROG_ORDER_RPCL;
+        jpeg2k_params_.num_resolutions = 4;
+        jpeg2k_params_.code_block_w = 32;
+        jpeg2k_params_.code_block_h = 32;
+        jpeg2k_params_.irreversible = 0;
+        params_.struct_next = &jpeg2k_params_;
+    }
+
+    void TearDown() override { CpuCodecExtensionTestBase::TearDown(); }
+
+    void PrepareImage()
+    {
+        PrepareImageForFormat();
+        for (size_t i = 0; i < image_buffer_.size(); i++)
+            image_buffer_[i] = static_cast<unsigned char>(i * 7 % 251);
+    }
+
+    void EncodeBatch(int batch_size) { CpuCodecExtensionTestBase::EncodeBatch("jpeg2k", batch_size, &params_); }
+
+    void CheckImageInfo(const std::vector<unsigned char>& data)
+    {
+        nvimgcodecCodeStream_t code_stream;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &code_stream, data.data(), data.size()));
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(code_stream, &info));
+        EXPECT_STREQ("jpeg2k", info.codec_name);
+        EXPECT_EQ(image_info_.plane_info[0].width, info.plane_info[0].width);
+        EXPECT_EQ(image_info_.plane_info[0].height, info.plane_info[0].height);
+        EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(code_stream));
+    }
+
+    struct MemoryReader
+    {
+        const std::vector<unsigned char>* data;
+        size_t pos;
+
+        static OPJ_SIZE_T read(void* buffer, OPJ_SIZE_T nbytes, void* user_data)
+        {
+            auto* reader = static_cast<MemoryReader*>(user_data);
+            size_t n = std::min(nbytes, reader->data->size() - reader->pos);
+            if (n == 0)
+                return static_cast<OPJ_SIZE_T>(-1);
+            memcpy(buffer, reader->data->data() + reader->pos, n);
+            reader->pos += n;
+            return n;
+        }
+        static OPJ_OFF_T skip(OPJ_OFF_T nbytes, void* user_data)
+        {
+            auto* reader = static_cast<MemoryReader*>(user_data);
+            nbytes = std::min<OPJ_OFF_T>(nbytes, reader->data->size() - reader->pos);
+            reader->pos += nbytes;
+            return nbytes;
+        }
+        static OPJ_BOOL seek(OPJ_OFF_T offset, void* user_data)
+        {
+            auto* reader = static_cast<MemoryReader*>(user_data);
+            if (offset < 0 || static_cast<size_t>(offset) > reader->data->size())
+                return OPJ_FALSE;
+            reader->pos = offset;
+            return OPJ_TRUE;
+        }
+    };
+
+    // Decodes the code stream with OpenJPEG to planar samples
+    std::vector<unsigned char> DecodePlanar(const std::vector<unsigned char>& data, OPJ_CODEC_FORMAT format)
+    {
+        std::vector<unsigned char> planar;
+        MemoryReader reader{&data, 0};
+        opj_stream_t* stream = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, OPJ_TRUE);
+        opj_stream_set_user_data(stream, &reader, nullptr);
+        opj_stream_set_user_data_length(stream, data.size());
+        opj_stream_set_read_function(stream, MemoryReader::read);
+        opj_stream_set_skip_function(stream, MemoryReader::skip);
+        opj_stream_set_seek_function(stream, MemoryReader::seek);
+        opj_codec_t* codec = opj_create_decompress(format);
+        opj_dparameters_t dparams;
+        opj_set_default_decoder_parameters(&dparams);
+        opj_image_t* image = nullptr;
+        if (opj_setup_decoder(codec, &dparams) && opj_read_header(stream, codec, &image) && opj_decode(codec, stream, image) &&
+            opj_end_decompress(codec, stream)) {
+            for (uint32_t c = 0; c < image->numcomps; c++) {
+                auto& comp = image->comps[c];
+                for (size_t i = 0; i < static_cast<size_t>(comp.w) * comp.h; i++)
+                    planar.push_back(static_cast<unsigned char>(comp.data[i]));
+            }
+        } else {
+            ADD_FAILURE() << "Could not decode jpeg2k code stream";
+        }
+        if (image)
+            opj_image_destroy(image);
+        opj_destroy_codec(codec);
+        opj_stream_destroy(stream);
+        return planar;
+    }
+
+    nvimgcodecEncodeParams_t params_;
+    nvimgcodecJpeg2kEncodeParams_t jpeg2k_params_;
+};
+
+TEST_F(OpenjpegExtEncoderTest, EncodeLosslessRGB)
+{
+    PrepareImage();
+    EncodeBatch(1);
+    CheckImageInfo(outputs_[0].data);
+    Convert_I_RGB_to_P_RGB();
+    EXPECT_EQ(planar_out_buffer_, DecodePlanar(outputs_[0].data, OPJ_CODEC_JP2));
+}
+
+TEST_F(OpenjpegExtEncoderTest, EncodeLosslessGrayToJ2K)
+{
+    sample_format_ = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    color_spec_ = NVIMGCODEC_COLORSPEC_GRAY;
+    chroma_subsampling_ = NVIMGCODEC_SAMPLING_GRAY;
+    jpeg2k_params_.stream_type = NVIMGCODEC_JPEG2K_STREAM_J2K;
+    PrepareImage();
+    EncodeBatch(1);
+    const unsigned char soc_siz[] = {0xFF, 0x4F, 0xFF, 0x51};
+    ASSERT_GT(outputs_[0].data.size(), sizeof(soc_siz));
+    EXPECT_EQ(0, memcmp(outputs_[0].data.data(), soc_siz, sizeof(soc_siz)));
+    CheckImageInfo(outputs_[0].data);
+    EXPECT_EQ(image_buffer_, DecodePlanar(outputs_[0].data, OPJ_CODEC_J2K));
+}
+
+TEST_F(OpenjpegExtEncoderTest, IrreversibleWithTargetPsnrIsSmaller)
+{
+    PrepareImage();
+    EncodeBatch(1);
+    auto lossless_size = outputs_[0].data.size();
+    jpeg2k_params_.irreversible = 1;
+    params_.target_psnr = 30;
+    EncodeBatch(1);
+    CheckImageInfo(outputs_[0].data);
+    EXPECT_LT(outputs_[0].data.size(), lossless_size);
+}
+
+TEST_F(OpenjpegExtEncoderTest, EncodeBatch)
+{
+    // Samples are encoded concurrently, each to its own output
+    PrepareImage();
+    EncodeBatch(5);
+    for (auto& output : outputs_) {
+        CheckImageInfo(output.data);
+        EXPECT_EQ(outputs_[0].data, output.data);
+    }
+}
+
+TEST_F(OpenjpegExtEncoderTest, InvalidCodeBlockSizeIsUnsupported)
+{
+    jpeg2k_params_.code_block_w = 16;
+    PrepareImage();
+    nvimgcodecImageInfo_t cs_image_info(image_info_);
+    strcpy(cs_image_info.codec_name, "jpeg2k");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &in_image_, &image_info_));
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_code_stream_, (void*)this,
+                                             &OpenjpegExtEncoderTest::ResizeBufferStatic<OpenjpegExtEncoderTest>, &cs_image_info));
+    nvimgcodecProcessingStatus_t status;
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCanEncode(encoder_, &in_image_, &out_code_stream_, 1, &params_, &status, true));
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_ENCODING_UNSUPPORTED, status);
+}
+
+}} // namespace nvimgcodec::test
@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <extensions/nvbmp/nvbmp_ext.h>
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <parsers/bmp.h>
+#include <parsers/parser_test_utils.h>
+#include <cstring>
+#include <vector>
+
+#include "common.h"
+#include "nvimgcodec_tests.h"
+
+namespace nvimgcodec { namespace test {
+
+class TranscodeTest : public ExtensionTestBase, public ::testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        ExtensionTestBase::SetUp();
+
+        nvimgcodecExtensionDesc_t bmp_parser_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_bmp_parser_extension_desc(&bmp_parser_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &bmp_parser_extension_, &bmp_parser_extension_desc));
+
+        nvimgcodecExtensionDesc_t nvbmp_extension_desc{NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC, sizeof(nvimgcodecExtensionDesc_t), 0};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_nvbmp_extension_desc(&nvbmp_extension_desc));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionCreate(instance_, &nvbmp_extension_, &nvbmp_extension_desc));
+
+        nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), 0};
+        exec_params.device_id = NVIMGCODEC_DEVICE_CPU_ONLY;
+        exec_params.max_num_cpu_threads = 4;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderCreate(instance_, &encoder_, &exec_params, nullptr));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderCreate(instance_, &decoder_, &exec_params, nullptr));
+
+        decode_params_ = {NVIMGCODEC_STRUCTURE_TYPE_DECODE_PARAMS, sizeof(nvimgcodecDecodeParams_t), 0};
+        encode_params_ = {NVIMGCODEC_STRUCTURE_TYPE_ENCODE_PARAMS, sizeof(nvimgcodecEncodeParams_t), 0};
+    }
+
+    void TearDown() override
+    {
+        for (auto cs : in_streams_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(cs));
+        for (auto cs : out_streams_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(cs));
+        if (decoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecDecoderDestroy(decoder_));
+        if (encoder_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderDestroy(encoder_));
+        ExtensionTestBase::TearDownCodecResources();
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(nvbmp_extension_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecExtensionDestroy(bmp_parser_extension_));
+        ExtensionTestBase::TearDown();
+    }
+
+    struct OutputBuffer
+    {
+        static unsigned char* ResizeBufferStatic(void* ctx, size_t bytes)
+        {
+            auto handle = reinterpret_cast<OutputBuffer*>(ctx);
+            handle->data.resize(bytes);
+            return handle->data.data();
+        }
+        std::vector<unsigned char> data;
+    };
+
+    // Encodes a random planar RGB image to a bmp code stream
+    void EncodeRandomImage(uint32_t width, uint32_t height, OutputBuffer* output)
+    {
+        image_info_ = {NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        image_info_.plane_info[0].width = width;
+        image_info_.plane_info[0].height = height;
+        sample_format_ = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+        color_spec_ = NVIMGCODEC_COLORSPEC_SRGB;
+        chroma_subsampling_ = NVIMGCODEC_SAMPLING_NONE;
+        PrepareImageForFormat();
+        for (auto& v : image_buffer_)
+            v = rand() % 255;
+
+        nvimgcodecImageInfo_t cs_image_info(image_info_);
+        strcpy(cs_image_info.codec_name, "bmp");
+        nvimgcodecImage_t image;
+        nvimgcodecCodeStream_t code_stream;
+        nvimgcodecFuture_t future;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageCreate(instance_, &image, &image_info_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS,
+            nvimgcodecCodeStreamCreateToHostMem(instance_, &code_stream, (void*)output, &OutputBuffer::ResizeBufferStatic, &cs_image_info));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecEncoderEncode(encoder_, &image, &code_stream, 1, &encode_params_, &future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future));
+        size_t status_size;
+        nvimgcodecProcessingStatus_t status;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future, &status, &status_size));
+        ASSERT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureDestroy(future));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(code_stream));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecImageDestroy(image));
+    }
+
+    void TestTranscode(const nvimgcodecTranscodeParams_t* transcode_params)
+    {
+        const std::vector<std::pair<uint32_t, uint32_t>> sizes = {{64, 48}, {33, 17}, {128, 96}, {7, 5}, {96, 128}, {64, 48}};
+        const int batch_size = sizes.size();
+        std::vector<OutputBuffer> inputs(batch_size);
+        std::vector<OutputBuffer> outputs(batch_size);
+        srand(4771);
+        for (int i = 0; i < batch_size; i++)
+            EncodeRandomImage(sizes[i].first, sizes[i].second, &inputs[i]);
+
+        in_streams_.resize(batch_size, nullptr);
+        out_streams_.resize(batch_size, nullptr);
+        for (int i = 0; i < batch_size; i++) {
+            LoadImageFromHostMemory(instance_, in_streams_[i], inputs[i].data.data(), inputs[i].data.size());
+            nvimgcodecImageInfo_t cs_image_info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(in_streams_[i], &cs_image_info));
+            strcpy(cs_image_info.codec_name, "bmp");
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateToHostMem(instance_, &out_streams_[i], (void*)&outputs[i],
+                                                     &OutputBuffer::ResizeBufferStatic, &cs_image_info));
+        }
+
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecTranscode(decoder_, encoder_, in_streams_.data(), out_streams_.data(), batch_size,
+                                                 &decode_params_, &encode_params_, transcode_params, &future_));
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureWaitForAll(future_));
+        size_t status_size;
+        std::vector<nvimgcodecProcessingStatus_t> status(batch_size);
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecFutureGetProcessingStatus(future_, status.data(), &status_size));
+        ASSERT_EQ(static_cast<size_t>(batch_size), status_size);
+        for (int i = 0; i < batch_size; i++) {
+            EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_SUCCESS, status[i]) << "sample #" << i;
+            // bmp is lossless, so going through the same encoder again gives the same code stream
+            EXPECT_EQ(inputs[i].data, outputs[i].data) << "sample #" << i;
+        }
+    }
+
+    nvimgcodecExtension_t bmp_parser_extension_;
+    nvimgcodecExtension_t nvbmp_extension_;
+    nvimgcodecEncoder_t encoder_ = nullptr;
+    nvimgcodecDecoder_t decoder_ = nullptr;
+    nvimgcodecDecodeParams_t decode_params_;
+    nvimgcodecEncodeParams_t encode_params_;
+    std::vector<nvimgcodecCodeStream_t> in_streams_;
+    std::vector<nvimgcodecCodeStream_t> out_streams_;
+};
+
+TEST_F(TranscodeTest, DefaultParams)
+{
+    nvimgcodecTranscodeParams_t transcode_params{NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS, sizeof(nvimgcodecTranscodeParams_t), 0};
+    TestTranscode(&transcode_params);
+}
+
+TEST_F(TranscodeTest, NullParams)
+{
+    TestTranscode(nullptr);
+}
+
+TEST_F(TranscodeTest, InFlightMemoryLimitedToSingleSample)
+{
+    // Every sample has to wait for the previous one to be encoded and reuse or replace its buffer
+    nvimgcodecTranscodeParams_t transcode_params{NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS, sizeof(nvimgcodecTranscodeParams_t), 0};
+    transcode_params.max_in_flight_bytes = 1;
+    TestTranscode(&transcode_params);
+}
+
+TEST_F(TranscodeTest, InFlightMemoryLimitedToFewSamples)
+{
+    nvimgcodecTranscodeParams_t transcode_params{NVIMGCODEC_STRUCTURE_TYPE_TRANSCODE_PARAMS, sizeof(nvimgcodecTranscodeParams_t), 0};
+    transcode_params.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+    transcode_params.buffer_kind = NVIMGCODEC_IMAGE_BUFFER_KIND_STRIDED_HOST;
+    transcode_params.max_in_flight_bytes = 2 * 128 * 96 * 3;
+    TestTranscode(&transcode_params);
+}
+
+}} // namespace nvimgcodec::test
@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include "../extensions/utils/host_allocator.h"
+#include "../extensions/utils/scratch.h"
+#include "../src/nvimgcodec_type_utils.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+struct CountingAllocator
+{
+    std::map<void*, size_t> live;
+    int num_allocations = 0;
+
+    static int Malloc(void* ctx, void** ptr, size_t size, size_t alignment)
+    {
+        auto* self = static_cast<CountingAllocator*>(ctx);
+        *ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (!*ptr)
+            return 1;
+        self->live[*ptr] = size;
+        self->num_allocations++;
+        return 0;
+    }
+
+    static int Free(void* ctx, void* ptr, size_t size)
+    {
+        auto* self = static_cast<CountingAllocator*>(ctx);
+        EXPECT_EQ(self->live.at(ptr), size);
+        self->live.erase(ptr);
+        std::free(ptr);
+        return 0;
+    }
+
+    nvimgcodecHostAllocator_t desc()
+    {
+        return {NVIMGCODEC_STRUCTURE_TYPE_HOST_ALLOCATOR, sizeof(nvimgcodecHostAllocator_t), nullptr, Malloc, Free, this};
+    }
+};
+
+} // namespace
+
+TEST(HostAllocator, FoundOnlyIfCompleteAndInsideStruct)
+{
+    CountingAllocator counting;
+    auto desc = counting.desc();
+    nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), nullptr};
+    exec_params.host_allocator = &desc;
+    EXPECT_EQ(&desc, GetHostAllocator(&exec_params));
+
+    exec_params.struct_size = offsetof(nvimgcodecExecutionParams_t, host_allocator);
+    EXPECT_EQ(nullptr, GetHostAllocator(&exec_params));
+
+    exec_params.struct_size = sizeof(nvimgcodecExecutionParams_t);
+    desc.host_free = nullptr;
+    EXPECT_EQ(nullptr, GetHostAllocator(&exec_params));
+    EXPECT_EQ(nullptr, GetHostAllocator(nullptr));
+}
+
+TEST(HostAllocator, NotCopiedFromOlderExecutionParams)
+{
+    CountingAllocator counting;
+    auto desc = counting.desc();
+    nvimgcodecExecutionParams_t exec_params{NVIMGCODEC_STRUCTURE_TYPE_EXECUTION_PARAMS, sizeof(nvimgcodecExecutionParams_t), nullptr};
+    exec_params.max_num_cpu_threads = 3;
+    exec_params.host_allocator = &desc;
+    exec_params.struct_size = offsetof(nvimgcodecExecutionParams_t, host_allocator);
+    auto copy = copy_execution_params(&exec_params);
+    EXPECT_EQ(sizeof(nvimgcodecExecutionParams_t), copy.struct_size);
+    EXPECT_EQ(3, copy.max_num_cpu_threads);
+    EXPECT_EQ(nullptr, copy.host_allocator);
+    EXPECT_EQ(nullptr, GetHostAllocator(&copy));
+
+    exec_params.struct_size = sizeof(nvimgcodecExecutionParams_t);
+    EXPECT_EQ(&desc, copy_execution_params(&exec_params).host_allocator);
+}
+
+TEST(HostAllocator, ContainerAllocationsGoThroughIt)
+{
+    CountingAllocator counting;
+    auto desc = counting.desc();
+    {
+        std::vector<unsigned char, HostAllocator<unsigned char>> buffer{HostAllocator<unsigned char>(&desc)};
+        buffer.resize(1000);
+        EXPECT_EQ(1u, counting.live.size());
+        buffer.resize(5000);
+    }
+    EXPECT_EQ(2, counting.num_allocations);
+    EXPECT_TRUE(counting.live.empty());
+
+    std::vector<int, HostAllocator<int>> fallback;
+    fallback.resize(100);
+    EXPECT_EQ(2, counting.num_allocations);
+}
+
+TEST(HostAllocator, MovesAlongWithTheMemory)
+{
+    CountingAllocator counting;
+    auto desc = counting.desc();
+    std::vector<unsigned char, HostAllocator<unsigned char>> buffer;
+    buffer = std::vector<unsigned char, HostAllocator<unsigned char>>(1000, 0, HostAllocator<unsigned char>(&desc));
+    EXPECT_EQ(&desc, buffer.get_allocator().hostAllocator());
+    EXPECT_EQ(1, counting.num_allocations);
+    buffer = std::vector<unsigned char, HostAllocator<unsigned char>>();
+    EXPECT_TRUE(counting.live.empty());
+    EXPECT_EQ(nullptr, buffer.get_allocator().hostAllocator());
+}
+
+TEST(HostAllocator, ScratchScopeReturnsMemoryAtEnd)
+{
+    CountingAllocator counting;
+    auto desc = counting.desc();
+    nvimgcodecFrameworkDesc_t framework{NVIMGCODEC_STRUCTURE_TYPE_FRAMEWORK_DESC, sizeof(nvimgcodecFrameworkDesc_t), nullptr};
+    {
+        ScratchScope scratch(&framework, &desc);
+        auto* a = scratch.allocate<uint16_t>(100);
+        auto* b = scratch.allocateBytes(64, 64);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a) % alignof(uint16_t));
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 64);
+        EXPECT_EQ(2u, counting.live.size());
+    }
+    EXPECT_TRUE(counting.live.empty());
+}
+
+}} // namespace nvimgcodec::test
@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace nvimgcodec { namespace test {
+
+inline void PutBE16(std::vector<uint8_t>& out, uint16_t value)
+{
+    out.push_back(value >> 8);
+    out.push_back(value & 0xFF);
+}
+
+inline void PutBE32(std::vector<uint8_t>& out, uint32_t value)
+{
+    for (int i = 3; i >= 0; i--)
+        out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+inline void PutTag(std::vector<uint8_t>& out, const char* signature)
+{
+    out.insert(out.end(), signature, signature + 4);
+}
+
+inline void PutS15Fixed16(std::vector<uint8_t>& out, double value)
+{
+    PutBE32(out, static_cast<uint32_t>(static_cast<int32_t>(std::lround(value * 65536))));
+}
+
+// Builds an RGB matrix/TRC profile with sRGB primaries, whose channels share the given tone curve tag
+inline std::vector<uint8_t> MakeRgbProfile(const std::vector<uint8_t>& curve)
+{
+    const double colorants[3][3] = {{0.4360747, 0.2225045, 0.0139322}, {0.3850649, 0.7168786, 0.0971045}, {0.1430804, 0.0606169, 0.7141733}};
+    const char* xyz_tags[3] = {"rXYZ", "gXYZ", "bXYZ"};
+    const char* trc_tags[3] = {"rTRC", "gTRC", "bTRC"};
+    constexpr uint32_t tags_offset = 128 + 4 + 6 * 12;
+
+    std::vector<uint8_t> xyz_data;
+    for (int c = 0; c < 3; c++) {
+        PutTag(xyz_data, "XYZ ");
+        PutBE32(xyz_data, 0);
+        for (int i = 0; i < 3; i++)
+            PutS15Fixed16(xyz_data, colorants[c][i]);
+    }
+
+    std::vector<uint8_t> profile(128, 0);
+    PutBE32(profile, 6);
+    for (int c = 0; c < 3; c++) {
+        PutTag(profile, xyz_tags[c]);
+        PutBE32(profile, tags_offset + 20 * c);
+        PutBE32(profile, 20);
+    }
+    for (int c = 0; c < 3; c++) {
+        PutTag(profile, trc_tags[c]);
+        PutBE32(profile, tags_offset + xyz_data.size());
+        PutBE32(profile, curve.size());
+    }
+    profile.insert(profile.end(), xyz_data.begin(), xyz_data.end());
+    profile.insert(profile.end(), curve.begin(), curve.end());
+
+    std::vector<uint8_t> header;
+    PutBE32(header, profile.size());
+    std::copy(header.begin(), header.end(), profile.begin());
+    memcpy(&profile[12], "mntr", 4);
+    memcpy(&profile[16], "RGB ", 4);
+    memcpy(&profile[20], "XYZ ", 4);
+    memcpy(&profile[36], "acsp", 4);
+    return profile;
+}
+
+inline std::vector<uint8_t> MakeGammaCurve(double gamma)
+{
+    std::vector<uint8_t> curve;
+    PutTag(curve, "curv");
+    PutBE32(curve, 0);
+    PutBE32(curve, 1);
+    PutBE16(curve, static_cast<uint16_t>(gamma * 256));
+    return curve;
+}
+
+inline std::vector<uint8_t> MakeSrgbCurve()
+{
+    std::vector<uint8_t> curve;
+    PutTag(curve, "para");
+    PutBE32(curve, 0);
+    PutBE16(curve, 3);
+    PutBE16(curve, 0);
+    for (double param : {2.4, 1 / 1.055, 0.055 / 1.055, 1 / 12.92, 0.04045})
+        PutS15Fixed16(curve, param);
+    return curve;
+}
+
+inline double SrgbEncode(double linear)
+{
+    return linear <= 0.0031308 ? 12.92 * linear : 1.055 * std::pow(linear, 1 / 2.4) - 0.055;
+}
+
+}} // namespace nvimgcodec::test
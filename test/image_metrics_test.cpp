@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "../extensions/utils/image_metrics.h"
+
+namespace nvimgcodec { namespace test {
+
+namespace {
+
+std::vector<uint8_t> RandomImage(int width, int height, int components, unsigned seed)
+{
+    std::vector<uint8_t> image(static_cast<size_t>(width) * height * components);
+    srand(seed);
+    for (auto& v : image)
+        v = rand() % 256;
+    return image;
+}
+
+// Smooth gradient, so that small perturbations keep the structure
+std::vector<uint8_t> GradientImage(int width, int height)
+{
+    std::vector<uint8_t> image(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            image[y * width + x] = static_cast<uint8_t>((x * 3 + y * 2) % 256);
+    return image;
+}
+
+double UniformSsim(double mu_a, double mu_b)
+{
+    constexpr double C1 = (0.01 * 255) * (0.01 * 255);
+    return (2 * mu_a * mu_b + C1) / (mu_a * mu_a + mu_b * mu_b + C1);
+}
+
+} // namespace
+
+TEST(ImageMetricsTest, PsnrOfIdenticalImagesIsInfinite)
+{
+    auto image = RandomImage(37, 21, 3, 1);
+    EXPECT_TRUE(std::isinf(ComputePsnr(image.data(), 37 * 3, image.data(), 37 * 3, 37, 21, 3)));
+}
+
+TEST(ImageMetricsTest, PsnrOfUnitError)
+{
+    std::vector<uint8_t> a(64 * 64, 100), b(64 * 64, 101);
+    EXPECT_NEAR(10.0 * std::log10(255.0 * 255.0), ComputePsnr(a.data(), 64, b.data(), 64, 64, 64, 1), 1e-9);
+}
+
+TEST(ImageMetricsTest, SsimOfIdenticalImagesIsOne)
+{
+    // Sizes which are not multiple of the window leave partial windows at the right and bottom edges
+    for (int components : {1, 3}) {
+        auto image = RandomImage(29, 13, components, 2);
+        size_t stride = 29 * components;
+        EXPECT_DOUBLE_EQ(1.0, ComputeSsim(image.data(), stride, image.data(), stride, 29, 13, components));
+    }
+}
+
+TEST(ImageMetricsTest, SsimOfUniformImages)
+{
+    // Without variance, only the luminance term is left
+    std::vector<uint8_t> a(16 * 16, 100), b(16 * 16, 110);
+    EXPECT_NEAR(UniformSsim(100, 110), ComputeSsim(a.data(), 16, b.data(), 16, 16, 16, 1), 1e-12);
+    EXPECT_NEAR(UniformSsim(100, 110), ComputeSsim(b.data(), 16, a.data(), 16, 16, 16, 1), 1e-12);
+}
+
+TEST(ImageMetricsTest, SsimDecreasesWithDistortion)
+{
+    const int width = 64, height = 48;
+    auto ref = GradientImage(width, height);
+    auto noise = RandomImage(width, height, 1, 3);
+    std::vector<uint8_t> slight(ref.size()), strong(ref.size());
+    for (size_t i = 0; i < ref.size(); i++) {
+        slight[i] = static_cast<uint8_t>(std::clamp(ref[i] + noise[i] % 5 - 2, 0, 255));
+        strong[i] = static_cast<uint8_t>(std::clamp(ref[i] + noise[i] % 61 - 30, 0, 255));
+    }
+    double ssim_slight = ComputeSsim(ref.data(), width, slight.data(), width, width, height, 1);
+    double ssim_strong = ComputeSsim(ref.data(), width, strong.data(), width, width, height, 1);
+    double ssim_unrelated = ComputeSsim(ref.data(), width, noise.data(), width, width, height, 1);
+    EXPECT_GT(ssim_slight, 0.9);
+    EXPECT_LT(ssim_slight, 1.0);
+    EXPECT_LT(ssim_strong, ssim_slight);
+    EXPECT_LT(ssim_unrelated, ssim_strong);
+    EXPECT_LT(ssim_unrelated, 0.1);
+}
+
+TEST(ImageMetricsTest, SsimOfGrayRgbMatchesLuma)
+{
+    const int width = 24, height = 20;
+    auto a = GradientImage(width, height);
+    auto b = RandomImage(width, height, 1, 4);
+    std::vector<uint8_t> a_rgb(a.size() * 3), b_rgb(b.size() * 3);
+    for (size_t i = 0; i < a.size(); i++) {
+        for (int c = 0; c < 3; c++) {
+            a_rgb[i * 3 + c] = a[i];
+            b_rgb[i * 3 + c] = b[i];
+        }
+    }
+    EXPECT_DOUBLE_EQ(ComputeSsim(a.data(), width, b.data(), width, width, height, 1),
+        ComputeSsim(a_rgb.data(), width * 3, b_rgb.data(), width * 3, width, height, 3));
+}
+
+TEST(ImageMetricsTest, SsimHonorsRowStride)
+{
+    const int width = 20, height = 18, padded_stride = 32;
+    auto a = GradientImage(width, height);
+    auto b = RandomImage(width, height, 1, 5);
+    std::vector<uint8_t> a_padded(padded_stride * height, 255);
+    for (int y = 0; y < height; y++)
+        std::copy(&a[y * width], &a[y * width] + width, &a_padded[y * padded_stride]);
+    EXPECT_DOUBLE_EQ(ComputeSsim(a.data(), width, b.data(), width, width, height, 1),
+        ComputeSsim(a_padded.data(), padded_stride, b.data(), width, width, height, 1));
+}
+
+}} // namespace nvimgcodec::test
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../src/mapped_image_buffer.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace nvimgcodec { namespace test {
+
+TEST(MappedImageBuffer, WritesReachFile)
+{
+    auto path = std::filesystem::temp_directory_path() / "nvimgcodec_mapped_image_buffer_test.raw";
+    const size_t size = 3 * 64 * 48;
+    {
+        MappedImageBuffer buffer(path.string(), size);
+        ASSERT_NE(nullptr, buffer.data());
+        ASSERT_EQ(size, buffer.size());
+        auto ptr = static_cast<unsigned char*>(buffer.data());
+        for (size_t i = 0; i < size; i++)
+            ptr[i] = static_cast<unsigned char>(i % 251);
+        buffer.sync();
+        ASSERT_EQ(size, std::filesystem::file_size(path));
+    }
+
+    std::ifstream f(path, std::ios::binary);
+    std::vector<unsigned char> content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::filesystem::remove(path);
+    ASSERT_EQ(size, content.size());
+    for (size_t i = 0; i < size; i++)
+        ASSERT_EQ(static_cast<unsigned char>(i % 251), content[i]);
+}
+
+TEST(MappedImageBuffer, ThrowsOnInvalidPath)
+{
+    EXPECT_THROW(MappedImageBuffer("/nonexistent_dir/nvimgcodec_mapped.raw", 16), std::runtime_error);
+}
+
+}} // namespace nvimgcodec::test
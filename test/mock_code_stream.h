@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../src/icode_stream.h"
+
+namespace nvimgcodec { namespace test {
+
+class MockCodeStream : public ICodeStream
+{
+  public:
+    MOCK_METHOD(void, parseFromFile, (const std::string& file_name), (override));
+    MOCK_METHOD(void, parseFromMem, (const unsigned char* data, size_t size), (override));
+    MOCK_METHOD(void, setOutputToFile, (const char* file_name), (override));
+    MOCK_METHOD(void, setOutputToHostMem, (void* ctx, nvimgcodecResizeBufferFunc_t get_buffer_func), (override));
+    MOCK_METHOD(nvimgcodecStatus_t, getImageInfo, (nvimgcodecImageInfo_t* image_info), (override));
+    MOCK_METHOD(nvimgcodecStatus_t, setImageInfo, (const nvimgcodecImageInfo_t* image_info), (override));
+    MOCK_METHOD(const std::vector<uint8_t>&, getIccProfile, (), (override));
+    MOCK_METHOD(std::string, getCodecName, (), (const, override));
+    MOCK_METHOD(ICodec*, getCodec, (), (const, override));
+    MOCK_METHOD(nvimgcodecIoStreamDesc_t*, getInputStreamDesc, (), (override));
+    MOCK_METHOD(nvimgcodecCodeStreamDesc_t*, getCodeStreamDesc, (), (override));
+};
+
+}} // namespace nvimgcodec::test
@@ -50,6 +50,10 @@ class MockCodec : public ICodec
     MOCK_METHOD(void, registerParserFactory,
         (std::unique_ptr<IImageParserFactory> factory, float priority), (override));
     MOCK_METHOD(void, unregisterParserFactory, (const std::string parser_id) ,(override));
+    MOCK_METHOD(int, getTransformersNum, (), (const, override));
+    MOCK_METHOD(const nvimgcodecTransformerDesc_t*, getTransformerDesc, (int index), (const, override));
+    MOCK_METHOD(void, registerTransformer, (const nvimgcodecTransformerDesc_t* desc, float priority), (override));
+    MOCK_METHOD(void, unregisterTransformer, (const std::string transformer_id), (override));
 };
 
 }} // namespace nvimgcodec::test
\ No newline at end of file
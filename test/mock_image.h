@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <nvimgcodec.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../src/iimage.h"
+#include "../src/processing_results.h"
+
+namespace nvimgcodec { namespace test {
+
+class MockImage : public IImage
+{
+  public:
+    MOCK_METHOD(void, setIndex, (int index), (override));
+    MOCK_METHOD(void, setImageInfo, (const nvimgcodecImageInfo_t* image_info), (override));
+    MOCK_METHOD(void, getImageInfo, (nvimgcodecImageInfo_t* image_info), (override));
+    MOCK_METHOD(nvimgcodecImageDesc_t*, getImageDesc, (), (override));
+    MOCK_METHOD(void, setPromise, (const ProcessingResultsPromise& promise), (override));
+};
+
+}} // namespace nvimgcodec::test
@@ -43,6 +43,7 @@ class MockImageDecoder : public IImageDecoder
     MOCK_METHOD(std::unique_ptr<ProcessingResultsFuture>, decode,
         (IDecodeState*, const std::vector<ICodeStream*>&, const std::vector<IImage*>&, const nvimgcodecDecodeParams_t*), (override));
     MOCK_METHOD(const char*, decoderId, (), (const, override));
+    MOCK_METHOD(bool, isCanDecodeMemoizable, (), (const, override));
 };
 
 
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+#include "../src/numa_topology.h"
+
+namespace nvimgcodec { namespace test {
+
+TEST(NumaTopology, ParseCpuList)
+{
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}), ParseCpuList("0-3,8,10-11\n"));
+    EXPECT_EQ(std::vector<int>({5}), ParseCpuList("5"));
+    EXPECT_TRUE(ParseCpuList("").empty());
+    EXPECT_TRUE(ParseCpuList("3-1").empty());
+    EXPECT_TRUE(ParseCpuList("0-").empty());
+    EXPECT_TRUE(ParseCpuList("a,b").empty());
+}
+
+TEST(NumaTopology, ReadNumaTopology)
+{
+    namespace fs = std::filesystem;
+    auto dir = fs::temp_directory_path() / "nvimgcodec_numa_topology_test";
+    fs::remove_all(dir);
+    auto add_node = [&dir](const char* name, const char* cpulist) {
+        fs::create_directories(dir / name);
+        std::ofstream(dir / name / "cpulist") << cpulist;
+    };
+    add_node("node10", "8-9\n");
+    add_node("node0", "0-3\n");
+    add_node("node1", "\n"); // Memory only node
+    add_node("nodes", "4\n");
+    std::ofstream(dir / "online") << "0-1,10\n";
+
+    auto nodes = ReadNumaTopology(dir.string());
+    fs::remove_all(dir);
+    ASSERT_EQ(2u, nodes.size());
+    EXPECT_EQ(0, nodes[0].id);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), nodes[0].cpus);
+    EXPECT_EQ(10, nodes[1].id);
+    EXPECT_EQ(std::vector<int>({8, 9}), nodes[1].cpus);
+
+    EXPECT_TRUE(ReadNumaTopology((dir / "missing").string()).empty());
+}
+
+TEST(NumaTopology, PartitionThreads)
+{
+    std::vector<NumaNode> nodes = {{0, {0, 1, 2, 3, 4, 5}}, {1, {6, 7}}};
+    EXPECT_EQ(std::vector<int>({6, 2}), PartitionThreads(nodes, 8));
+    EXPECT_EQ(std::vector<int>({3, 1}), PartitionThreads(nodes, 4));
+    EXPECT_EQ(std::vector<int>({1, 1}), PartitionThreads(nodes, 2));
+    EXPECT_TRUE(PartitionThreads(nodes, 1).empty());
+    for (int n = 2; n < 20; n++) {
+        auto threads = PartitionThreads(nodes, n);
+        EXPECT_EQ(n, std::accumulate(threads.begin(), threads.end(), 0));
+    }
+}
+
+TEST(NumaTopology, NodeSamples)
+{
+    NodeSamples node0{0, 3, 4}, node1{3, 1, 4};
+    EXPECT_TRUE(node0.contains(2));
+    EXPECT_TRUE(node1.contains(3));
+    EXPECT_TRUE(node0.contains(4));
+    EXPECT_TRUE(node1.contains(7));
+    EXPECT_FALSE(node0.contains(7));
+
+    // Batches place samples as they would be placed one at a time, each sample on exactly one node
+    for (int num_samples = 0; num_samples < 14; num_samples++) {
+        std::vector<int> node_of(num_samples, -1);
+        for (auto [n, node] : {std::pair{0, node0}, std::pair{1, node1}}) {
+            std::vector<int> expected;
+            for (int i = 0; i < num_samples; i++) {
+                if (node.contains(i))
+                    expected.push_back(i);
+            }
+            ASSERT_EQ(static_cast<int>(expected.size()), node.count(num_samples));
+            for (int t = 0; t < node.count(num_samples); t++) {
+                EXPECT_EQ(expected[t], node.sample(t));
+                EXPECT_EQ(-1, node_of[node.sample(t)]);
+                node_of[node.sample(t)] = n;
+            }
+        }
+        EXPECT_EQ(node_of.end(), std::find(node_of.begin(), node_of.end(), -1));
+    }
+}
+
+}} // namespace nvimgcodec::test
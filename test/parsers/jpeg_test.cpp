@@ -20,6 +20,8 @@
 #include "parsers/parser_test_utils.h"
 #include "nvimgcodec_tests.h"
 #include <nvimgcodec.h>
+#include <algorithm>
+#include <array>
 #include <string>
 #include <fstream>
 #include <vector>
@@ -33,6 +35,36 @@ static int NormalizeAngle(int degrees)
     return (degrees % 360 + 360) % 360;
 }
 
+// Builds the header of a baseline 4:2:0 JPEG whose tables are the IJG reference tables scaled to the given quality
+static std::vector<uint8_t> MakeJpegHeader(int quality, std::array<std::array<uint16_t, 64>, 2>* natural_tables)
+{
+    static const uint8_t zigzag[64] = {0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27,
+        20, 13, 6, 7, 14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46,
+        53, 60, 61, 54, 47, 55, 62, 63};
+    static const uint16_t reference[2][64] = {
+        {16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55, 14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80,
+            62, 18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92, 49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95,
+            98, 112, 100, 103, 99},
+        {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99, 24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99,
+            99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+            99, 99, 99}};
+    int scale = quality < 50 ? 5000 / quality : 200 - 2 * quality;
+    std::vector<uint8_t> header = {0xff, 0xd8, 0xff, 0xdb, 0x00, 2 + 2 * 65};
+    for (int t = 0; t < 2; t++) {
+        header.push_back(t);
+        for (int i = 0; i < 64; i++)
+            (*natural_tables)[t][i] = std::min(std::max((reference[t][i] * scale + 50) / 100, 1), 255);
+        for (int i = 0; i < 64; i++)
+            header.push_back((*natural_tables)[t][zigzag[i]]);
+    }
+    // SOF0: 8-bit, 16x16, Y 2x2 with table 0, Cb and Cr 1x1 with table 1
+    std::vector<uint8_t> sof = {0xff, 0xc0, 0x00, 17, 8, 0x00, 16, 0x00, 16, 3, 1, 0x22, 0, 2, 0x11, 1, 3, 0x11, 1};
+    header.insert(header.end(), sof.begin(), sof.end());
+    std::vector<uint8_t> sos = {0xff, 0xda, 0x00, 12, 3, 1, 0x00, 2, 0x11, 3, 0x11, 0, 63, 0, 0xff, 0xd9};
+    header.insert(header.end(), sos.begin(), sos.end());
+    return header;
+}
+
 class JPEGParserPluginTest : public ::testing::Test
 {
   public:
@@ -355,10 +387,25 @@ TEST_F(JPEGParserPluginTest, Error_GetInfo_NoSOF) {
     EXPECT_EQ(NVIMGCODEC_STATUS_SUCCESS,
         nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, bad.data(), bad.size()));
     // Fails to GetInfo (actual parsing) because there's no valid SOF marker
-    nvimgcodecImageInfo_t info;
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
     ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
 }
 
+TEST_F(JPEGParserPluginTest, Validation)
+{
+    auto buffer = read_file(resources_dir + "/jpeg/padlock-406986_640_420.jpg");
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    auto validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(0, validation.corrupted);
+
+    // Entropy-coded data ends before the EOI marker
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size() * 3 / 4);
+    validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(1, validation.corrupted);
+}
+
 TEST_F(JPEGParserPluginTest, Padding)
 {
     /* https://www.w3.org/Graphics/JPEG/itu-t81.pdf section B.1.1.2 Markers
@@ -477,5 +524,104 @@ TEST_F(JPEGParserPluginTest, EXIF_Rotate270)
     EXPECT_EQ(false, info.orientation.flip_y);
 }
 
+TEST_F(JPEGParserPluginTest, QuantizationInfo)
+{
+    for (int quality : {10, 50, 75, 90, 95}) {
+        std::array<std::array<uint16_t, 64>, 2> expected_tables;
+        auto buffer = MakeJpegHeader(quality, &expected_tables);
+        LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+        nvimgcodecJpegQuantizationInfo_t quant_info{
+            NVIMGCODEC_STRUCTURE_TYPE_JPEG_QUANTIZATION_INFO, sizeof(nvimgcodecJpegQuantizationInfo_t), 0};
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &quant_info};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+        EXPECT_EQ(NVIMGCODEC_SAMPLING_420, info.chroma_subsampling);
+        EXPECT_EQ(2, quant_info.num_tables);
+        EXPECT_EQ(0, quant_info.component_tables[0]);
+        EXPECT_EQ(1, quant_info.component_tables[1]);
+        EXPECT_EQ(1, quant_info.component_tables[2]);
+        for (int t = 0; t < 2; t++) {
+            for (int i = 0; i < 64; i++)
+                EXPECT_EQ(expected_tables[t][i], quant_info.tables[t][i]);
+        }
+        EXPECT_EQ(quality, quant_info.estimated_quality);
+    }
+}
+
+TEST_F(JPEGParserPluginTest, QuantizationInfo_TablesAfterFrame)
+{
+    std::array<std::array<uint16_t, 64>, 2> expected_tables;
+    auto header = MakeJpegHeader(75, &expected_tables);
+    auto table_segment = [&](int t) {
+        std::vector<uint8_t> segment = {0xff, 0xdb, 0x00, 2 + 65};
+        auto table = header.begin() + 6 + t * 65;
+        segment.insert(segment.end(), table, table + 65);
+        return segment;
+    };
+    auto sof = header.begin() + 6 + 2 * 65;
+    for (bool between_scans : {false, true}) {
+        // The chroma table comes after the frame header, before the first scan or between the luma and chroma scans
+        std::vector<uint8_t> buffer = {0xff, 0xd8};
+        auto luma_table = table_segment(0);
+        buffer.insert(buffer.end(), luma_table.begin(), luma_table.end());
+        buffer.insert(buffer.end(), sof, sof + 19);
+        auto chroma_table = table_segment(1);
+        if (!between_scans)
+            buffer.insert(buffer.end(), chroma_table.begin(), chroma_table.end());
+        // Luma scan, whose data has a stuffed 0xFF byte and a restart marker
+        buffer.insert(buffer.end(), {0xff, 0xda, 0x00, 8, 1, 1, 0x00, 0, 63, 0, 0x12, 0xff, 0x00, 0x34, 0xff, 0xd0, 0x56});
+        if (between_scans)
+            buffer.insert(buffer.end(), chroma_table.begin(), chroma_table.end());
+        buffer.insert(buffer.end(), {0xff, 0xda, 0x00, 10, 2, 2, 0x11, 3, 0x11, 0, 63, 0, 0x78, 0xff, 0xd9});
+        LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+
+        nvimgcodecJpegQuantizationInfo_t quant_info{
+            NVIMGCODEC_STRUCTURE_TYPE_JPEG_QUANTIZATION_INFO, sizeof(nvimgcodecJpegQuantizationInfo_t), 0};
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &quant_info};
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+        EXPECT_EQ(2, quant_info.num_tables);
+        for (int i = 0; i < 64; i++)
+            EXPECT_EQ(expected_tables[1][i], quant_info.tables[1][i]);
+        EXPECT_EQ(75, quant_info.estimated_quality);
+    }
+}
+
+TEST_F(JPEGParserPluginTest, IccProfile)
+{
+    std::array<std::array<uint16_t, 64>, 2> tables;
+    auto header = MakeJpegHeader(75, &tables);
+    std::vector<uint8_t> profile(300);
+    for (size_t i = 0; i < profile.size(); i++)
+        profile[i] = static_cast<uint8_t>(i * 7);
+
+    // The profile is split in two APP2 segments, stored out of order
+    const std::vector<uint8_t> icc_signature = {'I', 'C', 'C', '_', 'P', 'R', 'O', 'F', 'I', 'L', 'E', 0};
+    std::vector<uint8_t> buffer(header.begin(), header.begin() + 2);
+    for (int seq_no : {2, 1}) {
+        size_t chunk_size = profile.size() / 2;
+        size_t segment_size = 2 + icc_signature.size() + 2 + chunk_size;
+        buffer.insert(buffer.end(), {0xff, 0xe2, static_cast<uint8_t>(segment_size >> 8), static_cast<uint8_t>(segment_size & 0xff)});
+        buffer.insert(buffer.end(), icc_signature.begin(), icc_signature.end());
+        buffer.insert(buffer.end(), {static_cast<uint8_t>(seq_no), 2});
+        auto chunk = profile.begin() + (seq_no - 1) * chunk_size;
+        buffer.insert(buffer.end(), chunk, chunk + chunk_size);
+    }
+    buffer.insert(buffer.end(), header.begin() + 2, header.end());
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+
+    nvimgcodecIccProfile_t icc_info{NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE, sizeof(nvimgcodecIccProfile_t), nullptr};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &icc_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    ASSERT_EQ(profile.size(), icc_info.profile_size);
+    std::vector<uint8_t> data(icc_info.profile_size);
+    icc_info.buffer = data.data();
+    icc_info.buffer_size = data.size();
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(profile, data);
+
+    LoadImageFromHostMemory(instance_, stream_handle_, header.data(), header.size());
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(0, icc_info.profile_size);
+}
+
 }  // namespace test
 }  // namespace nvimgcodec
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <nvimgcodec.h>
+#include <cstring>
+#include <vector>
+#include "nvimgcodec_tests.h"
+#include "parsers/nvtensor.h"
+#include "parsers/nvtensor_format.h"
+#include "parsers/parser_test_utils.h"
+
+namespace nvimgcodec { namespace test {
+
+class NvTensorParserPluginTest : public ::testing::Test
+{
+  public:
+    NvTensorParserPluginTest() {}
+
+    void SetUp() override
+    {
+        nvimgcodecInstanceCreateInfo_t create_info{NVIMGCODEC_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, sizeof(nvimgcodecInstanceCreateInfo_t), 0};
+        create_info.message_severity = NVIMGCODEC_DEBUG_MESSAGE_SEVERITY_DEFAULT;
+        create_info.message_category = NVIMGCODEC_DEBUG_MESSAGE_CATEGORY_ALL;
+
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecInstanceCreate(&instance_, &create_info));
+
+        nvtensor_parser_extension_desc_.struct_type = NVIMGCODEC_STRUCTURE_TYPE_EXTENSION_DESC;
+        nvtensor_parser_extension_desc_.struct_size = sizeof(nvimgcodecExtensionDesc_t);
+        nvtensor_parser_extension_desc_.struct_next = nullptr;
+        ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, get_nvtensor_parser_extension_desc(&nvtensor_parser_extension_desc_));
+        nvimgcodecExtensionCreate(instance_, &nvtensor_parser_extension_, &nvtensor_parser_extension_desc_);
+    }
+
+    void TearDown() override
+    {
+        if (stream_handle_)
+            ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamDestroy(stream_handle_));
+        nvimgcodecExtensionDestroy(nvtensor_parser_extension_);
+        nvimgcodecInstanceDestroy(instance_);
+    }
+
+    nvimgcodecImageInfo_t expected_info()
+    {
+        nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+        info.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_RGB;
+        info.num_planes = 3;
+        info.color_spec = NVIMGCODEC_COLORSPEC_SRGB;
+        info.chroma_subsampling = NVIMGCODEC_SAMPLING_NONE;
+        info.orientation = {NVIMGCODEC_STRUCTURE_TYPE_ORIENTATION, sizeof(nvimgcodecOrientation_t), nullptr, 0, false, false};
+        for (int p = 0; p < info.num_planes; p++) {
+            info.plane_info[p].height = 17;
+            info.plane_info[p].width = 31;
+            info.plane_info[p].num_channels = 1;
+            info.plane_info[p].sample_type = NVIMGCODEC_SAMPLE_DATA_TYPE_UINT16;
+            info.plane_info[p].precision = 12;
+        }
+        return info;
+    }
+
+    // Uncompressed stream of the expected image, with a zero payload
+    std::vector<uint8_t> make_stream()
+    {
+        auto info = expected_info();
+        nvtensor::Header header;
+        header.sample_format = info.sample_format;
+        header.color_spec = info.color_spec;
+        header.chroma_subsampling = info.chroma_subsampling;
+        header.num_planes = info.num_planes;
+        header.chunk_size = 1000;
+        for (uint32_t p = 0; p < info.num_planes; p++) {
+            auto& plane = info.plane_info[p];
+            header.planes[p] = {plane.width, plane.height, plane.num_channels, plane.sample_type, plane.precision};
+        }
+        auto data = header.serialize();
+        data.resize(data.size() + header.payloadSize(), 0);
+        return data;
+    }
+
+    nvimgcodecInstance_t instance_;
+    nvimgcodecExtensionDesc_t nvtensor_parser_extension_desc_{};
+    nvimgcodecExtension_t nvtensor_parser_extension_;
+    nvimgcodecCodeStream_t stream_handle_ = nullptr;
+};
+
+TEST_F(NvTensorParserPluginTest, Uncompressed)
+{
+    auto buffer = make_stream();
+    EXPECT_EQ(0u, nvtensor::LoadLE<uint32_t>(buffer.data() + 12) % nvtensor::kPayloadAlignment);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_STREQ("nvtensor", info.codec_name);
+    expect_eq(expected_info(), info);
+}
+
+TEST_F(NvTensorParserPluginTest, Error_CreateStream_BadMagic)
+{
+    auto buffer = make_stream();
+    buffer[0] = 'X';
+    EXPECT_NE(NVIMGCODEC_STATUS_SUCCESS,
+        nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+}
+
+TEST_F(NvTensorParserPluginTest, Error_GetInfo_Truncated)
+{
+    auto buffer = make_stream();
+    buffer.resize(buffer.size() - 1);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+}
+
+TEST_F(NvTensorParserPluginTest, Error_GetInfo_UnsupportedVersion)
+{
+    auto buffer = make_stream();
+    nvtensor::StoreLE<uint32_t>(buffer.data() + 8, nvtensor::kVersion + 1);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+}
+
+TEST_F(NvTensorParserPluginTest, Error_GetInfo_PlaneSizeOverflow)
+{
+    auto buffer = make_stream();
+    uint8_t* plane = buffer.data() + nvtensor::kFixedHeaderSize;
+    nvtensor::StoreLE<uint32_t>(plane, 0xFFFFFFFF);
+    nvtensor::StoreLE<uint32_t>(plane + 4, 0xFFFFFFFF);
+    nvtensor::StoreLE<uint32_t>(plane + 8, 0xFFFFFFFF);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+}
+
+TEST_F(NvTensorParserPluginTest, Error_GetInfo_ChunkTableLargerThanStream)
+{
+    // A consistent header announcing 2^32-1 compressed chunks, whose size table alone would take 32 GB
+    nvtensor::Header header;
+    header.compression = NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD;
+    header.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    header.num_planes = 1;
+    header.planes[0] = {0xFFFFFFFF, 0xFFFFFFFF, 1, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, 8};
+    header.chunk_size = 0xFFFFFFFF;
+    ASSERT_EQ(0xFFFFFFFFu, header.numChunks());
+    auto buffer = header.serialize();
+    buffer.resize(buffer.size() + 1024, 0);
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+}
+
+TEST_F(NvTensorParserPluginTest, Error_GetInfo_CompressedSizeOverflow)
+{
+    // The compressed chunk sizes add up to 2^64, which would wrap around to an empty payload
+    nvtensor::Header header;
+    header.compression = NVIMGCODEC_NVTENSOR_COMPRESSION_ZSTD;
+    header.sample_format = NVIMGCODEC_SAMPLEFORMAT_P_Y;
+    header.num_planes = 1;
+    header.planes[0] = {16, 2, 1, NVIMGCODEC_SAMPLE_DATA_TYPE_UINT8, 8};
+    header.chunk_size = 16;
+    header.compressed_chunk_sizes = {uint64_t{1} << 63, uint64_t{1} << 63};
+    auto buffer = header.serialize();
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance_, &stream_handle_, buffer.data(), buffer.size()));
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), 0};
+    ASSERT_NE(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+}
+
+}} // namespace nvimgcodec::test
@@ -84,5 +84,15 @@ inline void LoadImageFromHostMemory(nvimgcodecInstance_t instance, nvimgcodecCod
     ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamCreateFromHostMem(instance, &stream_handle, data, data_size));
 }
 
+// Returns the validation result of the code stream. It is reported even if the rest of the image info can't be read.
+inline nvimgcodecCodeStreamValidation_t ValidateCodeStream(nvimgcodecCodeStream_t stream_handle)
+{
+    nvimgcodecCodeStreamValidation_t validation{
+        NVIMGCODEC_STRUCTURE_TYPE_CODE_STREAM_VALIDATION, sizeof(nvimgcodecCodeStreamValidation_t), nullptr};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &validation};
+    nvimgcodecCodeStreamGetImageInfo(stream_handle, &info);
+    return validation;
+}
+
 }  // namespace test
 }  // namespace nvimgcodec
\ No newline at end of file
@@ -225,4 +225,115 @@ TEST_F(PNGParserPluginTest, EXIF_Orientation_NoOrientation)
     expect_eq(expected_info, info);
 }
 
+namespace {
+
+void PutBE32(std::vector<uint8_t>& out, uint32_t value)
+{
+    for (int i = 3; i >= 0; i--)
+        out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+void PutChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data)
+{
+    PutBE32(out, data.size());
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBE32(out, 0); // CRC, not checked by the parser
+}
+
+uint32_t Crc32(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+// Builds a 1x1 gray PNG whose chunks have valid CRCs
+std::vector<uint8_t> MakeValidPng()
+{
+    std::vector<uint8_t> out = {137, 80, 78, 71, 13, 10, 26, 10};
+    auto put_chunk = [&out](const char* type, const std::vector<uint8_t>& data) {
+        PutBE32(out, data.size());
+        size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), data.begin(), data.end());
+        PutBE32(out, Crc32(out.data() + start, out.size() - start));
+    };
+    put_chunk("IHDR", {0, 0, 0, 1, 0, 0, 0, 1, 8, 0, 0, 0, 0});
+    put_chunk("IDAT", {0x78, 0x01, 0x63, 0x60, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01});
+    put_chunk("IEND", {});
+    return out;
+}
+
+// Builds a 1x1 RGB PNG header with an iCCP chunk, the profile being stored in an uncompressed deflate block
+std::vector<uint8_t> MakePngWithIccProfile(const std::vector<uint8_t>& profile)
+{
+    std::vector<uint8_t> out = {137, 80, 78, 71, 13, 10, 26, 10};
+    PutChunk(out, "IHDR", {0, 0, 0, 1, 0, 0, 0, 1, 8, 2, 0, 0, 0});
+    std::vector<uint8_t> iccp = {'i', 'c', 'c', 0, 0, 0x78, 0x01, 0x01};
+    uint16_t len = profile.size();
+    iccp.insert(iccp.end(), {static_cast<uint8_t>(len & 0xff), static_cast<uint8_t>(len >> 8), static_cast<uint8_t>(~len & 0xff),
+                                static_cast<uint8_t>((~len >> 8) & 0xff)});
+    iccp.insert(iccp.end(), profile.begin(), profile.end());
+    uint32_t a = 1, b = 0;
+    for (auto value : profile) {
+        a = (a + value) % 65521;
+        b = (b + a) % 65521;
+    }
+    PutBE32(iccp, (b << 16) | a);
+    PutChunk(out, "iCCP", iccp);
+    PutChunk(out, "IEND", {});
+    return out;
+}
+
+} // namespace
+
+TEST_F(PNGParserPluginTest, IccProfile)
+{
+    std::vector<uint8_t> profile(300);
+    for (size_t i = 0; i < profile.size(); i++)
+        profile[i] = static_cast<uint8_t>(i * 7);
+    auto buffer = MakePngWithIccProfile(profile);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+
+    std::vector<uint8_t> data(1024);
+    nvimgcodecIccProfile_t icc_info{NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE, sizeof(nvimgcodecIccProfile_t), nullptr, data.data(), data.size()};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &icc_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+#ifdef NVIMGCODEC_HAVE_ZLIB
+    ASSERT_EQ(profile.size(), icc_info.profile_size);
+    data.resize(icc_info.profile_size);
+    EXPECT_EQ(profile, data);
+#else
+    EXPECT_EQ(0, icc_info.profile_size);
+#endif
+}
+
+TEST_F(PNGParserPluginTest, Validation)
+{
+    auto buffer = MakeValidPng();
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    auto validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(0, validation.corrupted);
+
+    // Damaged IDAT data no longer matches its CRC
+    auto damaged = buffer;
+    damaged[8 + 25 + 8 + 4] ^= 0x10;
+    LoadImageFromHostMemory(instance_, stream_handle_, damaged.data(), damaged.size());
+    validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(1, validation.corrupted);
+
+    // Missing IEND chunk
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size() - 12);
+    validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(1, validation.corrupted);
+}
+
 }} // namespace nvimgcodec::test
@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 #include <nvimgcodec.h>
+#include <array>
 #include <cstring>
 #include <fstream>
 #include <string>
@@ -227,4 +228,252 @@ TEST_F(TIFFParserPluginTest, EXIF_Orientation_NoOrientation)
     expect_eq(expected_info, info);
 }
 
+namespace {
+
+struct TestIfd
+{
+    uint32_t width, height;
+    uint32_t tile_width, tile_height; // 0 for stripped images
+    uint32_t subfile_type;
+};
+
+void PutLE16(std::vector<uint8_t>& out, uint16_t value)
+{
+    out.push_back(value & 0xFF);
+    out.push_back(value >> 8);
+}
+
+void PutLE32(std::vector<uint8_t>& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+void PutLE64(std::vector<uint8_t>& out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back((value >> (8 * i)) & 0xFF);
+}
+
+// Offsets and value counts take 4 bytes in classic TIFF and 8 bytes in BigTIFF
+void PutOffset(std::vector<uint8_t>& out, uint64_t value, bool big_tiff)
+{
+    if (big_tiff)
+        PutLE64(out, value);
+    else
+        PutLE32(out, static_cast<uint32_t>(value));
+}
+
+std::vector<uint8_t> MakeTiffHeader(bool big_tiff)
+{
+    std::vector<uint8_t> out = {'I', 'I', static_cast<uint8_t>(big_tiff ? 43 : 42), 0};
+    if (big_tiff) {
+        PutLE16(out, 8); // size of offsets
+        PutLE16(out, 0);
+    }
+    PutOffset(out, out.size() + (big_tiff ? 8 : 4), big_tiff);
+    return out;
+}
+
+// Entry with a single value of type SHORT (3) or LONG (4)
+void PutScalarEntry(std::vector<uint8_t>& out, const std::array<uint32_t, 3>& e, bool big_tiff)
+{
+    PutLE16(out, e[0]);
+    PutLE16(out, e[1]);
+    PutOffset(out, 1, big_tiff);
+    if (e[1] == 3) {
+        PutLE16(out, e[2]);
+        PutLE16(out, 0);
+    } else {
+        PutLE32(out, e[2]);
+    }
+    if (big_tiff)
+        PutLE32(out, 0);
+}
+
+// Builds a little-endian TIFF header with a chain of IFDs (no pixel data), enough for the parser to enumerate levels
+std::vector<uint8_t> MakeTiffWithIfdChain(const std::vector<TestIfd>& ifds, bool big_tiff = false)
+{
+    std::vector<uint8_t> out = MakeTiffHeader(big_tiff);
+    for (size_t i = 0; i < ifds.size(); i++) {
+        const auto& ifd = ifds[i];
+        std::vector<std::array<uint32_t, 3>> entries = {{254, 4, ifd.subfile_type}, {256, 4, ifd.width}, {257, 4, ifd.height},
+            {258, 3, 8}, {277, 3, 1}};
+        if (ifd.tile_width) {
+            entries.push_back({322, 4, ifd.tile_width});
+            entries.push_back({323, 4, ifd.tile_height});
+        }
+        if (big_tiff)
+            PutLE64(out, entries.size());
+        else
+            PutLE16(out, entries.size());
+        for (auto& e : entries)
+            PutScalarEntry(out, e, big_tiff);
+        PutOffset(out, i + 1 < ifds.size() ? out.size() + (big_tiff ? 8 : 4) : 0, big_tiff);
+    }
+    return out;
+}
+
+// Builds a little-endian TIFF header of an RGB image with an ICC profile (no pixel data)
+std::vector<uint8_t> MakeTiffWithIccProfile(const std::vector<uint8_t>& profile)
+{
+    std::vector<uint8_t> out = {'I', 'I', 42, 0};
+    PutLE32(out, 8);
+    std::vector<std::array<uint32_t, 4>> entries = {{256, 4, 1, 16}, {257, 4, 1, 16}, {258, 3, 1, 8}, {277, 3, 1, 3}};
+    uint32_t profile_offset = 8 + 2 + (entries.size() + 1) * 12 + 4;
+    entries.push_back({34675, 7, static_cast<uint32_t>(profile.size()), profile_offset});
+    PutLE16(out, entries.size());
+    for (auto& e : entries) {
+        PutLE16(out, e[0]);
+        PutLE16(out, e[1]);
+        PutLE32(out, e[2]);
+        if (e[1] == 3) {
+            PutLE16(out, e[3]);
+            PutLE16(out, 0);
+        } else {
+            PutLE32(out, e[3]);
+        }
+    }
+    PutLE32(out, 0);
+    out.insert(out.end(), profile.begin(), profile.end());
+    return out;
+}
+
+} // namespace
+
+TEST_F(TIFFParserPluginTest, IccProfile)
+{
+    std::vector<uint8_t> profile(300);
+    for (size_t i = 0; i < profile.size(); i++)
+        profile[i] = static_cast<uint8_t>(i * 7);
+    auto buffer = MakeTiffWithIccProfile(profile);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+
+    std::vector<uint8_t> data(profile.size());
+    nvimgcodecIccProfile_t icc_info{NVIMGCODEC_STRUCTURE_TYPE_ICC_PROFILE, sizeof(nvimgcodecIccProfile_t), nullptr, data.data(), data.size()};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &icc_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(3, info.num_planes);
+    ASSERT_EQ(profile.size(), icc_info.profile_size);
+    EXPECT_EQ(profile, data);
+
+    LoadImageFromFilename(instance_, stream_handle_, resources_dir + "/tiff/cat-1245673_640.tiff");
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(0, icc_info.profile_size);
+}
+
+TEST_F(TIFFParserPluginTest, PyramidLevels_SinglePage)
+{
+    LoadImageFromFilename(instance_, stream_handle_, resources_dir + "/tiff/cat-1245673_640.tiff");
+    nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), 0};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &tiff_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    ASSERT_EQ(1, tiff_info.num_levels);
+    EXPECT_EQ(640, tiff_info.levels[0].width);
+    EXPECT_EQ(423, tiff_info.levels[0].height);
+    EXPECT_EQ(640, tiff_info.levels[0].tile_width);
+}
+
+TEST_F(TIFFParserPluginTest, PyramidLevels_SuccessivePages)
+{
+    // The stripped 128x96 page is a thumbnail and is not part of the pyramid
+    auto buffer = MakeTiffWithIfdChain({{1024, 768, 256, 256, 0}, {512, 384, 256, 256, 1}, {128, 96, 0, 0, 0}, {256, 192, 128, 128, 1}});
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), 0};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &tiff_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(1024, info.plane_info[0].width);
+    EXPECT_EQ(768, info.plane_info[0].height);
+    ASSERT_EQ(3, tiff_info.num_levels);
+    EXPECT_EQ(1024, tiff_info.levels[0].width);
+    EXPECT_EQ(768, tiff_info.levels[0].height);
+    EXPECT_EQ(256, tiff_info.levels[0].tile_width);
+    EXPECT_EQ(256, tiff_info.levels[0].tile_height);
+    EXPECT_EQ(512, tiff_info.levels[1].width);
+    EXPECT_EQ(384, tiff_info.levels[1].height);
+    EXPECT_EQ(256, tiff_info.levels[2].width);
+    EXPECT_EQ(192, tiff_info.levels[2].height);
+    EXPECT_EQ(128, tiff_info.levels[2].tile_width);
+    EXPECT_EQ(128, tiff_info.levels[2].tile_height);
+    // IFDs of tiled pages have 7 entries and the others 5, each IFD taking 2 + 12 * entries + 4 bytes
+    EXPECT_EQ(8, tiff_info.levels[0].ifd_offset);
+    EXPECT_EQ(98, tiff_info.levels[1].ifd_offset);
+    EXPECT_EQ(254, tiff_info.levels[2].ifd_offset);
+}
+
+TEST_F(TIFFParserPluginTest, PyramidLevels_BigTiff)
+{
+    auto buffer = MakeTiffWithIfdChain({{1024, 768, 256, 256, 0}, {512, 384, 256, 256, 1}, {128, 96, 0, 0, 0}, {256, 192, 128, 128, 1}}, true);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    nvimgcodecTiffImageInfo_t tiff_info{NVIMGCODEC_STRUCTURE_TYPE_TIFF_IMAGE_INFO, sizeof(nvimgcodecTiffImageInfo_t), 0};
+    nvimgcodecImageInfo_t info{NVIMGCODEC_STRUCTURE_TYPE_IMAGE_INFO, sizeof(nvimgcodecImageInfo_t), &tiff_info};
+    ASSERT_EQ(NVIMGCODEC_STATUS_SUCCESS, nvimgcodecCodeStreamGetImageInfo(stream_handle_, &info));
+    EXPECT_EQ(1, info.num_planes);
+    EXPECT_EQ(1024, info.plane_info[0].width);
+    EXPECT_EQ(768, info.plane_info[0].height);
+    EXPECT_EQ(8, info.plane_info[0].precision);
+    ASSERT_EQ(3, tiff_info.num_levels);
+    EXPECT_EQ(512, tiff_info.levels[1].width);
+    EXPECT_EQ(384, tiff_info.levels[1].height);
+    EXPECT_EQ(256, tiff_info.levels[2].width);
+    EXPECT_EQ(128, tiff_info.levels[2].tile_width);
+    // BigTIFF IFDs take 8 + 20 * entries + 8 bytes, after a 16 byte header
+    EXPECT_EQ(16, tiff_info.levels[0].ifd_offset);
+    EXPECT_EQ(172, tiff_info.levels[1].ifd_offset);
+    EXPECT_EQ(444, tiff_info.levels[2].ifd_offset);
+}
+
+namespace {
+
+// Builds a little-endian TIFF of a 2x2 gray image stored in one strip, whose byte count is given
+std::vector<uint8_t> MakeStrippedTiff(uint32_t strip_byte_count, bool big_tiff = false)
+{
+    std::vector<uint8_t> out = MakeTiffHeader(big_tiff);
+    std::vector<std::array<uint32_t, 3>> entries = {{256, 4, 2}, {257, 4, 2}, {258, 3, 8}, {273, 4, 0}, {277, 3, 1}, {278, 4, 2},
+        {279, 4, strip_byte_count}};
+    entries[3][2] = big_tiff ? 16 + 8 + entries.size() * 20 + 8 : 8 + 2 + entries.size() * 12 + 4;
+    if (big_tiff)
+        PutLE64(out, entries.size());
+    else
+        PutLE16(out, entries.size());
+    for (auto& e : entries)
+        PutScalarEntry(out, e, big_tiff);
+    PutOffset(out, 0, big_tiff);
+    out.insert(out.end(), {10, 20, 30, 40});
+    return out;
+}
+
+} // namespace
+
+TEST_F(TIFFParserPluginTest, Validation)
+{
+    auto buffer = MakeStrippedTiff(4);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    auto validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(0, validation.corrupted);
+
+    // The strip extends past the end of the file
+    buffer = MakeStrippedTiff(5);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(1, validation.corrupted);
+}
+
+TEST_F(TIFFParserPluginTest, Validation_BigTiff)
+{
+    auto buffer = MakeStrippedTiff(4, true);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    auto validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(0, validation.corrupted);
+
+    buffer = MakeStrippedTiff(5, true);
+    LoadImageFromHostMemory(instance_, stream_handle_, buffer.data(), buffer.size());
+    validation = ValidateCodeStream(stream_handle_);
+    EXPECT_EQ(1, validation.checked);
+    EXPECT_EQ(1, validation.corrupted);
+}
+
 }} // namespace nvimgcodec::test
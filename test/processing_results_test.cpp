@@ -57,6 +57,23 @@ TEST(FutureProcessingResultsTest, WaitNew)
     EXPECT_EQ(res1.first[2], 2);
 }
 
+TEST(FutureProcessingResultsTest, OnResult)
+{
+    ProcessingResultsPromise pro(3);
+    auto fut = pro.getFuture();
+    // Sample 2 gets the result of sample 0
+    pro.setOnResult([](ProcessingResultsPromise& promise, int index, const ProcessingResult& res) {
+        if (index == 0)
+            promise.set(2, res);
+    });
+    pro.set(1, ProcessingResult::success());
+    pro.set(0, ProcessingResult::failure(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED));
+    auto results = fut->getAllCopy();
+    EXPECT_TRUE(results[1].isSuccess());
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, results[0].status_);
+    EXPECT_EQ(NVIMGCODEC_PROCESSING_STATUS_IMAGE_CORRUPTED, results[2].status_);
+}
+
 TEST(FutureProcessingResultsTest, Benchmark)
 {
     ThreadPool tp(4, CPU_ONLY_DEVICE_ID, false, "FutureProcessingResultsTest");
@@ -0,0 +1,58 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+import os
+import numpy as np
+import pytest as t
+from nvidia import nvimgcodec
+
+img_dir_path = os.path.abspath(os.path.join(os.path.dirname(__file__), "../../resources"))
+
+filenames = [
+    "jpeg/padlock-406986_640_420.jpg",
+    "jpeg/padlock-406986_640_444.jpg",
+    "jpeg/padlock-406986_640_gray.jpg",
+    "bmp/cat-111793_640.bmp",
+]
+
+
+@t.mark.parametrize("max_in_flight_bytes", [0, 1, 2 * 640 * 480 * 3])
+def test_transcode_batch_to_bmp_matches_decode(max_in_flight_bytes):
+    decoder = nvimgcodec.Decoder()
+    encoder = nvimgcodec.Encoder()
+    transcoder = nvimgcodec.Transcoder(decoder, encoder, max_in_flight_bytes=max_in_flight_bytes)
+
+    fpaths = [os.path.join(img_dir_path, f) for f in filenames]
+    transcoded = transcoder.transcode(fpaths, codec="bmp")
+    assert len(transcoded) == len(fpaths)
+
+    ref_imgs = decoder.read(fpaths)
+    for ref_img, data in zip(ref_imgs, transcoded):
+        assert data is not None
+        test_img = decoder.decode(data)
+        np.testing.assert_array_equal(np.asarray(ref_img.cpu()), np.asarray(test_img.cpu()))
+
+
+def test_transcode_single():
+    decoder = nvimgcodec.Decoder()
+    encoder = nvimgcodec.Encoder()
+    transcoder = nvimgcodec.Transcoder(decoder, encoder)
+
+    fpath = os.path.join(img_dir_path, filenames[0])
+    data = transcoder.transcode(fpath, codec=".bmp")
+    ref_img = decoder.read(fpath)
+    test_img = decoder.decode(data)
+    np.testing.assert_array_equal(np.asarray(ref_img.cpu()), np.asarray(test_img.cpu()))
@@ -0,0 +1,176 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "../extensions/utils/scratch.h"
+#include "../src/scratch_arena.h"
+
+namespace nvimgcodec { namespace test {
+
+TEST(ScratchArena, Alignment)
+{
+    ScratchArena arena(1 << 20);
+    uint8_t* a = static_cast<uint8_t*>(arena.allocate(3, 1));
+    void* b = arena.allocate(100, 64);
+    void* c = arena.allocate(8, 0);
+    ASSERT_NE(nullptr, a);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 64);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(c) % alignof(std::max_align_t));
+    EXPECT_GE(static_cast<uint8_t*>(b), a + 3);
+    EXPECT_EQ(nullptr, arena.allocate(8, 3));
+}
+
+TEST(ScratchArena, ReusesPeakAfterReset)
+{
+    ScratchArena arena(1 << 20);
+    auto run_task = [&arena] {
+        for (int i = 0; i < 10; i++) {
+            void* ptr = arena.allocate(50000, 16);
+            ASSERT_NE(nullptr, ptr);
+            std::memset(ptr, i, 50000);
+        }
+        arena.reset();
+    };
+
+    run_task();
+    uint64_t system_allocations = arena.numSystemAllocations();
+    EXPECT_GT(system_allocations, 0u);
+    EXPECT_GE(arena.retainedSize(), 500000u);
+    EXPECT_EQ(arena.retainedSize(), arena.peakSize());
+
+    // Steady state, everything fits in the retained block
+    run_task();
+    run_task();
+    EXPECT_EQ(system_allocations, arena.numSystemAllocations());
+    run_task();
+    EXPECT_EQ(system_allocations, arena.numSystemAllocations());
+    EXPECT_EQ(40u, arena.numAllocations());
+}
+
+TEST(ScratchArena, RetainedSizeIsCapped)
+{
+    ScratchArena arena(4096);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_NE(nullptr, arena.allocate(100000, 0));
+        arena.reset();
+        EXPECT_LE(arena.retainedSize(), 4096u);
+    }
+    EXPECT_EQ(4u, arena.numSystemAllocations()); // One spill per task, plus the capped retained block
+}
+
+TEST(ScratchArenas, PerThread)
+{
+    ScratchArenas arenas(1 << 20);
+    ScratchArena* main_arena = &arenas.local();
+    EXPECT_EQ(main_arena, &arenas.local());
+    ScratchArena* other_arena = nullptr;
+    nvimgcodecScratchArenaStats_t stats{NVIMGCODEC_STRUCTURE_TYPE_SCRATCH_ARENA_STATS, sizeof(nvimgcodecScratchArenaStats_t), nullptr};
+    std::thread t([&] {
+        other_arena = &arenas.local();
+        other_arena->allocate(100, 0);
+        other_arena->reset();
+        arenas.getStats(&stats);
+    });
+    t.join();
+    EXPECT_NE(main_arena, other_arena);
+    EXPECT_EQ(2u, stats.num_arenas);
+    main_arena->allocate(10, 0);
+
+    // The arena of the other thread was released when it exited, its counters are kept
+    arenas.getStats(&stats);
+    EXPECT_EQ(1u, stats.num_arenas);
+    EXPECT_EQ(2u, stats.num_allocations);
+    EXPECT_GE(stats.peak_size, 100u);
+
+    // A thread uses a separate arena for each instance
+    ScratchArenas other_arenas(1 << 20);
+    EXPECT_NE(main_arena, &other_arenas.local());
+    EXPECT_EQ(main_arena, &arenas.local());
+}
+
+TEST(ScratchArenas, ThreadExitAfterInstanceIsDestroyed)
+{
+    auto arenas = std::make_unique<ScratchArenas>(1 << 20);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool destroyed = false;
+    std::thread t([&] {
+        arenas->local().allocate(10, 0);
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return destroyed; });
+    });
+    while (true) {
+        nvimgcodecScratchArenaStats_t stats{NVIMGCODEC_STRUCTURE_TYPE_SCRATCH_ARENA_STATS, sizeof(nvimgcodecScratchArenaStats_t), nullptr};
+        arenas->getStats(&stats);
+        if (stats.num_allocations == 1)
+            break;
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        arenas.reset();
+        destroyed = true;
+    }
+    cv.notify_one();
+    t.join();
+}
+
+TEST(ScratchScope, UsesArenaOnlyIfFrameworkProvidesIt)
+{
+    struct Arena
+    {
+        ScratchArena arena{1 << 20};
+        int allocations = 0;
+        int resets = 0;
+    } state;
+    nvimgcodecFrameworkDesc_t framework{NVIMGCODEC_STRUCTURE_TYPE_FRAMEWORK_DESC, sizeof(nvimgcodecFrameworkDesc_t), nullptr, &state};
+    framework.scratchAlloc = [](void* instance, size_t size, size_t alignment) {
+        auto* state = static_cast<Arena*>(instance);
+        state->allocations++;
+        return state->arena.allocate(size, alignment);
+    };
+    framework.scratchReset = [](void* instance) {
+        auto* state = static_cast<Arena*>(instance);
+        state->resets++;
+        state->arena.reset();
+    };
+
+    {
+        ScratchScope scratch(&framework);
+        EXPECT_NE(nullptr, scratch.allocate<uint32_t>(16));
+    }
+    EXPECT_EQ(1, state.allocations);
+    EXPECT_EQ(1, state.resets);
+
+    // A framework older than the arenas has a smaller descriptor, whose end must not be read
+    framework.struct_size = offsetof(nvimgcodecFrameworkDesc_t, registerTransformer);
+    {
+        ScratchScope scratch(&framework);
+        EXPECT_NE(nullptr, scratch.allocate<uint32_t>(16));
+    }
+    EXPECT_EQ(1, state.allocations);
+    EXPECT_EQ(1, state.resets);
+}
+
+}} // namespace nvimgcodec::test
@@ -18,6 +18,7 @@
 #include "../src/thread_pool.h"
 #include <gtest/gtest.h>
 #include <atomic>
+#include <vector>
 
 namespace nvimgcodec { namespace test {
 
@@ -69,6 +70,40 @@ TEST(ThreadPool, AddWorkWithPriority) {
   ASSERT_EQ(((1+1) << 3) + 1, count);
 }
 
+TEST(ThreadPool, AddBatch) {
+  ThreadPool tp(4, 0, false, "ThreadPool test");
+  std::vector<std::atomic<int>> runs(100);
+  tp.addBatch(100, [&runs](int thread_id, int task_idx) { runs[task_idx]++; });
+  tp.waitForWork();
+  for (int i = 0; i < 100; i++)
+    ASSERT_EQ(1, runs[i]) << "task " << i;
+}
+
+TEST(ThreadPool, AddBatchAfterWork) {
+  // only one thread to ensure deterministic behavior
+  ThreadPool tp(1, 0, false, "ThreadPool test");
+  std::atomic<int> count{0};
+  tp.addWork([&count](int thread_id) { count = 1; }, 10);
+  tp.addBatch(3, [&count](int thread_id, int task_idx) { count += task_idx + 1; });
+  tp.waitForWork();
+  ASSERT_EQ(1 + 1 + 2 + 3, count);
+}
+
+TEST(ThreadPool, AddBatchEmpty) {
+  ThreadPool tp(2, 0, false, "ThreadPool test");
+  tp.addBatch(0, [](int thread_id, int task_idx) { FAIL(); });
+  tp.waitForWork();
+}
+
+TEST(ThreadPool, AddBatchRepeated) {
+  ThreadPool tp(4, 0, false, "ThreadPool test");
+  std::atomic<int> count{0};
+  for (int it = 0; it < 20; it++) {
+    tp.addBatch(100, [&count](int thread_id, int task_idx) { count++; });
+    tp.waitForWork();
+    ASSERT_EQ(100 * (it + 1), count);
+  }
+}
 
 }  // namespace test
 